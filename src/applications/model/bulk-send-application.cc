@@ -198,6 +198,7 @@ void BulkSendApplication::SendData (void)
         }
 
       NS_LOG_LOGIC ("sending packet at " << Simulator::Now ());
+      // zero-filled payload, kept virtual down to the receiving socket
       Ptr<Packet> packet = Create<Packet> (toSend);
       m_txTrace (packet);
       int actual = m_socket->Send (packet);
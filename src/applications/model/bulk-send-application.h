@@ -64,6 +64,9 @@ class Socket;
  * For example, TCP sockets can be used, but
  * UDP sockets can not be used.
  *
+ * The packets sent carry a virtual payload (see
+ * Packet::IsVirtual), which the TCP send and receive
+ * buffers merge and split without copying any byte.
  */
 class BulkSendApplication : public Application
 {
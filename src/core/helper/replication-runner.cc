@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "replication-runner.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::ReplicationRunner implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ReplicationRunner");
+
+namespace {
+
+/**
+ * Invoke a job in the calling thread.
+ * \param [in] job The job
+ * \param [in] i The index of the replication
+ */
+void
+RunJob (const Callback<void, uint32_t> *job, uint32_t i)
+{
+  (*job)(i);
+}
+
+/**
+ * Run replications one after the other until none is left.
+ * \param [in] job The job running a replication
+ * \param [in,out] next The index of the next replication to run
+ * \param [in] n The number of replications
+ */
+void
+RunWorker (const Callback<void, uint32_t> *job, std::atomic<uint32_t> *next, uint32_t n)
+{
+  for (uint32_t i = (*next)++; i < n; i = (*next)++)
+    {
+      // a new thread starts with fresh thread local state: packet uids,
+      // free lists, address and flow counters.
+      std::thread thread (&RunJob, job, i);
+      thread.join ();
+    }
+}
+
+} // unnamed namespace
+
+ReplicationRunner::ReplicationRunner ()
+  : m_threads (std::max (std::thread::hardware_concurrency (), 1U))
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+ReplicationRunner::SetThreads (uint32_t threads)
+{
+  NS_LOG_FUNCTION (this << threads);
+  NS_ASSERT (threads > 0);
+  m_threads = threads;
+}
+
+uint32_t
+ReplicationRunner::GetThreads (void) const
+{
+  return m_threads;
+}
+
+void
+ReplicationRunner::DoRun (Callback<void, uint32_t> job, uint32_t n) const
+{
+  NS_LOG_FUNCTION (this << n);
+  std::atomic<uint32_t> next (0);
+  std::vector<std::thread> workers;
+  for (uint32_t w = 0; w < std::min (m_threads, n); ++w)
+    {
+      workers.push_back (std::thread (&RunWorker, &job, &next, n));
+    }
+  for (std::vector<std::thread>::iterator i = workers.begin (); i != workers.end (); ++i)
+    {
+      i->join ();
+    }
+}
+
+} // namespace ns3
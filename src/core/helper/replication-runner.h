@@ -0,0 +1,153 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef REPLICATION_RUNNER_H
+#define REPLICATION_RUNNER_H
+
+#include "ns3/callback.h"
+#include "ns3/replication.h"
+#include <mutex>
+#include <vector>
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::ReplicationRunner declaration and template implementation.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ * \brief Run independent replications of a simulation concurrently in
+ * one process.
+ *
+ * Each replication runs in a new thread which enters a Replication
+ * with its own RngRun, so that it builds and runs a simulation of its
+ * own, and its result is the same as if it ran alone in a process.
+ * The inputs shared by the replications, like a parsed topology or
+ * flow size distributions, are built once beforehand and handed to
+ * the replications as plain data or raw pointers to be read only.
+ *
+ * \code
+ *   static double
+ *   RunOnce (const Topology *topology, uint64_t run)
+ *   {
+ *     // build the nodes from *topology, install the applications
+ *     Simulator::Run ();
+ *     return averageFct;
+ *   }
+ *
+ *   ReplicationRunner runner;
+ *   std::vector<double> fct = runner.Run (MakeBoundCallback (&RunOnce, &topology), 1, 10);
+ * \endcode
+ */
+class ReplicationRunner
+{
+public:
+  /** Use as many threads as the hardware runs at once. */
+  ReplicationRunner ();
+
+  /**
+   * \param [in] threads The maximum number of replications running at once
+   */
+  void SetThreads (uint32_t threads);
+  /**
+   * \returns The maximum number of replications running at once
+   */
+  uint32_t GetThreads (void) const;
+
+  /**
+   * Run the replications of the runs \p firstRun to \p firstRun + \p n - 1
+   * and wait for all of them.
+   *
+   * The replication is invoked concurrently from several threads, with
+   * the run as argument, after which the simulation of its thread is
+   * destroyed.
+   *
+   * \param [in] replication The replication, which returns its result
+   * \param [in] firstRun The run of the first replication
+   * \param [in] n The number of replications
+   * \returns The results of the replications, in the order of the runs
+   */
+  template <typename R>
+  std::vector<R> Run (Callback<R, uint64_t> replication, uint64_t firstRun, uint32_t n) const;
+
+private:
+  /**
+   * Invoke a job once per replication, with the index of the replication,
+   * in a new thread each time.
+   * \param [in] job The job
+   * \param [in] n The number of replications
+   */
+  void DoRun (Callback<void, uint32_t> job, uint32_t n) const;
+
+  /**
+   * Runs one replication and stores its result.
+   */
+  template <typename R>
+  struct Collector
+  {
+    /**
+     * Run a replication.
+     * \param [in] i The index of the replication
+     */
+    void Run (uint32_t i);
+
+    Callback<R, uint64_t> replication;  //!< The replication
+    uint64_t firstRun;                  //!< The run of the first replication
+    std::vector<R> results;             //!< The results
+    std::mutex mutex;                   //!< Protects the results
+  };
+
+  uint32_t m_threads;  //!< The maximum number of replications running at once
+};
+
+} // namespace ns3
+
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+namespace ns3 {
+
+template <typename R>
+void
+ReplicationRunner::Collector<R>::Run (uint32_t i)
+{
+  Replication::Enter (firstRun + i);
+  R result = replication (firstRun + i);
+  Replication::Leave ();
+  std::lock_guard<std::mutex> lock (mutex);
+  results[i] = result;
+}
+
+template <typename R>
+std::vector<R>
+ReplicationRunner::Run (Callback<R, uint64_t> replication, uint64_t firstRun, uint32_t n) const
+{
+  Collector<R> collector;
+  collector.replication = replication;
+  collector.firstRun = firstRun;
+  collector.results.resize (n);
+  DoRun (MakeCallback (&Collector<R>::Run, &collector), n);
+  return collector.results;
+}
+
+} // namespace ns3
+
+#endif /* REPLICATION_RUNNER_H */
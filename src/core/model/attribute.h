@@ -20,6 +20,7 @@
 #ifndef ATTRIBUTE_H
 #define ATTRIBUTE_H
 
+#include <atomic>
 #include <string>
 #include <stdint.h>
 #include "ptr.h"
@@ -65,7 +66,7 @@ class ObjectBase;
  * Most subclasses of this base class are implemented by the 
  * ATTRIBUTE_HELPER_* macros.
  */
-class AttributeValue : public SimpleRefCount<AttributeValue>
+class AttributeValue : public SimpleRefCount<AttributeValue, empty, DefaultDeleter<AttributeValue>, std::atomic<uint32_t> >
 {
 public:
   AttributeValue ();
@@ -111,7 +112,7 @@ public:
  * of this base class are usually provided through the MakeAccessorHelper
  * template functions, hidden behind an ATTRIBUTE_HELPER_* macro.
  */
-class AttributeAccessor : public SimpleRefCount<AttributeAccessor>
+class AttributeAccessor : public SimpleRefCount<AttributeAccessor, empty, DefaultDeleter<AttributeAccessor>, std::atomic<uint32_t> >
 {
 public:
   AttributeAccessor ();
@@ -163,7 +164,7 @@ public:
  * Most subclasses of this base class are implemented by the 
  * ATTRIBUTE_HELPER_HEADER and ATTRIBUTE_HELPER_CPP macros.
  */
-class AttributeChecker : public SimpleRefCount<AttributeChecker>
+class AttributeChecker : public SimpleRefCount<AttributeChecker, empty, DefaultDeleter<AttributeChecker>, std::atomic<uint32_t> >
 {
 public:
   AttributeChecker ();
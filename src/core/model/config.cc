@@ -18,7 +18,8 @@
  * Authors: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "config.h"
-#include "singleton.h"
+#include "non-copyable.h"
+#include "replication.h"
 #include "object.h"
 #include "global-value.h"
 #include "object-ptr-container.h"
@@ -573,9 +574,16 @@ Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &conta
 }
 
 /** Config system implementation class. */
-class ConfigImpl : public Singleton<ConfigImpl>
+class ConfigImpl : private NonCopyable
 {
 public:
+  /**
+   * Get the Config implementation, of which a thread running a
+   * Replication has an instance of its own.
+   * \return A pointer to the Config implementation.
+   */
+  static ConfigImpl *Get (void);
+
   /** \copydoc Config::Set() */
   void Set (std::string path, const AttributeValue &value);
   /** \copydoc Config::ConnectWithoutContext() */
@@ -616,6 +624,14 @@ private:
   Roots m_roots;
 };
 
+ConfigImpl *
+ConfigImpl::Get (void)
+{
+  static ConfigImpl config;
+  static thread_local ConfigImpl replicationConfig;
+  return Replication::IsEntered () ? &replicationConfig : &config;
+}
+
 void 
 ConfigImpl::ParsePath (std::string path, std::string *root, std::string *leaf) const
 {
@@ -25,6 +25,8 @@
 
 #include "ptr.h"
 #include "pointer.h"
+#include "double.h"
+#include "uinteger.h"
 #include "assert.h"
 #include "log.h"
 
@@ -53,6 +55,17 @@ DefaultSimulatorImpl::GetTypeId (void)
     .SetParent<SimulatorImpl> ()
     .SetGroupName ("Core")
     .AddConstructor<DefaultSimulatorImpl> ()
+    .AddAttribute ("CompactionRatio",
+                   "The share of cancelled events in the event queue beyond which "
+                   "they are all removed; 1 never removes them.",
+                   DoubleValue (0.5),
+                   MakeDoubleAccessor (&DefaultSimulatorImpl::m_compactionRatio),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddAttribute ("CompactionMinimum",
+                   "The smallest number of cancelled events worth removing.",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&DefaultSimulatorImpl::m_compactionMinimum),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -71,6 +84,7 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_currentTs = 0;
   m_currentContext = Simulator::NO_CONTEXT;
   m_unscheduledEvents = 0;
+  m_cancelledEvents = 0;
   m_eventsWithContextEmpty = true;
   m_main = SystemThread::Self();
 }
@@ -125,6 +139,7 @@ DefaultSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
         }
     }
   m_events = scheduler;
+  m_schedulerFactory = schedulerFactory;
 }
 
 // System ID for non-distributed simulation is always zero
@@ -141,6 +156,11 @@ DefaultSimulatorImpl::ProcessOneEvent (void)
 
   NS_ASSERT (next.key.m_ts >= m_currentTs);
   m_unscheduledEvents--;
+  if (next.impl->IsCancelled ())
+    {
+      NS_ASSERT (m_cancelledEvents > 0);
+      m_cancelledEvents--;
+    }
 
   NS_LOG_LOGIC ("handle " << next.key.m_ts);
   m_currentTs = next.key.m_ts;
@@ -252,15 +272,7 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay,
 
   if (SystemThread::Equals (m_main))
     {
-      Time tAbsolute = delay + TimeStep (m_currentTs);
-      Scheduler::Event ev;
-      ev.impl = event;
-      ev.key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
-      ev.key.m_context = context;
-      ev.key.m_uid = m_uid;
-      m_uid++;
-      m_unscheduledEvents++;
-      m_events->Insert (ev);
+      ScheduleInContext (context, delay, event);
     }
   else
     {
@@ -277,6 +289,24 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay,
     }
 }
 
+EventId
+DefaultSimulatorImpl::ScheduleInContext (uint32_t context, Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << event);
+  NS_ASSERT_MSG (SystemThread::Equals (m_main), "ScheduleInContext called from another thread");
+
+  Time tAbsolute = delay + TimeStep (m_currentTs);
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+  ev.key.m_context = context;
+  ev.key.m_uid = m_uid;
+  m_uid++;
+  m_unscheduledEvents++;
+  m_events->Insert (ev);
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
 EventId
 DefaultSimulatorImpl::ScheduleNow (EventImpl *event)
 {
@@ -363,9 +393,44 @@ DefaultSimulatorImpl::Cancel (const EventId &id)
   if (!IsExpired (id))
     {
       id.PeekEventImpl ()->Cancel ();
+      if (id.GetUid () == 2)
+        {
+          // destroy events are not in the event queue
+          return;
+        }
+      m_cancelledEvents++;
+      if (m_cancelledEvents >= m_compactionMinimum
+          && m_cancelledEvents > m_compactionRatio * m_unscheduledEvents)
+        {
+          Compact ();
+        }
     }
 }
 
+void
+DefaultSimulatorImpl::Compact (void)
+{
+  NS_LOG_FUNCTION (this << m_unscheduledEvents << m_cancelledEvents);
+  // As in SetScheduler, the live events move to a new scheduler, since
+  // a scheduler may not accept events earlier than those it removed
+  Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler> ();
+  while (!m_events->IsEmpty ())
+    {
+      Scheduler::Event next = m_events->RemoveNext ();
+      if (next.impl->IsCancelled ())
+        {
+          next.impl->Unref ();
+          m_unscheduledEvents--;
+        }
+      else
+        {
+          scheduler->Insert (next);
+        }
+    }
+  m_events = scheduler;
+  m_cancelledEvents = 0;
+}
+
 bool
 DefaultSimulatorImpl::IsExpired (const EventId &id) const
 {
@@ -414,4 +479,16 @@ DefaultSimulatorImpl::GetContext (void) const
   return m_currentContext;
 }
 
+uint32_t
+DefaultSimulatorImpl::GetEventCount (void) const
+{
+  return m_unscheduledEvents - m_cancelledEvents;
+}
+
+uint32_t
+DefaultSimulatorImpl::GetCancelledEventCount (void) const
+{
+  return m_cancelledEvents;
+}
+
 } // namespace ns3
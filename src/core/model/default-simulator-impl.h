@@ -65,6 +65,7 @@ public:
   virtual void Stop (const Time &delay);
   virtual EventId Schedule (const Time &delay, EventImpl *event);
   virtual void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event);
+  virtual EventId ScheduleInContext (uint32_t context, const Time &delay, EventImpl *event);
   virtual EventId ScheduleNow (EventImpl *event);
   virtual EventId ScheduleDestroy (EventImpl *event);
   virtual void Remove (const EventId &id);
@@ -77,12 +78,16 @@ public:
   virtual void SetScheduler (ObjectFactory schedulerFactory);
   virtual uint32_t GetSystemId (void) const; 
   virtual uint32_t GetContext (void) const;
+  virtual uint32_t GetEventCount (void) const;
+  virtual uint32_t GetCancelledEventCount (void) const;
 
 private:
   virtual void DoDispose (void);
 
   /** Process the next event. */
   void ProcessOneEvent (void);
+  /** Drop the cancelled events from the event queue. */
+  void Compact (void);
   /** Move events from a different context into the main event queue. */
   void ProcessEventsWithContext (void);
  
@@ -115,6 +120,8 @@ private:
   bool m_stop;
   /** The event priority queue. */
   Ptr<Scheduler> m_events;
+  /** The factory of the event priority queue, to rebuild it. */
+  ObjectFactory m_schedulerFactory;
 
   /** Next event unique id. */
   uint32_t m_uid;
@@ -129,6 +136,12 @@ private:
    *  not counting the Destroy events; this is used for validation
    */
   int m_unscheduledEvents;
+  /** Number of cancelled events in the event queue. */
+  uint32_t m_cancelledEvents;
+  /** Share of cancelled events in the queue which triggers a compaction. */
+  double m_compactionRatio;
+  /** Smallest number of cancelled events worth a compaction. */
+  uint32_t m_compactionMinimum;
 
   /** Main execution thread. */
   SystemThread::ThreadId m_main;
@@ -26,6 +26,7 @@
  */
 
 #include "des-metrics.h"
+#include "event-allocator.h"
 #include "simulator.h"
 #include "system-path.h"
 
@@ -144,7 +145,16 @@ DesMetrics::Close (void)
 {
   m_os << std::endl;    // Finish the last event line
   
-  m_os << " ]" << std::endl;
+  m_os << " ]," << std::endl;
+
+  EventAllocator::Stats stats = EventAllocator::GetStats ();
+  m_os << " \"event_allocator\" : {" << std::endl;
+  m_os << "  \"allocations\" : "   << stats.allocations   << "," << std::endl;
+  m_os << "  \"deallocations\" : " << stats.deallocations << "," << std::endl;
+  m_os << "  \"recycled\" : "      << stats.recycled      << "," << std::endl;
+  m_os << "  \"large\" : "         << stats.large         << "," << std::endl;
+  m_os << "  \"slab_bytes\" : "    << stats.slabBytes     << std::endl;
+  m_os << " }" << std::endl;
   m_os << "}" << std::endl;
   m_os.close ();
 
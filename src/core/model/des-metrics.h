@@ -76,13 +76,20 @@ namespace ns3 {
   ["0",0,"0",0],
   ...
   ["0",0,"0",0]
- ]
+ ],
+ "event_allocator" : {
+  "allocations" : 1234,
+  ...
+ }
 } \endverbatim
  * The first few fields are self-explanatory. The \c event record consists of
  * the source context, the event send time, the destination context,
  * and the event execution time.  Times are given in the
  * current Time resolution.
  *
+ * The trailing \c event_allocator record gives the EventAllocator
+ * statistics at the time the trace file is closed.
+ *
  * <b> Enabling DES Metrics </b>
  *
  * Enable DES Metrics at configure time with
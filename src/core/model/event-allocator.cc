@@ -0,0 +1,278 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-allocator.h"
+
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup events
+ * ns3::EventAllocator implementation.
+ */
+
+namespace ns3 {
+
+namespace {
+
+/** Number of size classes. */
+const std::size_t N_CLASSES = EventAllocator::kMaxSize / EventAllocator::kGranularity;
+
+/** A free block, linked in the free list of its size class. */
+struct FreeBlock
+{
+  FreeBlock *next;  //!< Next free block of the same size class.
+};
+
+/**
+ * Free lists and slab cursor.
+ *
+ * This is a POD so that the thread_local instances are
+ * zero-initialized and remain usable until their thread exits.
+ */
+struct Cache
+{
+  FreeBlock *free[N_CLASSES];   //!< Free lists, per size class.
+  char *cursor;                 //!< Next unused byte in the current slab.
+  char *end;                    //!< End of the current slab.
+  EventAllocator::Stats stats;  //!< Statistics.
+  bool registered;              //!< Will this cache be flushed at thread exit.
+  bool dead;                    //!< Has this cache been flushed.
+};
+
+/** Global state, shared by all threads. */
+struct Depot
+{
+  std::recursive_mutex mutex;   //!< Protects all the members.
+  Cache cache;                  //!< Blocks and statistics of the exited threads.
+  std::vector<void *> slabs;    //!< All the slabs ever reserved.
+};
+
+/**
+ * Get the depot.
+ *
+ * The depot is never destroyed so that events released by static
+ * destructors can still be handled.
+ *
+ * \returns The depot.
+ */
+Depot *
+GetDepot (void)
+{
+  // value-initialization zeroes the cache.
+  static Depot *depot = new Depot ();
+  return depot;
+}
+
+/** The free lists of the current thread. */
+thread_local Cache g_cache;
+
+/** Hand the free lists of the current thread over to the depot when it exits. */
+struct CacheReaper
+{
+  /** Destructor. */
+  ~CacheReaper ()
+  {
+    Depot *depot = GetDepot ();
+    std::lock_guard<std::recursive_mutex> lock (depot->mutex);
+    for (std::size_t i = 0; i < N_CLASSES; ++i)
+      {
+        FreeBlock *head = g_cache.free[i];
+        if (head == 0)
+          {
+            continue;
+          }
+        FreeBlock *tail = head;
+        while (tail->next != 0)
+          {
+            tail = tail->next;
+          }
+        tail->next = depot->cache.free[i];
+        depot->cache.free[i] = head;
+        g_cache.free[i] = 0;
+      }
+    depot->cache.stats.allocations += g_cache.stats.allocations;
+    depot->cache.stats.deallocations += g_cache.stats.deallocations;
+    depot->cache.stats.recycled += g_cache.stats.recycled;
+    depot->cache.stats.large += g_cache.stats.large;
+    g_cache.dead = true;
+  }
+  bool armed;   //!< Dummy member, touched to construct the reaper.
+};
+
+/** Flushes g_cache when the current thread exits. */
+thread_local CacheReaper g_reaper;
+
+/**
+ * Get the size class of a block.
+ *
+ * \param [in] size The size of the block.
+ * \returns The size class.
+ */
+inline std::size_t
+SizeClass (std::size_t size)
+{
+  return (size + EventAllocator::kGranularity - 1) / EventAllocator::kGranularity - 1;
+}
+
+/**
+ * Allocate a block when the free list of its class is empty.
+ *
+ * \param [in,out] c The cache.
+ * \param [in] cls The size class.
+ * \returns The block.
+ */
+void *
+Refill (Cache &c, std::size_t cls)
+{
+  Depot *depot = GetDepot ();
+  if (&c != &depot->cache)
+    {
+      if (!c.registered)
+        {
+          g_reaper.armed = true;
+          c.registered = true;
+        }
+      std::lock_guard<std::recursive_mutex> lock (depot->mutex);
+      FreeBlock *head = depot->cache.free[cls];
+      if (head != 0)
+        {
+          // take the whole list of blocks released by exited threads.
+          depot->cache.free[cls] = 0;
+          c.free[cls] = head->next;
+          c.stats.recycled++;
+          return head;
+        }
+    }
+  std::size_t size = (cls + 1) * EventAllocator::kGranularity;
+  if (c.cursor == 0 || c.cursor + size > c.end)
+    {
+      char *slab = static_cast<char *> (std::malloc (EventAllocator::kSlabSize));
+      if (slab == 0)
+        {
+          throw std::bad_alloc ();
+        }
+      std::lock_guard<std::recursive_mutex> lock (depot->mutex);
+      depot->slabs.push_back (slab);
+      depot->cache.stats.slabBytes += EventAllocator::kSlabSize;
+      c.cursor = slab;
+      c.end = slab + EventAllocator::kSlabSize;
+    }
+  void *p = c.cursor;
+  c.cursor += size;
+  return p;
+}
+
+/**
+ * Allocate a block from a cache.
+ *
+ * \param [in,out] c The cache.
+ * \param [in] size The size of the block.
+ * \returns The block.
+ */
+inline void *
+DoAllocate (Cache &c, std::size_t size)
+{
+  c.stats.allocations++;
+  if (size > EventAllocator::kMaxSize)
+    {
+      c.stats.large++;
+      return ::operator new (size);
+    }
+  std::size_t cls = SizeClass (size);
+  FreeBlock *b = c.free[cls];
+  if (b != 0)
+    {
+      c.free[cls] = b->next;
+      c.stats.recycled++;
+      return b;
+    }
+  return Refill (c, cls);
+}
+
+/**
+ * Release a block to a cache.
+ *
+ * \param [in,out] c The cache.
+ * \param [in] p The block.
+ * \param [in] size The size of the block.
+ */
+inline void
+DoDeallocate (Cache &c, void *p, std::size_t size)
+{
+  c.stats.deallocations++;
+  if (size > EventAllocator::kMaxSize)
+    {
+      ::operator delete (p);
+      return;
+    }
+  std::size_t cls = SizeClass (size);
+  FreeBlock *b = static_cast<FreeBlock *> (p);
+  b->next = c.free[cls];
+  c.free[cls] = b;
+}
+
+} // unnamed namespace
+
+void *
+EventAllocator::Allocate (std::size_t size)
+{
+  if (!g_cache.dead)
+    {
+      return DoAllocate (g_cache, size);
+    }
+  Depot *depot = GetDepot ();
+  std::lock_guard<std::recursive_mutex> lock (depot->mutex);
+  return DoAllocate (depot->cache, size);
+}
+
+void
+EventAllocator::Deallocate (void *p, std::size_t size)
+{
+  if (p == 0)
+    {
+      return;
+    }
+  if (!g_cache.dead)
+    {
+      DoDeallocate (g_cache, p, size);
+      return;
+    }
+  Depot *depot = GetDepot ();
+  std::lock_guard<std::recursive_mutex> lock (depot->mutex);
+  DoDeallocate (depot->cache, p, size);
+}
+
+EventAllocator::Stats
+EventAllocator::GetStats (void)
+{
+  Depot *depot = GetDepot ();
+  std::lock_guard<std::recursive_mutex> lock (depot->mutex);
+  Stats stats = depot->cache.stats;
+  if (!g_cache.dead)
+    {
+      stats.allocations += g_cache.stats.allocations;
+      stats.deallocations += g_cache.stats.deallocations;
+      stats.recycled += g_cache.stats.recycled;
+      stats.large += g_cache.stats.large;
+    }
+  return stats;
+}
+
+} // namespace ns3
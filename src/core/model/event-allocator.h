@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_ALLOCATOR_H
+#define EVENT_ALLOCATOR_H
+
+#include <stdint.h>
+#include <cstddef>
+
+/**
+ * \file
+ * \ingroup events
+ * ns3::EventAllocator declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup events
+ * \brief Size-class slab allocator for EventImpl instances.
+ *
+ * Every EventImpl subclass created by MakeEvent stores the bound
+ * function (or object and member function) and its arguments inline,
+ * so the whole event closure is a single small object. This allocator
+ * serves those objects from per-thread free lists, one per size class
+ * of kGranularity bytes up to kMaxSize bytes, refilled by carving
+ * kSlabSize-byte slabs. In steady state scheduling an event thus does
+ * not call malloc at all; larger objects fall back to ::operator new.
+ *
+ * Blocks released by a thread go to that thread's free lists; when a
+ * thread exits, its free lists are handed over to a global depot from
+ * which other threads refill their own lists. Slabs are never returned
+ * to the system.
+ */
+class EventAllocator
+{
+public:
+  /** Allocation statistics. */
+  struct Stats
+  {
+    uint64_t allocations;      //!< Number of blocks allocated.
+    uint64_t deallocations;    //!< Number of blocks released.
+    uint64_t recycled;         //!< Allocations served from a free list.
+    uint64_t large;            //!< Allocations too large for the slabs.
+    uint64_t slabBytes;        //!< Total size of the slabs reserved.
+  };
+
+  /**
+   * Allocate a block.
+   *
+   * \param [in] size The size of the block in bytes.
+   * \returns A block of at least \p size bytes.
+   */
+  static void * Allocate (std::size_t size);
+  /**
+   * Release a block previously returned by Allocate.
+   *
+   * \param [in] p The block.
+   * \param [in] size The size given to Allocate.
+   */
+  static void Deallocate (void *p, std::size_t size);
+  /**
+   * Get the allocation statistics.
+   *
+   * The counters include the activity of the calling thread and
+   * of all the threads which have already exited.
+   *
+   * \returns The allocation statistics.
+   */
+  static Stats GetStats (void);
+
+  /** Size class granularity, in bytes. */
+  static const std::size_t kGranularity = 16;
+  /** Largest block size served from the slabs, in bytes. */
+  static const std::size_t kMaxSize = 256;
+  /** Size of a slab, in bytes. */
+  static const std::size_t kSlabSize = 64 * 1024;
+};
+
+} // namespace ns3
+
+#endif /* EVENT_ALLOCATOR_H */
@@ -21,6 +21,7 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
 #include "simple-ref-count.h"
 
 /**
@@ -66,6 +67,21 @@ public:
    */
   bool IsCancelled (void);
 
+  /**
+   * Allocate the storage of an event from the EventAllocator.
+   *
+   * \param [in] size The size of the concrete EventImpl subclass.
+   * \returns The storage for the event.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Release the storage of an event to the EventAllocator.
+   *
+   * \param [in] p The storage of the event.
+   * \param [in] size The size of the concrete EventImpl subclass.
+   */
+  static void operator delete (void *p, std::size_t size);
+
 protected:
   /**
    * Implementation for Invoke().
@@ -0,0 +1,371 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+#include "event-impl.h"
+#include "uinteger.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::LadderScheduler class.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (LadderScheduler);
+
+namespace {
+
+/**
+ * \ingroup scheduler
+ * Compare (greater than) two events, used to keep the bottom
+ * sorted by decreasing EventKey.
+ * \param [in] a The first event.
+ * \param [in] b The second event.
+ * \returns \c true if \c a > \c b
+ */
+inline bool
+EventGreater (const Scheduler::Event &a, const Scheduler::Event &b)
+{
+  return a.key > b.key;
+}
+
+/**
+ * \ingroup scheduler
+ * Remove an event from an unsorted bucket.
+ * \param [in,out] bucket The bucket.
+ * \param [in] ev The event to remove.
+ */
+inline void
+EraseUnsorted (std::vector<Scheduler::Event> &bucket, const Scheduler::Event &ev)
+{
+  for (std::vector<Scheduler::Event>::iterator i = bucket.begin ();
+       i != bucket.end (); ++i)
+    {
+      if (i->key.m_uid == ev.key.m_uid)
+        {
+          NS_ASSERT (ev.impl == i->impl);
+          *i = bucket.back ();
+          bucket.pop_back ();
+          return;
+        }
+    }
+  NS_ASSERT (false);
+}
+
+} // unnamed namespace
+
+TypeId
+LadderScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LadderScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<LadderScheduler> ()
+    .AddAttribute ("BucketThreshold",
+                   "Maximum number of events transferred at once from a "
+                   "rung to the bottom before the bucket is split into a new rung.",
+                   UintegerValue (50),
+                   MakeUintegerAccessor (&LadderScheduler::m_threshold),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MaxRungs",
+                   "Maximum number of rungs in the ladder.",
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&LadderScheduler::m_maxRungs),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+LadderScheduler::LadderScheduler ()
+  : m_topMin (0),
+    m_topMax (0),
+    m_topStart (0),
+    m_nRungs (0),
+    m_qSize (0),
+    m_threshold (50),
+    m_maxRungs (8)
+{
+  NS_LOG_FUNCTION (this);
+}
+LadderScheduler::~LadderScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LadderScheduler::Rung &
+LadderScheduler::PushRung (uint64_t start, uint64_t width, uint32_t nBuckets)
+{
+  NS_LOG_FUNCTION (this << start << width << nBuckets);
+  if (m_nRungs == m_rungs.size ())
+    {
+      m_rungs.push_back (Rung ());
+    }
+  Rung &rung = m_rungs[m_nRungs];
+  m_nRungs++;
+  // buckets are recycled from previous epochs, only grow the array.
+  if (rung.buckets.size () < nBuckets)
+    {
+      rung.buckets.resize (nBuckets);
+    }
+  rung.nBuckets = nBuckets;
+  rung.start = start;
+  rung.width = width;
+  rung.current = 0;
+  rung.count = 0;
+  return rung;
+}
+
+uint64_t
+LadderScheduler::CurrentStart (const Rung &rung) const
+{
+  return rung.start + rung.current * rung.width;
+}
+
+uint32_t
+LadderScheduler::FindRung (uint64_t ts) const
+{
+  uint32_t i = 0;
+  while (i < m_nRungs && ts < CurrentStart (m_rungs[i]))
+    {
+      i++;
+    }
+  return i;
+}
+
+void
+LadderScheduler::InsertBottom (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.key.m_ts << ev.key.m_uid);
+  Bucket::iterator pos = std::upper_bound (m_bottom.begin (), m_bottom.end (),
+                                           ev, EventGreater);
+  m_bottom.insert (pos, ev);
+}
+
+void
+LadderScheduler::SpawnFromBottom (void)
+{
+  if (m_bottom.size () <= m_threshold
+      || m_nRungs >= m_maxRungs)
+    {
+      return;
+    }
+  uint64_t min = m_bottom.back ().key.m_ts;
+  if (min == m_bottom.front ().key.m_ts)
+    {
+      // splitting would not spread the events.
+      return;
+    }
+  NS_LOG_FUNCTION (this);
+  uint64_t end = m_nRungs > 0 ? CurrentStart (m_rungs[m_nRungs - 1]) : m_topStart;
+  uint64_t n = m_bottom.size ();
+  uint64_t width = (end - min) / n + 1;
+  uint32_t nBuckets = (end - min + width - 1) / width;
+  Rung &rung = PushRung (min, width, nBuckets);
+  for (Bucket::const_iterator i = m_bottom.begin (); i != m_bottom.end (); ++i)
+    {
+      rung.buckets[(i->key.m_ts - min) / width].push_back (*i);
+    }
+  rung.count = n;
+  m_bottom.clear ();
+}
+
+void
+LadderScheduler::TransferTop (void)
+{
+  NS_LOG_FUNCTION (this << m_top.size () << m_topMin << m_topMax);
+  NS_ASSERT (!m_top.empty ());
+  // start a new epoch: the bucket width is sized such that the
+  // top events are spread over as many buckets as there are events.
+  uint32_t n = m_top.size ();
+  uint64_t width = (m_topMax - m_topMin) / n + 1;
+  Rung &rung = PushRung (m_topMin, width, n);
+  for (Bucket::const_iterator i = m_top.begin (); i != m_top.end (); ++i)
+    {
+      rung.buckets[(i->key.m_ts - m_topMin) / width].push_back (*i);
+    }
+  rung.count = n;
+  m_topStart = m_topMin + n * width;
+  m_top.clear ();
+}
+
+void
+LadderScheduler::FillBottom (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_bottom.empty ());
+  while (m_bottom.empty ())
+    {
+      if (m_nRungs == 0)
+        {
+          TransferTop ();
+        }
+      uint32_t r = m_nRungs - 1;
+      Rung *rung = &m_rungs[r];
+      if (rung->count == 0)
+        {
+          m_nRungs--;
+          continue;
+        }
+      while (rung->buckets[rung->current].empty ())
+        {
+          rung->current++;
+        }
+      uint32_t b = rung->current;
+      uint32_t n = rung->buckets[b].size ();
+      uint64_t start = CurrentStart (*rung);
+      rung->current++;
+      rung->count -= n;
+      if (n > m_threshold && rung->width > 1 && m_nRungs < m_maxRungs)
+        {
+          // split the bucket into a finer-grained rung.
+          uint64_t width = (rung->width + n - 1) / n;
+          uint32_t nBuckets = (rung->width + width - 1) / width;
+          NS_LOG_LOGIC ("spawn rung " << m_nRungs << " from bucket " << b <<
+                        " with " << n << " events, width=" << width);
+          Bucket events;
+          events.swap (rung->buckets[b]);
+          Rung &child = PushRung (start, width, nBuckets);
+          for (Bucket::const_iterator i = events.begin (); i != events.end (); ++i)
+            {
+              child.buckets[(i->key.m_ts - start) / width].push_back (*i);
+            }
+          child.count = n;
+          // give the storage back to the parent bucket.
+          events.clear ();
+          m_rungs[r].buckets[b].swap (events);
+        }
+      else
+        {
+          NS_LOG_LOGIC ("transfer bucket " << b << " of rung " << r <<
+                        " with " << n << " events");
+          m_bottom.swap (rung->buckets[b]);
+          std::sort (m_bottom.begin (), m_bottom.end (), EventGreater);
+        }
+    }
+}
+
+void
+LadderScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.key.m_ts << ev.key.m_uid);
+  uint64_t ts = ev.key.m_ts;
+  if (ts >= m_topStart)
+    {
+      if (m_top.empty ())
+        {
+          m_topMin = ts;
+          m_topMax = ts;
+        }
+      else
+        {
+          m_topMin = std::min (m_topMin, ts);
+          m_topMax = std::max (m_topMax, ts);
+        }
+      m_top.push_back (ev);
+    }
+  else
+    {
+      uint32_t r = FindRung (ts);
+      if (r < m_nRungs)
+        {
+          Rung &rung = m_rungs[r];
+          uint64_t b = (ts - rung.start) / rung.width;
+          NS_ASSERT (b < rung.nBuckets);
+          rung.buckets[b].push_back (ev);
+          rung.count++;
+        }
+      else
+        {
+          InsertBottom (ev);
+          SpawnFromBottom ();
+        }
+    }
+  m_qSize++;
+}
+
+bool
+LadderScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_qSize == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  if (m_bottom.empty ())
+    {
+      // refilling the bottom does not change the logical content.
+      const_cast<LadderScheduler *> (this)->FillBottom ();
+    }
+  return m_bottom.back ();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  if (m_bottom.empty ())
+    {
+      FillBottom ();
+    }
+  Scheduler::Event ev = m_bottom.back ();
+  m_bottom.pop_back ();
+  m_qSize--;
+  return ev;
+}
+
+void
+LadderScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.key.m_ts << ev.key.m_uid);
+  NS_ASSERT (!IsEmpty ());
+  uint64_t ts = ev.key.m_ts;
+  if (ts >= m_topStart)
+    {
+      EraseUnsorted (m_top, ev);
+    }
+  else
+    {
+      uint32_t r = FindRung (ts);
+      if (r < m_nRungs)
+        {
+          Rung &rung = m_rungs[r];
+          EraseUnsorted (rung.buckets[(ts - rung.start) / rung.width], ev);
+          rung.count--;
+        }
+      else
+        {
+          Bucket::iterator i = std::lower_bound (m_bottom.begin (), m_bottom.end (),
+                                                 ev, EventGreater);
+          NS_ASSERT (i != m_bottom.end () && i->key.m_uid == ev.key.m_uid);
+          m_bottom.erase (i);
+        }
+    }
+  m_qSize--;
+}
+
+} // namespace ns3
@@ -0,0 +1,165 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Declaration of ns3::LadderScheduler class.
+ */
+
+namespace ns3 {
+
+class EventImpl;
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue described in
+ * "Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by Wai Teng Tang, Rick Siow Mong Goh
+ * and Ian Li-Jin Thng (ACM TOMACS, 2005).
+ *
+ * Events are kept in three tiers:
+ *   - the \em top, an unsorted vector holding the far-future events;
+ *   - the \em ladder, a stack of rungs made of fixed-width buckets.
+ *     Each rung covers the time span of one bucket of the rung above;
+ *   - the \em bottom, a small sorted vector from which the earliest
+ *     event is dequeued.
+ *
+ * New events are appended to whichever tier covers their timestamp,
+ * so that only the bottom tier is ever kept sorted. When the bottom
+ * runs empty, the first non-empty bucket of the lowest rung is
+ * transferred to it, or split into a new rung if it holds more than
+ * "BucketThreshold" events. When the whole ladder is exhausted, a new
+ * epoch starts: the top is spread over a freshly sized first rung,
+ * whose bucket width is derived from the span of the top events.
+ *
+ * All tiers use contiguous storage (std::vector) which is recycled
+ * from one epoch to the next, so that in steady state insertion and
+ * removal do not allocate memory.
+ */
+class LadderScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  LadderScheduler ();
+  /** Destructor. */
+  virtual ~LadderScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /** Ladder bucket type: an unsorted vector of Events. */
+  typedef std::vector<Scheduler::Event> Bucket;
+
+  /** A rung of the ladder: an array of equal-width buckets. */
+  struct Rung
+  {
+    std::vector<Bucket> buckets; //!< The buckets of this rung.
+    uint32_t nBuckets; //!< Number of buckets in use.
+    uint64_t start;    //!< Timestamp at the start of the first bucket.
+    uint64_t width;    //!< Duration of a bucket, in dimensionless time units.
+    uint32_t current;  //!< Index of the first bucket not yet dequeued.
+    uint32_t count;    //!< Number of events stored in this rung.
+  };
+
+  /**
+   * Push a new, empty rung on the ladder.
+   *
+   * \param [in] start The timestamp at the start of the first bucket.
+   * \param [in] width The bucket width.
+   * \param [in] nBuckets The number of buckets.
+   * \returns The new rung.
+   */
+  Rung & PushRung (uint64_t start, uint64_t width, uint32_t nBuckets);
+  /**
+   * Compute the start of the current bucket of a rung.
+   *
+   * \param [in] rung The rung.
+   * \returns The timestamp at the start of the current bucket.
+   */
+  inline uint64_t CurrentStart (const Rung &rung) const;
+  /**
+   * Find the rung covering a timestamp.
+   *
+   * \param [in] ts The dimensionless time.
+   * \returns The rung index, or m_nRungs if the timestamp belongs
+   *          to the bottom.
+   */
+  inline uint32_t FindRung (uint64_t ts) const;
+  /**
+   * Insert an event in the bottom, keeping it sorted.
+   *
+   * \param [in] ev The new Event.
+   */
+  void InsertBottom (const Scheduler::Event &ev);
+  /**
+   * Move the content of the bottom to a new rung if it grew too large.
+   */
+  void SpawnFromBottom (void);
+  /**
+   * Spread the top events over a new first rung, starting a new epoch.
+   */
+  void TransferTop (void);
+  /**
+   * Refill the bottom from the ladder and the top.
+   */
+  void FillBottom (void);
+
+  /** The top: unsorted far-future events. */
+  Bucket m_top;
+  /** Smallest timestamp of the events in the top. */
+  uint64_t m_topMin;
+  /** Largest timestamp of the events in the top. */
+  uint64_t m_topMax;
+  /** Events with a timestamp larger or equal to this go to the top. */
+  uint64_t m_topStart;
+  /** The ladder. Only the first m_nRungs rungs are in use. */
+  std::vector<Rung> m_rungs;
+  /** Number of rungs in use. */
+  uint32_t m_nRungs;
+  /** The bottom, sorted by decreasing EventKey. */
+  Bucket m_bottom;
+  /** Number of events in queue. */
+  uint32_t m_qSize;
+  /** Maximum number of events in a bucket before it is split. */
+  uint32_t m_threshold;
+  /** Maximum number of rungs. */
+  uint32_t m_maxRungs;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
@@ -25,6 +25,8 @@
 #include "assert.h"
 #include "ns3/core-config.h"
 #include "fatal-error.h"
+#include "replication.h"
+#include "unused.h"
 
 #ifdef HAVE_GETENV
 #include <cstring>
@@ -54,6 +56,16 @@ static LogTimePrinter g_logTimePrinter = 0;
  * The LogNodePrinter.
  */
 static LogNodePrinter g_logNodePrinter = 0;
+/**
+ * \ingroup logging
+ * The LogTimePrinter of a thread running a Replication.
+ */
+static thread_local LogTimePrinter g_replicationTimePrinter = 0;
+/**
+ * \ingroup logging
+ * The LogNodePrinter of a thread running a Replication.
+ */
+static thread_local LogNodePrinter g_replicationNodePrinter = 0;
 
 /**
  * \ingroup logging
@@ -610,6 +622,14 @@ static void CheckEnvironmentVariables (void)
 }
 void LogSetTimePrinter (LogTimePrinter printer)
 {
+  if (Replication::IsEntered ())
+    {
+      g_replicationTimePrinter = printer;
+      // the replications may run concurrently, check the variables once
+      static bool checked = (CheckEnvironmentVariables (), true);
+      NS_UNUSED (checked);
+      return;
+    }
   g_logTimePrinter = printer;
   /** \internal
    *  This is the only place where we are more or less sure that all log variables
@@ -619,16 +639,21 @@ void LogSetTimePrinter (LogTimePrinter printer)
 }
 LogTimePrinter LogGetTimePrinter (void)
 {
-  return g_logTimePrinter;
+  return Replication::IsEntered () ? g_replicationTimePrinter : g_logTimePrinter;
 }
 
 void LogSetNodePrinter (LogNodePrinter printer)
 {
+  if (Replication::IsEntered ())
+    {
+      g_replicationNodePrinter = printer;
+      return;
+    }
   g_logNodePrinter = printer;
 }
 LogNodePrinter LogGetNodePrinter (void)
 {
-  return g_logNodePrinter;
+  return Replication::IsEntered () ? g_replicationNodePrinter : g_logNodePrinter;
 }
 
 
@@ -22,7 +22,8 @@
 #include "assert.h"
 #include "abort.h"
 #include "names.h"
-#include "singleton.h"
+#include "non-copyable.h"
+#include "replication.h"
 
 /**
  * \file
@@ -118,7 +119,7 @@ NameNode::~NameNode ()
  * \ingroup config
  * The singleton root Names object.
  */
-class NamesPriv : public Singleton<NamesPriv>
+class NamesPriv : private NonCopyable
 {
 public:
   /** Constructor. */
@@ -126,6 +127,13 @@ public:
   /** Destructor. */
   ~NamesPriv ();
 
+  /**
+   * Get the root Names object, of which a thread running a Replication
+   * has an instance of its own.
+   * \return A pointer to the root Names object.
+   */
+  static NamesPriv *Get (void);
+
   /**
    * \copydoc Names::Add(std::string,Ptr<Object>object)
    * \return \c true if the object was named successfully.
@@ -215,6 +223,14 @@ NamesPriv::~NamesPriv ()
   m_root.m_name = "";
 }
 
+NamesPriv *
+NamesPriv::Get (void)
+{
+  static NamesPriv names;
+  static thread_local NamesPriv replicationNames;
+  return Replication::IsEntered () ? &replicationNames : &names;
+}
+
 void
 NamesPriv::Clear (void)
 {
@@ -87,7 +87,7 @@ ObjectBase::ConstructSelf (const AttributeConstructionList &attributes)
       NS_LOG_DEBUG ("construct tid="<<tid.GetName ()<<", params="<<tid.GetAttributeN ());
       for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
         {
-          struct TypeId::AttributeInformation info = tid.GetAttribute(i);
+          const struct TypeId::AttributeInformation &info = tid.GetAttribute(i);
           NS_LOG_DEBUG ("try to construct \""<< tid.GetName ()<<"::"<<
                         info.name <<"\"");
           // is this attribute stored in this AttributeConstructionList instance ?
@@ -574,6 +574,28 @@ RealtimeSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay,
   }
 }
 
+EventId
+RealtimeSimulatorImpl::ScheduleInContext (uint32_t context, Time const &delay, EventImpl *impl)
+{
+  NS_LOG_FUNCTION (this << context << delay << impl);
+  NS_ASSERT_MSG (SystemThread::Equals (m_main), "ScheduleInContext called from another thread");
+
+  Scheduler::Event ev;
+  {
+    CriticalSection cs (m_mutex);
+    ev.impl = impl;
+    ev.key.m_ts = m_currentTs + delay.GetTimeStep ();
+    ev.key.m_context = context;
+    ev.key.m_uid = m_uid;
+    m_uid++;
+    m_unscheduledEvents++;
+    m_events->Insert (ev);
+    m_synchronizer->Signal ();
+  }
+
+  return EventId (impl, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
 EventId
 RealtimeSimulatorImpl::ScheduleNow (EventImpl *impl)
 {
@@ -0,0 +1,60 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "replication.h"
+#include "simulator.h"
+#include "names.h"
+#include "rng-seed-manager.h"
+#include "assert.h"
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::Replication implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Replication");
+
+thread_local bool Replication::m_entered = false;
+
+void
+Replication::Enter (uint64_t run)
+{
+  NS_LOG_FUNCTION (run);
+  NS_ASSERT_MSG (!m_entered, "The thread already runs a replication");
+  // the replication starts from the seed of the process
+  uint32_t seed = RngSeedManager::GetSeed ();
+  m_entered = true;
+  RngSeedManager::SetSeed (seed);
+  RngSeedManager::SetRun (run);
+  RngSeedManager::ResetNextStreamIndex ();
+}
+
+void
+Replication::Leave (void)
+{
+  NS_ASSERT_MSG (m_entered, "The thread does not run a replication");
+  // the nodes and channels unregister their Config roots when destroyed
+  Simulator::Destroy ();
+  Names::Clear ();
+  m_entered = false;
+  NS_LOG_FUNCTION_NOARGS ();
+}
+
+} // namespace ns3
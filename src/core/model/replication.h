@@ -0,0 +1,87 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef REPLICATION_H
+#define REPLICATION_H
+
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::Replication declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ * \brief Give a thread a simulation of its own.
+ *
+ * By default all the threads of a process share one simulation: the
+ * Simulator implementation, the NodeList and ChannelList, the Names,
+ * the Config root namespace objects, the SimulationSingleton instances,
+ * the log time and node printers and the RngSeedManager seed, run and
+ * stream numbers. A thread which enters a replication gets an instance
+ * of each of them of its own until it leaves it, so that independent
+ * replications of a simulation can run concurrently in one process.
+ *
+ * Everything else stays shared: attribute defaults, GlobalValues and
+ * log components must be set before the replications start, and
+ * objects handed to several replications must not be reference counted
+ * since the reference counts are not atomic. The packet uids and free
+ * lists are per thread, so a replication is only reproducible when its
+ * thread runs nothing else, as with the ReplicationRunner.
+ *
+ * TypeIds are registered on first use, which may happen in several
+ * replications at once: the IidManager serializes the registrations
+ * and the lookups by name, and never moves the record of a TypeId, so
+ * that the attributes a replication reads stay valid while another one
+ * registers a type. Registering every TypeId beforehand would not do,
+ * since the types without NS_OBJECT_ENSURE_REGISTERED, such as class
+ * templates, are only known once used.
+ */
+class Replication
+{
+public:
+  /**
+   * Enter a replication in the calling thread, with an empty simulation.
+   * \param [in] run The RngRun of the replication
+   */
+  static void Enter (uint64_t run);
+  /**
+   * Destroy the simulation of the calling thread, which goes back to the
+   * simulation of the process.
+   */
+  static void Leave (void);
+  /**
+   * \returns true if the calling thread runs a replication
+   */
+  static bool IsEntered (void);
+
+private:
+  /** Whether the thread runs a replication. */
+  static thread_local bool m_entered;
+};
+
+inline bool
+Replication::IsEntered (void)
+{
+  return m_entered;
+}
+
+} // namespace ns3
+
+#endif /* REPLICATION_H */
@@ -23,6 +23,7 @@
 #include "integer.h"
 #include "config.h"
 #include "log.h"
+#include "replication.h"
 
 /**
  * \file
@@ -66,11 +67,25 @@ static ns3::GlobalValue g_rngRun ("RngRun",
                                   "The substream index used for all streams",
                                   ns3::IntegerValue (1),
                                   ns3::MakeIntegerChecker<int64_t> ());
-
+/**
+ * \relates RngSeedManager
+ * The seed, run and next stream index of a thread running a Replication,
+ * which replace the global ones in that thread.
+ */
+static thread_local struct
+{
+  uint32_t seed;            //!< The seed
+  uint64_t run;             //!< The run number
+  uint64_t nextStreamIndex; //!< The next stream index
+} g_replication = { 1, 1, 0 };
 
 uint32_t RngSeedManager::GetSeed (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
+  if (Replication::IsEntered ())
+    {
+      return g_replication.seed;
+    }
   IntegerValue seedValue;
   g_rngSeed.GetValue (seedValue);
   return seedValue.Get ();
@@ -79,18 +94,32 @@ void
 RngSeedManager::SetSeed (uint32_t seed)
 {
   NS_LOG_FUNCTION (seed);
+  if (Replication::IsEntered ())
+    {
+      g_replication.seed = seed;
+      return;
+    }
   Config::SetGlobal ("RngSeed", IntegerValue(seed));
 }
 
 void RngSeedManager::SetRun (uint64_t run)
 {
   NS_LOG_FUNCTION (run);
+  if (Replication::IsEntered ())
+    {
+      g_replication.run = run;
+      return;
+    }
   Config::SetGlobal ("RngRun", IntegerValue (run));
 }
 
 uint64_t RngSeedManager::GetRun ()
 {
   NS_LOG_FUNCTION_NOARGS ();
+  if (Replication::IsEntered ())
+    {
+      return g_replication.run;
+    }
   IntegerValue value;
   g_rngRun.GetValue (value);
   int run = value.Get();
@@ -100,9 +129,18 @@ uint64_t RngSeedManager::GetRun ()
 uint64_t RngSeedManager::GetNextStreamIndex (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  uint64_t next = g_nextStreamIndex;
-  g_nextStreamIndex++;
+  uint64_t &index = Replication::IsEntered () ? g_replication.nextStreamIndex : g_nextStreamIndex;
+  uint64_t next = index;
+  index++;
   return next;
 }
 
+void
+RngSeedManager::ResetNextStreamIndex (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  uint64_t &index = Replication::IsEntered () ? g_replication.nextStreamIndex : g_nextStreamIndex;
+  index = 0;
+}
+
 } // namespace ns3
@@ -88,6 +88,8 @@ public:
    *   ./simulation 1
    *   ...Results for run 1:...
    * \endcode
+   * The runs can also share one process, each in a thread running a
+   * Replication, whose seed and run do not affect the other threads.
    *
    * \param [in] run The run number.
    */
@@ -104,6 +106,12 @@ public:
    * \returns The next stream index.
    */
   static uint64_t GetNextStreamIndex(void);
+  /**
+   * Restart the automatic assignment of stream indices at 0, so that
+   * the random variables created next get the same streams as in a
+   * new process.
+   */
+  static void ResetNextStreamIndex (void);
 
 };
 
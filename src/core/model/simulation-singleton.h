@@ -36,6 +36,9 @@ namespace ns3 {
  * type will be automatically deleted upon a call
  * to Simulator::Destroy.
  *
+ * Like the simulation, the instance is per thread in the threads
+ * running a Replication.
+ *
  * For a singleton with a lifetime bounded by the process,
  * not the simulation run, see Singleton.
  */
@@ -99,6 +102,7 @@ private:
  ********************************************************************/
 
 #include "simulator.h"
+#include "replication.h"
 
 namespace ns3 {
 
@@ -115,12 +119,14 @@ T **
 SimulationSingleton<T>::GetObject (void)
 {
   static T *pobject = 0;
-  if (pobject == 0)
+  static thread_local T *replicationObject = 0;
+  T **ppobject = Replication::IsEntered () ? &replicationObject : &pobject;
+  if (*ppobject == 0)
     {
-      pobject = new T ();
+      *ppobject = new T ();
       Simulator::ScheduleDestroy (&SimulationSingleton<T>::DeleteObject);
     }
-  return &pobject;
+  return ppobject;
 }
 
 template <typename T>
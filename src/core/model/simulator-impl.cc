@@ -42,4 +42,22 @@ SimulatorImpl::GetTypeId (void)
   return tid;
 }
 
+uint32_t
+SimulatorImpl::GetEventCount (void) const
+{
+  return 0;
+}
+
+uint32_t
+SimulatorImpl::GetCancelledEventCount (void) const
+{
+  return 0;
+}
+
+bool
+SimulatorImpl::IsConcurrent (void) const
+{
+  return false;
+}
+
 } // namespace ns3
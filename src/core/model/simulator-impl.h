@@ -67,6 +67,8 @@ public:
   virtual EventId Schedule (const Time &delay, EventImpl *event) = 0;
   /** \copydoc Simulator::ScheduleWithContext(uint32_t,const Time&,EventImpl*) */
   virtual void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event) = 0;
+  /** \copydoc Simulator::ScheduleInContext */
+  virtual EventId ScheduleInContext (uint32_t context, const Time &delay, EventImpl *event) = 0;
   /** \copydoc Simulator::ScheduleNow(const Ptr<EventImpl>&) */
   virtual EventId ScheduleNow (EventImpl *event) = 0;
   /** \copydoc Simulator::ScheduleDestroy(const Ptr<EventImpl>&) */
@@ -99,6 +101,25 @@ public:
   virtual uint32_t GetSystemId () const = 0; 
   /** \copydoc Simulator::GetContext */
   virtual uint32_t GetContext (void) const = 0;
+  /**
+   * \copydoc Simulator::GetEventCount
+   *
+   * Implementations which do not count their events return 0.
+   */
+  virtual uint32_t GetEventCount (void) const;
+  /**
+   * \copydoc Simulator::GetCancelledEventCount
+   *
+   * Implementations which do not count their events return 0.
+   */
+  virtual uint32_t GetCancelledEventCount (void) const;
+  /**
+   * \copydoc Simulator::IsConcurrent
+   *
+   * Implementations run the events of all the contexts in one thread
+   * unless they override this method.
+   */
+  virtual bool IsConcurrent (void) const;
 };
 
 } // namespace ns3
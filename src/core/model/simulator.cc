@@ -24,6 +24,7 @@
 #include "map-scheduler.h"
 #include "event-impl.h"
 #include "des-metrics.h"
+#include "replication.h"
 
 #include "ptr.h"
 #include "string.h"
@@ -110,12 +111,16 @@ NodePrinter (std::ostream &os)
 /**
  * \ingroup simulator
  * \brief Get the static SimulatorImpl instance.
+ *
+ * A thread running a Replication has an instance of its own.
+ *
  * \return The SimulatorImpl instance pointer.
  */
 static SimulatorImpl **PeekImpl (void)
 {
   static SimulatorImpl *impl = 0;
-  return &impl;
+  static thread_local SimulatorImpl *replicationImpl = 0;
+  return Replication::IsEntered () ? &replicationImpl : &impl;
 }
 
 /**
@@ -256,6 +261,14 @@ Simulator::ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *
   return GetImpl ()->ScheduleWithContext (context, delay, impl);
 }
 EventId
+Simulator::ScheduleInContext (uint32_t context, const Time &delay, EventImpl *impl)
+{
+#ifdef ENABLE_DES_METRICS
+  DesMetrics::Get ()->TraceWithContext (context, Now (), delay);
+#endif
+  return GetImpl ()->ScheduleInContext (context, delay, impl);
+}
+EventId
 Simulator::ScheduleDestroy (const Ptr<EventImpl> &ev)
 {
   return DoScheduleDestroy (GetPointer (ev));
@@ -355,6 +368,24 @@ Simulator::GetContext (void)
   return GetImpl ()->GetContext ();
 }
 
+uint32_t
+Simulator::GetEventCount (void)
+{
+  return GetImpl ()->GetEventCount ();
+}
+
+uint32_t
+Simulator::GetCancelledEventCount (void)
+{
+  return GetImpl ()->GetCancelledEventCount ();
+}
+
+bool
+Simulator::IsConcurrent (void)
+{
+  return GetImpl ()->IsConcurrent ();
+}
+
 uint32_t
 Simulator::GetSystemId (void)
 {
@@ -1157,6 +1157,20 @@ public:
    */
   static void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event);
 
+  /**
+   * Schedule a future event execution (in a different context) from
+   * the thread running the simulation.
+   *
+   * Unlike ScheduleWithContext, this method is not thread-safe, and it
+   * returns the id of the event, which can be cancelled.
+   *
+   * @param [in] context Event context.
+   * @param [in] delay Delay until the event expires.
+   * @param [in] event The event to schedule.
+   * @returns A unique identifier for the newly-scheduled event.
+   */
+  static EventId ScheduleInContext (uint32_t context, const Time &delay, EventImpl *event);
+
   /**
    * Schedule an event to run at the end of the simulation, after
    * the Stop() time or condition has been reached.
@@ -1182,6 +1196,37 @@ public:
    * @return The system id for this simulator.
    */
   static uint32_t GetSystemId (void);
+
+  /**
+   * Get the number of events in the event queue which will run, that
+   * is, which have not been cancelled.
+   *
+   * @return The number of live events.
+   */
+  static uint32_t GetEventCount (void);
+
+  /**
+   * Get the number of cancelled events which the event queue still
+   * holds.
+   *
+   * EventId::Cancel only marks an event, which stays in the queue
+   * until its time comes. The simulator drops them in a batch once
+   * they make up a large enough share of the queue.
+   *
+   * @return The number of dead events.
+   */
+  static uint32_t GetCancelledEventCount (void);
+
+  /**
+   * Check whether the events of different contexts may run at the same
+   * time in different threads, as with the MultithreadedSimulatorImpl.
+   *
+   * State shared by all the contexts of a simulation must then not be
+   * touched by the events.
+   *
+   * @return true if the events of different contexts may run concurrently.
+   */
+  static bool IsConcurrent (void);
   
 private:
   /** Default constructor. */
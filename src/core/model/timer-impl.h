@@ -131,6 +131,12 @@ public:
   virtual EventId Schedule (const Time &delay) = 0;
   /** Invoke the expire function. */
   virtual void Invoke (void) = 0;
+  /**
+   * Copy the function and its arguments.
+   *
+   * \returns A new TimerImpl owned by the caller.
+   */
+  virtual TimerImpl *Copy (void) const = 0;
 };
 
 } // namespace ns3
@@ -278,6 +284,10 @@ MakeTimerImpl (IntToType<0>, FN fn)
     {
       m_fn ();
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new FnTimerImplZero (*this);
+    }
     FN m_fn;
   } *function = new FnTimerImplZero (fn);
   return function;
@@ -313,6 +323,10 @@ MakeTimerImpl (IntToType<1>, FN fn)
     {
       m_fn (m_a1);
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new FnTimerImplOne (*this);
+    }
     FN m_fn;
     T1Stored m_a1;
   } *function = new FnTimerImplOne (fn);
@@ -353,6 +367,10 @@ MakeTimerImpl (IntToType<2>, FN fn)
     {
       m_fn (m_a1, m_a2);
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new FnTimerImplTwo (*this);
+    }
     FN m_fn;
     T1Stored m_a1;
     T2Stored m_a2;
@@ -398,6 +416,10 @@ MakeTimerImpl (IntToType<3>, FN fn)
     {
       m_fn (m_a1, m_a2, m_a3);
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new FnTimerImplThree (*this);
+    }
     FN m_fn;
     T1Stored m_a1;
     T2Stored m_a2;
@@ -448,6 +470,10 @@ MakeTimerImpl (IntToType<4>, FN fn)
     {
       m_fn (m_a1, m_a2, m_a3, m_a4);
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new FnTimerImplFour (*this);
+    }
     FN m_fn;
     T1Stored m_a1;
     T2Stored m_a2;
@@ -503,6 +529,10 @@ MakeTimerImpl (IntToType<5>, FN fn)
     {
       m_fn (m_a1, m_a2, m_a3, m_a4, m_a5);
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new FnTimerImplFive (*this);
+    }
     FN m_fn;
     T1Stored m_a1;
     T2Stored m_a2;
@@ -563,6 +593,10 @@ MakeTimerImpl (IntToType<6>, FN fn)
     {
       m_fn (m_a1, m_a2, m_a3, m_a4, m_a5, m_a6);
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new FnTimerImplSix (*this);
+    }
     FN m_fn;
     T1Stored m_a1;
     T2Stored m_a2;
@@ -653,6 +687,10 @@ MakeTimerImpl (IntToType<0>, MEM_PTR memPtr, OBJ_PTR objPtr)
     {
       (TimerImplMemberTraits<OBJ_PTR>::GetReference (m_objPtr).*m_memPtr)();
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new MemFnTimerImplZero (*this);
+    }
     MEM_PTR m_memPtr;
     OBJ_PTR m_objPtr;
   } *function = new MemFnTimerImplZero (memPtr, objPtr);
@@ -690,6 +728,10 @@ MakeTimerImpl (IntToType<1>, MEM_PTR memPtr, OBJ_PTR objPtr)
     {
       (TimerImplMemberTraits<OBJ_PTR>::GetReference (m_objPtr).*m_memPtr)(m_a1);
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new MemFnTimerImplOne (*this);
+    }
     MEM_PTR m_memPtr;
     OBJ_PTR m_objPtr;
     T1Stored m_a1;
@@ -732,6 +774,10 @@ MakeTimerImpl (IntToType<2>, MEM_PTR memPtr, OBJ_PTR objPtr)
     {
       (TimerImplMemberTraits<OBJ_PTR>::GetReference (m_objPtr).*m_memPtr)(m_a1, m_a2);
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new MemFnTimerImplTwo (*this);
+    }
     MEM_PTR m_memPtr;
     OBJ_PTR m_objPtr;
     T1Stored m_a1;
@@ -779,6 +825,10 @@ MakeTimerImpl (IntToType<3>, MEM_PTR memPtr, OBJ_PTR objPtr)
     {
       (TimerImplMemberTraits<OBJ_PTR>::GetReference (m_objPtr).*m_memPtr)(m_a1, m_a2, m_a3);
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new MemFnTimerImplThree (*this);
+    }
     MEM_PTR m_memPtr;
     OBJ_PTR m_objPtr;
     T1Stored m_a1;
@@ -831,6 +881,10 @@ MakeTimerImpl (IntToType<4>, MEM_PTR memPtr, OBJ_PTR objPtr)
     {
       (TimerImplMemberTraits<OBJ_PTR>::GetReference (m_objPtr).*m_memPtr)(m_a1, m_a2, m_a3, m_a4);
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new MemFnTimerImplFour (*this);
+    }
     MEM_PTR m_memPtr;
     OBJ_PTR m_objPtr;
     T1Stored m_a1;
@@ -888,6 +942,10 @@ MakeTimerImpl (IntToType<5>, MEM_PTR memPtr, OBJ_PTR objPtr)
     {
       (TimerImplMemberTraits<OBJ_PTR>::GetReference (m_objPtr).*m_memPtr)(m_a1, m_a2, m_a3, m_a4, m_a5);
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new MemFnTimerImplFive (*this);
+    }
     MEM_PTR m_memPtr;
     OBJ_PTR m_objPtr;
     T1Stored m_a1;
@@ -950,6 +1008,10 @@ MakeTimerImpl (IntToType<6>, MEM_PTR memPtr, OBJ_PTR objPtr)
     {
       (TimerImplMemberTraits<OBJ_PTR>::GetReference (m_objPtr).*m_memPtr)(m_a1, m_a2, m_a3, m_a4, m_a5, m_a6);
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new MemFnTimerImplSix (*this);
+    }
     MEM_PTR m_memPtr;
     OBJ_PTR m_objPtr;
     T1Stored m_a1;
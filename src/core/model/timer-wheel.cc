@@ -0,0 +1,393 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "timer-wheel.h"
+#include "simulator.h"
+#include "simulation-singleton.h"
+#include "make-event.h"
+#include "global-value.h"
+#include "log.h"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TimerWheel");
+
+/**
+ * \ingroup timer
+ * The length of a tick of the TimerWheel.
+ *
+ * A Timer or Watchdog enters the event queue at most one tick before
+ * it expires: a shorter tick avoids more cancelled events, a longer
+ * one needs fewer wakeups of the wheel.
+ */
+static GlobalValue g_timerWheelTick = GlobalValue ("TimerWheelTick",
+                                                   "The length of a tick of the wheel holding Timers and Watchdogs",
+                                                   TimeValue (MilliSeconds (1)),
+                                                   MakeTimeChecker ());
+
+/** The tick of the wheel when no wakeup is scheduled. */
+static const uint64_t NO_TICK = std::numeric_limits<uint64_t>::max ();
+
+TimerWheel::Entry::Entry ()
+  : m_context (0),
+    m_wheel (0),
+    m_list (0),
+    m_prev (0),
+    m_next (0)
+{
+}
+
+TimerWheel::Entry::Entry (const Entry &o)
+  : m_context (0),
+    m_wheel (0),
+    m_list (0),
+    m_prev (0),
+    m_next (0)
+{
+}
+
+TimerWheel::Entry &
+TimerWheel::Entry::operator = (const Entry &o)
+{
+  Cancel ();
+  return *this;
+}
+
+TimerWheel::Entry::~Entry ()
+{
+  Cancel ();
+}
+
+void
+TimerWheel::Entry::SetFunction (Callback<void> function)
+{
+  m_function = function;
+}
+
+void
+TimerWheel::Entry::Schedule (const Time &delay)
+{
+  NS_ASSERT_MSG (!m_function.IsNull (), "Scheduling a timer without a function");
+  Cancel ();
+  m_expiry = Simulator::Now () + delay;
+  if (Simulator::IsConcurrent ())
+    {
+      m_event = Simulator::Schedule (delay, &TimerWheel::Entry::Expire, this);
+      return;
+    }
+  m_context = Simulator::GetContext ();
+  SimulationSingleton<TimerWheel>::Get ()->Add (this);
+}
+
+void
+TimerWheel::Entry::Cancel (void)
+{
+  if (m_wheel != 0)
+    {
+      m_wheel->Remove (this);
+    }
+  else if (m_event.PeekEventImpl () != 0)
+    {
+      Simulator::Cancel (m_event);
+      m_event = EventId ();
+    }
+}
+
+bool
+TimerWheel::Entry::IsPending (void) const
+{
+  return m_wheel != 0 || m_event.PeekEventImpl () != 0;
+}
+
+Time
+TimerWheel::Entry::GetExpiry (void) const
+{
+  return m_expiry;
+}
+
+void
+TimerWheel::Entry::Expire (void)
+{
+  m_event = EventId ();
+  m_function ();
+}
+
+TimerWheel::TimerWheel ()
+  : m_overflow (0),
+    m_queued (0),
+    m_wakeupTick (NO_TICK)
+{
+  NS_LOG_FUNCTION (this);
+  TimeValue tick;
+  g_timerWheelTick.GetValue (tick);
+  m_tickSteps = std::max<int64_t> (tick.Get ().GetTimeStep (), 1);
+  m_tick = GetTick (Simulator::Now ());
+  for (uint32_t level = 0; level < LEVELS; level++)
+    {
+      std::fill (m_slots[level], m_slots[level] + SLOTS, (Entry *)0);
+      m_occupied[level] = 0;
+    }
+}
+
+TimerWheel::~TimerWheel ()
+{
+  NS_LOG_FUNCTION (this);
+  // The entries outlive the wheel, which is deleted with the simulation
+  std::vector<Entry *> lists (m_slots[0], m_slots[0] + LEVELS * SLOTS);
+  lists.push_back (m_overflow);
+  lists.push_back (m_queued);
+  for (std::vector<Entry *>::const_iterator i = lists.begin (); i != lists.end (); ++i)
+    {
+      for (Entry *entry = *i; entry != 0; entry = entry->m_next)
+        {
+          if (entry->m_event.PeekEventImpl () != 0)
+            {
+              Simulator::Cancel (entry->m_event);
+              entry->m_event = EventId ();
+            }
+          entry->m_wheel = 0;
+          entry->m_list = 0;
+        }
+    }
+  m_wakeup.Cancel ();
+}
+
+uint64_t
+TimerWheel::GetTick (const Time &time) const
+{
+  return time.GetTimeStep () / m_tickSteps;
+}
+
+void
+TimerWheel::Add (Entry *entry)
+{
+  NS_LOG_FUNCTION (this << entry << entry->m_expiry);
+  entry->m_wheel = this;
+  uint64_t now = GetTick (Simulator::Now ());
+  if (now > m_tick)
+    {
+      Advance (now);
+    }
+  Place (entry);
+  if (entry->m_list != &m_queued && GetNextTick () < m_wakeupTick)
+    {
+      ScheduleWakeup ();
+    }
+}
+
+void
+TimerWheel::Remove (Entry *entry)
+{
+  NS_LOG_FUNCTION (this << entry);
+  Unlink (entry);
+  if (entry->m_event.PeekEventImpl () != 0)
+    {
+      Simulator::Cancel (entry->m_event);
+      entry->m_event = EventId ();
+    }
+  entry->m_wheel = 0;
+}
+
+void
+TimerWheel::Place (Entry *entry)
+{
+  uint64_t tick = GetTick (entry->m_expiry);
+  if (tick <= m_tick)
+    {
+      Enqueue (entry);
+      return;
+    }
+  // The level is that of the highest digit in which the expiry tick
+  // differs from the current one, so that the slot is due when the
+  // current tick reaches it
+  uint64_t diff = tick ^ m_tick;
+  for (uint32_t level = 0; level < LEVELS; level++)
+    {
+      if ((diff >> (BITS * (level + 1))) == 0)
+        {
+          uint32_t slot = (tick >> (BITS * level)) & (SLOTS - 1);
+          Link (entry, &m_slots[level][slot]);
+          m_occupied[level] |= (uint64_t)1 << slot;
+          return;
+        }
+    }
+  Link (entry, &m_overflow);
+}
+
+void
+TimerWheel::Enqueue (Entry *entry)
+{
+  NS_LOG_FUNCTION (this << entry << entry->m_expiry);
+  entry->m_event = Simulator::ScheduleInContext (entry->m_context, entry->m_expiry - Simulator::Now (),
+                                                 MakeEvent (&TimerWheel::Expire, this, entry));
+  Link (entry, &m_queued);
+}
+
+void
+TimerWheel::Link (Entry *entry, Entry **list)
+{
+  entry->m_list = list;
+  entry->m_prev = 0;
+  entry->m_next = *list;
+  if (*list != 0)
+    {
+      (*list)->m_prev = entry;
+    }
+  *list = entry;
+}
+
+void
+TimerWheel::Unlink (Entry *entry)
+{
+  if (entry->m_prev != 0)
+    {
+      entry->m_prev->m_next = entry->m_next;
+    }
+  else
+    {
+      *entry->m_list = entry->m_next;
+    }
+  if (entry->m_next != 0)
+    {
+      entry->m_next->m_prev = entry->m_prev;
+    }
+  if (*entry->m_list == 0 && entry->m_list != &m_overflow && entry->m_list != &m_queued)
+    {
+      uint32_t index = entry->m_list - m_slots[0];
+      m_occupied[index / SLOTS] &= ~((uint64_t)1 << (index % SLOTS));
+    }
+  entry->m_list = 0;
+}
+
+uint64_t
+TimerWheel::GetNextTick (void) const
+{
+  uint64_t next = NO_TICK;
+  for (uint32_t level = 0; level < LEVELS; level++)
+    {
+      // Every slot in use lies after the digit of the current tick
+      uint32_t digit = (m_tick >> (BITS * level)) & (SLOTS - 1);
+      uint64_t after = m_occupied[level] & ~(((uint64_t)2 << digit) - 1);
+      if (after == 0)
+        {
+          continue;
+        }
+      uint32_t slot = __builtin_ctzll (after);
+      uint64_t base = (m_tick >> (BITS * (level + 1))) << (BITS * (level + 1));
+      next = std::min (next, base | ((uint64_t)slot << (BITS * level)));
+    }
+  if (m_overflow != 0)
+    {
+      next = std::min (next, ((m_tick >> (BITS * LEVELS)) + 1) << (BITS * LEVELS));
+    }
+  return next;
+}
+
+void
+TimerWheel::Advance (uint64_t tick)
+{
+  for (uint64_t next = GetNextTick (); next <= tick; next = GetNextTick ())
+    {
+      Process (next);
+    }
+  m_tick = tick;
+}
+
+void
+TimerWheel::Process (uint64_t tick)
+{
+  NS_LOG_FUNCTION (this << tick);
+  m_tick = tick;
+  if ((tick & (((uint64_t)1 << (BITS * LEVELS)) - 1)) == 0 && m_overflow != 0)
+    {
+      Entry *entry = m_overflow;
+      m_overflow = 0;
+      while (entry != 0)
+        {
+          Entry *next = entry->m_next;
+          entry->m_list = 0;
+          Place (entry);
+          entry = next;
+        }
+    }
+  // Move the due slots one level down, then schedule the due slot of
+  // level 0
+  for (uint32_t level = LEVELS; level-- > 0; )
+    {
+      if ((tick & (((uint64_t)1 << (BITS * level)) - 1)) != 0)
+        {
+          continue;
+        }
+      uint32_t slot = (tick >> (BITS * level)) & (SLOTS - 1);
+      Entry *entry = m_slots[level][slot];
+      m_slots[level][slot] = 0;
+      m_occupied[level] &= ~((uint64_t)1 << slot);
+      while (entry != 0)
+        {
+          Entry *next = entry->m_next;
+          entry->m_list = 0;
+          Place (entry);
+          entry = next;
+        }
+    }
+}
+
+void
+TimerWheel::ScheduleWakeup (void)
+{
+  uint64_t next = GetNextTick ();
+  if (next == NO_TICK)
+    {
+      return;
+    }
+  if (m_wakeupTick != NO_TICK)
+    {
+      m_wakeup.Cancel ();
+    }
+  m_wakeupTick = next;
+  m_wakeup = Simulator::Schedule (TimeStep (next * m_tickSteps) - Simulator::Now (),
+                                  &TimerWheel::Wakeup, this);
+}
+
+void
+TimerWheel::Wakeup (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_wakeupTick = NO_TICK;
+  Advance (GetTick (Simulator::Now ()));
+  ScheduleWakeup ();
+}
+
+void
+TimerWheel::Expire (Entry *entry)
+{
+  NS_LOG_FUNCTION (this << entry);
+  Unlink (entry);
+  entry->m_event = EventId ();
+  entry->m_wheel = 0;
+  entry->m_function ();
+}
+
+} // namespace ns3
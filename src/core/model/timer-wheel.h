@@ -0,0 +1,208 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "nstime.h"
+#include "event-id.h"
+#include "callback.h"
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup timer
+ * \brief A hierarchical timer wheel holding the Timers and Watchdogs of
+ * a simulation.
+ *
+ * Protocol timers are rearmed far more often than they expire. The
+ * wheel keeps them out of the event queue until they are about to
+ * expire, so that rearming one is a constant time list operation
+ * instead of a cancelled event left in the queue.
+ *
+ * Time is cut into ticks, whose length is set by the "TimerWheelTick"
+ * GlobalValue. The wheel has four levels of 64 slots: the slots of
+ * level 0 hold the entries expiring in each of the next 64 ticks,
+ * those of level 1 the entries expiring in each of the next 64 blocks
+ * of 64 ticks, and so on; entries beyond level 3 wait in an overflow
+ * list. Only the next tick at which a slot is due lives in the event
+ * queue. When a slot of level 1 or higher is due, its entries move down
+ * a level; when a slot of level 0 is due, its entries are scheduled as
+ * events at their exact expiry time, in the context they were
+ * scheduled from. Timers thus expire at the same time as before; the
+ * tick only sets how long before its expiry an entry enters the event
+ * queue.
+ *
+ * There is one wheel per simulation, created on first use and deleted
+ * by Simulator::Destroy. When Simulator::IsConcurrent, the contexts
+ * can't share a wheel, and the entries are scheduled directly as events
+ * instead.
+ */
+class TimerWheel
+{
+public:
+  /**
+   * \brief A timer held by the wheel.
+   *
+   * The entry invokes its function once it expires. Destroying a
+   * pending entry cancels it. A copy of an entry is not pending and has
+   * no function.
+   */
+  class Entry
+  {
+  public:
+    Entry ();
+    /**
+     * Copy constructor.
+     * \param [in] o The entry to copy, whose state is not copied
+     */
+    Entry (const Entry &o);
+    /**
+     * Assignment, which cancels this entry.
+     * \param [in] o The entry to copy, whose state is not copied
+     * \returns This entry
+     */
+    Entry &operator = (const Entry &o);
+    ~Entry ();
+
+    /**
+     * \param [in] function The function to invoke when the entry expires
+     */
+    void SetFunction (Callback<void> function);
+    /**
+     * Arm the entry, or rearm it if it is pending.
+     * \param [in] delay The delay from now until the expiry
+     */
+    void Schedule (const Time &delay);
+    /** Disarm the entry, if it is pending. */
+    void Cancel (void);
+    /**
+     * \returns true if the entry is armed and has not expired yet
+     */
+    bool IsPending (void) const;
+    /**
+     * \returns The expiry time of a pending entry
+     */
+    Time GetExpiry (void) const;
+
+  private:
+    friend class TimerWheel;
+
+    /** Invoke the function of an entry scheduled directly as an event. */
+    void Expire (void);
+
+    Callback<void> m_function;  //!< Invoked when the entry expires
+    Time m_expiry;              //!< The absolute expiry time
+    uint32_t m_context;         //!< The context to expire in
+    TimerWheel *m_wheel;        //!< The wheel holding the entry, or 0
+    Entry **m_list;             //!< Head of the list holding the entry
+    Entry *m_prev;              //!< Previous entry in the list
+    Entry *m_next;              //!< Next entry in the list
+    EventId m_event;            //!< The expiry event, once in the event queue
+  };
+
+  TimerWheel ();
+  ~TimerWheel ();
+
+private:
+  /** Number of levels of the wheel. */
+  static const uint32_t LEVELS = 4;
+  /** Number of bits of a tick number covered by each level. */
+  static const uint32_t BITS = 6;
+  /** Number of slots of each level. */
+  static const uint32_t SLOTS = 1 << BITS;
+
+  /**
+   * \param [in] time An absolute time
+   * \returns The tick containing the time
+   */
+  uint64_t GetTick (const Time &time) const;
+  /**
+   * Add an entry, and move the next wakeup earlier if needed.
+   * \param [in] entry The entry, which is not in the wheel
+   */
+  void Add (Entry *entry);
+  /**
+   * Take an entry out of the wheel.
+   * \param [in] entry The entry, which is in the wheel
+   */
+  void Remove (Entry *entry);
+  /**
+   * Put an entry in the slot of its expiry tick relative to the current
+   * tick, or schedule it if it is due.
+   * \param [in] entry The entry, which is not in a list
+   */
+  void Place (Entry *entry);
+  /**
+   * Schedule the expiry event of an entry.
+   * \param [in] entry The entry, which is not in a list
+   */
+  void Enqueue (Entry *entry);
+  /**
+   * Link an entry at the head of a list.
+   * \param [in] entry The entry
+   * \param [in] list The head of the list
+   */
+  void Link (Entry *entry, Entry **list);
+  /**
+   * Unlink an entry from its list, and mark its slot empty if it was
+   * the last one.
+   * \param [in] entry The entry
+   */
+  void Unlink (Entry *entry);
+  /**
+   * \returns The next tick at which a slot or the overflow list is due
+   */
+  uint64_t GetNextTick (void) const;
+  /**
+   * Process the slots due up to a tick.
+   * \param [in] tick The tick to advance to
+   */
+  void Advance (uint64_t tick);
+  /**
+   * Process the slots due at a tick, which becomes the current tick.
+   * \param [in] tick The tick
+   */
+  void Process (uint64_t tick);
+  /** Schedule the wakeup at the next due tick, if any. */
+  void ScheduleWakeup (void);
+  /** Process the slots due now. */
+  void Wakeup (void);
+  /**
+   * Invoke the function of an entry whose expiry event runs.
+   * \param [in] entry The entry
+   */
+  void Expire (Entry *entry);
+
+  int64_t m_tickSteps;                    //!< Length of a tick, in time steps
+  uint64_t m_tick;                        //!< The current tick
+  Entry *m_slots[LEVELS][SLOTS];          //!< The slots of each level
+  uint64_t m_occupied[LEVELS];            //!< Bitmap of the non empty slots of each level
+  Entry *m_overflow;                      //!< Entries beyond the last level
+  Entry *m_queued;                        //!< Entries whose expiry event is scheduled
+  EventId m_wakeup;                       //!< The next wakeup
+  uint64_t m_wakeupTick;                  //!< The tick of the next wakeup
+};
+
+} // namespace ns3
+
+#endif /* TIMER_WHEEL_H */
@@ -35,19 +35,48 @@ NS_LOG_COMPONENT_DEFINE ("Timer");
 Timer::Timer ()
   : m_flags (CHECK_ON_DESTROY),
     m_delay (FemtoSeconds (0)),
-    m_event (),
+    m_entry (),
     m_impl (0)
 {
   NS_LOG_FUNCTION (this);
+  m_entry.SetFunction (MakeCallback (&Timer::Expire, this));
 }
 
 Timer::Timer (enum DestroyPolicy destroyPolicy)
   : m_flags (destroyPolicy),
     m_delay (FemtoSeconds (0)),
-    m_event (),
+    m_entry (),
     m_impl (0)
 {
   NS_LOG_FUNCTION (this << destroyPolicy);
+  m_entry.SetFunction (MakeCallback (&Timer::Expire, this));
+}
+
+Timer::Timer (const Timer &o)
+  : m_flags (o.m_flags),
+    m_delay (o.m_delay),
+    m_entry (),
+    m_impl (o.m_impl == 0 ? 0 : o.m_impl->Copy ()),
+    m_delayLeft (o.m_delayLeft)
+{
+  NS_LOG_FUNCTION (this << &o);
+  m_entry.SetFunction (MakeCallback (&Timer::Expire, this));
+}
+
+Timer &
+Timer::operator = (const Timer &o)
+{
+  NS_LOG_FUNCTION (this << &o);
+  if (this != &o)
+    {
+      m_entry.Cancel ();
+      m_flags = o.m_flags;
+      m_delay = o.m_delay;
+      m_delayLeft = o.m_delayLeft;
+      delete m_impl;
+      m_impl = o.m_impl == 0 ? 0 : o.m_impl->Copy ();
+    }
+  return *this;
 }
 
 Timer::~Timer ()
@@ -55,18 +84,14 @@ Timer::~Timer ()
   NS_LOG_FUNCTION (this);
   if (m_flags & CHECK_ON_DESTROY)
     {
-      if (m_event.IsRunning ())
+      if (m_entry.IsPending ())
         {
           NS_FATAL_ERROR ("Event is still running while destroying.");
         }
     }
-  else if (m_flags & CANCEL_ON_DESTROY)
+  else if (m_flags & (CANCEL_ON_DESTROY | REMOVE_ON_DESTROY))
     {
-      m_event.Cancel ();
-    }
-  else if (m_flags & REMOVE_ON_DESTROY)
-    {
-      Simulator::Remove (m_event);
+      m_entry.Cancel ();
     }
   delete m_impl;
 }
@@ -90,7 +115,7 @@ Timer::GetDelayLeft (void) const
   switch (GetState ())
     {
     case Timer::RUNNING:
-      return Simulator::GetDelayLeft (m_event);
+      return m_entry.GetExpiry () - Simulator::Now ();
       break;
     case Timer::EXPIRED:
       return TimeStep (0);
@@ -109,25 +134,25 @@ void
 Timer::Cancel (void)
 {
   NS_LOG_FUNCTION (this);
-  Simulator::Cancel (m_event);
+  m_entry.Cancel ();
 }
 void
 Timer::Remove (void)
 {
   NS_LOG_FUNCTION (this);
-  Simulator::Remove (m_event);
+  m_entry.Cancel ();
 }
 bool
 Timer::IsExpired (void) const
 {
   NS_LOG_FUNCTION (this);
-  return !IsSuspended () && m_event.IsExpired ();
+  return !IsSuspended () && !m_entry.IsPending ();
 }
 bool
 Timer::IsRunning (void) const
 {
   NS_LOG_FUNCTION (this);
-  return !IsSuspended () && m_event.IsRunning ();
+  return !IsSuspended () && m_entry.IsPending ();
 }
 bool
 Timer::IsSuspended (void) const
@@ -166,11 +191,11 @@ Timer::Schedule (Time delay)
 {
   NS_LOG_FUNCTION (this << delay);
   NS_ASSERT (m_impl != 0);
-  if (m_event.IsRunning ())
+  if (m_entry.IsPending ())
     {
       NS_FATAL_ERROR ("Event is still running while re-scheduling.");
     }
-  m_event = m_impl->Schedule (delay);
+  m_entry.Schedule (delay);
 }
 
 void
@@ -178,8 +203,8 @@ Timer::Suspend (void)
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (IsRunning ());
-  m_delayLeft = Simulator::GetDelayLeft (m_event);
-  Simulator::Remove (m_event);
+  m_delayLeft = m_entry.GetExpiry () - Simulator::Now ();
+  m_entry.Cancel ();
   m_flags |= TIMER_SUSPENDED;
 }
 
@@ -188,10 +213,17 @@ Timer::Resume (void)
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (m_flags & TIMER_SUSPENDED);
-  m_event = m_impl->Schedule (m_delayLeft);
+  m_entry.Schedule (m_delayLeft);
   m_flags &= ~TIMER_SUSPENDED;
 }
 
+void
+Timer::Expire (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_impl->Invoke ();
+}
+
 
 } // namespace ns3
 
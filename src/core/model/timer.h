@@ -22,7 +22,7 @@
 
 #include "fatal-error.h"
 #include "nstime.h"
-#include "event-id.h"
+#include "timer-wheel.h"
 #include "int-to-type.h"
 
 /**
@@ -41,7 +41,7 @@ namespace ns3 {
  * to execute a specified virtual time in the future.
  *
  * A Watchdog timer cannot be paused or cancelled once it has been started,
- * however it can be lengthened (delayed).  A Watchdog takes no action
+ * however it can be lengthened (delayed).  A Watchdog is cancelled
  * when it is destroyed.
  *
  * A Timer can be suspended, resumed, cancelled and queried for time left,
@@ -68,6 +68,10 @@ class TimerImpl;
  * management policies. These policies are specified at construction time
  * and cannot be changed after.
  *
+ * A running timer waits in the TimerWheel, so cancelling and
+ * scheduling it again costs no event. The function and arguments are
+ * those set when it expires.
+ *
  * \see Watchdog for a simpler interface for a watchdog timer.
  */
 class Timer
@@ -112,6 +116,26 @@ public:
    * to use for destroy events
    */
   Timer (enum DestroyPolicy destroyPolicy);
+  /**
+   * Copy constructor.
+   *
+   * The copy has the delay, the destroy policy, the function and the
+   * arguments of \p o, and its own entry in the TimerWheel: it is not
+   * running, even if \p o is.
+   *
+   * \param [in] o The Timer to copy
+   */
+  Timer (const Timer &o);
+  /**
+   * Assignment operator.
+   *
+   * This Timer is cancelled, then takes the delay, the destroy policy,
+   * the function and the arguments of \p o.
+   *
+   * \param [in] o The Timer to copy
+   * \returns This Timer
+   */
+  Timer & operator = (const Timer &o);
   ~Timer ();
 
   /**
@@ -263,6 +287,9 @@ public:
   void Resume (void);
 
 private:
+  /** Internal callback invoked when the timer expires. */
+  void Expire (void);
+
   /** Internal bit marking the suspended state. */
   enum InternalSuspended
   {
@@ -281,8 +308,8 @@ private:
   int m_flags;
   /** The delay configured for this Timer. */
   Time m_delay;
-  /** The future event scheduled to expire the timer. */
-  EventId m_event;
+  /** The entry of the timer in the TimerWheel. */
+  TimerWheel::Entry m_entry;
   /**
    * The timer implementation, which contains the bound callback
    * function and arguments.
@@ -20,6 +20,7 @@
 #ifndef TRACE_SOURCE_ACCESSOR_H
 #define TRACE_SOURCE_ACCESSOR_H
 
+#include <atomic>
 #include <stdint.h>
 #include "callback.h"
 #include "ptr.h"
@@ -43,7 +44,7 @@ class ObjectBase;
  * This class abstracts the kind of trace source to which we want to connect
  * and provides services to Connect and Disconnect a sink to a trace source.
  */
-class TraceSourceAccessor : public SimpleRefCount<TraceSourceAccessor>
+class TraceSourceAccessor : public SimpleRefCount<TraceSourceAccessor, empty, DefaultDeleter<TraceSourceAccessor>, std::atomic<uint32_t> >
 {
 public:
   /** Constructor. */
@@ -21,7 +21,7 @@
 #ifndef TRACED_CALLBACK_H
 #define TRACED_CALLBACK_H
 
-#include <list>
+#include <vector>
 #include "callback.h"
 
 /**
@@ -46,6 +46,12 @@ namespace ns3 {
  * calling one of the \c operator() forms with the appropriate
  * number of arguments.
  *
+ * The chain is kept in a vector, and invoking an empty chain costs
+ * a single test. An invocation holds the chain it walks: a Callback
+ * which connects to or disconnects from the TracedCallback invoking
+ * it changes a copy of the chain, which is used from the next
+ * invocation on.
+ *
  * \tparam T1 \explicit Type of the first argument to the functor.
  * \tparam T2 \explicit Type of the second argument to the functor.
  * \tparam T3 \explicit Type of the third argument to the functor.
@@ -93,6 +99,16 @@ public:
    * \param [in] path Context path which was used to connect the Callback.
    */
   void Disconnect (const CallbackBase & callback, std::string path);
+  /**
+   * Check for an empty chain. Callers can test this to avoid building
+   * arguments which no Callback will see.
+   *
+   * \return \c true if no Callback is connected.
+   */
+  bool IsEmpty (void) const
+  {
+    return m_chain == 0;
+  }
   /**
    * \name Functors taking various numbers of arguments.
    *
@@ -234,9 +250,140 @@ private:
    * \tparam T7 \deduced Type of the seventh argument to the functor.
    * \tparam T8 \deduced Type of the eighth argument to the functor.
    */
-  typedef std::list<Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> > CallbackList;
-  /** The chain of Callbacks. */
-  CallbackList m_callbackList;
+  typedef std::vector<Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> > CallbackList;
+  /** The chain of Callbacks, shared with the invocations in progress. */
+  struct CallbackChain : public SimpleRefCount<CallbackChain>
+  {
+    CallbackList callbacks;  //!< The Callbacks, in connection order.
+  };
+  /**
+   * Get the chain of Callbacks for a change, copying it first if an
+   * invocation in progress holds it.
+   *
+   * eturn The Callbacks of the chain.
+   */
+  CallbackList & GetCallbacksForUpdate (void);
+  /** The chain of Callbacks, null when empty. */
+  Ptr<CallbackChain> m_chain;
+};
+
+/**
+ * \ingroup tracing
+ * \brief A TracedCallback which has been compiled out.
+ *
+ * It has the API of TracedCallback, but invoking it does nothing
+ * and can be optimized away entirely. Connecting to it is a fatal
+ * error, since the Callback would never be invoked; disconnecting
+ * from it does nothing.
+ *
+ * Classes select between TracedCallback and NullTracedCallback with
+ * SelectTracedCallback.
+ *
+ * \tparam T1 \explicit Type of the first argument to the functor.
+ * \tparam T2 \explicit Type of the second argument to the functor.
+ * \tparam T3 \explicit Type of the third argument to the functor.
+ * \tparam T4 \explicit Type of the fourth argument to the functor.
+ * \tparam T5 \explicit Type of the fifth argument to the functor.
+ * \tparam T6 \explicit Type of the sixth argument to the functor.
+ * \tparam T7 \explicit Type of the seventh argument to the functor.
+ * \tparam T8 \explicit Type of the eighth argument to the functor.
+ */
+template<typename T1 = empty, typename T2 = empty,
+         typename T3 = empty, typename T4 = empty,
+         typename T5 = empty, typename T6 = empty,
+         typename T7 = empty, typename T8 = empty>
+class NullTracedCallback
+{
+public:
+  /**
+   * \copydoc TracedCallback::ConnectWithoutContext
+   */
+  void ConnectWithoutContext (const CallbackBase & callback)
+  {
+    NS_FATAL_ERROR ("Connecting to a trace source which was compiled out");
+  }
+  /**
+   * \copydoc TracedCallback::Connect
+   */
+  void Connect (const CallbackBase & callback, std::string path)
+  {
+    NS_FATAL_ERROR ("Connecting to " << path << ", which was compiled out");
+  }
+  /**
+   * \copydoc TracedCallback::DisconnectWithoutContext
+   */
+  void DisconnectWithoutContext (const CallbackBase & callback) {}
+  /**
+   * \copydoc TracedCallback::Disconnect
+   */
+  void Disconnect (const CallbackBase & callback, std::string path) {}
+  /**
+   * \copydoc TracedCallback::IsEmpty
+   */
+  bool IsEmpty (void) const
+  {
+    return true;
+  }
+  /**
+   * \name Functors which do nothing.
+   * @{
+   */
+  void operator() (void) const {}
+  void operator() (T1 a1) const {}
+  void operator() (T1 a1, T2 a2) const {}
+  void operator() (T1 a1, T2 a2, T3 a3) const {}
+  void operator() (T1 a1, T2 a2, T3 a3, T4 a4) const {}
+  void operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5) const {}
+  void operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6) const {}
+  void operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7) const {}
+  void operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7, T8 a8) const {}
+  /**@}*/
+};
+
+/**
+ * \ingroup tracing
+ * \brief Select a TracedCallback, or a NullTracedCallback if
+ * \p ENABLED is \c false.
+ *
+ * A class whose trace sources can be compiled out declares them as
+ * \code
+ *   SelectTracedCallback<TRACES, Ptr<const Packet> >::Type m_txTrace;
+ * \endcode
+ * where \c TRACES is a compile-time constant of the class.
+ *
+ * \tparam ENABLED \c true to select a TracedCallback.
+ * \tparam T1 \explicit Type of the first argument to the functor.
+ * \tparam T2 \explicit Type of the second argument to the functor.
+ * \tparam T3 \explicit Type of the third argument to the functor.
+ * \tparam T4 \explicit Type of the fourth argument to the functor.
+ * \tparam T5 \explicit Type of the fifth argument to the functor.
+ * \tparam T6 \explicit Type of the sixth argument to the functor.
+ * \tparam T7 \explicit Type of the seventh argument to the functor.
+ * \tparam T8 \explicit Type of the eighth argument to the functor.
+ */
+template<bool ENABLED,
+         typename T1 = empty, typename T2 = empty,
+         typename T3 = empty, typename T4 = empty,
+         typename T5 = empty, typename T6 = empty,
+         typename T7 = empty, typename T8 = empty>
+struct SelectTracedCallback
+{
+  /** The selected type. */
+  typedef TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8> Type;
+};
+
+/**
+ * \ingroup tracing
+ * SelectTracedCallback specialization for compiled out trace sources.
+ */
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+struct SelectTracedCallback<false,T1,T2,T3,T4,T5,T6,T7,T8>
+{
+  /** The selected type. */
+  typedef NullTracedCallback<T1,T2,T3,T4,T5,T6,T7,T8> Type;
 };
 
 } // namespace ns3
@@ -253,9 +400,26 @@ template<typename T1, typename T2,
          typename T5, typename T6,
          typename T7, typename T8>
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::TracedCallback ()
-  : m_callbackList () 
+  : m_chain (0)
 {
 }
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+typename TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::CallbackList &
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::GetCallbacksForUpdate (void)
+{
+  if (m_chain == 0)
+    {
+      m_chain = Create<CallbackChain> ();
+    }
+  else if (m_chain->GetReferenceCount () > 1)
+    {
+      m_chain = Create<CallbackChain> (*m_chain);
+    }
+  return m_chain->callbacks;
+}
 template<typename T1, typename T2,
          typename T3, typename T4,
          typename T5, typename T6,
@@ -266,7 +430,7 @@ TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::ConnectWithoutContext (const CallbackBa
   Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> cb;
   if (!cb.Assign (callback))
     NS_FATAL_ERROR_NO_MSG();
-  m_callbackList.push_back (cb);
+  GetCallbacksForUpdate ().push_back (cb);
 }
 template<typename T1, typename T2,
          typename T3, typename T4,
@@ -279,7 +443,7 @@ TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Connect (const CallbackBase & callback,
   if (!cb.Assign (callback))
     NS_FATAL_ERROR ("when connecting to " << path);
   Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> realCb = cb.Bind (path);
-  m_callbackList.push_back (realCb);
+  GetCallbacksForUpdate ().push_back (realCb);
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -288,18 +452,27 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::DisconnectWithoutContext (const CallbackBase & callback)
 {
-  for (typename CallbackList::iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); /* empty */)
+  if (m_chain == 0)
+    {
+      return;
+    }
+  CallbackList &callbacks = GetCallbacksForUpdate ();
+  for (typename CallbackList::iterator i = callbacks.begin ();
+       i != callbacks.end (); /* empty */)
     {
       if ((*i).IsEqual (callback))
         {
-          i = m_callbackList.erase (i);
+          i = callbacks.erase (i);
         }
       else
         {
           i++;
         }
     }
+  if (callbacks.empty ())
+    {
+      m_chain = 0;
+    }
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -321,10 +494,16 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (void) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_chain == 0)
     {
-      (*i)();
+      return;
+    }
+  // a Callback may change the chain, which then gets copied.
+  Ptr<const CallbackChain> chain = m_chain;
+  for (typename CallbackList::const_iterator i = chain->callbacks.begin ();
+       i != chain->callbacks.end (); i++)
+    {
+      (*i) ();
     }
 }
 template<typename T1, typename T2, 
@@ -334,10 +513,16 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_chain == 0)
+    {
+      return;
+    }
+  // a Callback may change the chain, which then gets copied.
+  Ptr<const CallbackChain> chain = m_chain;
+  for (typename CallbackList::const_iterator i = chain->callbacks.begin ();
+       i != chain->callbacks.end (); i++)
     {
-      (*i)(a1);
+      (*i) (a1);
     }
 }
 template<typename T1, typename T2, 
@@ -347,10 +532,16 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_chain == 0)
+    {
+      return;
+    }
+  // a Callback may change the chain, which then gets copied.
+  Ptr<const CallbackChain> chain = m_chain;
+  for (typename CallbackList::const_iterator i = chain->callbacks.begin ();
+       i != chain->callbacks.end (); i++)
     {
-      (*i)(a1, a2);
+      (*i) (a1, a2);
     }
 }
 template<typename T1, typename T2, 
@@ -360,10 +551,16 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_chain == 0)
     {
-      (*i)(a1, a2, a3);
+      return;
+    }
+  // a Callback may change the chain, which then gets copied.
+  Ptr<const CallbackChain> chain = m_chain;
+  for (typename CallbackList::const_iterator i = chain->callbacks.begin ();
+       i != chain->callbacks.end (); i++)
+    {
+      (*i) (a1, a2, a3);
     }
 }
 template<typename T1, typename T2, 
@@ -373,10 +570,16 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_chain == 0)
+    {
+      return;
+    }
+  // a Callback may change the chain, which then gets copied.
+  Ptr<const CallbackChain> chain = m_chain;
+  for (typename CallbackList::const_iterator i = chain->callbacks.begin ();
+       i != chain->callbacks.end (); i++)
     {
-      (*i)(a1, a2, a3, a4);
+      (*i) (a1, a2, a3, a4);
     }
 }
 template<typename T1, typename T2, 
@@ -386,10 +589,16 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_chain == 0)
+    {
+      return;
+    }
+  // a Callback may change the chain, which then gets copied.
+  Ptr<const CallbackChain> chain = m_chain;
+  for (typename CallbackList::const_iterator i = chain->callbacks.begin ();
+       i != chain->callbacks.end (); i++)
     {
-      (*i)(a1, a2, a3, a4, a5);
+      (*i) (a1, a2, a3, a4, a5);
     }
 }
 template<typename T1, typename T2, 
@@ -399,10 +608,16 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_chain == 0)
     {
-      (*i)(a1, a2, a3, a4, a5, a6);
+      return;
+    }
+  // a Callback may change the chain, which then gets copied.
+  Ptr<const CallbackChain> chain = m_chain;
+  for (typename CallbackList::const_iterator i = chain->callbacks.begin ();
+       i != chain->callbacks.end (); i++)
+    {
+      (*i) (a1, a2, a3, a4, a5, a6);
     }
 }
 template<typename T1, typename T2, 
@@ -412,10 +627,16 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_chain == 0)
+    {
+      return;
+    }
+  // a Callback may change the chain, which then gets copied.
+  Ptr<const CallbackChain> chain = m_chain;
+  for (typename CallbackList::const_iterator i = chain->callbacks.begin ();
+       i != chain->callbacks.end (); i++)
     {
-      (*i)(a1, a2, a3, a4, a5, a6, a7);
+      (*i) (a1, a2, a3, a4, a5, a6, a7);
     }
 }
 template<typename T1, typename T2, 
@@ -425,10 +646,16 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7, T8 a8) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_chain == 0)
+    {
+      return;
+    }
+  // a Callback may change the chain, which then gets copied.
+  Ptr<const CallbackChain> chain = m_chain;
+  for (typename CallbackList::const_iterator i = chain->callbacks.begin ();
+       i != chain->callbacks.end (); i++)
     {
-      (*i)(a1, a2, a3, a4, a5, a6, a7, a8);
+      (*i) (a1, a2, a3, a4, a5, a6, a7, a8);
     }
 }
 
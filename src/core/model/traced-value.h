@@ -106,9 +106,14 @@ namespace TracedValueCallback {
  * and will define Connect/DisconnectWithoutContext methods to work
  * with MakeTraceSourceAccessor.
  *
+ * With \p ENABLED \c false the trace source is compiled out: the
+ * instance keeps the value and no Callback, and connecting to it is
+ * a fatal error.
+ *
  * \tparam T \explicit The type of the underlying value being traced.
+ * \tparam ENABLED \explicit \c false to compile the trace source out.
  */
-template <typename T>
+template <typename T, bool ENABLED = true>
 class TracedValue
 {
 public:
@@ -147,11 +152,12 @@ public:
   /**
    * Copy from a TracedValue of a compatable type.
    * \tparam U \deduced The underlying type of the other TracedValue.
+   * \tparam F \deduced Whether the other trace source is compiled in.
    * \param [in] other The other TracedValuet to copy.
    */
-  template <typename U>
-  TracedValue (const TracedValue<U> &other)
-    : m_v (other.m_v)
+  template <typename U, bool F>
+  TracedValue (const TracedValue<U,F> &other)
+    : m_v (other.Get ())
   {}
   /**
    * Copy from a variable type compatible with this underlying type.
@@ -262,7 +268,7 @@ private:
   /** The underlying value. */
   T m_v;
   /** The connected Callback. */
-  TracedCallback<T,T> m_cb;
+  typename SelectTracedCallback<ENABLED,T,T>::Type m_cb;
 };
 
   
@@ -280,12 +286,13 @@ private:
  * The underlying value will be written to the stream.
  *
  * \tparam T \deduced The underlying type of the TracedValue.
+ * \tparam E \deduced Whether the trace source is compiled in.
  * \param [in,out] os The output stream.
  * \param [in] rhs The TracedValue to stream.
  * \returns The stream.
  */
-template <typename T>
-std::ostream& operator << (std::ostream& os, const TracedValue<T>& rhs)
+template <typename T, bool E>
+std::ostream& operator << (std::ostream& os, const TracedValue<T,E>& rhs)
 {
   return os<<rhs.Get ();
 }
@@ -293,135 +300,137 @@ std::ostream& operator << (std::ostream& os, const TracedValue<T>& rhs)
 /**
  * Boolean operator for TracedValue.
  * \tparam T \deduced The underlying type held by the left-hand argument.
+ * \tparam E \deduced Whether the left-hand trace source is compiled in.
  * \tparam U \deduced The underlying type held by the right-hand argument.
+ * \tparam F \deduced Whether the right-hand trace source is compiled in.
  * \param [in] lhs The left-hand argument.
  * \param [in] rhs The right-hand argument.
  * \returns The boolean result of comparing the underlying values.
  */
-template <typename T, typename U>
-bool operator == (const TracedValue<T> &lhs, const TracedValue<U> &rhs)
+template <typename T, bool E, typename U, bool F>
+bool operator == (const TracedValue<T,E> &lhs, const TracedValue<U,F> &rhs)
 {
   TRACED_VALUE_DEBUG ("x==x");
   return lhs.Get () == rhs.Get ();
 }
-/** \copydoc operator==(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-bool operator == (const TracedValue<T> &lhs, const U &rhs)
+/** \copydoc operator==(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+bool operator == (const TracedValue<T,E> &lhs, const U &rhs)
 {
   TRACED_VALUE_DEBUG ("x==");
   return lhs.Get () == rhs;
 }
-/** \copydoc operator==(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-bool operator == (const U &lhs, const TracedValue<T> &rhs)
+/** \copydoc operator==(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+bool operator == (const U &lhs, const TracedValue<T,E> &rhs)
 {
   TRACED_VALUE_DEBUG ("==x");
   return lhs == rhs.Get ();
 }
 
-/** \copydoc operator==(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-bool operator != (const TracedValue<T> &lhs, const TracedValue<U> &rhs)
+/** \copydoc operator==(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U, bool F>
+bool operator != (const TracedValue<T,E> &lhs, const TracedValue<U,F> &rhs)
 {
   TRACED_VALUE_DEBUG ("x!=x");
   return lhs.Get () != rhs.Get ();
 }
-/** \copydoc operator==(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-bool operator != (const TracedValue<T> &lhs, const U &rhs)
+/** \copydoc operator==(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+bool operator != (const TracedValue<T,E> &lhs, const U &rhs)
 {
   TRACED_VALUE_DEBUG ("x!=");
   return lhs.Get () != rhs;
 }
-/** \copydoc operator==(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-bool operator != (const U &lhs, const TracedValue<T> &rhs)
+/** \copydoc operator==(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+bool operator != (const U &lhs, const TracedValue<T,E> &rhs)
 {
   TRACED_VALUE_DEBUG ("!=x");
   return lhs != rhs.Get ();
 }
 
-/** \copydoc operator==(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-bool operator <= (const TracedValue<T> &lhs, const TracedValue<U> &rhs)
+/** \copydoc operator==(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U, bool F>
+bool operator <= (const TracedValue<T,E> &lhs, const TracedValue<U,F> &rhs)
 {
   TRACED_VALUE_DEBUG ("x<=x");
   return lhs.Get () <= rhs.Get ();
 }
-/** \copydoc operator==(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-bool operator <= (const TracedValue<T> &lhs, const U &rhs)
+/** \copydoc operator==(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+bool operator <= (const TracedValue<T,E> &lhs, const U &rhs)
 {
   TRACED_VALUE_DEBUG ("x<=");
   return lhs.Get () <= rhs;
 }
-/** \copydoc operator==(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-bool operator <= (const U &lhs, const TracedValue<T> &rhs)
+/** \copydoc operator==(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+bool operator <= (const U &lhs, const TracedValue<T,E> &rhs)
 {
   TRACED_VALUE_DEBUG ("<=x");
   return lhs <= rhs.Get ();
 }
-/** \copydoc operator==(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-bool operator >= (const TracedValue<T> &lhs, const TracedValue<U> &rhs)
+/** \copydoc operator==(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U, bool F>
+bool operator >= (const TracedValue<T,E> &lhs, const TracedValue<U,F> &rhs)
 {
   TRACED_VALUE_DEBUG ("x>=x");
   return lhs.Get () >= rhs.Get ();
 }
-/** \copydoc operator==(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-bool operator >= (const TracedValue<T> &lhs, const U &rhs)
+/** \copydoc operator==(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+bool operator >= (const TracedValue<T,E> &lhs, const U &rhs)
 {
   TRACED_VALUE_DEBUG ("x>=");
   return lhs.Get () >= rhs;
 }
-/** \copydoc operator==(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-bool operator >= (const U &lhs, const TracedValue<T> &rhs)
+/** \copydoc operator==(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+bool operator >= (const U &lhs, const TracedValue<T,E> &rhs)
 {
   TRACED_VALUE_DEBUG (">=x");
   return lhs >= rhs.Get ();
 }
 
-/** \copydoc operator==(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-bool operator < (const TracedValue<T> &lhs, const TracedValue<U> &rhs)
+/** \copydoc operator==(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U, bool F>
+bool operator < (const TracedValue<T,E> &lhs, const TracedValue<U,F> &rhs)
 {
   TRACED_VALUE_DEBUG ("x<x");
   return lhs.Get () < rhs.Get ();
 }
-/** \copydoc operator==(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-bool operator < (const TracedValue<T> &lhs, const U &rhs)
+/** \copydoc operator==(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+bool operator < (const TracedValue<T,E> &lhs, const U &rhs)
 {
   TRACED_VALUE_DEBUG ("x<");
   return lhs.Get () < rhs;
 }
-/** \copydoc operator==(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-bool operator < (const U &lhs, const TracedValue<T> &rhs)
+/** \copydoc operator==(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+bool operator < (const U &lhs, const TracedValue<T,E> &rhs)
 {
   TRACED_VALUE_DEBUG ("<x");
   return lhs < rhs.Get ();
 }
-/** \copydoc operator==(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-bool operator > (const TracedValue<T> &lhs, const TracedValue<U> &rhs)
+/** \copydoc operator==(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U, bool F>
+bool operator > (const TracedValue<T,E> &lhs, const TracedValue<U,F> &rhs)
 {
   TRACED_VALUE_DEBUG ("x>x");
   return lhs.Get () > rhs.Get ();
 }
-/** \copydoc operator==(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-bool operator > (const TracedValue<T> &lhs, const U &rhs)
+/** \copydoc operator==(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+bool operator > (const TracedValue<T,E> &lhs, const U &rhs)
 {
   TRACED_VALUE_DEBUG ("x>");
   return lhs.Get () > rhs;
 }
-/** \copydoc operator==(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-bool operator > (const U &lhs, const TracedValue<T> &rhs)
+/** \copydoc operator==(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+bool operator > (const U &lhs, const TracedValue<T,E> &rhs)
 {
   TRACED_VALUE_DEBUG (">x");
   return lhs > rhs.Get ();
@@ -435,199 +444,201 @@ bool operator > (const U &lhs, const TracedValue<T> &rhs)
  * which has no Callback connected.
  *
  * \tparam T \deduced The underlying type held by the left-hand argument.
+ * \tparam E \deduced Whether the left-hand trace source is compiled in.
  * \tparam U \deduced The underlying type held by the right-hand argument.
+ * \tparam F \deduced Whether the right-hand trace source is compiled in.
  * \param [in] lhs The left-hand argument.
  * \param [in] rhs The right-hand argument.
  * \returns The result of doing the operator on
  *     the underlying values.
  */
-template <typename T, typename U>
-TracedValue<T> operator + (const TracedValue<T> &lhs, const TracedValue<U> &rhs) {
+template <typename T, bool E, typename U, bool F>
+TracedValue<T,E> operator + (const TracedValue<T,E> &lhs, const TracedValue<U,F> &rhs) {
   TRACED_VALUE_DEBUG ("x+x");
-  return TracedValue<T> (lhs.Get () + rhs.Get ());
+  return TracedValue<T,E> (lhs.Get () + rhs.Get ());
 }
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator + (const TracedValue<T> &lhs, const U &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> operator + (const TracedValue<T,E> &lhs, const U &rhs) {
   TRACED_VALUE_DEBUG ("x+");
-  return TracedValue<T> (lhs.Get () + rhs);
+  return TracedValue<T,E> (lhs.Get () + rhs);
 }
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator + (const U &lhs, const TracedValue<T> &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> operator + (const U &lhs, const TracedValue<T,E> &rhs) {
   TRACED_VALUE_DEBUG ("+x");
-  return TracedValue<T> (lhs + rhs.Get ());
+  return TracedValue<T,E> (lhs + rhs.Get ());
 }
 
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator - (const TracedValue<T> &lhs, const TracedValue<U> &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U, bool F>
+TracedValue<T,E> operator - (const TracedValue<T,E> &lhs, const TracedValue<U,F> &rhs) {
   TRACED_VALUE_DEBUG ("x-x");
-  return TracedValue<T> (lhs.Get () - rhs.Get ());
+  return TracedValue<T,E> (lhs.Get () - rhs.Get ());
 }
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator - (const TracedValue<T> &lhs, const U &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> operator - (const TracedValue<T,E> &lhs, const U &rhs) {
   TRACED_VALUE_DEBUG ("x-");
-  return TracedValue<T> (lhs.Get () - rhs);
+  return TracedValue<T,E> (lhs.Get () - rhs);
 }
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator - (const U &lhs, const TracedValue<T> &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> operator - (const U &lhs, const TracedValue<T,E> &rhs) {
   TRACED_VALUE_DEBUG ("-x");
-  return TracedValue<T> (lhs - rhs.Get ());
+  return TracedValue<T,E> (lhs - rhs.Get ());
 }
 
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator * (const TracedValue<T> &lhs, const TracedValue<U> &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U, bool F>
+TracedValue<T,E> operator * (const TracedValue<T,E> &lhs, const TracedValue<U,F> &rhs) {
   TRACED_VALUE_DEBUG ("x*x");
-  return TracedValue<T> (lhs.Get () * rhs.Get ());
+  return TracedValue<T,E> (lhs.Get () * rhs.Get ());
 }
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator * (const TracedValue<T> &lhs, const U &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> operator * (const TracedValue<T,E> &lhs, const U &rhs) {
   TRACED_VALUE_DEBUG ("x*");
-  return TracedValue<T> (lhs.Get () * rhs);
+  return TracedValue<T,E> (lhs.Get () * rhs);
 }
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator * (const U &lhs, const TracedValue<T> &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> operator * (const U &lhs, const TracedValue<T,E> &rhs) {
   TRACED_VALUE_DEBUG ("*x");
-  return TracedValue<T> (lhs * rhs.Get ());
+  return TracedValue<T,E> (lhs * rhs.Get ());
 }
 
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator / (const TracedValue<T> &lhs, const TracedValue<U> &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U, bool F>
+TracedValue<T,E> operator / (const TracedValue<T,E> &lhs, const TracedValue<U,F> &rhs) {
   TRACED_VALUE_DEBUG ("x/x");
-  return TracedValue<T> (lhs.Get () / rhs.Get ());
+  return TracedValue<T,E> (lhs.Get () / rhs.Get ());
 }
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator / (const TracedValue<T> &lhs, const U &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> operator / (const TracedValue<T,E> &lhs, const U &rhs) {
   TRACED_VALUE_DEBUG ("x/");
-  return TracedValue<T> (lhs.Get () / rhs);
+  return TracedValue<T,E> (lhs.Get () / rhs);
 }
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator / (const U &lhs, const TracedValue<T> &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> operator / (const U &lhs, const TracedValue<T,E> &rhs) {
   TRACED_VALUE_DEBUG ("/x");
-  return TracedValue<T> (lhs / rhs.Get ());
+  return TracedValue<T,E> (lhs / rhs.Get ());
 }
 
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator % (const TracedValue<T> &lhs, const TracedValue<U> &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U, bool F>
+TracedValue<T,E> operator % (const TracedValue<T,E> &lhs, const TracedValue<U,F> &rhs) {
   TRACED_VALUE_DEBUG ("x%x");
-  return TracedValue<T> (lhs.Get () % rhs.Get ());
+  return TracedValue<T,E> (lhs.Get () % rhs.Get ());
 }
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator % (const TracedValue<T> &lhs, const U &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> operator % (const TracedValue<T,E> &lhs, const U &rhs) {
   TRACED_VALUE_DEBUG ("x%");
-  return TracedValue<T> (lhs.Get () % rhs);
+  return TracedValue<T,E> (lhs.Get () % rhs);
 }
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator % (const U &lhs, const TracedValue<T> &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> operator % (const U &lhs, const TracedValue<T,E> &rhs) {
   TRACED_VALUE_DEBUG ("%x");
-  return TracedValue<T> (lhs % rhs.Get ());
+  return TracedValue<T,E> (lhs % rhs.Get ());
 }
 
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator ^ (const TracedValue<T> &lhs, const TracedValue<U> &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U, bool F>
+TracedValue<T,E> operator ^ (const TracedValue<T,E> &lhs, const TracedValue<U,F> &rhs) {
   TRACED_VALUE_DEBUG ("x^x");
-  return TracedValue<T> (lhs.Get () ^ rhs.Get ());
+  return TracedValue<T,E> (lhs.Get () ^ rhs.Get ());
 }
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator ^ (const TracedValue<T> &lhs, const U &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> operator ^ (const TracedValue<T,E> &lhs, const U &rhs) {
   TRACED_VALUE_DEBUG ("x^");
-  return TracedValue<T> (lhs.Get () ^ rhs);
+  return TracedValue<T,E> (lhs.Get () ^ rhs);
 }
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator ^ (const U &lhs, const TracedValue<T> &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> operator ^ (const U &lhs, const TracedValue<T,E> &rhs) {
   TRACED_VALUE_DEBUG ("^x");
-  return TracedValue<T> (lhs ^ rhs.Get ());
+  return TracedValue<T,E> (lhs ^ rhs.Get ());
 }
 
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator | (const TracedValue<T> &lhs, const TracedValue<U> &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U, bool F>
+TracedValue<T,E> operator | (const TracedValue<T,E> &lhs, const TracedValue<U,F> &rhs) {
   TRACED_VALUE_DEBUG ("x|x");
-  return TracedValue<T> (lhs.Get () | rhs.Get ());
+  return TracedValue<T,E> (lhs.Get () | rhs.Get ());
 }
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator | (const TracedValue<T> &lhs, const U &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> operator | (const TracedValue<T,E> &lhs, const U &rhs) {
   TRACED_VALUE_DEBUG ("x|");
-  return TracedValue<T> (lhs.Get () | rhs);
+  return TracedValue<T,E> (lhs.Get () | rhs);
 }
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator | (const U &lhs, const TracedValue<T> &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> operator | (const U &lhs, const TracedValue<T,E> &rhs) {
   TRACED_VALUE_DEBUG ("|x");
-  return TracedValue<T> (lhs | rhs.Get ());
+  return TracedValue<T,E> (lhs | rhs.Get ());
 }
 
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator & (const TracedValue<T> &lhs, const TracedValue<U> &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U, bool F>
+TracedValue<T,E> operator & (const TracedValue<T,E> &lhs, const TracedValue<U,F> &rhs) {
   TRACED_VALUE_DEBUG ("x&x");
-  return TracedValue<T> (lhs.Get () & rhs.Get ());
+  return TracedValue<T,E> (lhs.Get () & rhs.Get ());
 }
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator & (const TracedValue<T> &lhs, const U &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> operator & (const TracedValue<T,E> &lhs, const U &rhs) {
   TRACED_VALUE_DEBUG ("x&");
-  return TracedValue<T> (lhs.Get () & rhs);
+  return TracedValue<T,E> (lhs.Get () & rhs);
 }
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator & (const U &lhs, const TracedValue<T> &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> operator & (const U &lhs, const TracedValue<T,E> &rhs) {
   TRACED_VALUE_DEBUG ("&x");
-  return TracedValue<T> (lhs & rhs.Get ());
+  return TracedValue<T,E> (lhs & rhs.Get ());
 }
 
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator << (const TracedValue<T> &lhs, const TracedValue<U> &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U, bool F>
+TracedValue<T,E> operator << (const TracedValue<T,E> &lhs, const TracedValue<U,F> &rhs) {
   TRACED_VALUE_DEBUG ("x<<x");
-  return TracedValue<T> (lhs.Get () << rhs.Get ());
+  return TracedValue<T,E> (lhs.Get () << rhs.Get ());
 }
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator << (const TracedValue<T> &lhs, const U &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> operator << (const TracedValue<T,E> &lhs, const U &rhs) {
   TRACED_VALUE_DEBUG ("x<<");
-  return TracedValue<T> (lhs.Get () << rhs);
+  return TracedValue<T,E> (lhs.Get () << rhs);
 }
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator << (const U &lhs, const TracedValue<T> &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> operator << (const U &lhs, const TracedValue<T,E> &rhs) {
   TRACED_VALUE_DEBUG ("<<x");
-  return TracedValue<T> (lhs << rhs.Get ());
+  return TracedValue<T,E> (lhs << rhs.Get ());
 }
 
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator >> (const TracedValue<T> &lhs, const TracedValue<U> &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U, bool F>
+TracedValue<T,E> operator >> (const TracedValue<T,E> &lhs, const TracedValue<U,F> &rhs) {
   TRACED_VALUE_DEBUG ("x>>x");
-  return TracedValue<T> (lhs.Get () >> rhs.Get ());
+  return TracedValue<T,E> (lhs.Get () >> rhs.Get ());
 }
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator >> (const TracedValue<T> &lhs, const U &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> operator >> (const TracedValue<T,E> &lhs, const U &rhs) {
   TRACED_VALUE_DEBUG ("x>>");
-  return TracedValue<T> (lhs.Get () >> rhs);
+  return TracedValue<T,E> (lhs.Get () >> rhs);
 }
-/** \copydoc operator+(const TracedValue<T>&lhs,const TracedValue<U>&rhs) */
-template <typename T, typename U>
-TracedValue<T> operator >> (const U &lhs, const TracedValue<T> &rhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs,const TracedValue<U,F>&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> operator >> (const U &lhs, const TracedValue<T,E> &rhs) {
   TRACED_VALUE_DEBUG (">>x");
-  return TracedValue<T> (lhs >> rhs.Get ());
+  return TracedValue<T,E> (lhs >> rhs.Get ());
 }
 
 /**
@@ -638,95 +649,96 @@ TracedValue<T> operator >> (const U &lhs, const TracedValue<T> &rhs) {
  * is different, the Callback will be invoked.
  *
  * \tparam T \deduced The underlying type held by the left-hand argument.
+ * \tparam E \deduced Whether the left-hand trace source is compiled in.
  * \tparam U \deduced The underlying type held by the right-hand argument.
  * \param [in] lhs The left-hand argument.
  * \param [in] rhs The right-hand argument.
  * \returns The result of doing the operator on
  *     the underlying values.
  */
-template <typename T, typename U>
-TracedValue<T> &operator += (TracedValue<T> &lhs, const U &rhs) {
+template <typename T, bool E, typename U>
+TracedValue<T,E> &operator += (TracedValue<T,E> &lhs, const U &rhs) {
   TRACED_VALUE_DEBUG ("x+=");
   T tmp = lhs.Get ();
   tmp += rhs;
   lhs.Set (tmp);
   return lhs;
 }
-/** \copydoc operator+=(TracedValue<T>&lhs,const U&rhs) */
-template <typename T, typename U>
-TracedValue<T> &operator -= (TracedValue<T> &lhs, const U &rhs) {
+/** \copydoc operator+=(TracedValue<T,E>&lhs,const U&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> &operator -= (TracedValue<T,E> &lhs, const U &rhs) {
   TRACED_VALUE_DEBUG ("x-=");
   T tmp = lhs.Get ();
   tmp -= rhs;
   lhs.Set (tmp);
   return lhs;
 }
-/** \copydoc operator+=(TracedValue<T>&lhs,const U&rhs) */
-template <typename T, typename U>
-TracedValue<T> &operator *= (TracedValue<T> &lhs, const U &rhs) {
+/** \copydoc operator+=(TracedValue<T,E>&lhs,const U&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> &operator *= (TracedValue<T,E> &lhs, const U &rhs) {
   TRACED_VALUE_DEBUG ("x*=");
   T tmp = lhs.Get ();
   tmp *= rhs;
   lhs.Set (tmp);
   return lhs;
 }
-/** \copydoc operator+=(TracedValue<T>&lhs,const U&rhs) */
-template <typename T, typename U>
-TracedValue<T> &operator /= (TracedValue<T> &lhs, const U &rhs) {
+/** \copydoc operator+=(TracedValue<T,E>&lhs,const U&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> &operator /= (TracedValue<T,E> &lhs, const U &rhs) {
   TRACED_VALUE_DEBUG ("x/=");
   T tmp = lhs.Get ();
   tmp /= rhs;
   lhs.Set (tmp);
   return lhs;
 }
-/** \copydoc operator+=(TracedValue<T>&lhs,const U&rhs) */
-template <typename T, typename U>
-TracedValue<T> &operator %= (TracedValue<T> &lhs, const U &rhs) {
+/** \copydoc operator+=(TracedValue<T,E>&lhs,const U&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> &operator %= (TracedValue<T,E> &lhs, const U &rhs) {
   TRACED_VALUE_DEBUG ("x%=");
   T tmp = lhs.Get ();
   tmp %= rhs;
   lhs.Set (tmp);
   return lhs;
 }
-/** \copydoc operator+=(TracedValue<T>&lhs,const U&rhs) */
-template <typename T, typename U>
-TracedValue<T> &operator <<= (TracedValue<T> &lhs, const U &rhs) {
+/** \copydoc operator+=(TracedValue<T,E>&lhs,const U&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> &operator <<= (TracedValue<T,E> &lhs, const U &rhs) {
   TRACED_VALUE_DEBUG ("x<<=");
   T tmp = lhs.Get ();
   tmp <<= rhs;
   lhs.Set (tmp);
   return lhs;
 }
-/** \copydoc operator+=(TracedValue<T>&lhs,const U&rhs) */
-template <typename T, typename U>
-TracedValue<T> &operator >>= (TracedValue<T> &lhs, const U &rhs) {
+/** \copydoc operator+=(TracedValue<T,E>&lhs,const U&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> &operator >>= (TracedValue<T,E> &lhs, const U &rhs) {
   TRACED_VALUE_DEBUG ("x>>=");
   T tmp = lhs.Get ();
   tmp >>= rhs;
   lhs.Set (tmp);
   return lhs;
 }
-/** \copydoc operator+=(TracedValue<T>&lhs,const U&rhs) */
-template <typename T, typename U>
-TracedValue<T> &operator &= (TracedValue<T> &lhs, const U &rhs) {
+/** \copydoc operator+=(TracedValue<T,E>&lhs,const U&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> &operator &= (TracedValue<T,E> &lhs, const U &rhs) {
   TRACED_VALUE_DEBUG ("x&=");
   T tmp = lhs.Get ();
   tmp &= rhs;
   lhs.Set (tmp);
   return lhs;
 }
-/** \copydoc operator+=(TracedValue<T>&lhs,const U&rhs) */
-template <typename T, typename U>
-TracedValue<T> &operator |= (TracedValue<T> &lhs, const U &rhs) {
+/** \copydoc operator+=(TracedValue<T,E>&lhs,const U&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> &operator |= (TracedValue<T,E> &lhs, const U &rhs) {
   TRACED_VALUE_DEBUG ("x|=");
   T tmp = lhs.Get ();
   tmp |= rhs;
   lhs.Set (tmp);
   return lhs;
 }
-/** \copydoc operator+=(TracedValue<T>&lhs,const U&rhs) */
-template <typename T, typename U>
-TracedValue<T> &operator ^= (TracedValue<T> &lhs, const U &rhs) {
+/** \copydoc operator+=(TracedValue<T,E>&lhs,const U&rhs) */
+template <typename T, bool E, typename U>
+TracedValue<T,E> &operator ^= (TracedValue<T,E> &lhs, const U &rhs) {
   TRACED_VALUE_DEBUG ("x^=");
   T tmp = lhs.Get ();
   tmp ^= rhs;
@@ -739,32 +751,33 @@ TracedValue<T> &operator ^= (TracedValue<T> &lhs, const U &rhs) {
  * Unary arithmetic operator for TracedValue.
  *
  * \tparam T \deduced The underlying type held by the TracedValue.
+ * \tparam E \deduced Whether the trace source is compiled in.
  * \param [in] lhs The TracedValue.
  * \returns The result of doing the operator on
  *     the underlying values.
  */
-template <typename T>
-TracedValue<T> operator + (const TracedValue<T> &lhs) {
+template <typename T, bool E>
+TracedValue<T,E> operator + (const TracedValue<T,E> &lhs) {
   TRACED_VALUE_DEBUG ("(+x)");
-  return TracedValue<T> (+lhs.Get ());
+  return TracedValue<T,E> (+lhs.Get ());
 }
-/** \copydoc operator+(const TracedValue<T>&lhs) */
-template <typename T>
-TracedValue<T> operator - (const TracedValue<T> &lhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs) */
+template <typename T, bool E>
+TracedValue<T,E> operator - (const TracedValue<T,E> &lhs) {
   TRACED_VALUE_DEBUG ("(-x)");
-  return TracedValue<T> (-lhs.Get ());
+  return TracedValue<T,E> (-lhs.Get ());
 }
-/** \copydoc operator+(const TracedValue<T>&lhs) */
-template <typename T>
-TracedValue<T> operator ~ (const TracedValue<T> &lhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs) */
+template <typename T, bool E>
+TracedValue<T,E> operator ~ (const TracedValue<T,E> &lhs) {
   TRACED_VALUE_DEBUG ("(~x)");
-  return TracedValue<T> (~lhs.Get ());
+  return TracedValue<T,E> (~lhs.Get ());
 }
-/** \copydoc operator+(const TracedValue<T>&lhs) */
-template <typename T>
-TracedValue<T> operator ! (const TracedValue<T> &lhs) {
+/** \copydoc operator+(const TracedValue<T,E>&lhs) */
+template <typename T, bool E>
+TracedValue<T,E> operator ! (const TracedValue<T,E> &lhs) {
   TRACED_VALUE_DEBUG ("(!x)");
-  return TracedValue<T> (!lhs.Get ());
+  return TracedValue<T,E> (!lhs.Get ());
 }
 
 /**@}*/  // \ingroup tracing
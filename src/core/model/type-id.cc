@@ -23,7 +23,9 @@
 #include "singleton.h"
 #include "trace-source-accessor.h"
 
+#include <atomic>
 #include <map>
+#include <mutex>
 #include <vector>
 #include <sstream>
 #include <iomanip>
@@ -78,6 +80,10 @@ NS_LOG_COMPONENT_DEFINE ("TypeId");
 class IidManager : public Singleton<IidManager>
 {
 public:
+  /** Constructor. */
+  IidManager ();
+  /** Destructor. */
+  ~IidManager ();
   /**
    * Create a new unique type id.
    * \param [in] name The name of this type id.
@@ -228,7 +234,7 @@ public:
    * \param [in] i Index into attribute array
    * \returns The information associated to attribute whose index is \p i.
    */
-  struct TypeId::AttributeInformation GetAttribute(uint16_t uid, uint32_t i) const;
+  const struct TypeId::AttributeInformation &GetAttribute(uint16_t uid, uint32_t i) const;
   /**
    * Record a new TraceSource.
    * \param [in] uid The id.
@@ -320,9 +326,6 @@ private:
     /** Support message. */
     std::string supportMsg;
   };
-  /** Iterator type. */
-  typedef std::vector<struct IidInformation>::const_iterator Iterator;
-
   /**
    * Retrieve the information record for a type.
    * \param [in] uid The id.
@@ -330,8 +333,22 @@ private:
    */
   struct IidManager::IidInformation *LookupInformation (uint16_t uid) const;
 
-  /** The container of all type id records. */
-  std::vector<struct IidInformation> m_information;
+  /** IidManager storage constants. */
+  enum {
+    /** The number of type id records in a block of the container. */
+    BlockSize = 256
+  };
+
+  /**
+   * The container of all type id records, in blocks allocated as the
+   * types get registered. A record never moves, so that the references
+   * to it stay valid while other threads register more types.
+   */
+  struct IidInformation *m_information[0x10000 / BlockSize];
+  /** The number of type id records. */
+  std::atomic<uint32_t> m_size;
+  /** Serializes the registrations and the lookups by name and hash. */
+  mutable std::mutex m_mutex;
 
   /** Type of the by-name index. */
   typedef std::map<std::string, uint16_t> namemap_t;
@@ -368,10 +385,29 @@ IidManager::Hasher (const std::string name)
 #define IID "IidManager"
 #define IIDL IID << ": "
 
+IidManager::IidManager ()
+  : m_size (0)
+{
+  for (uint32_t i = 0; i < 0x10000 / BlockSize; i++)
+    {
+      m_information[i] = 0;
+    }
+}
+
+IidManager::~IidManager ()
+{
+  for (uint32_t i = 0; i < 0x10000 / BlockSize; i++)
+    {
+      delete [] m_information[i];
+    }
+}
+
 uint16_t
 IidManager::AllocateUid (std::string name)
 {
   NS_LOG_FUNCTION (IID << name);
+  // the types may be registered by several threads at once
+  std::lock_guard<std::mutex> lock (m_mutex);
   // Type names are definitive: equal names are equal types
   NS_ASSERT_MSG (m_namemap.count (name) == 0,
                  "Trying to allocate twice the same uid: " << name);
@@ -404,7 +440,7 @@ IidManager::AllocateUid (std::string name)
     // into ns3.  -- Peter Barnes, LLNL
     
     // Alphabetize the two types, so it's deterministic
-    struct IidInformation * hinfo = LookupInformation (GetUid (hash));
+    struct IidInformation * hinfo = LookupInformation (m_hashmap.find (hash)->second);
     if (name > hinfo->name)
       { // new type gets chained
         NS_LOG_LOGIC (IIDL << "New TypeId '" << name << "' getting chained.");
@@ -413,7 +449,7 @@ IidManager::AllocateUid (std::string name)
     else
       { // chain old type
         NS_LOG_LOGIC (IIDL << "Old TypeId '" << hinfo->name << "' getting chained.");
-        uint32_t oldUid = GetUid (hinfo->hash);
+        uint32_t oldUid = m_hashmap.find (hinfo->hash)->second;
         m_hashmap.erase (m_hashmap.find (hinfo->hash));
         hinfo->hash = hash | HashChainFlag;
         m_hashmap.insert (std::make_pair (hinfo->hash, oldUid));
@@ -429,9 +465,15 @@ IidManager::AllocateUid (std::string name)
   information.size = (std::size_t)(-1);
   information.hasConstructor = false;
   information.mustHideFromDocumentation = false;
-  m_information.push_back (information);
-  uint32_t uid = m_information.size ();
+  uint32_t uid = m_size.load () + 1;
   NS_ASSERT (uid <= 0xffff);
+  uint32_t block = (uid - 1) / BlockSize;
+  if (m_information[block] == 0)
+    {
+      m_information[block] = new struct IidInformation[BlockSize];
+    }
+  m_information[block][(uid - 1) % BlockSize] = information;
+  m_size.store (uid);
 
   // Add to both maps:
   m_namemap.insert (std::make_pair (name, uid));
@@ -444,16 +486,17 @@ struct IidManager::IidInformation *
 IidManager::LookupInformation (uint16_t uid) const
 {
   NS_LOG_FUNCTION (IID << uid);
-  NS_ASSERT (uid <= m_information.size () && uid != 0);
-  NS_LOG_LOGIC (IIDL << m_information[uid-1].name);
-  return const_cast<struct IidInformation *> (&m_information[uid-1]);
+  NS_ASSERT (uid <= m_size.load () && uid != 0);
+  struct IidInformation *information = &m_information[(uid - 1) / BlockSize][(uid - 1) % BlockSize];
+  NS_LOG_LOGIC (IIDL << information->name);
+  return information;
 }
 
 void 
 IidManager::SetParent (uint16_t uid, uint16_t parent)
 {
   NS_LOG_FUNCTION (IID << uid << parent);
-  NS_ASSERT (parent <= m_information.size ());
+  NS_ASSERT (parent <= m_size.load ());
   struct IidInformation *information = LookupInformation (uid);
   information->parent = parent;
 }
@@ -496,6 +539,7 @@ uint16_t
 IidManager::GetUid (std::string name) const
 {
   NS_LOG_FUNCTION (IID << name);
+  std::lock_guard<std::mutex> lock (m_mutex);
   uint16_t uid = 0;
   namemap_t::const_iterator it = m_namemap.find (name);
   if (it != m_namemap.end ())
@@ -509,6 +553,7 @@ uint16_t
 IidManager::GetUid (TypeId::hash_t hash) const
 {
   NS_LOG_FUNCTION (IID << hash);
+  std::lock_guard<std::mutex> lock (m_mutex);
   hashmap_t::const_iterator it = m_hashmap.find (hash);
   uint16_t uid = 0;
   if (it != m_hashmap.end ())
@@ -587,8 +632,8 @@ IidManager::HasConstructor (uint16_t uid) const
 uint32_t 
 IidManager::GetRegisteredN (void) const
 {
-  NS_LOG_FUNCTION (IID << m_information.size ());
-  return m_information.size ();
+  NS_LOG_FUNCTION (IID << m_size.load ());
+  return m_size.load ();
 }
 uint16_t 
 IidManager::GetRegistered (uint32_t i) const
@@ -689,7 +734,7 @@ IidManager::GetAttributeN (uint16_t uid) const
   NS_LOG_LOGIC (IIDL << size);
   return size;
 }
-struct TypeId::AttributeInformation 
+const struct TypeId::AttributeInformation &
 IidManager::GetAttribute(uint16_t uid, uint32_t i) const
 {
   NS_LOG_FUNCTION (IID << uid << i);
@@ -872,7 +917,7 @@ TypeId::LookupAttributeByName (std::string name, struct TypeId::AttributeInforma
       tid = nextTid;
       for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
         {
-          struct TypeId::AttributeInformation tmp = tid.GetAttribute(i);
+          const struct TypeId::AttributeInformation &tmp = tid.GetAttribute(i);
           if (tmp.name == name)
             {
               if (tmp.supportLevel == TypeId::SUPPORTED)
@@ -1061,7 +1106,7 @@ TypeId::GetAttributeN (void) const
   uint32_t n = IidManager::Get ()->GetAttributeN (m_tid);
   return n;
 }
-struct TypeId::AttributeInformation 
+const struct TypeId::AttributeInformation &
 TypeId::GetAttribute(uint32_t i) const
 {
   NS_LOG_FUNCTION (this << i);
@@ -1071,7 +1116,7 @@ std::string
 TypeId::GetAttributeFullName (uint32_t i) const
 {
   NS_LOG_FUNCTION (this << i);
-  struct TypeId::AttributeInformation info = GetAttribute(i);
+  const struct TypeId::AttributeInformation &info = GetAttribute(i);
   return GetName () + "::" + info.name;
 }
 
@@ -33,10 +33,34 @@ NS_LOG_COMPONENT_DEFINE ("Watchdog");
 
 Watchdog::Watchdog ()
   : m_impl (0),
-    m_event (),
+    m_entry (),
     m_end (MicroSeconds (0))
 {
   NS_LOG_FUNCTION_NOARGS ();
+  m_entry.SetFunction (MakeCallback (&Watchdog::Expire, this));
+}
+
+Watchdog::Watchdog (const Watchdog &o)
+  : m_impl (o.m_impl == 0 ? 0 : o.m_impl->Copy ()),
+    m_entry (),
+    m_end (MicroSeconds (0))
+{
+  NS_LOG_FUNCTION (this << &o);
+  m_entry.SetFunction (MakeCallback (&Watchdog::Expire, this));
+}
+
+Watchdog &
+Watchdog::operator = (const Watchdog &o)
+{
+  NS_LOG_FUNCTION (this << &o);
+  if (this != &o)
+    {
+      m_entry.Cancel ();
+      m_end = MicroSeconds (0);
+      delete m_impl;
+      m_impl = o.m_impl == 0 ? 0 : o.m_impl->Copy ();
+    }
+  return *this;
 }
 
 Watchdog::~Watchdog ()
@@ -51,25 +75,18 @@ Watchdog::Ping (Time delay)
   NS_LOG_FUNCTION (this << delay);
   Time end = Simulator::Now () + delay;
   m_end = std::max (m_end, end);
-  if (m_event.IsRunning ())
+  if (m_entry.IsPending () && m_entry.GetExpiry () == m_end)
     {
       return;
     }
-  m_event = Simulator::Schedule (m_end - Now (), &Watchdog::Expire, this);
+  m_entry.Schedule (m_end - Simulator::Now ());
 }
 
 void
 Watchdog::Expire (void)
 {
   NS_LOG_FUNCTION (this);
-  if (m_end == Simulator::Now ())
-    {
-      m_impl->Invoke ();
-    }
-  else
-    {
-      m_event = Simulator::Schedule (m_end - Now (), &Watchdog::Expire, this);
-    }
+  m_impl->Invoke ();
 }
 
 } // namespace ns3
@@ -21,7 +21,7 @@
 #define WATCHDOG_H
 
 #include "nstime.h"
-#include "event-id.h"
+#include "timer-wheel.h"
 
 /**
  * \file
@@ -51,6 +51,8 @@ class TimerImpl;
  * If you don't ping the watchdog sufficiently often, it triggers its
  * listening function.
  *
+ * The watchdog waits in the TimerWheel, so pinging it costs no event.
+ *
  * \see Timer for a more sophisticated general purpose timer.
  */
 class Watchdog 
@@ -58,6 +60,25 @@ class Watchdog
 public:
   /** Constructor. */
   Watchdog ();
+  /**
+   * Copy constructor.
+   *
+   * The copy has the function and the arguments of \p o, and its own
+   * entry in the TimerWheel: it is not armed, even if \p o is.
+   *
+   * \param [in] o The Watchdog to copy
+   */
+  Watchdog (const Watchdog &o);
+  /**
+   * Assignment operator.
+   *
+   * This Watchdog is disarmed, then takes the function and the
+   * arguments of \p o.
+   *
+   * \param [in] o The Watchdog to copy
+   * \returns This Watchdog
+   */
+  Watchdog & operator = (const Watchdog &o);
   /** Destructor. */
   ~Watchdog ();
 
@@ -176,8 +197,8 @@ private:
    * function and arguments.
    */
   TimerImpl *m_impl;
-  /** The future event scheduled to expire the timer. */
-  EventId m_event;
+  /** The entry of the watchdog in the TimerWheel. */
+  TimerWheel::Entry m_entry;
   /** The absolute time when the timer will expire. */
   Time m_end;
 };
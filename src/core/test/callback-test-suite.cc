@@ -18,6 +18,7 @@
 
 #include "ns3/test.h"
 #include "ns3/callback.h"
+#include "ns3/simple-ref-count.h"
 #include <stdint.h>
 
 using namespace ns3;
@@ -688,6 +689,81 @@ MakeCallbackTemplatesTestCase::DoRun (void)
   that.CheckParentalRights ();
 }
 
+// ===========================================================================
+// Check that copies of callbacks held inline and on the heap behave alike
+// ===========================================================================
+class CallbackCopyTarget : public SimpleRefCount<CallbackCopyTarget>
+{
+public:
+  CallbackCopyTarget () : m_sum (0) {}
+  void Add (int a) { m_sum += a; }
+  int m_sum;
+};
+
+static int g_copyBoundSum;
+
+void CopyBoundTarget (Ptr<CallbackCopyTarget> target, int a, int b) { g_copyBoundSum += a + b; }
+
+class CopyCallbackTestCase : public TestCase
+{
+public:
+  CopyCallbackTestCase ();
+  virtual ~CopyCallbackTestCase () {}
+
+private:
+  virtual void DoRun (void);
+};
+
+CopyCallbackTestCase::CopyCallbackTestCase ()
+  : TestCase ("Check copy, assignment and IsEqual of Callbacks")
+{
+}
+
+void
+CopyCallbackTestCase::DoRun (void)
+{
+  Ptr<CallbackCopyTarget> target = Create<CallbackCopyTarget> ();
+  Ptr<CallbackCopyTarget> other = Create<CallbackCopyTarget> ();
+  {
+    Callback<void, int> a = MakeCallback (&CallbackCopyTarget::Add, target);
+    Callback<void, int> b = a;
+    Callback<void, int> c;
+    c = b;
+    c = c;
+    NS_TEST_ASSERT_MSG_EQ (target->GetReferenceCount (), 4, "each copy holds a reference");
+    NS_TEST_ASSERT_MSG_EQ (a.IsEqual (b), true, "copy is not equal to the original");
+    NS_TEST_ASSERT_MSG_EQ (c.IsEqual (a), true, "assigned copy is not equal to the original");
+    NS_TEST_ASSERT_MSG_EQ (a.IsEqual (MakeCallback (&CallbackCopyTarget::Add, other)), false,
+                           "callbacks on different objects are equal");
+    a (1);
+    b (2);
+    c (3);
+    NS_TEST_ASSERT_MSG_EQ (target->m_sum, 6, "copies do not call the same object");
+    c.Nullify ();
+    NS_TEST_ASSERT_MSG_EQ (c.IsNull (), true, "Nullify did not release the callback");
+    NS_TEST_ASSERT_MSG_EQ (target->GetReferenceCount (), 3, "Nullify did not drop the reference");
+  }
+  NS_TEST_ASSERT_MSG_EQ (target->GetReferenceCount (), 1, "copies leaked a reference");
+
+  // Bind stores a whole callback, which does not fit inline
+  g_copyBoundSum = 0;
+  {
+    Callback<void, int, int> bound = MakeBoundCallback (&CopyBoundTarget, target);
+    Callback<void, int> big = bound.Bind (10);
+    Callback<void, int> copy;
+    NS_TEST_ASSERT_MSG_EQ (copy.CheckType (big), true, "CheckType failed");
+    NS_TEST_ASSERT_MSG_EQ (copy.Assign (big), true, "Assign failed");
+    NS_TEST_ASSERT_MSG_EQ (copy.IsEqual (big), true, "assigned copy is not equal to the original");
+    copy (1);
+    big (2);
+    NS_TEST_ASSERT_MSG_EQ (g_copyBoundSum, 23, "bound callback not called");
+    copy = MakeCallback (&CallbackCopyTarget::Add, other);
+    NS_TEST_ASSERT_MSG_EQ (copy.IsEqual (big), false, "callbacks of different kinds are equal");
+  }
+  NS_TEST_ASSERT_MSG_EQ (target->GetReferenceCount (), 1, "bound copies leaked a reference");
+  NS_TEST_ASSERT_MSG_EQ (other->GetReferenceCount (), 1, "assignment leaked a reference");
+}
+
 // ===========================================================================
 // The Test Suite that glues all of the Test Cases together.
 // ===========================================================================
@@ -705,6 +781,7 @@ CallbackTestSuite::CallbackTestSuite ()
   AddTestCase (new MakeBoundCallbackTestCase, TestCase::QUICK);
   AddTestCase (new NullifyCallbackTestCase, TestCase::QUICK);
   AddTestCase (new MakeCallbackTemplatesTestCase, TestCase::QUICK);
+  AddTestCase (new CopyCallbackTestCase, TestCase::QUICK);
 }
 
 static CallbackTestSuite CallbackTestSuite;
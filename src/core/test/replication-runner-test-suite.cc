@@ -0,0 +1,351 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/replication-runner.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/timer.h"
+#include "ns3/names.h"
+#include "ns3/config.h"
+#include "ns3/object.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/object-factory.h"
+#include "ns3/double.h"
+#include "ns3/rng-seed-manager.h"
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * A chain of timer expiries with random delays.
+ */
+class RandomChain
+{
+public:
+  /**
+   * \param [in] scales The delay scales, shared by the replications
+   */
+  RandomChain (const std::vector<double> *scales)
+    : m_scales (scales),
+      m_variable (CreateObject<UniformRandomVariable> ()),
+      m_steps (0),
+      m_sum (0)
+  {
+    m_timer.SetFunction (&RandomChain::Step, this);
+    m_timer.Schedule (MilliSeconds (1));
+  }
+  /** Draw a value and rearm the timer until the last step. */
+  void Step (void)
+  {
+    double value = m_variable->GetValue ();
+    m_sum += value;
+    if (++m_steps < 1000)
+      {
+        double scale = (*m_scales)[m_steps % m_scales->size ()];
+        m_timer.Schedule (MicroSeconds (1 + value * scale));
+      }
+  }
+
+  const std::vector<double> *m_scales;   //!< The delay scales
+  Ptr<UniformRandomVariable> m_variable; //!< The delays
+  Timer m_timer;                         //!< The next step
+  uint32_t m_steps;                      //!< The number of steps so far
+  double m_sum;                          //!< The sum of the values drawn
+};
+
+/**
+ * Run a random chain with the names and Config roots of a simulation.
+ * \param [in] scales The delay scales
+ * \param [in] run The run of the replication
+ * \returns The sum of the values drawn plus the end time, or -1 if the
+ * replication saw the state of another simulation
+ */
+static double
+Replicate (const std::vector<double> *scales, uint64_t run)
+{
+  if (RngSeedManager::GetRun () != run
+      || Simulator::Now () != Seconds (0)
+      || Names::Find<Object> ("simulation") != 0
+      || Config::GetRootNamespaceObjectN () != 0)
+    {
+      return -1;
+    }
+  Ptr<Object> root = CreateObject<Object> ();
+  Names::Add ("simulation", root);
+  Config::RegisterRootNamespaceObject (root);
+  RandomChain chain (scales);
+  Simulator::Run ();
+  Config::UnregisterRootNamespaceObject (root);
+  return chain.m_sum + Simulator::Now ().GetSeconds ();
+}
+
+/**
+ * Check that concurrent replications give the same results as
+ * sequential ones.
+ */
+class ReplicationRunnerTestCase : public TestCase
+{
+public:
+  ReplicationRunnerTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+ReplicationRunnerTestCase::ReplicationRunnerTestCase ()
+  : TestCase ("Concurrent replications match sequential ones")
+{
+}
+
+void
+ReplicationRunnerTestCase::DoRun (void)
+{
+  std::vector<double> scales;
+  scales.push_back (10);
+  scales.push_back (1000);
+  scales.push_back (100);
+  Callback<double, uint64_t> replication = MakeBoundCallback (&Replicate, &scales);
+
+  ReplicationRunner runner;
+  runner.SetThreads (1);
+  std::vector<double> sequential = runner.Run (replication, 3, 8);
+  runner.SetThreads (4);
+  std::vector<double> concurrent = runner.Run (replication, 3, 8);
+
+  NS_TEST_ASSERT_MSG_EQ (concurrent.size (), 8, "One result per run");
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      NS_TEST_ASSERT_MSG_GT (sequential[i], 0, "Replication " << i << " is not isolated");
+      NS_TEST_ASSERT_MSG_EQ (concurrent[i], sequential[i], "Replication " << i << " differs");
+      if (i > 0)
+        {
+          NS_TEST_ASSERT_MSG_NE (sequential[i], sequential[i - 1], "Runs should differ");
+        }
+    }
+}
+
+/**
+ * Check that replications leave the simulation of the process alone.
+ */
+class ReplicationProcessTestCase : public TestCase
+{
+public:
+  ReplicationProcessTestCase ();
+private:
+  virtual void DoRun (void);
+  /** An event of the simulation of the process. */
+  void Event (void);
+
+  uint32_t m_events; //!< The number of events run
+};
+
+ReplicationProcessTestCase::ReplicationProcessTestCase ()
+  : TestCase ("Replications do not touch the simulation of the process"),
+    m_events (0)
+{
+}
+
+void
+ReplicationProcessTestCase::Event (void)
+{
+  m_events++;
+}
+
+void
+ReplicationProcessTestCase::DoRun (void)
+{
+  uint64_t run = RngSeedManager::GetRun ();
+  Ptr<Object> root = CreateObject<Object> ();
+  Names::Add ("process", root);
+  Simulator::Schedule (Seconds (1), &ReplicationProcessTestCase::Event, this);
+
+  std::vector<double> scales (1, 100);
+  ReplicationRunner runner;
+  runner.SetThreads (2);
+  std::vector<double> results = runner.Run (MakeBoundCallback (&Replicate, &scales), 1, 4);
+  for (uint32_t i = 0; i < results.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_GT (results[i], 0, "Replication " << i << " is not isolated");
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (RngSeedManager::GetRun (), run, "The run of the process changed");
+  NS_TEST_ASSERT_MSG_EQ (Names::Find<Object> ("process"), root, "The names of the process changed");
+  NS_TEST_ASSERT_MSG_EQ (Simulator::Now (), Seconds (0), "The time of the process changed");
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_events, 1, "The events of the process changed");
+  Simulator::Destroy ();
+  Names::Clear ();
+}
+
+/**
+ * Create many objects with attributes, some of them set through a
+ * factory.
+ * \param [in] run The run of the replication
+ * \returns The number of objects whose attributes were wrong
+ */
+static uint32_t
+CreateObjects (uint64_t run)
+{
+  uint32_t errors = 0;
+  ObjectFactory factory;
+  factory.SetTypeId (UniformRandomVariable::GetTypeId ());
+  factory.Set ("Max", DoubleValue (run));
+  for (uint32_t i = 0; i < 20000; i++)
+    {
+      Ptr<UniformRandomVariable> variable = CreateObject<UniformRandomVariable> ();
+      Ptr<UniformRandomVariable> set = factory.Create<UniformRandomVariable> ();
+      if (variable->GetMax () != 1 || set->GetMax () != run)
+        {
+          errors++;
+        }
+    }
+  return errors;
+}
+
+/**
+ * Check that objects created concurrently leave the reference counts
+ * of the attributes shared through their TypeId intact.
+ */
+class ReplicationCreateObjectTestCase : public TestCase
+{
+public:
+  ReplicationCreateObjectTestCase ();
+private:
+  virtual void DoRun (void);
+  /**
+   * \param [in] tid The TypeId
+   * \returns The reference counts of the accessors, checkers and
+   * initial values of the attributes of the TypeId and its parents
+   */
+  std::vector<uint32_t> GetReferenceCounts (TypeId tid);
+};
+
+ReplicationCreateObjectTestCase::ReplicationCreateObjectTestCase ()
+  : TestCase ("Concurrent object creations share the attributes of the TypeIds")
+{
+}
+
+std::vector<uint32_t>
+ReplicationCreateObjectTestCase::GetReferenceCounts (TypeId tid)
+{
+  std::vector<uint32_t> counts;
+  for (; tid != Object::GetTypeId (); tid = tid.GetParent ())
+    {
+      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+        {
+          const struct TypeId::AttributeInformation &info = tid.GetAttribute (i);
+          counts.push_back (info.accessor->GetReferenceCount ());
+          counts.push_back (info.checker->GetReferenceCount ());
+          counts.push_back (info.initialValue->GetReferenceCount ());
+        }
+    }
+  return counts;
+}
+
+void
+ReplicationCreateObjectTestCase::DoRun (void)
+{
+  std::vector<uint32_t> before = GetReferenceCounts (UniformRandomVariable::GetTypeId ());
+  ReplicationRunner runner;
+  runner.SetThreads (4);
+  std::vector<uint32_t> errors = runner.Run (MakeCallback (&CreateObjects), 1, 8);
+  for (uint32_t i = 0; i < errors.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (errors[i], 0, "Replication " << i << " created wrong objects");
+    }
+  std::vector<uint32_t> after = GetReferenceCounts (UniformRandomVariable::GetTypeId ());
+  NS_TEST_ASSERT_MSG_EQ (after.size (), before.size (), "The attributes changed");
+  for (uint32_t i = 0; i < before.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (after[i], before[i], "A reference count of attribute " << i / 3 << " changed");
+    }
+}
+
+/**
+ * Register new TypeIds while holding a reference to an attribute of a
+ * TypeId registered before.
+ * \param [in] run The run of the replication
+ * \returns The number of TypeIds or attributes found wrong
+ */
+static uint32_t
+RegisterTypeIds (uint64_t run)
+{
+  uint32_t errors = 0;
+  const struct TypeId::AttributeInformation &max =
+    UniformRandomVariable::GetTypeId ().GetAttribute (1);
+  for (uint32_t i = 0; i < 300; i++)
+    {
+      std::ostringstream oss;
+      oss << "ns3::ReplicationTestType" << run << "-" << i;
+      TypeId tid = TypeId (oss.str ().c_str ())
+        .SetParent<Object> ()
+        .SetGroupName ("Core");
+      TypeId found;
+      if (!TypeId::LookupByNameFailSafe (oss.str (), &found) || found != tid
+          || tid.GetParent () != Object::GetTypeId () || max.name != "Max")
+        {
+          errors++;
+        }
+    }
+  return errors;
+}
+
+/**
+ * Check that TypeIds registered concurrently are all found, and leave
+ * the attributes of the other TypeIds in place.
+ */
+class ReplicationTypeIdTestCase : public TestCase
+{
+public:
+  ReplicationTypeIdTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+ReplicationTypeIdTestCase::ReplicationTypeIdTestCase ()
+  : TestCase ("Concurrent TypeId registrations")
+{
+}
+
+void
+ReplicationTypeIdTestCase::DoRun (void)
+{
+  uint32_t registered = TypeId::GetRegisteredN ();
+  ReplicationRunner runner;
+  runner.SetThreads (4);
+  std::vector<uint32_t> errors = runner.Run (MakeCallback (&RegisterTypeIds), 1, 8);
+  for (uint32_t i = 0; i < errors.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (errors[i], 0, "Replication " << i << " registered wrong TypeIds");
+    }
+  NS_TEST_ASSERT_MSG_EQ (TypeId::GetRegisteredN (), registered + 8 * 300, "TypeIds not registered");
+}
+
+/**
+ * The replication runner test suite.
+ */
+class ReplicationRunnerTestSuite : public TestSuite
+{
+public:
+  ReplicationRunnerTestSuite ()
+    : TestSuite ("replication-runner")
+  {
+    AddTestCase (new ReplicationRunnerTestCase, TestCase::QUICK);
+    AddTestCase (new ReplicationProcessTestCase, TestCase::QUICK);
+    AddTestCase (new ReplicationCreateObjectTestCase, TestCase::QUICK);
+    AddTestCase (new ReplicationTypeIdTestCase, TestCase::QUICK);
+  }
+} g_replicationRunnerTestSuite;
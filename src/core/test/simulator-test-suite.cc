@@ -23,6 +23,12 @@
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/ladder-scheduler.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/event-allocator.h"
+#include "ns3/uinteger.h"
+#include <set>
+#include <vector>
 
 using namespace ns3;
 
@@ -459,6 +465,216 @@ SimulatorTemplateTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class SchedulerOrderTestCase : public TestCase
+{
+public:
+  SchedulerOrderTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  ObjectFactory m_schedulerFactory;
+};
+
+SchedulerOrderTestCase::SchedulerOrderTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check that a mix of inserts and removes is ordered with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{
+}
+
+void
+SchedulerOrderTestCase::DoRun (void)
+{
+  Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler> ();
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (1);
+
+  // reference ordering
+  std::set<Scheduler::Event> pending;
+  std::vector<Scheduler::Event> removable;
+  uint64_t now = 0;
+  uint32_t uid = 0;
+  bool ordered = true;
+  for (uint32_t i = 0; i < 20000; i++)
+    {
+      uint32_t action = rng->GetInteger (0, 9);
+      if (action < 5 || pending.empty ())
+        {
+          Scheduler::Event ev;
+          ev.impl = 0;
+          // mix of near, far and simultaneous events
+          uint32_t kind = rng->GetInteger (0, 2);
+          uint64_t delay = kind == 0 ? 0 : (kind == 1 ? rng->GetInteger (0, 100) : rng->GetInteger (0, 1000000));
+          ev.key.m_ts = now + delay;
+          ev.key.m_uid = uid++;
+          ev.key.m_context = 0;
+          scheduler->Insert (ev);
+          pending.insert (ev);
+          removable.push_back (ev);
+        }
+      else if (action < 8)
+        {
+          Scheduler::Event ev = scheduler->RemoveNext ();
+          Scheduler::Event expected = *pending.begin ();
+          pending.erase (pending.begin ());
+          if (ev.key.m_uid != expected.key.m_uid)
+            {
+              ordered = false;
+            }
+          now = ev.key.m_ts;
+        }
+      else
+        {
+          uint32_t index = rng->GetInteger (0, removable.size () - 1);
+          Scheduler::Event ev = removable[index];
+          removable[index] = removable.back ();
+          removable.pop_back ();
+          if (pending.erase (ev) == 1)
+            {
+              scheduler->Remove (ev);
+            }
+        }
+    }
+  while (!pending.empty ())
+    {
+      NS_TEST_ASSERT_MSG_EQ (scheduler->IsEmpty (), false, "Scheduler lost events");
+      Scheduler::Event ev = scheduler->RemoveNext ();
+      if (ev.key.m_uid != pending.begin ()->key.m_uid)
+        {
+          ordered = false;
+        }
+      pending.erase (pending.begin ());
+    }
+  NS_TEST_EXPECT_MSG_EQ (ordered, true, "Events removed out of order");
+  NS_TEST_EXPECT_MSG_EQ (scheduler->IsEmpty (), true, "Scheduler not empty");
+}
+
+class EventAllocatorTestCase : public TestCase
+{
+public:
+  EventAllocatorTestCase ();
+  virtual void DoRun (void);
+  void Reschedule (uint32_t n);
+};
+
+EventAllocatorTestCase::EventAllocatorTestCase ()
+  : TestCase ("Check that the storage of expired events is recycled")
+{
+}
+
+void
+EventAllocatorTestCase::Reschedule (uint32_t n)
+{
+  if (n > 0)
+    {
+      Simulator::Schedule (MicroSeconds (1), &EventAllocatorTestCase::Reschedule, this, n - 1);
+    }
+}
+
+void
+EventAllocatorTestCase::DoRun (void)
+{
+  EventAllocator::Stats before = EventAllocator::GetStats ();
+  Simulator::Schedule (MicroSeconds (1), &EventAllocatorTestCase::Reschedule, this, 1000);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  EventAllocator::Stats after = EventAllocator::GetStats ();
+
+  NS_TEST_EXPECT_MSG_EQ (after.allocations - before.allocations,
+                         after.deallocations - before.deallocations,
+                         "All the events should have been released");
+  // only the first events of the chain may need fresh storage.
+  NS_TEST_EXPECT_MSG_GT (after.recycled - before.recycled, 990,
+                         "Event storage was not recycled");
+  NS_TEST_EXPECT_MSG_EQ (after.large, before.large,
+                         "Small events should not bypass the slabs");
+
+  void *p = EventAllocator::Allocate (EventAllocator::kMaxSize + 1);
+  EventAllocator::Deallocate (p, EventAllocator::kMaxSize + 1);
+  NS_TEST_EXPECT_MSG_EQ (EventAllocator::GetStats ().large, before.large + 1,
+                         "Large blocks should bypass the slabs");
+}
+
+class CancelledEventsTestCase : public TestCase
+{
+public:
+  CancelledEventsTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  void Event (uint32_t i);
+  ObjectFactory m_schedulerFactory;
+  std::vector<bool> m_cancelled;
+  uint32_t m_ran;
+  Time m_last;
+};
+
+CancelledEventsTestCase::CancelledEventsTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check that cancelled events are counted and dropped with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{
+}
+
+void
+CancelledEventsTestCase::Event (uint32_t i)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_cancelled[i], false, "cancelled event " << i << " ran");
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (Simulator::Now (), m_last, "event " << i << " ran out of order");
+  m_last = Simulator::Now ();
+  m_ran++;
+}
+
+void
+CancelledEventsTestCase::DoRun (void)
+{
+  Simulator::SetScheduler (m_schedulerFactory);
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (1);
+  m_ran = 0;
+  m_last = Seconds (0);
+
+  std::vector<EventId> ids;
+  for (uint32_t i = 0; i < 4000; i++)
+    {
+      ids.push_back (Simulator::Schedule (MicroSeconds (rng->GetInteger (0, 100000)),
+                                          &CancelledEventsTestCase::Event, this, i));
+      m_cancelled.push_back (false);
+    }
+  NS_TEST_ASSERT_MSG_EQ (Simulator::GetEventCount (), 4000, "wrong number of live events");
+
+  // cancel three events out of four: the first 2001 exceed half of
+  // the queue, which drops them
+  uint32_t cancelled = 0;
+  for (uint32_t i = 0; i < 4000; i++)
+    {
+      if (i % 4 == 0)
+        {
+          continue;
+        }
+      ids[i].Cancel ();
+      ids[i].Cancel ();
+      m_cancelled[i] = true;
+      cancelled++;
+      if (cancelled == 2000)
+        {
+          NS_TEST_ASSERT_MSG_EQ (Simulator::GetCancelledEventCount (), 2000, "wrong number of dead events");
+          NS_TEST_ASSERT_MSG_EQ (Simulator::GetEventCount (), 2000, "wrong number of live events");
+        }
+      if (cancelled == 2001)
+        {
+          NS_TEST_ASSERT_MSG_EQ (Simulator::GetCancelledEventCount (), 0, "dead events were not dropped");
+          NS_TEST_ASSERT_MSG_EQ (Simulator::GetEventCount (), 1999, "wrong number of live events");
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (Simulator::GetCancelledEventCount (), 999, "wrong number of dead events");
+  NS_TEST_ASSERT_MSG_EQ (Simulator::GetEventCount (), 1000, "wrong number of live events");
+  NS_TEST_ASSERT_MSG_EQ (ids[1].IsExpired (), true, "a dropped event is not expired");
+  NS_TEST_ASSERT_MSG_EQ (ids[0].IsExpired (), false, "a live event is expired");
+
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_ran, 1000, "wrong number of events ran");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetCancelledEventCount (), 0, "dead events left");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetEventCount (), 0, "live events left");
+  Simulator::Destroy ();
+}
+
 class SimulatorTestSuite : public TestSuite
 {
 public:
@@ -475,5 +691,14 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new CancelledEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    AddTestCase (new CancelledEventsTestCase (factory), TestCase::QUICK);
+    factory.Set ("BucketThreshold", UintegerValue (4));
+    factory.Set ("MaxRungs", UintegerValue (3));
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    AddTestCase (new EventAllocatorTestCase (), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
@@ -21,6 +21,8 @@
 #include "ns3/test.h"
 #include "ns3/simulator.h"
 #include "ns3/nstime.h"
+#include <map>
+#include <vector>
 
 namespace {
 void bari (int)
@@ -208,6 +210,220 @@ TimerTemplateTestCase::DoTeardown (void)
   Simulator::Destroy ();
 }
 
+class TimerWheelTestCase : public TestCase
+{
+public:
+  TimerWheelTestCase ();
+  virtual void DoRun (void);
+  void Arm (uint32_t i, Time delay);
+  void Expire (uint32_t i);
+  std::vector<Timer *> m_timers;
+  std::vector<Time> m_expected;
+  uint32_t m_armed;
+  uint32_t m_replaced;
+  uint32_t m_expired;
+};
+
+TimerWheelTestCase::TimerWheelTestCase ()
+  : TestCase ("Check that timers expire on time and in context across the wheel")
+{
+}
+
+void
+TimerWheelTestCase::Arm (uint32_t i, Time delay)
+{
+  if (m_timers[i]->IsRunning ())
+    {
+      m_replaced++;
+      m_timers[i]->Cancel ();
+    }
+  m_armed++;
+  m_timers[i]->Schedule (delay);
+  m_expected[i] = Simulator::Now () + delay;
+  NS_TEST_EXPECT_MSG_EQ (m_timers[i]->GetDelayLeft (), delay, "wrong delay left");
+}
+
+void
+TimerWheelTestCase::Expire (uint32_t i)
+{
+  m_expired++;
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), m_expected[i], "timer " << i << " expired at the wrong time");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetContext (), i, "timer " << i << " expired in the wrong context");
+  NS_TEST_EXPECT_MSG_EQ (m_timers[i]->IsExpired (), true, "timer " << i << " still running");
+}
+
+void
+TimerWheelTestCase::DoRun (void)
+{
+  m_armed = 0;
+  m_replaced = 0;
+  m_expired = 0;
+  // delays from a few nanoseconds to hours, past the last level
+  uint32_t seed = 42;
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      m_timers.push_back (new Timer (Timer::CANCEL_ON_DESTROY));
+      m_timers[i]->SetFunction (&TimerWheelTestCase::Expire, this);
+      m_timers[i]->SetArguments (i);
+      m_expected.push_back (Seconds (0));
+    }
+  for (uint32_t j = 0; j < 1000; j++)
+    {
+      seed = seed * 1103515245 + 12345;
+      uint32_t i = (seed >> 8) % 100;
+      seed = seed * 1103515245 + 12345;
+      Time delay = NanoSeconds ((seed >> 8) % 1000);
+      for (uint32_t k = (seed >> 4) % 14; k > 0; k--)
+        {
+          delay = delay * 10;
+        }
+      seed = seed * 1103515245 + 12345;
+      Time at = j < 100 ? Seconds (0) : MicroSeconds ((seed >> 8) % 10000) * ((seed >> 4) % 4096);
+      Simulator::ScheduleWithContext (i, at, &TimerWheelTestCase::Arm, this, i, delay);
+    }
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_armed, 1000, "timers not armed");
+  NS_TEST_ASSERT_MSG_EQ (m_expired, m_armed - m_replaced, "wrong number of expiries");
+  for (uint32_t i = 0; i < m_timers.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_timers[i]->IsExpired (), true, "timer " << i << " still running");
+      delete m_timers[i];
+    }
+  Simulator::Destroy ();
+}
+
+class TimerCompactionTestCase : public TestCase
+{
+public:
+  TimerCompactionTestCase ();
+  virtual void DoRun (void);
+  void Expire (uint32_t i);
+  std::vector<Timer *> m_timers;
+  std::vector<bool> m_cancelled;
+  uint32_t m_expired;
+};
+
+TimerCompactionTestCase::TimerCompactionTestCase ()
+  : TestCase ("Check that cancelled timers are counted and dropped with the cancelled events")
+{
+}
+
+void
+TimerCompactionTestCase::Expire (uint32_t i)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_cancelled[i], false, "cancelled timer " << i << " expired");
+  m_expired++;
+}
+
+void
+TimerCompactionTestCase::DoRun (void)
+{
+  m_expired = 0;
+  // due within the current tick, each timer has its expiry event
+  for (uint32_t i = 0; i < 3000; i++)
+    {
+      m_timers.push_back (new Timer (Timer::CANCEL_ON_DESTROY));
+      m_timers[i]->SetFunction (&TimerCompactionTestCase::Expire, this);
+      m_timers[i]->SetArguments (i);
+      m_timers[i]->Schedule (NanoSeconds (1 + i));
+      m_cancelled.push_back (false);
+    }
+  NS_TEST_ASSERT_MSG_EQ (Simulator::GetEventCount (), 3000, "wrong number of live events");
+
+  // cancel five timers out of six: the first 1501 exceed half of the
+  // queue, which drops them
+  uint32_t cancelled = 0;
+  for (uint32_t i = 0; i < 3000; i++)
+    {
+      if (i % 6 == 0)
+        {
+          continue;
+        }
+      m_timers[i]->Cancel ();
+      m_timers[i]->Cancel ();
+      m_cancelled[i] = true;
+      cancelled++;
+      if (cancelled == 1500)
+        {
+          NS_TEST_ASSERT_MSG_EQ (Simulator::GetCancelledEventCount (), 1500, "wrong number of dead events");
+          NS_TEST_ASSERT_MSG_EQ (Simulator::GetEventCount (), 1500, "wrong number of live events");
+        }
+      if (cancelled == 1501)
+        {
+          NS_TEST_ASSERT_MSG_EQ (Simulator::GetCancelledEventCount (), 0, "dead events were not dropped");
+          NS_TEST_ASSERT_MSG_EQ (Simulator::GetEventCount (), 1499, "wrong number of live events");
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (Simulator::GetCancelledEventCount (), 999, "wrong number of dead events");
+  NS_TEST_ASSERT_MSG_EQ (Simulator::GetEventCount (), 500, "wrong number of live events");
+
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_expired, 500, "wrong number of expiries");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetCancelledEventCount (), 0, "dead events left");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetEventCount (), 0, "live events left");
+  for (uint32_t i = 0; i < m_timers.size (); i++)
+    {
+      delete m_timers[i];
+    }
+  Simulator::Destroy ();
+}
+
+class TimerCopyTestCase : public TestCase
+{
+public:
+  TimerCopyTestCase ();
+  virtual void DoRun (void);
+  void Expire (uint32_t i);
+  std::vector<uint32_t> m_expired;
+  std::vector<Time> m_expiredTime;
+};
+
+TimerCopyTestCase::TimerCopyTestCase ()
+  : TestCase ("Check that copies of a timer can be scheduled on their own")
+{
+}
+
+void
+TimerCopyTestCase::Expire (uint32_t i)
+{
+  m_expired.push_back (i);
+  m_expiredTime.push_back (Simulator::Now ());
+}
+
+void
+TimerCopyTestCase::DoRun (void)
+{
+  Timer timer (Timer::CANCEL_ON_DESTROY);
+  timer.SetFunction (&TimerCopyTestCase::Expire, this);
+  timer.SetArguments (static_cast<uint32_t> (1));
+  timer.SetDelay (MicroSeconds (10));
+  timer.Schedule ();
+
+  // as a std::map does with the timers of the entries it inserts
+  std::map<uint32_t, Timer> timers;
+  timers.insert (std::make_pair (2, timer));
+  Timer &copy = timers.find (2)->second;
+  NS_TEST_ASSERT_MSG_EQ (copy.IsRunning (), false, "the copy of a running timer is running");
+  NS_TEST_ASSERT_MSG_EQ (copy.GetDelay (), MicroSeconds (10), "the delay was not copied");
+  copy.SetArguments (static_cast<uint32_t> (2));
+  copy.Schedule (MicroSeconds (5));
+
+  Timer assigned (Timer::CANCEL_ON_DESTROY);
+  assigned = timer;
+  assigned.SetArguments (static_cast<uint32_t> (3));
+  assigned.Schedule ();
+  timer.Cancel ();
+  NS_TEST_ASSERT_MSG_EQ (copy.IsRunning (), true, "cancelling a timer cancelled its copy");
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_expired.size (), 2, "wrong number of expiries");
+  NS_TEST_ASSERT_MSG_EQ (m_expired[0], 2, "the copy did not expire with its own arguments");
+  NS_TEST_ASSERT_MSG_EQ (m_expiredTime[0], MicroSeconds (5), "the copy expired at the wrong time");
+  NS_TEST_ASSERT_MSG_EQ (m_expired[1], 3, "the assigned timer did not expire with its own arguments");
+  NS_TEST_ASSERT_MSG_EQ (m_expiredTime[1], MicroSeconds (10), "the assigned timer expired at the wrong time");
+  Simulator::Destroy ();
+}
+
 static class TimerTestSuite : public TestSuite
 {
 public:
@@ -216,5 +432,8 @@ public:
   {
     AddTestCase (new TimerStateTestCase (), TestCase::QUICK);
     AddTestCase (new TimerTemplateTestCase (), TestCase::QUICK);
+    AddTestCase (new TimerWheelTestCase (), TestCase::QUICK);
+    AddTestCase (new TimerCompactionTestCase (), TestCase::QUICK);
+    AddTestCase (new TimerCopyTestCase (), TestCase::QUICK);
   }
 } g_timerTestSuite;
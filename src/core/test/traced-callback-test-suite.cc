@@ -18,6 +18,7 @@
 
 #include "ns3/test.h"
 #include "ns3/traced-callback.h"
+#include "ns3/traced-value.h"
 
 using namespace ns3;
 
@@ -62,6 +63,7 @@ BasicTracedCallbackTestCase::DoRun (void)
   // these methods do is to set corresponding member variables m_one and m_two.
   //
   TracedCallback<uint8_t, double> trace;
+  NS_TEST_ASSERT_MSG_EQ (trace.IsEmpty (), true, "New TracedCallback not empty");
 
   //
   // Connect both callbacks to their respective test methods.  If we hit the 
@@ -70,6 +72,7 @@ BasicTracedCallbackTestCase::DoRun (void)
   //
   trace.ConnectWithoutContext (MakeCallback (&BasicTracedCallbackTestCase::CbOne, this));
   trace.ConnectWithoutContext (MakeCallback (&BasicTracedCallbackTestCase::CbTwo, this));
+  NS_TEST_ASSERT_MSG_EQ (trace.IsEmpty (), false, "Connected TracedCallback is empty");
   m_one = false;
   m_two = false;
   trace (1, 2);
@@ -90,6 +93,7 @@ BasicTracedCallbackTestCase::DoRun (void)
   // If we now disconnect callback two then neither callback should be called.
   //
   trace.DisconnectWithoutContext (MakeCallback (&BasicTracedCallbackTestCase::CbTwo, this));
+  NS_TEST_ASSERT_MSG_EQ (trace.IsEmpty (), true, "Disconnected TracedCallback not empty");
   m_one = false;
   m_two = false;
   trace (1, 2);
@@ -108,6 +112,144 @@ BasicTracedCallbackTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_two, true, "Callback CbTwo not called");
 }
 
+class ReentrantTracedCallbackTestCase : public TestCase
+{
+public:
+  ReentrantTracedCallbackTestCase ();
+  virtual ~ReentrantTracedCallbackTestCase () {}
+
+private:
+  virtual void DoRun (void);
+
+  void CbOne (uint8_t a, double b);
+  void CbTwo (uint8_t a, double b);
+  void CbThree (uint8_t a, double b);
+
+  TracedCallback<uint8_t, double> m_trace;
+  uint32_t m_one;
+  uint32_t m_two;
+  uint32_t m_three;
+};
+
+ReentrantTracedCallbackTestCase::ReentrantTracedCallbackTestCase ()
+  : TestCase ("Check a TracedCallback changed by its own Callbacks")
+{
+}
+
+void
+ReentrantTracedCallbackTestCase::CbOne (uint8_t a, double b)
+{
+  //
+  // Disconnect ourselves and the next callback, and connect a new one.
+  //
+  m_one++;
+  m_trace.DisconnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbOne, this));
+  m_trace.DisconnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbTwo, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbThree, this));
+}
+
+void
+ReentrantTracedCallbackTestCase::CbTwo (uint8_t a, double b)
+{
+  m_two++;
+}
+
+void
+ReentrantTracedCallbackTestCase::CbThree (uint8_t a, double b)
+{
+  //
+  // Disconnect ourselves, and reconnect the first callback.
+  //
+  m_three++;
+  m_trace.DisconnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbThree, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbOne, this));
+}
+
+void
+ReentrantTracedCallbackTestCase::DoRun (void)
+{
+  m_one = 0;
+  m_two = 0;
+  m_three = 0;
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbOne, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbTwo, this));
+
+  //
+  // The changes made by a callback only apply to the next hits of the trace:
+  // the first hit still calls CbTwo, and not CbThree.
+  //
+  m_trace (1, 2);
+  NS_TEST_ASSERT_MSG_EQ (m_one, 1, "Callback CbOne not called once");
+  NS_TEST_ASSERT_MSG_EQ (m_two, 1, "Callback CbTwo not called once");
+  NS_TEST_ASSERT_MSG_EQ (m_three, 0, "Callback CbThree called by the hit which connected it");
+
+  m_trace (1, 2);
+  NS_TEST_ASSERT_MSG_EQ (m_one, 1, "Disconnected callback CbOne called");
+  NS_TEST_ASSERT_MSG_EQ (m_two, 1, "Disconnected callback CbTwo called");
+  NS_TEST_ASSERT_MSG_EQ (m_three, 1, "Callback CbThree not called once");
+
+  m_trace (1, 2);
+  NS_TEST_ASSERT_MSG_EQ (m_one, 2, "Reconnected callback CbOne not called");
+  NS_TEST_ASSERT_MSG_EQ (m_two, 1, "Disconnected callback CbTwo called");
+  NS_TEST_ASSERT_MSG_EQ (m_three, 1, "Disconnected callback CbThree called");
+
+  m_trace.DisconnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbThree, this));
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "Disconnected TracedCallback not empty");
+}
+
+class CompiledOutTraceTestCase : public TestCase
+{
+public:
+  CompiledOutTraceTestCase ();
+  virtual ~CompiledOutTraceTestCase () {}
+
+private:
+  virtual void DoRun (void);
+
+  void CbOne (uint32_t a, uint32_t b);
+
+  bool m_one;
+};
+
+CompiledOutTraceTestCase::CompiledOutTraceTestCase ()
+  : TestCase ("Check compiled out TracedCallback and TracedValue")
+{
+}
+
+void
+CompiledOutTraceTestCase::CbOne (uint32_t a, uint32_t b)
+{
+  m_one = true;
+}
+
+void
+CompiledOutTraceTestCase::DoRun (void)
+{
+  SelectTracedCallback<false, uint32_t, uint32_t>::Type trace;
+  NS_TEST_ASSERT_MSG_EQ (trace.IsEmpty (), true, "NullTracedCallback not empty");
+  trace (1, 2);
+  trace.DisconnectWithoutContext (MakeCallback (&CompiledOutTraceTestCase::CbOne, this));
+
+  //
+  // A compiled out TracedValue keeps its value semantics, and mixes with
+  // a traced one.
+  //
+  TracedValue<uint32_t, false> value = 5;
+  TracedValue<uint32_t> traced = 7;
+  m_one = false;
+  traced.ConnectWithoutContext (MakeCallback (&CompiledOutTraceTestCase::CbOne, this));
+  value += 3;
+  value++;
+  NS_TEST_ASSERT_MSG_EQ (value.Get (), 9, "Wrong compiled out TracedValue");
+  NS_TEST_ASSERT_MSG_EQ ((value - traced).Get (), 2, "Wrong difference of TracedValues");
+  NS_TEST_ASSERT_MSG_EQ ((value > traced), true, "Wrong comparison of TracedValues");
+  traced = value;
+  NS_TEST_ASSERT_MSG_EQ (m_one, true, "Traced value not traced");
+  NS_TEST_ASSERT_MSG_EQ (traced.Get (), 9, "Wrong assignment of TracedValues");
+  uint32_t raw = value;
+  NS_TEST_ASSERT_MSG_EQ (raw, 9, "Wrong conversion of compiled out TracedValue");
+}
+
 class TracedCallbackTestSuite : public TestSuite
 {
 public:
@@ -118,6 +260,8 @@ TracedCallbackTestSuite::TracedCallbackTestSuite ()
   : TestSuite ("traced-callback", UNIT)
 {
   AddTestCase (new BasicTracedCallbackTestCase, TestCase::QUICK);
+  AddTestCase (new ReentrantTracedCallbackTestCase, TestCase::QUICK);
+  AddTestCase (new CompiledOutTraceTestCase, TestCase::QUICK);
 }
 
 static TracedCallbackTestSuite tracedCallbackTestSuite;
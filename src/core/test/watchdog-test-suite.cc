@@ -29,6 +29,7 @@ public:
   virtual void DoRun (void);
   void Expire (Time expected);
   bool m_expired;
+  uint32_t m_expiries;
   Time m_expiredTime;
   Time m_expiredArgument;
 };
@@ -42,6 +43,7 @@ void
 WatchdogTestCase::Expire (Time expected)
 {
   m_expired = true;
+  m_expiries++;
   m_expiredTime = Simulator::Now ();
   m_expiredArgument = expected;
 }
@@ -50,11 +52,16 @@ void
 WatchdogTestCase::DoRun (void)
 {
   m_expired = false;
+  m_expiries = 0;
   m_expiredArgument = Seconds (0);
   m_expiredTime = Seconds (0);
   Watchdog watchdog;
   watchdog.SetFunction (&WatchdogTestCase::Expire, this);
   watchdog.SetArguments (MicroSeconds (40));
+  // a copy has the function and the arguments, and is armed on its own
+  Watchdog copy (watchdog);
+  copy.SetArguments (MicroSeconds (3));
+  copy.Ping (MicroSeconds (3));
   watchdog.Ping (MicroSeconds (10));
   Simulator::Schedule (MicroSeconds (5), &Watchdog::Ping, &watchdog, MicroSeconds (20));
   Simulator::Schedule (MicroSeconds (20), &Watchdog::Ping, &watchdog, MicroSeconds (2));
@@ -62,6 +69,7 @@ WatchdogTestCase::DoRun (void)
   Simulator::Run ();
   Simulator::Destroy ();
   NS_TEST_ASSERT_MSG_EQ (m_expired, true, "The timer did not expire ??");
+  NS_TEST_ASSERT_MSG_EQ (m_expiries, 2, "The copy did not expire on its own");
   NS_TEST_ASSERT_MSG_EQ (m_expiredTime, MicroSeconds (40), "The timer did not expire at the expected time ?");
   NS_TEST_ASSERT_MSG_EQ (m_expiredArgument, MicroSeconds (40), "We did not get the right argument");
 }
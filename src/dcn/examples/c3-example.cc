@@ -10,6 +10,7 @@ using namespace ns3;
 NS_LOG_COMPONENT_DEFINE ("C3Example");
 
 const uint32_t flowSize = 100000;
+const Time start = Seconds (2.0);
 const Time deadline = Seconds (5.0);
 const int port = 9;
 
@@ -31,7 +32,8 @@ ReceiveTracer (Ptr<const Packet> packet,const Address &from)
   static int totalReceive = 0;
   dcn::C3Tag c3Tag;
   NS_ASSERT(packet->FindFirstMatchingByteTag (c3Tag));
-  if (c3Tag.GetDeadline () <= Simulator::Now ())
+  // the deadline is relative to the start of the flow
+  if (Simulator::Now () <= start + c3Tag.GetDeadline ())
     {
       totalReceive += packet->GetSize ();
       NS_LOG_INFO ("At " << Simulator::Now () << " receive " << totalReceive <<"/" << c3Tag.GetFlowSize ());
@@ -84,7 +86,7 @@ main (int argc, char *argv[])
   sender.SetAttribute ("MaxBytes", UintegerValue (flowSize));
   ApplicationContainer senderApps = sender.Install (nodes.Get (0));
   senderApps.Get (0)->TraceConnectWithoutContext ("Tx", MakeCallback (&SendTracer));
-  senderApps.Start (Seconds (2.0));
+  senderApps.Start (start);
   senderApps.Stop (Seconds (50.0));
 
   PacketSinkHelper receiver ("ns3::TcpSocketFactory", receiverAddress);
@@ -0,0 +1,79 @@
+#include "addcn-flow.h"
+
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ADDCNFlow");
+
+namespace dcn {
+
+NS_OBJECT_ENSURE_REGISTERED (ADDCNFlow);
+
+TypeId
+ADDCNFlow::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::dcn::ADDCNFlow")
+      .SetParent<C3DsFlow> ()
+      .SetGroupName ("DCN")
+      .AddConstructor<ADDCNFlow> ()
+  ;
+  return tid;
+}
+
+ADDCNFlow::ADDCNFlow ()
+  : m_protocol (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ADDCNFlow::~ADDCNFlow ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+ADDCNFlow::SetFlowInfo (Ipv4Address source, Ipv4Address destination,
+                        uint8_t protocol, const C3Tag &tag)
+{
+  NS_LOG_FUNCTION (this << source << destination << (int)protocol);
+  m_source = source;
+  m_destination = destination;
+  m_protocol = protocol;
+  C3DsFlow::SetFlowInfo (tag.GetFlowSize (), tag.GetDeadline ());
+  if (tag.GetSegmentSize () > 0)
+    {
+      SetAttribute ("Bucket", UintegerValue (2 * 8 * tag.GetSegmentSize ()));
+    }
+  NS_LOG_INFO ("New flow from " << source << " to " << destination << " of "
+               << tag.GetFlowSize () << " bytes with deadline " << GetDeadline ());
+}
+
+void
+ADDCNFlow::Send (Ptr<Packet> p, Ptr<Ipv4Route> route)
+{
+  NS_LOG_FUNCTION (this << p << route);
+  C3DsFlow::Send (p, m_source, m_destination, m_protocol, route);
+}
+
+Ipv4Address
+ADDCNFlow::GetSource (void) const
+{
+  return m_source;
+}
+
+Ipv4Address
+ADDCNFlow::GetDestination (void) const
+{
+  return m_destination;
+}
+
+uint8_t
+ADDCNFlow::GetProtocol (void) const
+{
+  return m_protocol;
+}
+
+} //namespace dcn
+} //namespace ns3
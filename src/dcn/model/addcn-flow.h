@@ -0,0 +1,78 @@
+#ifndef ADDCN_FLOW_H
+#define ADDCN_FLOW_H
+
+#include <stdint.h>
+
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/packet.h"
+
+#include "c3-ds-flow.h"
+#include "c3-tag.h"
+
+namespace ns3 {
+namespace dcn {
+
+/**
+ * \ingroup dcn
+ *
+ * \brief the traffic of a tenant from a source to a destination with an
+ * L4 protocol
+ *
+ * The flow is shaped as a C3DsFlow, at the rate the slice of the tenant
+ * allocates to it, and is known by its addresses and protocol.  The bucket
+ * holds two segments, or two packets of 1500 bytes if the segment size is
+ * unknown.
+ */
+class ADDCNFlow : public C3DsFlow
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  ADDCNFlow ();
+  virtual ~ADDCNFlow ();
+
+  /**
+   * \brief Set the addresses of the flow, which starts now
+   * \param source the source address
+   * \param destination the destination address
+   * \param protocol the L4 protocol number
+   * \param tag the C3 information of the first packet
+   */
+  void SetFlowInfo (Ipv4Address source, Ipv4Address destination,
+                    uint8_t protocol, const C3Tag &tag);
+
+  /**
+   * \brief Shape a packet of the flow
+   * \param p the packet
+   * \param route the route of the packet
+   */
+  void Send (Ptr<Packet> p, Ptr<Ipv4Route> route);
+
+  /**
+   * \return the source address
+   */
+  Ipv4Address GetSource (void) const;
+  /**
+   * \return the destination address
+   */
+  Ipv4Address GetDestination (void) const;
+  /**
+   * \return the L4 protocol number
+   */
+  uint8_t GetProtocol (void) const;
+
+private:
+  Ipv4Address m_source;              //!< source address
+  Ipv4Address m_destination;         //!< destination address
+  uint8_t m_protocol;                //!< L4 protocol number
+};
+
+} //namespace dcn
+} //namespace ns3
+
+#endif // ADDCN_FLOW_H
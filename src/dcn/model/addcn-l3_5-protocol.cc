@@ -0,0 +1,286 @@
+#include "addcn-l3_5-protocol.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include "c3-tag.h"
+#include "c3-division.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ADDCNL3_5Protocol");
+
+namespace dcn {
+
+NS_OBJECT_ENSURE_REGISTERED (ADDCNL3_5Protocol);
+
+TypeId
+ADDCNL3_5Protocol::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::dcn::ADDCNL3_5Protocol")
+      .SetParent<IpL3_5Protocol> ()
+      .SetGroupName ("DCN")
+      .AddConstructor<ADDCNL3_5Protocol> ()
+      .AddAttribute ("DataRate",
+                     "The rate shared by the tenants of the host",
+                     DataRateValue (DataRate ("1Gbps")),
+                     MakeDataRateAccessor (&ADDCNL3_5Protocol::m_rate),
+                     MakeDataRateChecker ())
+      .AddAttribute ("ControlInterval",
+                     "The interval between two allocations of the rates",
+                     TimeValue (MicroSeconds (500)),
+                     MakeTimeAccessor (&ADDCNL3_5Protocol::m_interval),
+                     MakeTimeChecker ())
+      .AddAttribute ("FlowTimeout",
+                     "The idle time after which a flow is over",
+                     TimeValue (MilliSeconds (10)),
+                     MakeTimeAccessor (&ADDCNL3_5Protocol::m_flowTimeout),
+                     MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+ADDCNL3_5Protocol::ADDCNL3_5Protocol ()
+  : m_table (16),
+    m_nFlows (0),
+    m_nUsed (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ADDCNL3_5Protocol::~ADDCNL3_5Protocol ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+ADDCNL3_5Protocol::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_updateEvent.Cancel ();
+  for (std::vector<Slot>::iterator it = m_table.begin (); it != m_table.end (); ++it)
+    {
+      if (it->state == SLOT_FULL)
+        {
+          it->flow->Dispose ();
+        }
+    }
+  m_table.clear ();
+  m_nFlows = 0;
+  m_nUsed = 0;
+  for (SliceMap_t::iterator it = m_slices.begin (); it != m_slices.end (); ++it)
+    {
+      it->second->Dispose ();
+    }
+  m_slices.clear ();
+  IpL3_5Protocol::DoDispose ();
+}
+
+uint32_t
+ADDCNL3_5Protocol::Hash (uint64_t addresses, uint8_t protocol) const
+{
+  // the finalizer of MurmurHash3
+  uint64_t h = addresses ^ (protocol * 0x9e3779b97f4a7c15ULL);
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  return static_cast<uint32_t> (h) & (m_table.size () - 1);
+}
+
+uint32_t
+ADDCNL3_5Protocol::Find (uint64_t addresses, uint8_t protocol) const
+{
+  uint32_t mask = m_table.size () - 1;
+  for (uint32_t i = Hash (addresses, protocol); ; i = (i + 1) & mask)
+    {
+      const Slot &slot = m_table[i];
+      if (slot.state == SLOT_EMPTY)
+        {
+          return m_table.size ();
+        }
+      if (slot.state == SLOT_FULL && slot.addresses == addresses && slot.protocol == protocol)
+        {
+          return i;
+        }
+    }
+}
+
+void
+ADDCNL3_5Protocol::Insert (Ptr<ADDCNFlow> flow)
+{
+  NS_LOG_FUNCTION (this << flow);
+  // keep at least half of the slots empty
+  if ((m_nUsed + 1) * 2 > m_table.size ())
+    {
+      Rehash ((m_nFlows + 1) * 4 > m_table.size () ? m_table.size () * 2 : m_table.size ());
+    }
+  uint64_t addresses = (static_cast<uint64_t> (flow->GetSource ().Get ()) << 32) | flow->GetDestination ().Get ();
+  uint32_t mask = m_table.size () - 1;
+  uint32_t i = Hash (addresses, flow->GetProtocol ());
+  while (m_table[i].state == SLOT_FULL)
+    {
+      i = (i + 1) & mask;
+    }
+  if (m_table[i].state == SLOT_EMPTY)
+    {
+      ++m_nUsed;
+    }
+  m_table[i].addresses = addresses;
+  m_table[i].protocol = flow->GetProtocol ();
+  m_table[i].state = SLOT_FULL;
+  m_table[i].flow = flow;
+  ++m_nFlows;
+}
+
+void
+ADDCNL3_5Protocol::Erase (Ptr<ADDCNFlow> flow)
+{
+  NS_LOG_FUNCTION (this << flow);
+  uint64_t addresses = (static_cast<uint64_t> (flow->GetSource ().Get ()) << 32) | flow->GetDestination ().Get ();
+  uint32_t i = Find (addresses, flow->GetProtocol ());
+  NS_ASSERT (i < m_table.size ());
+  m_table[i].state = SLOT_DELETED;
+  m_table[i].flow = 0;
+  --m_nFlows;
+}
+
+void
+ADDCNL3_5Protocol::Rehash (uint32_t capacity)
+{
+  NS_LOG_FUNCTION (this << capacity);
+  std::vector<Slot> table (capacity);
+  m_table.swap (table);
+  m_nFlows = 0;
+  m_nUsed = 0;
+  for (std::vector<Slot>::iterator it = table.begin (); it != table.end (); ++it)
+    {
+      if (it->state == SLOT_FULL)
+        {
+          Insert (it->flow);
+        }
+    }
+}
+
+void
+ADDCNL3_5Protocol::Send (Ptr<Packet> packet, Ipv4Address source,
+                         Ipv4Address destination, uint8_t protocol, Ptr<Ipv4Route> route)
+{
+  NS_LOG_FUNCTION (this << packet << source << destination << (int)protocol << route);
+  C3Tag tag;
+  if (!packet->PeekPacketTag (tag) && !packet->FindFirstMatchingByteTag (tag))
+    {
+      ForwardDown (packet, source, destination, protocol, route);
+      return;
+    }
+
+  uint64_t addresses = (static_cast<uint64_t> (source.Get ()) << 32) | destination.Get ();
+  uint32_t i = Find (addresses, protocol);
+  Ptr<ADDCNFlow> flow;
+  if (i < m_table.size ())
+    {
+      flow = m_table[i].flow;
+    }
+  else
+    {
+      Ptr<ADDCNSlice> &slice = m_slices[tag.GetDivisionId ()];
+      if (slice == 0)
+        {
+          slice = CreateObject<ADDCNSlice> ();
+          NS_LOG_INFO ("New slice " << tag.GetDivisionId ());
+        }
+      flow = CreateObject<ADDCNFlow> ();
+      flow->SetFlowInfo (source, destination, protocol, tag);
+      flow->SetDownTarget (GetDownTarget ());
+      slice->AddFlow (flow);
+      Insert (flow);
+      if (!m_updateEvent.IsRunning ())
+        {
+          m_updateEvent = Simulator::Schedule (m_interval, &ADDCNL3_5Protocol::Update, this);
+        }
+    }
+  flow->Send (packet, route);
+}
+
+void
+ADDCNL3_5Protocol::Send6 (Ptr<Packet> packet, Ipv6Address source,
+                          Ipv6Address destination, uint8_t protocol, Ptr<Ipv6Route> route)
+{
+  NS_LOG_FUNCTION (this << packet << source << destination << (int)protocol << route);
+  ForwardDown6 (packet, source, destination, protocol, route);
+}
+
+IpL4Protocol::RxStatus
+ADDCNL3_5Protocol::Receive (Ptr<Packet> p,
+                            Ipv4Header const &header,
+                            Ptr<Ipv4Interface> incomingInterface)
+{
+  NS_LOG_FUNCTION (this << p << header << incomingInterface);
+  return ForwardUp (p, header, incomingInterface, header.GetProtocol ());
+}
+
+IpL4Protocol::RxStatus
+ADDCNL3_5Protocol::Receive (Ptr<Packet> p,
+                            Ipv6Header const &header,
+                            Ptr<Ipv6Interface> incomingInterface)
+{
+  NS_LOG_FUNCTION (this << p << header << incomingInterface);
+  return ForwardUp6 (p, header, incomingInterface, header.GetNextHeader ());
+}
+
+uint32_t
+ADDCNL3_5Protocol::GetNFlows (void) const
+{
+  return m_nFlows;
+}
+
+Ptr<ADDCNFlow>
+ADDCNL3_5Protocol::GetFlow (Ipv4Address source, Ipv4Address destination, uint8_t protocol) const
+{
+  uint64_t addresses = (static_cast<uint64_t> (source.Get ()) << 32) | destination.Get ();
+  uint32_t i = Find (addresses, protocol);
+  return i < m_table.size () ? m_table[i].flow : 0;
+}
+
+void
+ADDCNL3_5Protocol::Update (void)
+{
+  NS_LOG_FUNCTION (this);
+  std::vector<double> demands;
+  std::vector<Ptr<ADDCNFlow> > over;
+  for (SliceMap_t::iterator it = m_slices.begin (); it != m_slices.end (); )
+    {
+      double demand = it->second->Update (m_flowTimeout, over);
+      if (it->second->GetNFlows () == 0)
+        {
+          it->second->Dispose ();
+          m_slices.erase (it++);
+        }
+      else
+        {
+          demands.push_back (demand);
+          ++it;
+        }
+    }
+  for (std::vector<Ptr<ADDCNFlow> >::iterator it = over.begin (); it != over.end (); ++it)
+    {
+      Erase (*it);
+      (*it)->Dispose ();
+    }
+  if (m_slices.empty ())
+    {
+      NS_LOG_INFO ("No flow left");
+      return;
+    }
+
+  std::vector<double> rates;
+  C3Division::Allocate (m_rate.GetBitRate (), demands, std::vector<double> (), rates);
+  uint32_t i = 0;
+  for (SliceMap_t::iterator it = m_slices.begin (); it != m_slices.end (); ++it, ++i)
+    {
+      it->second->SetRate (rates[i]);
+    }
+  m_updateEvent = Simulator::Schedule (m_interval, &ADDCNL3_5Protocol::Update, this);
+}
+
+} //namespace dcn
+} //namespace ns3
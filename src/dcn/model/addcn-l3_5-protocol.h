@@ -0,0 +1,143 @@
+#ifndef ADDCN_L3_5_PROTOCOL_H
+#define ADDCN_L3_5_PROTOCOL_H
+
+#include <stdint.h>
+#include <map>
+#include <vector>
+
+#include "ns3/data-rate.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+
+#include "ip-l3_5-protocol.h"
+#include "addcn-slice.h"
+#include "addcn-flow.h"
+
+namespace ns3 {
+namespace dcn {
+
+/**
+ * \ingroup dcn
+ *
+ * \brief ADDCN: a per-tenant rate control between L4 and IP
+ *
+ * The packets tagged with a C3Tag are shaped per (source, destination,
+ * L4 protocol) flow, which belongs to the slice of the division (tenant)
+ * of its first packet.  The rate of the host is shared between the
+ * slices, and the rate of a slice between its flows, once per control
+ * interval.
+ *
+ * The flows are found in a flat open-addressing hash table, so that a
+ * lookup costs one probe or two with tens of thousands of flows.
+ */
+class ADDCNL3_5Protocol : public IpL3_5Protocol
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  ADDCNL3_5Protocol ();
+  virtual ~ADDCNL3_5Protocol ();
+
+  // inherited from IpL3_5Protocol
+  virtual void Send (Ptr<Packet> packet, Ipv4Address source,
+                     Ipv4Address destination, uint8_t protocol, Ptr<Ipv4Route> route);
+  virtual void Send6 (Ptr<Packet> packet, Ipv6Address source,
+                      Ipv6Address destination, uint8_t protocol, Ptr<Ipv6Route> route);
+
+  // inherited from IpL4Protocol
+  virtual enum IpL4Protocol::RxStatus Receive (Ptr<Packet> p,
+                                               Ipv4Header const &header,
+                                               Ptr<Ipv4Interface> incomingInterface);
+  virtual enum IpL4Protocol::RxStatus Receive (Ptr<Packet> p,
+                                               Ipv6Header const &header,
+                                               Ptr<Ipv6Interface> incomingInterface);
+
+  /**
+   * \return the number of flows being shaped
+   */
+  uint32_t GetNFlows (void) const;
+
+  /**
+   * \param source the source address
+   * \param destination the destination address
+   * \param protocol the L4 protocol number
+   * \return the flow, or 0 if there is none
+   */
+  Ptr<ADDCNFlow> GetFlow (Ipv4Address source, Ipv4Address destination, uint8_t protocol) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief Remove the flows over and share the rate of the host
+   */
+  void Update (void);
+
+  /// states of a slot
+  enum
+  {
+    SLOT_EMPTY,
+    SLOT_FULL,
+    SLOT_DELETED
+  };
+
+  /**
+   * \brief A slot of the flow table
+   */
+  struct Slot
+  {
+    Slot () : addresses (0), protocol (0), state (SLOT_EMPTY) {}
+
+    uint64_t addresses;   //!< source and destination addresses
+    uint8_t protocol;     //!< L4 protocol number
+    uint8_t state;        //!< SLOT_EMPTY, SLOT_FULL or SLOT_DELETED
+    Ptr<ADDCNFlow> flow;  //!< the flow
+  };
+
+  /**
+   * \param addresses the source and destination addresses
+   * \param protocol the L4 protocol number
+   * \return the first slot to probe
+   */
+  uint32_t Hash (uint64_t addresses, uint8_t protocol) const;
+  /**
+   * \param addresses the source and destination addresses
+   * \param protocol the L4 protocol number
+   * \return the slot of the flow, or the size of the table if there is none
+   */
+  uint32_t Find (uint64_t addresses, uint8_t protocol) const;
+  /**
+   * \param flow the flow to add to the table
+   */
+  void Insert (Ptr<ADDCNFlow> flow);
+  /**
+   * \param flow the flow to remove from the table
+   */
+  void Erase (Ptr<ADDCNFlow> flow);
+  /**
+   * \param capacity the new number of slots, a power of two
+   */
+  void Rehash (uint32_t capacity);
+
+  /// the slices by division
+  typedef std::map<uint32_t, Ptr<ADDCNSlice> > SliceMap_t;
+
+  DataRate m_rate;             //!< rate of the host
+  Time m_interval;             //!< control interval
+  Time m_flowTimeout;          //!< idle time after which a flow is over
+  SliceMap_t m_slices;         //!< the slices
+  std::vector<Slot> m_table;   //!< the flow table
+  uint32_t m_nFlows;           //!< full slots
+  uint32_t m_nUsed;            //!< full and deleted slots
+  EventId m_updateEvent;       //!< next update of the rates
+};
+
+} //namespace dcn
+} //namespace ns3
+
+#endif // ADDCN_L3_5_PROTOCOL_H
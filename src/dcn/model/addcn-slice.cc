@@ -0,0 +1,98 @@
+#include "addcn-slice.h"
+
+#include "ns3/log.h"
+
+#include "c3-division.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ADDCNSlice");
+
+namespace dcn {
+
+NS_OBJECT_ENSURE_REGISTERED (ADDCNSlice);
+
+TypeId
+ADDCNSlice::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::dcn::ADDCNSlice")
+      .SetParent<Object> ()
+      .SetGroupName ("DCN")
+      .AddConstructor<ADDCNSlice> ()
+  ;
+  return tid;
+}
+
+ADDCNSlice::ADDCNSlice ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ADDCNSlice::~ADDCNSlice ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+ADDCNSlice::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_flows.clear ();
+  Object::DoDispose ();
+}
+
+void
+ADDCNSlice::AddFlow (Ptr<ADDCNFlow> flow)
+{
+  NS_LOG_FUNCTION (this << flow);
+  m_flows.push_back (flow);
+}
+
+double
+ADDCNSlice::Update (Time timeout, std::vector<Ptr<ADDCNFlow> > &over)
+{
+  NS_LOG_FUNCTION (this << timeout);
+  double demand = 0;
+  m_demands.clear ();
+  for (uint32_t i = 0; i < m_flows.size (); )
+    {
+      if (m_flows[i]->IsIdle (timeout))
+        {
+          NS_LOG_INFO ("Flow from " << m_flows[i]->GetSource () << " to "
+                       << m_flows[i]->GetDestination () << " is over");
+          over.push_back (m_flows[i]);
+          m_flows[i] = m_flows.back ();
+          m_flows.pop_back ();
+        }
+      else
+        {
+          m_demands.push_back (m_flows[i]->GetDemand ());
+          demand += m_demands.back ();
+          ++i;
+        }
+    }
+  return demand;
+}
+
+void
+ADDCNSlice::SetRate (double rate)
+{
+  NS_LOG_FUNCTION (this << rate);
+  NS_ASSERT (m_demands.size () == m_flows.size ());
+  std::vector<double> rates;
+  C3Division::Allocate (rate, m_demands, std::vector<double> (), rates);
+  for (uint32_t i = 0; i < m_flows.size (); ++i)
+    {
+      m_flows[i]->SetRate (DataRate (static_cast<uint64_t> (rates[i])));
+    }
+  NS_LOG_INFO ("Rate " << rate << "bps for " << m_flows.size () << " flows");
+}
+
+uint32_t
+ADDCNSlice::GetNFlows (void) const
+{
+  return m_flows.size ();
+}
+
+} //namespace dcn
+} //namespace ns3
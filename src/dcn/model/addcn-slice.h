@@ -0,0 +1,70 @@
+#ifndef ADDCN_SLICE_H
+#define ADDCN_SLICE_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+
+#include "addcn-flow.h"
+
+namespace ns3 {
+namespace dcn {
+
+/**
+ * \ingroup dcn
+ *
+ * \brief the flows of a tenant on a host
+ *
+ * The rate of the slice is shared between its flows max-min fairly up to
+ * their deadline demand, and the spare rate equally.
+ */
+class ADDCNSlice : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  ADDCNSlice ();
+  virtual ~ADDCNSlice ();
+
+  /**
+   * \param flow a new flow of the slice
+   */
+  void AddFlow (Ptr<ADDCNFlow> flow);
+
+  /**
+   * \brief Remove the idle flows and compute the demand of the slice
+   * \param timeout the idle time after which a flow is over
+   * \param over the flows removed
+   * \return the rate the slice needs to meet its deadlines in bps
+   */
+  double Update (Time timeout, std::vector<Ptr<ADDCNFlow> > &over);
+
+  /**
+   * \brief Allocate the rate of the slice to its flows
+   * \param rate the rate of the slice in bps
+   */
+  void SetRate (double rate);
+
+  /**
+   * \return the number of flows in the slice
+   */
+  uint32_t GetNFlows (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  std::vector<Ptr<ADDCNFlow> > m_flows; //!< the flows
+  std::vector<double> m_demands;        //!< demands of the flows at the last update
+};
+
+} //namespace dcn
+} //namespace ns3
+
+#endif // ADDCN_SLICE_H
@@ -0,0 +1,161 @@
+#include "c3-division.h"
+
+#include <algorithm>
+
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("C3Division");
+
+namespace dcn {
+
+NS_OBJECT_ENSURE_REGISTERED (C3Division);
+
+TypeId
+C3Division::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::dcn::C3Division")
+      .SetParent<Object> ()
+      .SetGroupName ("DCN")
+      .AddConstructor<C3Division> ()
+  ;
+  return tid;
+}
+
+C3Division::C3Division ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+C3Division::~C3Division ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+C3Division::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (TunnelMap_t::iterator it = m_tunnels.begin (); it != m_tunnels.end (); ++it)
+    {
+      it->second->Dispose ();
+    }
+  m_tunnels.clear ();
+  m_downTarget.Nullify ();
+  Object::DoDispose ();
+}
+
+void
+C3Division::SetDownTarget (IpL4Protocol::DownTargetCallback cb)
+{
+  m_downTarget = cb;
+}
+
+bool
+C3Division::Send (Ptr<Packet> p, uint64_t flowKey, const C3Tag &tag,
+                  Ipv4Address source, Ipv4Address destination,
+                  uint8_t protocol, Ptr<Ipv4Route> route)
+{
+  NS_LOG_FUNCTION (this << p << source << destination);
+  uint64_t key = (static_cast<uint64_t> (source.Get ()) << 32) | destination.Get ();
+  Ptr<C3DsTunnel> &tunnel = m_tunnels[key];
+  if (tunnel == 0)
+    {
+      tunnel = CreateObject<C3DsTunnel> ();
+      tunnel->SetDownTarget (m_downTarget);
+      NS_LOG_INFO ("New tunnel from " << source << " to " << destination);
+    }
+  return tunnel->Send (p, flowKey, tag, source, destination, protocol, route);
+}
+
+double
+C3Division::Update (Time timeout)
+{
+  NS_LOG_FUNCTION (this << timeout);
+  double demand = 0;
+  m_demands.clear ();
+  for (TunnelMap_t::iterator it = m_tunnels.begin (); it != m_tunnels.end (); )
+    {
+      double d = it->second->Update (timeout);
+      if (it->second->GetNFlows () == 0)
+        {
+          it->second->Dispose ();
+          it = m_tunnels.erase (it);
+        }
+      else
+        {
+          m_demands.push_back (d);
+          demand += d;
+          ++it;
+        }
+    }
+  return demand;
+}
+
+void
+C3Division::SetRate (double rate)
+{
+  NS_LOG_FUNCTION (this << rate);
+  NS_ASSERT (m_demands.size () == m_tunnels.size ());
+  std::vector<double> rates;
+  Allocate (rate, m_demands, std::vector<double> (), rates);
+  uint32_t i = 0;
+  for (TunnelMap_t::iterator it = m_tunnels.begin (); it != m_tunnels.end (); ++it, ++i)
+    {
+      it->second->SetRate (rates[i]);
+    }
+  NS_LOG_INFO ("Rate " << rate << "bps for " << m_tunnels.size () << " tunnels");
+}
+
+uint32_t
+C3Division::GetNFlows (void) const
+{
+  uint32_t n = 0;
+  for (TunnelMap_t::const_iterator it = m_tunnels.begin (); it != m_tunnels.end (); ++it)
+    {
+      n += it->second->GetNFlows ();
+    }
+  return n;
+}
+
+void
+C3Division::Allocate (double rate, const std::vector<double> &demands,
+                      const std::vector<double> &weights, std::vector<double> &rates)
+{
+  uint32_t n = demands.size ();
+  rates.assign (n, 0);
+  if (n == 0)
+    {
+      return;
+    }
+
+  // water-filling: the smallest demands are met first
+  std::vector<uint32_t> order (n);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      order[i] = i;
+    }
+  std::sort (order.begin (), order.end (),
+             [&demands] (uint32_t a, uint32_t b) { return demands[a] < demands[b]; });
+  double spare = rate;
+  for (uint32_t k = 0; k < n; ++k)
+    {
+      uint32_t i = order[k];
+      rates[i] = std::min (demands[i], spare / (n - k));
+      spare -= rates[i];
+    }
+
+  double totalWeight = 0;
+  for (uint32_t i = 0; i < weights.size (); ++i)
+    {
+      totalWeight += weights[i];
+    }
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      rates[i] += totalWeight > 0 ? spare * weights[i] / totalWeight : spare / n;
+    }
+}
+
+} //namespace dcn
+} //namespace ns3
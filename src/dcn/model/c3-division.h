@@ -0,0 +1,106 @@
+#ifndef C3_DIVISION_H
+#define C3_DIVISION_H
+
+#include <stdint.h>
+#include <vector>
+#include <unordered_map>
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ip-l4-protocol.h"
+
+#include "c3-tag.h"
+#include "c3-ds-tunnel.h"
+
+namespace ns3 {
+namespace dcn {
+
+/**
+ * \ingroup dcn
+ *
+ * \brief the tunnels of a division (tenant) of C3 on a host
+ *
+ * The rate of the division is shared between its tunnels max-min fairly
+ * up to their deadline demand, and the spare rate equally.
+ */
+class C3Division : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  C3Division ();
+  virtual ~C3Division ();
+
+  /**
+   * \param cb the callback to send the shaped packets to IP
+   */
+  void SetDownTarget (IpL4Protocol::DownTargetCallback cb);
+
+  /**
+   * \brief Shape a packet of the division
+   * \param p the packet
+   * \param flowKey the key of the flow in its tunnel
+   * \param tag the C3 information of the flow
+   * \param source the source address
+   * \param destination the destination address
+   * \param protocol the L4 protocol number
+   * \param route the route of the packet
+   * \return true if the packet starts a new flow
+   */
+  bool Send (Ptr<Packet> p, uint64_t flowKey, const C3Tag &tag,
+             Ipv4Address source, Ipv4Address destination,
+             uint8_t protocol, Ptr<Ipv4Route> route);
+
+  /**
+   * \brief Remove the idle flows and tunnels and compute the demand of
+   * the division
+   * \param timeout the idle time after which a flow is over
+   * \return the rate the division needs to meet its deadlines in bps
+   */
+  double Update (Time timeout);
+
+  /**
+   * \brief Allocate the rate of the division to its tunnels
+   * \param rate the rate of the division in bps
+   */
+  void SetRate (double rate);
+
+  /**
+   * \return the number of flows in the division
+   */
+  uint32_t GetNFlows (void) const;
+
+  /**
+   * \brief Share a rate max-min fairly up to the demands, then the spare
+   * rate in proportion to the weights
+   * \param rate the rate to share
+   * \param demands the demands
+   * \param weights the weights of the spare rate, all equal if empty
+   * \param rates the shares
+   */
+  static void Allocate (double rate, const std::vector<double> &demands,
+                        const std::vector<double> &weights, std::vector<double> &rates);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// the tunnels by source and destination address
+  typedef std::unordered_map<uint64_t, Ptr<C3DsTunnel> > TunnelMap_t;
+
+  TunnelMap_t m_tunnels;                         //!< the tunnels
+  std::vector<double> m_demands;                 //!< demands of the tunnels at the last update
+  IpL4Protocol::DownTargetCallback m_downTarget; //!< callback to IP
+};
+
+} //namespace dcn
+} //namespace ns3
+
+#endif // C3_DIVISION_H
@@ -0,0 +1,171 @@
+#include "c3-ds-flow.h"
+
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("C3DsFlow");
+
+namespace dcn {
+
+NS_OBJECT_ENSURE_REGISTERED (C3DsFlow);
+
+TypeId
+C3DsFlow::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::dcn::C3DsFlow")
+      .SetParent<Object> ()
+      .SetGroupName ("DCN")
+      .AddConstructor<C3DsFlow> ()
+      .AddAttribute ("Bucket",
+                     "The bucket of the shaper of the flow in bits",
+                     UintegerValue (24000),
+                     MakeUintegerAccessor (&C3DsFlow::SetBucket),
+                     MakeUintegerChecker<uint64_t> ())
+      .AddAttribute ("QueueLimit",
+                     "The queue limit of the shaper of the flow in packets",
+                     UintegerValue (1000),
+                     MakeUintegerAccessor (&C3DsFlow::SetQueueLimit),
+                     MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+C3DsFlow::C3DsFlow ()
+  : m_flowSize (0),
+    m_sentBytes (0),
+    m_backlog (0),
+    m_deadline (0),
+    m_protocol (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_tbf = CreateObject<TokenBucketFilter> ();
+  m_tbf->SetRate (DataRate (0));
+  m_tbf->SetSendTarget (MakeCallback (&C3DsFlow::Forward, this));
+  m_tbf->SetDropTarget (MakeCallback (&C3DsFlow::Drop, this));
+}
+
+C3DsFlow::~C3DsFlow ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+C3DsFlow::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_tbf->Dispose ();
+  m_tbf = 0;
+  m_route = 0;
+  m_downTarget.Nullify ();
+  Object::DoDispose ();
+}
+
+void
+C3DsFlow::SetBucket (uint64_t bucket)
+{
+  m_tbf->SetAttribute ("Bucket", UintegerValue (bucket));
+}
+
+void
+C3DsFlow::SetQueueLimit (uint32_t limit)
+{
+  m_tbf->SetQueueLimit (limit);
+}
+
+void
+C3DsFlow::SetFlowInfo (uint32_t flowSize, Time deadline)
+{
+  NS_LOG_FUNCTION (this << flowSize << deadline);
+  m_flowSize = flowSize;
+  m_deadline = deadline.IsStrictlyPositive () ? Simulator::Now () + deadline : Time (0);
+  m_lastSend = Simulator::Now ();
+}
+
+void
+C3DsFlow::SetDownTarget (IpL4Protocol::DownTargetCallback cb)
+{
+  m_downTarget = cb;
+}
+
+void
+C3DsFlow::Send (Ptr<Packet> p, Ipv4Address source, Ipv4Address destination,
+                uint8_t protocol, Ptr<Ipv4Route> route)
+{
+  NS_LOG_FUNCTION (this << p << source << destination << (int)protocol << route);
+  m_source = source;
+  m_destination = destination;
+  m_protocol = protocol;
+  m_route = route;
+  m_sentBytes += p->GetSize ();
+  m_lastSend = Simulator::Now ();
+  m_backlog += p->GetSize ();
+  m_tbf->Send (p);
+}
+
+void
+C3DsFlow::Forward (Ptr<Packet> p)
+{
+  NS_LOG_FUNCTION (this << p);
+  m_backlog -= p->GetSize ();
+  m_downTarget (p, m_source, m_destination, m_protocol, m_route);
+}
+
+void
+C3DsFlow::Drop (Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << p);
+  // the transport protocol sends the packet again
+  m_backlog -= p->GetSize ();
+  m_sentBytes -= p->GetSize ();
+  NS_LOG_INFO ("Drop " << p << " of flow to " << m_destination << " with rate " << m_tbf->GetRate ());
+}
+
+double
+C3DsFlow::GetDemand (void) const
+{
+  Time now = Simulator::Now ();
+  if (m_deadline <= now)
+    {
+      return 0;
+    }
+  uint64_t remaining = GetRemainingSize () + m_backlog;
+  return remaining * 8.0 / (m_deadline - now).GetSeconds ();
+}
+
+uint32_t
+C3DsFlow::GetRemainingSize (void) const
+{
+  return m_sentBytes < m_flowSize ? m_flowSize - m_sentBytes : 0;
+}
+
+Time
+C3DsFlow::GetDeadline (void) const
+{
+  return m_deadline;
+}
+
+bool
+C3DsFlow::IsIdle (Time timeout) const
+{
+  return m_backlog == 0 && Simulator::Now () - m_lastSend >= timeout;
+}
+
+DataRate
+C3DsFlow::GetRate (void) const
+{
+  return m_tbf->GetRate ();
+}
+
+void
+C3DsFlow::SetRate (DataRate rate)
+{
+  NS_LOG_FUNCTION (this << rate);
+  m_tbf->SetRate (rate);
+}
+
+} //namespace dcn
+} //namespace ns3
@@ -0,0 +1,135 @@
+#ifndef C3_DS_FLOW_H
+#define C3_DS_FLOW_H
+
+#include <stdint.h>
+
+#include "ns3/object.h"
+#include "ns3/data-rate.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/net-device.h"
+#include "ns3/ip-l4-protocol.h"
+
+#include "token-bucket-filter.h"
+
+namespace ns3 {
+namespace dcn {
+
+/**
+ * \ingroup dcn
+ *
+ * \brief a deadline or size aware flow of C3
+ *
+ * The packets of the flow are shaped by a TokenBucketFilter at the rate
+ * its tunnel allocates to it.  The flow knows its remaining size, and the
+ * rate it needs to meet its deadline.
+ */
+class C3DsFlow : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  C3DsFlow ();
+  virtual ~C3DsFlow ();
+
+  /**
+   * \brief Set the size and the deadline of the flow, which starts now
+   * \param flowSize the size of the flow in bytes
+   * \param deadline the deadline relative to now, zero for no deadline
+   */
+  void SetFlowInfo (uint32_t flowSize, Time deadline);
+
+  /**
+   * \param cb the callback to send the shaped packets to IP
+   */
+  void SetDownTarget (IpL4Protocol::DownTargetCallback cb);
+
+  /**
+   * \brief Shape a packet of the flow
+   * \param p the packet
+   * \param source the source address
+   * \param destination the destination address
+   * \param protocol the L4 protocol number
+   * \param route the route of the packet
+   */
+  void Send (Ptr<Packet> p, Ipv4Address source, Ipv4Address destination,
+             uint8_t protocol, Ptr<Ipv4Route> route);
+
+  /**
+   * \return the rate the flow needs to meet its deadline in bps, zero if
+   * it has no deadline or missed it
+   */
+  double GetDemand (void) const;
+
+  /**
+   * \return the bytes of the flow not sent yet by the application
+   */
+  uint32_t GetRemainingSize (void) const;
+
+  /**
+   * \return the absolute deadline of the flow, zero if it has none
+   */
+  Time GetDeadline (void) const;
+
+  /**
+   * \param timeout the idle time after which a flow is over
+   * \return true if nothing is queued and nothing was sent for the timeout
+   */
+  bool IsIdle (Time timeout) const;
+
+  /**
+   * \return the rate allocated to the flow
+   */
+  DataRate GetRate (void) const;
+
+  /**
+   * \param rate the rate allocated to the flow
+   */
+  void SetRate (DataRate rate);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \param bucket the bucket of the shaper in bits
+   */
+  void SetBucket (uint64_t bucket);
+  /**
+   * \param limit the queue limit of the shaper in packets
+   */
+  void SetQueueLimit (uint32_t limit);
+  /**
+   * \brief Send a packet leaving the token bucket filter to IP
+   * \param p the packet
+   */
+  void Forward (Ptr<Packet> p);
+  /**
+   * \brief Account a packet dropped by the token bucket filter
+   * \param p the packet
+   */
+  void Drop (Ptr<const Packet> p);
+
+  Ptr<TokenBucketFilter> m_tbf;      //!< shaper of the flow
+  uint32_t m_flowSize;               //!< size of the flow in bytes
+  uint64_t m_sentBytes;              //!< bytes received from L4
+  uint32_t m_backlog;                //!< bytes in the shaper
+  Time m_deadline;                   //!< absolute deadline, zero for none
+  Time m_lastSend;                   //!< last time a packet was received from L4
+  Ipv4Address m_source;              //!< source address
+  Ipv4Address m_destination;         //!< destination address
+  uint8_t m_protocol;                //!< L4 protocol number
+  Ptr<Ipv4Route> m_route;            //!< route of the last packet
+  IpL4Protocol::DownTargetCallback m_downTarget; //!< callback to IP
+};
+
+} //namespace dcn
+} //namespace ns3
+
+#endif // C3_DS_FLOW_H
@@ -0,0 +1,172 @@
+#include "c3-ds-tunnel.h"
+
+#include <vector>
+#include <algorithm>
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("C3DsTunnel");
+
+namespace dcn {
+
+NS_OBJECT_ENSURE_REGISTERED (C3DsTunnel);
+
+TypeId
+C3DsTunnel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::dcn::C3DsTunnel")
+      .SetParent<Object> ()
+      .SetGroupName ("DCN")
+      .AddConstructor<C3DsTunnel> ()
+  ;
+  return tid;
+}
+
+C3DsTunnel::C3DsTunnel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+C3DsTunnel::~C3DsTunnel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+C3DsTunnel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (FlowMap_t::iterator it = m_flows.begin (); it != m_flows.end (); ++it)
+    {
+      it->second->Dispose ();
+    }
+  m_flows.clear ();
+  m_downTarget.Nullify ();
+  Object::DoDispose ();
+}
+
+void
+C3DsTunnel::SetDownTarget (IpL4Protocol::DownTargetCallback cb)
+{
+  m_downTarget = cb;
+}
+
+bool
+C3DsTunnel::Send (Ptr<Packet> p, uint64_t flowKey, const C3Tag &tag,
+                  Ipv4Address source, Ipv4Address destination,
+                  uint8_t protocol, Ptr<Ipv4Route> route)
+{
+  NS_LOG_FUNCTION (this << p << flowKey);
+  bool created = false;
+  Ptr<C3DsFlow> &flow = m_flows[flowKey];
+  if (flow == 0)
+    {
+      flow = CreateObject<C3DsFlow> ();
+      flow->SetFlowInfo (tag.GetFlowSize (), tag.GetDeadline ());
+      flow->SetDownTarget (m_downTarget);
+      created = true;
+      NS_LOG_INFO ("New flow to " << destination << " of " << tag.GetFlowSize ()
+                   << " bytes with deadline " << flow->GetDeadline ());
+    }
+  flow->Send (p, source, destination, protocol, route);
+  return created;
+}
+
+double
+C3DsTunnel::Update (Time timeout)
+{
+  NS_LOG_FUNCTION (this << timeout);
+  double demand = 0;
+  for (FlowMap_t::iterator it = m_flows.begin (); it != m_flows.end (); )
+    {
+      if (it->second->IsIdle (timeout))
+        {
+          NS_LOG_INFO ("Flow to the deadline " << it->second->GetDeadline () << " is over");
+          it->second->Dispose ();
+          it = m_flows.erase (it);
+        }
+      else
+        {
+          demand += it->second->GetDemand ();
+          ++it;
+        }
+    }
+  return demand;
+}
+
+namespace {
+
+/// A flow and the allocation data of its rate
+struct FlowRate
+{
+  Ptr<C3DsFlow> flow; //!< the flow
+  Time deadline;      //!< its deadline, zero for none
+  double demand;      //!< the rate it needs to meet its deadline
+  double weight;      //!< its weight for the spare rate
+  double rate;        //!< the rate allocated
+
+  /**
+   * \param o the other flow
+   * \return true if the flow has an earlier deadline than the other
+   */
+  bool operator< (const FlowRate &o) const
+  {
+    return deadline < o.deadline;
+  }
+};
+
+} // anonymous namespace
+
+void
+C3DsTunnel::SetRate (double rate)
+{
+  NS_LOG_FUNCTION (this << rate);
+  if (m_flows.empty ())
+    {
+      return;
+    }
+  std::vector<FlowRate> flows;
+  flows.reserve (m_flows.size ());
+  double totalWeight = 0;
+  for (FlowMap_t::const_iterator it = m_flows.begin (); it != m_flows.end (); ++it)
+    {
+      FlowRate f;
+      f.flow = it->second;
+      f.deadline = f.flow->GetDeadline ();
+      f.demand = f.flow->GetDemand ();
+      // size-aware: the shortest flows get most of the spare rate
+      f.weight = 1.0 / (1 + f.flow->GetRemainingSize ());
+      f.rate = 0;
+      totalWeight += f.weight;
+      flows.push_back (f);
+    }
+
+  // earliest deadline first
+  std::sort (flows.begin (), flows.end ());
+  double spare = rate;
+  for (std::vector<FlowRate>::iterator it = flows.begin (); it != flows.end () && spare > 0; ++it)
+    {
+      if (it->demand > 0)
+        {
+          it->rate = std::min (it->demand, spare);
+          spare -= it->rate;
+        }
+    }
+  for (std::vector<FlowRate>::iterator it = flows.begin (); it != flows.end (); ++it)
+    {
+      it->rate += spare * it->weight / totalWeight;
+      it->flow->SetRate (DataRate (static_cast<uint64_t> (it->rate)));
+    }
+}
+
+uint32_t
+C3DsTunnel::GetNFlows (void) const
+{
+  return m_flows.size ();
+}
+
+} //namespace dcn
+} //namespace ns3
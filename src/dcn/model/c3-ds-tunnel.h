@@ -0,0 +1,93 @@
+#ifndef C3_DS_TUNNEL_H
+#define C3_DS_TUNNEL_H
+
+#include <stdint.h>
+#include <unordered_map>
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ip-l4-protocol.h"
+
+#include "c3-tag.h"
+#include "c3-ds-flow.h"
+
+namespace ns3 {
+namespace dcn {
+
+/**
+ * \ingroup dcn
+ *
+ * \brief the flows of a division between a source and a destination
+ *
+ * The rate of the tunnel goes first to the deadlines of its flows, the
+ * earliest deadline first, then to all its flows in inverse proportion
+ * to their remaining size.
+ */
+class C3DsTunnel : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  C3DsTunnel ();
+  virtual ~C3DsTunnel ();
+
+  /**
+   * \param cb the callback to send the shaped packets to IP
+   */
+  void SetDownTarget (IpL4Protocol::DownTargetCallback cb);
+
+  /**
+   * \brief Shape a packet of one of the flows of the tunnel
+   * \param p the packet
+   * \param flowKey the key of the flow
+   * \param tag the C3 information of the flow
+   * \param source the source address
+   * \param destination the destination address
+   * \param protocol the L4 protocol number
+   * \param route the route of the packet
+   * \return true if the packet starts a new flow
+   */
+  bool Send (Ptr<Packet> p, uint64_t flowKey, const C3Tag &tag,
+             Ipv4Address source, Ipv4Address destination,
+             uint8_t protocol, Ptr<Ipv4Route> route);
+
+  /**
+   * \brief Remove the idle flows and compute the demand of the tunnel
+   * \param timeout the idle time after which a flow is over
+   * \return the rate the tunnel needs to meet its deadlines in bps
+   */
+  double Update (Time timeout);
+
+  /**
+   * \brief Allocate the rate of the tunnel to its flows
+   * \param rate the rate of the tunnel in bps
+   */
+  void SetRate (double rate);
+
+  /**
+   * \return the number of flows in the tunnel
+   */
+  uint32_t GetNFlows (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// the flows by key
+  typedef std::unordered_map<uint64_t, Ptr<C3DsFlow> > FlowMap_t;
+
+  FlowMap_t m_flows;                             //!< the flows
+  IpL4Protocol::DownTargetCallback m_downTarget; //!< callback to IP
+};
+
+} //namespace dcn
+} //namespace ns3
+
+#endif // C3_DS_TUNNEL_H
@@ -0,0 +1,171 @@
+#include "c3-l3_5-protocol.h"
+
+#include <vector>
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("C3L3_5Protocol");
+
+namespace dcn {
+
+NS_OBJECT_ENSURE_REGISTERED (C3L3_5Protocol);
+
+TypeId
+C3L3_5Protocol::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::dcn::C3L3_5Protocol")
+      .SetParent<IpL3_5Protocol> ()
+      .SetGroupName ("DCN")
+      .AddConstructor<C3L3_5Protocol> ()
+      .AddAttribute ("DataRate",
+                     "The rate shared by the C3 flows of the host",
+                     DataRateValue (DataRate ("1Gbps")),
+                     MakeDataRateAccessor (&C3L3_5Protocol::m_rate),
+                     MakeDataRateChecker ())
+      .AddAttribute ("ControlInterval",
+                     "The interval between two allocations of the rates",
+                     TimeValue (MicroSeconds (500)),
+                     MakeTimeAccessor (&C3L3_5Protocol::m_interval),
+                     MakeTimeChecker ())
+      .AddAttribute ("FlowTimeout",
+                     "The idle time after which a flow is over",
+                     TimeValue (MilliSeconds (10)),
+                     MakeTimeAccessor (&C3L3_5Protocol::m_flowTimeout),
+                     MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+C3L3_5Protocol::C3L3_5Protocol ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+C3L3_5Protocol::~C3L3_5Protocol ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+C3L3_5Protocol::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_updateEvent.Cancel ();
+  for (DivisionMap_t::iterator it = m_divisions.begin (); it != m_divisions.end (); ++it)
+    {
+      it->second->Dispose ();
+    }
+  m_divisions.clear ();
+  IpL3_5Protocol::DoDispose ();
+}
+
+void
+C3L3_5Protocol::Send (Ptr<Packet> packet, Ipv4Address source,
+                      Ipv4Address destination, uint8_t protocol, Ptr<Ipv4Route> route)
+{
+  NS_LOG_FUNCTION (this << packet << source << destination << (int)protocol << route);
+  C3Tag tag;
+  if (!packet->PeekPacketTag (tag) && !packet->FindFirstMatchingByteTag (tag))
+    {
+      ForwardDown (packet, source, destination, protocol, route);
+      return;
+    }
+
+  // the ports lead both the TCP and the UDP headers
+  uint8_t ports[4] = { 0, 0, 0, 0 };
+  packet->CopyData (ports, 4);
+  uint64_t flowKey = (static_cast<uint64_t> (protocol) << 32)
+    | (static_cast<uint32_t> (ports[0]) << 24) | (ports[1] << 16) | (ports[2] << 8) | ports[3];
+
+  Ptr<C3Division> &division = m_divisions[tag.GetDivisionId ()];
+  if (division == 0)
+    {
+      division = CreateObject<C3Division> ();
+      division->SetDownTarget (GetDownTarget ());
+      NS_LOG_INFO ("New division " << tag.GetDivisionId ());
+    }
+  if (division->Send (packet, flowKey, tag, source, destination, protocol, route)
+      && !m_updateEvent.IsRunning ())
+    {
+      m_updateEvent = Simulator::Schedule (m_interval, &C3L3_5Protocol::Update, this);
+    }
+}
+
+void
+C3L3_5Protocol::Send6 (Ptr<Packet> packet, Ipv6Address source,
+                       Ipv6Address destination, uint8_t protocol, Ptr<Ipv6Route> route)
+{
+  NS_LOG_FUNCTION (this << packet << source << destination << (int)protocol << route);
+  ForwardDown6 (packet, source, destination, protocol, route);
+}
+
+IpL4Protocol::RxStatus
+C3L3_5Protocol::Receive (Ptr<Packet> p,
+                         Ipv4Header const &header,
+                         Ptr<Ipv4Interface> incomingInterface)
+{
+  NS_LOG_FUNCTION (this << p << header << incomingInterface);
+  return ForwardUp (p, header, incomingInterface, header.GetProtocol ());
+}
+
+IpL4Protocol::RxStatus
+C3L3_5Protocol::Receive (Ptr<Packet> p,
+                         Ipv6Header const &header,
+                         Ptr<Ipv6Interface> incomingInterface)
+{
+  NS_LOG_FUNCTION (this << p << header << incomingInterface);
+  return ForwardUp6 (p, header, incomingInterface, header.GetNextHeader ());
+}
+
+uint32_t
+C3L3_5Protocol::GetNFlows (void) const
+{
+  uint32_t n = 0;
+  for (DivisionMap_t::const_iterator it = m_divisions.begin (); it != m_divisions.end (); ++it)
+    {
+      n += it->second->GetNFlows ();
+    }
+  return n;
+}
+
+void
+C3L3_5Protocol::Update (void)
+{
+  NS_LOG_FUNCTION (this);
+  std::vector<double> demands;
+  for (DivisionMap_t::iterator it = m_divisions.begin (); it != m_divisions.end (); )
+    {
+      double demand = it->second->Update (m_flowTimeout);
+      if (it->second->GetNFlows () == 0)
+        {
+          it->second->Dispose ();
+          m_divisions.erase (it++);
+        }
+      else
+        {
+          demands.push_back (demand);
+          ++it;
+        }
+    }
+  if (m_divisions.empty ())
+    {
+      NS_LOG_INFO ("No flow left");
+      return;
+    }
+
+  std::vector<double> rates;
+  C3Division::Allocate (m_rate.GetBitRate (), demands, std::vector<double> (), rates);
+  uint32_t i = 0;
+  for (DivisionMap_t::iterator it = m_divisions.begin (); it != m_divisions.end (); ++it, ++i)
+    {
+      it->second->SetRate (rates[i]);
+    }
+  NS_LOG_INFO ("Rates of " << m_divisions.size () << " divisions updated");
+  m_updateEvent = Simulator::Schedule (m_interval, &C3L3_5Protocol::Update, this);
+}
+
+} //namespace dcn
+} //namespace ns3
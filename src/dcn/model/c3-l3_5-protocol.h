@@ -0,0 +1,82 @@
+#ifndef C3_L3_5_PROTOCOL_H
+#define C3_L3_5_PROTOCOL_H
+
+#include <stdint.h>
+#include <map>
+
+#include "ns3/data-rate.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+
+#include "ip-l3_5-protocol.h"
+#include "c3-division.h"
+
+namespace ns3 {
+namespace dcn {
+
+/**
+ * \ingroup dcn
+ *
+ * \brief C3: a deadline and size aware rate allocation between L4 and IP
+ *
+ * The packets tagged with a C3Tag are shaped per flow.  The rate of the
+ * host is shared between the divisions, the rate of a division between its
+ * tunnels, and the rate of a tunnel between its flows.  The rates are
+ * recomputed once per control interval for all the flows, never per
+ * packet; a new flow sends its bucket and waits for the next interval.
+ * The untagged and IPv6 packets are not shaped.
+ */
+class C3L3_5Protocol : public IpL3_5Protocol
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  C3L3_5Protocol ();
+  virtual ~C3L3_5Protocol ();
+
+  // inherited from IpL3_5Protocol
+  virtual void Send (Ptr<Packet> packet, Ipv4Address source,
+                     Ipv4Address destination, uint8_t protocol, Ptr<Ipv4Route> route);
+  virtual void Send6 (Ptr<Packet> packet, Ipv6Address source,
+                      Ipv6Address destination, uint8_t protocol, Ptr<Ipv6Route> route);
+
+  // inherited from IpL4Protocol
+  virtual enum IpL4Protocol::RxStatus Receive (Ptr<Packet> p,
+                                               Ipv4Header const &header,
+                                               Ptr<Ipv4Interface> incomingInterface);
+  virtual enum IpL4Protocol::RxStatus Receive (Ptr<Packet> p,
+                                               Ipv6Header const &header,
+                                               Ptr<Ipv6Interface> incomingInterface);
+
+  /**
+   * \return the number of flows being shaped
+   */
+  uint32_t GetNFlows (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief Remove the flows over and share the rate of the host
+   */
+  void Update (void);
+
+  /// the divisions by id
+  typedef std::map<uint32_t, Ptr<C3Division> > DivisionMap_t;
+
+  DataRate m_rate;             //!< rate of the host
+  Time m_interval;             //!< control interval
+  Time m_flowTimeout;          //!< idle time after which a flow is over
+  DivisionMap_t m_divisions;   //!< the divisions
+  EventId m_updateEvent;       //!< next update of the rates
+};
+
+} //namespace dcn
+} //namespace ns3
+
+#endif // C3_L3_5_PROTOCOL_H
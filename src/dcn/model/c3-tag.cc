@@ -0,0 +1,121 @@
+#include "c3-tag.h"
+
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("C3Tag");
+
+namespace dcn {
+
+NS_OBJECT_ENSURE_REGISTERED (C3Tag);
+
+TypeId
+C3Tag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::dcn::C3Tag")
+      .SetParent<Tag> ()
+      .SetGroupName ("DCN")
+      .AddConstructor<C3Tag> ()
+  ;
+  return tid;
+}
+
+TypeId
+C3Tag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+uint32_t
+C3Tag::GetSerializedSize (void) const
+{
+  return 4 + 8 + 4 + 4;
+}
+
+void
+C3Tag::Serialize (TagBuffer buf) const
+{
+  buf.WriteU32 (m_flowSize);
+  buf.WriteU64 (m_deadline.GetTimeStep ());
+  buf.WriteU32 (m_segmentSize);
+  buf.WriteU32 (m_divisionId);
+}
+
+void
+C3Tag::Deserialize (TagBuffer buf)
+{
+  m_flowSize = buf.ReadU32 ();
+  m_deadline = TimeStep (buf.ReadU64 ());
+  m_segmentSize = buf.ReadU32 ();
+  m_divisionId = buf.ReadU32 ();
+}
+
+void
+C3Tag::Print (std::ostream &os) const
+{
+  os << "FlowSize=" << m_flowSize
+     << " Deadline=" << m_deadline
+     << " SegmentSize=" << m_segmentSize
+     << " DivisionId=" << m_divisionId;
+}
+
+C3Tag::C3Tag ()
+  : Tag (),
+    m_flowSize (0),
+    m_deadline (0),
+    m_segmentSize (0),
+    m_divisionId (0)
+{
+}
+
+uint32_t
+C3Tag::GetFlowSize (void) const
+{
+  return m_flowSize;
+}
+
+void
+C3Tag::SetFlowSize (uint32_t flowSize)
+{
+  m_flowSize = flowSize;
+}
+
+Time
+C3Tag::GetDeadline (void) const
+{
+  return m_deadline;
+}
+
+void
+C3Tag::SetDeadline (Time deadline)
+{
+  m_deadline = deadline;
+}
+
+uint32_t
+C3Tag::GetSegmentSize (void) const
+{
+  return m_segmentSize;
+}
+
+void
+C3Tag::SetSegmentSize (uint32_t segmentSize)
+{
+  m_segmentSize = segmentSize;
+}
+
+uint32_t
+C3Tag::GetDivisionId (void) const
+{
+  return m_divisionId;
+}
+
+void
+C3Tag::SetDivisionId (uint32_t divisionId)
+{
+  m_divisionId = divisionId;
+}
+
+} //namespace dcn
+} //namespace ns3
@@ -0,0 +1,84 @@
+#ifndef C3_TAG_H
+#define C3_TAG_H
+
+#include <stdint.h>
+
+#include "ns3/tag.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+namespace dcn {
+
+/**
+ * \ingroup dcn
+ *
+ * \brief the flow information C3 needs to allocate rates
+ *
+ * The sender application tags the packets of a flow with its size,
+ * its deadline relative to the start of the flow (zero for flows
+ * without deadline) and the division (tenant) it belongs to.
+ */
+class C3Tag : public Tag
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer buf) const;
+  virtual void Deserialize (TagBuffer buf);
+  virtual void Print (std::ostream &os) const;
+
+  C3Tag ();
+
+  /**
+   * \return the size of the flow in bytes
+   */
+  uint32_t GetFlowSize (void) const;
+  /**
+   * \param flowSize the size of the flow in bytes
+   */
+  void SetFlowSize (uint32_t flowSize);
+
+  /**
+   * \return the deadline of the flow, relative to its start
+   */
+  Time GetDeadline (void) const;
+  /**
+   * \param deadline the deadline of the flow, relative to its start,
+   * or zero if the flow has no deadline
+   */
+  void SetDeadline (Time deadline);
+
+  /**
+   * \return the segment size of the flow
+   */
+  uint32_t GetSegmentSize (void) const;
+  /**
+   * \param segmentSize the segment size of the flow
+   */
+  void SetSegmentSize (uint32_t segmentSize);
+
+  /**
+   * \return the division the flow belongs to
+   */
+  uint32_t GetDivisionId (void) const;
+  /**
+   * \param divisionId the division the flow belongs to
+   */
+  void SetDivisionId (uint32_t divisionId);
+
+private:
+  uint32_t m_flowSize;    //!< size of the flow in bytes
+  Time m_deadline;        //!< deadline relative to the start of the flow
+  uint32_t m_segmentSize; //!< segment size of the flow
+  uint32_t m_divisionId;  //!< division of the flow
+};
+
+} //namespace dcn
+} //namespace ns3
+
+#endif // C3_TAG_H
@@ -92,12 +92,10 @@ IpL3_5Protocol::Insert (Ptr<IpL4Protocol> protocol, int32_t interfaceIndex)
 {
   NS_LOG_FUNCTION (this << protocol << interfaceIndex);
 
-  L4ListKey_t key = std::make_pair (protocol->GetProtocolNumber (), interfaceIndex);
-  if (m_protocols.find (key) != m_protocols.end ())
+  if (!m_protocols.Insert (protocol, interfaceIndex))
     {
       NS_LOG_WARN ("Overwriting protocol " << int(protocol->GetProtocolNumber ()) << " on interface " << int(interfaceIndex));
     }
-  m_protocols[key] = protocol;
 }
 
 void
@@ -113,16 +111,10 @@ IpL3_5Protocol::Remove (Ptr<IpL4Protocol> protocol, int32_t interfaceIndex)
 {
   NS_LOG_FUNCTION (this << protocol << interfaceIndex);
 
-  L4ListKey_t key = std::make_pair (protocol->GetProtocolNumber (), interfaceIndex);
-  L4List_t::iterator iter = m_protocols.find (key);
-  if (iter == m_protocols.end ())
+  if (!m_protocols.Remove (protocol->GetProtocolNumber (), interfaceIndex))
     {
       NS_LOG_WARN ("Trying to remove an non-existent protocol " << int(protocol->GetProtocolNumber ()) << " on interface " << int(interfaceIndex));
     }
-  else
-    {
-      m_protocols.erase (key);
-    }
 }
 
 Ptr<IpL4Protocol>
@@ -138,27 +130,7 @@ IpL3_5Protocol::GetProtocol (int protocolNumber, int32_t interfaceIndex) const
 {
   NS_LOG_FUNCTION (this << protocolNumber << interfaceIndex);
 
-  L4ListKey_t key;
-  L4List_t::const_iterator i;
-  if (interfaceIndex >= 0)
-    {
-      // try the interface-specific protocol.
-      key = std::make_pair (protocolNumber, interfaceIndex);
-      i = m_protocols.find (key);
-      if (i != m_protocols.end ())
-        {
-          return i->second;
-        }
-    }
-  // try the generic protocol.
-  key = std::make_pair (protocolNumber, -1);
-  i = m_protocols.find (key);
-  if (i != m_protocols.end ())
-    {
-      return i->second;
-    }
-
-  return 0;
+  return m_protocols.Get (protocolNumber, interfaceIndex);
 }
 
 void
@@ -168,7 +140,7 @@ IpL3_5Protocol::DoDispose (void)
   m_downTarget6.Nullify ();
   m_downTarget.Nullify ();
   m_node = 0;
-  m_protocols.clear ();
+  m_protocols.Clear ();
   m_protocolNumber = 0;
   IpL4Protocol::DoDispose ();
 }
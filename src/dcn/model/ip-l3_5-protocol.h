@@ -8,6 +8,7 @@
 #include <utility>
 
 #include "ns3/ip-l4-protocol.h"
+#include "ns3/ip-l4-protocol-table.h"
 #include "ns3/type-id.h"
 #include "ns3/ptr.h"
 #include "ns3/node.h"
@@ -152,18 +153,8 @@ protected:
                      uint8_t protocol, Ptr<Ipv6Route> route);
 
 private:
-  /**
-   * \brief Container of the IPv4 L4 keys: protocol number, interface index
-   */
-  typedef std::pair<int, int32_t> L4ListKey_t;
-
-  /**
-   * \brief Container of the IPv4 L4 instances.
-   */
-  typedef std::map<L4ListKey_t, Ptr<IpL4Protocol> > L4List_t;
-
   uint8_t m_protocolNumber; //!< current protocol number.
-  L4List_t m_protocols;  //!< List of transport protocol.
+  IpL4ProtocolTable m_protocols;  //!< List of transport protocol.
   Ptr<Node> m_node;   //!< the node this stack is associated with
   IpL4Protocol::DownTargetCallback m_downTarget;   //!< Callback to send packets over IPv4
   IpL4Protocol::DownTargetCallback6 m_downTarget6; //!< Callback to send packets over IPv6
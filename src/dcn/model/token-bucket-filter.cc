@@ -3,7 +3,9 @@
 #include "ns3/log.h"
 #include "ns3/assert.h"
 #include "ns3/uinteger.h"
-#include "ns3/drop-tail-queue.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
 
 namespace ns3 {
 
@@ -13,6 +15,9 @@ namespace dcn {
 
 NS_OBJECT_ENSURE_REGISTERED (TokenBucketFilter);
 
+/// nanobits per bit
+static const int64_t NANOBITS = 1000000000;
+
 TypeId
 TokenBucketFilter::GetTypeId (void)
 {
@@ -37,6 +42,11 @@ TokenBucketFilter::GetTypeId (void)
                      MakeUintegerAccessor (&TokenBucketFilter::SetQueueLimit,
                                            &TokenBucketFilter::GetQueueLimit),
                      MakeUintegerChecker<uint64_t> ())
+      .AddAttribute ("Slack",
+                     "The packets eligible within the slack are released together",
+                     TimeValue (Seconds (0)),
+                     MakeTimeAccessor (&TokenBucketFilter::m_slack),
+                     MakeTimeChecker (Seconds (0)))
   ;
   return tid;
 }
@@ -46,14 +56,11 @@ TokenBucketFilter::TokenBucketFilter ()
     m_bucket (0),
     m_tokens (0),
     m_init (true),
-    m_timer (Timer::CANCEL_ON_DESTROY)
+    m_queueLimit (0),
+    m_nEvents (0)
 {
   NS_LOG_FUNCTION (this);
   m_lastUpdateTime = Simulator::Now ();
-  m_queue = CreateObject<DropTailQueue> ();
-  m_queue->SetMode (Queue::QUEUE_MODE_PACKETS);
-  m_queue->SetDropCallback (MakeCallback (&TokenBucketFilter::Drop, this));
-  m_timer.SetFunction (&TokenBucketFilter::Transmit, this);
 }
 
 TokenBucketFilter::~TokenBucketFilter ()
@@ -65,12 +72,19 @@ void
 TokenBucketFilter::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
-  m_timer.Cancel ();
+  m_event.Cancel ();
   // drop all packet in the queue
-  while (!m_queue->IsEmpty ())
+  while (!m_queue.empty ())
     {
-      m_dropTarget (m_queue->Dequeue ()->GetPacket ());
+      m_dropTarget (m_queue.front ());
+      m_queue.pop_front ();
     }
+  SetParent (0);
+  for (std::vector<TokenBucketFilter *>::iterator i = m_children.begin (); i != m_children.end (); ++i)
+    {
+      (*i)->m_parent = 0;
+    }
+  m_children.clear ();
   Connector::DoDispose ();
 }
 
@@ -79,38 +93,31 @@ TokenBucketFilter::Send (Ptr<Packet> p)
 {
   NS_LOG_FUNCTION (this << p);
 
-  // start with a full bucket
-  if (m_init)
+  //send at once if the queue is empty and the tokens are there
+  if (m_queue.empty ())
     {
-      m_tokens = static_cast<double> (m_bucket);
-      m_lastUpdateTime = Simulator::Now ();
-      m_init = false;
+      int64_t cost = static_cast<int64_t> (p->GetSize ()) * 8 * NANOBITS;
+      int64_t wait = GetWait (cost);
+      NS_LOG_DEBUG ("tokens: "<< m_tokens << " cost: " << cost << " wait: " << wait);
+      if (wait >= 0 && wait <= m_slack.GetNanoSeconds ())
+        {
+          Charge (cost);
+          m_sendTarget (p);
+          return;
+        }
     }
 
-  //enque packets appropriately if a non-zero queue already exists
-  if (!m_queue->IsEmpty ())
+  if (m_queue.size () >= m_queueLimit)
     {
-      // leave the drop decision to queue
-      NS_LOG_DEBUG ("Enqueue packet: " << p);
-      m_queue->Enqueue (Create<QueueItem> (p));
+      NS_LOG_DEBUG ("Drop packet: " << p);
+      m_dropTarget (p);
+      return;
     }
-  else
+  NS_LOG_DEBUG ("Enqueue packet: " << p);
+  m_queue.push_back (p);
+  if (m_queue.size () == 1)
     {
-      UpdateTokens ();
-      uint64_t packetSize = static_cast<uint64_t> (p->GetSize ()) << 3; //packet size in bits
-      NS_LOG_DEBUG ("tokens: "<< m_tokens << " size: " << packetSize);
-      if (m_tokens >= packetSize)
-        {
-          m_sendTarget (p);
-          m_tokens -= packetSize;
-        }
-      else
-        {
-          if (m_queue->Enqueue (Create<QueueItem> (p)) && m_rate.GetBitRate ())
-            {
-              m_timer.Schedule (GetSendDelay (p));
-            }
-        }
+      Reschedule ();
     }
 }
 
@@ -124,73 +131,183 @@ void
 TokenBucketFilter::SetRate (DataRate rate)
 {
   NS_LOG_FUNCTION (this << rate);
-  if (rate == DataRate (0) && !m_queue->IsEmpty ())
+  if (!m_init)
     {
-      NS_LOG_DEBUG (Simulator::Now () << this << " rate to 0");
+      // the tokens until now come at the former rate
+      UpdateTokens ();
     }
   m_rate = rate;
-  // 如果当前queue非空 && m_timer无调度任务 && rate非0
-  if (m_timer.IsExpired () && !m_queue->IsEmpty () && m_rate.GetBitRate ())
-    {
-      //schedule next event
-      m_timer.Schedule (GetSendDelay (m_queue->Peek ()->GetPacket ()));
-    }
+  // the children wait for the tokens of this filter too
+  RescheduleAll ();
 }
 
 uint32_t
 TokenBucketFilter::GetQueueLimit (void) const
 {
-  return m_queue->GetMaxPackets ();
+  return m_queueLimit;
 }
 
 void
 TokenBucketFilter::SetQueueLimit (uint32_t limit)
 {
-  m_queue->SetMaxPackets (limit);
+  m_queueLimit = limit;
+}
+
+Ptr<TokenBucketFilter>
+TokenBucketFilter::GetParent (void) const
+{
+  return m_parent;
 }
 
 void
-TokenBucketFilter::Drop (Ptr<QueueItem> item)
+TokenBucketFilter::SetParent (Ptr<TokenBucketFilter> parent)
+{
+  NS_LOG_FUNCTION (this << parent);
+  if (m_parent != 0)
+    {
+      std::vector<TokenBucketFilter *> &siblings = m_parent->m_children;
+      siblings.erase (std::find (siblings.begin (), siblings.end (), this));
+    }
+  m_parent = parent;
+  if (m_parent != 0)
+    {
+      m_parent->m_children.push_back (this);
+    }
+  if (!m_queue.empty ())
+    {
+      Reschedule ();
+    }
+}
+
+uint64_t
+TokenBucketFilter::GetNEvents (void) const
 {
-  NS_LOG_FUNCTION (this << item->GetPacket ());
-  m_dropTarget (item->GetPacket ());
+  return m_nEvents;
 }
 
 void
 TokenBucketFilter::UpdateTokens (void)
 {
-  m_tokens = std::min (static_cast<double> (m_bucket),
-                       m_tokens + (Simulator::Now ().GetSeconds () - m_lastUpdateTime.GetSeconds ()) * m_rate.GetBitRate ());
-  m_lastUpdateTime = Simulator::Now ();
+  Time now = Simulator::Now ();
+  int64_t bucket = static_cast<int64_t> (m_bucket) * NANOBITS;
+  if (m_init)
+    {
+      // start with a full bucket
+      m_tokens = bucket;
+      m_lastUpdateTime = now;
+      m_init = false;
+      return;
+    }
+  int64_t elapsed = (now - m_lastUpdateTime).GetNanoSeconds ();
+  m_lastUpdateTime = now;
+  int64_t rate = static_cast<int64_t> (m_rate.GetBitRate ());
+  if (m_tokens >= bucket || rate == 0)
+    {
+      m_tokens = std::min (m_tokens, bucket);
+      return;
+    }
+  // compare first, elapsed * rate may overflow
+  if (elapsed >= (bucket - m_tokens) / rate + 1)
+    {
+      m_tokens = bucket;
+    }
+  else
+    {
+      m_tokens += elapsed * rate;
+    }
+}
+
+int64_t
+TokenBucketFilter::GetWait (int64_t cost)
+{
+  UpdateTokens ();
+  // a packet larger than the bucket waits for a full bucket
+  int64_t need = std::min (cost, static_cast<int64_t> (m_bucket) * NANOBITS);
+  int64_t wait = 0;
+  if (m_tokens < need)
+    {
+      int64_t rate = static_cast<int64_t> (m_rate.GetBitRate ());
+      if (rate == 0)
+        {
+          return -1;
+        }
+      wait = (need - m_tokens + rate - 1) / rate;
+    }
+  if (m_parent != 0)
+    {
+      int64_t parentWait = m_parent->GetWait (cost);
+      if (parentWait < 0)
+        {
+          return -1;
+        }
+      wait = std::max (wait, parentWait);
+    }
+  return wait;
+}
+
+void
+TokenBucketFilter::Charge (int64_t cost)
+{
+  m_tokens -= cost;
+  if (m_parent != 0)
+    {
+      m_parent->Charge (cost);
+    }
 }
 
 void
 TokenBucketFilter::Transmit (void)
 {
   NS_LOG_FUNCTION (this);
-  NS_ASSERT (!m_queue->IsEmpty ());
-  Ptr<Packet> p = m_queue->Dequeue ()->GetPacket ();
-  UpdateTokens ();
-  uint64_t packetSize = static_cast<uint64_t> (p->GetSize ()) << 3; //packet size in bits
+  int64_t slack = m_slack.GetNanoSeconds ();
+  while (!m_queue.empty ())
+    {
+      Ptr<Packet> p = m_queue.front ();
+      int64_t cost = static_cast<int64_t> (p->GetSize ()) * 8 * NANOBITS;
+      int64_t wait = GetWait (cost);
+      if (wait < 0)
+        {
+          // a rate is zero
+          return;
+        }
+      if (wait > slack)
+        {
+          m_event = Simulator::Schedule (NanoSeconds (wait), &TokenBucketFilter::Transmit, this);
+          ++m_nEvents;
+          return;
+        }
+      m_queue.pop_front ();
+      Charge (cost);
+      m_sendTarget (p);
+    }
+}
 
-  //We simply send the packet here without checking if we have enough tokens
-  //since the timer is supposed to fire at the right time
-  m_sendTarget (p);
-  m_tokens -= packetSize;
-  if(m_rate.GetBitRate () && !m_queue->IsEmpty ())
+void
+TokenBucketFilter::RescheduleAll (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_queue.empty ())
     {
-      //schedule next event
-      m_timer.Schedule (GetSendDelay (m_queue->Peek ()->GetPacket ()));
+      Reschedule ();
+    }
+  for (std::vector<TokenBucketFilter *>::iterator i = m_children.begin (); i != m_children.end (); ++i)
+    {
+      (*i)->RescheduleAll ();
     }
 }
 
-Time
-TokenBucketFilter::GetSendDelay (Ptr<const Packet> p) const
+void
+TokenBucketFilter::Reschedule (void)
 {
-  uint64_t packetSize = static_cast<uint64_t> (p->GetSize ()) << 3;
-  return Time::FromDouble (std::max (packetSize - m_tokens, 0.0) / m_rate.GetBitRate (), Time::S);
+  NS_LOG_FUNCTION (this);
+  m_event.Cancel ();
+  int64_t wait = GetWait (static_cast<int64_t> (m_queue.front ()->GetSize ()) * 8 * NANOBITS);
+  if (wait >= 0)
+    {
+      m_event = Simulator::Schedule (NanoSeconds (wait), &TokenBucketFilter::Transmit, this);
+      ++m_nEvents;
+    }
 }
 
 } //namespace dcn
 } //namespace ns3
-
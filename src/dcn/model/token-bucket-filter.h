@@ -2,12 +2,12 @@
 #define TOKEN_BUCKET_FILTER_H
 
 #include <stdint.h>
+#include <deque>
+#include <vector>
 
 #include "ns3/data-rate.h"
 #include "ns3/nstime.h"
-#include "ns3/timer.h"
-#include "ns3/queue.h"
-#include "ns3/queue-disc.h"
+#include "ns3/event-id.h"
 #include "ns3/packet.h"
 
 #include "connector.h"
@@ -20,6 +20,18 @@ namespace dcn {
  *
  * \brief implement the ns-2 TBF in ns-3
  * yet another implementation of TBF(Token Bucket filter)
+ *
+ * The tokens are counted in integer nanobits, so that a rate of R bps adds
+ * R tokens per nanosecond, and the departure time of the head packet is
+ * computed exactly in nanoseconds.  A single event releases every queued
+ * packet eligible within the Slack, which then runs a small token debt:
+ * a non-zero slack trades the precision of the departures for far fewer
+ * events, without changing the long-term rate.
+ *
+ * A filter may have a parent filter, whose bucket is shared by all its
+ * children: a packet leaves when the buckets of the filter and of all its
+ * ancestors hold enough tokens, and is charged to all of them.  The parent
+ * only provides tokens, the packets wait in the queue of the children.
  */
 class TokenBucketFilter : public Connector
 {
@@ -60,41 +72,73 @@ public:
    */
   void SetQueueLimit (uint32_t limit);
 
+  /**
+   * @brief GetParent
+   * @return the filter sharing its bucket, or 0
+   */
+  Ptr<TokenBucketFilter> GetParent (void) const;
+
+  /**
+   * @brief SetParent
+   * @param parent the filter sharing its bucket with this one
+   */
+  void SetParent (Ptr<TokenBucketFilter> parent);
+
+  /**
+   * @brief GetNEvents
+   * @return the number of events scheduled to release packets
+   */
+  uint64_t GetNEvents (void) const;
+
 protected:
 
   virtual void DoDispose (void);
 
 private:
 
-  /**
-   * \brief called when packet drop
-   * \param item droped item
-   * this is mainly used for callback
-   */
-  void Drop (Ptr<QueueItem> item);
   /**
    * \brief Update the tokens in TBF
    */
   void UpdateTokens (void);
   /**
-   * \brief get the delay time to send the packet
-   * \param p the packet to be send
-   * \return the time delay
+   * \brief get the delay until the filter and its ancestors hold tokens
+   * \param cost the tokens needed in nanobits
+   * \return the delay in nanoseconds, or -1 if a rate is zero
+   */
+  int64_t GetWait (int64_t cost);
+  /**
+   * \brief take tokens from the filter and its ancestors
+   * \param cost the tokens taken in nanobits
    */
-  Time GetSendDelay (Ptr<const Packet> p) const;
+  void Charge (int64_t cost);
   /**
-   * \brief Sending the first Packet in the queue to the sendTarget
+   * \brief Send all the packets eligible within the slack to the
+   * sendTarget and schedule the departure of the next one
    */
   void Transmit (void);
+  /**
+   * \brief schedule the next departure of a queued packet
+   */
+  void Reschedule (void);
+  /**
+   * \brief reschedule the departures of the filter and its descendants,
+   * whose tokens come at a new rate
+   */
+  void RescheduleAll (void);
 
 private:
   DataRate m_rate;
   uint64_t m_bucket;
-  double m_tokens;
+  int64_t m_tokens;            //!< tokens in nanobits
   bool m_init;
   Time m_lastUpdateTime;
-  Ptr<Queue> m_queue;
-  Timer m_timer;
+  Time m_slack;                //!< packets eligible within the slack leave together
+  std::deque<Ptr<Packet> > m_queue;
+  uint32_t m_queueLimit;
+  Ptr<TokenBucketFilter> m_parent; //!< filter sharing its bucket
+  std::vector<TokenBucketFilter *> m_children; //!< filters sharing this bucket
+  EventId m_event;             //!< next departure
+  uint64_t m_nEvents;          //!< events scheduled
 };
 
 } //namespace dcn
@@ -1,55 +1,563 @@
 /* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
 
-// Include a header file from your module to test.
-#include "ns3/dcn.h"
+#include <algorithm>
 
-// An essential include is test.h
 #include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/socket.h"
+#include "ns3/data-rate.h"
+#include "ns3/ip-l3_5-protocol-helper.h"
+#include "ns3/c3-l3_5-protocol.h"
+#include "ns3/c3-division.h"
+#include "ns3/c3-tag.h"
+#include "ns3/addcn-l3_5-protocol.h"
+#include "ns3/token-bucket-filter.h"
 
-// Do not put your test classes in namespace ns3.  You may find it useful
-// to use the using directive to access the ns3 namespace directly
 using namespace ns3;
 
-// This is an example TestCase.
-class DcnTestCase1 : public TestCase
+/**
+ * \ingroup dcn
+ * \defgroup dcn-test dcn module tests
+ */
+
+/**
+ * \ingroup dcn-test
+ * \ingroup tests
+ *
+ * \brief Check the max-min sharing of the rate of a C3 division
+ */
+class C3AllocateTestCase : public TestCase
+{
+public:
+  C3AllocateTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+C3AllocateTestCase::C3AllocateTestCase ()
+  : TestCase ("C3 max-min sharing of the rates")
+{
+}
+
+void
+C3AllocateTestCase::DoRun (void)
+{
+  std::vector<double> demands, weights, rates;
+  demands.push_back (10);
+  demands.push_back (50);
+  demands.push_back (100);
+
+  // the small demand is met, the others share the rest
+  dcn::C3Division::Allocate (90, demands, weights, rates);
+  NS_TEST_ASSERT_MSG_EQ_TOL (rates[0], 10, 1e-9, "small demand not met");
+  NS_TEST_ASSERT_MSG_EQ_TOL (rates[1], 40, 1e-9, "bad max-min share");
+  NS_TEST_ASSERT_MSG_EQ_TOL (rates[2], 40, 1e-9, "bad max-min share");
+
+  // the spare rate goes with the weights
+  weights.push_back (0);
+  weights.push_back (1);
+  weights.push_back (3);
+  dcn::C3Division::Allocate (200, demands, weights, rates);
+  NS_TEST_ASSERT_MSG_EQ_TOL (rates[0], 10, 1e-9, "bad spare share");
+  NS_TEST_ASSERT_MSG_EQ_TOL (rates[1], 60, 1e-9, "bad spare share");
+  NS_TEST_ASSERT_MSG_EQ_TOL (rates[2], 130, 1e-9, "bad spare share");
+}
+
+/**
+ * \ingroup dcn-test
+ * \ingroup tests
+ *
+ * \brief A test case sending UDP flows of 1000 byte packets tagged with
+ * their C3 information, and recording when they are received
+ */
+class DcnFlowTestCase : public TestCase
+{
+protected:
+  /**
+   * \param name the name of the test case
+   * \param flowSize the size of each flow
+   */
+  DcnFlowTestCase (std::string name, uint32_t flowSize);
+
+  /**
+   * \brief Send the packets of a flow
+   * \param socket the sending socket
+   * \param tag the C3 information of the flow
+   */
+  void SendFlow (Ptr<Socket> socket, dcn::C3Tag tag);
+  /**
+   * \brief Receive the packets of the flows
+   * \param socket the receiving socket
+   */
+  void Receive (Ptr<Socket> socket);
+
+  std::map<uint16_t, uint32_t> m_received; //!< bytes received per source port
+  std::map<uint16_t, Time> m_completion;   //!< completion time per source port
+  uint32_t m_flowSize;                     //!< size of each flow
+};
+
+DcnFlowTestCase::DcnFlowTestCase (std::string name, uint32_t flowSize)
+  : TestCase (name),
+    m_flowSize (flowSize)
+{
+}
+
+void
+DcnFlowTestCase::SendFlow (Ptr<Socket> socket, dcn::C3Tag tag)
+{
+  for (uint32_t sent = 0; sent < tag.GetFlowSize (); sent += 1000)
+    {
+      Ptr<Packet> p = Create<Packet> (1000);
+      p->AddPacketTag (tag);
+      socket->Send (p);
+    }
+}
+
+void
+DcnFlowTestCase::Receive (Ptr<Socket> socket)
+{
+  Address from;
+  Ptr<Packet> p;
+  while ((p = socket->RecvFrom (from)))
+    {
+      if (p->GetSize () < 1000)
+        {
+          // address resolution
+          continue;
+        }
+      uint16_t port = InetSocketAddress::ConvertFrom (from).GetPort ();
+      m_received[port] += p->GetSize ();
+      if (m_received[port] == m_flowSize)
+        {
+          m_completion[port] = Simulator::Now ();
+        }
+    }
+}
+
+/**
+ * \ingroup dcn-test
+ * \ingroup tests
+ *
+ * \brief Check that C3 lets a deadline flow finish before a flow without
+ * deadline sent at the same time
+ */
+class C3DeadlineTestCase : public DcnFlowTestCase
+{
+public:
+  C3DeadlineTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+C3DeadlineTestCase::C3DeadlineTestCase ()
+  : DcnFlowTestCase ("C3 deadline-aware rate allocation", 100000)
+{
+}
+
+void
+C3DeadlineTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  SimpleNetDeviceHelper devices;
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = ipv4.Assign (devices.Install (nodes));
+
+  dcn::IpL3_5ProtocolHelper c3 ("ns3::dcn::C3L3_5Protocol");
+  c3.SetAttribute ("DataRate", DataRateValue (DataRate ("10Mbps")));
+  c3.AddIpL4Protocol ("ns3::UdpL4Protocol");
+  c3.Install (nodes);
+
+  TypeId tid = TypeId::LookupByName ("ns3::UdpSocketFactory");
+  Ptr<Socket> sink = Socket::CreateSocket (nodes.Get (1), tid);
+  sink->Bind (InetSocketAddress (Ipv4Address::GetAny (), 9));
+  sink->SetRecvCallback (MakeCallback (&C3DeadlineTestCase::Receive, this));
+
+  // resolve the address before the flows start
+  Ptr<Socket> warmup = Socket::CreateSocket (nodes.Get (0), tid);
+  warmup->Connect (InetSocketAddress (interfaces.GetAddress (1), 9));
+  warmup->Send (Create<Packet> (10));
+
+  // 2 x 100 KB at 10 Mb/s: the deadline flow needs 8 Mb/s during 100 ms
+  dcn::C3Tag tag;
+  tag.SetFlowSize (m_flowSize);
+  for (uint16_t port = 1000; port <= 1001; ++port)
+    {
+      Ptr<Socket> source = Socket::CreateSocket (nodes.Get (0), tid);
+      source->SetAttribute ("RcvBufSize", UintegerValue (1000000));
+      source->Bind (InetSocketAddress (Ipv4Address::GetAny (), port));
+      source->Connect (InetSocketAddress (interfaces.GetAddress (1), 9));
+      tag.SetDeadline (port == 1000 ? MilliSeconds (100) : Time (0));
+      Simulator::Schedule (MilliSeconds (20), &C3DeadlineTestCase::SendFlow, this, source, tag);
+    }
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received[1000], m_flowSize, "deadline flow not received");
+  NS_TEST_ASSERT_MSG_EQ (m_received[1001], m_flowSize, "flow without deadline not received");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (m_completion[1000], MilliSeconds (121), "deadline missed");
+  NS_TEST_ASSERT_MSG_GT (m_completion[1001], m_completion[1000], "deadline flow not first");
+  // the rate is not wasted
+  NS_TEST_ASSERT_MSG_LT (m_completion[1001], MilliSeconds (200), "rate not used");
+  Ptr<dcn::C3L3_5Protocol> protocol = nodes.Get (0)->GetObject<dcn::C3L3_5Protocol> ();
+  NS_TEST_ASSERT_MSG_EQ (protocol->GetNFlows (), 0, "flows not removed");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup dcn-test
+ * \ingroup tests
+ *
+ * \brief Check the flat flow table of ADDCN with many flows coming and
+ * going
+ */
+class ADDCNFlowTableTestCase : public TestCase
+{
+public:
+  ADDCNFlowTableTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Send one packet to each of a number of destinations
+   * \param first the first destination
+   * \param n the number of destinations
+   */
+  void SendFlows (uint32_t first, uint32_t n);
+  /**
+   * \brief Check the flows of the table
+   * \param first the first destination
+   * \param n the number of destinations
+   */
+  void CheckFlows (uint32_t first, uint32_t n);
+
+  Ptr<dcn::ADDCNL3_5Protocol> m_protocol; //!< the protocol under test
+};
+
+ADDCNFlowTableTestCase::ADDCNFlowTableTestCase ()
+  : TestCase ("ADDCN flow table")
+{
+}
+
+void
+ADDCNFlowTableTestCase::SendFlows (uint32_t first, uint32_t n)
+{
+  dcn::C3Tag tag;
+  tag.SetFlowSize (1000);
+  for (uint32_t i = first; i < first + n; ++i)
+    {
+      for (uint8_t protocol = 6; protocol <= 17; protocol += 11)
+        {
+          Ptr<Packet> p = Create<Packet> (100);
+          p->AddPacketTag (tag);
+          m_protocol->Send (p, Ipv4Address ("10.0.0.1"), Ipv4Address (0x0b000000 + i), protocol, 0);
+        }
+    }
+}
+
+void
+ADDCNFlowTableTestCase::CheckFlows (uint32_t first, uint32_t n)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_protocol->GetNFlows (), 2 * n, "bad number of flows");
+  for (uint32_t i = first; i < first + n; ++i)
+    {
+      Ptr<dcn::ADDCNFlow> flow = m_protocol->GetFlow (Ipv4Address ("10.0.0.1"), Ipv4Address (0x0b000000 + i), 17);
+      NS_TEST_ASSERT_MSG_NE (flow, 0, "flow not found");
+      NS_TEST_ASSERT_MSG_EQ (flow->GetDestination (), Ipv4Address (0x0b000000 + i), "bad flow");
+      NS_TEST_ASSERT_MSG_NE (m_protocol->GetFlow (Ipv4Address ("10.0.0.1"), Ipv4Address (0x0b000000 + i), 6), 0,
+                             "flow not found");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_protocol->GetFlow (Ipv4Address ("10.0.0.1"), Ipv4Address (0x0b000000 + first), 1), 0,
+                         "unknown flow found");
+}
+
+void
+ADDCNFlowTableTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (1);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  dcn::IpL3_5ProtocolHelper addcn ("ns3::dcn::ADDCNL3_5Protocol");
+  addcn.SetAttribute ("FlowTimeout", TimeValue (MilliSeconds (1)));
+  addcn.AddIpL4Protocol ("ns3::UdpL4Protocol");
+  addcn.Install (nodes);
+  m_protocol = nodes.Get (0)->GetObject<dcn::ADDCNL3_5Protocol> ();
+
+  // the flows time out after a millisecond, and new ones reuse their slots
+  Simulator::Schedule (MilliSeconds (1), &ADDCNFlowTableTestCase::SendFlows, this, 0, 20000);
+  Simulator::Schedule (MilliSeconds (2), &ADDCNFlowTableTestCase::CheckFlows, this, 0, 20000);
+  Simulator::Schedule (MilliSeconds (10), &ADDCNFlowTableTestCase::CheckFlows, this, 0, 0);
+  Simulator::Schedule (MilliSeconds (11), &ADDCNFlowTableTestCase::SendFlows, this, 10000, 20000);
+  Simulator::Schedule (MilliSeconds (12), &ADDCNFlowTableTestCase::CheckFlows, this, 10000, 20000);
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_protocol->GetNFlows (), 0, "flows not removed");
+  m_protocol = 0;
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup dcn-test
+ * \ingroup tests
+ *
+ * \brief Check that ADDCN shares the rate of the host between tenants and
+ * lets a tenant meet its deadline
+ */
+class ADDCNSliceTestCase : public DcnFlowTestCase
 {
 public:
-  DcnTestCase1 ();
-  virtual ~DcnTestCase1 ();
+  ADDCNSliceTestCase ();
 
 private:
   virtual void DoRun (void);
 };
 
-// Add some help text to this case to describe what it is intended to test
-DcnTestCase1::DcnTestCase1 ()
-  : TestCase ("Dcn test case (does nothing)")
+ADDCNSliceTestCase::ADDCNSliceTestCase ()
+  : DcnFlowTestCase ("ADDCN per-tenant rate allocation", 100000)
 {
 }
 
-// This destructor does nothing but we include it as a reminder that
-// the test case should clean up after itself
-DcnTestCase1::~DcnTestCase1 ()
+void
+ADDCNSliceTestCase::DoRun (void)
 {
+  NodeContainer nodes;
+  nodes.Create (3);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  SimpleNetDeviceHelper devices;
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = ipv4.Assign (devices.Install (nodes));
+
+  dcn::IpL3_5ProtocolHelper addcn ("ns3::dcn::ADDCNL3_5Protocol");
+  addcn.SetAttribute ("DataRate", DataRateValue (DataRate ("10Mbps")));
+  addcn.AddIpL4Protocol ("ns3::UdpL4Protocol");
+  addcn.Install (nodes);
+
+  // tenant 0 sends to n1 without deadline from port 1000, tenant 1 to n2
+  // with a deadline of 100 ms from port 1001: it needs 8 Mb/s, and gets
+  // half of the spare 2 Mb/s
+  TypeId tid = TypeId::LookupByName ("ns3::UdpSocketFactory");
+  for (uint32_t i = 1; i <= 2; ++i)
+    {
+      Ptr<Socket> sink = Socket::CreateSocket (nodes.Get (i), tid);
+      sink->Bind (InetSocketAddress (Ipv4Address::GetAny (), 9));
+      sink->SetRecvCallback (MakeCallback (&ADDCNSliceTestCase::Receive, this));
+
+      Ptr<Socket> source = Socket::CreateSocket (nodes.Get (0), tid);
+      source->Bind (InetSocketAddress (Ipv4Address::GetAny (), 999 + i));
+      source->Connect (InetSocketAddress (interfaces.GetAddress (i), 9));
+      // resolve the address before the flows start
+      source->Send (Create<Packet> (10));
+
+      dcn::C3Tag tag;
+      tag.SetFlowSize (m_flowSize);
+      tag.SetDivisionId (i - 1);
+      tag.SetDeadline (i == 2 ? MilliSeconds (100) : Time (0));
+      Simulator::Schedule (MilliSeconds (20), &ADDCNSliceTestCase::SendFlow, this, source, tag);
+    }
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received[1000], m_flowSize, "flow of tenant 0 not received");
+  NS_TEST_ASSERT_MSG_EQ (m_received[1001], m_flowSize, "flow of tenant 1 not received");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (m_completion[1001], MilliSeconds (121), "deadline missed");
+  NS_TEST_ASSERT_MSG_GT (m_completion[1000], m_completion[1001], "deadline not first");
+  NS_TEST_ASSERT_MSG_LT (m_completion[1000], MilliSeconds (200), "rate not used");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup dcn-test
+ * \ingroup tests
+ *
+ * \brief Check the departures of TokenBucketFilter, exact or batched, and
+ * the sharing of a parent bucket, whose rate may drop to zero
+ */
+class TokenBucketFilterTestCase : public TestCase
+{
+public:
+  TokenBucketFilterTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Create a filter at 1 Mb/s with a bucket of 12000 bits
+   * \param slack the slack of the filter
+   * \return the filter
+   */
+  Ptr<dcn::TokenBucketFilter> CreateFilter (Time slack);
+  /**
+   * \brief Send packets of 1000 bytes to a filter
+   * \param tbf the filter
+   * \param n the number of packets
+   */
+  void SendPackets (Ptr<dcn::TokenBucketFilter> tbf, uint32_t n);
+  /**
+   * \brief Record the departure of a packet of the first filter
+   * \param p the packet
+   */
+  void DepartFirst (Ptr<Packet> p);
+  /**
+   * \brief Record the departure of a packet of the second filter
+   * \param p the packet
+   */
+  void DepartSecond (Ptr<Packet> p);
+
+  std::vector<Time> m_first;  //!< departures from the first filter
+  std::vector<Time> m_second; //!< departures from the second filter
+};
+
+TokenBucketFilterTestCase::TokenBucketFilterTestCase ()
+  : TestCase ("TokenBucketFilter departures")
+{
+}
+
+Ptr<dcn::TokenBucketFilter>
+TokenBucketFilterTestCase::CreateFilter (Time slack)
+{
+  Ptr<dcn::TokenBucketFilter> tbf = CreateObject<dcn::TokenBucketFilter> ();
+  tbf->SetAttribute ("Bucket", UintegerValue (12000));
+  tbf->SetAttribute ("Slack", TimeValue (slack));
+  tbf->SetQueueLimit (1000);
+  tbf->SetRate (DataRate ("1Mbps"));
+  return tbf;
+}
+
+void
+TokenBucketFilterTestCase::SendPackets (Ptr<dcn::TokenBucketFilter> tbf, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      tbf->Send (Create<Packet> (1000));
+    }
+}
+
+void
+TokenBucketFilterTestCase::DepartFirst (Ptr<Packet> p)
+{
+  m_first.push_back (Simulator::Now ());
+}
+
+void
+TokenBucketFilterTestCase::DepartSecond (Ptr<Packet> p)
+{
+  m_second.push_back (Simulator::Now ());
 }
 
-//
-// This method is the pure virtual method from class TestCase that every
-// TestCase must implement
-//
 void
-DcnTestCase1::DoRun (void)
+TokenBucketFilterTestCase::DoRun (void)
 {
-  // A wide variety of test macros are available in src/core/test.h
-  NS_TEST_ASSERT_MSG_EQ (true, true, "true doesn't equal true for some reason");
-  // Use this one for floating point comparisons
-  NS_TEST_ASSERT_MSG_EQ_TOL (0.01, 0.01, 0.001, "Numbers are not equal within tolerance");
+  // exact: the first packet takes 8000 of the 12000 bits of the bucket,
+  // the second waits 4 ms, and the others 8 ms each
+  Ptr<dcn::TokenBucketFilter> tbf = CreateFilter (Seconds (0));
+  tbf->SetSendTarget (MakeCallback (&TokenBucketFilterTestCase::DepartFirst, this));
+  Simulator::Schedule (MilliSeconds (1), &TokenBucketFilterTestCase::SendPackets, this, tbf, 100);
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_first.size (), 100, "packets lost");
+  NS_TEST_ASSERT_MSG_EQ (m_first[0], MilliSeconds (1), "first packet delayed");
+  NS_TEST_ASSERT_MSG_EQ (m_first[1], MilliSeconds (5), "bad departure");
+  NS_TEST_ASSERT_MSG_EQ (m_first[99], MilliSeconds (5 + 98 * 8), "bad departure");
+  NS_TEST_ASSERT_MSG_EQ (tbf->GetNEvents (), 99, "bad number of events");
+  tbf->Dispose ();
+  Simulator::Destroy ();
+
+  // batched: the packets eligible within 50 ms leave together, and the
+  // token debt keeps the rate
+  m_first.clear ();
+  tbf = CreateFilter (MilliSeconds (50));
+  tbf->SetSendTarget (MakeCallback (&TokenBucketFilterTestCase::DepartFirst, this));
+  Simulator::Schedule (MilliSeconds (1), &TokenBucketFilterTestCase::SendPackets, this, tbf, 100);
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_first.size (), 100, "packets lost");
+  NS_TEST_ASSERT_MSG_LT (tbf->GetNEvents (), 20, "departures not batched");
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (m_first[99], MilliSeconds (5 + 98 * 8 - 50), "rate exceeded");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (m_first[99], MilliSeconds (5 + 98 * 8), "rate not reached");
+  tbf->Dispose ();
+  Simulator::Destroy ();
+
+  // hierarchical: two children at 600 kb/s share the 1 Mb/s of their parent
+  m_first.clear ();
+  Ptr<dcn::TokenBucketFilter> parent = CreateFilter (Seconds (0));
+  Ptr<dcn::TokenBucketFilter> first = CreateFilter (Seconds (0));
+  Ptr<dcn::TokenBucketFilter> second = CreateFilter (Seconds (0));
+  first->SetRate (DataRate ("600kbps"));
+  second->SetRate (DataRate ("600kbps"));
+  first->SetParent (parent);
+  second->SetParent (parent);
+  first->SetSendTarget (MakeCallback (&TokenBucketFilterTestCase::DepartFirst, this));
+  second->SetSendTarget (MakeCallback (&TokenBucketFilterTestCase::DepartSecond, this));
+  Simulator::Schedule (MilliSeconds (1), &TokenBucketFilterTestCase::SendPackets, this, first, 50);
+  Simulator::Schedule (MilliSeconds (1), &TokenBucketFilterTestCase::SendPackets, this, second, 50);
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_first.size (), 50, "packets lost");
+  NS_TEST_ASSERT_MSG_EQ (m_second.size (), 50, "packets lost");
+  // the child keeps its own rate
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (m_first.back (), MilliSeconds (1 + (50 * 8000 - 12000) / 600), "child rate exceeded");
+  // and the aggregate never takes more than the tokens of the parent
+  std::vector<Time> all (m_first);
+  all.insert (all.end (), m_second.begin (), m_second.end ());
+  std::sort (all.begin (), all.end ());
+  for (int64_t i = 2; i < static_cast<int64_t> (all.size ()); ++i)
+    {
+      // one bit per microsecond at 1 Mb/s
+      NS_TEST_ASSERT_MSG_GT_OR_EQ (all[i], MilliSeconds (1) + MicroSeconds ((i + 1) * 8000 - 12000),
+                                   "parent rate exceeded");
+    }
+  NS_TEST_ASSERT_MSG_LT (all.back (), MilliSeconds (900), "parent rate not reached");
+  first->Dispose ();
+  second->Dispose ();
+  parent->Dispose ();
+  Simulator::Destroy ();
+
+  // the children wait while the parent has no rate, and resume as soon
+  // as it gets one back
+  m_first.clear ();
+  m_second.clear ();
+  parent = CreateFilter (Seconds (0));
+  first = CreateFilter (Seconds (0));
+  second = CreateFilter (Seconds (0));
+  first->SetParent (parent);
+  second->SetParent (parent);
+  parent->SetRate (DataRate (0));
+  first->SetSendTarget (MakeCallback (&TokenBucketFilterTestCase::DepartFirst, this));
+  second->SetSendTarget (MakeCallback (&TokenBucketFilterTestCase::DepartSecond, this));
+  Simulator::Schedule (MilliSeconds (1), &TokenBucketFilterTestCase::SendPackets, this, first, 20);
+  Simulator::Schedule (MilliSeconds (1), &TokenBucketFilterTestCase::SendPackets, this, second, 20);
+  Simulator::Schedule (MilliSeconds (100), &dcn::TokenBucketFilter::SetRate, parent, DataRate ("1Mbps"));
+  Simulator::Run ();
+  // the full bucket of the parent lets the first packet through
+  NS_TEST_ASSERT_MSG_EQ (m_first.size (), 20, "first child stalled");
+  NS_TEST_ASSERT_MSG_EQ (m_second.size (), 20, "second child stalled");
+  NS_TEST_ASSERT_MSG_EQ (m_first[0], MilliSeconds (1), "first packet delayed");
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (m_first[1], MilliSeconds (100), "packet sent without parent tokens");
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (m_second[0], MilliSeconds (100), "packet sent without parent tokens");
+  // the 4000 bits missing to the parent come in 4 ms
+  NS_TEST_ASSERT_MSG_EQ (std::min (m_first[1], m_second[0]), MilliSeconds (104), "children not woken by the parent rate");
+  NS_TEST_ASSERT_MSG_LT (std::max (m_first.back (), m_second.back ()), MilliSeconds (100 + 40 * 8),
+                         "parent rate not reached");
+  first->Dispose ();
+  second->Dispose ();
+  parent->Dispose ();
+  Simulator::Destroy ();
 }
 
-// The TestSuite class names the TestSuite, identifies what type of TestSuite,
-// and enables the TestCases to be run.  Typically, only the constructor for
-// this class must be defined
-//
+/**
+ * \ingroup dcn-test
+ * \ingroup tests
+ *
+ * \brief DCN TestSuite
+ */
 class DcnTestSuite : public TestSuite
 {
 public:
@@ -59,10 +567,11 @@ public:
 DcnTestSuite::DcnTestSuite ()
   : TestSuite ("dcn", UNIT)
 {
-  // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
-  AddTestCase (new DcnTestCase1, TestCase::QUICK);
+  AddTestCase (new C3AllocateTestCase, TestCase::QUICK);
+  AddTestCase (new C3DeadlineTestCase, TestCase::QUICK);
+  AddTestCase (new ADDCNFlowTableTestCase, TestCase::QUICK);
+  AddTestCase (new ADDCNSliceTestCase, TestCase::QUICK);
+  AddTestCase (new TokenBucketFilterTestCase, TestCase::QUICK);
 }
 
-// Do not forget to allocate an instance of this TestSuite
-static DcnTestSuite dcnTestSuite;
-
+static DcnTestSuite g_dcnTestSuite; //!< Static variable for test initialization
@@ -82,6 +82,10 @@ public:
    * Users must first call PopulateRoutingTables() and then may subsequently
    * call RecomputeRoutingTables() at any later time in the simulation.
    *
+   * When the GlobalRoutingSpfMode global value is Incremental, only the
+   * routers whose shortest paths changed get their routes recomputed; the
+   * others only lose their routes to the destinations which vanished.
+   *
    */
   static void RecomputeRoutingTables (void);
 private:
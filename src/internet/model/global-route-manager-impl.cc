@@ -27,6 +27,9 @@
 #include <queue>
 #include <algorithm>
 #include <iostream>
+#include <unordered_map>
+#include <functional>
+#include <iterator>
 #include "ns3/assert.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
@@ -35,6 +38,15 @@
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/mpi-interface.h"
+#include "ns3/global-value.h"
+#include "ns3/enum.h"
+#include "ns3/uinteger.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#include <unistd.h>
+#endif /* HAVE_PTHREAD_H */
 #include "global-router-interface.h"
 #include "global-route-manager-impl.h"
 #include "candidate-queue.h"
@@ -44,6 +56,32 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("GlobalRouteManagerImpl");
 
+/**
+ * \ingroup globalrouting
+ * The algorithm computing the global routes.
+ */
+static GlobalValue g_spfMode = GlobalValue
+  ("GlobalRoutingSpfMode",
+   "The algorithm computing the global routes: Legacy runs the SPF of each "
+   "router in turn on the LSDB, Parallel runs them on a compact graph of the "
+   "LSDB across worker threads, and Incremental also keeps the distances of "
+   "the routers so that RecomputeRoutingTables only computes the routers "
+   "whose shortest paths changed",
+   EnumValue (GlobalRouteManagerImpl::SPF_LEGACY),
+   MakeEnumChecker (GlobalRouteManagerImpl::SPF_LEGACY, "Legacy",
+                    GlobalRouteManagerImpl::SPF_PARALLEL, "Parallel",
+                    GlobalRouteManagerImpl::SPF_INCREMENTAL, "Incremental"));
+
+/**
+ * \ingroup globalrouting
+ * The number of worker threads of the parallel SPF.
+ */
+static GlobalValue g_spfThreads = GlobalValue
+  ("GlobalRoutingSpfThreads",
+   "The number of worker threads of the parallel SPF, 0 for one per processor",
+   UintegerValue (0),
+   MakeUintegerChecker<uint32_t> ());
+
 /**
  * \brief Stream insertion operator.
  *
@@ -531,18 +569,314 @@ GlobalRouteManagerLSDB::GetLSAByLinkData (Ipv4Address addr) const
   return 0;
 }
 
+void
+GlobalRouteManagerLSDB::GetLSAs (std::vector<GlobalRoutingLSA*>& lsas) const
+{
+  NS_LOG_FUNCTION (this);
+  for (LSDBMap_t::const_iterator i = m_database.begin (); i != m_database.end (); i++)
+    {
+      lsas.push_back (i->second);
+    }
+}
+
 // ---------------------------------------------------------------------------
 //
 // GlobalRouteManagerImpl Implementation
 //
 // ---------------------------------------------------------------------------
 
+/**
+ * \brief Compact snapshot of the LSDB used by the parallel SPF
+ *
+ * The routers and networks of the LSDB are numbered in the order of their
+ * link state ID, and their links are stored in compressed sparse rows along
+ * with everything SPFNexthopCalculation () needs to know about them, so that
+ * the SPF of each router can run on a worker thread without touching the
+ * nodes, the LSAs or any reference count.
+ */
+struct GlobalRouteManagerImpl::SpfGraph
+{
+  static const uint32_t NONE = 0xffffffff; //!< No vertex
+
+  /// Kind of route
+  enum RouteType
+  {
+    HOST,     //!< Host route, see SPFIntraAddRouter ()
+    NETWORK,  //!< Network route, see SPFIntraAddTransit () and SPFIntraAddStub ()
+    EXTERNAL  //!< External route, see SPFAddASExternal ()
+  };
+
+  /// Kind of root, see CheckForStubNode ()
+  enum RootType
+  {
+    ROOT_SPF,     //!< The SPF of the router is run
+    ROOT_DEFAULT, //!< Stub router, a default route is installed
+    ROOT_NONE     //!< Router without transit link, no route is installed
+  };
+
+  /// Destination of a route
+  struct Dest
+  {
+    uint32_t type; //!< RouteType
+    uint32_t dest; //!< Destination host or network
+    uint32_t mask; //!< Destination mask
+    /**
+     * \param o the other destination
+     * \returns true if this destination sorts before the other
+     */
+    bool operator< (const Dest& o) const
+    {
+      return type < o.type || (type == o.type && (dest < o.dest || (dest == o.dest && mask < o.mask)));
+    }
+    /**
+     * \param o the other destination
+     * \returns true if the destinations are equal
+     */
+    bool operator== (const Dest& o) const
+    {
+      return type == o.type && dest == o.dest && mask == o.mask;
+    }
+  };
+
+  /// Link from a vertex
+  struct Edge
+  {
+    uint32_t to;      //!< Destination vertex
+    uint32_t metric;  //!< Metric of the link, zero from a network
+    uint32_t nextHop; //!< Address of the other end, see SPFNexthopCalculation ()
+    int32_t outIf;    //!< Interface of the router on the link; -1 if unknown, or
+                      //!< if a network has no link record back from the router
+  };
+
+  /// Router having routes installed
+  struct Root
+  {
+    uint32_t vertex;                 //!< Vertex of the router
+    RootType type;                   //!< Kind of root
+    uint32_t nextHop;                //!< Next hop of the default route
+    int32_t outIf;                   //!< Interface of the default route
+    Ptr<Ipv4GlobalRouting> routing;  //!< Routing protocol of the router
+  };
+
+  /// External destination
+  struct External
+  {
+    uint32_t vertex; //!< Advertising router, or NONE
+    Dest dest;       //!< Destination
+  };
+
+  /// Route computed by a worker
+  struct Route
+  {
+    Dest dest;        //!< Destination
+    uint32_t nextHop; //!< Next hop
+    int32_t outIf;    //!< Outgoing interface
+  };
+
+  /// SPF of a root
+  struct Job
+  {
+    uint32_t root;              //!< Index of the root
+    std::vector<Route> routes;  //!< Routes, in the order SPFCalculate () installs them
+    std::vector<uint32_t> dist; //!< Distances from the root, if kept
+  };
+
+  /// Exit from the root: next hop and outgoing interface
+  typedef std::pair<uint32_t, int32_t> Exit;
+
+  /// Candidate of the priority queue
+  struct Candidate
+  {
+    uint32_t dist;   //!< Distance from the root
+    uint32_t router; //!< 1 for routers, which come after networks at equal distance
+    uint32_t seq;    //!< Push order, so that equal candidates come in FIFO order
+    uint32_t vertex; //!< Vertex
+    /**
+     * \param o the other candidate
+     * \returns true if this candidate comes after the other
+     */
+    bool operator> (const Candidate& o) const
+    {
+      return dist > o.dist || (dist == o.dist && (router > o.router || (router == o.router && seq > o.seq)));
+    }
+  };
+
+  /// Per-worker state of the SPF, reused from one root to the next
+  struct Scratch
+  {
+    std::vector<uint32_t> dist;                //!< Distance from the root
+    std::vector<uint8_t> state;                //!< GlobalRoutingLSA::SPFStatus
+    std::vector<uint32_t> seq;                 //!< Sequence of the valid candidate
+    std::vector<std::vector<Exit> > exits;     //!< Exits from the root
+    std::vector<std::vector<uint32_t> > parents; //!< Parents in the SPF tree
+    std::vector<Candidate> queue;              //!< Candidate heap
+    std::vector<std::pair<uint32_t, uint32_t> > links; //!< Parent and child, in pop order
+    std::vector<uint32_t> childStart;          //!< Children rows
+    std::vector<uint32_t> children;            //!< Children of each vertex, in pop order
+    std::vector<std::pair<uint32_t, uint32_t> > stack; //!< Depth-first walk of the tree
+    std::vector<Exit> tmp;                     //!< Exits of an equal-cost path
+  };
+
+  /// Worker thread running the SPF of some roots
+  struct Worker
+  {
+    const SpfGraph* graph;    //!< The graph
+    bool keepDist;            //!< Whether to keep the distances
+    std::vector<Job*> jobs;   //!< The roots to compute
+    Scratch scratch;          //!< The SPF state
+    /// Run the SPF of every job
+    void Run (void)
+    {
+      for (uint32_t i = 0; i < jobs.size (); i++)
+        {
+          graph->Calculate (*jobs[i], scratch, keepDist);
+        }
+    }
+  };
+
+  /// Link of the graph with the link state IDs of its ends, for diffs
+  struct EdgeKey
+  {
+    uint32_t from;    //!< Link state ID of the origin
+    uint32_t to;      //!< Link state ID of the destination
+    uint32_t metric;  //!< Metric
+    uint32_t nextHop; //!< Next hop
+    int32_t outIf;    //!< Interface
+    /**
+     * \param o the other link
+     * \returns true if this link sorts before the other
+     */
+    bool operator< (const EdgeKey& o) const
+    {
+      if (from != o.from)
+        {
+          return from < o.from;
+        }
+      if (to != o.to)
+        {
+          return to < o.to;
+        }
+      if (metric != o.metric)
+        {
+          return metric < o.metric;
+        }
+      if (nextHop != o.nextHop)
+        {
+          return nextHop < o.nextHop;
+        }
+      return outIf < o.outIf;
+    }
+  };
+
+  /// Destination of the graph with the link state ID of its vertex, for diffs
+  struct DestKey
+  {
+    uint32_t vertex; //!< Link state ID of the vertex
+    Dest dest;       //!< Destination
+    /**
+     * \param o the other destination
+     * \returns true if this destination sorts before the other
+     */
+    bool operator< (const DestKey& o) const
+    {
+      return vertex < o.vertex || (vertex == o.vertex && dest < o.dest);
+    }
+  };
+
+  std::vector<uint32_t> id;           //!< Link state ID of each vertex
+  std::vector<uint8_t> network;       //!< Whether each vertex is a network
+  std::unordered_map<uint32_t, uint32_t> index; //!< Vertex of each link state ID
+  std::vector<uint32_t> edgeStart;    //!< Row of each vertex in edges
+  std::vector<Edge> edges;            //!< Links of the vertices
+  std::vector<uint32_t> intraStart;   //!< Row of each vertex in intra
+  std::vector<Dest> intra;            //!< Destinations installed when a vertex joins the tree
+  std::vector<uint32_t> stubStart;    //!< Row of each vertex in stubs
+  std::vector<Dest> stubs;            //!< Stub networks of the routers
+  std::vector<External> externals;    //!< External destinations
+  std::vector<Root> roots;            //!< Routers having routes installed
+  std::vector<uint32_t> edgeFrom;     //!< Origin of each link, see BuildInEdges ()
+  std::vector<uint32_t> inStart;      //!< Row of each vertex in inEdges
+  std::vector<uint32_t> inEdges;      //!< Links to the vertices
+
+  /**
+   * \brief Run the SPF of a root, see SPFCalculate ()
+   * \param job the job
+   * \param s the state of the SPF
+   * \param keepDist whether to keep the distances in the job
+   */
+  void Calculate (Job& job, Scratch& s, bool keepDist) const;
+
+  /**
+   * \brief Compute the exits of a vertex reached through a link, see
+   * SPFNexthopCalculation ()
+   * \param r the root
+   * \param v the parent
+   * \param e the link from the parent
+   * \param s the state of the SPF
+   * \param exits the exits
+   */
+  void NextHops (uint32_t r, uint32_t v, const Edge& e, const Scratch& s,
+                 std::vector<Exit>& exits) const;
+
+  /**
+   * \brief Add the routes to some destinations through some exits
+   * \param begin the first destination
+   * \param end past the last destination
+   * \param exits the exits
+   * \param routes the routes
+   */
+  static void AddRoutes (const Dest* begin, const Dest* end,
+                         const std::vector<Exit>& exits, std::vector<Route>& routes);
+
+  /**
+   * \brief Index the links by destination
+   */
+  void BuildInEdges (void);
+
+  /**
+   * \brief Find the exits of a vertex from the distances of a root
+   *
+   * This walks the shortest-path DAG back from the vertex, merging the exits
+   * of the paths the way Calculate () does.  BuildInEdges () must have been
+   * called.
+   *
+   * \param r the root
+   * \param y the vertex
+   * \param dist the distances from the root
+   * \param memo the exits found so far
+   * \returns the exits of the vertex
+   */
+  const std::vector<Exit>& ExitsOf (uint32_t r, uint32_t y, const std::vector<uint32_t>& dist,
+                                    std::unordered_map<uint32_t, std::vector<Exit> >& memo) const;
+
+  /**
+   * \param keys the sorted links of the graph
+   */
+  void GetEdgeKeys (std::vector<EdgeKey>& keys) const;
+
+  /**
+   * \param keys the sorted destinations of the graph
+   */
+  void GetDestKeys (std::vector<DestKey>& keys) const;
+};
+
+const uint32_t GlobalRouteManagerImpl::SpfGraph::NONE;
+
+/// Graph and distances of each root, kept by SPF_INCREMENTAL
+struct GlobalRouteManagerImpl::SpfState
+{
+  SpfGraph graph;                           //!< The graph
+  std::vector<std::vector<uint32_t> > dist; //!< Distances from each root
+};
+
 GlobalRouteManagerImpl::GlobalRouteManagerImpl () 
   :
-    m_spfroot (0)
+    m_spfroot (0),
+    m_spfState (0)
 {
   NS_LOG_FUNCTION (this);
   m_lsdb = new GlobalRouteManagerLSDB ();
+  m_spfSummary = SpfSummary ();
 }
 
 GlobalRouteManagerImpl::~GlobalRouteManagerImpl ()
@@ -552,6 +886,7 @@ GlobalRouteManagerImpl::~GlobalRouteManagerImpl ()
     {
       delete m_lsdb;
     }
+  delete m_spfState;
 }
 
 void
@@ -592,6 +927,8 @@ GlobalRouteManagerImpl::DeleteGlobalRoutes ()
         }
       NS_LOG_LOGIC ("Deleted " << j << " global routes from node "<< node->GetId ());
     }
+  delete m_spfState;
+  m_spfState = 0;
   if (m_lsdb)
     {
       NS_LOG_LOGIC ("Deleting LSDB, creating new one");
@@ -696,6 +1033,11 @@ void
 GlobalRouteManagerImpl::InitializeRoutes ()
 {
   NS_LOG_FUNCTION (this);
+  if (GetSpfMode () != SPF_LEGACY)
+    {
+      ParallelInitializeRoutes ();
+      return;
+    }
 //
 // Walk the list of nodes in the system.
 //
@@ -712,8 +1054,9 @@ GlobalRouteManagerImpl::InitializeRoutes ()
         node->GetObject<GlobalRouter> ();
 
       uint32_t systemId = MpiInterface::GetSystemId ();
-      // Ignore nodes that are not assigned to our systemId (distributed sim)
-      if (node->GetSystemId () != systemId) 
+      // Ignore nodes that are not assigned to our systemId (distributed sim),
+      // unless all the systems share this process
+      if (!MpiInterface::IsSharedMemory () && node->GetSystemId () != systemId) 
         {
           continue;
         }
@@ -2203,6 +2546,954 @@ GlobalRouteManagerImpl::SPFVertexAddParent (SPFVertex* v)
     }
 }
 
+// ---------------------------------------------------------------------------
+//
+// Parallel and incremental SPF
+//
+// ---------------------------------------------------------------------------
+
+void
+GlobalRouteManagerImpl::SpfGraph::AddRoutes (const Dest* begin, const Dest* end,
+                                             const std::vector<Exit>& exits,
+                                             std::vector<Route>& routes)
+{
+  for (const Dest* d = begin; d != end; d++)
+    {
+      for (uint32_t i = 0; i < exits.size (); i++)
+        {
+          if (exits[i].second >= 0)
+            {
+              Route route;
+              route.dest = *d;
+              route.nextHop = exits[i].first;
+              route.outIf = exits[i].second;
+              routes.push_back (route);
+            }
+        }
+    }
+}
+
+void
+GlobalRouteManagerImpl::SpfGraph::NextHops (uint32_t r, uint32_t v, const Edge& e,
+                                            const Scratch& s, std::vector<Exit>& exits) const
+{
+  exits.clear ();
+  if (v == r)
+    {
+      // Link off the root: the next hop is the address of the neighbor
+      // router on the link, or none for a directly connected network
+      exits.push_back (Exit (e.nextHop, e.outIf));
+    }
+  else if (network[v] && s.parents[v][0] == r)
+    {
+      // Router on a network directly connected to the root
+      if (e.outIf >= 0 && !s.exits[v].empty ())
+        {
+          exits.push_back (Exit (e.nextHop, s.exits[v][0].second));
+        }
+    }
+  else
+    {
+      exits = s.exits[v];
+    }
+}
+
+void
+GlobalRouteManagerImpl::SpfGraph::Calculate (Job& job, Scratch& s, bool keepDist) const
+{
+  const Root& root = roots[job.root];
+  job.routes.clear ();
+  job.dist.clear ();
+  if (root.type == ROOT_DEFAULT)
+    {
+      Route route;
+      route.dest.type = NETWORK;
+      route.dest.dest = 0;
+      route.dest.mask = 0;
+      route.nextHop = root.nextHop;
+      route.outIf = root.outIf;
+      job.routes.push_back (route);
+    }
+  if (root.type != ROOT_SPF)
+    {
+      return;
+    }
+
+  uint32_t n = id.size ();
+  s.dist.assign (n, SPF_INFINITY);
+  s.state.assign (n, GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED);
+  s.seq.assign (n, 0);
+  s.exits.resize (n);
+  s.parents.resize (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      s.exits[i].clear ();
+      s.parents[i].clear ();
+    }
+  s.queue.clear ();
+  s.links.clear ();
+
+  uint32_t r = root.vertex;
+  uint32_t seq = 0;
+  s.dist[r] = 0;
+  s.state[r] = GlobalRoutingLSA::LSA_SPF_IN_SPFTREE;
+  uint32_t v = r;
+  for (;;)
+    {
+      // RFC2328 16.1. (2), see SPFNext ()
+      for (uint32_t i = edgeStart[v]; i < edgeStart[v + 1]; i++)
+        {
+          const Edge& e = edges[i];
+          uint32_t w = e.to;
+          if (s.state[w] == GlobalRoutingLSA::LSA_SPF_IN_SPFTREE)
+            {
+              continue;
+            }
+          uint32_t distance = s.dist[v] + e.metric;
+          if (s.state[w] == GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED || distance < s.dist[w])
+            {
+              NextHops (r, v, e, s, s.exits[w]);
+              s.dist[w] = distance;
+              s.parents[w].assign (1, v);
+              s.state[w] = GlobalRoutingLSA::LSA_SPF_CANDIDATE;
+              Candidate c;
+              c.dist = distance;
+              c.router = network[w] ? 0 : 1;
+              c.seq = seq;
+              c.vertex = w;
+              s.seq[w] = seq++;
+              s.queue.push_back (c);
+              std::push_heap (s.queue.begin (), s.queue.end (), std::greater<Candidate> ());
+            }
+          else if (distance == s.dist[w])
+            {
+              // Equal-cost paths, see SPFVertex::MergeRootExitDirections ()
+              NextHops (r, v, e, s, s.tmp);
+              std::vector<Exit>& exits = s.exits[w];
+              exits.insert (exits.end (), s.tmp.begin (), s.tmp.end ());
+              std::sort (exits.begin (), exits.end ());
+              exits.erase (std::unique (exits.begin (), exits.end ()), exits.end ());
+              if (std::find (s.parents[w].begin (), s.parents[w].end (), v) == s.parents[w].end ())
+                {
+                  s.parents[w].push_back (v);
+                }
+            }
+        }
+      // RFC2328 16.1. (3), the candidates whose distance dropped since
+      // they were queued are skipped
+      bool found = false;
+      while (!s.queue.empty ())
+        {
+          std::pop_heap (s.queue.begin (), s.queue.end (), std::greater<Candidate> ());
+          Candidate c = s.queue.back ();
+          s.queue.pop_back ();
+          if (s.state[c.vertex] == GlobalRoutingLSA::LSA_SPF_CANDIDATE && s.seq[c.vertex] == c.seq)
+            {
+              v = c.vertex;
+              found = true;
+              break;
+            }
+        }
+      if (!found)
+        {
+          break;
+        }
+      s.state[v] = GlobalRoutingLSA::LSA_SPF_IN_SPFTREE;
+      for (uint32_t i = 0; i < s.parents[v].size (); i++)
+        {
+          s.links.push_back (std::make_pair (s.parents[v][i], v));
+        }
+      // RFC2328 16.1. (4)
+      AddRoutes (intra.data () + intraStart[v], intra.data () + intraStart[v + 1], s.exits[v], job.routes);
+    }
+
+  // Second stage: the stubs, walking the tree depth first like
+  // SPFProcessStubs () does
+  s.childStart.assign (n + 1, 0);
+  for (uint32_t i = 0; i < s.links.size (); i++)
+    {
+      s.childStart[s.links[i].first + 1]++;
+    }
+  for (uint32_t i = 0; i < n; i++)
+    {
+      s.childStart[i + 1] += s.childStart[i];
+    }
+  s.children.resize (s.links.size ());
+  s.seq.assign (s.childStart.begin (), s.childStart.end () - 1);
+  for (uint32_t i = 0; i < s.links.size (); i++)
+    {
+      s.children[s.seq[s.links[i].first]++] = s.links[i].second;
+    }
+  s.stack.clear ();
+  s.stack.push_back (std::make_pair (r, s.childStart[r]));
+  s.state[r] = GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED;
+  while (!s.stack.empty ())
+    {
+      uint32_t top = s.stack.back ().first;
+      uint32_t next = s.stack.back ().second;
+      if (next == s.childStart[top + 1])
+        {
+          s.stack.pop_back ();
+          continue;
+        }
+      s.stack.back ().second++;
+      uint32_t c = s.children[next];
+      if (s.state[c] != GlobalRoutingLSA::LSA_SPF_IN_SPFTREE)
+        {
+          continue;
+        }
+      // Reuse the status to mark the processed vertices
+      s.state[c] = GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED;
+      AddRoutes (stubs.data () + stubStart[c], stubs.data () + stubStart[c + 1], s.exits[c], job.routes);
+      s.stack.push_back (std::make_pair (c, s.childStart[c]));
+    }
+
+  // External routes through the advertising routers
+  for (uint32_t i = 0; i < externals.size (); i++)
+    {
+      uint32_t a = externals[i].vertex;
+      if (a != NONE && a != r && s.dist[a] != SPF_INFINITY)
+        {
+          AddRoutes (&externals[i].dest, &externals[i].dest + 1, s.exits[a], job.routes);
+        }
+    }
+  if (keepDist)
+    {
+      job.dist = s.dist;
+    }
+}
+
+void
+GlobalRouteManagerImpl::SpfGraph::BuildInEdges (void)
+{
+  uint32_t n = id.size ();
+  edgeFrom.resize (edges.size ());
+  inStart.assign (n + 1, 0);
+  for (uint32_t v = 0; v < n; v++)
+    {
+      for (uint32_t i = edgeStart[v]; i < edgeStart[v + 1]; i++)
+        {
+          edgeFrom[i] = v;
+          inStart[edges[i].to + 1]++;
+        }
+    }
+  for (uint32_t v = 0; v < n; v++)
+    {
+      inStart[v + 1] += inStart[v];
+    }
+  std::vector<uint32_t> next (inStart.begin (), inStart.end () - 1);
+  inEdges.resize (edges.size ());
+  for (uint32_t i = 0; i < edges.size (); i++)
+    {
+      inEdges[next[edges[i].to]++] = i;
+    }
+}
+
+const std::vector<GlobalRouteManagerImpl::SpfGraph::Exit>&
+GlobalRouteManagerImpl::SpfGraph::ExitsOf (uint32_t r, uint32_t y, const std::vector<uint32_t>& dist,
+                                           std::unordered_map<uint32_t, std::vector<Exit> >& memo) const
+{
+  std::unordered_map<uint32_t, std::vector<Exit> >::iterator it = memo.find (y);
+  if (it != memo.end ())
+    {
+      return it->second;
+    }
+  // Inserted first, so that links of null metric cannot loop
+  std::vector<Exit>& exits = memo[y];
+  std::vector<Exit> merged, hops;
+  uint32_t paths = 0;
+  for (uint32_t i = inStart[y]; i < inStart[y + 1]; i++)
+    {
+      const Edge& e = edges[inEdges[i]];
+      uint32_t u = edgeFrom[inEdges[i]];
+      if (dist[u] == SPF_INFINITY || static_cast<uint64_t> (dist[u]) + e.metric != dist[y])
+        {
+          continue;
+        }
+      hops.clear ();
+      bool rootParent = false;
+      if (u != r && network[u])
+        {
+          for (uint32_t j = edgeStart[r]; j < edgeStart[r + 1]; j++)
+            {
+              rootParent = rootParent || (edges[j].to == u && edges[j].metric == dist[u]);
+            }
+        }
+      if (u == r)
+        {
+          hops.push_back (Exit (e.nextHop, e.outIf));
+        }
+      else if (rootParent)
+        {
+          const std::vector<Exit>& parent = ExitsOf (r, u, dist, memo);
+          if (e.outIf >= 0 && !parent.empty ())
+            {
+              hops.push_back (Exit (e.nextHop, parent[0].second));
+            }
+        }
+      else
+        {
+          hops = ExitsOf (r, u, dist, memo);
+        }
+      if (paths++ == 0)
+        {
+          merged = hops;
+        }
+      else
+        {
+          merged.insert (merged.end (), hops.begin (), hops.end ());
+          std::sort (merged.begin (), merged.end ());
+          merged.erase (std::unique (merged.begin (), merged.end ()), merged.end ());
+        }
+    }
+  exits = merged;
+  return exits;
+}
+
+void
+GlobalRouteManagerImpl::SpfGraph::GetEdgeKeys (std::vector<EdgeKey>& keys) const
+{
+  for (uint32_t v = 0; v < id.size (); v++)
+    {
+      for (uint32_t i = edgeStart[v]; i < edgeStart[v + 1]; i++)
+        {
+          EdgeKey key;
+          key.from = id[v];
+          key.to = id[edges[i].to];
+          key.metric = edges[i].metric;
+          key.nextHop = edges[i].nextHop;
+          key.outIf = edges[i].outIf;
+          keys.push_back (key);
+        }
+    }
+  std::sort (keys.begin (), keys.end ());
+}
+
+void
+GlobalRouteManagerImpl::SpfGraph::GetDestKeys (std::vector<DestKey>& keys) const
+{
+  for (uint32_t v = 0; v < id.size (); v++)
+    {
+      DestKey key;
+      key.vertex = id[v];
+      for (uint32_t i = intraStart[v]; i < intraStart[v + 1]; i++)
+        {
+          key.dest = intra[i];
+          keys.push_back (key);
+        }
+      for (uint32_t i = stubStart[v]; i < stubStart[v + 1]; i++)
+        {
+          key.dest = stubs[i];
+          keys.push_back (key);
+        }
+    }
+  for (uint32_t i = 0; i < externals.size (); i++)
+    {
+      if (externals[i].vertex != NONE)
+        {
+          DestKey key;
+          key.vertex = id[externals[i].vertex];
+          key.dest = externals[i].dest;
+          keys.push_back (key);
+        }
+    }
+  std::sort (keys.begin (), keys.end ());
+}
+
+GlobalRouteManagerImpl::SpfMode
+GlobalRouteManagerImpl::GetSpfMode (void)
+{
+  EnumValue mode;
+  g_spfMode.GetValue (mode);
+  return static_cast<SpfMode> (mode.Get ());
+}
+
+const GlobalRouteManagerImpl::SpfSummary&
+GlobalRouteManagerImpl::GetSpfSummary (void) const
+{
+  return m_spfSummary;
+}
+
+void
+GlobalRouteManagerImpl::LogSpfSummary (void) const
+{
+  NS_LOG_INFO ("SPF of " << m_spfSummary.computed << " of " << m_spfSummary.roots <<
+               " routers (" << m_spfSummary.patched << " pruned) on " <<
+               m_spfSummary.vertices << " vertices with " << m_spfSummary.threads <<
+               " threads: graph " << m_spfSummary.graphMs << " ms, spf " <<
+               m_spfSummary.spfMs << " ms, install " << m_spfSummary.installMs << " ms");
+}
+
+void
+GlobalRouteManagerImpl::BuildSpfGraph (SpfGraph& graph)
+{
+  NS_LOG_FUNCTION (this);
+  std::vector<GlobalRoutingLSA*> lsas;
+  m_lsdb->GetLSAs (lsas);
+  uint32_t n = lsas.size ();
+//
+// Number the vertices, and index the routers by the addresses they have on
+// transit networks for GetLSAByLinkData ()
+//
+  std::unordered_map<uint32_t, uint32_t> byLinkData;
+  graph.id.resize (n);
+  graph.network.resize (n);
+  for (uint32_t v = 0; v < n; v++)
+    {
+      graph.id[v] = lsas[v]->GetLinkStateId ().Get ();
+      graph.network[v] = lsas[v]->GetLSType () == GlobalRoutingLSA::NetworkLSA;
+      graph.index[graph.id[v]] = v;
+      for (uint32_t j = 0; j < lsas[v]->GetNLinkRecords (); j++)
+        {
+          GlobalRoutingLinkRecord *lr = lsas[v]->GetLinkRecord (j);
+          if (lr->GetLinkType () == GlobalRoutingLinkRecord::TransitNetwork)
+            {
+              byLinkData.insert (std::make_pair (lr->GetLinkData ().Get (), v));
+            }
+        }
+    }
+
+  graph.edgeStart.push_back (0);
+  graph.intraStart.push_back (0);
+  graph.stubStart.push_back (0);
+  for (uint32_t v = 0; v < n; v++)
+    {
+      GlobalRoutingLSA *lsa = lsas[v];
+      if (graph.network[v])
+        {
+          Ipv4Mask mask = lsa->GetNetworkLSANetworkMask ();
+          SpfGraph::Dest dest;
+          dest.type = SpfGraph::NETWORK;
+          dest.dest = lsa->GetLinkStateId ().CombineMask (mask).Get ();
+          dest.mask = mask.Get ();
+          graph.intra.push_back (dest);
+          for (uint32_t i = 0; i < lsa->GetNAttachedRouters (); i++)
+            {
+              std::unordered_map<uint32_t, uint32_t>::const_iterator it =
+                byLinkData.find (lsa->GetAttachedRouter (i).Get ());
+              if (it == byLinkData.end ())
+                {
+                  continue;
+                }
+              SpfGraph::Edge e;
+              e.to = it->second;
+              e.metric = 0;
+              e.nextHop = 0;
+              e.outIf = -1;
+              // The address of the router on the network, should it be
+              // directly connected to the root
+              GlobalRoutingLSA *wlsa = lsas[e.to];
+              for (uint32_t j = 0; j < wlsa->GetNLinkRecords (); j++)
+                {
+                  GlobalRoutingLinkRecord *lr = wlsa->GetLinkRecord (j);
+                  if (lr->GetLinkId () == lsa->GetLinkStateId ())
+                    {
+                      e.nextHop = lr->GetLinkData ().Get ();
+                      e.outIf = 0;
+                    }
+                }
+              graph.edges.push_back (e);
+            }
+        }
+      else
+        {
+          Ptr<Ipv4> ipv4;
+          if (lsa->GetNode ())
+            {
+              ipv4 = lsa->GetNode ()->GetObject<Ipv4> ();
+            }
+          for (uint32_t j = 0; j < lsa->GetNLinkRecords (); j++)
+            {
+              GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (j);
+              if (lr->GetLinkType () == GlobalRoutingLinkRecord::StubNetwork)
+                {
+                  Ipv4Mask mask (lr->GetLinkData ().Get ());
+                  SpfGraph::Dest dest;
+                  dest.type = SpfGraph::NETWORK;
+                  dest.dest = lr->GetLinkId ().CombineMask (mask).Get ();
+                  dest.mask = mask.Get ();
+                  graph.stubs.push_back (dest);
+                  continue;
+                }
+              if (lr->GetLinkType () == GlobalRoutingLinkRecord::PointToPoint)
+                {
+                  SpfGraph::Dest dest;
+                  dest.type = SpfGraph::HOST;
+                  dest.dest = lr->GetLinkData ().Get ();
+                  dest.mask = Ipv4Mask::GetOnes ().Get ();
+                  graph.intra.push_back (dest);
+                }
+              std::unordered_map<uint32_t, uint32_t>::const_iterator it =
+                graph.index.find (lr->GetLinkId ().Get ());
+              NS_ASSERT_MSG (it != graph.index.end (), "No LSA for link " << lr->GetLinkId ());
+              if (it == graph.index.end ())
+                {
+                  continue;
+                }
+              SpfGraph::Edge e;
+              e.to = it->second;
+              e.metric = lr->GetMetric ();
+              e.nextHop = 0;
+              e.outIf = -1;
+              GlobalRoutingLSA *wlsa = lsas[e.to];
+              if (lr->GetLinkType () == GlobalRoutingLinkRecord::PointToPoint)
+                {
+                  // The address of the neighbor on the link, see SPFGetNextLink ()
+                  for (uint32_t k = 0; k < wlsa->GetNLinkRecords (); k++)
+                    {
+                      GlobalRoutingLinkRecord *remote = wlsa->GetLinkRecord (k);
+                      if (remote->GetLinkId () == lsa->GetLinkStateId ())
+                        {
+                          e.nextHop = remote->GetLinkData ().Get ();
+                          break;
+                        }
+                    }
+                  if (ipv4)
+                    {
+                      e.outIf = ipv4->GetInterfaceForPrefix (lr->GetLinkData (), Ipv4Mask::GetOnes ());
+                    }
+                }
+              else if (ipv4)
+                {
+                  e.outIf = ipv4->GetInterfaceForPrefix (wlsa->GetLinkStateId (),
+                                                         wlsa->GetNetworkLSANetworkMask ());
+                }
+              graph.edges.push_back (e);
+            }
+        }
+      graph.edgeStart.push_back (graph.edges.size ());
+      graph.intraStart.push_back (graph.intra.size ());
+      graph.stubStart.push_back (graph.stubs.size ());
+    }
+
+  for (uint32_t i = 0; i < m_lsdb->GetNumExtLSAs (); i++)
+    {
+      GlobalRoutingLSA *extlsa = m_lsdb->GetExtLSA (i);
+      SpfGraph::External ext;
+      std::unordered_map<uint32_t, uint32_t>::const_iterator it =
+        graph.index.find (extlsa->GetAdvertisingRouter ().Get ());
+      ext.vertex = (it != graph.index.end () && !graph.network[it->second]) ? it->second : SpfGraph::NONE;
+      Ipv4Mask mask = extlsa->GetNetworkLSANetworkMask ();
+      ext.dest.type = SpfGraph::EXTERNAL;
+      ext.dest.dest = extlsa->GetLinkStateId ().CombineMask (mask).Get ();
+      ext.dest.mask = mask.Get ();
+      graph.externals.push_back (ext);
+    }
+
+//
+// The routers having routes installed, as in InitializeRoutes (), and
+// whether they are stubs, as in CheckForStubNode ()
+//
+  uint32_t systemId = MpiInterface::GetSystemId ();
+  NodeList::Iterator listEnd = NodeList::End ();
+  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
+    {
+      Ptr<Node> node = *i;
+      Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter> ();
+      if (!MpiInterface::IsSharedMemory () && node->GetSystemId () != systemId)
+        {
+          continue;
+        }
+      if (!rtr || rtr->GetNumLSAs () == 0)
+        {
+          continue;
+        }
+      std::unordered_map<uint32_t, uint32_t>::const_iterator it =
+        graph.index.find (rtr->GetRouterId ().Get ());
+      if (it == graph.index.end ())
+        {
+          continue;
+        }
+      SpfGraph::Root root;
+      root.vertex = it->second;
+      root.type = SpfGraph::ROOT_SPF;
+      root.nextHop = 0;
+      root.outIf = -1;
+      root.routing = rtr->GetRoutingProtocol ();
+
+      GlobalRoutingLSA *rlsa = lsas[root.vertex];
+      uint32_t transits = 0;
+      GlobalRoutingLinkRecord *transitLink = 0;
+      for (uint32_t j = 0; j < rlsa->GetNLinkRecords (); j++)
+        {
+          GlobalRoutingLinkRecord *l = rlsa->GetLinkRecord (j);
+          if (l->GetLinkType () == GlobalRoutingLinkRecord::TransitNetwork
+              || l->GetLinkType () == GlobalRoutingLinkRecord::PointToPoint)
+            {
+              transits++;
+              transitLink = l;
+            }
+        }
+      if (transits == 0)
+        {
+          NS_LOG_WARN ("all nodes should have at least one transit link:" << rtr->GetRouterId ());
+          root.type = SpfGraph::ROOT_NONE;
+        }
+      else if (transits == 1 && transitLink->GetLinkType () == GlobalRoutingLinkRecord::PointToPoint)
+        {
+          GlobalRoutingLSA *wlsa = m_lsdb->GetLSA (transitLink->GetLinkId ());
+          for (uint32_t j = 0; wlsa && j < wlsa->GetNLinkRecords (); j++)
+            {
+              GlobalRoutingLinkRecord *lr = wlsa->GetLinkRecord (j);
+              if (lr->GetLinkType () == GlobalRoutingLinkRecord::PointToPoint
+                  && lr->GetLinkId () == rlsa->GetLinkStateId ())
+                {
+                  root.type = SpfGraph::ROOT_DEFAULT;
+                  root.nextHop = lr->GetLinkData ().Get ();
+                  root.outIf = node->GetObject<Ipv4> ()->GetInterfaceForPrefix (transitLink->GetLinkData (),
+                                                                                 Ipv4Mask::GetOnes ());
+                  break;
+                }
+            }
+        }
+      graph.roots.push_back (root);
+    }
+}
+
+void
+GlobalRouteManagerImpl::SpfRunRoots (const SpfGraph& graph, const std::vector<uint32_t>& roots,
+                                     bool clear, std::vector<std::vector<uint32_t> >* dist)
+{
+  NS_LOG_FUNCTION (this << roots.size () << clear);
+  UintegerValue value;
+  g_spfThreads.GetValue (value);
+  uint32_t threads = value.Get ();
+#ifdef HAVE_PTHREAD_H
+  if (threads == 0)
+    {
+      long cpus = sysconf (_SC_NPROCESSORS_ONLN);
+      threads = cpus > 0 ? cpus : 1;
+    }
+#else
+  threads = 1;
+#endif /* HAVE_PTHREAD_H */
+  threads = std::max<uint32_t> (1, std::min<uint32_t> (threads, roots.size ()));
+  m_spfSummary.threads = threads;
+
+//
+// The roots are computed in batches, so that the routes of a handful of
+// roots per thread are held in memory at a time; the routes are installed
+// on the main thread between two batches.
+//
+  std::vector<SpfGraph::Worker> workers (threads);
+  for (uint32_t t = 0; t < threads; t++)
+    {
+      workers[t].graph = &graph;
+      workers[t].keepDist = dist != 0;
+    }
+  uint32_t batch = threads * 16;
+  std::vector<SpfGraph::Job> jobs (std::min<uint32_t> (batch, roots.size ()));
+  for (uint32_t start = 0; start < roots.size (); start += batch)
+    {
+      uint32_t count = std::min<uint32_t> (batch, roots.size () - start);
+      for (uint32_t t = 0; t < threads; t++)
+        {
+          workers[t].jobs.clear ();
+        }
+      for (uint32_t k = 0; k < count; k++)
+        {
+          jobs[k].root = roots[start + k];
+          workers[k % threads].jobs.push_back (&jobs[k]);
+        }
+
+      SystemWallClockMs clock;
+      clock.Start ();
+#ifdef HAVE_PTHREAD_H
+      std::vector<Ptr<SystemThread> > running;
+      for (uint32_t t = 1; t < threads; t++)
+        {
+          running.push_back (Create<SystemThread> (MakeCallback (&SpfGraph::Worker::Run, &workers[t])));
+          running.back ()->Start ();
+        }
+      workers[0].Run ();
+      for (uint32_t t = 0; t < running.size (); t++)
+        {
+          running[t]->Join ();
+        }
+#else
+      workers[0].Run ();
+#endif /* HAVE_PTHREAD_H */
+      m_spfSummary.spfMs += clock.End ();
+
+      clock.Start ();
+      for (uint32_t k = 0; k < count; k++)
+        {
+          const SpfGraph::Root& root = graph.roots[jobs[k].root];
+          Ptr<Ipv4GlobalRouting> gr = root.routing;
+          if (clear)
+            {
+              while (gr->GetNRoutes () > 0)
+                {
+                  gr->RemoveRoute (0);
+                }
+            }
+          const std::vector<SpfGraph::Route>& routes = jobs[k].routes;
+          for (uint32_t i = 0; i < routes.size (); i++)
+            {
+              const SpfGraph::Route& route = routes[i];
+              Ipv4Address dest (route.dest.dest);
+              Ipv4Address nextHop (route.nextHop);
+              switch (route.dest.type)
+                {
+                case SpfGraph::HOST:
+                  gr->AddHostRouteTo (dest, nextHop, route.outIf);
+                  break;
+                case SpfGraph::NETWORK:
+                  gr->AddNetworkRouteTo (dest, Ipv4Mask (route.dest.mask), nextHop, route.outIf);
+                  break;
+                case SpfGraph::EXTERNAL:
+                  gr->AddASExternalRouteTo (dest, Ipv4Mask (route.dest.mask), nextHop, route.outIf);
+                  break;
+                }
+            }
+          NS_LOG_LOGIC ("Installed " << routes.size () << " routes on router " <<
+                        Ipv4Address (graph.id[root.vertex]));
+          if (dist)
+            {
+              (*dist)[jobs[k].root].swap (jobs[k].dist);
+            }
+        }
+      m_spfSummary.installMs += clock.End ();
+    }
+}
+
+void
+GlobalRouteManagerImpl::ParallelInitializeRoutes ()
+{
+  NS_LOG_FUNCTION (this);
+  m_spfSummary = SpfSummary ();
+  SystemWallClockMs clock;
+  clock.Start ();
+  SpfState *state = new SpfState;
+  BuildSpfGraph (state->graph);
+  m_spfSummary.graphMs = clock.End ();
+
+  uint32_t n = state->graph.roots.size ();
+  m_spfSummary.vertices = state->graph.id.size ();
+  m_spfSummary.roots = n;
+  m_spfSummary.computed = n;
+  std::vector<uint32_t> roots (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      roots[i] = i;
+    }
+  bool incremental = GetSpfMode () == SPF_INCREMENTAL;
+  if (incremental)
+    {
+      state->dist.resize (n);
+    }
+  SpfRunRoots (state->graph, roots, false, incremental ? &state->dist : 0);
+
+  delete m_spfState;
+  m_spfState = 0;
+  if (incremental)
+    {
+      m_spfState = state;
+    }
+  else
+    {
+      delete state;
+    }
+  LogSpfSummary ();
+}
+
+void
+GlobalRouteManagerImpl::RecomputeRoutes ()
+{
+  NS_LOG_FUNCTION (this);
+  if (GetSpfMode () == SPF_INCREMENTAL && m_spfState)
+    {
+      IncrementalRecomputeRoutes ();
+      return;
+    }
+  DeleteGlobalRoutes ();
+  BuildGlobalRoutingDatabase ();
+  InitializeRoutes ();
+}
+
+//
+// A router needs its SPF run again if the new LSDB changes its shortest-path
+// DAG, that is if a link on one of its shortest paths vanished or changed,
+// or if a new link offers a path no longer than the shortest one; or if a
+// destination appeared on a reachable vertex.  Otherwise its routes are
+// unchanged, except those to the destinations which vanished, which are
+// removed in place.
+//
+void
+GlobalRouteManagerImpl::IncrementalRecomputeRoutes ()
+{
+  NS_LOG_FUNCTION (this);
+  m_spfSummary = SpfSummary ();
+  SystemWallClockMs clock;
+  clock.Start ();
+
+  delete m_lsdb;
+  m_lsdb = new GlobalRouteManagerLSDB ();
+  BuildGlobalRoutingDatabase ();
+  SpfState *state = new SpfState;
+  BuildSpfGraph (state->graph);
+  const SpfGraph& og = m_spfState->graph;
+  const SpfGraph& ng = state->graph;
+
+  std::vector<SpfGraph::EdgeKey> oldEdges, newEdges, removedEdges, addedEdges;
+  og.GetEdgeKeys (oldEdges);
+  ng.GetEdgeKeys (newEdges);
+  std::set_difference (oldEdges.begin (), oldEdges.end (), newEdges.begin (), newEdges.end (),
+                       std::back_inserter (removedEdges));
+  std::set_difference (newEdges.begin (), newEdges.end (), oldEdges.begin (), oldEdges.end (),
+                       std::back_inserter (addedEdges));
+  std::vector<SpfGraph::DestKey> oldDests, newDests, removedDests, addedDests;
+  og.GetDestKeys (oldDests);
+  ng.GetDestKeys (newDests);
+  std::set_difference (oldDests.begin (), oldDests.end (), newDests.begin (), newDests.end (),
+                       std::back_inserter (removedDests));
+  std::set_difference (newDests.begin (), newDests.end (), oldDests.begin (), oldDests.end (),
+                       std::back_inserter (addedDests));
+  NS_LOG_LOGIC (removedEdges.size () << " links removed, " << addedEdges.size () << " added, " <<
+                removedDests.size () << " destinations removed, " << addedDests.size () << " added");
+
+//
+// The changes, in the vertex numbers of the old graph
+//
+  std::vector<std::pair<uint32_t, uint32_t> > removed, added;
+  std::vector<uint32_t> removedMetric, addedMetric;
+  for (uint32_t i = 0; i < removedEdges.size (); i++)
+    {
+      removed.push_back (std::make_pair (og.index.at (removedEdges[i].from), og.index.at (removedEdges[i].to)));
+      removedMetric.push_back (removedEdges[i].metric);
+    }
+  for (uint32_t i = 0; i < addedEdges.size (); i++)
+    {
+      std::unordered_map<uint32_t, uint32_t>::const_iterator from = og.index.find (addedEdges[i].from);
+      std::unordered_map<uint32_t, uint32_t>::const_iterator to = og.index.find (addedEdges[i].to);
+      if (from == og.index.end ())
+        {
+          // Only reachable through another new link
+          continue;
+        }
+      added.push_back (std::make_pair (from->second, to == og.index.end () ? SpfGraph::NONE : to->second));
+      addedMetric.push_back (addedEdges[i].metric);
+    }
+  std::vector<uint32_t> removedAt, removedAtNew, addedAt;
+  for (uint32_t i = 0; i < removedDests.size (); i++)
+    {
+      removedAt.push_back (og.index.at (removedDests[i].vertex));
+      std::unordered_map<uint32_t, uint32_t>::const_iterator at = ng.index.find (removedDests[i].vertex);
+      removedAtNew.push_back (at == ng.index.end () ? SpfGraph::NONE : at->second);
+    }
+  for (uint32_t i = 0; i < addedDests.size (); i++)
+    {
+      std::unordered_map<uint32_t, uint32_t>::const_iterator at = og.index.find (addedDests[i].vertex);
+      if (at != og.index.end ())
+        {
+          addedAt.push_back (at->second);
+        }
+    }
+  state->graph.BuildInEdges ();
+
+  std::unordered_map<uint32_t, uint32_t> oldRoots;
+  for (uint32_t i = 0; i < og.roots.size (); i++)
+    {
+      oldRoots[og.id[og.roots[i].vertex]] = i;
+    }
+  state->dist.resize (ng.roots.size ());
+  std::vector<uint32_t> affected;
+  for (uint32_t j = 0; j < ng.roots.size (); j++)
+    {
+      const SpfGraph::Root& root = ng.roots[j];
+      std::unordered_map<uint32_t, uint32_t>::const_iterator it = oldRoots.find (ng.id[root.vertex]);
+      bool recompute = root.type != SpfGraph::ROOT_SPF || it == oldRoots.end ()
+        || og.roots[it->second].type != SpfGraph::ROOT_SPF;
+      const std::vector<uint32_t>* dist = recompute ? 0 : &m_spfState->dist[it->second];
+      uint32_t r = recompute ? 0 : og.roots[it->second].vertex;
+      for (uint32_t i = 0; !recompute && i < removed.size (); i++)
+        {
+          uint64_t d = (*dist)[removed[i].first];
+          recompute = d != SPF_INFINITY && d + removedMetric[i] == (*dist)[removed[i].second];
+        }
+      for (uint32_t i = 0; !recompute && i < added.size (); i++)
+        {
+          uint64_t d = (*dist)[added[i].first];
+          recompute = d != SPF_INFINITY
+            && (added[i].second == SpfGraph::NONE || d + addedMetric[i] <= (*dist)[added[i].second]);
+        }
+      for (uint32_t i = 0; !recompute && i < addedAt.size (); i++)
+        {
+          recompute = addedAt[i] != r && (*dist)[addedAt[i]] != SPF_INFINITY;
+        }
+      for (uint32_t i = 0; !recompute && i < removedAt.size (); i++)
+        {
+          recompute = removedAtNew[i] == SpfGraph::NONE && (*dist)[removedAt[i]] != SPF_INFINITY;
+        }
+      if (recompute)
+        {
+          affected.push_back (j);
+          continue;
+        }
+
+      // Same DAG: renumber the distances, and remove the routes to the
+      // destinations withdrawn by the vertices, through the exits the
+      // routes were installed with
+      std::vector<uint32_t>& newDist = state->dist[j];
+      newDist.assign (ng.id.size (), SPF_INFINITY);
+      for (uint32_t v = 0; v < og.id.size (); v++)
+        {
+          std::unordered_map<uint32_t, uint32_t>::const_iterator nv = ng.index.find (og.id[v]);
+          if (nv != ng.index.end ())
+            {
+              newDist[nv->second] = (*dist)[v];
+            }
+        }
+      std::unordered_map<uint32_t, std::vector<SpfGraph::Exit> > memo;
+      bool patched = false;
+      for (uint32_t i = 0; i < removedAt.size (); i++)
+        {
+          if (removedAt[i] == r || (*dist)[removedAt[i]] == SPF_INFINITY)
+            {
+              continue;
+            }
+          const SpfGraph::Dest& dest = removedDests[i].dest;
+          const std::vector<SpfGraph::Exit>& exits = ng.ExitsOf (root.vertex, removedAtNew[i], newDist, memo);
+          for (uint32_t k = 0; k < exits.size (); k++)
+            {
+              if (exits[k].second < 0)
+                {
+                  continue;
+                }
+              Ipv4Address nextHop (exits[k].first);
+              switch (dest.type)
+                {
+                case SpfGraph::HOST:
+                  root.routing->RemoveHostRouteTo (Ipv4Address (dest.dest), nextHop, exits[k].second);
+                  break;
+                case SpfGraph::NETWORK:
+                  root.routing->RemoveNetworkRouteTo (Ipv4Address (dest.dest), Ipv4Mask (dest.mask),
+                                                      nextHop, exits[k].second);
+                  break;
+                case SpfGraph::EXTERNAL:
+                  root.routing->RemoveASExternalRouteTo (Ipv4Address (dest.dest), Ipv4Mask (dest.mask),
+                                                         nextHop, exits[k].second);
+                  break;
+                }
+            }
+          patched = true;
+        }
+      if (patched)
+        {
+          m_spfSummary.patched++;
+        }
+    }
+  m_spfSummary.vertices = ng.id.size ();
+  m_spfSummary.roots = ng.roots.size ();
+  m_spfSummary.computed = affected.size ();
+  m_spfSummary.graphMs = clock.End ();
+
+  SpfRunRoots (ng, affected, true, &state->dist);
+  delete m_spfState;
+  m_spfState = state;
+  LogSpfSummary ();
+}
+
 } // namespace ns3
 
 
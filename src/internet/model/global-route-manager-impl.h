@@ -674,6 +674,16 @@ public:
    */
   uint32_t GetNumExtLSAs () const;
 
+  /**
+   * @brief Get all the Link State Advertisements of the database.
+   *
+   * The router and network LSAs are appended in the order of their link
+   * state ID; the external LSAs are not included.
+   *
+   * @param lsas the vector to append the LSAs to
+   */
+  void GetLSAs (std::vector<GlobalRoutingLSA*>& lsas) const;
+
 
 private:
   typedef std::map<Ipv4Address, GlobalRoutingLSA*> LSDBMap_t; //!< container of IPv4 addresses / Link State Advertisements
@@ -735,6 +745,52 @@ public:
  */
   virtual void InitializeRoutes ();
 
+/**
+ * @brief Recompute the routes after a change of the topology
+ *
+ * This is DeleteGlobalRoutes (), BuildGlobalRoutingDatabase () and
+ * InitializeRoutes () in turn, unless the GlobalRoutingSpfMode global value
+ * is Incremental and the routes were computed by this mode.  The routers
+ * whose shortest-path DAG is unchanged by the new link state database then
+ * keep their routing tables, only the routes to vanished destinations being
+ * removed, and the SPF is run again on the other routers only.
+ */
+  virtual void RecomputeRoutes ();
+
+/**
+ * @brief Algorithm used by InitializeRoutes ()
+ */
+  enum SpfMode
+  {
+    SPF_LEGACY,      //!< SPFVertex trees built from the LSDB, one router at a time
+    SPF_PARALLEL,    //!< SPF on a compact graph of the LSDB, across worker threads
+    SPF_INCREMENTAL  //!< SPF_PARALLEL, and RecomputeRoutes () is incremental
+  };
+
+/**
+ * @brief Summary of the last computation of the parallel SPF
+ */
+  struct SpfSummary
+  {
+    uint32_t vertices;   //!< Number of routers and networks in the graph
+    uint32_t roots;      //!< Number of routers having routes installed
+    uint32_t computed;   //!< Number of routers whose SPF was run
+    uint32_t patched;    //!< Number of routers whose routes were only pruned
+    uint32_t threads;    //!< Number of worker threads
+    int64_t graphMs;     //!< Time spent building the graph and diffing it, in ms
+    int64_t spfMs;       //!< Time spent in the SPF computations, in ms
+    int64_t installMs;   //!< Time spent writing the routing tables, in ms
+  };
+
+/**
+ * @brief Get the summary of the last SPF_PARALLEL or SPF_INCREMENTAL run
+ *
+ * The summary is also logged at the INFO level.
+ *
+ * @returns the summary
+ */
+  const SpfSummary& GetSpfSummary (void) const;
+
 /**
  * @brief Debugging routine; allow client code to supply a pre-built LSDB
  */
@@ -769,6 +825,57 @@ private:
   SPFVertex* m_spfroot; //!< the root node
   GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
 
+  struct SpfGraph;
+  struct SpfState;
+
+  SpfState* m_spfState; //!< graph and distances kept by SPF_INCREMENTAL
+  SpfSummary m_spfSummary; //!< summary of the last parallel SPF run
+
+  /**
+   * \brief Get the value of the GlobalRoutingSpfMode global value
+   * \returns the SPF mode
+   */
+  static SpfMode GetSpfMode (void);
+
+  /**
+   * \brief Build the compact graph of the LSDB used by the parallel SPF
+   *
+   * The interface indexes and next hops which SPFNexthopCalculation ()
+   * looks up on the fly are resolved here once per link, along with the
+   * routers the routes are installed on.
+   *
+   * \param graph the graph to fill
+   */
+  void BuildSpfGraph (SpfGraph& graph);
+
+  /**
+   * \brief Run the SPF of some routers of a graph across worker threads and
+   * install their routes
+   *
+   * \param graph the graph
+   * \param roots the indexes of the routers in the roots of the graph
+   * \param clear whether to remove the current routes of the routers first
+   * \param dist if not null, receives the distances computed from each root
+   */
+  void SpfRunRoots (const SpfGraph& graph, const std::vector<uint32_t>& roots,
+                    bool clear, std::vector<std::vector<uint32_t> >* dist);
+
+  /**
+   * \brief Compute the routes of every router with the parallel SPF
+   */
+  void ParallelInitializeRoutes ();
+
+  /**
+   * \brief Recompute the routes of the routers affected by the changes of
+   * the LSDB since the last run of the parallel SPF
+   */
+  void IncrementalRecomputeRoutes ();
+
+  /**
+   * \brief Log the summary of the last parallel SPF run
+   */
+  void LogSpfSummary (void) const;
+
   /**
    * \brief Test if a node is a stub, from an OSPF sense.
    *
@@ -21,6 +21,7 @@
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/simulation-singleton.h"
+#include "ns3/replication.h"
 #include "global-route-manager.h"
 #include "global-route-manager-impl.h"
 
@@ -58,12 +59,21 @@ GlobalRouteManager::InitializeRoutes (void)
   InitializeRoutes ();
 }
 
+void
+GlobalRouteManager::RecomputeRoutes (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  SimulationSingleton<GlobalRouteManagerImpl>::Get ()->
+  RecomputeRoutes ();
+}
+
 uint32_t
 GlobalRouteManager::AllocateRouterId (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
   static uint32_t routerId = 0;
-  return routerId++;
+  static thread_local uint32_t replicationRouterId = 0;
+  return Replication::IsEntered () ? replicationRouterId++ : routerId++;
 }
 
 
@@ -64,6 +64,15 @@ public:
  */
   static void InitializeRoutes ();
 
+/**
+ * @brief Recompute the routes after a change of the topology
+ *
+ * Deletes the routes, rebuilds the routing database and computes the routes
+ * again, or only recomputes the routers affected by the change when the
+ * GlobalRoutingSpfMode global value is Incremental.
+ */
+  static void RecomputeRoutes ();
+
 private:
 /**
  * @brief Global Route Manager copy construction is disallowed.  There's no 
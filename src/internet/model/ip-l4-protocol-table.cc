@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ip-l4-protocol-table.h"
+#include "ns3/assert.h"
+#include <algorithm>
+
+namespace ns3 {
+
+IpL4ProtocolTable::IpL4ProtocolTable ()
+{
+  std::fill (m_nOverrides, m_nOverrides + 256, 0);
+}
+
+bool
+IpL4ProtocolTable::Insert (Ptr<IpL4Protocol> protocol, int32_t interfaceIndex)
+{
+  int protocolNumber = protocol->GetProtocolNumber ();
+  NS_ASSERT_MSG (protocolNumber >= 0 && protocolNumber <= 255, "Invalid protocol number " << protocolNumber);
+  if (interfaceIndex < 0)
+    {
+      bool inserted = m_protocols[protocolNumber] == 0;
+      m_protocols[protocolNumber] = protocol;
+      return inserted;
+    }
+  uint32_t i = FindOverride (protocolNumber, interfaceIndex);
+  if (i < m_overrides.size ())
+    {
+      m_overrides[i].protocol = protocol;
+      return false;
+    }
+  NS_ASSERT_MSG (m_nOverrides[protocolNumber] < 255, "Too many interfaces for protocol " << protocolNumber);
+  Override entry;
+  entry.protocolNumber = protocolNumber;
+  entry.interfaceIndex = interfaceIndex;
+  entry.protocol = protocol;
+  m_overrides.push_back (entry);
+  ++m_nOverrides[protocolNumber];
+  return true;
+}
+
+bool
+IpL4ProtocolTable::Remove (int protocolNumber, int32_t interfaceIndex)
+{
+  if (protocolNumber < 0 || protocolNumber > 255)
+    {
+      return false;
+    }
+  if (interfaceIndex < 0)
+    {
+      bool removed = m_protocols[protocolNumber] != 0;
+      m_protocols[protocolNumber] = 0;
+      return removed;
+    }
+  uint32_t i = FindOverride (protocolNumber, interfaceIndex);
+  if (i == m_overrides.size ())
+    {
+      return false;
+    }
+  m_overrides[i] = m_overrides.back ();
+  m_overrides.pop_back ();
+  --m_nOverrides[protocolNumber];
+  return true;
+}
+
+void
+IpL4ProtocolTable::Clear (void)
+{
+  for (uint32_t i = 0; i < 256; ++i)
+    {
+      m_protocols[i] = 0;
+    }
+  std::fill (m_nOverrides, m_nOverrides + 256, 0);
+  m_overrides.clear ();
+}
+
+uint32_t
+IpL4ProtocolTable::FindOverride (int protocolNumber, int32_t interfaceIndex) const
+{
+  uint32_t i = 0;
+  while (i < m_overrides.size ()
+         && (m_overrides[i].protocolNumber != protocolNumber
+             || m_overrides[i].interfaceIndex != interfaceIndex))
+    {
+      ++i;
+    }
+  return i;
+}
+
+} // namespace ns3
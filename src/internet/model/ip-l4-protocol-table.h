@@ -0,0 +1,115 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef IP_L4_PROTOCOL_TABLE_H
+#define IP_L4_PROTOCOL_TABLE_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/ptr.h"
+#include "ip-l4-protocol.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ *
+ * \brief Table of the L4 protocols of an L3 protocol, indexed by protocol number
+ *
+ * The protocols registered for every interface are kept in an array of
+ * 256 entries, so that the demultiplexing of a received packet is a single
+ * array load. The protocols registered for a single interface are kept in
+ * a small list, which is searched only for the protocol numbers which
+ * have such an override.
+ */
+class IpL4ProtocolTable
+{
+public:
+  IpL4ProtocolTable ();
+
+  /**
+   * \brief Register a protocol
+   * \param protocol the protocol
+   * \param interfaceIndex the interface of the protocol, or -1 for all of them
+   * \returns false if a protocol with the same number was replaced
+   */
+  bool Insert (Ptr<IpL4Protocol> protocol, int32_t interfaceIndex);
+  /**
+   * \brief Unregister a protocol
+   * \param protocolNumber the number of the protocol
+   * \param interfaceIndex the interface of the protocol, or -1 for all of them
+   * \returns false if no protocol was registered
+   */
+  bool Remove (int protocolNumber, int32_t interfaceIndex);
+  /**
+   * \brief Get the protocol of a received packet
+   * \param protocolNumber the number of the protocol
+   * \param interfaceIndex the interface of the packet, or -1 to look up
+   * the protocol registered for all of the interfaces only
+   * \returns the protocol registered for the interface, or else the one
+   * registered for all of them, or 0
+   */
+  Ptr<IpL4Protocol> Get (int protocolNumber, int32_t interfaceIndex) const;
+  /**
+   * \brief Unregister all of the protocols
+   */
+  void Clear (void);
+
+private:
+  /**
+   * \brief Protocol registered for a single interface
+   */
+  struct Override
+  {
+    int protocolNumber;          //!< the number of the protocol
+    int32_t interfaceIndex;      //!< the interface of the protocol
+    Ptr<IpL4Protocol> protocol;  //!< the protocol
+  };
+
+  /**
+   * \brief Find the override of a protocol on an interface
+   * \param protocolNumber the number of the protocol
+   * \param interfaceIndex the interface of the protocol
+   * \returns the index of the override, or the number of overrides
+   */
+  uint32_t FindOverride (int protocolNumber, int32_t interfaceIndex) const;
+
+  Ptr<IpL4Protocol> m_protocols[256];  //!< protocols of all of the interfaces
+  uint8_t m_nOverrides[256];           //!< number of overrides of each protocol
+  std::vector<Override> m_overrides;   //!< protocols of a single interface
+};
+
+inline Ptr<IpL4Protocol>
+IpL4ProtocolTable::Get (int protocolNumber, int32_t interfaceIndex) const
+{
+  if (protocolNumber < 0 || protocolNumber > 255)
+    {
+      return 0;
+    }
+  if (interfaceIndex >= 0 && m_nOverrides[protocolNumber] != 0)
+    {
+      uint32_t i = FindOverride (protocolNumber, interfaceIndex);
+      if (i < m_overrides.size ())
+        {
+          return m_overrides[i].protocol;
+        }
+    }
+  return m_protocols[protocolNumber];
+}
+
+} // namespace ns3
+
+#endif /* IP_L4_PROTOCOL_TABLE_H */
@@ -22,14 +22,42 @@
 #include "ipv4-end-point.h"
 #include "ipv4-interface-address.h"
 #include "ns3/log.h"
+#include <algorithm>
 
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Ipv4EndPointDemux");
 
+bool
+Ipv4EndPointDemux::ConnectedKey::operator== (const ConnectedKey &other) const
+{
+  return localAddress == other.localAddress && peerAddress == other.peerAddress
+         && localPort == other.localPort && peerPort == other.peerPort;
+}
+
+size_t
+Ipv4EndPointDemux::ConnectedKeyHash::operator() (const ConnectedKey &key) const
+{
+  // MurmurHash3 finalizer over the four-tuple
+  uint64_t h = (static_cast<uint64_t> (key.localAddress.Get ()) << 32) | key.peerAddress.Get ();
+  h ^= ((static_cast<uint64_t> (key.localPort) << 16) | key.peerPort) * 0x9e3779b97f4a7c15ULL;
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return static_cast<size_t> (h);
+}
+
+Ipv4EndPointDemux::PortEntry::PortEntry ()
+  : nConnected (0)
+{
+}
+
 Ipv4EndPointDemux::Ipv4EndPointDemux ()
-  : m_ephemeral (49152), m_portLast (65535), m_portFirst (49152)
+  : m_ephemeral (49152), m_portLast (65535), m_portFirst (49152),
+    m_nEndPoints (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -37,36 +65,123 @@ Ipv4EndPointDemux::Ipv4EndPointDemux ()
 Ipv4EndPointDemux::~Ipv4EndPointDemux ()
 {
   NS_LOG_FUNCTION (this);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  EndPoints endPoints = GetAllEndPoints ();
+  m_connected.clear ();
+  m_ports.clear ();
+  for (EndPointsI i = endPoints.begin (); i != endPoints.end (); i++) 
     {
       Ipv4EndPoint *endPoint = *i;
+      endPoint->m_demux = 0;
       delete endPoint;
     }
-  m_endPoints.clear ();
 }
 
 bool
-Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
+Ipv4EndPointDemux::IsConnected (Ipv4EndPoint *endPoint)
 {
-  NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  return endPoint->GetLocalAddress () != Ipv4Address::GetAny ()
+         && endPoint->GetPeerAddress () != Ipv4Address::GetAny ()
+         && endPoint->GetPeerPort () != 0;
+}
+
+Ipv4EndPointDemux::ConnectedKey
+Ipv4EndPointDemux::GetKey (Ipv4EndPoint *endPoint)
+{
+  ConnectedKey key;
+  key.localAddress = endPoint->GetLocalAddress ();
+  key.peerAddress = endPoint->GetPeerAddress ();
+  key.localPort = endPoint->GetLocalPort ();
+  key.peerPort = endPoint->GetPeerPort ();
+  return key;
+}
+
+void
+Ipv4EndPointDemux::Index (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  PortEntry &entry = m_ports[endPoint->GetLocalPort ()];
+  if (IsConnected (endPoint))
+    {
+      m_connected[GetKey (endPoint)].push_back (endPoint);
+      ++entry.nConnected;
+    }
+  else
     {
-      if ((*i)->GetLocalPort  () == port) 
+      entry.endPoints.push_back (endPoint);
+    }
+}
+
+void
+Ipv4EndPointDemux::Unindex (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  PortEndPoints::iterator entry = m_ports.find (endPoint->GetLocalPort ());
+  NS_ASSERT (entry != m_ports.end ());
+  if (IsConnected (endPoint))
+    {
+      ConnectedEndPoints::iterator i = m_connected.find (GetKey (endPoint));
+      NS_ASSERT (i != m_connected.end ());
+      i->second.erase (std::find (i->second.begin (), i->second.end (), endPoint));
+      if (i->second.empty ())
         {
-          return true;
+          m_connected.erase (i);
         }
+      --entry->second.nConnected;
     }
-  return false;
+  else
+    {
+      std::vector<Ipv4EndPoint *> &endPoints = entry->second.endPoints;
+      endPoints.erase (std::find (endPoints.begin (), endPoints.end (), endPoint));
+    }
+  if (entry->second.endPoints.empty () && entry->second.nConnected == 0)
+    {
+      m_ports.erase (entry);
+    }
+}
+
+void
+Ipv4EndPointDemux::Add (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  Index (endPoint);
+  endPoint->m_demux = this;
+  ++m_nEndPoints;
+  NS_LOG_DEBUG ("Now have >>" << m_nEndPoints << "<< endpoints.");
+}
+
+bool
+Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
+{
+  NS_LOG_FUNCTION (this << port);
+  return m_ports.find (port) != m_ports.end ();
 }
 
 bool
 Ipv4EndPointDemux::LookupLocal (Ipv4Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  PortEndPoints::iterator entry = m_ports.find (port);
+  if (entry == m_ports.end ())
     {
-      if ((*i)->GetLocalPort () == port &&
-          (*i)->GetLocalAddress () == addr) 
+      return false;
+    }
+  std::vector<Ipv4EndPoint *> &endPoints = entry->second.endPoints;
+  for (std::vector<Ipv4EndPoint *>::iterator i = endPoints.begin (); i != endPoints.end (); i++) 
+    {
+      if ((*i)->GetLocalAddress () == addr) 
+        {
+          return true;
+        }
+    }
+  if (entry->second.nConnected == 0 || addr == Ipv4Address::GetAny ())
+    {
+      return false;
+    }
+  // the connected end points are not indexed by port: this is only
+  // reached when binding to a port which has connections
+  for (ConnectedEndPoints::iterator i = m_connected.begin (); i != m_connected.end (); i++)
+    {
+      if (i->first.localPort == port && i->first.localAddress == addr)
         {
           return true;
         }
@@ -85,8 +200,7 @@ Ipv4EndPointDemux::Allocate (void)
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (Ipv4Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Add (endPoint);
   return endPoint;
 }
 
@@ -101,8 +215,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address)
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Add (endPoint);
   return endPoint;
 }
 
@@ -124,8 +237,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address, uint16_t port)
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Add (endPoint);
   return endPoint;
 }
 
@@ -134,24 +246,39 @@ Ipv4EndPointDemux::Allocate (Ipv4Address localAddress, uint16_t localPort,
                              Ipv4Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  Ipv4EndPoint *endPoint = new Ipv4EndPoint (localAddress, localPort);
+  endPoint->SetPeer (peerAddress, peerPort);
+  bool duplicate = false;
+  if (IsConnected (endPoint))
     {
-      if ((*i)->GetLocalPort () == localPort &&
-          (*i)->GetLocalAddress () == localAddress &&
-          (*i)->GetPeerPort () == peerPort &&
-          (*i)->GetPeerAddress () == peerAddress) 
+      duplicate = m_connected.find (GetKey (endPoint)) != m_connected.end ();
+    }
+  else
+    {
+      PortEndPoints::iterator entry = m_ports.find (localPort);
+      if (entry != m_ports.end ())
         {
-          NS_LOG_WARN ("No way we can allocate this end-point.");
-          /* no way we can allocate this end-point. */
-          return 0;
+          std::vector<Ipv4EndPoint *> &endPoints = entry->second.endPoints;
+          for (std::vector<Ipv4EndPoint *>::iterator i = endPoints.begin (); i != endPoints.end (); i++) 
+            {
+              if ((*i)->GetLocalAddress () == localAddress &&
+                  (*i)->GetPeerPort () == peerPort &&
+                  (*i)->GetPeerAddress () == peerAddress) 
+                {
+                  duplicate = true;
+                  break;
+                }
+            }
         }
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (localAddress, localPort);
-  endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
-
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-
+  if (duplicate)
+    {
+      NS_LOG_WARN ("No way we can allocate this end-point.");
+      /* no way we can allocate this end-point. */
+      delete endPoint;
+      return 0;
+    }
+  Add (endPoint);
   return endPoint;
 }
 
@@ -159,15 +286,14 @@ void
 Ipv4EndPointDemux::DeAllocate (Ipv4EndPoint *endPoint)
 {
   NS_LOG_FUNCTION (this << endPoint);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  if (endPoint->m_demux != this)
     {
-      if (*i == endPoint)
-        {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
-        }
+      return;
     }
+  Unindex (endPoint);
+  endPoint->m_demux = 0;
+  --m_nEndPoints;
+  delete endPoint;
 }
 
 /*
@@ -179,14 +305,103 @@ Ipv4EndPointDemux::GetAllEndPoints (void)
   NS_LOG_FUNCTION (this);
   EndPoints ret;
 
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  for (PortEndPoints::iterator i = m_ports.begin (); i != m_ports.end (); i++)
+    {
+      ret.insert (ret.end (), i->second.endPoints.begin (), i->second.endPoints.end ());
+    }
+  for (ConnectedEndPoints::iterator i = m_connected.begin (); i != m_connected.end (); i++)
     {
-      Ipv4EndPoint* endP = *i;
-      ret.push_back (endP);
+      ret.insert (ret.end (), i->second.begin (), i->second.end ());
     }
   return ret;
 }
 
+void
+Ipv4EndPointDemux::Match (Ipv4EndPoint *endP,
+                          Ipv4Address daddr, uint16_t dport,
+                          Ipv4Address saddr, uint16_t sport,
+                          Ptr<Ipv4Interface> incomingInterface,
+                          bool isBroadcast, Ipv4Address incomingInterfaceAddr,
+                          EndPoints retval[4])
+{
+  NS_LOG_DEBUG ("Looking at endpoint dport=" << endP->GetLocalPort ()
+                                             << " daddr=" << endP->GetLocalAddress ()
+                                             << " sport=" << endP->GetPeerPort ()
+                                             << " saddr=" << endP->GetPeerAddress ());
+
+  if (!endP->IsRxEnabled ())
+    {
+      NS_LOG_LOGIC ("Skipping endpoint " << &endP
+                    << " because endpoint can not receive packets");
+      return;
+    }
+
+  if (endP->GetBoundNetDevice ())
+    {
+      if (endP->GetBoundNetDevice () != incomingInterface->GetDevice ())
+        {
+          NS_LOG_LOGIC ("Skipping endpoint " << &endP
+                                             << " because endpoint is bound to specific device and"
+                                             << endP->GetBoundNetDevice ()
+                                             << " does not match packet device " << incomingInterface->GetDevice ());
+          return;
+        }
+    }
+  bool localAddressMatchesWildCard = 
+    endP->GetLocalAddress () == Ipv4Address::GetAny ();
+  bool localAddressMatchesExact = endP->GetLocalAddress () == daddr;
+
+  if (isBroadcast)
+    {
+      NS_LOG_DEBUG ("Found bcast, localaddr " << endP->GetLocalAddress ());
+    }
+
+  if (isBroadcast && (endP->GetLocalAddress () != Ipv4Address::GetAny ()))
+    {
+      localAddressMatchesExact = (endP->GetLocalAddress () ==
+                                  incomingInterfaceAddr);
+    }
+  // if no match here, keep looking
+  if (!(localAddressMatchesExact || localAddressMatchesWildCard))
+    return; 
+  bool remotePeerMatchesExact = endP->GetPeerPort () == sport;
+  bool remotePeerMatchesWildCard = endP->GetPeerPort () == 0;
+  bool remoteAddressMatchesExact = endP->GetPeerAddress () == saddr;
+  bool remoteAddressMatchesWildCard = endP->GetPeerAddress () ==
+    Ipv4Address::GetAny ();
+  // If remote does not match either with exact or wildcard,
+  // skip this one
+  if (!(remotePeerMatchesExact || remotePeerMatchesWildCard))
+    return;
+  if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
+    return;
+
+  // Now figure out which return list to add this one to
+  if (localAddressMatchesWildCard &&
+      remotePeerMatchesWildCard &&
+      remoteAddressMatchesWildCard)
+    { // Only local port matches exactly
+      retval[0].push_back (endP);
+    }
+  if ((localAddressMatchesExact || (isBroadcast && localAddressMatchesWildCard))&&
+      remotePeerMatchesWildCard &&
+      remoteAddressMatchesWildCard)
+    { // Only local port and local address matches exactly
+      retval[1].push_back (endP);
+    }
+  if (localAddressMatchesWildCard &&
+      remotePeerMatchesExact &&
+      remoteAddressMatchesExact)
+    { // All but local address
+      retval[2].push_back (endP);
+    }
+  if (localAddressMatchesExact &&
+      remotePeerMatchesExact &&
+      remoteAddressMatchesExact)
+    { // All 4 match
+      retval[3].push_back (endP);
+    }
+}
 
 /*
  * If we have an exact match, we return it.
@@ -200,122 +415,71 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
 {
   NS_LOG_FUNCTION (this << daddr << dport << saddr << sport << incomingInterface);
   
-  EndPoints retval1; // Matches exact on local port, wildcards on others
-  EndPoints retval2; // Matches exact on local port/adder, wildcards on others
-  EndPoints retval3; // Matches all but local address
-  EndPoints retval4; // Exact match on all 4
+  // retval[0]: Matches exact on local port, wildcards on others
+  // retval[1]: Matches exact on local port/adder, wildcards on others
+  // retval[2]: Matches all but local address
+  // retval[3]: Exact match on all 4
+  EndPoints retval[4];
 
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  PortEndPoints::iterator entry = m_ports.find (dport);
+  if (entry == m_ports.end ())
     {
-      Ipv4EndPoint* endP = *i;
-
-      NS_LOG_DEBUG ("Looking at endpoint dport=" << endP->GetLocalPort ()
-                                                 << " daddr=" << endP->GetLocalAddress ()
-                                                 << " sport=" << endP->GetPeerPort ()
-                                                 << " saddr=" << endP->GetPeerAddress ());
+      NS_LOG_LOGIC ("No endpoint bound to port " << dport);
+      return retval[0];
+    }
 
-      if (!endP->IsRxEnabled ())
+  bool subnetDirected = false;
+  Ipv4Address incomingInterfaceAddr = daddr;  // may be a broadcast
+  for (uint32_t i = 0; incomingInterface && i < incomingInterface->GetNAddresses (); i++)
+    {
+      Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
+      if (addr.GetLocal ().CombineMask (addr.GetMask ()) == daddr.CombineMask (addr.GetMask ()) &&
+          daddr.IsSubnetDirectedBroadcast (addr.GetMask ()))
         {
-          NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                        << " because endpoint can not receive packets");
-          continue;
+          subnetDirected = true;
+          incomingInterfaceAddr = addr.GetLocal ();
         }
+    }
+  bool isBroadcast = (daddr.IsBroadcast () || subnetDirected == true);
+  NS_LOG_DEBUG ("dest addr " << daddr << " broadcast? " << isBroadcast);
 
-      if (endP->GetLocalPort () != dport) 
-        {
-          NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                                             << " because endpoint dport "
-                                             << endP->GetLocalPort ()
-                                             << " does not match packet dport " << dport);
-          continue;
-        }
-      if (endP->GetBoundNetDevice ())
+  // The connected end points can only match exactly, on the address of
+  // the incoming interface for a broadcast
+  if (entry->second.nConnected > 0)
+    {
+      ConnectedKey key;
+      key.localAddress = incomingInterfaceAddr;
+      key.peerAddress = saddr;
+      key.localPort = dport;
+      key.peerPort = sport;
+      ConnectedEndPoints::iterator i = m_connected.find (key);
+      if (i != m_connected.end ())
         {
-          if (endP->GetBoundNetDevice () != incomingInterface->GetDevice ())
+          for (std::vector<Ipv4EndPoint *>::iterator j = i->second.begin (); j != i->second.end (); j++)
             {
-              NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                                                 << " because endpoint is bound to specific device and"
-                                                 << endP->GetBoundNetDevice ()
-                                                 << " does not match packet device " << incomingInterface->GetDevice ());
-              continue;
+              Match (*j, daddr, dport, saddr, sport, incomingInterface,
+                     isBroadcast, incomingInterfaceAddr, retval);
             }
-        }
-      bool subnetDirected = false;
-      Ipv4Address incomingInterfaceAddr = daddr;  // may be a broadcast
-      for (uint32_t i = 0; i < incomingInterface->GetNAddresses (); i++)
-        {
-          Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
-          if (addr.GetLocal ().CombineMask (addr.GetMask ()) == daddr.CombineMask (addr.GetMask ()) &&
-              daddr.IsSubnetDirectedBroadcast (addr.GetMask ()))
+          if (!retval[3].empty ())
             {
-              subnetDirected = true;
-              incomingInterfaceAddr = addr.GetLocal ();
+              return retval[3];
             }
         }
-      bool isBroadcast = (daddr.IsBroadcast () || subnetDirected == true);
-      NS_LOG_DEBUG ("dest addr " << daddr << " broadcast? " << isBroadcast);
-      bool localAddressMatchesWildCard = 
-        endP->GetLocalAddress () == Ipv4Address::GetAny ();
-      bool localAddressMatchesExact = endP->GetLocalAddress () == daddr;
-
-      if (isBroadcast)
-        {
-          NS_LOG_DEBUG ("Found bcast, localaddr " << endP->GetLocalAddress ());
-        }
+    }
 
-      if (isBroadcast && (endP->GetLocalAddress () != Ipv4Address::GetAny ()))
-        {
-          localAddressMatchesExact = (endP->GetLocalAddress () ==
-                                      incomingInterfaceAddr);
-        }
-      // if no match here, keep looking
-      if (!(localAddressMatchesExact || localAddressMatchesWildCard))
-        continue; 
-      bool remotePeerMatchesExact = endP->GetPeerPort () == sport;
-      bool remotePeerMatchesWildCard = endP->GetPeerPort () == 0;
-      bool remoteAddressMatchesExact = endP->GetPeerAddress () == saddr;
-      bool remoteAddressMatchesWildCard = endP->GetPeerAddress () ==
-        Ipv4Address::GetAny ();
-      // If remote does not match either with exact or wildcard,
-      // skip this one
-      if (!(remotePeerMatchesExact || remotePeerMatchesWildCard))
-        continue;
-      if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
-        continue;
-
-      // Now figure out which return list to add this one to
-      if (localAddressMatchesWildCard &&
-          remotePeerMatchesWildCard &&
-          remoteAddressMatchesWildCard)
-        { // Only local port matches exactly
-          retval1.push_back (endP);
-        }
-      if ((localAddressMatchesExact || (isBroadcast && localAddressMatchesWildCard))&&
-          remotePeerMatchesWildCard &&
-          remoteAddressMatchesWildCard)
-        { // Only local port and local address matches exactly
-          retval2.push_back (endP);
-        }
-      if (localAddressMatchesWildCard &&
-          remotePeerMatchesExact &&
-          remoteAddressMatchesExact)
-        { // All but local address
-          retval3.push_back (endP);
-        }
-      if (localAddressMatchesExact &&
-          remotePeerMatchesExact &&
-          remoteAddressMatchesExact)
-        { // All 4 match
-          retval4.push_back (endP);
-        }
+  std::vector<Ipv4EndPoint *> &endPoints = entry->second.endPoints;
+  for (std::vector<Ipv4EndPoint *>::iterator i = endPoints.begin (); i != endPoints.end (); i++) 
+    {
+      Match (*i, daddr, dport, saddr, sport, incomingInterface,
+             isBroadcast, incomingInterfaceAddr, retval);
     }
 
   // Here we find the most exact match
-  if (!retval4.empty ()) return retval4;
-  if (!retval3.empty ()) return retval3;
-  if (!retval2.empty ()) return retval2;
-  return retval1;  // might be empty if no matches
+  if (!retval[3].empty ()) return retval[3];
+  if (!retval[2].empty ()) return retval[2];
+  if (!retval[1].empty ()) return retval[1];
+  return retval[0];  // might be empty if no matches
 }
 
 Ipv4EndPoint *
@@ -326,16 +490,41 @@ Ipv4EndPointDemux::SimpleLookup (Ipv4Address daddr,
 {
   NS_LOG_FUNCTION (this << daddr << dport << saddr << sport);
 
+  ConnectedKey key;
+  key.localAddress = daddr;
+  key.peerAddress = saddr;
+  key.localPort = dport;
+  key.peerPort = sport;
+  ConnectedEndPoints::iterator connected = m_connected.find (key);
+  if (connected != m_connected.end ())
+    {
+      /* this is an exact match. */
+      return connected->second.front ();
+    }
+  PortEndPoints::iterator entry = m_ports.find (dport);
+  if (entry == m_ports.end ())
+    {
+      return 0;
+    }
+
   // this code is a copy/paste version of an old BSD ip stack lookup
   // function.
   uint32_t genericity = 3;
   Ipv4EndPoint *generic = 0;
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  EndPoints endPoints (entry->second.endPoints.begin (), entry->second.endPoints.end ());
+  if (entry->second.nConnected > 0)
     {
-      if ((*i)->GetLocalPort () != dport) 
+      // only reached for the ICMP errors of an unknown connection
+      for (ConnectedEndPoints::iterator i = m_connected.begin (); i != m_connected.end (); i++)
         {
-          continue;
+          if (i->first.localPort == dport)
+            {
+              endPoints.insert (endPoints.end (), i->second.begin (), i->second.end ());
+            }
         }
+    }
+  for (EndPointsI i = endPoints.begin (); i != endPoints.end (); i++) 
+    {
       if ((*i)->GetLocalAddress () == daddr &&
           (*i)->GetPeerPort () == sport &&
           (*i)->GetPeerAddress () == saddr) 
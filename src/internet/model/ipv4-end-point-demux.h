@@ -23,6 +23,8 @@
 
 #include <stdint.h>
 #include <list>
+#include <vector>
+#include <unordered_map>
 #include "ns3/ipv4-address.h"
 #include "ipv4-interface.h"
 
@@ -40,6 +42,12 @@ class Ipv4EndPoint;
  * of endpoints, and has APIs to add and find endpoints in this demux.  This
  * code is shared in common to TCP and UDP protocols in ns3.  This demux
  * sits between ns3's layer four and the socket layer
+ *
+ * The connected endpoints, whose four-tuple is fully specified, are kept in
+ * a hash table, so that the packets of a connection are demultiplexed in
+ * constant time whatever the number of connections.  The listeners and the
+ * other endpoints with wildcards are kept in lists indexed by local port.
+ * The endpoints notify the demux when their addresses change.
  */
 
 class Ipv4EndPointDemux {
@@ -186,9 +194,130 @@ private:
   uint16_t m_portFirst;
 
   /**
-   * \brief A list of IPv4 end points.
+   * \brief Addresses and ports of a connected end point.
+   */
+  struct ConnectedKey
+  {
+    Ipv4Address localAddress; //!< the local address
+    Ipv4Address peerAddress;  //!< the peer address
+    uint16_t localPort;       //!< the local port
+    uint16_t peerPort;        //!< the peer port
+
+    /**
+     * \brief Compare two keys
+     * \param other the other key
+     * \returns true if the keys are equal
+     */
+    bool operator== (const ConnectedKey &other) const;
+  };
+
+  /**
+   * \brief Hash function of the connected end points.
+   */
+  struct ConnectedKeyHash
+  {
+    /**
+     * \brief Hash a key
+     * \param key the key
+     * \returns the hash of the key
+     */
+    size_t operator() (const ConnectedKey &key) const;
+  };
+
+  /**
+   * \brief End points bound to a local port.
+   */
+  struct PortEntry
+  {
+    PortEntry ();
+    std::vector<Ipv4EndPoint *> endPoints; //!< the end points with wildcards
+    uint32_t nConnected;                   //!< the number of connected end points
+  };
+
+  /**
+   * \brief Container of the connected end points.
+   */
+  typedef std::unordered_map<ConnectedKey, std::vector<Ipv4EndPoint *>, ConnectedKeyHash> ConnectedEndPoints;
+
+  /**
+   * \brief Container of the end points by local port.
+   */
+  typedef std::unordered_map<uint16_t, PortEntry> PortEndPoints;
+
+  /**
+   * \brief Check whether the four-tuple of an end point is fully specified.
+   * \param endPoint the end point
+   * \returns true if the end point is connected
+   */
+  static bool IsConnected (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Get the key of a connected end point.
+   * \param endPoint the end point
+   * \returns the key of the end point
    */
-  EndPoints m_endPoints;
+  static ConnectedKey GetKey (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Add an end point to the indexes.
+   *
+   * Also called by the end point after its addresses change.
+   *
+   * \param endPoint the end point
+   */
+  void Index (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Remove an end point from the indexes.
+   *
+   * Also called by the end point before its addresses change.
+   *
+   * \param endPoint the end point
+   */
+  void Unindex (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Register a new end point.
+   * \param endPoint the end point
+   */
+  void Add (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Classify an end point matching a packet by precedence.
+   * \param endP the end point
+   * \param daddr destination address of the packet
+   * \param dport destination port of the packet
+   * \param saddr source address of the packet
+   * \param sport source port of the packet
+   * \param incomingInterface the incoming interface
+   * \param isBroadcast true if the packet is a broadcast
+   * \param incomingInterfaceAddr the address of the incoming interface
+   * the packet is a subnet-directed broadcast for, or daddr
+   * \param retval the lists of matches, from the least to the most exact
+   */
+  void Match (Ipv4EndPoint *endP,
+              Ipv4Address daddr, uint16_t dport,
+              Ipv4Address saddr, uint16_t sport,
+              Ptr<Ipv4Interface> incomingInterface,
+              bool isBroadcast, Ipv4Address incomingInterfaceAddr,
+              EndPoints retval[4]);
+
+  /**
+   * \brief The connected end points.
+   */
+  ConnectedEndPoints m_connected;
+
+  /**
+   * \brief The end points by local port.
+   */
+  PortEndPoints m_ports;
+
+  /**
+   * \brief The number of end points.
+   */
+  uint32_t m_nEndPoints;
+
+  friend class Ipv4EndPoint;
 };
 
 } // namespace ns3
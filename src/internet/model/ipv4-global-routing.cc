@@ -29,6 +29,7 @@
 #include "ns3/boolean.h"
 #include "ns3/node.h"
 #include "ns3/enum.h"
+#include "ns3/uinteger.h"
 #include "ipv4-global-routing.h"
 #include "global-route-manager.h"
 #include "udp-header.h"
@@ -64,6 +65,17 @@ Ipv4GlobalRouting::GetTypeId (void)
                                    ECMP_HASH, "ECMP_HASH",         // Per-Flow ECMP
                                    ECMP_RANDOM, "ECMP_RANDOM",     // Per-Packet ECMP
                                    ECMP_FLOWCELL, "ECMP_FLOWCELL"))// Per-Hop ECMP with flowcell
+    .AddAttribute ("EcmpHashSeed",
+                   "Seed of the five tuple hash, to vary the paths chosen by each node",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&Ipv4GlobalRouting::m_ecmpSeed),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("LookupMode",
+                   "Route lookup algorithm",
+                   EnumValue (LOOKUP_LIST),
+                   MakeEnumAccessor (&Ipv4GlobalRouting::m_lookupMode),
+                   MakeEnumChecker (LOOKUP_LIST, "LOOKUP_LIST",   // linear scan
+                                    LOOKUP_TRIE, "LOOKUP_TRIE"))  // hash table and trie
     .AddAttribute ("RespondToInterfaceEvents",
                    "Set to true if you want to dynamically recompute the global routes upon Interface notification events (up/down, or add/remove address)",
                    BooleanValue (false),
@@ -75,12 +87,15 @@ Ipv4GlobalRouting::GetTypeId (void)
 
 Ipv4GlobalRouting::Ipv4GlobalRouting () 
   : //m_randomEcmpRouting (false),
-    m_respondToInterfaceEvents (false)
+    m_respondToInterfaceEvents (false),
+    m_ecmpSeed (0),
+    m_lookupMode (LOOKUP_LIST),
+    m_indexValid (false)
 {
   NS_LOG_FUNCTION (this);
 
   m_rand = CreateObject<UniformRandomVariable> ();
-  hasher = Hasher();
+  hasher = Hasher (Create<Hash::Function::Murmur3> ());
 }
 
 Ipv4GlobalRouting::~Ipv4GlobalRouting ()
@@ -97,6 +112,7 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, nextHop, interface);
   m_hostRoutes.push_back (route);
+  m_indexValid = false;
 }
 
 void 
@@ -107,6 +123,7 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, interface);
   m_hostRoutes.push_back (route);
+  m_indexValid = false;
 }
 
 void 
@@ -122,6 +139,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_networkRoutes.push_back (route);
+  m_indexValid = false;
 }
 
 void 
@@ -135,6 +153,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         networkMask,
                                                         interface);
   m_networkRoutes.push_back (route);
+  m_indexValid = false;
 }
 
 void 
@@ -150,66 +169,208 @@ Ipv4GlobalRouting::AddASExternalRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_ASexternalRoutes.push_back (route);
+  m_indexValid = false;
 }
 
 uint64_t
-Ipv4GlobalRouting::GetTupleValue(const Ipv4Header &header, Ptr<const Packet> ipPayload, bool flowcell)
+Ipv4GlobalRouting::GetTupleValue (const Ipv4Header &header, Ptr<const Packet> ipPayload, bool flowcell)
 {
-  NS_LOG_FUNCTION(this << header);
+  NS_LOG_FUNCTION (this << header);
+
+  // seed, source, destination, protocol, then the first eight bytes of
+  // the transport header
+  uint8_t buf[21];
+  buf[0] = (m_ecmpSeed >> 24) & 0xff;
+  buf[1] = (m_ecmpSeed >> 16) & 0xff;
+  buf[2] = (m_ecmpSeed >> 8) & 0xff;
+  buf[3] = m_ecmpSeed & 0xff;
+  header.GetSource ().Serialize (buf + 4);
+  header.GetDestination ().Serialize (buf + 8);
+  buf[12] = header.GetProtocol ();
+  size_t size = 13;
+
+  // Both UDP and TCP headers start with the ports; the TCP sequence
+  // number follows, its two high bytes are the 64KB flowcell
+  uint8_t protocol = header.GetProtocol ();
+  if ((protocol == UDP_PROT_NUMBER || protocol == TCP_PROT_NUMBER)
+      && ipPayload != 0 && ipPayload->GetSize () >= 8)
+    {
+      ipPayload->CopyData (buf + size, 8);
+      size += 4;
+      if (flowcell && protocol == TCP_PROT_NUMBER)
+        {
+          size += 2;
+        }
+      NS_LOG_DEBUG ("FiveTuple() -> (src, dst, protN, sPort, dPort) - "
+                    << header.GetSource () << ", "
+                    << header.GetDestination () << ", "
+                    << (int)protocol << ", "
+                    << ((buf[13] << 8) | buf[14]) << ", "
+                    << ((buf[15] << 8) | buf[16]));
+    }
 
-  hasher.clear();
-  std::ostringstream oss;
-  oss << header.GetSource()
-      << header.GetDestination()
-      << header.GetProtocol();
+  hasher.clear ();
+  return hasher.GetHash32 (reinterpret_cast<const char *> (buf), size);
+}
 
-  switch (header.GetProtocol())
-  {
-    case UDP_PROT_NUMBER:
+void
+Ipv4GlobalRouting::BuildIndex (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_groups.clear ();
+  m_hostIndex.clear ();
+  m_networkTrie.assign (1, TrieNode ());
+  m_networkTrie[0].child[0] = m_networkTrie[0].child[1] = 0;
+  m_networkTrie[0].group = -1;
+  m_externalTrie = m_networkTrie;
+
+  for (HostRoutesCI i = m_hostRoutes.begin (); i != m_hostRoutes.end (); i++)
+    {
+      uint32_t dest = (*i)->GetDest ().Get ();
+      std::unordered_map<uint32_t, uint32_t>::const_iterator it = m_hostIndex.find (dest);
+      if (it == m_hostIndex.end ())
+        {
+          m_hostIndex[dest] = m_groups.size ();
+          m_groups.push_back (EcmpGroup (1, *i));
+        }
+      else
+        {
+          m_groups[it->second].push_back (*i);
+        }
+    }
+  for (NetworkRoutesCI j = m_networkRoutes.begin (); j != m_networkRoutes.end (); j++)
     {
-      UdpHeader udpHeader;
-      ipPayload->PeekHeader(udpHeader);
-      NS_LOG_DEBUG ("FiveTuple() -> UDP: (src, dst, protN, sPort, dPort) - "
-          << header.GetSource() << ", "
-          << header.GetDestination() << ", "
-          << (int)header.GetProtocol() << ", "
-          << (int)udpHeader.GetSourcePort() << ", "
-          << (int)udpHeader.GetDestinationPort());
+      TrieInsert (m_networkTrie, *j);
+    }
+  for (ASExternalRoutesCI k = m_ASexternalRoutes.begin (); k != m_ASexternalRoutes.end (); k++)
+    {
+      TrieInsert (m_externalTrie, *k);
+    }
+  m_indexValid = true;
+  NS_LOG_LOGIC ("Indexed " << m_hostIndex.size () << " hosts, " <<
+                m_networkTrie.size () << " network trie nodes, " <<
+                m_groups.size () << " ECMP groups");
+}
 
-      oss << udpHeader.GetSourcePort()
-          << udpHeader.GetDestinationPort();
+void
+Ipv4GlobalRouting::TrieInsert (std::vector<TrieNode> &trie, Ipv4RoutingTableEntry *route)
+{
+  uint32_t network = route->GetDestNetwork ().Get ();
+  uint16_t length = route->GetDestNetworkMask ().GetPrefixLength ();
+  uint32_t node = 0;
+  for (uint16_t bit = 0; bit < length; ++bit)
+    {
+      uint32_t b = (network >> (31 - bit)) & 1;
+      if (trie[node].child[b] == 0)
+        {
+          TrieNode child;
+          child.child[0] = child.child[1] = 0;
+          child.group = -1;
+          trie[node].child[b] = trie.size ();
+          trie.push_back (child);
+        }
+      node = trie[node].child[b];
+    }
+  if (trie[node].group < 0)
+    {
+      trie[node].group = m_groups.size ();
+      m_groups.push_back (EcmpGroup (1, route));
+    }
+  else
+    {
+      m_groups[trie[node].group].push_back (route);
+    }
+}
 
-      break;
+const Ipv4GlobalRouting::EcmpGroup *
+Ipv4GlobalRouting::TrieLookup (const std::vector<TrieNode> &trie, uint32_t dest,
+                               Ptr<NetDevice> oif, EcmpGroup &filtered) const
+{
+  // the groups of the prefixes matching dest, from the shortest
+  int32_t groups[33];
+  uint32_t n = 0;
+  uint32_t node = 0;
+  for (uint16_t bit = 0; ; ++bit)
+    {
+      if (trie[node].group >= 0)
+        {
+          groups[n++] = trie[node].group;
+        }
+      if (bit == 32)
+        {
+          break;
+        }
+      node = trie[node].child[(dest >> (31 - bit)) & 1];
+      if (node == 0)
+        {
+          break;
+        }
     }
-    case TCP_PROT_NUMBER:
-    {
-      TcpHeader tcpHeader;
-      ipPayload->PeekHeader(tcpHeader);
-      NS_LOG_DEBUG ("FiveTuple() -> TCP: (src, dst, protN, sPort, dPort) - "
-          << header.GetSource() << ", "
-          << header.GetDestination() << ", "
-          << (int)header.GetProtocol() << ", "
-          << (int)tcpHeader.GetSourcePort() << ", "
-          << (int)tcpHeader.GetDestinationPort());
-      
-      oss << tcpHeader.GetSourcePort()
-          << tcpHeader.GetDestinationPort();
-
-      if (flowcell) // flowcell ecmp
-      {
-        SequenceNumber32 seq = tcpHeader.GetSequenceNumber();
-        oss << (seq.GetValue() >> 16);
-      }
-      break;
+  // Like the linear scan, fall back to a shorter prefix when no route
+  // of a longer one goes through oif
+  while (n > 0)
+    {
+      const EcmpGroup *routes = FilterGroup (m_groups[groups[--n]], oif, filtered);
+      if (routes != 0)
+        {
+          return routes;
+        }
     }
-    default:
-      break;
-  }
+  return 0;
+}
 
-  std::string data = oss.str();
-  uint32_t hash = hasher.GetHash32(data);
-  oss.str("");
-  return hash;  
+const Ipv4GlobalRouting::EcmpGroup *
+Ipv4GlobalRouting::FilterGroup (const EcmpGroup &group, Ptr<NetDevice> oif, EcmpGroup &filtered) const
+{
+  if (oif == 0)
+    {
+      return &group;
+    }
+  filtered.clear ();
+  for (EcmpGroup::const_iterator i = group.begin (); i != group.end (); ++i)
+    {
+      if (oif == m_ipv4->GetNetDevice ((*i)->GetInterface ()))
+        {
+          filtered.push_back (*i);
+        }
+      else
+        {
+          NS_LOG_LOGIC ("Not on requested interface, skipping");
+        }
+    }
+  return filtered.empty () ? 0 : &filtered;
+}
+
+const Ipv4GlobalRouting::EcmpGroup *
+Ipv4GlobalRouting::LookupIndex (Ipv4Address dest, Ptr<NetDevice> oif, EcmpGroup &filtered)
+{
+  if (!m_indexValid)
+    {
+      BuildIndex ();
+    }
+  const EcmpGroup *routes = 0;
+  std::unordered_map<uint32_t, uint32_t>::const_iterator it = m_hostIndex.find (dest.Get ());
+  if (it != m_hostIndex.end ())
+    {
+      routes = FilterGroup (m_groups[it->second], oif, filtered);
+    }
+  if (routes == 0)
+    {
+      routes = TrieLookup (m_networkTrie, dest.Get (), oif, filtered);
+    }
+  if (routes == 0)
+    {
+      routes = TrieLookup (m_externalTrie, dest.Get (), oif, filtered);
+      // Like the linear scan, only the first external route to a network
+      // through oif is used
+      if (routes != 0 && routes->size () > 1)
+        {
+          Ipv4RoutingTableEntry *first = routes->front ();
+          filtered.assign (1, first);
+          routes = &filtered;
+        }
+    }
+  return routes;
 }
 
 Ptr<Ipv4Route>
@@ -223,6 +384,16 @@ Ipv4GlobalRouting::LookupGlobal (const Ipv4Header &header, Ptr<const Packet> ipP
   typedef std::vector<Ipv4RoutingTableEntry*> RouteVec_t;
   RouteVec_t allRoutes;
 
+  if (m_lookupMode == LOOKUP_TRIE)
+    {
+      const EcmpGroup *routes = LookupIndex (header.GetDestination (), oif, allRoutes);
+      if (routes == 0)
+        {
+          return 0;
+        }
+      return CreateRoute (*routes, header, ipPayload);
+    }
+
   NS_LOG_LOGIC ("Number of m_hostRoutes = " << m_hostRoutes.size ());
   for (HostRoutesCI i = m_hostRoutes.begin (); 
        i != m_hostRoutes.end (); 
@@ -293,48 +464,7 @@ Ipv4GlobalRouting::LookupGlobal (const Ipv4Header &header, Ptr<const Packet> ipP
     }
   if (allRoutes.size () > 0 ) // if route(s) is found
     {
-      // pick up one of the routes uniformly at random if random
-      // ECMP routing is enabled, or always select the first route
-      // consistently if random ECMP routing is disabled
-      uint32_t selectIndex;
-      /*
-      if (m_randomEcmpRouting)
-        {
-          selectIndex = m_rand->GetInteger (0, allRoutes.size ()-1);
-        }
-      else 
-        {
-          selectIndex = 0;
-        }
-      */
-      switch (m_ecmpMode)
-      {
-        case ECMP_NONE:
-          selectIndex = 0;
-          break;
-        case ECMP_HASH:
-          selectIndex = GetTupleValue(header,ipPayload) % (allRoutes.size());
-          break;
-        case ECMP_RANDOM:
-          selectIndex = m_rand->GetInteger (0, allRoutes.size()-1);
-          break;
-        case ECMP_FLOWCELL:
-          selectIndex = GetTupleValue(header,ipPayload, true) % (allRoutes.size());
-          break;
-        default:
-          selectIndex = 0;
-          break;
-      }
-      Ipv4RoutingTableEntry* route = allRoutes.at (selectIndex); 
-      // create a Ipv4Route object from the selected routing table entry
-      rtentry = Create<Ipv4Route> ();
-      rtentry->SetDestination (route->GetDest ());
-      /// \todo handle multi-address case
-      rtentry->SetSource (m_ipv4->GetAddress (route->GetInterface (), 0).GetLocal ());
-      rtentry->SetGateway (route->GetGateway ());
-      uint32_t interfaceIdx = route->GetInterface ();
-      rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
-      return rtentry;
+      return CreateRoute (allRoutes, header, ipPayload);
     }
   else 
     {
@@ -342,6 +472,44 @@ Ipv4GlobalRouting::LookupGlobal (const Ipv4Header &header, Ptr<const Packet> ipP
     }
 }
 
+Ptr<Ipv4Route>
+Ipv4GlobalRouting::CreateRoute (const EcmpGroup &allRoutes, const Ipv4Header &header, Ptr<const Packet> ipPayload)
+{
+  NS_ASSERT (allRoutes.size () > 0);
+  // pick up one of the routes uniformly at random if random
+  // ECMP routing is enabled, or always select the first route
+  // consistently if random ECMP routing is disabled
+  uint32_t selectIndex;
+  switch (m_ecmpMode)
+  {
+    case ECMP_NONE:
+      selectIndex = 0;
+      break;
+    case ECMP_HASH:
+      selectIndex = GetTupleValue(header,ipPayload) % (allRoutes.size());
+      break;
+    case ECMP_RANDOM:
+      selectIndex = m_rand->GetInteger (0, allRoutes.size()-1);
+      break;
+    case ECMP_FLOWCELL:
+      selectIndex = GetTupleValue(header,ipPayload, true) % (allRoutes.size());
+      break;
+    default:
+      selectIndex = 0;
+      break;
+  }
+  Ipv4RoutingTableEntry* route = allRoutes.at (selectIndex); 
+  // create a Ipv4Route object from the selected routing table entry
+  Ptr<Ipv4Route> rtentry = Create<Ipv4Route> ();
+  rtentry->SetDestination (route->GetDest ());
+  /// \todo handle multi-address case
+  rtentry->SetSource (m_ipv4->GetAddress (route->GetInterface (), 0).GetLocal ());
+  rtentry->SetGateway (route->GetGateway ());
+  uint32_t interfaceIdx = route->GetInterface ();
+  rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
+  return rtentry;
+}
+
 uint32_t 
 Ipv4GlobalRouting::GetNRoutes (void) const
 {
@@ -418,6 +586,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
               NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_hostRoutes.size ());
               delete *i;
               m_hostRoutes.erase (i);
+              m_indexValid = false;
               NS_LOG_LOGIC ("Done removing host route " << index << "; host route remaining size = " << m_hostRoutes.size ());
               return;
             }
@@ -435,6 +604,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_networkRoutes.size ());
           delete *j;
           m_networkRoutes.erase (j);
+          m_indexValid = false;
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
           return;
         }
@@ -451,6 +621,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_ASexternalRoutes.size ());
           delete *k;
           m_ASexternalRoutes.erase (k);
+          m_indexValid = false;
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
           return;
         }
@@ -459,6 +630,51 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
   NS_ASSERT (false);
 }
 
+bool
+Ipv4GlobalRouting::RemoveRouteTo (std::list<Ipv4RoutingTableEntry *> &routes, const Ipv4RoutingTableEntry &route)
+{
+  NS_LOG_FUNCTION (this << route);
+  for (std::list<Ipv4RoutingTableEntry *>::iterator i = routes.begin (); i != routes.end (); i++)
+    {
+      if ((*i)->GetDest () == route.GetDest ()
+          && (*i)->GetDestNetworkMask () == route.GetDestNetworkMask ()
+          && (*i)->GetGateway () == route.GetGateway ()
+          && (*i)->GetInterface () == route.GetInterface ())
+        {
+          delete *i;
+          routes.erase (i);
+          m_indexValid = false;
+          return true;
+        }
+    }
+  return false;
+}
+
+bool
+Ipv4GlobalRouting::RemoveHostRouteTo (Ipv4Address dest, Ipv4Address nextHop, uint32_t interface)
+{
+  NS_LOG_FUNCTION (this << dest << nextHop << interface);
+  return RemoveRouteTo (m_hostRoutes, Ipv4RoutingTableEntry::CreateHostRouteTo (dest, nextHop, interface));
+}
+
+bool
+Ipv4GlobalRouting::RemoveNetworkRouteTo (Ipv4Address network, Ipv4Mask networkMask,
+                                         Ipv4Address nextHop, uint32_t interface)
+{
+  NS_LOG_FUNCTION (this << network << networkMask << nextHop << interface);
+  return RemoveRouteTo (m_networkRoutes,
+                        Ipv4RoutingTableEntry::CreateNetworkRouteTo (network, networkMask, nextHop, interface));
+}
+
+bool
+Ipv4GlobalRouting::RemoveASExternalRouteTo (Ipv4Address network, Ipv4Mask networkMask,
+                                            Ipv4Address nextHop, uint32_t interface)
+{
+  NS_LOG_FUNCTION (this << network << networkMask << nextHop << interface);
+  return RemoveRouteTo (m_ASexternalRoutes,
+                        Ipv4RoutingTableEntry::CreateNetworkRouteTo (network, networkMask, nextHop, interface));
+}
+
 int64_t
 Ipv4GlobalRouting::AssignStreams (int64_t stream)
 {
@@ -489,6 +705,11 @@ Ipv4GlobalRouting::DoDispose (void)
     {
       delete (*l);
     }
+  m_indexValid = false;
+  m_groups.clear ();
+  m_hostIndex.clear ();
+  m_networkTrie.clear ();
+  m_externalTrie.clear ();
 
   Ipv4RoutingProtocol::DoDispose ();
 }
@@ -21,6 +21,8 @@
 #define IPV4_GLOBAL_ROUTING_H
 
 #include <list>
+#include <vector>
+#include <unordered_map>
 #include <stdint.h>
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv4-header.h"
@@ -28,6 +30,7 @@
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/hash.h"
 
 namespace ns3 {
 
@@ -48,6 +51,12 @@ typedef enum
   ECMP_FLOWCELL, // per-hop with flowcell 64KB each change
 }EcmpMode_t;
 
+typedef enum
+{
+  LOOKUP_LIST,  // linear scan, every matching network route is a candidate
+  LOOKUP_TRIE,  // hashed host routes and longest prefix match on networks
+}LookupMode_t;
+
 /**
  * \ingroup ipv4
  *
@@ -72,6 +81,12 @@ typedef enum
  *
  * This class deals with Ipv4 unicast routes only.
  *
+ * With the LOOKUP_TRIE mode, the routes are indexed upon the first lookup
+ * after a change: host routes in a hash table, network and external routes
+ * in binary tries, each destination pointing to its group of equal-cost
+ * routes. A network route then wins over the shorter prefixes matching
+ * the destination, whereas LOOKUP_LIST considers all of them.
+ *
  * \see Ipv4RoutingProtocol
  * \see GlobalRouteManager
  */
@@ -225,6 +240,40 @@ public:
    */
   void RemoveRoute (uint32_t i);
 
+  /**
+   * \brief Remove a host route.
+   *
+   * \param dest The Ipv4Address destination for this route.
+   * \param nextHop The next hop in the route to the destination.
+   * \param interface The network interface index used to send packets.
+   * \returns true if a route was removed
+   */
+  bool RemoveHostRouteTo (Ipv4Address dest, Ipv4Address nextHop, uint32_t interface);
+
+  /**
+   * \brief Remove a network route.
+   *
+   * \param network The Ipv4Address network for this route.
+   * \param networkMask The Ipv4Mask to extract the network.
+   * \param nextHop The next hop in the route to the destination.
+   * \param interface The network interface index used to send packets.
+   * \returns true if a route was removed
+   */
+  bool RemoveNetworkRouteTo (Ipv4Address network, Ipv4Mask networkMask,
+                             Ipv4Address nextHop, uint32_t interface);
+
+  /**
+   * \brief Remove an external route.
+   *
+   * \param network The Ipv4Address network for this route.
+   * \param networkMask The Ipv4Mask to extract the network.
+   * \param nextHop The next hop in the route to the destination.
+   * \param interface The network interface index used to send packets.
+   * \returns true if a route was removed
+   */
+  bool RemoveASExternalRouteTo (Ipv4Address network, Ipv4Mask networkMask,
+                                Ipv4Address nextHop, uint32_t interface);
+
   /**
    * Assign a fixed random variable stream number to the random variables
    * used by this model.  Return the number of streams (possibly zero) that
@@ -235,6 +284,18 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * \brief Hash the five tuple of a packet to pick its ECMP route
+   *
+   * The addresses, the protocol and the ports are hashed with Murmur3,
+   * along with the EcmpHashSeed attribute. With flowcell, the 64 KB block
+   * of the TCP sequence number is hashed as well.
+   *
+   * \param header the IPv4 header of the packet
+   * \param ipPayload the packet, starting with the transport header
+   * \param flowcell hash the flowcell of TCP packets too
+   * \return the hash value
+   */
   uint64_t GetTupleValue (const Ipv4Header &header, Ptr<const Packet> ipPayload, bool flowcell = false);
 
 protected:
@@ -270,6 +331,72 @@ private:
   /// iterator of container of Ipv4RoutingTableEntry (routes to external AS)
   typedef std::list<Ipv4RoutingTableEntry *>::iterator ASExternalRoutesI;
 
+  /// Equal-cost routes to a destination
+  typedef std::vector<Ipv4RoutingTableEntry *> EcmpGroup;
+
+  /**
+   * \brief Node of the binary trie of the network routes
+   *
+   * The root is the node zero, so a child index of zero means no child.
+   */
+  struct TrieNode
+  {
+    uint32_t child[2]; //!< Children for the next bit equal to 0 and 1
+    int32_t group;     //!< ECMP group of the prefix ending here, or -1
+  };
+
+  /**
+   * \brief Remove the first route of a list equal to a route
+   * \param routes the route list
+   * \param route the route
+   * \returns true if a route was removed
+   */
+  bool RemoveRouteTo (std::list<Ipv4RoutingTableEntry *> &routes, const Ipv4RoutingTableEntry &route);
+
+  /**
+   * \brief Build the lookup index from the route lists
+   *
+   * The index is rebuilt upon the first lookup after a change of the routes.
+   */
+  void BuildIndex (void);
+
+  /**
+   * \brief Insert a prefix in a trie
+   * \param trie the trie
+   * \param route the route to the prefix, added to its group if it already exists
+   */
+  void TrieInsert (std::vector<TrieNode> &trie, Ipv4RoutingTableEntry *route);
+
+  /**
+   * \brief Find the longest prefix of a trie matching an address with a
+   * route through the given interface
+   * \param trie the trie
+   * \param dest the address
+   * \param oif output interface if any (put 0 otherwise)
+   * \param filtered storage for the routes through oif
+   * \return the routes of the prefix through oif, or 0
+   */
+  const EcmpGroup *TrieLookup (const std::vector<TrieNode> &trie, uint32_t dest,
+                               Ptr<NetDevice> oif, EcmpGroup &filtered) const;
+
+  /**
+   * \brief Lookup the candidate routes in the index
+   * \param dest destination address
+   * \param oif output interface if any (put 0 otherwise)
+   * \param filtered storage for the routes through oif
+   * \return the candidate routes, or 0
+   */
+  const EcmpGroup *LookupIndex (Ipv4Address dest, Ptr<NetDevice> oif, EcmpGroup &filtered);
+
+  /**
+   * \brief Keep the routes of a group through the given interface
+   * \param group the group
+   * \param oif the output interface
+   * \param filtered storage for the routes through oif
+   * \return the routes through oif, or 0 if none
+   */
+  const EcmpGroup *FilterGroup (const EcmpGroup &group, Ptr<NetDevice> oif, EcmpGroup &filtered) const;
+
   /**
    * \brief Lookup in the forwarding table for destination.
    * \param dest destination address
@@ -279,11 +406,28 @@ private:
   // Ptr<Ipv4Route> LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif = 0);
   Ptr<Ipv4Route> LookupGlobal (const Ipv4Header &header, Ptr<const Packet> ipPayload, Ptr<NetDevice> oif = 0, bool host = false);
 
+  /**
+   * \brief Pick one of the equal-cost routes according to the ECMP mode
+   * \param allRoutes the candidate routes, at least one
+   * \param header the IPv4 header of the packet
+   * \param ipPayload the packet, starting with the transport header
+   * \return Ipv4Route to route the packet
+   */
+  Ptr<Ipv4Route> CreateRoute (const EcmpGroup &allRoutes, const Ipv4Header &header, Ptr<const Packet> ipPayload);
+
   Hasher hasher;                       //!< Used for hashing five tuple
+  uint32_t m_ecmpSeed;                 //!< Seed of the five tuple hash
+  LookupMode_t m_lookupMode;           //!< Route lookup algorithm
   HostRoutes m_hostRoutes;             //!< Routes to hosts
   NetworkRoutes m_networkRoutes;       //!< Routes to networks
   ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+  bool m_indexValid;                                 //!< The index matches the route lists
+  std::vector<EcmpGroup> m_groups;                   //!< ECMP groups of the index
+  std::unordered_map<uint32_t, uint32_t> m_hostIndex; //!< Host address to ECMP group
+  std::vector<TrieNode> m_networkTrie;               //!< Trie of the network routes
+  std::vector<TrieNode> m_externalTrie;              //!< Trie of the external routes
+
   Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
 
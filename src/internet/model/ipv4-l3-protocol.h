@@ -34,6 +34,7 @@
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/nstime.h"
 #include "ns3/simulator.h"
+#include "ip-l4-protocol-table.h"
 
 class Ipv4L3ProtocolTestCase;
 
@@ -444,19 +445,9 @@ private:
    */
   typedef std::list<Ptr<Ipv4RawSocketImpl> > SocketList;
 
-  /**
-   * \brief Container of the IPv4 L4 keys: protocol number, interface index
-   */
-  typedef std::pair<int, int32_t> L4ListKey_t;
-
-  /**
-   * \brief Container of the IPv4 L4 instances.
-   */
-  typedef std::map<L4ListKey_t, Ptr<IpL4Protocol> > L4List_t;
-
   bool m_ipForward;      //!< Forwarding packets (i.e. router mode) state.
   bool m_weakEsModel;    //!< Weak ES model state
-  L4List_t m_protocols;  //!< List of transport protocol.
+  IpL4ProtocolTable m_protocols;  //!< List of transport protocol.
   Ipv4InterfaceList m_interfaces; //!< List of IPv4 interfaces.
   Ipv4InterfaceReverseContainer m_reverseInterfacesContainer; //!< Container of NetDevice / Interface index associations.
   uint8_t m_defaultTtl;  //!< Default TTL
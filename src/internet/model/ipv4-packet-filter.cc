@@ -23,8 +23,6 @@
 
 #include "ns3/log.h"
 #include "ns3/enum.h"
-#include "ns3/tcp-header.h"
-#include "ns3/udp-header.h"
 #include "ipv4-queue-disc-item.h"
 #include "ipv4-packet-filter.h"
 
@@ -99,52 +97,59 @@ FqCoDelIpv4PacketFilter::DoClassify (Ptr<QueueDiscItem> item) const
 
   NS_ASSERT (ipv4Item != 0);
 
-  Ipv4Header hdr = ipv4Item->GetHeader ();
-  Ipv4Address src = hdr.GetSource ();
-  Ipv4Address dest = hdr.GetDestination ();
-  uint8_t prot = hdr.GetProtocol ();
-  uint16_t fragOffset = hdr.GetFragmentOffset ();
+  uint32_t hash = ipv4Item->Hash (m_perturbation);
 
-  TcpHeader tcpHdr;
-  UdpHeader udpHdr;
-  uint16_t srcPort = 0;
-  uint16_t destPort = 0;
+  NS_LOG_DEBUG ("Found Ipv4 packet; hash value " << hash);
 
-  Ptr<Packet> pkt = ipv4Item->GetPacket ();
+  return hash;
+}
 
-  if (prot == 6 && fragOffset == 0) // TCP
-    {
-      pkt->PeekHeader (tcpHdr);
-      srcPort = tcpHdr.GetSourcePort ();
-      destPort = tcpHdr.GetDestinationPort ();
-    }
-  else if (prot == 17 && fragOffset == 0) // UDP
+// ------------------------------------------------------------------------- //
+
+NS_OBJECT_ENSURE_REGISTERED (PrioIpv4PacketFilter);
+
+TypeId
+PrioIpv4PacketFilter::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PrioIpv4PacketFilter")
+    .SetParent<Ipv4PacketFilter> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<PrioIpv4PacketFilter> ()
+  ;
+  return tid;
+}
+
+PrioIpv4PacketFilter::PrioIpv4PacketFilter ()
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < 64; i++)
     {
-      pkt->PeekHeader (udpHdr);
-      srcPort = udpHdr.GetSourcePort ();
-      destPort = udpHdr.GetDestinationPort ();
+      m_bands[i] = PF_NO_MATCH;
     }
+}
 
-  /* serialize the 5-tuple and the perturbation in buf */
-  uint8_t buf[17];
-  src.Serialize (buf);
-  dest.Serialize (buf + 4);
-  buf[8] = prot;
-  buf[9] = (srcPort >> 8) & 0xff;
-  buf[10] = srcPort & 0xff;
-  buf[11] = (destPort >> 8) & 0xff;
-  buf[12] = destPort & 0xff;
-  buf[13] = (m_perturbation >> 24) & 0xff;
-  buf[14] = (m_perturbation >> 16) & 0xff;
-  buf[15] = (m_perturbation >> 8) & 0xff;
-  buf[16] = m_perturbation & 0xff;
-
-  /* Linux calculates the jhash2 (jenkins hash), we calculate the murmur3 */
-  uint32_t hash = Hash32 ((char*) buf, 17);
+PrioIpv4PacketFilter::~PrioIpv4PacketFilter ()
+{
+  NS_LOG_FUNCTION (this);
+}
 
-  NS_LOG_DEBUG ("Found Ipv4 packet; hash value " << hash);
+void
+PrioIpv4PacketFilter::SetBand (Ipv4Header::DscpType dscp, uint32_t band)
+{
+  NS_LOG_FUNCTION (this << dscp << band);
+  NS_ASSERT (dscp < 64);
+  m_bands[dscp] = band;
+}
 
-  return hash;
+int32_t
+PrioIpv4PacketFilter::DoClassify (Ptr<QueueDiscItem> item) const
+{
+  NS_LOG_FUNCTION (this << item);
+  Ptr<Ipv4QueueDiscItem> ipv4Item = DynamicCast<Ipv4QueueDiscItem> (item);
+
+  NS_ASSERT (ipv4Item != 0);
+
+  return m_bands[ipv4Item->GetHeader ().GetDscp ()];
 }
 
 } // namespace ns3
@@ -21,15 +21,49 @@
 #include "ipv6-end-point-demux.h"
 #include "ipv6-end-point.h"
 #include "ns3/log.h"
+#include <algorithm>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Ipv6EndPointDemux");
 
+bool Ipv6EndPointDemux::ConnectedKey::operator== (const ConnectedKey &other) const
+{
+  return localAddress == other.localAddress && peerAddress == other.peerAddress
+         && localPort == other.localPort && peerPort == other.peerPort;
+}
+
+size_t Ipv6EndPointDemux::ConnectedKeyHash::operator() (const ConnectedKey &key) const
+{
+  uint8_t buf[32];
+  key.localAddress.GetBytes (buf);
+  key.peerAddress.GetBytes (buf + 16);
+  uint64_t h = ((static_cast<uint64_t> (key.localPort) << 16) | key.peerPort) * 0x9e3779b97f4a7c15ULL;
+  for (uint32_t i = 0; i < 32; i += 8)
+    {
+      uint64_t word = 0;
+      for (uint32_t j = 0; j < 8; j++)
+        {
+          word = (word << 8) | buf[i + j];
+        }
+      h = (h ^ word) * 0xff51afd7ed558ccdULL;
+      h ^= h >> 33;
+    }
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return static_cast<size_t> (h);
+}
+
+Ipv6EndPointDemux::PortEntry::PortEntry ()
+  : nConnected (0)
+{
+}
+
 Ipv6EndPointDemux::Ipv6EndPointDemux ()
   : m_ephemeral (49152),
     m_portFirst (49152),
-    m_portLast (65535)
+    m_portLast (65535),
+    m_nEndPoints (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -37,34 +71,116 @@ Ipv6EndPointDemux::Ipv6EndPointDemux ()
 Ipv6EndPointDemux::~Ipv6EndPointDemux ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  EndPoints endPoints = GetEndPoints ();
+  m_connected.clear ();
+  m_ports.clear ();
+  for (EndPointsI i = endPoints.begin (); i != endPoints.end (); i++)
     {
       Ipv6EndPoint *endPoint = *i;
+      endPoint->m_demux = 0;
       delete endPoint;
     }
-  m_endPoints.clear ();
 }
 
-bool Ipv6EndPointDemux::LookupPortLocal (uint16_t port)
+bool Ipv6EndPointDemux::IsConnected (Ipv6EndPoint *endPoint)
 {
-  NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  return endPoint->GetLocalAddress () != Ipv6Address::GetAny ()
+         && endPoint->GetPeerAddress () != Ipv6Address::GetAny ()
+         && endPoint->GetPeerPort () != 0;
+}
+
+Ipv6EndPointDemux::ConnectedKey Ipv6EndPointDemux::GetKey (Ipv6EndPoint *endPoint)
+{
+  ConnectedKey key;
+  key.localAddress = endPoint->GetLocalAddress ();
+  key.peerAddress = endPoint->GetPeerAddress ();
+  key.localPort = endPoint->GetLocalPort ();
+  key.peerPort = endPoint->GetPeerPort ();
+  return key;
+}
+
+void Ipv6EndPointDemux::Index (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  PortEntry &entry = m_ports[endPoint->GetLocalPort ()];
+  if (IsConnected (endPoint))
+    {
+      m_connected[GetKey (endPoint)].push_back (endPoint);
+      ++entry.nConnected;
+    }
+  else
     {
-      if ((*i)->GetLocalPort  () == port)
+      entry.endPoints.push_back (endPoint);
+    }
+}
+
+void Ipv6EndPointDemux::Unindex (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  PortEndPoints::iterator entry = m_ports.find (endPoint->GetLocalPort ());
+  NS_ASSERT (entry != m_ports.end ());
+  if (IsConnected (endPoint))
+    {
+      ConnectedEndPoints::iterator i = m_connected.find (GetKey (endPoint));
+      NS_ASSERT (i != m_connected.end ());
+      i->second.erase (std::find (i->second.begin (), i->second.end (), endPoint));
+      if (i->second.empty ())
         {
-          return true;
+          m_connected.erase (i);
         }
+      --entry->second.nConnected;
+    }
+  else
+    {
+      std::vector<Ipv6EndPoint *> &endPoints = entry->second.endPoints;
+      endPoints.erase (std::find (endPoints.begin (), endPoints.end (), endPoint));
+    }
+  if (entry->second.endPoints.empty () && entry->second.nConnected == 0)
+    {
+      m_ports.erase (entry);
     }
-  return false;
+}
+
+void Ipv6EndPointDemux::Add (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  Index (endPoint);
+  endPoint->m_demux = this;
+  ++m_nEndPoints;
+  NS_LOG_DEBUG ("Now have >>" << m_nEndPoints << "<< endpoints.");
+}
+
+bool Ipv6EndPointDemux::LookupPortLocal (uint16_t port)
+{
+  NS_LOG_FUNCTION (this << port);
+  return m_ports.find (port) != m_ports.end ();
 }
 
 bool Ipv6EndPointDemux::LookupLocal (Ipv6Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  PortEndPoints::iterator entry = m_ports.find (port);
+  if (entry == m_ports.end ())
+    {
+      return false;
+    }
+  std::vector<Ipv6EndPoint *> &endPoints = entry->second.endPoints;
+  for (std::vector<Ipv6EndPoint *>::iterator i = endPoints.begin (); i != endPoints.end (); i++)
     {
-      if ((*i)->GetLocalPort () == port
-          && (*i)->GetLocalAddress () == addr)
+      if ((*i)->GetLocalAddress () == addr)
+        {
+          return true;
+        }
+    }
+  if (entry->second.nConnected == 0 || addr == Ipv6Address::GetAny ())
+    {
+      return false;
+    }
+  /* the connected end points are not indexed by port: this is only
+     reached when binding to a port which has connections */
+  for (ConnectedEndPoints::iterator i = m_connected.begin (); i != m_connected.end (); i++)
+    {
+      if (i->first.localPort == port && i->first.localAddress == addr)
         {
           return true;
         }
@@ -82,8 +198,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate ()
       return 0;
     }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (Ipv6Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Add (endPoint);
   return endPoint;
 }
 
@@ -97,8 +212,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address)
       return 0;
     }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Add (endPoint);
   return endPoint;
 }
 
@@ -118,8 +232,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address, uint16_t port)
       return 0;
     }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Add (endPoint);
   return endPoint;
 }
 
@@ -127,39 +240,141 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address localAddress, uint16_t lo
                                            Ipv6Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  Ipv6EndPoint *endPoint = new Ipv6EndPoint (localAddress, localPort);
+  endPoint->SetPeer (peerAddress, peerPort);
+  bool duplicate = false;
+  if (IsConnected (endPoint))
+    {
+      duplicate = m_connected.find (GetKey (endPoint)) != m_connected.end ();
+    }
+  else
     {
-      if ((*i)->GetLocalPort () == localPort
-          && (*i)->GetLocalAddress () == localAddress
-          && (*i)->GetPeerPort () == peerPort
-          && (*i)->GetPeerAddress () == peerAddress)
+      PortEndPoints::iterator entry = m_ports.find (localPort);
+      if (entry != m_ports.end ())
         {
-          NS_LOG_WARN ("No way we can allocate this end-point.");
-          /* no way we can allocate this end-point. */
-          return 0;
+          std::vector<Ipv6EndPoint *> &endPoints = entry->second.endPoints;
+          for (std::vector<Ipv6EndPoint *>::iterator i = endPoints.begin (); i != endPoints.end (); i++)
+            {
+              if ((*i)->GetLocalAddress () == localAddress
+                  && (*i)->GetPeerPort () == peerPort
+                  && (*i)->GetPeerAddress () == peerAddress)
+                {
+                  duplicate = true;
+                  break;
+                }
+            }
         }
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (localAddress, localPort);
-  endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
-
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-
+  if (duplicate)
+    {
+      NS_LOG_WARN ("No way we can allocate this end-point.");
+      /* no way we can allocate this end-point. */
+      delete endPoint;
+      return 0;
+    }
+  Add (endPoint);
   return endPoint;
 }
 
 void Ipv6EndPointDemux::DeAllocate (Ipv6EndPoint *endPoint)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  if (endPoint->m_demux != this)
+    {
+      return;
+    }
+  Unindex (endPoint);
+  endPoint->m_demux = 0;
+  --m_nEndPoints;
+  delete endPoint;
+}
+
+void Ipv6EndPointDemux::Match (Ipv6EndPoint *endP, Ipv6Address daddr,
+                               Ipv6Address saddr, uint16_t sport,
+                               Ptr<Ipv6Interface> incomingInterface,
+                               EndPoints retval[4])
+{
+  NS_LOG_DEBUG ("Looking at endpoint dport=" << endP->GetLocalPort ()
+                                             << " daddr=" << endP->GetLocalAddress ()
+                                             << " sport=" << endP->GetPeerPort ()
+                                             << " saddr=" << endP->GetPeerAddress ());
+
+  if (!endP->IsRxEnabled ())
     {
-      if (*i == endPoint)
+      NS_LOG_LOGIC ("Skipping endpoint " << &endP
+                    << " because endpoint can not receive packets");
+      return;
+    }
+
+  if (endP->GetBoundNetDevice ())
+    {
+      if (!incomingInterface)
+        {
+          return;
+        }
+      if (endP->GetBoundNetDevice () != incomingInterface->GetDevice ())
         {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
+          NS_LOG_LOGIC ("Skipping endpoint " << &endP
+                                             << " because endpoint is bound to specific device and"
+                                             << endP->GetBoundNetDevice ()
+                                             << " does not match packet device " << incomingInterface->GetDevice ());
+          return;
         }
     }
+
+  /*    Ipv6Address incomingInterfaceAddr = incomingInterface->GetAddress (); */
+  NS_LOG_DEBUG ("dest addr " << daddr);
+
+  bool localAddressMatchesWildCard = endP->GetLocalAddress () == Ipv6Address::GetAny ();
+  bool localAddressMatchesExact = endP->GetLocalAddress () == daddr;
+  bool localAddressMatchesAllRouters = endP->GetLocalAddress () == Ipv6Address::GetAllRoutersMulticast ();
+
+  /* if no match here, keep looking */
+  if (!(localAddressMatchesExact || localAddressMatchesWildCard))
+    {
+      return;
+    }
+  bool remotePeerMatchesExact = endP->GetPeerPort () == sport;
+  bool remotePeerMatchesWildCard = endP->GetPeerPort () == 0;
+  bool remoteAddressMatchesExact = endP->GetPeerAddress () == saddr;
+  bool remoteAddressMatchesWildCard = endP->GetPeerAddress () == Ipv6Address::GetAny ();
+
+  /* If remote does not match either with exact or wildcard,i
+     skip this one */
+  if (!(remotePeerMatchesExact || remotePeerMatchesWildCard))
+    {
+      return;
+    }
+  if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
+    {
+      return;
+    }
+
+  /* Now figure out which return list to add this one to */
+  if (localAddressMatchesWildCard
+      && remotePeerMatchesWildCard
+      && remoteAddressMatchesWildCard)
+    { /* Only local port matches exactly */
+      retval[0].push_back (endP);
+    }
+  if ((localAddressMatchesExact || (localAddressMatchesAllRouters))
+      && remotePeerMatchesWildCard
+      && remoteAddressMatchesWildCard)
+    { /* Only local port and local address matches exactly */
+      retval[1].push_back (endP);
+    }
+  if (localAddressMatchesWildCard
+      && remotePeerMatchesExact
+      && remoteAddressMatchesExact)
+    { /* All but local address */
+      retval[2].push_back (endP);
+    }
+  if (localAddressMatchesExact
+      && remotePeerMatchesExact
+      && remoteAddressMatchesExact)
+    { /* All 4 match */
+      retval[3].push_back (endP);
+    }
 }
 
 /*
@@ -173,137 +388,101 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint1
 {
   NS_LOG_FUNCTION (this << daddr << dport << saddr << sport << incomingInterface);
 
-  EndPoints retval1; /* Matches exact on local port, wildcards on others */
-  EndPoints retval2; /* Matches exact on local port/adder, wildcards on others */
-  EndPoints retval3; /* Matches all but local address */
-  EndPoints retval4; /* Exact match on all 4 */
+  /* retval[0]: Matches exact on local port, wildcards on others
+     retval[1]: Matches exact on local port/adder, wildcards on others
+     retval[2]: Matches all but local address
+     retval[3]: Exact match on all 4 */
+  EndPoints retval[4];
 
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  PortEndPoints::iterator entry = m_ports.find (dport);
+  if (entry == m_ports.end ())
     {
-      Ipv6EndPoint* endP = *i;
-
-      NS_LOG_DEBUG ("Looking at endpoint dport=" << endP->GetLocalPort ()
-                                                 << " daddr=" << endP->GetLocalAddress ()
-                                                 << " sport=" << endP->GetPeerPort ()
-                                                 << " saddr=" << endP->GetPeerAddress ());
-
-      if (!endP->IsRxEnabled ())
-        {
-          NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                        << " because endpoint can not receive packets");
-          continue;
-        }
-
-      if (endP->GetLocalPort () != dport)
-        {
-          NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                                             << " because endpoint dport "
-                                             << endP->GetLocalPort ()
-                                             << " does not match packet dport " << dport);
-          continue;
-        }
+      NS_LOG_LOGIC ("No endpoint bound to port " << dport);
+      return retval[0];
+    }
 
-      if (endP->GetBoundNetDevice ())
+  /* The connected end points can only match exactly */
+  if (entry->second.nConnected > 0)
+    {
+      ConnectedKey key;
+      key.localAddress = daddr;
+      key.peerAddress = saddr;
+      key.localPort = dport;
+      key.peerPort = sport;
+      ConnectedEndPoints::iterator i = m_connected.find (key);
+      if (i != m_connected.end ())
         {
-          if (!incomingInterface)
+          for (std::vector<Ipv6EndPoint *>::iterator j = i->second.begin (); j != i->second.end (); j++)
             {
-              continue;
+              Match (*j, daddr, saddr, sport, incomingInterface, retval);
             }
-          if (endP->GetBoundNetDevice () != incomingInterface->GetDevice ())
+          if (!retval[3].empty ())
             {
-              NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                                                 << " because endpoint is bound to specific device and"
-                                                 << endP->GetBoundNetDevice ()
-                                                 << " does not match packet device " << incomingInterface->GetDevice ());
-              continue;
+              return retval[3];
             }
         }
+    }
 
-      /*    Ipv6Address incomingInterfaceAddr = incomingInterface->GetAddress (); */
-      NS_LOG_DEBUG ("dest addr " << daddr);
-
-      bool localAddressMatchesWildCard = endP->GetLocalAddress () == Ipv6Address::GetAny ();
-      bool localAddressMatchesExact = endP->GetLocalAddress () == daddr;
-      bool localAddressMatchesAllRouters = endP->GetLocalAddress () == Ipv6Address::GetAllRoutersMulticast ();
-
-      /* if no match here, keep looking */
-      if (!(localAddressMatchesExact || localAddressMatchesWildCard))
-        {
-          continue;
-        }
-      bool remotePeerMatchesExact = endP->GetPeerPort () == sport;
-      bool remotePeerMatchesWildCard = endP->GetPeerPort () == 0;
-      bool remoteAddressMatchesExact = endP->GetPeerAddress () == saddr;
-      bool remoteAddressMatchesWildCard = endP->GetPeerAddress () == Ipv6Address::GetAny ();
-
-      /* If remote does not match either with exact or wildcard,i
-         skip this one */
-      if (!(remotePeerMatchesExact || remotePeerMatchesWildCard))
-        {
-          continue;
-        }
-      if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
-        {
-          continue;
-        }
-
-      /* Now figure out which return list to add this one to */
-      if (localAddressMatchesWildCard
-          && remotePeerMatchesWildCard
-          && remoteAddressMatchesWildCard)
-        { /* Only local port matches exactly */
-          retval1.push_back (endP);
-        }
-      if ((localAddressMatchesExact || (localAddressMatchesAllRouters))
-          && remotePeerMatchesWildCard
-          && remoteAddressMatchesWildCard)
-        { /* Only local port and local address matches exactly */
-          retval2.push_back (endP);
-        }
-      if (localAddressMatchesWildCard
-          && remotePeerMatchesExact
-          && remoteAddressMatchesExact)
-        { /* All but local address */
-          retval3.push_back (endP);
-        }
-      if (localAddressMatchesExact
-          && remotePeerMatchesExact
-          && remoteAddressMatchesExact)
-        { /* All 4 match */
-          retval4.push_back (endP);
-        }
+  std::vector<Ipv6EndPoint *> &endPoints = entry->second.endPoints;
+  for (std::vector<Ipv6EndPoint *>::iterator i = endPoints.begin (); i != endPoints.end (); i++)
+    {
+      Match (*i, daddr, saddr, sport, incomingInterface, retval);
     }
 
   /* Here we find the most exact match */
-  if (!retval4.empty ())
+  if (!retval[3].empty ())
     {
-      return retval4;
+      return retval[3];
     }
-  if (!retval3.empty ())
+  if (!retval[2].empty ())
     {
-      return retval3;
+      return retval[2];
     }
-  if (!retval2.empty ())
+  if (!retval[1].empty ())
     {
-      return retval2;
+      return retval[1];
     }
-  return retval1;  /* might be empty if no matches */
+  return retval[0];  /* might be empty if no matches */
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::SimpleLookup (Ipv6Address dst, uint16_t dport, Ipv6Address src, uint16_t sport)
 {
+  ConnectedKey key;
+  key.localAddress = dst;
+  key.peerAddress = src;
+  key.localPort = dport;
+  key.peerPort = sport;
+  ConnectedEndPoints::iterator connected = m_connected.find (key);
+  if (connected != m_connected.end ())
+    {
+      /* this is an exact match. */
+      return connected->second.front ();
+    }
+  PortEndPoints::iterator entry = m_ports.find (dport);
+  if (entry == m_ports.end ())
+    {
+      return 0;
+    }
+
   uint32_t genericity = 3;
   Ipv6EndPoint *generic = 0;
-
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  EndPoints endPoints (entry->second.endPoints.begin (), entry->second.endPoints.end ());
+  if (entry->second.nConnected > 0)
     {
-      uint32_t tmp = 0;
-
-      if ((*i)->GetLocalPort () != dport)
+      /* only reached for the ICMP errors of an unknown connection */
+      for (ConnectedEndPoints::iterator i = m_connected.begin (); i != m_connected.end (); i++)
         {
-          continue;
+          if (i->first.localPort == dport)
+            {
+              endPoints.insert (endPoints.end (), i->second.begin (), i->second.end ());
+            }
         }
+    }
+
+  for (EndPointsI i = endPoints.begin (); i != endPoints.end (); i++)
+    {
+      uint32_t tmp = 0;
 
       if ((*i)->GetLocalAddress () == dst && (*i)->GetPeerPort () == sport
           && (*i)->GetPeerAddress () == src)
@@ -355,7 +534,17 @@ uint16_t Ipv6EndPointDemux::AllocateEphemeralPort ()
 
 Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::GetEndPoints () const
 {
-  return m_endPoints;
+  EndPoints ret;
+
+  for (PortEndPoints::const_iterator i = m_ports.begin (); i != m_ports.end (); i++)
+    {
+      ret.insert (ret.end (), i->second.endPoints.begin (), i->second.endPoints.end ());
+    }
+  for (ConnectedEndPoints::const_iterator i = m_connected.begin (); i != m_connected.end (); i++)
+    {
+      ret.insert (ret.end (), i->second.begin (), i->second.end ());
+    }
+  return ret;
 }
 
 } /* namespace ns3 */
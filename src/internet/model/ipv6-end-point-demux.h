@@ -23,6 +23,8 @@
 
 #include <stdint.h>
 #include <list>
+#include <vector>
+#include <unordered_map>
 #include "ns3/ipv6-address.h"
 #include "ipv6-interface.h"
 
@@ -34,6 +36,10 @@ class Ipv6EndPoint;
  * \ingroup ipv6
  *
  * \brief Demultiplexer for end points.
+ *
+ * As in Ipv4EndPointDemux, the connected end points are kept in a hash
+ * table on their four-tuple, and the other ones in lists indexed by local
+ * port.
  */
 class Ipv6EndPointDemux
 {
@@ -169,9 +175,124 @@ private:
   uint16_t m_portLast;
 
   /**
-   * \brief A list of IPv6 end points.
+   * \brief Addresses and ports of a connected end point.
+   */
+  struct ConnectedKey
+  {
+    Ipv6Address localAddress; //!< the local address
+    Ipv6Address peerAddress;  //!< the peer address
+    uint16_t localPort;       //!< the local port
+    uint16_t peerPort;        //!< the peer port
+
+    /**
+     * \brief Compare two keys
+     * \param other the other key
+     * \returns true if the keys are equal
+     */
+    bool operator== (const ConnectedKey &other) const;
+  };
+
+  /**
+   * \brief Hash function of the connected end points.
+   */
+  struct ConnectedKeyHash
+  {
+    /**
+     * \brief Hash a key
+     * \param key the key
+     * \returns the hash of the key
+     */
+    size_t operator() (const ConnectedKey &key) const;
+  };
+
+  /**
+   * \brief End points bound to a local port.
+   */
+  struct PortEntry
+  {
+    PortEntry ();
+    std::vector<Ipv6EndPoint *> endPoints; //!< the end points with wildcards
+    uint32_t nConnected;                   //!< the number of connected end points
+  };
+
+  /**
+   * \brief Container of the connected end points.
+   */
+  typedef std::unordered_map<ConnectedKey, std::vector<Ipv6EndPoint *>, ConnectedKeyHash> ConnectedEndPoints;
+
+  /**
+   * \brief Container of the end points by local port.
+   */
+  typedef std::unordered_map<uint16_t, PortEntry> PortEndPoints;
+
+  /**
+   * \brief Check whether the four-tuple of an end point is fully specified.
+   * \param endPoint the end point
+   * \returns true if the end point is connected
+   */
+  static bool IsConnected (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Get the key of a connected end point.
+   * \param endPoint the end point
+   * \returns the key of the end point
    */
-  EndPoints m_endPoints;
+  static ConnectedKey GetKey (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Add an end point to the indexes.
+   *
+   * Also called by the end point after its addresses change.
+   *
+   * \param endPoint the end point
+   */
+  void Index (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Remove an end point from the indexes.
+   *
+   * Also called by the end point before its addresses change.
+   *
+   * \param endPoint the end point
+   */
+  void Unindex (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Register a new end point.
+   * \param endPoint the end point
+   */
+  void Add (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Classify an end point matching a packet by precedence.
+   * \param endP the end point
+   * \param daddr destination address of the packet
+   * \param saddr source address of the packet
+   * \param sport source port of the packet
+   * \param incomingInterface the incoming interface
+   * \param retval the lists of matches, from the least to the most exact
+   */
+  void Match (Ipv6EndPoint *endP, Ipv6Address daddr,
+              Ipv6Address saddr, uint16_t sport,
+              Ptr<Ipv6Interface> incomingInterface,
+              EndPoints retval[4]);
+
+  /**
+   * \brief The connected end points.
+   */
+  ConnectedEndPoints m_connected;
+
+  /**
+   * \brief The end points by local port.
+   */
+  PortEndPoints m_ports;
+
+  /**
+   * \brief The number of end points.
+   */
+  uint32_t m_nEndPoints;
+
+  friend class Ipv6EndPoint;
 };
 
 } /* namespace ns3 */
@@ -139,11 +139,7 @@ void Ipv6L3Protocol::DoDispose ()
   NS_LOG_FUNCTION_NOARGS ();
 
   /* clear protocol and interface list */
-  for (L4List_t::iterator it = m_protocols.begin (); it != m_protocols.end (); ++it)
-    {
-      it->second = 0;
-    }
-  m_protocols.clear ();
+  m_protocols.Clear ();
 
   /* remove interfaces */
   for (Ipv6InterfaceList::iterator it = m_interfaces.begin (); it != m_interfaces.end (); ++it)
@@ -722,90 +718,54 @@ void Ipv6L3Protocol::SetNode (Ptr<Node> node)
 void Ipv6L3Protocol::Insert (Ptr<IpL4Protocol> protocol)
 {
   NS_LOG_FUNCTION (this << protocol);
-  L4ListKey_t key = std::make_pair (protocol->GetProtocolNumber (), -1);
-  if (m_protocols.find (key) != m_protocols.end ())
+  if (!m_protocols.Insert (protocol, -1))
     {
       NS_LOG_WARN ("Overwriting default protocol " << int(protocol->GetProtocolNumber ()));
     }
-  m_protocols[key] = protocol;
 }
 
 void Ipv6L3Protocol::Insert (Ptr<IpL4Protocol> protocol, uint32_t interfaceIndex)
 {
   NS_LOG_FUNCTION (this << protocol << interfaceIndex);
 
-  L4ListKey_t key = std::make_pair (protocol->GetProtocolNumber (), interfaceIndex);
-  if (m_protocols.find (key) != m_protocols.end ())
+  if (!m_protocols.Insert (protocol, interfaceIndex))
     {
       NS_LOG_WARN ("Overwriting protocol " << int(protocol->GetProtocolNumber ()) << " on interface " << int(interfaceIndex));
     }
-  m_protocols[key] = protocol;
 }
 
 void Ipv6L3Protocol::Remove (Ptr<IpL4Protocol> protocol)
 {
   NS_LOG_FUNCTION (this << protocol);
 
-  L4ListKey_t key = std::make_pair (protocol->GetProtocolNumber (), -1);
-  L4List_t::iterator iter = m_protocols.find (key);
-  if (iter == m_protocols.end ())
+  if (!m_protocols.Remove (protocol->GetProtocolNumber (), -1))
     {
       NS_LOG_WARN ("Trying to remove an non-existent default protocol " << int(protocol->GetProtocolNumber ()));
     }
-  else
-    {
-      m_protocols.erase (key);
-    }
 }
 
 void Ipv6L3Protocol::Remove (Ptr<IpL4Protocol> protocol, uint32_t interfaceIndex)
 {
   NS_LOG_FUNCTION (this << protocol << interfaceIndex);
 
-  L4ListKey_t key = std::make_pair (protocol->GetProtocolNumber (), interfaceIndex);
-  L4List_t::iterator iter = m_protocols.find (key);
-  if (iter == m_protocols.end ())
+  if (!m_protocols.Remove (protocol->GetProtocolNumber (), interfaceIndex))
     {
       NS_LOG_WARN ("Trying to remove an non-existent protocol " << int(protocol->GetProtocolNumber ()) << " on interface " << int(interfaceIndex));
     }
-  else
-    {
-      m_protocols.erase (key);
-    }
 }
 
 Ptr<IpL4Protocol> Ipv6L3Protocol::GetProtocol (int protocolNumber) const
 {
   NS_LOG_FUNCTION (this << protocolNumber);
 
-  return GetProtocol (protocolNumber, -1);
+  return m_protocols.Get (protocolNumber, -1);
 }
 
 Ptr<IpL4Protocol> Ipv6L3Protocol::GetProtocol (int protocolNumber, int32_t interfaceIndex) const
 {
   NS_LOG_FUNCTION (this << protocolNumber << interfaceIndex);
 
-  L4ListKey_t key;
-  L4List_t::const_iterator i;
-  if (interfaceIndex >= 0)
-    {
-      // try the interface-specific protocol.
-      key = std::make_pair (protocolNumber, interfaceIndex);
-      i = m_protocols.find (key);
-      if (i != m_protocols.end ())
-        {
-          return i->second;
-        }
-    }
-  // try the generic protocol.
-  key = std::make_pair (protocolNumber, -1);
-  i = m_protocols.find (key);
-  if (i != m_protocols.end ())
-    {
-      return i->second;
-    }
-
-  return 0;
+  return m_protocols.Get (protocolNumber, interfaceIndex);
 }
 
 Ptr<Socket> Ipv6L3Protocol::CreateRawSocket ()
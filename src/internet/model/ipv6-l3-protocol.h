@@ -29,6 +29,7 @@
 #include "ns3/ipv6-address.h"
 #include "ns3/ipv6-header.h"
 #include "ns3/ipv6-pmtu-cache.h"
+#include "ip-l4-protocol-table.h"
 
 class Ipv6L3ProtocolTestCase;
 
@@ -481,16 +482,6 @@ private:
    */
   typedef std::list<Ptr<Ipv6RawSocketImpl> > SocketList;
 
-  /**
-   * \brief Container of the IPv6 L4 keys: protocol number, interface index
-   */
-  typedef std::pair<int, int32_t> L4ListKey_t;
-
-  /**
-   * \brief Container of the IPv6 L4 instances.
-   */
-  typedef std::map<L4ListKey_t, Ptr<IpL4Protocol> > L4List_t;
-
   /**
    * \brief Container of the IPv6 Autoconfigured addresses.
    */
@@ -682,7 +673,7 @@ private:
   /**
    * \brief List of transport protocol.
    */
-  L4List_t m_protocols;
+  IpL4ProtocolTable m_protocols;
 
   /**
    * \brief List of IPv6 interfaces.
@@ -23,8 +23,6 @@
 
 #include "ns3/log.h"
 #include "ns3/enum.h"
-#include "ns3/tcp-header.h"
-#include "ns3/udp-header.h"
 #include "ipv6-queue-disc-item.h"
 #include "ipv6-packet-filter.h"
 
@@ -99,51 +97,59 @@ FqCoDelIpv6PacketFilter::DoClassify (Ptr< QueueDiscItem > item) const
 
   NS_ASSERT (ipv6Item != 0);
 
-  Ipv6Header hdr = ipv6Item->GetHeader ();
-  Ipv6Address src = hdr.GetSourceAddress ();
-  Ipv6Address dest = hdr.GetDestinationAddress ();
-  uint8_t prot = hdr.GetNextHeader ();
+  uint32_t hash = ipv6Item->Hash (m_perturbation);
 
-  TcpHeader tcpHdr;
-  UdpHeader udpHdr;
-  uint16_t srcPort = 0;
-  uint16_t destPort = 0;
+  NS_LOG_DEBUG ("Found Ipv6 packet; hash value " << hash);
 
-  Ptr<Packet> pkt = ipv6Item->GetPacket ();
+  return hash;
+}
 
-  if (prot == 6) // TCP
-    {
-      pkt->PeekHeader (tcpHdr);
-      srcPort = tcpHdr.GetSourcePort ();
-      destPort = tcpHdr.GetDestinationPort ();
-    }
-  else if (prot == 17) // UDP
+// ------------------------------------------------------------------------- //
+
+NS_OBJECT_ENSURE_REGISTERED (PrioIpv6PacketFilter);
+
+TypeId
+PrioIpv6PacketFilter::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PrioIpv6PacketFilter")
+    .SetParent<Ipv6PacketFilter> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<PrioIpv6PacketFilter> ()
+  ;
+  return tid;
+}
+
+PrioIpv6PacketFilter::PrioIpv6PacketFilter ()
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < 64; i++)
     {
-      pkt->PeekHeader (udpHdr);
-      srcPort = udpHdr.GetSourcePort ();
-      destPort = udpHdr.GetDestinationPort ();
+      m_bands[i] = PF_NO_MATCH;
     }
+}
 
-  /* serialize the 5-tuple and the perturbation in buf */
-  uint8_t buf[41];
-  src.Serialize (buf);
-  dest.Serialize (buf + 16);
-  buf[32] = prot;
-  buf[33] = (srcPort >> 8) & 0xff;
-  buf[34] = srcPort & 0xff;
-  buf[35] = (destPort >> 8) & 0xff;
-  buf[36] = destPort & 0xff;
-  buf[37] = (m_perturbation >> 24) & 0xff;
-  buf[38] = (m_perturbation >> 16) & 0xff;
-  buf[39] = (m_perturbation >> 8) & 0xff;
-  buf[40] = m_perturbation & 0xff;
-
-  /* Linux calculates the jhash2 (jenkins hash), we calculate the murmur3 */
-  uint32_t hash = Hash32 ((char*) buf, 41);
-
-  NS_LOG_DEBUG ("Found Ipv6 packet; hash of the five tuple " << hash);
+PrioIpv6PacketFilter::~PrioIpv6PacketFilter ()
+{
+  NS_LOG_FUNCTION (this);
+}
 
-  return hash;
+void
+PrioIpv6PacketFilter::SetBand (Ipv6Header::DscpType dscp, uint32_t band)
+{
+  NS_LOG_FUNCTION (this << dscp << band);
+  NS_ASSERT (dscp < 64);
+  m_bands[dscp] = band;
+}
+
+int32_t
+PrioIpv6PacketFilter::DoClassify (Ptr<QueueDiscItem> item) const
+{
+  NS_LOG_FUNCTION (this << item);
+  Ptr<Ipv6QueueDiscItem> ipv6Item = DynamicCast<Ipv6QueueDiscItem> (item);
+
+  NS_ASSERT (ipv6Item != 0);
+
+  return m_bands[ipv6Item->GetHeader ().GetDscp ()];
 }
 
 } // namespace ns3
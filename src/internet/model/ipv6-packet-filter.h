@@ -26,6 +26,7 @@
 
 #include "ns3/object.h"
 #include "ns3/packet-filter.h"
+#include "ipv6-header.h"
 
 namespace ns3 {
 
@@ -76,6 +77,38 @@ private:
   uint32_t m_perturbation; //!< hash perturbation value
 };
 
+
+/**
+ * \ingroup internet
+ *
+ * PrioIpv6PacketFilter classifies IPv6 packets by their DSCP, so that
+ * the priority queue disc serves them in the band configured for their
+ * DSCP. Packets whose DSCP has no band configured are not matched.
+ */
+class PrioIpv6PacketFilter : public Ipv6PacketFilter {
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  PrioIpv6PacketFilter ();
+  virtual ~PrioIpv6PacketFilter ();
+
+  /**
+   * \brief Set the band of the packets carrying a DSCP
+   * \param dscp the DSCP
+   * \param band the band of the priority queue disc
+   */
+  void SetBand (Ipv6Header::DscpType dscp, uint32_t band);
+
+private:
+  virtual int32_t DoClassify (Ptr<QueueDiscItem> item) const;
+
+  int32_t m_bands[64]; //!< band of each DSCP, PF_NO_MATCH if not configured
+};
+
 } // namespace ns3
 
 #endif /* IPV6_PACKET_FILTER */
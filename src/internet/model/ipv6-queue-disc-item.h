@@ -85,6 +85,14 @@ public:
    */
   virtual bool Mark (void);
 
+  /**
+   * \brief Computes the hash of the packet's 5-tuple
+   *
+   * \param perturbation hash perturbation value
+   * \return the hash of the packet's 5-tuple
+   */
+  virtual uint32_t Hash (uint32_t perturbation = 0) const;
+
 private:
   /**
    * \brief Default constructor
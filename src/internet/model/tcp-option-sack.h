@@ -0,0 +1,88 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef TCP_OPTION_SACK_H
+#define TCP_OPTION_SACK_H
+
+#include <list>
+#include "ns3/tcp-option.h"
+#include "ns3/sequence-number.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup tcp
+ *
+ * \brief Defines the TCP option of kind 5 (selective acknowledgment option) as in \RFC{2018}
+ *
+ * Each block reports a contiguous range of data received and queued by
+ * the receiver beyond the cumulative acknowledgment: the first sequence
+ * number of the block and the sequence number immediately following the
+ * last byte of the block.
+ */
+class TcpOptionSack : public TcpOption
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  /// A SACK block, [left edge, right edge)
+  typedef std::pair<SequenceNumber32, SequenceNumber32> SackBlock;
+  /// List of SACK blocks, in the order of the option
+  typedef std::list<SackBlock> SackList;
+
+  TcpOptionSack ();
+  virtual ~TcpOptionSack ();
+
+  virtual void Print (std::ostream &os) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+  virtual uint8_t GetKind (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+
+  /**
+   * \brief Append a block to the option
+   * \param block the block
+   */
+  void AddSackBlock (SackBlock block);
+  /**
+   * \brief Get the number of blocks in the option
+   * \return the number of blocks
+   */
+  uint32_t GetNumSackBlocks (void) const;
+  /**
+   * \brief Get the blocks of the option
+   * \return the list of blocks
+   */
+  const SackList &GetSackList (void) const;
+  /**
+   * \brief Remove all the blocks
+   */
+  void ClearSackList (void);
+
+protected:
+  SackList m_sackList; //!< the SACK blocks
+};
+
+} // namespace ns3
+
+#endif /* TCP_OPTION_SACK_H */
@@ -22,6 +22,8 @@
 #include "tcp-option-rfc793.h"
 #include "tcp-option-winscale.h"
 #include "tcp-option-ts.h"
+#include "tcp-option-sack-permitted.h"
+#include "tcp-option-sack.h"
 
 #include "ns3/type-id.h"
 #include "ns3/log.h"
@@ -68,7 +70,7 @@ TcpOption::CreateOption (uint8_t kind)
     TypeId tid;
   };
 
-  static ObjectFactory objectFactory;
+  static thread_local ObjectFactory objectFactory;
   static kindToTid toTid[] =
   {
     { TcpOption::END,       TcpOptionEnd::GetTypeId () },
@@ -76,6 +78,8 @@ TcpOption::CreateOption (uint8_t kind)
     { TcpOption::NOP,       TcpOptionNOP::GetTypeId () },
     { TcpOption::TS,        TcpOptionTS::GetTypeId () },
     { TcpOption::WINSCALE,  TcpOptionWinScale::GetTypeId () },
+    { TcpOption::SACKPERMITTED, TcpOptionSackPermitted::GetTypeId () },
+    { TcpOption::SACK,      TcpOptionSack::GetTypeId () },
     { TcpOption::UNKNOWN,  TcpOptionUnknown::GetTypeId () }
   };
 
@@ -101,6 +105,8 @@ TcpOption::IsKindKnown (uint8_t kind)
     case MSS:
     case WINSCALE:
     case TS:
+    case SACKPERMITTED:
+    case SACK:
     // Do not add UNKNOWN here
       return true;
     }
@@ -18,6 +18,8 @@
  * Author: Adrian Sai-wah Tam <adrian.sw.tam@gmail.com>
  */
 
+#include <vector>
+
 #include "ns3/packet.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
@@ -52,7 +54,8 @@ TcpRxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpRxBuffer::TcpRxBuffer (uint32_t n)
-  : m_nextRxSeq (n), m_gotFin (false), m_size (0), m_maxBuffer (32768), m_availBytes (0)
+  : m_nextRxSeq (n), m_gotFin (false), m_size (0), m_maxBuffer (32768), m_availBytes (0),
+    m_lastAddedSeq (n)
 {
 }
 
@@ -156,61 +159,59 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
       if (maxSeq < tailSeq) tailSeq = maxSeq;
       if (tailSeq < headSeq) headSeq = tailSeq;
     }
-  // Remove overlapped bytes from packet
-  BufIterator i = m_data.begin ();
-  while (i != m_data.end () && i->first <= tailSeq)
+  // Find the parts of the packet which are not buffered yet
+  std::vector<std::pair<SequenceNumber32, SequenceNumber32> > holes;
+  SequenceNumber32 seq = headSeq;
+  BufIterator i = m_data.upper_bound (headSeq);
+  if (i != m_data.begin ())
     {
-      SequenceNumber32 lastByteSeq = i->first + SequenceNumber32 (i->second->GetSize ());
-      if (lastByteSeq > headSeq)
+      --i;
+    }
+  for (; i != m_data.end () && i->first < tailSeq && seq < tailSeq; ++i)
+    {
+      SequenceNumber32 lastByteSeq = i->first + SequenceNumber32 (i->second.size);
+      if (i->first > seq)
         {
-          if (i->first > headSeq && lastByteSeq < tailSeq)
-            { // Rare case: Existing packet is embedded fully in the new packet
-              m_size -= i->second->GetSize ();
-              m_data.erase (i++);
-              continue;
-            }
-          if (i->first <= headSeq)
-            { // Incoming head is overlapped
-              headSeq = lastByteSeq;
-            }
-          if (lastByteSeq >= tailSeq)
-            { // Incoming tail is overlapped
-              tailSeq = i->first;
-            }
+          holes.push_back (std::make_pair (seq, i->first));
+        }
+      if (lastByteSeq > seq)
+        {
+          seq = lastByteSeq;
         }
-      ++i;
     }
-  // We now know how much we are going to store, trim the packet
-  if (headSeq >= tailSeq)
+  if (seq < tailSeq)
     {
-      NS_LOG_LOGIC ("Nothing to buffer");
-      return false; // Nothing to buffer anyway
+      holes.push_back (std::make_pair (seq, tailSeq));
     }
-  else
+  if (holes.empty ())
     {
-      uint32_t start = headSeq - tcph.GetSequenceNumber ();
-      uint32_t length = tailSeq - headSeq;
-      p = p->CreateFragment (start, length);
-      NS_ASSERT (length == p->GetSize ());
+      NS_LOG_LOGIC ("Nothing to buffer");
+      return false; // Nothing to buffer anyway
     }
-  // Insert packet into buffer
-  NS_ASSERT (m_data.find (headSeq) == m_data.end ()); // Shouldn't be there yet
-  m_data [ headSeq ] = p;
-  NS_LOG_LOGIC ("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize ());
-  // Update variables
-  m_size += p->GetSize ();      // Occupancy
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
+  m_lastAddedSeq = holes.front ().first;
+  // Insert the missing parts into the buffer
+  for (std::vector<std::pair<SequenceNumber32, SequenceNumber32> >::const_iterator h = holes.begin ();
+       h != holes.end (); ++h)
     {
-      if (i->first < m_nextRxSeq)
+      uint32_t start = h->first - tcph.GetSequenceNumber ();
+      uint32_t length = h->second - h->first;
+      Ptr<Packet> fragment = p;
+      if (length != pktSize)
         {
-          continue;
+          fragment = p->CreateFragment (start, length);
         }
-      else if (i->first > m_nextRxSeq)
-        {
-          break;
-        };
-      m_nextRxSeq = i->first + SequenceNumber32 (i->second->GetSize ());
-      m_availBytes += i->second->GetSize ();
+      NS_ASSERT (length == fragment->GetSize ());
+      Insert (h->first, fragment);
+      m_size += length;      // Occupancy
+      NS_LOG_LOGIC ("Buffered packet of seqno=" << h->first << " len=" << length);
+    }
+  // Only the first interval can hold in-sequence data
+  BufIterator first = m_data.begin ();
+  SequenceNumber32 lastByteSeq = first->first + SequenceNumber32 (first->second.size);
+  if (first->first <= m_nextRxSeq && lastByteSeq > m_nextRxSeq)
+    {
+      m_availBytes += lastByteSeq - m_nextRxSeq.Get ();
+      m_nextRxSeq = lastByteSeq;
     }
   NS_LOG_LOGIC ("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
   if (m_gotFin && m_nextRxSeq == m_finSeq)
@@ -220,6 +221,69 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
   return true;
 }
 
+TcpRxBuffer::BufIterator
+TcpRxBuffer::Insert (SequenceNumber32 head, Ptr<Packet> p)
+{
+  NS_LOG_FUNCTION (this << head << p);
+
+  SequenceNumber32 tail = head + SequenceNumber32 (p->GetSize ());
+  BufIterator next = m_data.lower_bound (head);
+  BufIterator cur = m_data.end ();
+  if (next != m_data.begin ())
+    {
+      BufIterator prev = next;
+      --prev;
+      NS_ASSERT (prev->first + SequenceNumber32 (prev->second.size) <= head);
+      if (prev->first + SequenceNumber32 (prev->second.size) == head)
+        { // The packet extends the previous interval, the usual in-order case
+          cur = prev;
+        }
+    }
+  if (cur == m_data.end ())
+    {
+      cur = m_data.insert (next, std::make_pair (head, Interval ()));
+      cur->second.size = 0;
+    }
+  Append (cur->second, p);
+  NS_ASSERT (next == m_data.end () || next->first >= tail);
+  if (next != m_data.end () && next->first == tail)
+    { // The packet fills a hole: merge the two intervals, moving the smaller one
+      Interval &a = cur->second;
+      Interval &b = next->second;
+      if (a.packets.back ()->IsVirtual () && b.packets.front ()->IsVirtual ())
+        {
+          a.packets.back () = Create<Packet> (a.packets.back ()->GetSize () + b.packets.front ()->GetSize ());
+          b.packets.pop_front ();
+        }
+      if (a.packets.size () >= b.packets.size ())
+        {
+          a.packets.insert (a.packets.end (), b.packets.begin (), b.packets.end ());
+        }
+      else
+        {
+          b.packets.insert (b.packets.begin (), a.packets.begin (), a.packets.end ());
+          a.packets.swap (b.packets);
+        }
+      a.size += b.size;
+      m_data.erase (next);
+    }
+  return cur;
+}
+
+void
+TcpRxBuffer::Append (Interval &interval, Ptr<Packet> p)
+{
+  if (p->IsVirtual () && !interval.packets.empty () && interval.packets.back ()->IsVirtual ())
+    { // Only the size of virtual payload matters, extend the last packet
+      interval.packets.back () = Create<Packet> (interval.packets.back ()->GetSize () + p->GetSize ());
+    }
+  else
+    {
+      interval.packets.push_back (p);
+    }
+  interval.size += p->GetSize ();
+}
+
 Ptr<Packet>
 TcpRxBuffer::Extract (uint32_t maxSize)
 {
@@ -229,54 +293,95 @@ TcpRxBuffer::Extract (uint32_t maxSize)
   NS_LOG_LOGIC ("Requested to extract " << extractSize << " bytes from TcpRxBuffer of size=" << m_size);
   if (extractSize == 0) return 0;  // No contiguous block to return
   NS_ASSERT (m_data.size ()); // At least we have something to extract
+  BufIterator i = m_data.begin ();
+  NS_ASSERT (i->first <= m_nextRxSeq); // in-sequence data expected
+  NS_ASSERT (i->second.size >= extractSize);
+  Interval &interval = i->second;
   Ptr<Packet> outPkt = Create<Packet> (); // The packet that contains all the data to return
-  BufIterator i;
-  while (extractSize)
+  uint32_t left = extractSize;
+  while (left)
     { // Check the buffered data for delivery
-      i = m_data.begin ();
-      NS_ASSERT (i->first <= m_nextRxSeq); // in-sequence data expected
+      Ptr<Packet> p = interval.packets.front ();
       // Check if we send the whole pkt or just a partial
-      uint32_t pktSize = i->second->GetSize ();
-      if (pktSize <= extractSize)
+      uint32_t pktSize = p->GetSize ();
+      if (pktSize <= left)
         { // Whole packet is extracted
-          if (outPkt->GetSize ())
-            {
-              outPkt->AddAtEnd (i->second);
-            }
-          else
-            {
-              outPkt = i->second;
-            }
-          m_data.erase (i);
-          m_size -= pktSize;
-          m_availBytes -= pktSize;
-          extractSize -= pktSize;
+          interval.packets.pop_front ();
         }
       else
         { // Partial is extracted and done
-          if (outPkt->GetSize ())
-            {
-              outPkt->AddAtEnd (i->second->CreateFragment (0, extractSize));
-            }
-          else
-            {
-              outPkt = i->second->CreateFragment (0, extractSize);
-            }
-          m_data[i->first + SequenceNumber32 (extractSize)] = i->second->CreateFragment (extractSize, pktSize - extractSize);
-          m_data.erase (i);
-          m_size -= extractSize;
-          m_availBytes -= extractSize;
-          extractSize = 0;
+          interval.packets.front () = p->CreateFragment (left, pktSize - left);
+          p = p->CreateFragment (0, left);
+        }
+      left -= p->GetSize ();
+      if (outPkt->GetSize ())
+        {
+          outPkt->AddAtEnd (p);
+        }
+      else
+        {
+          outPkt = p;
         }
     }
+  m_size -= extractSize;
+  m_availBytes -= extractSize;
+  interval.size -= extractSize;
+  if (interval.size > 0)
+    { // The remaining data now starts after the extracted bytes
+      SequenceNumber32 head = i->first + SequenceNumber32 (extractSize);
+      Interval &rest = m_data.insert (i, std::make_pair (head, Interval ()))->second;
+      rest.size = interval.size;
+      rest.packets.swap (interval.packets);
+    }
+  m_data.erase (i);
   if (outPkt->GetSize () == 0)
     {
       NS_LOG_LOGIC ("Nothing extracted.");
       return 0;
     }
   NS_LOG_LOGIC ("Extracted " << outPkt->GetSize ( ) << " bytes, bufsize=" << m_size
-                             << ", num pkts in buffer=" << m_data.size ());
+                             << ", num intervals in buffer=" << m_data.size ());
   return outPkt;
 }
 
+TcpOptionSack::SackList
+TcpRxBuffer::GetSackList (uint32_t maxBlocks) const
+{
+  NS_LOG_FUNCTION (this << maxBlocks);
+
+  TcpOptionSack::SackList list;
+  // Only the first interval may hold in-sequence data
+  IntervalMap::const_iterator first = m_data.begin ();
+  if (first != m_data.end () && first->first <= m_nextRxSeq)
+    {
+      ++first;
+    }
+  if (first == m_data.end () || maxBlocks == 0)
+    {
+      return list;
+    }
+  // The interval holding the last segment received comes first
+  IntervalMap::const_iterator last = m_data.upper_bound (m_lastAddedSeq);
+  if (last != m_data.begin ())
+    {
+      --last;
+    }
+  if (last->first > m_nextRxSeq)
+    {
+      list.push_back (std::make_pair (last->first, last->first + SequenceNumber32 (last->second.size)));
+    }
+  else
+    {
+      last = m_data.end ();
+    }
+  for (IntervalMap::const_iterator i = first; i != m_data.end () && list.size () < maxBlocks; ++i)
+    {
+      if (i != last)
+        {
+          list.push_back (std::make_pair (i->first, i->first + SequenceNumber32 (i->second.size)));
+        }
+    }
+  return list;
+}
+
 } //namepsace ns3
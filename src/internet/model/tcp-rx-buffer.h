@@ -21,12 +21,14 @@
 #ifndef TCP_RX_BUFFER_H
 #define TCP_RX_BUFFER_H
 
+#include <deque>
 #include <map>
 #include "ns3/traced-value.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/sequence-number.h"
 #include "ns3/ptr.h"
 #include "ns3/tcp-header.h"
+#include "ns3/tcp-option-sack.h"
 
 namespace ns3 {
 class Packet;
@@ -36,6 +38,15 @@ class Packet;
  *
  * \brief class for the reordering buffer that keeps the data from lower layer, i.e.
  *        TcpL4Protocol, sent to the application
+ *
+ * The data is kept as a set of disjoint intervals of sequence numbers,
+ * each holding the packets which cover it in order. A packet which is
+ * adjacent to an interval is appended or prepended to it, and two
+ * intervals that a packet joins are merged, so that the buffer holds
+ * one interval per hole in the sequence space, however reordered the
+ * segments are. Adjacent virtual packets (see Packet::IsVirtual) are
+ * merged into a single packet, so that the payload of bulk transfers
+ * is reassembled without copying bytes.
  */
 class TcpRxBuffer : public Object
 {
@@ -106,9 +117,8 @@ public:
   /**
    * Insert a packet into the buffer and update the availBytes counter to
    * reflect the number of bytes ready to send to the application. This
-   * function handles overlap by triming the head of the inputted packet and
-   * removing data from the buffer that overlaps the tail of the inputted
-   * packet
+   * function handles overlap by only inserting the parts of the inputted
+   * packet which are not buffered yet, within the receive window.
    *
    * \param p packet
    * \param tcph packet's TCP header
@@ -125,16 +135,56 @@ public:
    */
   Ptr<Packet> Extract (uint32_t maxSize);
 
+  /**
+   * \brief Get the SACK blocks describing the out-of-sequence data
+   *
+   * As required by \RFC{2018}, the first block holds the most recently
+   * received segment; the other blocks follow in sequence order.
+   *
+   * \param maxBlocks the maximum number of blocks to report
+   * \returns the list of blocks, empty if there is no out-of-sequence data
+   */
+  TcpOptionSack::SackList GetSackList (uint32_t maxBlocks) const;
+
 private:
-  /// container for data stored in the buffer
-  typedef std::map<SequenceNumber32, Ptr<Packet> >::iterator BufIterator;
+  /**
+   * \brief A contiguous interval of buffered data
+   */
+  struct Interval
+  {
+    uint32_t size;                     //!< Number of bytes in the interval
+    std::deque<Ptr<Packet> > packets;  //!< The packets covering the interval, in order
+  };
+  /// container for data stored in the buffer, indexed by the first sequence number
+  typedef std::map<SequenceNumber32, Interval> IntervalMap;
+  /// iterator on the intervals
+  typedef IntervalMap::iterator BufIterator;
+
+  /**
+   * \brief Store a packet which overlaps no buffered data
+   *
+   * The packet is merged with the intervals it is adjacent to.
+   *
+   * \param head the sequence number of the first byte of the packet
+   * \param p the packet
+   * \returns the interval now holding the packet
+   */
+  BufIterator Insert (SequenceNumber32 head, Ptr<Packet> p);
+  /**
+   * \brief Append a packet at the end of an interval
+   * \param interval the interval
+   * \param p the packet
+   */
+  static void Append (Interval &interval, Ptr<Packet> p);
+
   TracedValue<SequenceNumber32> m_nextRxSeq; //!< Seqnum of the first missing byte in data (RCV.NXT)
   SequenceNumber32 m_finSeq;                 //!< Seqnum of the FIN packet
   bool m_gotFin;                             //!< Did I received FIN packet?
   uint32_t m_size;                           //!< Number of total data bytes in the buffer, not necessarily contiguous
   uint32_t m_maxBuffer;                      //!< Upper bound of the number of data bytes in buffer (RCV.WND)
   uint32_t m_availBytes;                     //!< Number of bytes available to read, i.e. contiguous block at head
-  std::map<SequenceNumber32, Ptr<Packet> > m_data; //!< Corresponding data (may be null)
+  SequenceNumber32 m_lastAddedSeq;           //!< Seqnum of the first byte stored by the last Add
+  IntervalMap m_data;                        //!< Corresponding data, one entry per contiguous interval
 };
 
 } //namepsace ns3
@@ -49,6 +49,8 @@
 #include "tcp-header.h"
 #include "tcp-option-winscale.h"
 #include "tcp-option-ts.h"
+#include "tcp-option-sack-permitted.h"
+#include "tcp-option-sack.h"
 #include "rtt-estimator.h"
 #include "tcp-congestion-ops.h"
 
@@ -98,6 +100,16 @@ TcpSocketBase::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&TcpSocketBase::m_timestampEnabled),
                    MakeBooleanChecker ())
+    .AddAttribute ("Sack", "Enable or disable the SACK option and the "
+                   "scoreboard-based loss recovery",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::m_sackEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("TailLossProbe", "Enable or disable the tail loss probe "
+                   "(used only with SACK)",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&TcpSocketBase::m_tlpEnabled),
+                   MakeBooleanChecker ())
     .AddAttribute ("MinRto",
                    "Minimum retransmit timeout value",
                    TimeValue (Seconds (1.0)), // RFC 6298 says min RTO=1 sec, but Linux uses 200ms.
@@ -276,10 +288,10 @@ TcpSocketState::TcpCongStateName[TcpSocketState::CA_LAST_STATE] =
 
 TcpSocketBase::TcpSocketBase (void)
   : TcpSocket (),
-    m_retxEvent (),
+    m_retxTimer (Timer::CANCEL_ON_DESTROY),
     m_lastAckEvent (),
-    m_delAckEvent (),
-    m_persistEvent (),
+    m_delAckTimer (Timer::CANCEL_ON_DESTROY),
+    m_persistTimer (Timer::CANCEL_ON_DESTROY),
     m_timewaitEvent (),
     m_dupAckCount (0),
     m_delAckCount (0),
@@ -323,12 +335,17 @@ TcpSocketBase::TcpSocketBase (void)
     m_sndWindShift (0),
     m_timestampEnabled (true),
     m_timestampToEcho (0),
+    m_sackEnabled (false),
     m_sendPendingDataEvent (),
     // Set m_recover to the initial sequence number
     m_recover (0),
     m_retxThresh (3),
     m_limitedTx (false),
     m_retransOut (0),
+    m_rackEvent (),
+    m_tlpEnabled (true),
+    m_tlpOutstanding (false),
+    m_tlpHighSeq (0),
     m_congestionControl (0),
     m_isFirstPartialAck (true),
     m_ecn (false),
@@ -340,33 +357,44 @@ TcpSocketBase::TcpSocketBase (void)
   m_rxBuffer = CreateObject<TcpRxBuffer> ();
   m_txBuffer = CreateObject<TcpTxBuffer> ();
   m_tcb      = CreateObject<TcpSocketState> ();
+  m_retxTimer.SetFunction (&TcpSocketBase::RetxTimerExpired, this);
+  m_delAckTimer.SetFunction (&TcpSocketBase::DelAckTimeout, this);
+  m_persistTimer.SetFunction (&TcpSocketBase::PersistTimeout, this);
 
-  bool ok;
+  // Chain the trace sources of the TCB to ours, unless either side is
+  // compiled out
+  if (TRACES && TcpSocketState::TRACES)
+    {
+      bool ok;
 
-  ok = m_tcb->TraceConnectWithoutContext ("CongestionWindow",
-                                          MakeCallback (&TcpSocketBase::UpdateCwnd, this));
-  NS_ASSERT (ok == true);
+      ok = m_tcb->TraceConnectWithoutContext ("CongestionWindow",
+                                              MakeCallback (&TcpSocketBase::UpdateCwnd, this));
+      NS_ASSERT (ok == true);
 
-  ok = m_tcb->TraceConnectWithoutContext ("SlowStartThreshold",
-                                          MakeCallback (&TcpSocketBase::UpdateSsThresh, this));
-  NS_ASSERT (ok == true);
+      ok = m_tcb->TraceConnectWithoutContext ("SlowStartThreshold",
+                                              MakeCallback (&TcpSocketBase::UpdateSsThresh, this));
+      NS_ASSERT (ok == true);
 
-  ok = m_tcb->TraceConnectWithoutContext ("CongState",
-                                          MakeCallback (&TcpSocketBase::UpdateCongState, this));
-  NS_ASSERT (ok == true);
+      ok = m_tcb->TraceConnectWithoutContext ("CongState",
+                                              MakeCallback (&TcpSocketBase::UpdateCongState, this));
+      NS_ASSERT (ok == true);
 
-  ok = m_tcb->TraceConnectWithoutContext ("NextTxSequence",
-                                          MakeCallback (&TcpSocketBase::UpdateNextTxSequence, this));
-  NS_ASSERT (ok == true);
+      ok = m_tcb->TraceConnectWithoutContext ("NextTxSequence",
+                                              MakeCallback (&TcpSocketBase::UpdateNextTxSequence, this));
+      NS_ASSERT (ok == true);
 
-  ok = m_tcb->TraceConnectWithoutContext ("HighestSequence",
-                                          MakeCallback (&TcpSocketBase::UpdateHighTxMark, this));
-  NS_ASSERT (ok == true);
+      ok = m_tcb->TraceConnectWithoutContext ("HighestSequence",
+                                              MakeCallback (&TcpSocketBase::UpdateHighTxMark, this));
+      NS_ASSERT (ok == true);
+    }
 }
 
 TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
   : TcpSocket (sock),
     //copy object::m_tid and socket::callbacks
+    m_retxTimer (Timer::CANCEL_ON_DESTROY),
+    m_delAckTimer (Timer::CANCEL_ON_DESTROY),
+    m_persistTimer (Timer::CANCEL_ON_DESTROY),
     m_dupAckCount (sock.m_dupAckCount),
     m_delAckCount (0),
     m_delAckMaxCount (sock.m_delAckMaxCount),
@@ -405,10 +433,14 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
     m_sndWindShift (sock.m_sndWindShift),
     m_timestampEnabled (sock.m_timestampEnabled),
     m_timestampToEcho (sock.m_timestampToEcho),
+    m_sackEnabled (sock.m_sackEnabled),
     m_recover (sock.m_recover),
     m_retxThresh (sock.m_retxThresh),
     m_limitedTx (sock.m_limitedTx),
     m_retransOut (sock.m_retransOut),
+    m_tlpEnabled (sock.m_tlpEnabled),
+    m_tlpOutstanding (sock.m_tlpOutstanding),
+    m_tlpHighSeq (sock.m_tlpHighSeq),
     m_isFirstPartialAck (sock.m_isFirstPartialAck),
     m_txTrace (sock.m_txTrace),
     m_rxTrace (sock.m_rxTrace),
@@ -419,6 +451,9 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
 {
   NS_LOG_FUNCTION (this);
   NS_LOG_LOGIC ("Invoked the copy constructor");
+  m_retxTimer.SetFunction (&TcpSocketBase::RetxTimerExpired, this);
+  m_delAckTimer.SetFunction (&TcpSocketBase::DelAckTimeout, this);
+  m_persistTimer.SetFunction (&TcpSocketBase::PersistTimeout, this);
   // Copy the rtt estimator if it is set
   if (sock.m_rtt)
     {
@@ -440,26 +475,31 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
       m_congestionControl = sock.m_congestionControl->Fork ();
     }
 
-  bool ok;
+  // Chain the trace sources of the TCB to ours, unless either side is
+  // compiled out
+  if (TRACES && TcpSocketState::TRACES)
+    {
+      bool ok;
 
-  ok = m_tcb->TraceConnectWithoutContext ("CongestionWindow",
-                                          MakeCallback (&TcpSocketBase::UpdateCwnd, this));
-  NS_ASSERT (ok == true);
+      ok = m_tcb->TraceConnectWithoutContext ("CongestionWindow",
+                                              MakeCallback (&TcpSocketBase::UpdateCwnd, this));
+      NS_ASSERT (ok == true);
 
-  ok = m_tcb->TraceConnectWithoutContext ("SlowStartThreshold",
-                                          MakeCallback (&TcpSocketBase::UpdateSsThresh, this));
-  NS_ASSERT (ok == true);
+      ok = m_tcb->TraceConnectWithoutContext ("SlowStartThreshold",
+                                              MakeCallback (&TcpSocketBase::UpdateSsThresh, this));
+      NS_ASSERT (ok == true);
 
-  ok = m_tcb->TraceConnectWithoutContext ("CongState",
-                                          MakeCallback (&TcpSocketBase::UpdateCongState, this));
-  NS_ASSERT (ok == true);
+      ok = m_tcb->TraceConnectWithoutContext ("CongState",
+                                              MakeCallback (&TcpSocketBase::UpdateCongState, this));
+      NS_ASSERT (ok == true);
 
-  ok = m_tcb->TraceConnectWithoutContext ("NextTxSequence",
-                                          MakeCallback (&TcpSocketBase::UpdateNextTxSequence, this));
-  NS_ASSERT (ok == true);
+      ok = m_tcb->TraceConnectWithoutContext ("NextTxSequence",
+                                              MakeCallback (&TcpSocketBase::UpdateNextTxSequence, this));
+      NS_ASSERT (ok == true);
 
-  ok = m_tcb->TraceConnectWithoutContext ("HighestSequence",
-                                          MakeCallback (&TcpSocketBase::UpdateHighTxMark, this));
+      ok = m_tcb->TraceConnectWithoutContext ("HighestSequence",
+                                              MakeCallback (&TcpSocketBase::UpdateHighTxMark, this));
+    }
 }
 
 TcpSocketBase::~TcpSocketBase (void)
@@ -1299,6 +1339,12 @@ TcpSocketBase::DoForwardUp (Ptr<Packet> packet, const Address &fromAddress,
           m_timestampEnabled = false;
         }
 
+      // SACK is used only if both ends permit it (RFC 2018)
+      if (!tcpHeader.HasOption (TcpOption::SACKPERMITTED))
+        {
+          m_sackEnabled = false;
+        }
+
       // Initialize cWnd and ssThresh
       m_tcb->m_cWnd = GetInitialCwnd () * GetSegSize ();
       m_tcb->m_ssThresh = GetInitialSSThresh ();
@@ -1335,17 +1381,17 @@ TcpSocketBase::DoForwardUp (Ptr<Packet> packet, const Address &fromAddress,
     }
 
 
-  if (m_rWnd.Get () == 0 && m_persistEvent.IsExpired ())
+  if (m_rWnd.Get () == 0 && m_persistTimer.IsExpired ())
     { // Zero window: Enter persist state to send 1 byte to probe
       NS_LOG_LOGIC (this << " Enter zerowindow persist state");
       NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
-      m_retxEvent.Cancel ();
+                    (Simulator::Now () + m_retxTimer.GetDelayLeft ()).GetSeconds ());
+      m_retxTimer.Cancel ();
       NS_LOG_LOGIC ("Schedule persist timeout at time " <<
                     Simulator::Now ().GetSeconds () << " to expire at time " <<
                     (Simulator::Now () + m_persistTimeout).GetSeconds ());
-      m_persistEvent = Simulator::Schedule (m_persistTimeout, &TcpSocketBase::PersistTimeout, this);
-      NS_ASSERT (m_persistTimeout == Simulator::GetDelayLeft (m_persistEvent));
+      m_persistTimer.Schedule (m_persistTimeout);
+      NS_ASSERT (m_persistTimeout == m_persistTimer.GetDelayLeft ());
     }
 
   // TCP state machine code in different process functions
@@ -1411,11 +1457,11 @@ TcpSocketBase::DoForwardUp (Ptr<Packet> packet, const Address &fromAddress,
       break;
     }
 
-  if (m_rWnd.Get () != 0 && m_persistEvent.IsRunning ())
+  if (m_rWnd.Get () != 0 && m_persistTimer.IsRunning ())
     { // persist probes end, the other end has increased the window
       NS_ASSERT (m_connected);
       NS_LOG_LOGIC (this << " Leaving zerowindow persist state");
-      m_persistEvent.Cancel ();
+      m_persistTimer.Cancel ();
 
       // Try to send more data, since window has been updated
       if (!m_sendPendingDataEvent.IsRunning ())
@@ -1550,7 +1596,17 @@ TcpSocketBase::DupAck ()
 
   if (m_tcb->m_congState == TcpSocketState::CA_DISORDER)
     {
-      if ((m_dupAckCount == m_retxThresh) && (m_highRxAckMark >= m_recover))
+      if (m_sackEnabled)
+        {
+          // The scoreboard drives the recovery: the head is lost after
+          // DupThresh duplicate ACKs (RFC 6675), and the data SACKed
+          // already opens the window for new segments (RFC 3042)
+          if ((m_dupAckCount == m_retxThresh) && (m_highRxAckMark >= m_recover))
+            {
+              m_txBuffer->MarkHeadAsLost ();
+            }
+        }
+      else if ((m_dupAckCount == m_retxThresh) && (m_highRxAckMark >= m_recover))
         {
           // triple duplicate ack triggers fast retransmit (RFC2582 sec.3 bullet #1)
           NS_LOG_DEBUG (TcpSocketState::TcpCongStateName[m_tcb->m_congState] <<
@@ -1563,7 +1619,7 @@ TcpSocketBase::DupAck ()
           LimitedTransmit ();
         }
     }
-  else if (m_tcb->m_congState == TcpSocketState::CA_RECOVERY)
+  else if (m_tcb->m_congState == TcpSocketState::CA_RECOVERY && !m_sackEnabled)
     { // Increase cwnd for every additional dupack (RFC2582, sec.3 bullet #3)
       m_tcb->m_cWnd += m_tcb->m_segmentSize;
       NS_LOG_INFO (m_dupAckCount << " Dupack received in fast recovery mode."
@@ -1592,6 +1648,12 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
 
   m_tcb->m_lastAckedSeq = ackNumber;
 
+  uint32_t bytesSacked = 0;
+  if (m_sackEnabled && tcpHeader.HasOption (TcpOption::SACK))
+    {
+      bytesSacked = ProcessOptionSack (tcpHeader.GetOption (TcpOption::SACK));
+    }
+
   if (ackNumber == m_txBuffer->HeadSequence ()
       && ackNumber < m_tcb->m_nextTxSequence
       && packet->GetSize () == 0)
@@ -1654,6 +1716,11 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
           segsAcked = 1;
         }
 
+      if (m_tlpOutstanding && ackNumber >= m_tlpHighSeq)
+        { // The tail loss probe episode is over
+          m_tlpOutstanding = false;
+        }
+
       if (m_tcb->m_congState == TcpSocketState::CA_OPEN)
         {
           m_congestionControl->PktsAcked (m_tcb, segsAcked, m_lastRtt);
@@ -1672,7 +1739,21 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
         }
       else if (m_tcb->m_congState == TcpSocketState::CA_RECOVERY)
         {
-          if (ackNumber < m_recover)
+          if (ackNumber < m_recover && m_sackEnabled)
+            {
+              /* Partial ACK with SACK.
+               * The segments to retransmit are those marked lost in the
+               * scoreboard, and the window was not inflated, so there is
+               * nothing to deflate: just keep on recovering.
+               */
+              callCongestionControl = false;
+              m_dupAckCount = SafeSubtraction (m_dupAckCount, segsAcked);
+              m_congestionControl->PktsAcked (m_tcb, 1, m_lastRtt);
+
+              NS_LOG_INFO ("Partial ACK for seq " << ackNumber <<
+                           " in SACK recovery, recover seq: " << m_recover);
+            }
+          else if (ackNumber < m_recover)
             {
               /* Partial ACK.
                * In case of partial ACK, retransmit the first unacknowledged
@@ -1786,6 +1867,19 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
         }
     }
 
+  if (m_sackEnabled)
+    {
+      RackDetectLoss ();
+      // Newly SACKed data opens the window, lost data has to be resent
+      if ((bytesSacked > 0 || m_txBuffer->GetLostBytes () > 0)
+          && !m_sendPendingDataEvent.IsRunning ())
+        {
+          m_sendPendingDataEvent = Simulator::Schedule (TimeStep (1),
+                                                        &TcpSocketBase::SendPendingData,
+                                                        this, m_connected);
+        }
+    }
+
   // If there is any data piggybacked, store it into m_rxBuffer
   if (packet->GetSize () > 0)
     {
@@ -1855,7 +1949,7 @@ TcpSocketBase::ProcessSynSent (Ptr<Packet> packet, const TcpHeader& tcpHeader)
       m_congestionControl->CongestionStateSet (m_tcb, TcpSocketState::CA_OPEN);
       m_state = ESTABLISHED;
       m_connected = true;
-      m_retxEvent.Cancel ();
+      m_retxTimer.Cancel ();
       m_delAckCount = m_delAckMaxCount;
       ReceivedData (packet, tcpHeader);
       Simulator::ScheduleNow (&TcpSocketBase::ConnectionSucceeded, this);
@@ -1892,7 +1986,7 @@ TcpSocketBase::ProcessSynSent (Ptr<Packet> packet, const TcpHeader& tcpHeader)
       m_congestionControl->CongestionStateSet (m_tcb, TcpSocketState::CA_OPEN);
       m_state = ESTABLISHED;
       m_connected = true;
-      m_retxEvent.Cancel ();
+      m_retxTimer.Cancel ();
       m_rxBuffer->SetNextRxSequence (tcpHeader.GetSequenceNumber () + SequenceNumber32 (1));
       m_tcb->m_highTxMark = ++m_tcb->m_nextTxSequence;
       m_txBuffer->SetHeadSequence (m_tcb->m_nextTxSequence);
@@ -1950,7 +2044,7 @@ TcpSocketBase::ProcessSynRcvd (Ptr<Packet> packet, const TcpHeader& tcpHeader,
       m_congestionControl->CongestionStateSet (m_tcb, TcpSocketState::CA_OPEN);
       m_state = ESTABLISHED;
       m_connected = true;
-      m_retxEvent.Cancel ();
+      m_retxTimer.Cancel ();
       m_tcb->m_highTxMark = ++m_tcb->m_nextTxSequence;
       m_txBuffer->SetHeadSequence (m_tcb->m_nextTxSequence);
       if (m_endPoint)
@@ -1996,7 +2090,7 @@ TcpSocketBase::ProcessSynRcvd (Ptr<Packet> packet, const TcpHeader& tcpHeader,
       if (tcpHeader.GetSequenceNumber () == m_rxBuffer->NextRxSequence ())
         { // In-sequence FIN before connection complete. Set up connection and close.
           m_connected = true;
-          m_retxEvent.Cancel ();
+          m_retxTimer.Cancel ();
           m_tcb->m_highTxMark = ++m_tcb->m_nextTxSequence;
           m_txBuffer->SetHeadSequence (m_tcb->m_nextTxSequence);
           if (m_endPoint)
@@ -2264,7 +2358,7 @@ TcpSocketBase::Destroy (void)
       m_tcp->RemoveSocket (this);
     }
   NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
+                (Simulator::Now () + m_retxTimer.GetDelayLeft ()).GetSeconds ());
   CancelAllTimers ();
 }
 
@@ -2280,7 +2374,7 @@ TcpSocketBase::Destroy6 (void)
       m_tcp->RemoveSocket (this);
     }
   NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
+                (Simulator::Now () + m_retxTimer.GetDelayLeft ()).GetSeconds ());
   CancelAllTimers ();
 }
 
@@ -2388,6 +2482,11 @@ TcpSocketBase::SendEmptyPacket (uint8_t flags)
           AddOptionWScale (header);
         }
 
+      if (m_sackEnabled)
+        {
+          AddOptionSackPermitted (header);
+        }
+
       if (m_synCount == 0)
         { // No more connection retries, give up
           NS_LOG_LOGIC ("Connection failed.");
@@ -2430,19 +2529,19 @@ TcpSocketBase::SendEmptyPacket (uint8_t flags)
 
   if (flags & TcpHeader::ACK)
     { // If sending an ACK, cancel the delay ACK as well
-      m_delAckEvent.Cancel ();
+      m_delAckTimer.Cancel ();
       m_delAckCount = 0;
       if (m_highTxAck < header.GetAckNumber ())
         {
           m_highTxAck = header.GetAckNumber ();
         }
     }
-  if (m_retxEvent.IsExpired () && (hasSyn || hasFin) && !isAck )
+  if (m_retxTimer.IsExpired () && (hasSyn || hasFin) && !isAck )
     { // Retransmit SYN / SYN+ACK / FIN / FIN+ACK to guard against lost
       NS_LOG_LOGIC ("Schedule retransmission timeout at time "
                     << Simulator::Now ().GetSeconds () << " to expire at time "
                     << (Simulator::Now () + m_rto.Get ()).GetSeconds ());
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::SendEmptyPacket, this, flags);
+      ScheduleRetxTimer (m_rto, RETX_SEND_EMPTY, flags);
     }
 }
 
@@ -2623,7 +2722,7 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
 
   if (withAck)
     {
-      m_delAckEvent.Cancel ();
+      m_delAckTimer.Cancel ();
       m_delAckCount = 0;
     }
 
@@ -2726,7 +2825,15 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
   header.SetWindowSize (AdvertisedWindowSize ());
   AddOptions (header);
 
-  if (m_retxEvent.IsExpired ())
+  if (m_retxTimer.IsExpired () && !isRetransmission && TailLossProbeAllowed ())
+    {
+      Time pto = GetProbeTimeout ();
+      NS_LOG_LOGIC (this << " SendDataPacket Schedule TailLossProbe at time " <<
+                    Simulator::Now ().GetSeconds () << " to expire at time " <<
+                    (Simulator::Now () + pto).GetSeconds ());
+      ScheduleRetxTimer (pto, RETX_TAIL_LOSS);
+    }
+  else if (m_retxTimer.IsExpired ())
     {
       // Schedules retransmit timeout. If this is a retransmission, double the timer
 
@@ -2740,7 +2847,7 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
       NS_LOG_LOGIC (this << " SendDataPacket Schedule ReTxTimeout at time " <<
                     Simulator::Now ().GetSeconds () << " to expire at time " <<
                     (Simulator::Now () + m_rto.Get ()).GetSeconds () );
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::ReTxTimeout, this);
+      ScheduleRetxTimer (m_rto, RETX_TIMEOUT);
     }
 
   m_txTrace (p, header, this);
@@ -2817,6 +2924,23 @@ TcpSocketBase::SendPendingData (bool withAck)
       return false; // Is this the right way to handle this condition?
     }
   uint32_t nPacketsSent = 0;
+  if (m_sackEnabled)
+    { // Retransmit the segments marked lost before sending new data (RFC 6675)
+      SequenceNumber32 seq;
+      uint32_t size;
+      while (m_txBuffer->NextLostSegment (seq, size))
+        {
+          uint32_t s = std::min (size, m_tcb->m_segmentSize);
+          if (AvailableWindow () < s)
+            {
+              NS_LOG_LOGIC ("Not enough window to retransmit " << seq);
+              break;
+            }
+          NS_LOG_DEBUG ("Retransmitting lost segment " << seq << " of size " << s);
+          SendDataPacket (seq, s, withAck);
+          nPacketsSent++;
+        }
+    }
   while (m_txBuffer->SizeFromSequence (m_tcb->m_nextTxSequence))
     {
       if ((m_ecnState & (ECN_RX_ECHO | ECN_SEND_CWR)) == ECN_RX_ECHO)
@@ -2894,7 +3018,11 @@ TcpSocketBase::BytesInFlight ()
   uint32_t duplicatedSize;
   uint32_t bytesInFlight;
 
-  if (m_retransOut > m_dupAckCount)
+  if (m_sackEnabled)
+    { // The scoreboard knows exactly (RFC 6675 "pipe")
+      bytesInFlight = m_txBuffer->BytesInFlight ();
+    }
+  else if (m_retransOut > m_dupAckCount)
     {
       duplicatedSize = (m_retransOut - m_dupAckCount)*m_tcb->m_segmentSize;
       bytesInFlight = flightSize + duplicatedSize;
@@ -2929,6 +3057,18 @@ TcpSocketBase::AvailableWindow () const
   uint32_t unack = UnAckDataCount (); // Number of outstanding bytes
   uint32_t win = Window ();           // Number of bytes allowed to be outstanding
 
+  if (m_sackEnabled)
+    { // cWnd limits the bytes in the network, rWnd the bytes not acknowledged
+      uint32_t pipe = m_txBuffer->BytesInFlight ();
+      uint32_t cWnd = m_tcb->m_cWnd.Get ();
+      uint32_t rWnd = m_rWnd.Get ();
+
+      NS_LOG_DEBUG ("UnAckCount=" << unack << ", Pipe=" << pipe <<
+                    ", cWnd=" << cWnd << ", rWnd=" << rWnd);
+      return std::min (cWnd < pipe ? 0 : cWnd - pipe,
+                       rWnd < unack ? 0 : rWnd - unack);
+    }
+
   NS_LOG_DEBUG ("UnAckCount=" << unack << ", Win=" << win);
   return (win < unack) ? 0 : (win - unack);
 }
@@ -2976,16 +3116,15 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
     { // In-sequence packet: ACK if delayed ack count allows
       if (++m_delAckCount >= m_delAckMaxCount)
         {
-          m_delAckEvent.Cancel ();
+          m_delAckTimer.Cancel ();
           m_delAckCount = 0;
           SendACK ();
         }
-      else if (m_delAckEvent.IsExpired ())
+      else if (m_delAckTimer.IsExpired ())
         {
-          m_delAckEvent = Simulator::Schedule (m_delAckTimeout,
-                                               &TcpSocketBase::DelAckTimeout, this);
+          m_delAckTimer.Schedule (m_delAckTimeout);
           NS_LOG_LOGIC (this << " scheduled delayed ACK at " <<
-                        (Simulator::Now () + Simulator::GetDelayLeft (m_delAckEvent)).GetSeconds ());
+                        (Simulator::Now () + m_delAckTimer.GetDelayLeft ()).GetSeconds ());
         }
     }
   // Notify app to receive if necessary
@@ -3075,16 +3214,27 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack, bool resetRTO)
   if (m_state != SYN_RCVD && resetRTO)
     { // Set RTO unless the ACK is received in SYN_RCVD state
       NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
-      m_retxEvent.Cancel ();
+                    (Simulator::Now () + m_retxTimer.GetDelayLeft ()).GetSeconds ());
+      m_retxTimer.Cancel ();
       // On receiving a "New" ack we restart retransmission timer .. RFC 6298
       // RFC 6298, clause 2.4
       m_rto = Max (m_rtt->GetEstimate () + Max (m_clockGranularity, m_rtt->GetVariation () * 4), m_minRto);
 
-      NS_LOG_LOGIC (this << " Schedule ReTxTimeout at time " <<
-                    Simulator::Now ().GetSeconds () << " to expire at time " <<
-                    (Simulator::Now () + m_rto.Get ()).GetSeconds ());
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::ReTxTimeout, this);
+      if (TailLossProbeAllowed () && ack < m_tcb->m_highTxMark)
+        {
+          Time pto = GetProbeTimeout ();
+          NS_LOG_LOGIC (this << " Schedule TailLossProbe at time " <<
+                        Simulator::Now ().GetSeconds () << " to expire at time " <<
+                        (Simulator::Now () + pto).GetSeconds ());
+          ScheduleRetxTimer (pto, RETX_TAIL_LOSS);
+        }
+      else
+        {
+          NS_LOG_LOGIC (this << " Schedule ReTxTimeout at time " <<
+                        Simulator::Now ().GetSeconds () << " to expire at time " <<
+                        (Simulator::Now () + m_rto.Get ()).GetSeconds ());
+          ScheduleRetxTimer (m_rto, RETX_TIMEOUT);
+        }
     }
 
   // Note the highest ACK and tell app to send more
@@ -3102,9 +3252,168 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack, bool resetRTO)
   if (m_txBuffer->Size () == 0 && m_state != FIN_WAIT_1 && m_state != CLOSING)
     { // No retransmit timer if no data to retransmit
       NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
-      m_retxEvent.Cancel ();
+                    (Simulator::Now () + m_retxTimer.GetDelayLeft ()).GetSeconds ());
+      m_retxTimer.Cancel ();
+    }
+}
+
+void
+TcpSocketBase::EnterSackRecovery ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_sackEnabled);
+
+  m_recover = m_tcb->m_highTxMark;
+  m_congestionControl->CongestionStateSet (m_tcb, TcpSocketState::CA_RECOVERY);
+  m_tcb->m_congState = TcpSocketState::CA_RECOVERY;
+
+  // RFC 6675 uses FlightSize, not the bytes still in the network
+  m_tcb->m_ssThresh = m_congestionControl->GetSsThresh (m_tcb, UnAckDataCount ());
+  m_tcb->m_cWnd = m_tcb->m_ssThresh;
+
+  NS_LOG_INFO (m_txBuffer->GetLostBytes () << " bytes lost. Enter SACK recovery mode." <<
+               "Reset cwnd to " << m_tcb->m_cWnd << ", ssthresh to " <<
+               m_tcb->m_ssThresh << " at fast recovery seqnum " << m_recover);
+}
+
+void
+TcpSocketBase::RackDetectLoss ()
+{
+  NS_LOG_FUNCTION (this);
+
+  // Once in recovery, RACK does not wait for reordered segments any more
+  Time reoWnd = Seconds (0);
+  Time minRtt = m_txBuffer->GetMinRtt ();
+  if (minRtt != Time::Max ()
+      && (m_tcb->m_congState == TcpSocketState::CA_OPEN
+          || m_tcb->m_congState == TcpSocketState::CA_DISORDER))
+    {
+      reoWnd = minRtt / 4;
+    }
+
+  Time timeout = m_txBuffer->DetectLosses (reoWnd);
+  m_rackEvent.Cancel ();
+  if (timeout.IsStrictlyPositive ())
+    {
+      NS_LOG_LOGIC (this << " Schedule RackTimeout in " << timeout.GetSeconds ());
+      m_rackEvent = Simulator::Schedule (timeout, &TcpSocketBase::RackTimeout, this);
+    }
+
+  if (m_txBuffer->GetLostBytes () > 0
+      && (m_tcb->m_congState == TcpSocketState::CA_OPEN
+          || m_tcb->m_congState == TcpSocketState::CA_DISORDER))
+    {
+      NS_LOG_DEBUG (TcpSocketState::TcpCongStateName[m_tcb->m_congState] <<
+                    " -> RECOVERY");
+      EnterSackRecovery ();
+    }
+}
+
+void
+TcpSocketBase::RackTimeout (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_state == CLOSED || m_state == TIME_WAIT)
+    {
+      return;
+    }
+  RackDetectLoss ();
+  SendPendingData (m_connected);
+}
+
+bool
+TcpSocketBase::TailLossProbeAllowed (void) const
+{
+  // The tail of a flow is often sent just before the application closes
+  // the socket, so probe after the FIN as well
+  return m_sackEnabled && m_tlpEnabled && !m_tlpOutstanding
+         && m_tcb->m_congState == TcpSocketState::CA_OPEN
+         && (m_state == ESTABLISHED || m_state == CLOSE_WAIT
+             || m_state == FIN_WAIT_1 || m_state == CLOSING || m_state == LAST_ACK);
+}
+
+Time
+TcpSocketBase::GetProbeTimeout (void) const
+{
+  Time srtt = m_rtt->GetEstimate ();
+  if (srtt.IsZero ())
+    { // No RTT sample yet
+      return m_rto.Get ();
+    }
+  Time pto = srtt * 2;
+  if (m_txBuffer->BytesInFlight () <= m_tcb->m_segmentSize)
+    { // Leave time to the receiver to delay its ACK
+      pto += m_delAckTimeout;
     }
+  return Min (pto, m_rto.Get ());
+}
+
+void
+TcpSocketBase::ScheduleRetxTimer (Time delay, RetxTimerAction action, uint8_t flags)
+{
+  NS_LOG_FUNCTION (this << delay << action << static_cast<uint32_t> (flags));
+  // The function of the timer stays the same, so that it is never replaced
+  // while the timer invokes it
+  m_retxTimer.SetArguments (action, flags);
+  m_retxTimer.Schedule (delay);
+}
+
+void
+TcpSocketBase::RetxTimerExpired (RetxTimerAction action, uint8_t flags)
+{
+  NS_LOG_FUNCTION (this << action << static_cast<uint32_t> (flags));
+  switch (action)
+    {
+    case RETX_TIMEOUT:
+      ReTxTimeout ();
+      break;
+    case RETX_TAIL_LOSS:
+      TailLossProbe ();
+      break;
+    case RETX_SEND_EMPTY:
+      SendEmptyPacket (flags);
+      break;
+    }
+}
+
+void
+TcpSocketBase::TailLossProbe (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_state == CLOSED || m_state == TIME_WAIT)
+    {
+      return;
+    }
+  if (m_txBuffer->HeadSequence () >= m_tcb->m_highTxMark)
+    {
+      return;
+    }
+
+  // The RTO covers the probe and what is still outstanding
+  ScheduleRetxTimer (m_rto, RETX_TIMEOUT);
+  m_tlpOutstanding = true;
+
+  uint32_t unack = UnAckDataCount ();
+  uint32_t rWnd = m_rWnd.Get () < unack ? 0 : m_rWnd.Get () - unack;
+  uint32_t available = m_txBuffer->SizeFromSequence (m_tcb->m_nextTxSequence);
+  if (available > 0 && rWnd >= std::min (available, m_tcb->m_segmentSize))
+    { // Probe with new data
+      NS_LOG_DEBUG ("Tail loss probe with new data at " << m_tcb->m_nextTxSequence);
+      uint32_t sz = SendDataPacket (m_tcb->m_nextTxSequence, m_tcb->m_segmentSize, m_connected);
+      m_tcb->m_nextTxSequence += sz;
+    }
+  else
+    { // Probe with the last segment sent
+      SequenceNumber32 seq = m_tcb->m_highTxMark.Get () - m_tcb->m_segmentSize;
+      if (seq < m_txBuffer->HeadSequence ()
+          || m_tcb->m_highTxMark.Get () - m_txBuffer->HeadSequence () <= static_cast<int32_t> (m_tcb->m_segmentSize))
+        {
+          seq = m_txBuffer->HeadSequence ();
+        }
+      NS_LOG_DEBUG ("Tail loss probe retransmitting " << seq);
+      SendDataPacket (seq, m_tcb->m_highTxMark.Get () - seq, true);
+    }
+  m_tlpHighSeq = m_tcb->m_highTxMark;
 }
 
 // Retransmit timeout
@@ -3159,7 +3468,7 @@ TcpSocketBase::PersistTimeout ()
 {
   NS_LOG_LOGIC ("PersistTimeout expired at " << Simulator::Now ().GetSeconds ());
   m_persistTimeout = std::min (Seconds (60), Time (2 * m_persistTimeout)); // max persist timeout = 60s
-  Ptr<Packet> p = m_txBuffer->CopyFromSequence (1, m_tcb->m_nextTxSequence);
+  Ptr<Packet> p = m_txBuffer->CopyProbe (1, m_tcb->m_nextTxSequence);
   TcpHeader tcpHeader;
   tcpHeader.SetSequenceNumber (m_tcb->m_nextTxSequence);
   tcpHeader.SetAckNumber (m_rxBuffer->NextRxSequence ());
@@ -3202,7 +3511,7 @@ TcpSocketBase::PersistTimeout ()
   NS_LOG_LOGIC ("Schedule persist timeout at time "
                 << Simulator::Now ().GetSeconds () << " to expire at time "
                 << (Simulator::Now () + m_persistTimeout).GetSeconds ());
-  m_persistEvent = Simulator::Schedule (m_persistTimeout, &TcpSocketBase::PersistTimeout, this);
+  m_persistTimer.Schedule (m_persistTimeout);
 }
 
 void
@@ -3258,7 +3567,15 @@ TcpSocketBase::Retransmit ()
       m_tcb->m_cWnd = m_tcb->m_segmentSize;
     }
 
-  m_tcb->m_nextTxSequence = m_txBuffer->HeadSequence (); // Restart from highest Ack
+  if (m_sackEnabled)
+    { // Resend what was not SACKed, the scoreboard keeps track of it (RFC 6675)
+      m_txBuffer->MarkAllAsLost ();
+      m_tlpOutstanding = false;
+    }
+  else
+    {
+      m_tcb->m_nextTxSequence = m_txBuffer->HeadSequence (); // Restart from highest Ack
+    }
   m_dupAckCount = 0;
 
   NS_LOG_DEBUG ("RTO. Reset cwnd to " <<  m_tcb->m_cWnd << ", ssthresh to " <<
@@ -3327,12 +3644,13 @@ TcpSocketBase::DoRetransmit ()
 void
 TcpSocketBase::CancelAllTimers ()
 {
-  m_retxEvent.Cancel ();
-  m_persistEvent.Cancel ();
-  m_delAckEvent.Cancel ();
+  m_retxTimer.Cancel ();
+  m_persistTimer.Cancel ();
+  m_delAckTimer.Cancel ();
   m_lastAckEvent.Cancel ();
   m_timewaitEvent.Cancel ();
   m_sendPendingDataEvent.Cancel ();
+  m_rackEvent.Cancel ();
 }
 
 /* Move TCP to Time_Wait state and schedule a transition to Closed state */
@@ -3515,6 +3833,61 @@ TcpSocketBase::AddOptions (TcpHeader& header)
     {
       AddOptionTimestamp (header);
     }
+
+  if (m_sackEnabled && (header.GetFlags () & TcpHeader::ACK)
+      && !(header.GetFlags () & TcpHeader::SYN))
+    {
+      AddOptionSack (header);
+    }
+}
+
+void
+TcpSocketBase::AddOptionSackPermitted (TcpHeader &header)
+{
+  NS_LOG_FUNCTION (this << header);
+  NS_ASSERT (header.GetFlags () & TcpHeader::SYN);
+
+  header.AppendOption (CreateObject<TcpOptionSackPermitted> ());
+  NS_LOG_INFO (m_node->GetId () << " Add option SACK-PERMITTED");
+}
+
+uint32_t
+TcpSocketBase::ProcessOptionSack (const Ptr<const TcpOption> option)
+{
+  NS_LOG_FUNCTION (this << option);
+
+  Ptr<const TcpOptionSack> s = DynamicCast<const TcpOptionSack> (option);
+  NS_LOG_INFO (m_node->GetId () << " Received SACK option with " <<
+               s->GetNumSackBlocks () << " blocks");
+  return m_txBuffer->Sack (s->GetSackList ());
+}
+
+void
+TcpSocketBase::AddOptionSack (TcpHeader &header)
+{
+  NS_LOG_FUNCTION (this << header);
+
+  // Two bytes for the kind and the length, eight for each block
+  uint32_t optionLen = header.GetOptionLength ();
+  uint32_t space = header.GetMaxOptionLength () - optionLen;
+  if (space < 10)
+    {
+      return;
+    }
+  TcpOptionSack::SackList list = m_rxBuffer->GetSackList ((space - 2) / 8);
+  if (list.empty ())
+    {
+      return;
+    }
+
+  Ptr<TcpOptionSack> option = CreateObject<TcpOptionSack> ();
+  for (TcpOptionSack::SackList::const_iterator it = list.begin (); it != list.end (); ++it)
+    {
+      option->AddSackBlock (*it);
+    }
+  header.AppendOption (option);
+  NS_LOG_INFO (m_node->GetId () << " Add option SACK with " <<
+               option->GetNumSackBlocks () << " blocks");
 }
 
 void
@@ -33,6 +33,7 @@
 #include "ns3/ipv6-header.h"
 #include "ns3/ipv6-interface.h"
 #include "ns3/event-id.h"
+#include "ns3/timer.h"
 #include "tcp-tx-buffer.h"
 #include "tcp-rx-buffer.h"
 #include "rtt-estimator.h"
@@ -150,9 +151,15 @@ public:
    */
   static const char* const TcpCongStateName[TcpSocketState::CA_LAST_STATE];
 
+#ifdef NS3_DISABLE_TRACES_TcpSocketState
+  static const bool TRACES = false; //!< Trace sources compiled out by --disable-trace-sources
+#else
+  static const bool TRACES = true;  //!< Trace sources compiled in
+#endif
+
   // Congestion control
-  TracedValue<uint32_t>  m_cWnd;            //!< Congestion window
-  TracedValue<uint32_t>  m_ssThresh;        //!< Slow start threshold
+  TracedValue<uint32_t, TRACES>  m_cWnd;     //!< Congestion window
+  TracedValue<uint32_t, TRACES>  m_ssThresh; //!< Slow start threshold
   uint32_t               m_initialCWnd;     //!< Initial cWnd value
   uint32_t               m_initialSsThresh; //!< Initial Slow Start Threshold value
 
@@ -160,9 +167,9 @@ public:
   uint32_t               m_segmentSize;     //!< Segment size
   SequenceNumber32       m_lastAckedSeq;    //!< Last sequence ACKed
 
-  TracedValue<TcpCongState_t> m_congState;    //!< State in the Congestion state machine
-  TracedValue<SequenceNumber32> m_highTxMark; //!< Highest seqno ever sent, regardless of ReTx
-  TracedValue<SequenceNumber32> m_nextTxSequence; //!< Next seqnum to be sent (SND.NXT), ReTx pushes it back
+  TracedValue<TcpCongState_t, TRACES> m_congState;    //!< State in the Congestion state machine
+  TracedValue<SequenceNumber32, TRACES> m_highTxMark; //!< Highest seqno ever sent, regardless of ReTx
+  TracedValue<SequenceNumber32, TRACES> m_nextTxSequence; //!< Next seqnum to be sent (SND.NXT), ReTx pushes it back
 
   /**
    * \brief Get cwnd in segments rather than bytes
@@ -353,30 +360,36 @@ public:
    */
   Ptr<TcpRxBuffer> GetRxBuffer (void) const;
 
+#ifdef NS3_DISABLE_TRACES_TcpSocketBase
+  static const bool TRACES = false; //!< Trace sources compiled out by --disable-trace-sources
+#else
+  static const bool TRACES = true;  //!< Trace sources compiled in
+#endif
+
   /**
    * \brief Callback pointer for cWnd trace chaining
    */
-  TracedCallback<uint32_t, uint32_t> m_cWndTrace;
+  SelectTracedCallback<TRACES, uint32_t, uint32_t>::Type m_cWndTrace;
 
   /**
    * \brief Callback pointer for ssTh trace chaining
    */
-  TracedCallback<uint32_t, uint32_t> m_ssThTrace;
+  SelectTracedCallback<TRACES, uint32_t, uint32_t>::Type m_ssThTrace;
 
   /**
    * \brief Callback pointer for congestion state trace chaining
    */
-  TracedCallback<TcpSocketState::TcpCongState_t, TcpSocketState::TcpCongState_t> m_congStateTrace;
+  SelectTracedCallback<TRACES, TcpSocketState::TcpCongState_t, TcpSocketState::TcpCongState_t>::Type m_congStateTrace;
 
   /**
    * \brief Callback pointer for high tx mark chaining
    */
-  TracedCallback <SequenceNumber32, SequenceNumber32> m_highTxMarkTrace;
+  SelectTracedCallback<TRACES, SequenceNumber32, SequenceNumber32>::Type m_highTxMarkTrace;
 
   /**
    * \brief Callback pointer for next tx sequence chaining
    */
-  TracedCallback<SequenceNumber32, SequenceNumber32> m_nextTxSequenceTrace;
+  SelectTracedCallback<TRACES, SequenceNumber32, SequenceNumber32>::Type m_nextTxSequenceTrace;
 
   /**
    * \brief Callback function to hook to TcpSocketState congestion window
@@ -874,6 +887,76 @@ protected:
    */
   void FastRetransmit ();
 
+  /**
+   * \brief Enter fast recovery on losses found with the SACK scoreboard
+   *
+   * Unlike FastRetransmit(), the congestion window is not inflated: the
+   * lost segments are retransmitted by SendPendingData() as the bytes in
+   * flight, counted by the scoreboard, allow.
+   */
+  void EnterSackRecovery ();
+
+  /**
+   * \brief Run the RACK loss detection (RFC 8985) on the scoreboard
+   *
+   * Schedule the reordering timeout if some segments may be deemed lost
+   * later, and enter recovery if some segments are lost.
+   */
+  void RackDetectLoss ();
+
+  /**
+   * \brief Detect losses upon the RACK reordering timeout
+   */
+  void RackTimeout (void);
+
+  /**
+   * \brief Check if a tail loss probe can be scheduled instead of an RTO
+   * \returns true if a probe can be scheduled
+   */
+  bool TailLossProbeAllowed (void) const;
+
+  /**
+   * \brief Get the probe timeout of the tail loss probe (RFC 8985, 7.2)
+   * \returns the probe timeout
+   */
+  Time GetProbeTimeout (void) const;
+
+  /**
+   * \brief The action taken when the retransmission timer expires
+   */
+  enum RetxTimerAction
+  {
+    RETX_TIMEOUT,     //!< Call ReTxTimeout()
+    RETX_TAIL_LOSS,   //!< Call TailLossProbe()
+    RETX_SEND_EMPTY   //!< Resend a SYN or FIN segment
+  };
+
+  /**
+   * \brief Schedule the retransmission timer
+   *
+   * \param delay the delay before the timer expires
+   * \param action the action taken when the timer expires
+   * \param flags the flags of the segment resent by RETX_SEND_EMPTY
+   */
+  void ScheduleRetxTimer (Time delay, RetxTimerAction action, uint8_t flags = 0);
+
+  /**
+   * \brief Take the action of the expired retransmission timer
+   *
+   * \param action the action to take
+   * \param flags the flags of the segment resent by RETX_SEND_EMPTY
+   */
+  void RetxTimerExpired (RetxTimerAction action, uint8_t flags);
+
+  /**
+   * \brief Send a tail loss probe (RFC 8985, 7.3)
+   *
+   * Send a new segment, or retransmit the last one, so that the loss of
+   * the last segments of a window is detected by RACK rather than by a
+   * retransmission timeout.
+   */
+  void TailLossProbe (void);
+
   /**
    * \brief Call Retransmit() upon RTO event
    */
@@ -963,6 +1046,33 @@ protected:
    */
   void AddOptionTimestamp (TcpHeader& header);
 
+  /**
+   * \brief Add the SACK-permitted option to the header
+   *
+   * \param header TcpHeader, with the SYN flag set, to which add the option to
+   */
+  void AddOptionSackPermitted (TcpHeader &header);
+
+  /**
+   * \brief Process the SACK option from the other side
+   *
+   * Update the scoreboard of the Tx buffer with the SACK blocks.
+   *
+   * \param option SACK option from the segment
+   * \returns the number of bytes newly selectively acknowledged
+   */
+  uint32_t ProcessOptionSack (const Ptr<const TcpOption> option);
+
+  /**
+   * \brief Add the SACK option to the header
+   *
+   * The blocks describe the out-of-sequence data of the Rx buffer, as many
+   * as the option space left allows; nothing is added if there is none.
+   *
+   * \param header TcpHeader to which add the option to
+   */
+  void AddOptionSack (TcpHeader &header);
+
   /**
    * @brief Send Ack packet; add ecn mark if needed
    */
@@ -1006,10 +1116,10 @@ protected:
 
 protected:
   // Counters and events
-  EventId           m_retxEvent;       //!< Retransmission event
+  Timer             m_retxTimer;       //!< Retransmission timer, also used for the tail loss probe
   EventId           m_lastAckEvent;    //!< Last ACK timeout event
-  EventId           m_delAckEvent;     //!< Delayed ACK timeout event
-  EventId           m_persistEvent;    //!< Persist event: Send 1 byte to probe for a non-zero Rx window
+  Timer             m_delAckTimer;     //!< Delayed ACK timer
+  Timer             m_persistTimer;    //!< Persist timer: Send 1 byte to probe for a non-zero Rx window
   EventId           m_timewaitEvent;   //!< TIME_WAIT expiration event: Move this socket to CLOSED state
   uint32_t          m_dupAckCount;     //!< Dupack counter
   uint32_t          m_delAckCount;     //!< Delayed ACK counter
@@ -1019,10 +1129,10 @@ protected:
   uint32_t          m_synRetries;      //!< Number of connection attempts
   uint32_t          m_dataRetrCount;   //!< Count of remaining data retransmission attempts
   uint32_t          m_dataRetries;     //!< Number of data retransmission attempts
-  TracedValue<Time> m_rto;             //!< Retransmit timeout
+  TracedValue<Time, TRACES> m_rto;             //!< Retransmit timeout
   Time              m_minRto;          //!< minimum value of the Retransmit timeout
   Time              m_clockGranularity; //!< Clock Granularity used in RTO calcs
-  TracedValue<Time> m_lastRtt;         //!< Last RTT sample collected
+  TracedValue<Time, TRACES> m_lastRtt;         //!< Last RTT sample collected
   Time              m_delAckTimeout;   //!< Time to delay an ACK
   Time              m_persistTimeout;  //!< Time between sending 1-byte probes
   Time              m_cnTimeout;       //!< Timeout for connection retry
@@ -1043,7 +1153,7 @@ protected:
   Ptr<TcpTxBuffer>              m_txBuffer;       //!< Tx buffer
 
   // State-related attributes
-  TracedValue<TcpStates_t> m_state;         //!< TCP state
+  TracedValue<TcpStates_t, TRACES> m_state;         //!< TCP state
   mutable enum SocketErrno m_errno;         //!< Socket error code
   bool                     m_closeNotified; //!< Told app to close socket
   bool                     m_closeOnEmpty;  //!< Close socket upon tx buffer emptied
@@ -1054,12 +1164,12 @@ protected:
 
   // Window management
   uint16_t              m_maxWinSize;  //!< Maximum window size to advertise
-  TracedValue<uint32_t> m_rWnd;        //!< Receiver window (RCV.WND in RFC793)
-  TracedValue<SequenceNumber32> m_highRxMark;     //!< Highest seqno received
+  TracedValue<uint32_t, TRACES> m_rWnd;        //!< Receiver window (RCV.WND in RFC793)
+  TracedValue<SequenceNumber32, TRACES> m_highRxMark;     //!< Highest seqno received
   SequenceNumber32 m_highTxAck;                   //!< Highest ack sent
-  TracedValue<SequenceNumber32> m_highRxAckMark;  //!< Highest ack received
+  TracedValue<SequenceNumber32, TRACES> m_highRxAckMark;  //!< Highest ack received
   uint32_t                      m_bytesAckedNotProcessed;  //!< Bytes acked, but not processed
-  TracedValue<uint32_t>         m_bytesInFlight; //!< Bytes in flight
+  TracedValue<uint32_t, TRACES>         m_bytesInFlight; //!< Bytes in flight
 
   // Options
   bool    m_winScalingEnabled; //!< Window Scale option enabled (RFC 7323)
@@ -1069,6 +1179,8 @@ protected:
   bool     m_timestampEnabled;    //!< Timestamp option enabled
   uint32_t m_timestampToEcho;     //!< Timestamp to echo
 
+  bool     m_sackEnabled;         //!< SACK option enabled (RFC 2018)
+
   EventId m_sendPendingDataEvent; //!< micro-delay event to send pending data
 
   // Fast Retransmit and Recovery
@@ -1077,6 +1189,12 @@ protected:
   bool                   m_limitedTx;    //!< perform limited transmit
   uint32_t               m_retransOut;   //!< Number of retransmission in this window
 
+  // RACK-TLP loss detection, with SACK only
+  EventId                m_rackEvent;      //!< RACK reordering timeout event
+  bool                   m_tlpEnabled;     //!< Send tail loss probes
+  bool                   m_tlpOutstanding; //!< A tail loss probe is not acknowledged yet
+  SequenceNumber32       m_tlpHighSeq;     //!< Highest seqnum sent when the last probe was sent
+
   // Transmission Control Block
   Ptr<TcpSocketState>    m_tcb;               //!< Congestion control informations
   Ptr<TcpCongestionOps>  m_congestionControl; //!< Congestion control
@@ -1085,16 +1203,16 @@ protected:
   bool m_isFirstPartialAck; //!< First partial ACK during RECOVERY
 
   // The following two traces pass a packet with a TCP header
-  TracedCallback<Ptr<const Packet>, const TcpHeader&,
-                 Ptr<const TcpSocketBase> > m_txTrace; //!< Trace of transmitted packets
+  SelectTracedCallback<TRACES, Ptr<const Packet>, const TcpHeader&,
+                       Ptr<const TcpSocketBase> >::Type m_txTrace; //!< Trace of transmitted packets
 
-  TracedCallback<Ptr<const Packet>, const TcpHeader&,
-                 Ptr<const TcpSocketBase> > m_rxTrace; //!< Trace of received packets
+  SelectTracedCallback<TRACES, Ptr<const Packet>, const TcpHeader&,
+                       Ptr<const TcpSocketBase> >::Type m_rxTrace; //!< Trace of received packets
   
   // Parameters related to Explicit Congestion Notification
   bool                          m_ecn;             //!< Socket ECN capability
-  TracedValue<uint8_t>          m_ecnState;        //!< Current ECN State, represented as combination of EcnState values
-  TracedValue<SequenceNumber32> m_ecnEchoSeq;      //!< Sequence number of the last received ECN Echo
+  TracedValue<uint8_t, TRACES>          m_ecnState;        //!< Current ECN State, represented as combination of EcnState values
+  TracedValue<SequenceNumber32, TRACES> m_ecnEchoSeq;      //!< Sequence number of the last received ECN Echo
   bool                          m_ceReceived;      //!< Flag indicating a received CE packet
 
 };
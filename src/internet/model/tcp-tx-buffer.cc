@@ -25,6 +25,7 @@
 #include "ns3/packet.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
+#include "ns3/simulator.h"
 
 #include "tcp-tx-buffer.h"
 
@@ -57,7 +58,10 @@ TcpTxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpTxBuffer::TcpTxBuffer (uint32_t n)
-  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_data (0)
+  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_firstOffset (0),
+    m_highestSent (0), m_cursor (0), m_sackedOut (0), m_lostOut (0), m_retransOut (0),
+    m_lostHint (0), m_rackXmitTs (Seconds (0)), m_rackEndOffset (0), m_rackRtt (Seconds (0)),
+    m_minRtt (Time::Max ())
 {
 }
 
@@ -111,7 +115,18 @@ TcpTxBuffer::Add (Ptr<Packet> p)
     {
       if (p->GetSize () > 0)
         {
-          m_data.push_back (p);
+          if (p->IsVirtual () && m_data.Size () > 0 && m_data.Back ().packet->IsVirtual ())
+            { // Only the size of virtual payload matters, extend the last packet
+              Ptr<Packet> &last = m_data.Back ().packet;
+              last = Create<Packet> (last->GetSize () + p->GetSize ());
+            }
+          else
+            {
+              Chunk chunk;
+              chunk.offset = m_firstOffset + m_size;
+              chunk.packet = p;
+              m_data.PushBack (chunk);
+            }
           m_size += p->GetSize ();
           NS_LOG_LOGIC ("Updated size=" << m_size << ", lastSeq=" << m_firstByteSeq + SequenceNumber32 (m_size));
         }
@@ -133,6 +148,44 @@ TcpTxBuffer::SizeFromSequence (const SequenceNumber32& seq) const
   return lastSeq - seq;
 }
 
+uint64_t
+TcpTxBuffer::GetOffset (const SequenceNumber32& seq) const
+{
+  return m_firstOffset + (seq - m_firstByteSeq.Get ());
+}
+
+uint32_t
+TcpTxBuffer::FindChunk (uint64_t offset)
+{
+  NS_ASSERT (m_data.Size () > 0);
+  // Segments are usually sent in order: look at the last packet used first
+  for (uint32_t i = m_cursor; i < m_cursor + 2 && i < m_data.Size (); ++i)
+    {
+      if (m_data[i].offset <= offset && offset < m_data[i].offset + m_data[i].packet->GetSize ())
+        {
+          m_cursor = i;
+          return i;
+        }
+    }
+  // Binary search for the last packet starting at or before the offset
+  uint32_t low = 0;
+  uint32_t high = m_data.Size ();
+  while (high - low > 1)
+    {
+      uint32_t mid = low + (high - low) / 2;
+      if (m_data[mid].offset <= offset)
+        {
+          low = mid;
+        }
+      else
+        {
+          high = mid;
+        }
+    }
+  m_cursor = low;
+  return low;
+}
+
 Ptr<Packet>
 TcpTxBuffer::CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq)
 {
@@ -142,62 +195,56 @@ TcpTxBuffer::CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq)
     {
       return Create<Packet> (); // Empty packet returned
     }
-  if (m_data.size () == 0)
+  uint64_t offset = GetOffset (seq);
+  RecordTransmission (offset, s);
+  return CopyData (offset, s);
+}
+
+Ptr<Packet>
+TcpTxBuffer::CopyProbe (uint32_t numBytes, const SequenceNumber32& seq)
+{
+  NS_LOG_FUNCTION (this << numBytes << seq);
+  uint32_t s = std::min (numBytes, SizeFromSequence (seq));
+  if (s == 0)
+    {
+      return Create<Packet> ();
+    }
+  return CopyData (GetOffset (seq), s);
+}
+
+Ptr<Packet>
+TcpTxBuffer::CopyData (uint64_t offset, uint32_t s)
+{
+  if (m_data.Size () == 0)
     { // No actual data, just return dummy-data packet of correct size
       return Create<Packet> (s);
     }
 
   // Extract data from the buffer and return
-  uint32_t offset = seq - m_firstByteSeq.Get ();
-  uint32_t count = 0;      // Offset of the first byte of a packet in the buffer
-  uint32_t pktSize = 0;
-  bool beginFound = false;
-  int pktCount = 0;
   Ptr<Packet> outPacket;
-  NS_LOG_LOGIC ("There are " << m_data.size () << " number of packets in buffer");
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
+  for (uint32_t i = FindChunk (offset); s > 0; ++i)
     {
-      pktCount++;
-      pktSize = (*i)->GetSize ();
-      if (!beginFound)
-        { // Look for first fragment
-          if (count + pktSize > offset)
-            {
-              NS_LOG_LOGIC ("First byte found in packet #" << pktCount << " at buffer offset " << count
-                                                           << ", packet len=" << pktSize);
-              beginFound = true;
-              uint32_t packetOffset = offset - count;
-              uint32_t fragmentLength = count + pktSize - offset;
-              if (fragmentLength >= s)
-                { // Data to be copied falls entirely in this packet
-                  return (*i)->CreateFragment (packetOffset, s);
-                }
-              else
-                { // This packet only fulfills part of the request
-                  outPacket = (*i)->CreateFragment (packetOffset, fragmentLength);
-                }
-              NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
-            }
-        }
-      else if (count + pktSize >= offset + s)
-        { // Last packet fragment found
-          NS_LOG_LOGIC ("Last byte found in packet #" << pktCount << " at buffer offset " << count
-                                                      << ", packet len=" << pktSize);
-          uint32_t fragmentLength = offset + s - count;
-          Ptr<Packet> endFragment = (*i)->CreateFragment (0, fragmentLength);
-          outPacket->AddAtEnd (endFragment);
-          NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
-          break;
+      NS_ASSERT (i < m_data.Size ());
+      const Chunk &chunk = m_data[i];
+      uint32_t pktSize = chunk.packet->GetSize ();
+      uint32_t packetOffset = offset - chunk.offset;
+      uint32_t fragmentLength = std::min (pktSize - packetOffset, s);
+      NS_LOG_LOGIC ("Copying " << fragmentLength << " bytes from packet #" << i
+                               << " at offset " << packetOffset << ", packet len=" << pktSize);
+      Ptr<Packet> fragment = chunk.packet->CreateFragment (packetOffset, fragmentLength);
+      if (outPacket == 0)
+        {
+          outPacket = fragment;
         }
       else
         {
-          NS_LOG_LOGIC ("Appending to output the packet #" << pktCount << " of offset " << count << " len=" << pktSize);
-          outPacket->AddAtEnd (*i);
-          NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
+          outPacket->AddAtEnd (fragment);
         }
-      count += pktSize;
+      offset += fragmentLength;
+      s -= fragmentLength;
+      m_cursor = i;
     }
-  NS_ASSERT (outPacket->GetSize () == s);
+  NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
   return outPacket;
 }
 
@@ -213,44 +260,358 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq)
 {
   NS_LOG_FUNCTION (this << seq);
   NS_LOG_LOGIC ("current data size=" << m_size << ", headSeq=" << m_firstByteSeq << ", maxBuffer=" << m_maxBuffer
-                                     << ", numPkts=" << m_data.size ());
+                                     << ", numPkts=" << m_data.Size ());
   // Cases do not need to scan the buffer
   if (m_firstByteSeq >= seq) return;
 
-  // Scan the buffer and discard packets
-  uint32_t offset = seq - m_firstByteSeq.Get ();  // Number of bytes to remove
-  uint32_t pktSize;
-  NS_LOG_LOGIC ("Offset=" << offset);
-  BufIterator i = m_data.begin ();
-  while (i != m_data.end ())
+  // Number of bytes to remove; ACKing a FIN acknowledges one more
+  uint32_t offset = std::min<uint32_t> (seq - m_firstByteSeq.Get (), m_size);
+  m_size -= offset;
+  m_firstOffset += offset;
+  m_firstByteSeq += offset;
+  // Drop the packets fully acknowledged; a partially acknowledged
+  // packet is kept as is, the bytes before m_firstOffset are skipped
+  while (m_data.Size () > 0
+         && m_data.Front ().offset + m_data.Front ().packet->GetSize () <= m_firstOffset)
     {
-      if (offset > (*i)->GetSize ())
-        { // This packet is behind the seqnum. Remove this packet from the buffer
-          pktSize = (*i)->GetSize ();
-          m_size -= pktSize;
-          offset -= pktSize;
-          m_firstByteSeq += pktSize;
-          i = m_data.erase (i);
-          NS_LOG_LOGIC ("Removed one packet of size " << pktSize << ", offset=" << offset);
-        }
-      else if (offset > 0)
-        { // Part of the packet is behind the seqnum. Fragment
-          pktSize = (*i)->GetSize () - offset;
-          *i = (*i)->CreateFragment (offset, pktSize);
-          m_size -= offset;
-          m_firstByteSeq += offset;
-          NS_LOG_LOGIC ("Fragmented one packet by size " << offset << ", new size=" << pktSize);
-          break;
+      NS_LOG_LOGIC ("Removed one packet of size " << m_data.Front ().packet->GetSize ());
+      m_data.PopFront ();
+      m_cursor = m_cursor > 0 ? m_cursor - 1 : 0;
+    }
+  // Same for the scoreboard, trimming the partially acknowledged segment
+  while (m_segments.Size () > 0
+         && m_segments.Front ().offset + m_segments.Front ().size <= m_firstOffset)
+    {
+      const Segment &front = m_segments.Front ();
+      if (!front.sacked)
+        {
+          RackUpdate (front);
         }
+      Acknowledge (front, front.size);
+      m_segments.PopFront ();
+    }
+  if (m_segments.Size () > 0 && m_segments.Front ().offset < m_firstOffset)
+    {
+      Segment &front = m_segments.Front ();
+      uint32_t acked = m_firstOffset - front.offset;
+      Acknowledge (front, acked);
+      front.size -= acked;
+      front.offset = m_firstOffset;
     }
+  m_highestSent = std::max (m_highestSent, m_firstOffset);
   // Catching the case of ACKing a FIN
   if (m_size == 0)
     {
       m_firstByteSeq = seq;
     }
   NS_LOG_LOGIC ("size=" << m_size << " headSeq=" << m_firstByteSeq << " maxBuffer=" << m_maxBuffer
-                        <<" numPkts="<< m_data.size ());
+                        <<" numPkts="<< m_data.Size ());
   NS_ASSERT (m_firstByteSeq == seq);
 }
 
+uint32_t
+TcpTxBuffer::FindSegment (uint64_t offset) const
+{
+  if (m_segments.Size () == 0 || offset < m_segments[0].offset || offset >= m_highestSent)
+    {
+      return m_segments.Size ();
+    }
+  uint32_t low = 0;
+  uint32_t high = m_segments.Size ();
+  while (high - low > 1)
+    {
+      uint32_t mid = low + (high - low) / 2;
+      if (m_segments[mid].offset <= offset)
+        {
+          low = mid;
+        }
+      else
+        {
+          high = mid;
+        }
+    }
+  return low;
+}
+
+void
+TcpTxBuffer::RecordTransmission (uint64_t offset, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << offset << size);
+  uint64_t end = offset + size;
+  Time now = Simulator::Now ();
+  // The bytes already sent are retransmitted
+  for (uint32_t i = FindSegment (offset);
+       i < m_segments.Size () && m_segments[i].offset < end; ++i)
+    {
+      if (m_segments[i].lost && !m_segments[i].retransmitted)
+        {
+          if (m_segments[i].offset < offset)
+            {
+              SplitSegment (i, offset);
+              ++i;
+            }
+          if (m_segments[i].offset + m_segments[i].size > end)
+            {
+              SplitSegment (i, end);
+            }
+        }
+      Segment &segment = m_segments[i];
+      segment.retransmits++;
+      segment.lastSent = now;
+      if (segment.lost && !segment.retransmitted)
+        {
+          segment.retransmitted = true;
+          m_retransOut += segment.size;
+        }
+    }
+  if (end > m_highestSent)
+    {
+      Segment segment;
+      segment.offset = std::max (offset, m_highestSent);
+      segment.size = end - segment.offset;
+      segment.retransmits = 0;
+      segment.lastSent = now;
+      segment.sacked = false;
+      segment.lost = false;
+      segment.retransmitted = false;
+      m_segments.PushBack (segment);
+      m_highestSent = end;
+    }
+}
+
+void
+TcpTxBuffer::SplitSegment (uint32_t i, uint64_t offset)
+{
+  NS_LOG_FUNCTION (this << i << offset);
+  Segment second = m_segments[i];
+  second.offset = offset;
+  second.size = m_segments[i].offset + m_segments[i].size - offset;
+  m_segments[i].size -= second.size;
+  m_segments.Insert (i + 1, second);
+}
+
+uint32_t
+TcpTxBuffer::GetSentSegments (void) const
+{
+  return m_segments.Size ();
+}
+
+uint32_t
+TcpTxBuffer::GetRetransmitCount (const SequenceNumber32& seq) const
+{
+  uint32_t i = FindSegment (GetOffset (seq));
+  if (i == m_segments.Size ())
+    {
+      return 0;
+    }
+  return m_segments[i].retransmits;
+}
+
+uint32_t
+TcpTxBuffer::Sack (const TcpOptionSack::SackList &list)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t sacked = 0;
+  for (TcpOptionSack::SackList::const_iterator it = list.begin (); it != list.end (); ++it)
+    {
+      if (it->second <= m_firstByteSeq || it->second <= it->first)
+        {
+          NS_LOG_LOGIC ("Ignoring SACK block [" << it->first << ";" << it->second << ")");
+          continue;
+        }
+      uint64_t begin = it->first < m_firstByteSeq ? m_firstOffset : GetOffset (it->first);
+      uint64_t end = std::min (GetOffset (it->second), m_highestSent);
+      uint32_t i = FindSegment (begin);
+      if (i < m_segments.Size () && m_segments[i].offset < begin)
+        { // The block starts in the middle of this segment
+          ++i;
+        }
+      for (; i < m_segments.Size () && m_segments[i].offset + m_segments[i].size <= end; ++i)
+        {
+          Segment &segment = m_segments[i];
+          if (segment.sacked)
+            {
+              continue;
+            }
+          RackUpdate (segment);
+          Acknowledge (segment, segment.size);
+          segment.sacked = true;
+          segment.lost = false;
+          segment.retransmitted = false;
+          m_sackedOut += segment.size;
+          sacked += segment.size;
+        }
+    }
+  NS_LOG_LOGIC ("Newly sacked " << sacked << " bytes, sacked=" << m_sackedOut);
+  return sacked;
+}
+
+void
+TcpTxBuffer::RackUpdate (const Segment &segment)
+{
+  Time rtt = Simulator::Now () - segment.lastSent;
+  if (segment.retransmits > 0 && rtt < m_minRtt)
+    { // Likely the acknowledgment of an earlier transmission
+      return;
+    }
+  if (segment.retransmits == 0)
+    {
+      m_minRtt = std::min (m_minRtt, rtt);
+    }
+  uint64_t end = segment.offset + segment.size;
+  if (segment.lastSent > m_rackXmitTs
+      || (segment.lastSent == m_rackXmitTs && end > m_rackEndOffset))
+    {
+      m_rackXmitTs = segment.lastSent;
+      m_rackEndOffset = end;
+      m_rackRtt = rtt;
+    }
+}
+
+Time
+TcpTxBuffer::DetectLosses (Time reoWnd)
+{
+  NS_LOG_FUNCTION (this << reoWnd);
+  Time now = Simulator::Now ();
+  Time timeout = Seconds (0);
+  if (m_sackedOut == 0)
+    { // Nothing was delivered beyond the head
+      return timeout;
+    }
+  for (uint32_t i = 0; i < m_segments.Size (); ++i)
+    {
+      Segment &segment = m_segments[i];
+      if (segment.sacked || (segment.lost && !segment.retransmitted))
+        {
+          continue;
+        }
+      uint64_t end = segment.offset + segment.size;
+      if (segment.lastSent > m_rackXmitTs
+          || (segment.lastSent == m_rackXmitTs && end > m_rackEndOffset))
+        { // Sent after the last segment delivered
+          if (end > m_rackEndOffset && segment.retransmits == 0)
+            { // So are all the following segments
+              break;
+            }
+          continue;
+        }
+      Time remaining = segment.lastSent + m_rackRtt + reoWnd - now;
+      if (remaining.IsStrictlyPositive ())
+        {
+          timeout = std::max (timeout, remaining);
+        }
+      else
+        {
+          NS_LOG_LOGIC ("Segment at offset " << segment.offset << " deemed lost");
+          SetLost (segment);
+        }
+    }
+  return timeout;
+}
+
+void
+TcpTxBuffer::MarkHeadAsLost (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_segments.Size () > 0 && !m_segments.Front ().sacked && !m_segments.Front ().lost)
+    {
+      SetLost (m_segments.Front ());
+    }
+}
+
+void
+TcpTxBuffer::MarkAllAsLost (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < m_segments.Size (); ++i)
+    {
+      if (!m_segments[i].sacked)
+        {
+          SetLost (m_segments[i]);
+        }
+    }
+}
+
+void
+TcpTxBuffer::SetLost (Segment &segment)
+{
+  if (!segment.lost)
+    {
+      segment.lost = true;
+      m_lostOut += segment.size;
+    }
+  if (segment.retransmitted)
+    { // The retransmission is lost as well
+      segment.retransmitted = false;
+      m_retransOut -= segment.size;
+    }
+  m_lostHint = std::min (m_lostHint, segment.offset);
+}
+
+void
+TcpTxBuffer::Acknowledge (const Segment &segment, uint32_t size)
+{
+  if (segment.sacked)
+    {
+      m_sackedOut -= size;
+    }
+  if (segment.lost)
+    {
+      m_lostOut -= size;
+    }
+  if (segment.retransmitted)
+    {
+      m_retransOut -= size;
+    }
+}
+
+bool
+TcpTxBuffer::NextLostSegment (SequenceNumber32 &seq, uint32_t &size)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_lostOut == m_retransOut || m_segments.Size () == 0)
+    { // All the lost segments were retransmitted
+      return false;
+    }
+  uint32_t i = FindSegment (std::max (m_lostHint, m_segments[0].offset));
+  for (; i < m_segments.Size (); ++i)
+    {
+      const Segment &segment = m_segments[i];
+      if (segment.lost && !segment.retransmitted)
+        {
+          m_lostHint = segment.offset;
+          seq = m_firstByteSeq + SequenceNumber32 (segment.offset - m_firstOffset);
+          size = segment.size;
+          return true;
+        }
+    }
+  m_lostHint = m_highestSent;
+  return false;
+}
+
+uint32_t
+TcpTxBuffer::GetSackedBytes (void) const
+{
+  return m_sackedOut;
+}
+
+uint32_t
+TcpTxBuffer::GetLostBytes (void) const
+{
+  return m_lostOut;
+}
+
+uint32_t
+TcpTxBuffer::BytesInFlight (void) const
+{
+  uint32_t sent = m_highestSent - m_firstOffset;
+  return sent - m_sackedOut - m_lostOut + m_retransOut;
+}
+
+Time
+TcpTxBuffer::GetMinRtt (void) const
+{
+  return m_minRtt;
+}
+
 } // namepsace ns3
@@ -21,12 +21,15 @@
 #ifndef TCP_TX_BUFFER_H
 #define TCP_TX_BUFFER_H
 
-#include <list>
+#include <algorithm>
+#include <vector>
 #include "ns3/traced-value.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/object.h"
 #include "ns3/sequence-number.h"
 #include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/tcp-option-sack.h"
 
 namespace ns3 {
 class Packet;
@@ -36,6 +39,25 @@ class Packet;
  *
  * \brief class for keeping the data sent by the application to the TCP socket, i.e.
  *        the sending buffer.
+ *
+ * The packets given by the application are kept in a ring, each one
+ * tagged with the offset of its first byte in the stream. Cutting a
+ * segment out of the buffer starts from the packet found last, which
+ * is the right one when segments are sent in order, or else from a
+ * binary search of the ring; acknowledged packets are dropped from
+ * the head of the ring, without modifying a partially acknowledged one.
+ *
+ * The buffer also keeps the scoreboard of the segments sent and not
+ * yet acknowledged: CopyFromSequence records each transmission, and
+ * counts the retransmissions of the bytes already sent. With selective
+ * acknowledgments (\RFC{2018}), the scoreboard records the segments
+ * acknowledged by SACK blocks and the ones deemed lost, either by the
+ * RACK algorithm (\RFC{8985}) or by the socket, and accounts for the
+ * bytes in flight as in \RFC{6675}.
+ *
+ * Consecutive virtual packets (see Packet::IsVirtual), such as the ones
+ * sent by BulkSendApplication, are merged into a single packet, so that
+ * segments of any size are cut out of bulk data without copying bytes.
  */
 class TcpTxBuffer : public Object
 {
@@ -107,12 +129,28 @@ public:
 
   /**
    * Copy data of size numBytes into a packet, data from the range [seq, seq+numBytes)
+   *
+   * The data is recorded in the scoreboard as being sent (or sent again).
+   *
    * \param numBytes number of bytes to copy
    * \param seq start sequence number to extract
    * \returns a packet
    */
   Ptr<Packet> CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq);
 
+  /**
+   * Copy data of size numBytes into a packet, data from the range [seq, seq+numBytes),
+   * for a probe such as a zero window probe
+   *
+   * The data is not recorded in the scoreboard, so that the probe is
+   * neither counted in flight nor as a retransmission of the data.
+   *
+   * \param numBytes number of bytes to copy
+   * \param seq start sequence number to extract
+   * \returns a packet
+   */
+  Ptr<Packet> CopyProbe (uint32_t numBytes, const SequenceNumber32& seq);
+
   /**
    * Set the m_firstByteSeq to seq. Supposed to be called only when the
    * connection is just set up and we did not send any data out yet.
@@ -127,14 +165,258 @@ public:
    */
   void DiscardUpTo (const SequenceNumber32& seq);
 
+  /**
+   * Returns the number of segments sent and not yet acknowledged
+   * \returns the number of segments in the scoreboard
+   */
+  uint32_t GetSentSegments (void) const;
+
+  /**
+   * Returns how many times the segment holding a byte was retransmitted
+   * \param seq the sequence number of the byte
+   * \returns the number of retransmissions, 0 if the byte was never sent
+   */
+  uint32_t GetRetransmitCount (const SequenceNumber32& seq) const;
+
+  /**
+   * Mark the segments covered by SACK blocks as selectively acknowledged
+   *
+   * Only the segments entirely covered by a block are acknowledged;
+   * the blocks below the head of the buffer are ignored.
+   *
+   * \param list the SACK blocks received
+   * \returns the number of bytes newly acknowledged
+   */
+  uint32_t Sack (const TcpOptionSack::SackList &list);
+
+  /**
+   * Mark the segments lost according to the RACK algorithm (\RFC{8985})
+   *
+   * A segment is deemed lost when a segment sent after it has been
+   * acknowledged, and it was sent more than the RTT of that segment
+   * plus the reordering window ago.
+   *
+   * \param reoWnd the reordering window
+   * \returns the time left before one more segment is deemed lost, or
+   *          zero if there is none
+   */
+  Time DetectLosses (Time reoWnd);
+
+  /**
+   * Mark the first segment not acknowledged as lost
+   */
+  void MarkHeadAsLost (void);
+
+  /**
+   * Mark all the segments not selectively acknowledged as lost, e.g.
+   * after a retransmission timeout
+   */
+  void MarkAllAsLost (void);
+
+  /**
+   * Find the first segment deemed lost and not retransmitted since
+   * \param seq the sequence number of the segment, if any
+   * \param size the size of the segment, if any
+   * \returns true if there is such a segment
+   */
+  bool NextLostSegment (SequenceNumber32 &seq, uint32_t &size);
+
+  /**
+   * Returns the number of bytes selectively acknowledged
+   * \returns the number of bytes selectively acknowledged
+   */
+  uint32_t GetSackedBytes (void) const;
+
+  /**
+   * Returns the number of bytes deemed lost
+   * \returns the number of bytes deemed lost
+   */
+  uint32_t GetLostBytes (void) const;
+
+  /**
+   * Returns the number of bytes in flight according to the scoreboard
+   *
+   * As the "pipe" of \RFC{6675}, these are the bytes sent and neither
+   * acknowledged nor deemed lost, plus the retransmissions of the bytes
+   * deemed lost.
+   *
+   * \returns the number of bytes in flight
+   */
+  uint32_t BytesInFlight (void) const;
+
+  /**
+   * Returns the minimum RTT of the segments acknowledged without being
+   * retransmitted
+   * \returns the minimum RTT, or Time::Max () if there was no sample
+   */
+  Time GetMinRtt (void) const;
+
+private:
+  /**
+   * \brief A growable ring, indexed from its head
+   *
+   * Unlike std::deque, the items are stored in a single array, which
+   * only grows; pushing at the back and popping from the front never
+   * allocate once the ring reached its working size.
+   */
+  template <typename T>
+  class Ring
+  {
+public:
+    Ring () : m_head (0), m_count (0) {}
+    /** \returns the number of items */
+    uint32_t Size (void) const { return m_count; }
+    /**
+     * \param i index from the head
+     * \returns the item
+     */
+    T & operator[] (uint32_t i) { return m_items[(m_head + i) & (m_items.size () - 1)]; }
+    /**
+     * \param i index from the head
+     * \returns the item
+     */
+    const T & operator[] (uint32_t i) const { return m_items[(m_head + i) & (m_items.size () - 1)]; }
+    /** \returns the first item */
+    T & Front (void) { return (*this)[0]; }
+    /** \returns the last item */
+    T & Back (void) { return (*this)[m_count - 1]; }
+    /** \param item the item to add at the back */
+    void PushBack (const T &item)
+    {
+      if (m_count == m_items.size ())
+        {
+          std::vector<T> items (std::max<std::size_t> (16, 2 * m_items.size ()));
+          for (uint32_t i = 0; i < m_count; ++i)
+            {
+              items[i] = (*this)[i];
+            }
+          m_items.swap (items);
+          m_head = 0;
+        }
+      m_count++;
+      Back () = item;
+    }
+    /**
+     * \param i index from the head
+     * \param item the item to insert before the item at index i
+     */
+    void Insert (uint32_t i, const T &item)
+    {
+      PushBack (item);
+      for (uint32_t j = m_count - 1; j > i; --j)
+        {
+          (*this)[j] = (*this)[j - 1];
+        }
+      (*this)[i] = item;
+    }
+    /** Remove the first item */
+    void PopFront (void)
+    {
+      Front () = T ();
+      m_head = (m_head + 1) & (m_items.size () - 1);
+      m_count--;
+    }
 private:
-  /// container for data stored in the buffer
-  typedef std::list<Ptr<Packet> >::iterator BufIterator;
+    std::vector<T> m_items;   //!< the storage, its size is a power of two
+    uint32_t m_head;          //!< index of the first item
+    uint32_t m_count;         //!< number of items
+  };
+
+  /// A packet given by the application
+  struct Chunk
+  {
+    uint64_t offset;          //!< Stream offset of the first byte of the packet
+    Ptr<Packet> packet;       //!< The packet
+  };
+
+  /// A segment of the scoreboard
+  struct Segment
+  {
+    uint64_t offset;          //!< Stream offset of the first byte of the segment
+    uint32_t size;            //!< Size of the segment
+    uint32_t retransmits;     //!< Number of retransmissions
+    Time lastSent;            //!< Time of the last transmission
+    bool sacked;              //!< Selectively acknowledged
+    bool lost;                //!< Deemed lost
+    bool retransmitted;       //!< Retransmitted since deemed lost
+  };
+
+  /**
+   * Convert a sequence number of the buffer into a stream offset
+   * \param seq the sequence number
+   * \returns the stream offset
+   */
+  uint64_t GetOffset (const SequenceNumber32& seq) const;
+  /**
+   * Find the packet holding a byte
+   * \param offset the stream offset of the byte
+   * \returns the index of the packet in the ring
+   */
+  uint32_t FindChunk (uint64_t offset);
+  /**
+   * Find the segment of the scoreboard holding a byte
+   * \param offset the stream offset of the byte
+   * \returns the index of the segment in the ring, or the number of
+   *          segments if the byte was not sent
+   */
+  uint32_t FindSegment (uint64_t offset) const;
+  /**
+   * Copy some data of the buffer into a packet
+   * \param offset the stream offset of the first byte
+   * \param s the number of bytes, all of them in the buffer
+   * \returns a packet
+   */
+  Ptr<Packet> CopyData (uint64_t offset, uint32_t s);
+  /**
+   * Record the transmission of some data in the scoreboard
+   *
+   * A segment deemed lost and partially retransmitted is split, so that
+   * its bytes not retransmitted stay to be retransmitted.
+   *
+   * \param offset the stream offset of the first byte sent
+   * \param size the number of bytes sent
+   */
+  void RecordTransmission (uint64_t offset, uint32_t size);
+  /**
+   * Split a segment of the scoreboard in two
+   * \param i the index of the segment in the ring
+   * \param offset the stream offset of the first byte of the second segment
+   */
+  void SplitSegment (uint32_t i, uint64_t offset);
+  /**
+   * Mark a segment as lost
+   * \param segment the segment
+   */
+  void SetLost (Segment &segment);
+  /**
+   * Remove the first bytes of a segment from the counters of the scoreboard
+   * \param segment the segment
+   * \param size the number of bytes acknowledged
+   */
+  void Acknowledge (const Segment &segment, uint32_t size);
+  /**
+   * Update the most recently sent segment delivered, as in step 2 of
+   * the RACK algorithm (\RFC{8985})
+   * \param segment a segment which was just acknowledged
+   */
+  void RackUpdate (const Segment &segment);
 
   TracedValue<SequenceNumber32> m_firstByteSeq; //!< Sequence number of the first byte in data (SND.UNA)
   uint32_t m_size;                              //!< Number of data bytes
   uint32_t m_maxBuffer;                         //!< Max number of data bytes in buffer (SND.WND)
-  std::list<Ptr<Packet> > m_data;               //!< Corresponding data (may be null)
+  uint64_t m_firstOffset;                       //!< Stream offset of the first byte in data
+  uint64_t m_highestSent;                       //!< Stream offset following the last byte sent
+  Ring<Chunk> m_data;                           //!< Corresponding data
+  uint32_t m_cursor;                            //!< Index of the packet found last
+  Ring<Segment> m_segments;                     //!< Scoreboard of the segments sent
+  uint32_t m_sackedOut;                         //!< Number of bytes selectively acknowledged
+  uint32_t m_lostOut;                           //!< Number of bytes deemed lost
+  uint32_t m_retransOut;                        //!< Number of bytes deemed lost and retransmitted
+  uint64_t m_lostHint;                          //!< No lost segment to retransmit before this offset
+  Time m_rackXmitTs;                            //!< Time the most recently sent segment delivered was sent
+  uint64_t m_rackEndOffset;                     //!< Stream offset following that segment
+  Time m_rackRtt;                               //!< RTT of that segment
+  Time m_minRtt;                                //!< Minimum RTT of the segments delivered
 };
 
 } // namepsace ns3
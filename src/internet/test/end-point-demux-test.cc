@@ -0,0 +1,166 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "../model/ipv4-end-point-demux.h"
+#include "../model/ipv4-end-point.h"
+#include "ns3/ipv4-interface.h"
+#include "../model/ipv6-end-point-demux.h"
+#include "../model/ipv6-end-point.h"
+#include "ns3/ipv6-interface.h"
+
+namespace ns3 {
+
+/**
+ * \brief Check the precedence of the matches of Ipv4EndPointDemux, with
+ * listeners and many connected end points
+ */
+class Ipv4EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv4EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+Ipv4EndPointDemuxTestCase::Ipv4EndPointDemuxTestCase ()
+  : TestCase ("IPv4 listeners and connected end points")
+{
+}
+
+void
+Ipv4EndPointDemuxTestCase::DoRun (void)
+{
+  Ipv4EndPointDemux demux;
+  Ptr<Ipv4Interface> interface = CreateObject<Ipv4Interface> ();
+  Ipv4Address local ("10.0.0.1");
+
+  // a wildcard listener and a listener on the local address
+  Ipv4EndPoint *any = demux.Allocate (80);
+  Ipv4EndPoint *listener = demux.Allocate (local, 80);
+  NS_TEST_ASSERT_MSG_EQ ((demux.Allocate (local, 80) == 0), true, "duplicate bind");
+  Ipv4EndPointDemux::EndPoints found = demux.Lookup (local, 80, Ipv4Address ("10.0.1.1"), 1000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "bad number of matches");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), listener, "listener on the address not preferred");
+  found = demux.Lookup (Ipv4Address ("10.0.0.2"), 80, Ipv4Address ("10.0.1.1"), 1000, interface);
+  NS_TEST_ASSERT_MSG_EQ ((found.size () == 1 && found.front () == any), true, "wildcard listener not found");
+  NS_TEST_ASSERT_MSG_EQ (demux.Lookup (local, 81, Ipv4Address ("10.0.1.1"), 1000, interface).size (), 0, "bad port");
+
+  // many connections forked from the listener
+  std::vector<Ipv4EndPoint *> connections;
+  for (uint32_t i = 0; i < 10000; i++)
+    {
+      connections.push_back (demux.Allocate (local, 80, Ipv4Address (0x0a010000 + i), 1000 + i % 7));
+    }
+  NS_TEST_ASSERT_MSG_EQ ((demux.Allocate (local, 80, Ipv4Address (0x0a010000), 1000) == 0), true,
+                         "duplicate connection");
+  for (uint32_t i = 0; i < 10000; i += 97)
+    {
+      found = demux.Lookup (local, 80, Ipv4Address (0x0a010000 + i), 1000 + i % 7, interface);
+      NS_TEST_ASSERT_MSG_EQ ((found.size () == 1 && found.front () == connections[i]), true, "connection not found");
+      NS_TEST_ASSERT_MSG_EQ (demux.SimpleLookup (local, 80, Ipv4Address (0x0a010000 + i), 1000 + i % 7),
+                             connections[i], "connection not found");
+    }
+  // an unknown peer reaches the listener
+  found = demux.Lookup (local, 80, Ipv4Address (0x0a010000), 999, interface);
+  NS_TEST_ASSERT_MSG_EQ ((found.size () == 1 && found.front () == listener), true, "listener not found");
+
+  // an end point whose peer changes is found at its new four-tuple
+  Ipv4EndPoint *client = demux.Allocate (local);
+  uint16_t port = client->GetLocalPort ();
+  client->SetPeer (Ipv4Address ("10.0.2.1"), 443);
+  found = demux.Lookup (local, port, Ipv4Address ("10.0.2.1"), 443, interface);
+  NS_TEST_ASSERT_MSG_EQ ((found.size () == 1 && found.front () == client), true, "connected client not found");
+  client->SetPeer (Ipv4Address ("10.0.2.2"), 443);
+  NS_TEST_ASSERT_MSG_EQ (demux.Lookup (local, port, Ipv4Address ("10.0.2.1"), 443, interface).size (), 0,
+                         "old peer still matches");
+  NS_TEST_ASSERT_MSG_EQ (demux.Lookup (local, port, Ipv4Address ("10.0.2.2"), 443, interface).size (), 1,
+                         "new peer does not match");
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (port), true, "port not in use");
+  demux.DeAllocate (client);
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (port), false, "port still in use");
+
+  // the connections do not outlive their deallocation
+  for (uint32_t i = 0; i < 10000; i++)
+    {
+      demux.DeAllocate (connections[i]);
+    }
+  found = demux.Lookup (local, 80, Ipv4Address (0x0a010000), 1000, interface);
+  NS_TEST_ASSERT_MSG_EQ ((found.size () == 1 && found.front () == listener), true, "connection not removed");
+  NS_TEST_ASSERT_MSG_EQ (demux.GetAllEndPoints ().size (), 2, "bad number of end points");
+}
+
+/**
+ * \brief Check the precedence of the matches of Ipv6EndPointDemux
+ */
+class Ipv6EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv6EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+Ipv6EndPointDemuxTestCase::Ipv6EndPointDemuxTestCase ()
+  : TestCase ("IPv6 listeners and connected end points")
+{
+}
+
+void
+Ipv6EndPointDemuxTestCase::DoRun (void)
+{
+  Ipv6EndPointDemux demux;
+  Ptr<Ipv6Interface> interface = CreateObject<Ipv6Interface> ();
+  Ipv6Address local ("2001:db8::1");
+  Ipv6Address peer ("2001:db8:1::1");
+
+  Ipv6EndPoint *any = demux.Allocate (80);
+  Ipv6EndPoint *connection = demux.Allocate (local, 80, peer, 1000);
+  NS_TEST_ASSERT_MSG_EQ ((demux.Allocate (local, 80, peer, 1000) == 0), true, "duplicate connection");
+  Ipv6EndPointDemux::EndPoints found = demux.Lookup (local, 80, peer, 1000, interface);
+  NS_TEST_ASSERT_MSG_EQ ((found.size () == 1 && found.front () == connection), true, "connection not found");
+  found = demux.Lookup (local, 80, peer, 1001, interface);
+  NS_TEST_ASSERT_MSG_EQ ((found.size () == 1 && found.front () == any), true, "listener not found");
+
+  connection->SetPeer (peer, 1001);
+  found = demux.Lookup (local, 80, peer, 1001, interface);
+  NS_TEST_ASSERT_MSG_EQ ((found.size () == 1 && found.front () == connection), true, "connection not re-indexed");
+  demux.DeAllocate (connection);
+  found = demux.Lookup (local, 80, peer, 1001, interface);
+  NS_TEST_ASSERT_MSG_EQ ((found.size () == 1 && found.front () == any), true, "connection not removed");
+  NS_TEST_ASSERT_MSG_EQ (demux.GetEndPoints ().size (), 1, "bad number of end points");
+}
+
+/**
+ * \brief End point demux TestSuite
+ */
+class EndPointDemuxTestSuite : public TestSuite
+{
+public:
+  EndPointDemuxTestSuite ()
+    : TestSuite ("end-point-demux", UNIT)
+  {
+    AddTestCase (new Ipv4EndPointDemuxTestCase, TestCase::QUICK);
+    AddTestCase (new Ipv6EndPointDemuxTestCase, TestCase::QUICK);
+  }
+};
+
+static EndPointDemuxTestSuite g_endPointDemuxTestSuite; //!< Static variable for test initialization
+
+} // namespace ns3
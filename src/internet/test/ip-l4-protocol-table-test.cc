@@ -0,0 +1,92 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/ip-l4-protocol-table.h"
+#include "ns3/udp-l4-protocol.h"
+#include "ns3/tcp-l4-protocol.h"
+
+namespace ns3 {
+
+/**
+ * \brief Check the lookups and the per-interface overrides of IpL4ProtocolTable
+ */
+class IpL4ProtocolTableTestCase : public TestCase
+{
+public:
+  IpL4ProtocolTableTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+IpL4ProtocolTableTestCase::IpL4ProtocolTableTestCase ()
+  : TestCase ("Default and per-interface protocols")
+{
+}
+
+void
+IpL4ProtocolTableTestCase::DoRun (void)
+{
+  IpL4ProtocolTable table;
+  Ptr<IpL4Protocol> udp = CreateObject<UdpL4Protocol> ();
+  Ptr<IpL4Protocol> udp1 = CreateObject<UdpL4Protocol> ();
+  Ptr<IpL4Protocol> tcp = CreateObject<TcpL4Protocol> ();
+
+  NS_TEST_ASSERT_MSG_EQ (table.Get (17, -1), 0, "empty table");
+  NS_TEST_ASSERT_MSG_EQ (table.Get (300, 0), 0, "invalid protocol number");
+  NS_TEST_ASSERT_MSG_EQ (table.Insert (udp, -1), true, "protocol replaced");
+  NS_TEST_ASSERT_MSG_EQ (table.Insert (tcp, -1), true, "protocol replaced");
+  NS_TEST_ASSERT_MSG_EQ (table.Insert (udp, -1), false, "protocol not replaced");
+
+  // the override applies to its interface only
+  NS_TEST_ASSERT_MSG_EQ (table.Insert (udp1, 1), true, "protocol replaced");
+  NS_TEST_ASSERT_MSG_EQ (table.Get (17, 1), udp1, "override not found");
+  NS_TEST_ASSERT_MSG_EQ (table.Get (17, 0), udp, "bad default protocol");
+  NS_TEST_ASSERT_MSG_EQ (table.Get (17, -1), udp, "bad default protocol");
+  NS_TEST_ASSERT_MSG_EQ (table.Get (6, 1), tcp, "override of another protocol");
+
+  // removing the override restores the default protocol
+  NS_TEST_ASSERT_MSG_EQ (table.Remove (17, 2), false, "non-existent override removed");
+  NS_TEST_ASSERT_MSG_EQ (table.Remove (17, 1), true, "override not removed");
+  NS_TEST_ASSERT_MSG_EQ (table.Get (17, 1), udp, "bad default protocol");
+  NS_TEST_ASSERT_MSG_EQ (table.Remove (17, -1), true, "protocol not removed");
+  NS_TEST_ASSERT_MSG_EQ (table.Get (17, 1), 0, "protocol not removed");
+
+  table.Clear ();
+  NS_TEST_ASSERT_MSG_EQ (table.Get (6, -1), 0, "table not cleared");
+  udp->Dispose ();
+  udp1->Dispose ();
+  tcp->Dispose ();
+}
+
+/**
+ * \brief IpL4ProtocolTable TestSuite
+ */
+class IpL4ProtocolTableTestSuite : public TestSuite
+{
+public:
+  IpL4ProtocolTableTestSuite ()
+    : TestSuite ("ip-l4-protocol-table", UNIT)
+  {
+    AddTestCase (new IpL4ProtocolTableTestCase, TestCase::QUICK);
+  }
+};
+
+static IpL4ProtocolTableTestSuite g_ipL4ProtocolTableTestSuite; //!< Static variable for test initialization
+
+} // namespace ns3
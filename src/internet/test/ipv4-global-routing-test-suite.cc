@@ -17,6 +17,7 @@
 #include <vector>
 #include "ns3/boolean.h"
 #include "ns3/config.h"
+#include "ns3/enum.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
@@ -41,7 +42,10 @@
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/ipv4-global-routing.h"
+#include "ns3/global-route-manager-impl.h"
+#include "ns3/simulation-singleton.h"
 #include "ns3/bridge-helper.h"
+#include "ns3/udp-header.h"
 
 using namespace ns3;
 
@@ -1167,6 +1171,250 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+// Check the route lookup through the index of LOOKUP_TRIE, and the
+// pinning of the flows to one of the ECMP routes
+class Ipv4GlobalRoutingLookupTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingLookupTestCase ();
+
+private:
+  virtual void DoRun (void);
+  Ipv4Address Lookup (Ptr<Ipv4GlobalRouting> routing, std::string dest,
+                      uint16_t sport = 1, Ptr<NetDevice> oif = 0);
+};
+
+Ipv4GlobalRoutingLookupTestCase::Ipv4GlobalRoutingLookupTestCase ()
+  : TestCase ("Global routing lookup with a trie and per-flow ECMP")
+{
+}
+
+Ipv4Address
+Ipv4GlobalRoutingLookupTestCase::Lookup (Ptr<Ipv4GlobalRouting> routing, std::string dest,
+                                         uint16_t sport, Ptr<NetDevice> oif)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  UdpHeader udp;
+  udp.SetSourcePort (sport);
+  udp.SetDestinationPort (9);
+  p->AddHeader (udp);
+  Ipv4Header header;
+  header.SetSource (Ipv4Address ("10.0.1.1"));
+  header.SetDestination (Ipv4Address (dest.c_str ()));
+  header.SetProtocol (17);
+  Socket::SocketErrno err;
+  Ptr<Ipv4Route> route = routing->RouteOutput (p, header, oif, err);
+  return route == 0 ? Ipv4Address::GetAny () : route->GetGateway ();
+}
+
+void
+Ipv4GlobalRoutingLookupTestCase::DoRun (void)
+{
+  Ptr<Node> n = CreateObject<Node> ();
+  InternetStackHelper internet;
+  internet.Install (n);
+  SimpleNetDeviceHelper devHelper;
+  NetDeviceContainer devices;
+  devices.Add (devHelper.Install (n));
+  devices.Add (devHelper.Install (n));
+  devices.Add (devHelper.Install (n));
+  Ipv4AddressHelper ipv4;
+  for (uint32_t i = 0; i < devices.GetN (); ++i)
+    {
+      std::ostringstream base;
+      base << "10.0." << i + 1 << ".0";
+      ipv4.SetBase (base.str ().c_str (), "255.255.255.0");
+      ipv4.Assign (NetDeviceContainer (devices.Get (i)));
+    }
+
+  Ptr<Ipv4GlobalRouting> routing = CreateObject<Ipv4GlobalRouting> ();
+  routing->SetAttribute ("LookupMode", EnumValue (LOOKUP_TRIE));
+  routing->SetAttribute ("EcmpMode", EnumValue (ECMP_HASH));
+  routing->SetIpv4 (n->GetObject<Ipv4> ());
+  routing->AddHostRouteTo (Ipv4Address ("10.2.5.7"), Ipv4Address ("10.0.1.2"), 1);
+  routing->AddNetworkRouteTo (Ipv4Address ("10.2.0.0"), Ipv4Mask ("/16"), Ipv4Address ("10.0.1.2"), 1);
+  routing->AddNetworkRouteTo (Ipv4Address ("10.2.5.0"), Ipv4Mask ("/24"), Ipv4Address ("10.0.2.2"), 2);
+  routing->AddNetworkRouteTo (Ipv4Address ("10.2.5.0"), Ipv4Mask ("/24"), Ipv4Address ("10.0.3.2"), 3);
+  routing->AddASExternalRouteTo (Ipv4Address ("0.0.0.0"), Ipv4Mask ("/0"), Ipv4Address ("10.0.3.2"), 3);
+
+  // host routes first, then the longest prefix, then external routes
+  NS_TEST_ASSERT_MSG_EQ (Lookup (routing, "10.2.5.7"), Ipv4Address ("10.0.1.2"), "host route not used");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (routing, "10.2.9.9"), Ipv4Address ("10.0.1.2"), "bad /16 route");
+  NS_TEST_ASSERT_MSG_NE (Lookup (routing, "10.2.5.9"), Ipv4Address ("10.0.1.2"), "longest prefix not used");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (routing, "192.168.0.1"), Ipv4Address ("10.0.3.2"), "external route not used");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (routing, "10.2.5.9", 1, devices.Get (1)), Ipv4Address ("10.0.2.2"),
+                         "output interface not honoured");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (routing, "10.2.5.7", 1, devices.Get (2)), Ipv4Address ("10.0.3.2"),
+                         "no fallback on the network route through the output interface");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (routing, "10.2.5.9", 1, devices.Get (0)), Ipv4Address ("10.0.1.2"),
+                         "no fallback on a shorter prefix through the output interface");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (routing, "10.3.0.1", 1, devices.Get (0)), Ipv4Address::GetAny (),
+                         "route found through the wrong output interface");
+
+  // flows stay on one path, and are spread on both
+  uint32_t onFirst = 0;
+  for (uint16_t sport = 1; sport <= 64; ++sport)
+    {
+      Ipv4Address gw = Lookup (routing, "10.2.5.9", sport);
+      NS_TEST_ASSERT_MSG_EQ (Lookup (routing, "10.2.5.9", sport), gw, "flow not pinned to a path");
+      onFirst += (gw == Ipv4Address ("10.0.2.2")) ? 1 : 0;
+    }
+  NS_TEST_ASSERT_MSG_GT (onFirst, 0, "ECMP route never used");
+  NS_TEST_ASSERT_MSG_LT (onFirst, 64, "ECMP route never used");
+
+  // the index follows the changes of the routes
+  routing->RemoveRoute (0);
+  NS_TEST_ASSERT_MSG_NE (Lookup (routing, "10.2.5.7"), Ipv4Address ("10.0.1.2"), "removed route used");
+
+  // the linear scan considers every matching network
+  routing->SetAttribute ("LookupMode", EnumValue (LOOKUP_LIST));
+  routing->SetAttribute ("EcmpMode", EnumValue (ECMP_NONE));
+  NS_TEST_ASSERT_MSG_EQ (Lookup (routing, "10.2.5.9"), Ipv4Address ("10.0.1.2"), "bad first network route");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (routing, "10.2.5.9", 1, devices.Get (0)), Ipv4Address ("10.0.1.2"),
+                         "bad network route through the output interface");
+
+  routing->Dispose ();
+  Simulator::Destroy ();
+}
+
+// Check that the parallel and incremental SPF install the same routes as
+// the legacy SPF, before and after a link goes down and up again
+class Ipv4GlobalRoutingSpfModeTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingSpfModeTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Recompute the routes with a SPF mode
+   * \param mode the SPF mode
+   * \returns the routes of each node
+   */
+  std::vector<std::string> Recompute (std::string mode);
+  /**
+   * \brief Check the routes of each node
+   * \param routes the routes
+   * \param expected the routes expected
+   * \param msg the message
+   */
+  void CheckRoutes (const std::vector<std::string> &routes, const std::vector<std::string> &expected,
+                    std::string msg);
+
+  NodeContainer m_nodes; //!< The routers
+};
+
+Ipv4GlobalRoutingSpfModeTestCase::Ipv4GlobalRoutingSpfModeTestCase ()
+  : TestCase ("Global routing with the parallel and incremental SPF")
+{
+}
+
+std::vector<std::string>
+Ipv4GlobalRoutingSpfModeTestCase::Recompute (std::string mode)
+{
+  Config::SetGlobal ("GlobalRoutingSpfMode", StringValue (mode));
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  std::vector<std::string> routes;
+  for (uint32_t i = 0; i < m_nodes.GetN (); ++i)
+    {
+      Ptr<Ipv4GlobalRouting> routing =
+        m_nodes.Get (i)->GetObject<Ipv4> ()->GetRoutingProtocol ()->GetObject<Ipv4GlobalRouting> ();
+      std::ostringstream oss;
+      for (uint32_t j = 0; j < routing->GetNRoutes (); ++j)
+        {
+          oss << *routing->GetRoute (j) << "; ";
+        }
+      routes.push_back (oss.str ());
+    }
+  return routes;
+}
+
+void
+Ipv4GlobalRoutingSpfModeTestCase::CheckRoutes (const std::vector<std::string> &routes,
+                                               const std::vector<std::string> &expected,
+                                               std::string msg)
+{
+  for (uint32_t i = 0; i < routes.size (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (routes[i], expected[i], msg << " on node " << i);
+    }
+}
+
+void
+Ipv4GlobalRoutingSpfModeTestCase::DoRun (void)
+{
+  // A ring n0-n1-n2-n3 with equal-cost paths, the stub router n4 on n2 and
+  // n5 on n0 with a stub network; apart, a LAN between n6, n7 and n8, and n9
+  // on n8.  The legacy SPF does not support a LAN reached through several
+  // equal-cost paths.
+  m_nodes.Create (10);
+  InternetStackHelper internet;
+  Ipv4GlobalRoutingHelper ipv4RoutingHelper;
+  internet.SetRoutingHelper (ipv4RoutingHelper);
+  internet.Install (m_nodes);
+
+  SimpleNetDeviceHelper p2p;
+  p2p.SetNetDevicePointToPointMode (true);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.0.0", "255.255.255.252");
+  uint32_t links[][2] = { {0, 1}, {1, 2}, {2, 3}, {3, 0}, {2, 4}, {0, 5}, {8, 9} };
+  NetDeviceContainer ring;
+  for (uint32_t i = 0; i < sizeof (links) / sizeof (links[0]); ++i)
+    {
+      NetDeviceContainer devices = p2p.Install (NodeContainer (m_nodes.Get (links[i][0]), m_nodes.Get (links[i][1])),
+                                                CreateObject<SimpleChannel> ());
+      ring.Add (devices);
+      ipv4.Assign (devices);
+      ipv4.NewNetwork ();
+    }
+  SimpleNetDeviceHelper lan;
+  ipv4.SetBase ("10.2.0.0", "255.255.255.0");
+  ipv4.Assign (lan.Install (NodeContainer (m_nodes.Get (6), m_nodes.Get (7), m_nodes.Get (8)),
+                            CreateObject<SimpleChannel> ()));
+  ipv4.SetBase ("10.3.0.0", "255.255.255.0");
+  NetDeviceContainer stub = lan.Install (m_nodes.Get (5), CreateObject<SimpleChannel> ());
+  ipv4.Assign (stub);
+
+  Config::SetGlobal ("GlobalRoutingSpfMode", StringValue ("Legacy"));
+  Config::SetGlobal ("GlobalRoutingSpfThreads", UintegerValue (3));
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  std::vector<std::string> legacy = Recompute ("Legacy");
+  CheckRoutes (Recompute ("Parallel"), legacy, "Parallel SPF differs");
+  CheckRoutes (Recompute ("Incremental"), legacy, "Incremental SPF differs");
+
+  // The stub network of n5 goes down: the shortest paths do not change, and
+  // only the routes to the network are removed
+  Ptr<Ipv4> ip5 = m_nodes.Get (5)->GetObject<Ipv4> ();
+  uint32_t stubInterface = ip5->GetInterfaceForDevice (stub.Get (0));
+  ip5->SetDown (stubInterface);
+  std::vector<std::string> incremental = Recompute ("Incremental");
+  GlobalRouteManagerImpl::SpfSummary summary =
+    SimulationSingleton<GlobalRouteManagerImpl>::Get ()->GetSpfSummary ();
+  NS_TEST_EXPECT_MSG_LT (summary.computed, summary.roots, "every router recomputed");
+  NS_TEST_EXPECT_MSG_GT (summary.patched, 0, "no router pruned");
+  CheckRoutes (incremental, Recompute ("Legacy"), "Incremental SPF differs after stub down");
+
+  // A link of the ring goes down: the routers of the LAN are not recomputed
+  Recompute ("Incremental");
+  Ptr<Ipv4> ip1 = m_nodes.Get (1)->GetObject<Ipv4> ();
+  uint32_t ringInterface = ip1->GetInterfaceForDevice (ring.Get (1));
+  ip1->SetDown (ringInterface);
+  incremental = Recompute ("Incremental");
+  summary = SimulationSingleton<GlobalRouteManagerImpl>::Get ()->GetSpfSummary ();
+  NS_TEST_EXPECT_MSG_LT (summary.computed, summary.roots, "every router recomputed");
+  CheckRoutes (incremental, Recompute ("Legacy"), "Incremental SPF differs after link down");
+
+  Recompute ("Incremental");
+  ip1->SetUp (ringInterface);
+  ip5->SetUp (stubInterface);
+  incremental = Recompute ("Incremental");
+  CheckRoutes (incremental, Recompute ("Legacy"), "Incremental SPF differs after link up");
+  CheckRoutes (incremental, legacy, "Routes not restored");
+
+  Config::SetGlobal ("GlobalRoutingSpfThreads", UintegerValue (0));
+  Simulator::Destroy ();
+}
+
 class Ipv4GlobalRoutingTestSuite : public TestSuite
 {
 public:
@@ -1184,6 +1432,8 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite ()
     AddTestCase (new TwoBridgeTest, TestCase::QUICK);
     AddTestCase (new Ipv4DynamicGlobalRoutingTestCase, TestCase::QUICK);
     AddTestCase (new Ipv4GlobalRoutingSlash32TestCase, TestCase::QUICK);
+    AddTestCase (new Ipv4GlobalRoutingLookupTestCase, TestCase::QUICK);
+    AddTestCase (new Ipv4GlobalRoutingSpfModeTestCase, TestCase::QUICK);
   }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -759,17 +759,17 @@ TcpGeneralTest::GetRWnd (SocketWho who)
     }
 }
 
-EventId
-TcpGeneralTest::GetPersistentEvent (SocketWho who)
+const Timer &
+TcpGeneralTest::GetPersistTimer (SocketWho who)
 {
   if (who == SENDER)
     {
-      return DynamicCast<TcpSocketMsgBase> (m_senderSocket)->m_persistEvent;
+      return DynamicCast<TcpSocketMsgBase> (m_senderSocket)->m_persistTimer;
     }
   else if (who == RECEIVER)
     {
 
-      return DynamicCast<TcpSocketMsgBase> (m_receiverSocket)->m_persistEvent;
+      return DynamicCast<TcpSocketMsgBase> (m_receiverSocket)->m_persistTimer;
     }
   else
     {
@@ -1170,15 +1170,15 @@ TcpSocketSmallAcks::SendEmptyPacket (uint8_t flags)
 
   if (flags & TcpHeader::ACK)
     { // If sending an ACK, cancel the delay ACK as well
-      m_delAckEvent.Cancel ();
+      m_delAckTimer.Cancel ();
       m_delAckCount = 0;
     }
-  if (m_retxEvent.IsExpired () && (hasSyn || hasFin) && !isAck )
+  if (m_retxTimer.IsExpired () && (hasSyn || hasFin) && !isAck )
     { // Retransmit SYN / SYN+ACK / FIN / FIN+ACK to guard against lost
       NS_LOG_LOGIC ("Schedule retransmission timeout at time "
                     << Simulator::Now ().GetSeconds () << " to expire at time "
                     << (Simulator::Now () + m_rto.Get ()).GetSeconds ());
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketSmallAcks::SendEmptyPacket, this, flags);
+      ScheduleRetxTimer (m_rto, RETX_SEND_EMPTY, flags);
     }
 
   // send another ACK if bytes remain
@@ -484,12 +484,12 @@ protected:
   uint32_t GetRWnd (SocketWho who);
 
   /**
-   * \brief Get the persistent event of the selected socket
+   * \brief Get the persist timer of the selected socket
    *
    * \param who socket where check the parameter
-   * \return the persistent event in the selected socket
+   * \return the persist timer in the selected socket
    */
-  EventId GetPersistentEvent (SocketWho who);
+  const Timer & GetPersistTimer (SocketWho who);
 
   /**
    * \brief Get the persistent timeout of the selected socket
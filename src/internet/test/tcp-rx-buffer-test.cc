@@ -0,0 +1,183 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/tcp-rx-buffer.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+/**
+ * \brief Check the reassembly done by TcpRxBuffer
+ *
+ * Segments carry a byte pattern derived from their sequence number, so
+ * that the order of the bytes extracted can be verified.
+ */
+class TcpRxBufferTestCase : public TestCase
+{
+public:
+  TcpRxBufferTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Add a segment carrying the pattern to the buffer
+   * \param buf the buffer
+   * \param seq the sequence number of the first byte
+   * \param size the size of the segment
+   * \returns the value returned by TcpRxBuffer::Add
+   */
+  bool AddSegment (Ptr<TcpRxBuffer> buf, uint32_t seq, uint32_t size);
+  /**
+   * \brief Check the content of an extracted packet
+   * \param p the packet
+   * \param seq the sequence number of its first byte
+   * \returns true if the packet carries the pattern
+   */
+  bool CheckPattern (Ptr<Packet> p, uint32_t seq);
+};
+
+TcpRxBufferTestCase::TcpRxBufferTestCase ()
+  : TestCase ("Reassembly of reordered and overlapping segments")
+{
+}
+
+bool
+TcpRxBufferTestCase::AddSegment (Ptr<TcpRxBuffer> buf, uint32_t seq, uint32_t size)
+{
+  std::vector<uint8_t> data (size);
+  for (uint32_t i = 0; i < size; ++i)
+    {
+      data[i] = static_cast<uint8_t> ((seq + i) % 251);
+    }
+  TcpHeader h;
+  h.SetSequenceNumber (SequenceNumber32 (seq));
+  return buf->Add (Create<Packet> (&data[0], size), h);
+}
+
+bool
+TcpRxBufferTestCase::CheckPattern (Ptr<Packet> p, uint32_t seq)
+{
+  std::vector<uint8_t> data (p->GetSize ());
+  p->CopyData (&data[0], data.size ());
+  for (uint32_t i = 0; i < data.size (); ++i)
+    {
+      if (data[i] != static_cast<uint8_t> ((seq + i) % 251))
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+TcpRxBufferTestCase::DoRun (void)
+{
+  Ptr<TcpRxBuffer> buf = CreateObject<TcpRxBuffer> (1000);
+  buf->SetMaxBufferSize (10000);
+
+  // in order
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (buf, 1000, 100), true, "in-order segment rejected");
+  NS_TEST_ASSERT_MSG_EQ (buf->Available (), 100, "in-order segment not available");
+  NS_TEST_ASSERT_MSG_EQ (buf->NextRxSequence (), SequenceNumber32 (1100), "bad RCV.NXT");
+
+  // out of order, then the hole is filled
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (buf, 1300, 100), true, "segment rejected");
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (buf, 1200, 100), true, "segment rejected");
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (buf, 1500, 100), true, "segment rejected");
+  NS_TEST_ASSERT_MSG_EQ (buf->Available (), 100, "out-of-order data available");
+  NS_TEST_ASSERT_MSG_EQ (buf->Size (), 400, "bad occupancy");
+
+  // SACK blocks: the last segment received first, then in order
+  TcpOptionSack::SackList sack = buf->GetSackList (4);
+  NS_TEST_ASSERT_MSG_EQ (sack.size (), 2, "bad number of SACK blocks");
+  NS_TEST_ASSERT_MSG_EQ (sack.front ().first, SequenceNumber32 (1500), "bad first SACK block");
+  NS_TEST_ASSERT_MSG_EQ (sack.back ().first, SequenceNumber32 (1200), "bad second SACK block");
+  NS_TEST_ASSERT_MSG_EQ (sack.back ().second, SequenceNumber32 (1400), "bad second SACK block");
+  NS_TEST_ASSERT_MSG_EQ (buf->GetSackList (1).size (), 1, "too many SACK blocks");
+
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (buf, 1100, 100), true, "segment rejected");
+  NS_TEST_ASSERT_MSG_EQ (buf->Available (), 400, "hole not filled");
+  NS_TEST_ASSERT_MSG_EQ (buf->NextRxSequence (), SequenceNumber32 (1400), "bad RCV.NXT");
+  NS_TEST_ASSERT_MSG_EQ (buf->GetSackList (4).size (), 1, "in-sequence data SACKed");
+
+  // duplicates and overlaps only store the missing bytes
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (buf, 1200, 100), false, "duplicate stored");
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (buf, 1350, 300), true, "overlapping segment rejected");
+  NS_TEST_ASSERT_MSG_EQ (buf->Size (), 650, "overlap stored twice");
+  NS_TEST_ASSERT_MSG_EQ (buf->Available (), 650, "overlap not in sequence");
+
+  // partial extraction, then the rest
+  Ptr<Packet> p = buf->Extract (250);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 250, "bad extracted size");
+  NS_TEST_ASSERT_MSG_EQ (CheckPattern (p, 1000), true, "bad extracted data");
+  p = buf->Extract (1000);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 400, "bad extracted size");
+  NS_TEST_ASSERT_MSG_EQ (CheckPattern (p, 1250), true, "bad extracted data");
+  NS_TEST_ASSERT_MSG_EQ (buf->Size (), 0, "buffer not empty");
+  NS_TEST_ASSERT_MSG_EQ (buf->Extract (1000), 0, "extracted from an empty buffer");
+
+  // data beyond the receive window is dropped
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (buf, 2000, 100), true, "segment rejected");
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (buf, 11900, 200), true, "segment rejected");
+  NS_TEST_ASSERT_MSG_EQ (buf->Size (), 200, "window not enforced");
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (buf, 12000, 100), false, "segment beyond the window stored");
+
+  // FIN
+  buf = CreateObject<TcpRxBuffer> (0);
+  buf->SetMaxBufferSize (10000);
+  buf->SetFinSequence (SequenceNumber32 (200));
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (buf, 100, 100), true, "segment rejected");
+  NS_TEST_ASSERT_MSG_EQ (buf->Finished (), false, "finished with a hole");
+  NS_TEST_ASSERT_MSG_EQ (AddSegment (buf, 0, 100), true, "segment rejected");
+  NS_TEST_ASSERT_MSG_EQ (buf->Finished (), true, "not finished");
+  NS_TEST_ASSERT_MSG_EQ (buf->NextRxSequence (), SequenceNumber32 (201), "FIN not accounted");
+
+  // virtual payload is merged into a single packet
+  buf = CreateObject<TcpRxBuffer> (0);
+  buf->SetMaxBufferSize (100000);
+  TcpHeader h;
+  for (uint32_t i = 10; i > 0; --i)
+    {
+      h.SetSequenceNumber (SequenceNumber32 ((i - 1) * 1000));
+      buf->Add (Create<Packet> (1000), h);
+    }
+  NS_TEST_ASSERT_MSG_EQ (buf->Available (), 10000, "virtual segments not merged");
+  p = buf->Extract (10000);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 10000, "bad extracted size");
+  NS_TEST_ASSERT_MSG_EQ (p->IsVirtual (), true, "virtual payload materialized");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief TcpRxBuffer TestSuite
+ */
+class TcpRxBufferTestSuite : public TestSuite
+{
+public:
+  TcpRxBufferTestSuite ()
+    : TestSuite ("tcp-rx-buffer", UNIT)
+  {
+    AddTestCase (new TcpRxBufferTestCase, TestCase::QUICK);
+  }
+};
+
+static TcpRxBufferTestSuite g_tcpRxBufferTestSuite; //!< Static variable for test initialization
+
+} // namespace ns3
@@ -0,0 +1,228 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "tcp-general-test.h"
+#include "tcp-error-model.h"
+#include "ns3/node.h"
+#include "ns3/log.h"
+#include "ns3/tcp-option.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpSackRecoveryTestSuite");
+
+/**
+ * \brief Check the SACK loss recovery of a segment lost in the last flight
+ *
+ * Ten segments are sent in one flight, with SACK on both ends, and the
+ * receiver drops the first transmission of one of them.
+ *
+ * When the segment lost is followed by a single one (and by the FIN),
+ * the receiver sends only two duplicate ACKs: the loss is detected by
+ * RACK when the reordering window expires, and the segment is resent in
+ * SACK recovery.
+ *
+ * When the segment lost is the last one, no SACK arrives: a tail loss
+ * probe resends it before the RTO.
+ *
+ * In both cases the segment is resent once, without any RTO.
+ */
+class TcpSackRecoveryTest : public TcpGeneralTest
+{
+public:
+  /**
+   * \param seqToKill the sequence number of the segment lost
+   * \param tailLoss true if the segment lost is the last one
+   * \param desc the test description
+   */
+  TcpSackRecoveryTest (uint32_t seqToKill, bool tailLoss, const std::string &desc);
+
+protected:
+  virtual Ptr<TcpSocketMsgBase> CreateSenderSocket (Ptr<Node> node);
+  virtual Ptr<TcpSocketMsgBase> CreateReceiverSocket (Ptr<Node> node);
+  virtual Ptr<ErrorModel> CreateReceiverErrorModel ();
+
+  virtual void CongStateTrace (const TcpSocketState::TcpCongState_t oldValue,
+                               const TcpSocketState::TcpCongState_t newValue);
+  virtual void Tx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void RcvAck (const Ptr<const TcpSocketState> tcb,
+                       const TcpHeader& h, SocketWho who);
+  virtual void RTOExpired (const Ptr<const TcpSocketState> tcb, SocketWho who);
+  virtual void FinalChecks ();
+
+  virtual void ConfigureEnvironment ();
+  virtual void ConfigureProperties ();
+
+private:
+  uint32_t m_seqToKill;        //!< The sequence number of the segment lost
+  bool m_tailLoss;             //!< True if the segment lost is the last one
+  TcpSocketState::TcpCongState_t m_congState; //!< The congestion state of the sender
+  uint32_t m_acks;             //!< The ACKs of the segment lost received
+  bool m_sackReceived;         //!< True if one of them had a SACK option
+  uint32_t m_transmissions;    //!< The transmissions of the segment lost
+  uint32_t m_dupAcks;          //!< The duplicate ACKs received before the retransmission
+  TcpSocketState::TcpCongState_t m_retxState; //!< The congestion state at the retransmission
+  bool m_rtoExpired;           //!< True if the RTO expired
+  SequenceNumber32 m_highAck;  //!< The highest ACK sent by the receiver
+};
+
+TcpSackRecoveryTest::TcpSackRecoveryTest (uint32_t seqToKill, bool tailLoss,
+                                          const std::string &desc)
+  : TcpGeneralTest (desc),
+    m_seqToKill (seqToKill),
+    m_tailLoss (tailLoss),
+    m_congState (TcpSocketState::CA_OPEN),
+    m_acks (0),
+    m_sackReceived (false),
+    m_transmissions (0),
+    m_dupAcks (0),
+    m_retxState (TcpSocketState::CA_OPEN),
+    m_rtoExpired (false),
+    m_highAck (0)
+{
+}
+
+void
+TcpSackRecoveryTest::ConfigureEnvironment ()
+{
+  TcpGeneralTest::ConfigureEnvironment ();
+  SetAppPktCount (10);
+  SetPropagationDelay (MilliSeconds (10));
+}
+
+void
+TcpSackRecoveryTest::ConfigureProperties ()
+{
+  TcpGeneralTest::ConfigureProperties ();
+  SetInitialCwnd (SENDER, 10);
+}
+
+Ptr<TcpSocketMsgBase>
+TcpSackRecoveryTest::CreateSenderSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket (node);
+  socket->SetAttribute ("Sack", BooleanValue (true));
+  return socket;
+}
+
+Ptr<TcpSocketMsgBase>
+TcpSackRecoveryTest::CreateReceiverSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateReceiverSocket (node);
+  socket->SetAttribute ("Sack", BooleanValue (true));
+  return socket;
+}
+
+Ptr<ErrorModel>
+TcpSackRecoveryTest::CreateReceiverErrorModel ()
+{
+  Ptr<TcpSeqErrorModel> errorModel = CreateObject<TcpSeqErrorModel> ();
+  errorModel->AddSeqToKill (SequenceNumber32 (m_seqToKill));
+  return errorModel;
+}
+
+void
+TcpSackRecoveryTest::CongStateTrace (const TcpSocketState::TcpCongState_t oldValue,
+                                     const TcpSocketState::TcpCongState_t newValue)
+{
+  NS_LOG_INFO ("\tSENDER " << TcpSocketState::TcpCongStateName[oldValue] <<
+               " -> " << TcpSocketState::TcpCongStateName[newValue]);
+  m_congState = newValue;
+}
+
+void
+TcpSackRecoveryTest::Tx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who == RECEIVER && h.GetAckNumber () > m_highAck)
+    {
+      m_highAck = h.GetAckNumber ();
+    }
+  else if (who == SENDER && p->GetSize () > 0
+           && h.GetSequenceNumber () == SequenceNumber32 (m_seqToKill))
+    {
+      NS_LOG_INFO ("\tSENDER TX " << h << " size " << p->GetSize ());
+      if (++m_transmissions == 2)
+        {
+          m_dupAcks = m_acks > 0 ? m_acks - 1 : 0;
+          m_retxState = m_congState;
+        }
+    }
+}
+
+void
+TcpSackRecoveryTest::RcvAck (const Ptr<const TcpSocketState> tcb,
+                             const TcpHeader &h, SocketWho who)
+{
+  if (who == SENDER && h.GetAckNumber () == SequenceNumber32 (m_seqToKill))
+    {
+      NS_LOG_INFO ("\tSENDER RX " << h);
+      m_acks++;
+      if (h.HasOption (TcpOption::SACK))
+        {
+          m_sackReceived = true;
+        }
+    }
+}
+
+void
+TcpSackRecoveryTest::RTOExpired (const Ptr<const TcpSocketState> tcb, SocketWho who)
+{
+  if (who == SENDER)
+    {
+      m_rtoExpired = true;
+    }
+}
+
+void
+TcpSackRecoveryTest::FinalChecks ()
+{
+  NS_TEST_ASSERT_MSG_EQ (m_rtoExpired, false, "The RTO expired");
+  NS_TEST_ASSERT_MSG_EQ (m_transmissions, 2, "The segment lost was not resent once");
+  NS_TEST_ASSERT_MSG_GT (m_highAck, SequenceNumber32 (10 * 500), "Data not delivered");
+  if (m_tailLoss)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_sackReceived, false, "SACK received for a tail loss");
+      NS_TEST_ASSERT_MSG_EQ ((m_retxState == TcpSocketState::CA_OPEN
+                              || m_retxState == TcpSocketState::CA_DISORDER), true,
+                             "The segment was not resent by a tail loss probe");
+    }
+  else
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_sackReceived, true, "No SACK received");
+      NS_TEST_ASSERT_MSG_LT (m_dupAcks, 3, "The loss was detected by duplicate ACKs");
+      NS_TEST_ASSERT_MSG_EQ (m_retxState, TcpSocketState::CA_RECOVERY,
+                             "The segment was not resent in SACK recovery");
+    }
+}
+
+/**
+ * \brief The test suite of the SACK loss recovery
+ */
+static class TcpSackRecoveryTestSuite : public TestSuite
+{
+public:
+  TcpSackRecoveryTestSuite ()
+    : TestSuite ("tcp-sack-recovery-test", UNIT)
+  {
+    AddTestCase (new TcpSackRecoveryTest (4001, false, "RACK detects the loss of the last but one segment"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpSackRecoveryTest (4501, true, "Tail loss probe resends the last segment"),
+                 TestCase::QUICK);
+  }
+} g_tcpSackRecoveryTestSuite;
+
+} // namespace ns3
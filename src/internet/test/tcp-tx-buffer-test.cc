@@ -0,0 +1,333 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/tcp-tx-buffer.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+/**
+ * \brief Check the segments cut out of TcpTxBuffer and its scoreboard
+ *
+ * The application writes carry a byte pattern derived from their stream
+ * offset, so that the content of the segments can be verified.
+ */
+class TcpTxBufferTestCase : public TestCase
+{
+public:
+  TcpTxBufferTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Check the content of a segment
+   * \param p the segment
+   * \param offset the stream offset of its first byte
+   * \returns true if the segment carries the pattern
+   */
+  bool CheckPattern (Ptr<Packet> p, uint32_t offset);
+};
+
+TcpTxBufferTestCase::TcpTxBufferTestCase ()
+  : TestCase ("Segmentation, acknowledgment and scoreboard")
+{
+}
+
+bool
+TcpTxBufferTestCase::CheckPattern (Ptr<Packet> p, uint32_t offset)
+{
+  std::vector<uint8_t> data (p->GetSize ());
+  p->CopyData (&data[0], data.size ());
+  for (uint32_t i = 0; i < data.size (); ++i)
+    {
+      if (data[i] != static_cast<uint8_t> ((offset + i) % 251))
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+TcpTxBufferTestCase::DoRun (void)
+{
+  Ptr<TcpTxBuffer> buf = CreateObject<TcpTxBuffer> (0);
+  buf->SetMaxBufferSize (100000);
+  buf->SetHeadSequence (SequenceNumber32 (1000));
+
+  // application writes of various sizes
+  uint32_t sizes[] = { 100, 700, 50, 3000, 1 };
+  uint32_t total = 0;
+  for (uint32_t i = 0; i < sizeof (sizes) / sizeof (sizes[0]); ++i)
+    {
+      std::vector<uint8_t> data (sizes[i]);
+      for (uint32_t j = 0; j < sizes[i]; ++j)
+        {
+          data[j] = static_cast<uint8_t> ((total + j) % 251);
+        }
+      NS_TEST_ASSERT_MSG_EQ (buf->Add (Create<Packet> (&data[0], sizes[i])), true, "write rejected");
+      total += sizes[i];
+    }
+  NS_TEST_ASSERT_MSG_EQ (buf->Size (), total, "bad buffer size");
+  NS_TEST_ASSERT_MSG_EQ (buf->TailSequence (), SequenceNumber32 (1000 + total), "bad tail");
+
+  // segments spanning several writes, in order
+  uint32_t sent = 0;
+  while (sent < total)
+    {
+      Ptr<Packet> p = buf->CopyFromSequence (536, SequenceNumber32 (1000 + sent));
+      NS_TEST_ASSERT_MSG_EQ (p->GetSize (), std::min (536u, total - sent), "bad segment size");
+      NS_TEST_ASSERT_MSG_EQ (CheckPattern (p, sent), true, "bad segment data");
+      sent += p->GetSize ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (buf->GetSentSegments (), (total + 535) / 536, "bad scoreboard");
+  NS_TEST_ASSERT_MSG_EQ (buf->GetRetransmitCount (SequenceNumber32 (1000)), 0, "bad retransmit count");
+
+  // partial acknowledgment in the middle of a write, then retransmission
+  buf->DiscardUpTo (SequenceNumber32 (1000 + 600));
+  NS_TEST_ASSERT_MSG_EQ (buf->Size (), total - 600, "bad size after ack");
+  NS_TEST_ASSERT_MSG_EQ (buf->HeadSequence (), SequenceNumber32 (1600), "bad head after ack");
+  Ptr<Packet> p = buf->CopyFromSequence (536, SequenceNumber32 (1600));
+  NS_TEST_ASSERT_MSG_EQ (CheckPattern (p, 600), true, "bad retransmitted data");
+  NS_TEST_ASSERT_MSG_EQ (buf->GetRetransmitCount (SequenceNumber32 (1600)), 1, "retransmission not counted");
+  NS_TEST_ASSERT_MSG_EQ (buf->GetRetransmitCount (SequenceNumber32 (1000 + 536 * 3)), 0, "bad retransmit count");
+
+  // random access
+  p = buf->CopyFromSequence (10, SequenceNumber32 (1000 + 3000));
+  NS_TEST_ASSERT_MSG_EQ (CheckPattern (p, 3000), true, "bad data");
+
+  // acknowledging everything and the FIN
+  buf->DiscardUpTo (SequenceNumber32 (1000 + total + 1));
+  NS_TEST_ASSERT_MSG_EQ (buf->Size (), 0, "buffer not empty");
+  NS_TEST_ASSERT_MSG_EQ (buf->GetSentSegments (), 0, "scoreboard not empty");
+  NS_TEST_ASSERT_MSG_EQ (buf->HeadSequence (), SequenceNumber32 (1000 + total + 1), "FIN not acknowledged");
+
+  // virtual writes are merged
+  buf = CreateObject<TcpTxBuffer> (0);
+  buf->SetMaxBufferSize (100000);
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      buf->Add (Create<Packet> (1000));
+    }
+  p = buf->CopyFromSequence (1448, SequenceNumber32 (500));
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 1448, "bad segment size");
+  NS_TEST_ASSERT_MSG_EQ (p->IsVirtual (), true, "virtual payload materialized");
+
+  // a zero window probe is left out of the scoreboard
+  uint32_t inFlight = buf->BytesInFlight ();
+  p = buf->CopyProbe (1, SequenceNumber32 (500 + 1448));
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 1, "bad probe size");
+  NS_TEST_ASSERT_MSG_EQ (buf->GetSentSegments (), 1, "probe recorded");
+  NS_TEST_ASSERT_MSG_EQ (buf->BytesInFlight (), inFlight, "probe in flight");
+  buf->CopyFromSequence (1448, SequenceNumber32 (500 + 1448));
+  NS_TEST_ASSERT_MSG_EQ (buf->GetRetransmitCount (SequenceNumber32 (500 + 1448)), 0,
+                         "first transmission after a probe counted as a retransmission");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief Check the SACK scoreboard and the RACK loss detection of TcpTxBuffer
+ */
+class TcpTxBufferSackTestCase : public TestCase
+{
+public:
+  TcpTxBufferSackTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /// Send ten segments
+  void Send (void);
+  /// SACK the last eight segments sent
+  void Sack (void);
+  /// Check the losses detected at the end of the reordering window
+  void CheckLosses (void);
+
+  Ptr<TcpTxBuffer> m_buf; //!< The buffer under test
+};
+
+TcpTxBufferSackTestCase::TcpTxBufferSackTestCase ()
+  : TestCase ("SACK scoreboard and RACK loss detection")
+{
+}
+
+void
+TcpTxBufferSackTestCase::Send (void)
+{
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      m_buf->CopyFromSequence (100, SequenceNumber32 (i * 100));
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_buf->BytesInFlight (), 1000, "bad bytes in flight");
+  NS_TEST_ASSERT_MSG_EQ (m_buf->DetectLosses (MilliSeconds (5)), Seconds (0), "loss without SACK");
+}
+
+void
+TcpTxBufferSackTestCase::Sack (void)
+{
+  // Blocks partially covering a segment do not SACK it
+  TcpOptionSack::SackList list;
+  list.push_back (std::make_pair (SequenceNumber32 (250), SequenceNumber32 (350)));
+  NS_TEST_ASSERT_MSG_EQ (m_buf->Sack (list), 0, "segment partially SACKed");
+  list.clear ();
+  list.push_back (std::make_pair (SequenceNumber32 (200), SequenceNumber32 (1000)));
+  NS_TEST_ASSERT_MSG_EQ (m_buf->Sack (list), 800, "bad bytes SACKed");
+  NS_TEST_ASSERT_MSG_EQ (m_buf->Sack (list), 0, "bytes SACKed twice");
+  NS_TEST_ASSERT_MSG_EQ (m_buf->GetSackedBytes (), 800, "bad scoreboard");
+  NS_TEST_ASSERT_MSG_EQ (m_buf->BytesInFlight (), 200, "bad bytes in flight");
+
+  // Sent along with the segments delivered: wait for the reordering window
+  Time timeout = m_buf->DetectLosses (MilliSeconds (5));
+  NS_TEST_ASSERT_MSG_EQ (timeout, MilliSeconds (5), "bad reordering timeout");
+  NS_TEST_ASSERT_MSG_EQ (m_buf->GetLostBytes (), 0, "loss detected too early");
+}
+
+void
+TcpTxBufferSackTestCase::CheckLosses (void)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_buf->DetectLosses (MilliSeconds (5)), Seconds (0), "bad reordering timeout");
+  NS_TEST_ASSERT_MSG_EQ (m_buf->GetLostBytes (), 200, "losses not detected");
+  NS_TEST_ASSERT_MSG_EQ (m_buf->BytesInFlight (), 0, "bad bytes in flight");
+
+  // The lost segments come in order, and only once
+  SequenceNumber32 seq;
+  uint32_t size;
+  NS_TEST_ASSERT_MSG_EQ (m_buf->NextLostSegment (seq, size), true, "lost segment not found");
+  NS_TEST_ASSERT_MSG_EQ (seq, SequenceNumber32 (0), "bad lost segment");
+  NS_TEST_ASSERT_MSG_EQ (size, 100, "bad lost segment size");
+  m_buf->CopyFromSequence (size, seq);
+  NS_TEST_ASSERT_MSG_EQ (m_buf->NextLostSegment (seq, size), true, "lost segment not found");
+  NS_TEST_ASSERT_MSG_EQ (seq, SequenceNumber32 (100), "bad lost segment");
+  m_buf->CopyFromSequence (size, seq);
+  NS_TEST_ASSERT_MSG_EQ (m_buf->NextLostSegment (seq, size), false, "lost segment sent twice");
+  NS_TEST_ASSERT_MSG_EQ (m_buf->BytesInFlight (), 200, "retransmissions not in flight");
+
+  // The cumulative ACK clears the scoreboard
+  m_buf->DiscardUpTo (SequenceNumber32 (1000));
+  NS_TEST_ASSERT_MSG_EQ (m_buf->GetSackedBytes (), 0, "SACKed bytes left");
+  NS_TEST_ASSERT_MSG_EQ (m_buf->GetLostBytes (), 0, "lost bytes left");
+  NS_TEST_ASSERT_MSG_EQ (m_buf->BytesInFlight (), 0, "bad bytes in flight");
+}
+
+void
+TcpTxBufferSackTestCase::DoRun (void)
+{
+  m_buf = CreateObject<TcpTxBuffer> (0);
+  m_buf->SetMaxBufferSize (100000);
+  m_buf->Add (Create<Packet> (1000));
+
+  // The SACK arrives after an RTT of 10 ms
+  Simulator::Schedule (MilliSeconds (0), &TcpTxBufferSackTestCase::Send, this);
+  Simulator::Schedule (MilliSeconds (10), &TcpTxBufferSackTestCase::Sack, this);
+  Simulator::Schedule (MilliSeconds (15), &TcpTxBufferSackTestCase::CheckLosses, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_buf = 0;
+}
+
+/**
+ * \brief Check the retransmission of a lost block larger than a segment
+ */
+class TcpTxBufferLostBlockTestCase : public TestCase
+{
+public:
+  TcpTxBufferLostBlockTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpTxBufferLostBlockTestCase::TcpTxBufferLostBlockTestCase ()
+  : TestCase ("Retransmission of a lost block larger than a segment")
+{
+}
+
+void
+TcpTxBufferLostBlockTestCase::DoRun (void)
+{
+  Ptr<TcpTxBuffer> buf = CreateObject<TcpTxBuffer> (0);
+  buf->SetMaxBufferSize (100000);
+  buf->Add (Create<Packet> (3000));
+
+  // A block of three segments of 1000 bytes, sent at once and lost
+  buf->CopyFromSequence (3000, SequenceNumber32 (0));
+  buf->MarkAllAsLost ();
+  NS_TEST_ASSERT_MSG_EQ (buf->GetLostBytes (), 3000, "block not lost");
+  NS_TEST_ASSERT_MSG_EQ (buf->BytesInFlight (), 0, "bad bytes in flight");
+
+  // Each retransmission of a segment leaves the rest of the block lost
+  SequenceNumber32 seq;
+  uint32_t size;
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (buf->NextLostSegment (seq, size), true, "lost bytes not found");
+      NS_TEST_ASSERT_MSG_EQ (seq, SequenceNumber32 (i * 1000), "bad lost bytes");
+      NS_TEST_ASSERT_MSG_EQ (size, 3000 - i * 1000, "bad lost bytes size");
+      buf->CopyFromSequence (1000, seq);
+      NS_TEST_ASSERT_MSG_EQ (buf->BytesInFlight (), (i + 1) * 1000, "bad bytes in flight");
+      NS_TEST_ASSERT_MSG_EQ (buf->GetRetransmitCount (seq), 1, "bad retransmit count");
+    }
+  NS_TEST_ASSERT_MSG_EQ (buf->NextLostSegment (seq, size), false, "lost bytes sent twice");
+  NS_TEST_ASSERT_MSG_EQ (buf->GetSentSegments (), 3, "block not split");
+
+  // A retransmission in the middle of a block splits it in three
+  buf->DiscardUpTo (SequenceNumber32 (3000));
+  buf->Add (Create<Packet> (3000));
+  buf->CopyFromSequence (3000, SequenceNumber32 (3000));
+  buf->MarkAllAsLost ();
+  buf->CopyFromSequence (1000, SequenceNumber32 (4000));
+  NS_TEST_ASSERT_MSG_EQ (buf->GetSentSegments (), 3, "block not split");
+  NS_TEST_ASSERT_MSG_EQ (buf->NextLostSegment (seq, size), true, "lost bytes not found");
+  NS_TEST_ASSERT_MSG_EQ (seq, SequenceNumber32 (3000), "bad lost bytes");
+  NS_TEST_ASSERT_MSG_EQ (size, 1000, "bad lost bytes size");
+  buf->CopyFromSequence (size, seq);
+  NS_TEST_ASSERT_MSG_EQ (buf->NextLostSegment (seq, size), true, "lost bytes not found");
+  NS_TEST_ASSERT_MSG_EQ (seq, SequenceNumber32 (5000), "bad lost bytes");
+  NS_TEST_ASSERT_MSG_EQ (size, 1000, "bad lost bytes size");
+  buf->CopyFromSequence (size, seq);
+  NS_TEST_ASSERT_MSG_EQ (buf->NextLostSegment (seq, size), false, "lost bytes sent twice");
+  NS_TEST_ASSERT_MSG_EQ (buf->BytesInFlight (), 3000, "bad bytes in flight");
+
+  // The cumulative ACK clears the scoreboard
+  buf->DiscardUpTo (SequenceNumber32 (6000));
+  NS_TEST_ASSERT_MSG_EQ (buf->GetLostBytes (), 0, "lost bytes left");
+  NS_TEST_ASSERT_MSG_EQ (buf->BytesInFlight (), 0, "bad bytes in flight");
+  NS_TEST_ASSERT_MSG_EQ (buf->GetSentSegments (), 0, "segments left");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief TcpTxBuffer TestSuite
+ */
+class TcpTxBufferTestSuite : public TestSuite
+{
+public:
+  TcpTxBufferTestSuite ()
+    : TestSuite ("tcp-tx-buffer", UNIT)
+  {
+    AddTestCase (new TcpTxBufferTestCase, TestCase::QUICK);
+    AddTestCase (new TcpTxBufferSackTestCase, TestCase::QUICK);
+    AddTestCase (new TcpTxBufferLostBlockTestCase, TestCase::QUICK);
+  }
+};
+
+static TcpTxBufferTestSuite g_tcpTxBufferTestSuite; //!< Static variable for test initialization
+
+} // namespace ns3
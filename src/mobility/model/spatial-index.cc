@@ -0,0 +1,229 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "spatial-index.h"
+#include "mobility-model.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SpatialIndex");
+
+SpatialIndex::SpatialIndex ()
+  : m_cellSize (1000.0),
+    m_nItems (0),
+    m_maxSpeed (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+SpatialIndex::~SpatialIndex ()
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+}
+
+void
+SpatialIndex::SetCellSize (double size)
+{
+  NS_LOG_FUNCTION (this << size);
+  NS_ABORT_MSG_UNLESS (size > 0, "The cell size must be positive");
+  m_cellSize = size;
+  m_cells.clear ();
+  m_maxSpeed = 0;
+  m_lastRefresh = Simulator::Now ();
+  for (uint32_t i = 0; i < m_entries.size (); i++)
+    {
+      Insert (i);
+    }
+}
+
+double
+SpatialIndex::GetCellSize (void) const
+{
+  return m_cellSize;
+}
+
+uint32_t
+SpatialIndex::Add (Ptr<MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  NS_ASSERT (mobility != 0);
+  uint32_t id = m_nItems++;
+  std::map<const MobilityModel *, uint32_t>::const_iterator it = m_entryOf.find (PeekPointer (mobility));
+  if (it != m_entryOf.end ())
+    {
+      m_entries[it->second].items.push_back (id);
+      return id;
+    }
+
+  uint32_t index = m_entries.size ();
+  Entry entry;
+  entry.mobility = mobility;
+  entry.items.push_back (id);
+  m_entries.push_back (entry);
+  m_entryOf[PeekPointer (mobility)] = index;
+  Insert (index);
+  mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&SpatialIndex::CourseChanged, this));
+  return id;
+}
+
+uint32_t
+SpatialIndex::GetN (void) const
+{
+  return m_nItems;
+}
+
+void
+SpatialIndex::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<Entry>::iterator it = m_entries.begin (); it != m_entries.end (); ++it)
+    {
+      it->mobility->TraceDisconnectWithoutContext ("CourseChange", MakeCallback (&SpatialIndex::CourseChanged, this));
+    }
+  m_entries.clear ();
+  m_entryOf.clear ();
+  m_cells.clear ();
+  m_nItems = 0;
+  m_maxSpeed = 0;
+}
+
+void
+SpatialIndex::GetCandidates (const Vector &position, double range, std::vector<uint32_t> &ids)
+{
+  NS_LOG_FUNCTION (this << position << range);
+  ids.clear ();
+  double slack = m_maxSpeed * (Simulator::Now () - m_lastRefresh).GetSeconds ();
+  if (slack > m_cellSize / 2)
+    {
+      Refresh ();
+      slack = 0;
+    }
+  double r = range + slack;
+  int64_t x0 = static_cast<int64_t> (std::floor ((position.x - r) / m_cellSize));
+  int64_t x1 = static_cast<int64_t> (std::floor ((position.x + r) / m_cellSize));
+  int64_t y0 = static_cast<int64_t> (std::floor ((position.y - r) / m_cellSize));
+  int64_t y1 = static_cast<int64_t> (std::floor ((position.y + r) / m_cellSize));
+
+  if (static_cast<double> (x1 - x0 + 1) * (y1 - y0 + 1) > m_cells.size ())
+    {
+      // the query covers more cells than are occupied
+      for (CellMap::const_iterator it = m_cells.begin (); it != m_cells.end (); ++it)
+        {
+          int64_t ix = static_cast<int32_t> (it->first >> 32);
+          int64_t iy = static_cast<int32_t> (it->first & 0xffffffff);
+          if (ix < x0 || ix > x1 || iy < y0 || iy > y1)
+            {
+              continue;
+            }
+          for (std::vector<uint32_t>::const_iterator e = it->second.begin (); e != it->second.end (); ++e)
+            {
+              ids.insert (ids.end (), m_entries[*e].items.begin (), m_entries[*e].items.end ());
+            }
+        }
+    }
+  else
+    {
+      for (int64_t ix = x0; ix <= x1; ix++)
+        {
+          for (int64_t iy = y0; iy <= y1; iy++)
+            {
+              CellMap::const_iterator it = m_cells.find (GetKey (ix, iy));
+              if (it == m_cells.end ())
+                {
+                  continue;
+                }
+              for (std::vector<uint32_t>::const_iterator e = it->second.begin (); e != it->second.end (); ++e)
+                {
+                  ids.insert (ids.end (), m_entries[*e].items.begin (), m_entries[*e].items.end ());
+                }
+            }
+        }
+    }
+  std::sort (ids.begin (), ids.end ());
+}
+
+uint64_t
+SpatialIndex::GetCell (double x, double y) const
+{
+  return GetKey (static_cast<int64_t> (std::floor (x / m_cellSize)),
+                 static_cast<int64_t> (std::floor (y / m_cellSize)));
+}
+
+uint64_t
+SpatialIndex::GetKey (int64_t ix, int64_t iy)
+{
+  return (static_cast<uint64_t> (static_cast<uint32_t> (ix)) << 32) | static_cast<uint32_t> (iy);
+}
+
+void
+SpatialIndex::Insert (uint32_t index)
+{
+  Entry &entry = m_entries[index];
+  Vector position = entry.mobility->GetPosition ();
+  Vector velocity = entry.mobility->GetVelocity ();
+  entry.speed = std::sqrt (velocity.x * velocity.x + velocity.y * velocity.y);
+  m_maxSpeed = std::max (m_maxSpeed, entry.speed);
+  entry.cell = GetCell (position.x, position.y);
+  m_cells[entry.cell].push_back (index);
+}
+
+void
+SpatialIndex::Place (uint32_t index)
+{
+  Entry &entry = m_entries[index];
+  std::vector<uint32_t> &from = m_cells[entry.cell];
+  std::vector<uint32_t>::iterator it = std::find (from.begin (), from.end (), index);
+  NS_ASSERT (it != from.end ());
+  *it = from.back ();
+  from.pop_back ();
+  if (from.empty ())
+    {
+      m_cells.erase (entry.cell);
+    }
+  Insert (index);
+}
+
+void
+SpatialIndex::Refresh (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_maxSpeed = 0;
+  m_lastRefresh = Simulator::Now ();
+  for (uint32_t i = 0; i < m_entries.size (); i++)
+    {
+      if (m_entries[i].speed > 0)
+        {
+          Place (i);
+        }
+    }
+}
+
+void
+SpatialIndex::CourseChanged (Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  std::map<const MobilityModel *, uint32_t>::const_iterator it = m_entryOf.find (PeekPointer (mobility));
+  NS_ASSERT (it != m_entryOf.end ());
+  Place (it->second);
+}
+
+} // namespace ns3
@@ -0,0 +1,152 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include "ns3/ptr.h"
+#include "ns3/vector.h"
+#include "ns3/nstime.h"
+#include <map>
+#include <vector>
+#include <stdint.h>
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \ingroup mobility
+ *
+ * \brief A uniform grid over the x-y positions of a set of MobilityModels.
+ *
+ * Channels use this to find the receivers that may be within range of
+ * a transmitter without visiting every receiver. Each item added gets
+ * the next id (0, 1, 2, ...), so a channel can use its PHY list index.
+ * Several items may share a MobilityModel.
+ *
+ * The index follows the "CourseChange" trace of every MobilityModel,
+ * so a change of position or velocity moves only the affected entry.
+ * Models that move between course changes (e.g.
+ * ConstantVelocityMobilityModel) are covered by widening each query by
+ * the largest distance any of them can have travelled since it was
+ * last placed. Once that slack exceeds half a cell, the moving entries
+ * are re-placed at their current position. This relies on the velocity
+ * staying constant between course changes, which holds for all the
+ * ns-3 models except ConstantAccelerationMobilityModel.
+ *
+ * GetCandidates returns a superset of the items within range: every
+ * item in a cell that the query touches. The caller makes the exact
+ * distance check.
+ */
+class SpatialIndex
+{
+public:
+  SpatialIndex ();
+  ~SpatialIndex ();
+
+  /**
+   * Set the side of the square grid cells, in meters. This re-places
+   * every entry. A cell size close to the query range works best.
+   * \param size the cell size, which must be positive
+   */
+  void SetCellSize (double size);
+  /**
+   * \return the side of the grid cells, in meters
+   */
+  double GetCellSize (void) const;
+
+  /**
+   * Add an item located by the given MobilityModel.
+   * \param mobility the mobility model of the item
+   * \return the id of the item, i.e., the number of items added before it
+   */
+  uint32_t Add (Ptr<MobilityModel> mobility);
+  /**
+   * \return the number of items added since the last Clear
+   */
+  uint32_t GetN (void) const;
+  /**
+   * Remove every item and disconnect from their mobility models.
+   */
+  void Clear (void);
+
+  /**
+   * Get the ids of the items that may be within range of a position.
+   * \param position the center of the query
+   * \param range the distance from the center, in meters
+   * \param ids the ids of the candidates, in increasing order
+   */
+  void GetCandidates (const Vector &position, double range, std::vector<uint32_t> &ids);
+
+private:
+  /**
+   * A MobilityModel tracked by the index and the items it locates.
+   */
+  struct Entry
+  {
+    Ptr<MobilityModel> mobility;   //!< the mobility model
+    std::vector<uint32_t> items;   //!< the items located by this model
+    uint64_t cell;                 //!< key of the cell the entry is in
+    double speed;                  //!< speed when last placed, in m/s
+  };
+
+  /**
+   * \param x the x coordinate
+   * \param y the y coordinate
+   * \return the key of the cell containing (x, y)
+   */
+  uint64_t GetCell (double x, double y) const;
+  /**
+   * \param ix the cell column
+   * \param iy the cell row
+   * \return the key of the cell
+   */
+  static uint64_t GetKey (int64_t ix, int64_t iy);
+  /**
+   * Read the position and velocity of an entry and add it to its cell.
+   * \param index the entry index
+   */
+  void Insert (uint32_t index);
+  /**
+   * Take an entry out of its cell and insert it again.
+   * \param index the entry index
+   */
+  void Place (uint32_t index);
+  /**
+   * Re-place every moving entry and reset the drift allowance.
+   */
+  void Refresh (void);
+  /**
+   * Update the entry of a mobility model whose course changed.
+   * \param mobility the mobility model
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility);
+
+  /// Cells, keyed by GetKey, holding entry indices
+  typedef std::map<uint64_t, std::vector<uint32_t> > CellMap;
+
+  double m_cellSize;                                //!< side of the cells, in meters
+  std::vector<Entry> m_entries;                     //!< the tracked mobility models
+  std::map<const MobilityModel *, uint32_t> m_entryOf; //!< entry index of each mobility model
+  CellMap m_cells;                                  //!< the grid
+  uint32_t m_nItems;                                //!< number of items added
+  double m_maxSpeed;                                //!< largest speed among the entries, in m/s
+  Time m_lastRefresh;                               //!< when the moving entries were last re-placed
+};
+
+} // namespace ns3
+
+#endif /* SPATIAL_INDEX_H */
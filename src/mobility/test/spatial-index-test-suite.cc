@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/spatial-index.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include <algorithm>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Check that the candidates returned by a SpatialIndex are sorted and
+ * include every item within range.
+ */
+class SpatialIndexTestCase : public TestCase
+{
+public:
+  SpatialIndexTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Query the index and compare with a scan of every item.
+   * \param position the center of the query
+   * \param range the range of the query
+   */
+  void Check (Vector position, double range);
+
+  SpatialIndex m_index;                         //!< the index under test
+  std::vector<Ptr<MobilityModel> > m_items;     //!< mobility model of each item
+};
+
+SpatialIndexTestCase::SpatialIndexTestCase ()
+  : TestCase ("Check SpatialIndex queries against a linear scan")
+{
+}
+
+void
+SpatialIndexTestCase::Check (Vector position, double range)
+{
+  std::vector<uint32_t> ids;
+  m_index.GetCandidates (position, range, ids);
+  NS_TEST_ASSERT_MSG_EQ (std::is_sorted (ids.begin (), ids.end ()), true, "candidates not sorted");
+  for (uint32_t i = 0; i < m_items.size (); i++)
+    {
+      if (CalculateDistance (position, m_items[i]->GetPosition ()) <= range)
+        {
+          NS_TEST_ASSERT_MSG_EQ (std::binary_search (ids.begin (), ids.end (), i), true,
+                                 "item " << i << " in range at " << Simulator::Now ().GetSeconds () << "s is missing");
+        }
+    }
+  NS_TEST_ASSERT_MSG_LT (ids.size (), m_items.size (), "the index did not prune anything");
+}
+
+void
+SpatialIndexTestCase::DoRun (void)
+{
+  m_index.SetCellSize (100);
+
+  // 400 static items on a 2 km square, the last one sharing the model
+  // of the first
+  uint32_t seed = 12345;
+  for (uint32_t i = 0; i < 400; i++)
+    {
+      seed = seed * 1103515245 + 12345;
+      double x = (seed >> 8) % 2000 - 1000.0;
+      seed = seed * 1103515245 + 12345;
+      double y = (seed >> 8) % 2000 - 1000.0;
+      Ptr<ConstantPositionMobilityModel> m = CreateObject<ConstantPositionMobilityModel> ();
+      m->SetPosition (Vector (x, y, 0));
+      m_items.push_back (m);
+      NS_TEST_ASSERT_MSG_EQ (m_index.Add (m), i, "wrong id");
+    }
+  m_items.push_back (m_items[0]);
+  m_index.Add (m_items[0]);
+
+  // 20 items crossing the square at up to 30 m/s
+  for (uint32_t i = 0; i < 20; i++)
+    {
+      Ptr<ConstantVelocityMobilityModel> m = CreateObject<ConstantVelocityMobilityModel> ();
+      m->SetPosition (Vector (-1000.0 + i * 100, -1000.0, 0));
+      m->SetVelocity (Vector (i + 10.0, (i % 3) * 5.0, 0));
+      m_items.push_back (m);
+      m_index.Add (m);
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_index.GetN (), m_items.size (), "wrong number of items");
+
+  Check (Vector (0, 0, 0), 150);
+  Check (Vector (-1000, -1000, 0), 250);
+  Check (Vector (333, -777, 0), 99.5);
+
+  // move a static item through its CourseChange trace
+  DynamicCast<ConstantPositionMobilityModel> (m_items[7])->SetPosition (Vector (5000, 5000, 0));
+  std::vector<uint32_t> ids;
+  m_index.GetCandidates (Vector (5001, 5001, 0), 10, ids);
+  NS_TEST_ASSERT_MSG_EQ (ids.size (), 1, "moved item not found");
+  NS_TEST_ASSERT_MSG_EQ (ids[0], 7, "wrong item found");
+
+  // let the moving items drift, with a change of course halfway
+  for (uint32_t t = 1; t <= 60; t++)
+    {
+      Simulator::Schedule (Seconds (t), &SpatialIndexTestCase::Check, this, Vector (0, 0, 0), 200);
+      Simulator::Schedule (Seconds (t), &SpatialIndexTestCase::Check, this, Vector (-500, -200, 0), 120);
+      Simulator::Schedule (Seconds (t), &SpatialIndexTestCase::Check, this, Vector (0, -1000, 0), 200);
+      Simulator::Schedule (Seconds (t), &SpatialIndexTestCase::Check, this, Vector (500, -900, 0), 100);
+    }
+  Simulator::Schedule (Seconds (30.5), &ConstantVelocityMobilityModel::SetVelocity,
+                       DynamicCast<ConstantVelocityMobilityModel> (m_items.back ()), Vector (-20, 20, 0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  m_index.Clear ();
+  NS_TEST_ASSERT_MSG_EQ (m_index.GetN (), 0, "items left after Clear");
+}
+
+/**
+ * SpatialIndex test suite.
+ */
+class SpatialIndexTestSuite : public TestSuite
+{
+public:
+  SpatialIndexTestSuite ();
+};
+
+SpatialIndexTestSuite::SpatialIndexTestSuite ()
+  : TestSuite ("spatial-index", UNIT)
+{
+  AddTestCase (new SpatialIndexTestCase, TestCase::QUICK);
+}
+
+static SpatialIndexTestSuite g_spatialIndexTestSuite; //!< Static variable for test initialization
@@ -497,6 +497,14 @@ DistributedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &del
 {
   NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << m_currentTs << event);
 
+  ScheduleInContext (context, delay, event);
+}
+
+EventId
+DistributedSimulatorImpl::ScheduleInContext (uint32_t context, Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << m_currentTs << event);
+
   Scheduler::Event ev;
   ev.impl = event;
   ev.key.m_ts = m_currentTs + delay.GetTimeStep ();
@@ -505,6 +513,7 @@ DistributedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &del
   m_uid++;
   m_unscheduledEvents++;
   m_events->Insert (ev);
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
 }
 
 EventId
@@ -70,6 +70,12 @@ public:
    * \return true if parallel communication is enabled
    */
   static bool IsEnabled ();
+  /**
+   * \return true if the parallel tasks are threads of this process
+   *
+   * When running a sequential simulation this will return false.
+   */
+  static bool IsSharedMemory ();
   /**
    * \param pargc number of command line arguments
    * \param pargv command line arguments
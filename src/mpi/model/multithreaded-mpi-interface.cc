@@ -0,0 +1,89 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-mpi-interface.h"
+#include "multithreaded-simulator-impl.h"
+
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MultithreadedMpiInterface");
+
+MultithreadedMpiInterface::MultithreadedMpiInterface ()
+  : m_enabled (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MultithreadedMpiInterface::~MultithreadedMpiInterface ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MultithreadedMpiInterface::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint32_t
+MultithreadedMpiInterface::GetSystemId ()
+{
+  return Simulator::GetSystemId ();
+}
+
+uint32_t
+MultithreadedMpiInterface::GetSize ()
+{
+  return MultithreadedSimulatorImpl::GetSize ();
+}
+
+bool
+MultithreadedMpiInterface::IsEnabled ()
+{
+  return m_enabled;
+}
+
+bool
+MultithreadedMpiInterface::IsSharedMemory ()
+{
+  return true;
+}
+
+void
+MultithreadedMpiInterface::Enable (int* pargc, char*** pargv)
+{
+  NS_LOG_FUNCTION (this);
+  m_enabled = true;
+}
+
+void
+MultithreadedMpiInterface::Disable ()
+{
+  NS_LOG_FUNCTION (this);
+  m_enabled = false;
+}
+
+void
+MultithreadedMpiInterface::SendPacket (Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev)
+{
+  NS_LOG_FUNCTION (this << p << rxTime.GetTimeStep () << node << dev);
+  MultithreadedSimulatorImpl::SendPacket (p, rxTime, node, dev);
+}
+
+} // namespace ns3
@@ -0,0 +1,66 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_MULTITHREADED_MPI_INTERFACE_H
+#define NS3_MULTITHREADED_MPI_INTERFACE_H
+
+#include "parallel-communication-interface.h"
+
+#include <ns3/nstime.h>
+#include <ns3/packet.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Interface between ns-3 and the threads of the
+ * MultithreadedSimulatorImpl.
+ *
+ * All the partitions live in the same process, so this interface
+ * does not require MPI: Enable ignores the command line arguments
+ * and packets are handed over to the simulator, which delivers them
+ * through shared memory.
+ */
+class MultithreadedMpiInterface : public ParallelCommunicationInterface
+{
+public:
+  MultithreadedMpiInterface ();
+  virtual ~MultithreadedMpiInterface ();
+
+  // virtual from ParallelCommunicationInterface
+  virtual void Destroy ();
+  /**
+   * \return the partition of the calling thread
+   */
+  virtual uint32_t GetSystemId ();
+  /**
+   * \return the number of partitions
+   */
+  virtual uint32_t GetSize ();
+  virtual bool IsEnabled ();
+  virtual bool IsSharedMemory ();
+  virtual void Enable (int* pargc, char*** pargv);
+  virtual void Disable ();
+  virtual void SendPacket (Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev);
+
+private:
+  bool m_enabled;  //!< Has Enable been called.
+};
+
+} // namespace ns3
+
+#endif /* NS3_MULTITHREADED_MPI_INTERFACE_H */
@@ -0,0 +1,942 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+#include "mpi-interface.h"
+#include "mpi-receiver.h"
+
+#include "ns3/simulator.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/make-event.h"
+#include "ns3/channel.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/uinteger.h"
+#include "ns3/ptr.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl);
+
+namespace {
+
+/** The partition run by the current thread. */
+thread_local uint32_t g_partition = 0;
+
+/** Largest representable timestamp, used as infinity. */
+const uint64_t MAX_TS = 0x7fffffffffffffffULL;
+
+} // unnamed namespace
+
+/**
+ * \brief Lock-free single-producer single-consumer queue of serialized
+ * packets.
+ *
+ * The producer is the thread of the source partition, the consumer the
+ * thread of the destination partition. When the ring is full, messages
+ * are appended to an overflow list owned by the producer, which the
+ * consumer only reads while the producer waits at the barrier.
+ */
+class MultithreadedSimulatorImpl::Ring
+{
+public:
+  /** A serialized packet. */
+  struct Message
+  {
+    uint64_t ts;     //!< Receive timestamp.
+    uint32_t node;   //!< Destination node.
+    uint32_t dev;    //!< Destination device.
+    uint8_t *data;   //!< Serialized packet.
+    uint32_t size;   //!< Size of the serialized packet.
+  };
+
+  /**
+   * Constructor.
+   * \param size The capacity, rounded up to a power of two.
+   */
+  Ring (uint32_t size)
+    : m_head (0),
+      m_tail (0),
+      m_overflowHead (0)
+  {
+    uint32_t capacity = 1;
+    while (capacity < size)
+      {
+        capacity <<= 1;
+      }
+    m_slots.resize (capacity);
+    m_mask = capacity - 1;
+  }
+  /** Destructor. */
+  ~Ring ()
+  {
+    Message m;
+    while (Pop (m))
+      {
+        delete [] m.data;
+      }
+  }
+  /**
+   * Append a message. Only called by the producer.
+   * \param m The message.
+   */
+  void Push (const Message &m)
+  {
+    uint32_t tail = m_tail.load (std::memory_order_relaxed);
+    if (!m_overflow.empty ()
+        || tail - m_head.load (std::memory_order_acquire) > m_mask)
+      {
+        m_overflow.push_back (m);
+        return;
+      }
+    m_slots[tail & m_mask] = m;
+    m_tail.store (tail + 1, std::memory_order_release);
+  }
+  /**
+   * Remove the oldest message. Only called by the consumer.
+   * \param [out] m The message.
+   * \return \c true if a message was available.
+   */
+  bool Pop (Message &m)
+  {
+    uint32_t head = m_head.load (std::memory_order_relaxed);
+    if (head != m_tail.load (std::memory_order_acquire))
+      {
+        m = m_slots[head & m_mask];
+        m_head.store (head + 1, std::memory_order_release);
+        return true;
+      }
+    if (m_overflowHead < m_overflow.size ())
+      {
+        m = m_overflow[m_overflowHead++];
+        if (m_overflowHead == m_overflow.size ())
+          {
+            m_overflow.clear ();
+            m_overflowHead = 0;
+          }
+        return true;
+      }
+    return false;
+  }
+
+private:
+  std::vector<Message> m_slots;     //!< The ring storage.
+  uint32_t m_mask;                  //!< Capacity - 1.
+  std::atomic<uint32_t> m_head;     //!< Next slot to read, written by the consumer.
+  std::atomic<uint32_t> m_tail;     //!< Next slot to write, written by the producer.
+  std::vector<Message> m_overflow;  //!< Messages which did not fit in the ring.
+  std::size_t m_overflowHead;       //!< Next overflow message to read.
+};
+
+void
+MultithreadedSimulatorImpl::Barrier::Reset (uint32_t n)
+{
+  m_n = n;
+  m_count.store (0);
+  m_generation.store (0);
+}
+
+void
+MultithreadedSimulatorImpl::Barrier::Wait (void)
+{
+  uint32_t generation = m_generation.load (std::memory_order_acquire);
+  if (m_count.fetch_add (1, std::memory_order_acq_rel) + 1 == m_n)
+    {
+      m_count.store (0, std::memory_order_relaxed);
+      m_generation.fetch_add (1, std::memory_order_release);
+      return;
+    }
+  while (m_generation.load (std::memory_order_acquire) == generation)
+    {
+      std::this_thread::yield ();
+    }
+}
+
+MultithreadedSimulatorImpl *MultithreadedSimulatorImpl::g_instance = 0;
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Mpi")
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+    .AddAttribute ("Partitions",
+                   "Minimum number of partitions, and thus of threads. More "
+                   "partitions are created if a node has a larger SystemId.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&MultithreadedSimulatorImpl::m_nPartitions),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("RingSize",
+                   "Number of messages each inter-partition ring can hold "
+                   "before spilling over to a slower list.",
+                   UintegerValue (4096),
+                   MakeUintegerAccessor (&MultithreadedSimulatorImpl::m_ringSize),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+  : m_stopTs (MAX_TS),
+    m_lookAhead (MAX_TS),
+    m_maxLookAhead (MAX_TS),
+    m_nPartitions (1),
+    m_ringSize (4096),
+    m_running (false)
+{
+  NS_LOG_FUNCTION (this);
+
+  Partition *part = new Partition;
+  part->events = 0;
+  // uids are allocated from 4.
+  // uid 0 is "invalid" events
+  // uid 1 is "now" events
+  // uid 2 is "destroy" events
+  part->uid = 4;
+  // before ::Run is entered, the m_currentUid will be zero
+  part->currentUid = 0;
+  part->currentTs = 0;
+  part->currentContext = Simulator::NO_CONTEXT;
+  part->unscheduledEvents = 0;
+  part->nextTs = MAX_TS;
+  part->stopTs = MAX_TS;
+  m_partitions.push_back (part);
+  g_instance = this;
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<Ring *>::iterator i = m_rings.begin (); i != m_rings.end (); ++i)
+    {
+      delete *i;
+    }
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      delete *i;
+    }
+  if (g_instance == this)
+    {
+      g_instance = 0;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      Ptr<Scheduler> events = (*i)->events;
+      while (events != 0 && !events->IsEmpty ())
+        {
+          Scheduler::Event next = events->RemoveNext ();
+          next.impl->Unref ();
+        }
+      (*i)->events = 0;
+    }
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+
+  while (true)
+    {
+      Ptr<EventImpl> ev;
+      {
+        std::lock_guard<std::mutex> lock (m_destroyMutex);
+        if (m_destroyEvents.empty ())
+          {
+            break;
+          }
+        ev = m_destroyEvents.front ().PeekEventImpl ();
+        m_destroyEvents.pop_front ();
+      }
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+
+  if (MpiInterface::IsEnabled ())
+    {
+      MpiInterface::Destroy ();
+    }
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetSize (void)
+{
+  if (g_instance == 0)
+    {
+      // create the simulator if it was selected but not yet used.
+      Simulator::GetImplementation ();
+    }
+  if (g_instance == 0)
+    {
+      return 1;
+    }
+  uint32_t n = g_instance->m_nPartitions;
+  for (uint32_t i = 0; i < NodeList::GetNNodes (); ++i)
+    {
+      n = std::max (n, NodeList::GetNode (i)->GetSystemId () + 1);
+    }
+  return n;
+}
+
+MultithreadedSimulatorImpl::Partition &
+MultithreadedSimulatorImpl::GetPartition (void) const
+{
+  NS_ASSERT (g_partition < m_partitions.size ());
+  return *m_partitions[g_partition];
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartitionOf (uint32_t context) const
+{
+  if (context < m_systemIds.size ())
+    {
+      return m_systemIds[context];
+    }
+  return g_partition;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::Insert (Partition &part, uint64_t ts, uint32_t context, EventImpl *event)
+{
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = ts;
+  ev.key.m_context = context;
+  ev.key.m_uid = part.uid;
+  // each partition allocates its own uids out of the sequence, so that
+  // the uids stay unique when the events move between the partitions.
+  part.uid += m_partitions.size ();
+  part.unscheduledEvents++;
+  part.events->Insert (ev);
+  return ev.key.m_uid;
+}
+
+void
+MultithreadedSimulatorImpl::Dispatch (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  uint32_t n = m_nPartitions;
+  uint32_t nNodes = NodeList::GetNNodes ();
+  m_systemIds.resize (nNodes);
+  m_receivers.resize (nNodes);
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      Ptr<Node> node = NodeList::GetNode (i);
+      m_systemIds[i] = node->GetSystemId ();
+      n = std::max (n, m_systemIds[i] + 1);
+      m_receivers[i].resize (node->GetNDevices ());
+      for (uint32_t j = 0; j < node->GetNDevices (); ++j)
+        {
+          // the receivers outlive the simulation, no need to hold a reference.
+          m_receivers[i][j] = PeekPointer (node->GetDevice (j)->GetObject<MpiReceiver> ());
+        }
+    }
+
+  Partition &first = *m_partitions[0];
+  while (m_partitions.size () < n)
+    {
+      Partition *part = new Partition (first);
+      part->events = m_schedulerFactory.Create<Scheduler> ();
+      part->unscheduledEvents = 0;
+      m_partitions.push_back (part);
+    }
+
+  // move the events whose node belongs to another partition: all of
+  // them before the first run, only the ones of the nodes whose
+  // SystemId changed since, before the next runs.
+  uint32_t uid = first.uid;
+  for (uint32_t p = 0; p < m_partitions.size (); ++p)
+    {
+      uid = std::max (uid, m_partitions[p]->uid);
+    }
+  for (uint32_t p = 0; p < m_partitions.size (); ++p)
+    {
+      Partition &part = *m_partitions[p];
+      std::vector<Scheduler::Event> events;
+      while (!part.events->IsEmpty ())
+        {
+          events.push_back (part.events->RemoveNext ());
+        }
+      for (std::vector<Scheduler::Event>::const_iterator i = events.begin (); i != events.end (); ++i)
+        {
+          uint32_t context = i->key.m_context;
+          uint32_t target = context < nNodes ? m_systemIds[context] : p;
+          if (target == p)
+            {
+              part.events->Insert (*i);
+              continue;
+            }
+          // the event keeps its uid, which the EventIds held by the
+          // callers refer to.
+          m_partitions[target]->events->Insert (*i);
+          part.unscheduledEvents--;
+          m_partitions[target]->unscheduledEvents++;
+        }
+    }
+  for (uint32_t p = 1; p < m_partitions.size (); ++p)
+    {
+      Partition &part = *m_partitions[p];
+      part.currentUid = first.currentUid;
+      part.currentTs = first.currentTs;
+      part.currentContext = Simulator::NO_CONTEXT;
+    }
+  for (uint32_t p = 0; p < m_partitions.size (); ++p)
+    {
+      m_partitions[p]->uid = uid + p;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::CalculateLookAhead (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_lookAhead = MAX_TS;
+  if (m_partitions.size () > 1)
+    {
+      for (uint32_t i = 0; i < NodeList::GetNNodes (); ++i)
+        {
+          Ptr<Node> node = NodeList::GetNode (i);
+          for (uint32_t j = 0; j < node->GetNDevices (); ++j)
+            {
+              Ptr<NetDevice> localNetDevice = node->GetDevice (j);
+              // only works for p2p links currently
+              if (!localNetDevice->IsPointToPoint ())
+                {
+                  continue;
+                }
+              Ptr<Channel> channel = localNetDevice->GetChannel ();
+              if (channel == 0 || channel->GetNDevices () != 2)
+                {
+                  continue;
+                }
+
+              // grab the adjacent node
+              Ptr<Node> remoteNode;
+              if (channel->GetDevice (0) == localNetDevice)
+                {
+                  remoteNode = (channel->GetDevice (1))->GetNode ();
+                }
+              else
+                {
+                  remoteNode = (channel->GetDevice (0))->GetNode ();
+                }
+
+              // if it's not remote, don't consider it
+              if (remoteNode->GetSystemId () == node->GetSystemId ())
+                {
+                  continue;
+                }
+
+              TimeValue delay;
+              if (channel->GetAttributeFailSafe ("Delay", delay))
+                {
+                  uint64_t ts = delay.Get ().GetTimeStep ();
+                  m_lookAhead = std::min (m_lookAhead, ts);
+                }
+            }
+        }
+    }
+  m_lookAhead = std::min (m_lookAhead, m_maxLookAhead);
+  if (m_lookAhead == 0)
+    {
+      NS_FATAL_ERROR ("Partitions are connected by a zero-delay link, can't run in parallel");
+    }
+  NS_LOG_LOGIC ("lookahead " << m_lookAhead << " partitions " << m_partitions.size ());
+}
+
+void
+MultithreadedSimulatorImpl::SetMaximumLookAhead (const Time lookAhead)
+{
+  if (lookAhead > 0)
+    {
+      NS_LOG_FUNCTION (this << lookAhead);
+      m_maxLookAhead = lookAhead.GetTimeStep ();
+    }
+  else
+    {
+      NS_LOG_WARN ("attempted to set look ahead negative: " << lookAhead);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+
+  m_schedulerFactory = schedulerFactory;
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+      Ptr<Scheduler> events = (*i)->events;
+      if (events != 0)
+        {
+          while (!events->IsEmpty ())
+            {
+              Scheduler::Event next = events->RemoveNext ();
+              scheduler->Insert (next);
+            }
+        }
+      (*i)->events = scheduler;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::ProcessOneEvent (Partition &part)
+{
+  Scheduler::Event next = part.events->RemoveNext ();
+
+  NS_ASSERT (next.key.m_ts >= part.currentTs);
+  part.unscheduledEvents--;
+
+  NS_LOG_LOGIC ("handle " << next.key.m_ts);
+  part.currentTs = next.key.m_ts;
+  part.currentContext = next.key.m_context;
+  part.currentUid = next.key.m_uid;
+  next.impl->Invoke ();
+  next.impl->Unref ();
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      if (!(*i)->events->IsEmpty ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+MultithreadedSimulatorImpl::ReceiveMessages (uint32_t p)
+{
+  Partition &part = *m_partitions[p];
+  uint32_t n = m_partitions.size ();
+  for (uint32_t src = 0; src < n; ++src)
+    {
+      Ring::Message m;
+      Ring *ring = m_rings[src * n + p];
+      while (ring->Pop (m))
+        {
+          NS_ASSERT (m.ts >= part.currentTs);
+          Ptr<Packet> packet = Create<Packet> (m.data, m.size, true);
+          delete [] m.data;
+          MpiReceiver *receiver = m_receivers[m.node][m.dev];
+          NS_ASSERT (receiver != 0);
+          Insert (part, m.ts, m.node, MakeEvent (&MpiReceiver::Receive, receiver, packet));
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::RunPartition (uint32_t p)
+{
+  NS_LOG_FUNCTION (this << p);
+
+  g_partition = p;
+  Partition &part = *m_partitions[p];
+  uint32_t n = m_partitions.size ();
+  while (true)
+    {
+      // no event is being executed between the two barriers: collect
+      // the messages of the previous window and agree on the next one.
+      m_barrier.Wait ();
+      ReceiveMessages (p);
+      part.nextTs = part.events->IsEmpty () ? MAX_TS : part.events->PeekNext ().key.m_ts;
+      part.stopTs = m_stopTs.load ();
+      m_barrier.Wait ();
+
+      uint64_t lbts = MAX_TS;
+      for (uint32_t i = 0; i < n; ++i)
+        {
+          lbts = std::min (lbts, m_partitions[i]->nextTs);
+        }
+      if (lbts == MAX_TS || lbts >= part.stopTs)
+        {
+          break;
+        }
+      // no message sent from now on can arrive before the end of the window.
+      uint64_t granted = m_lookAhead >= MAX_TS - lbts ? MAX_TS : lbts + m_lookAhead;
+      while (!part.events->IsEmpty ())
+        {
+          uint64_t ts = part.events->PeekNext ().key.m_ts;
+          // Stop() only updates part.stopTs of the partition calling it,
+          // the others see it at the next window.
+          if (ts >= granted || ts >= part.stopTs)
+            {
+              break;
+            }
+          ProcessOneEvent (part);
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (g_partition == 0, "Simulator::Run must be called from the main thread");
+
+  Dispatch ();
+  CalculateLookAhead ();
+
+  uint32_t n = m_partitions.size ();
+  if (m_rings.size () != n * n)
+    {
+      for (std::vector<Ring *>::iterator i = m_rings.begin (); i != m_rings.end (); ++i)
+        {
+          delete *i;
+        }
+      m_rings.clear ();
+      for (uint32_t i = 0; i < n * n; ++i)
+        {
+          m_rings.push_back (new Ring (m_ringSize));
+        }
+    }
+  m_barrier.Reset (n);
+
+  m_running = true;
+  std::vector<std::thread> threads;
+  for (uint32_t p = 1; p < n; ++p)
+    {
+      threads.push_back (std::thread (&MultithreadedSimulatorImpl::RunPartition, this, p));
+    }
+  RunPartition (0);
+  for (std::vector<std::thread>::iterator i = threads.begin (); i != threads.end (); ++i)
+    {
+      i->join ();
+    }
+  m_running = false;
+
+  // the remaining events stay in their partition. The first partition
+  // gets the simulation time, for use by the main thread until the next run.
+  Partition &first = *m_partitions[0];
+  uint64_t stopTs = m_stopTs.load ();
+  bool empty = first.events->IsEmpty ();
+  int unscheduledEvents = first.unscheduledEvents;
+  for (uint32_t p = 1; p < n; ++p)
+    {
+      Partition &part = *m_partitions[p];
+      empty = empty && part.events->IsEmpty ();
+      unscheduledEvents += part.unscheduledEvents;
+      first.uid = std::max (first.uid, part.uid);
+      if (part.currentTs > first.currentTs)
+        {
+          first.currentTs = part.currentTs;
+          first.currentUid = part.currentUid;
+        }
+    }
+  if (stopTs != MAX_TS && stopTs > first.currentTs)
+    {
+      // the events at the stop time were not executed.
+      first.currentTs = stopTs;
+      first.currentUid = 0;
+    }
+  // the events scheduled by the main thread are not bound to a node.
+  first.currentContext = Simulator::NO_CONTEXT;
+  first.stopTs = MAX_TS;
+  m_stopTs.store (MAX_TS);
+
+  // If the simulator stopped naturally by lack of events, make a
+  // consistency test to check that we didn't lose any events along the way.
+  NS_ASSERT (!empty || unscheduledEvents == 0);
+  NS_UNUSED (unscheduledEvents);
+}
+
+void
+MultithreadedSimulatorImpl::SendPacket (Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev)
+{
+  NS_ASSERT (g_instance != 0);
+  g_instance->DoSendPacket (p, rxTime, node, dev);
+}
+
+void
+MultithreadedSimulatorImpl::DoSendPacket (Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev)
+{
+  NS_LOG_FUNCTION (this << p << rxTime.GetTimeStep () << node << dev);
+  NS_ASSERT_MSG (m_running, "Packets can only be sent while the simulation runs");
+  NS_ASSERT (node < m_systemIds.size ());
+
+  uint32_t src = g_partition;
+  uint32_t dst = m_systemIds[node];
+  uint64_t ts = rxTime.GetTimeStep ();
+  if (dst == src)
+    {
+      // a remote channel between two nodes of the same partition.
+      MpiReceiver *receiver = m_receivers[node][dev];
+      NS_ASSERT (receiver != 0);
+      Insert (GetPartition (), ts, node, MakeEvent (&MpiReceiver::Receive, receiver, p->Copy ()));
+      return;
+    }
+
+  Ring::Message m;
+  m.ts = ts;
+  m.node = node;
+  m.dev = dev;
+  m.size = p->GetSerializedSize ();
+  m.data = new uint8_t[m.size];
+  p->Serialize (m.data, m.size);
+  m_rings[src * m_partitions.size () + dst]->Push (m);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId () const
+{
+  return g_partition;
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Partition &part = GetPartition ();
+  part.stopTs = std::min (part.stopTs, part.currentTs);
+  uint64_t stopTs = m_stopTs.load ();
+  while (part.currentTs < stopTs
+         && !m_stopTs.compare_exchange_weak (stopTs, part.currentTs))
+    {
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Stop (Time const &delay)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep ());
+
+  Partition &part = GetPartition ();
+  uint64_t ts = part.currentTs + delay.GetTimeStep ();
+  part.stopTs = std::min (part.stopTs, ts);
+  uint64_t stopTs = m_stopTs.load ();
+  while (ts < stopTs
+         && !m_stopTs.compare_exchange_weak (stopTs, ts))
+    {
+    }
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+MultithreadedSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep () << event);
+
+  Partition &part = GetPartition ();
+  Time tAbsolute = delay + TimeStep (part.currentTs);
+
+  NS_ASSERT (tAbsolute.IsPositive ());
+  NS_ASSERT (tAbsolute >= TimeStep (part.currentTs));
+  uint64_t ts = static_cast<uint64_t> (tAbsolute.GetTimeStep ());
+  uint32_t uid = Insert (part, ts, part.currentContext, event);
+  return EventId (event, ts, part.currentContext, uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << event);
+
+  ScheduleInContext (context, delay, event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleInContext (uint32_t context, Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << event);
+
+  if (m_running && GetPartitionOf (context) != g_partition)
+    {
+      NS_FATAL_ERROR ("Node " << context << " belongs to partition " << GetPartitionOf (context) <<
+                      " and can't be reached from partition " << g_partition <<
+                      " other than through a remote channel");
+    }
+  Partition &part = GetPartition ();
+  uint64_t ts = part.currentTs + delay.GetTimeStep ();
+  uint32_t uid = Insert (part, ts, context, event);
+  return EventId (event, ts, context, uid);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << event);
+
+  Partition &part = GetPartition ();
+  uint32_t uid = Insert (part, part.currentTs, part.currentContext, event);
+  return EventId (event, part.currentTs, part.currentContext, uid);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << event);
+
+  EventId id (Ptr<EventImpl> (event, false), GetPartition ().currentTs, 0xffffffff, 2);
+  std::lock_guard<std::mutex> lock (m_destroyMutex);
+  m_destroyEvents.push_back (id);
+  return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  return TimeStep (GetPartition ().currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs () - GetPartition ().currentTs);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      std::lock_guard<std::mutex> lock (m_destroyMutex);
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  uint32_t p = g_partition;
+  if (!m_running && id.GetContext () < m_systemIds.size ())
+    {
+      // between two runs, the events stay in the partition of their node.
+      p = std::min<uint32_t> (m_systemIds[id.GetContext ()], m_partitions.size () - 1);
+    }
+  Partition &part = *m_partitions[p];
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  part.events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+
+  part.unscheduledEvents--;
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &id) const
+{
+  if (id.GetUid () == 2)
+    {
+      if (id.PeekEventImpl () == 0
+          || id.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      std::lock_guard<std::mutex> lock (m_destroyMutex);
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  Partition &part = GetPartition ();
+  if (id.PeekEventImpl () == 0
+      || id.GetTs () < part.currentTs
+      || (id.GetTs () == part.currentTs
+          && id.GetUid () <= part.currentUid)
+      || id.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (MAX_TS);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  return GetPartition ().currentContext;
+}
+
+bool
+MultithreadedSimulatorImpl::IsConcurrent (void) const
+{
+  return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,247 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_MULTITHREADED_SIMULATOR_IMPL_H
+#define NS3_MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/simulator-impl.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/object-factory.h"
+#include "ns3/packet.h"
+#include "ns3/ptr.h"
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <vector>
+
+namespace ns3 {
+
+class MpiReceiver;
+
+/**
+ * \ingroup simulator
+ * \ingroup mpi
+ *
+ * \brief Parallel simulator implementation using shared-memory threads
+ *
+ * This simulator runs a distributed simulation inside a single process,
+ * without MPI. Nodes are partitioned by their SystemId: each partition
+ * owns an event list and is executed by its own thread, partition 0
+ * being run by the thread which calls Simulator::Run.
+ *
+ * Like DistributedSimulatorImpl, partitions can only be connected by
+ * PointToPointRemoteChannel links. The packets sent over these links
+ * are serialized into a lock-free single-producer single-consumer ring
+ * per pair of partitions, and turned into MpiReceiver::Receive events
+ * on the receiving side.
+ *
+ * Synchronization is conservative: the smallest Delay of the
+ * remote channels is the lookahead, and all the partitions execute the
+ * events of the time window [lbts, lbts + lookahead) in parallel, lbts
+ * being the timestamp of the earliest pending event of all the
+ * partitions. Between two windows, the threads meet at a barrier,
+ * drain their inbound rings and compute the next lbts. As messages are
+ * only exchanged at the window boundaries, in a deterministic order,
+ * a simulation always produces the same results whatever the
+ * scheduling of the threads.
+ *
+ * Events scheduled before Simulator::Run are dispatched to the partition
+ * which owns the node matching their context, or to partition 0 if the
+ * context is not a node.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  MultithreadedSimulatorImpl ();
+  /** Destructor. */
+  ~MultithreadedSimulatorImpl ();
+
+  // virtual from SimulatorImpl
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (Time const &delay);
+  virtual EventId Schedule (Time const &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event);
+  virtual EventId ScheduleInContext (uint32_t context, Time const &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetMaximumLookAhead (const Time lookAhead);
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+  virtual bool IsConcurrent (void) const;
+
+  /**
+   * \return the number of partitions
+   *
+   * This is the value of the "Partitions" attribute, or one more than
+   * the largest SystemId of the existing nodes if that is larger.
+   */
+  static uint32_t GetSize (void);
+  /**
+   * \param p packet to send
+   * \param rxTime received time at destination node
+   * \param node destination node
+   * \param dev destination device
+   *
+   * Send a packet to a device owned by another partition. This is
+   * called by MultithreadedMpiInterface::SendPacket.
+   */
+  static void SendPacket (Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev);
+
+private:
+  class Ring;
+
+  /** The state of a partition, only accessed by the thread running it. */
+  struct Partition
+  {
+    Ptr<Scheduler> events;  //!< The event list.
+    uint32_t uid;           //!< Next event uid.
+    uint32_t currentUid;    //!< Uid of the event being executed.
+    uint64_t currentTs;     //!< Timestamp of the event being executed.
+    uint32_t currentContext;  //!< Context of the event being executed.
+    /**
+     * Number of events that have been inserted but not yet scheduled,
+     * not counting the "destroy" events; used for validation.
+     */
+    int unscheduledEvents;
+    uint64_t nextTs;        //!< Earliest pending event, published at the barrier.
+    uint64_t stopTs;        //!< Snapshot of m_stopTs taken at the barrier.
+  };
+
+  /** A sense-reversing barrier which spins on atomics. */
+  class Barrier
+  {
+public:
+    /**
+     * Reset the barrier.
+     * \param n The number of threads which meet at the barrier.
+     */
+    void Reset (uint32_t n);
+    /** Wait until all the threads reach the barrier. */
+    void Wait (void);
+private:
+    uint32_t m_n;                         //!< Number of threads.
+    std::atomic<uint32_t> m_count;        //!< Number of threads waiting.
+    std::atomic<uint32_t> m_generation;   //!< Incremented each time the barrier opens.
+  };
+
+  virtual void DoDispose (void);
+
+  /**
+   * \return the partition run by the calling thread.
+   */
+  Partition & GetPartition (void) const;
+  /**
+   * \param context the context of an event
+   * \return the partition which owns the node of this context
+   */
+  uint32_t GetPartitionOf (uint32_t context) const;
+  /**
+   * Insert an event in a partition.
+   * \param part the partition
+   * \param ts the timestamp of the event
+   * \param context the context of the event
+   * \param event the event
+   * \return the uid of the event
+   */
+  uint32_t Insert (Partition &part, uint64_t ts, uint32_t context, EventImpl *event);
+  /**
+   * Move every pending event to the partition owning its context,
+   * creating the missing partitions.
+   */
+  void Dispatch (void);
+  /** Compute the lookahead from the Delay of the remote links. */
+  void CalculateLookAhead (void);
+  /**
+   * Turn the messages received by a partition into events.
+   * \param p the partition index
+   */
+  void ReceiveMessages (uint32_t p);
+  /**
+   * Execute the events of a partition, in the calling thread.
+   * \param p the partition index
+   */
+  void RunPartition (uint32_t p);
+  /**
+   * Execute the next event of a partition.
+   * \param part the partition
+   */
+  void ProcessOneEvent (Partition &part);
+  /**
+   * \param p packet to send
+   * \param rxTime received time at destination node
+   * \param node destination node
+   * \param dev destination device
+   */
+  void DoSendPacket (Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev);
+
+  /** Container type for the events to run at Simulator::Destroy(). */
+  typedef std::list<EventId> DestroyEvents;
+
+  /** The events to run at Simulator::Destroy(). */
+  DestroyEvents m_destroyEvents;
+  /** Protects m_destroyEvents. */
+  mutable std::mutex m_destroyMutex;
+  /** The partitions, indexed by SystemId. */
+  std::vector<Partition *> m_partitions;
+  /** The message rings, indexed by source * size + destination. */
+  std::vector<Ring *> m_rings;
+  /** The receivers of the remote devices, indexed by node and device. */
+  std::vector<std::vector<MpiReceiver *> > m_receivers;
+  /** The partition of each node, indexed by node id. */
+  std::vector<uint32_t> m_systemIds;
+  /** The scheduler type of the partitions. */
+  ObjectFactory m_schedulerFactory;
+  /** The barrier separating the time windows. */
+  Barrier m_barrier;
+  /** The events beyond this timestamp are not executed. */
+  std::atomic<uint64_t> m_stopTs;
+  /** Lookahead, in time steps. */
+  uint64_t m_lookAhead;
+  /** Upper bound of the lookahead set by SetMaximumLookAhead. */
+  uint64_t m_maxLookAhead;
+  /** Minimum number of partitions. */
+  uint32_t m_nPartitions;
+  /** Capacity of the message rings. */
+  uint32_t m_ringSize;
+  /** Is Run executing. */
+  bool m_running;
+
+  /** The instance which handles SendPacket. */
+  static MultithreadedSimulatorImpl *g_instance;
+};
+
+} // namespace ns3
+
+#endif /* NS3_MULTITHREADED_SIMULATOR_IMPL_H */
@@ -424,6 +424,14 @@ NullMessageSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &del
 {
   NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << m_currentTs << event);
 
+  ScheduleInContext (context, delay, event);
+}
+
+EventId
+NullMessageSimulatorImpl::ScheduleInContext (uint32_t context, Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << m_currentTs << event);
+
   Time tAbsolute(m_currentTs + delay.GetTimeStep ());
 
   NS_ASSERT (tAbsolute.IsPositive ());
@@ -437,6 +445,7 @@ NullMessageSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &del
   m_uid++;
   m_unscheduledEvents++;
   m_events->Insert (ev);
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
 }
 
 EventId
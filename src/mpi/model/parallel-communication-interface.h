@@ -69,6 +69,13 @@ public:
    * \return true if parallel communication is enabled
    */
   virtual bool IsEnabled () = 0;
+  /**
+   * \return true if all the parallel tasks share the memory of this process
+   *
+   * In that case, every node is instantiated in this process, whatever
+   * its system id, and the whole topology is visible to each task.
+   */
+  virtual bool IsSharedMemory () { return false; }
   /**
    * \param pargc number of command line arguments
    * \param pargv command line arguments
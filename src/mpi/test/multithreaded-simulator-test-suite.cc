@@ -0,0 +1,439 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/simulator-impl.h"
+#include "ns3/object-factory.h"
+#include "ns3/uinteger.h"
+#include "ns3/timer.h"
+#include "ns3/node.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Set the MultithreadedSimulatorImpl with two partitions as the
+ * simulator, before any other use of the simulator.
+ */
+static void
+UseMultithreadedSimulator (void)
+{
+  Ptr<MultithreadedSimulatorImpl> impl = CreateObject<MultithreadedSimulatorImpl> ();
+  impl->SetAttribute ("Partitions", UintegerValue (2));
+  Simulator::SetImplementation (impl);
+}
+
+/**
+ * Events of a node which schedule more events of the node, with many
+ * ties and cancellations.
+ */
+class EventTree
+{
+public:
+  /**
+   * \param [in] node The node of the events
+   */
+  EventTree (Ptr<Node> node);
+  /**
+   * Record an event and schedule its children.
+   * \param [in] id The id of the event
+   */
+  void Event (uint32_t id);
+
+  /** The time, id and partition of an event. */
+  struct Record
+  {
+    Time time;          //!< The time of the event
+    uint32_t id;        //!< The id of the event
+    uint32_t systemId;  //!< The partition running the event
+    /**
+     * \param [in] o The other record
+     * \returns true if the records are the same
+     */
+    bool operator == (const Record &o) const
+    {
+      return time == o.time && id == o.id && systemId == o.systemId;
+    }
+  };
+
+  Ptr<Node> m_node;              //!< The node of the events
+  uint32_t m_seed;               //!< The state of the delays
+  uint32_t m_ids;                //!< The number of events scheduled
+  std::vector<Record> m_records; //!< The events run, in order
+  uint32_t m_errors;             //!< The number of events in the wrong context
+};
+
+EventTree::EventTree (Ptr<Node> node)
+  : m_node (node),
+    m_seed (node->GetId () + 1),
+    m_ids (0),
+    m_errors (0)
+{
+}
+
+void
+EventTree::Event (uint32_t id)
+{
+  Record record;
+  record.time = Simulator::Now ();
+  record.id = id;
+  record.systemId = m_node->GetSystemId ();
+  m_records.push_back (record);
+  if (Simulator::GetContext () != m_node->GetId ())
+    {
+      m_errors++;
+    }
+  for (uint32_t i = 0; i < 3 && m_ids < 3000; i++)
+    {
+      m_seed = m_seed * 1103515245 + 12345;
+      uint32_t draw = m_seed >> 8;
+      EventId event;
+      if (draw % 7 == 0)
+        {
+          event = Simulator::ScheduleNow (&EventTree::Event, this, ++m_ids);
+        }
+      else
+        {
+          // delays of a few microseconds, so that many events are tied
+          event = Simulator::Schedule (MicroSeconds (draw % 4), &EventTree::Event, this, ++m_ids);
+        }
+      if (draw % 5 == 0)
+        {
+          event.Cancel ();
+        }
+    }
+}
+
+/**
+ * Check that the MultithreadedSimulatorImpl runs the events of each node
+ * in the same order and at the same times as the DefaultSimulatorImpl,
+ * up to the stop time.
+ */
+class MultithreadedEventOrderTestCase : public TestCase
+{
+public:
+  MultithreadedEventOrderTestCase ();
+private:
+  virtual void DoRun (void);
+  /**
+   * Run the event trees of four nodes in two partitions until 500 us.
+   * \param [in] trees The event trees, one per node
+   * \returns The simulation time after the run
+   */
+  Time RunTrees (std::vector<EventTree *> *trees);
+};
+
+MultithreadedEventOrderTestCase::MultithreadedEventOrderTestCase ()
+  : TestCase ("Check that the partitions run the events as the default simulator")
+{
+}
+
+Time
+MultithreadedEventOrderTestCase::RunTrees (std::vector<EventTree *> *trees)
+{
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      trees->push_back (new EventTree (CreateObject<Node> (i % 2)));
+      Simulator::ScheduleWithContext ((*trees)[i]->m_node->GetId (), Seconds (0),
+                                      &EventTree::Event, (*trees)[i], 0);
+    }
+  Simulator::Stop (MicroSeconds (500));
+  Simulator::Run ();
+  Time now = Simulator::Now ();
+  Simulator::Destroy ();
+  return now;
+}
+
+void
+MultithreadedEventOrderTestCase::DoRun (void)
+{
+  std::vector<EventTree *> expected;
+  Time expectedEnd = RunTrees (&expected);
+  UseMultithreadedSimulator ();
+  std::vector<EventTree *> trees;
+  Time end = RunTrees (&trees);
+
+  NS_TEST_EXPECT_MSG_EQ (end, expectedEnd, "the simulations stopped at different times");
+  for (uint32_t i = 0; i < trees.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_GT (expected[i]->m_records.size (), 1000, "too few events on node " << i);
+      NS_TEST_EXPECT_MSG_EQ (trees[i]->m_records.size (), expected[i]->m_records.size (),
+                             "different number of events on node " << i);
+      NS_TEST_EXPECT_MSG_EQ ((trees[i]->m_records == expected[i]->m_records), true,
+                             "different events on node " << i);
+      NS_TEST_EXPECT_MSG_EQ (trees[i]->m_errors, 0, "events of node " << i << " in the wrong context");
+      delete expected[i];
+      delete trees[i];
+    }
+}
+
+/**
+ * A timer of a node rearmed at every expiry, along with a timer which
+ * is cancelled and rearmed before it expires.
+ */
+class TimerChain
+{
+public:
+  /**
+   * \param [in] node The node of the timers
+   */
+  TimerChain (Ptr<Node> node);
+  /** Arm the timers for the first time, in the context of the node. */
+  void Start (void);
+  /** Check an expiry of the chained timer and rearm the timers. */
+  void Step (void);
+  /** Count the expiry of the other timer. */
+  void Other (void);
+
+  Ptr<Node> m_node;     //!< The node of the timers
+  Timer m_timer;        //!< The chained timer
+  Timer m_other;        //!< The timer cancelled before it expires
+  Time m_expected;      //!< The expected expiry of the chained timer
+  uint32_t m_steps;     //!< The number of expiries of the chained timer
+  uint32_t m_others;    //!< The number of expiries of the other timer
+  uint32_t m_errors;    //!< The number of expiries in the wrong place or time
+};
+
+TimerChain::TimerChain (Ptr<Node> node)
+  : m_node (node),
+    m_timer (Timer::CANCEL_ON_DESTROY),
+    m_other (Timer::CANCEL_ON_DESTROY),
+    m_steps (0),
+    m_others (0),
+    m_errors (0)
+{
+  m_timer.SetFunction (&TimerChain::Step, this);
+  m_other.SetFunction (&TimerChain::Other, this);
+}
+
+void
+TimerChain::Start (void)
+{
+  Time delay = MicroSeconds (1 + m_node->GetId ());
+  m_timer.Schedule (delay);
+  m_other.Schedule (delay * 2);
+  m_expected = Simulator::Now () + delay;
+}
+
+void
+TimerChain::Step (void)
+{
+  if (Simulator::Now () != m_expected
+      || Simulator::GetContext () != m_node->GetId ()
+      || Simulator::GetSystemId () != m_node->GetSystemId ())
+    {
+      m_errors++;
+    }
+  if (++m_steps < 1000)
+    {
+      // delays from a microsecond to tens of milliseconds, across the
+      // levels of a wheel
+      Time delay = MicroSeconds (1 + (m_steps * 7919 + m_node->GetId () * 104729) % 50000);
+      m_timer.Schedule (delay);
+      m_other.Cancel ();
+      m_other.Schedule (delay * 2);
+      m_expected = Simulator::Now () + delay;
+    }
+}
+
+void
+TimerChain::Other (void)
+{
+  if (Simulator::GetContext () != m_node->GetId ()
+      || Simulator::GetSystemId () != m_node->GetSystemId ())
+    {
+      m_errors++;
+    }
+  m_others++;
+}
+
+/**
+ * Check that the Timers of nodes in different partitions expire on
+ * time, in their context and partition.
+ */
+class MultithreadedTimerTestCase : public TestCase
+{
+public:
+  MultithreadedTimerTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+MultithreadedTimerTestCase::MultithreadedTimerTestCase ()
+  : TestCase ("Check that timers of several partitions expire in their partition")
+{
+}
+
+void
+MultithreadedTimerTestCase::DoRun (void)
+{
+  UseMultithreadedSimulator ();
+  NS_TEST_ASSERT_MSG_EQ (Simulator::IsConcurrent (), true, "the simulator should run partitions concurrently");
+
+  std::vector<TimerChain *> chains;
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      chains.push_back (new TimerChain (CreateObject<Node> (i % 2)));
+      Simulator::ScheduleWithContext (i, Seconds (0), &TimerChain::Start, chains[i]);
+    }
+  Simulator::Run ();
+  for (uint32_t i = 0; i < chains.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (chains[i]->m_steps, 1000, "timer of node " << i << " did not expire every time");
+      NS_TEST_EXPECT_MSG_EQ (chains[i]->m_others, 1, "rearmed timer of node " << i << " expired");
+      NS_TEST_EXPECT_MSG_EQ (chains[i]->m_errors, 0, "timer of node " << i << " expired in the wrong place");
+      delete chains[i];
+    }
+  Simulator::Destroy ();
+}
+
+/**
+ * Events of a node in another partition than the main thread, removed
+ * and cancelled through the EventIds returned when they were scheduled.
+ */
+class MovedEvents
+{
+public:
+  /**
+   * \param [in] node The node of the events
+   */
+  MovedEvents (Ptr<Node> node);
+  /** Schedule the events, from the main thread. */
+  void Schedule (void);
+  /** Remove and cancel the events, in the context of the node. */
+  void Remove (void);
+  /** Count an event which should have been removed or cancelled. */
+  void Removed (void);
+  /** Check that the events expired, in the context of the node. */
+  void Check (void);
+
+  Ptr<Node> m_node;     //!< The node of the events
+  EventId m_removed;    //!< The event removed
+  EventId m_cancelled;  //!< The event cancelled
+  EventId m_kept;       //!< The event left alone
+  uint32_t m_runs;      //!< The number of events removed or cancelled which ran
+  uint32_t m_kepts;     //!< The number of runs of the event left alone
+  uint32_t m_errors;    //!< The number of wrong expiry states
+};
+
+MovedEvents::MovedEvents (Ptr<Node> node)
+  : m_node (node),
+    m_runs (0),
+    m_kepts (0),
+    m_errors (0)
+{
+}
+
+void
+MovedEvents::Schedule (void)
+{
+  uint32_t context = m_node->GetId ();
+  m_removed = Simulator::ScheduleInContext (context, MicroSeconds (10),
+                                            MakeEvent (&MovedEvents::Removed, this));
+  m_cancelled = Simulator::ScheduleInContext (context, MicroSeconds (10),
+                                              MakeEvent (&MovedEvents::Removed, this));
+  m_kept = Simulator::ScheduleInContext (context, MicroSeconds (10),
+                                         MakeEvent (&MovedEvents::Check, this));
+  Simulator::ScheduleWithContext (context, MicroSeconds (5), &MovedEvents::Remove, this);
+}
+
+void
+MovedEvents::Remove (void)
+{
+  if (m_removed.IsExpired () || m_cancelled.IsExpired () || m_kept.IsExpired ())
+    {
+      m_errors++;
+    }
+  Simulator::Remove (m_removed);
+  m_cancelled.Cancel ();
+  if (!m_removed.IsExpired () || !m_cancelled.IsExpired () || m_kept.IsExpired ())
+    {
+      m_errors++;
+    }
+}
+
+void
+MovedEvents::Removed (void)
+{
+  m_runs++;
+}
+
+void
+MovedEvents::Check (void)
+{
+  m_kepts++;
+  if (!m_removed.IsExpired () || !m_cancelled.IsExpired ())
+    {
+      m_errors++;
+    }
+}
+
+/**
+ * Check that the events moved to the partition of their node before
+ * the run can still be removed and cancelled through their EventIds.
+ */
+class MultithreadedMovedEventTestCase : public TestCase
+{
+public:
+  MultithreadedMovedEventTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+MultithreadedMovedEventTestCase::MultithreadedMovedEventTestCase ()
+  : TestCase ("Check that the events moved to another partition keep their EventIds")
+{
+}
+
+void
+MultithreadedMovedEventTestCase::DoRun (void)
+{
+  UseMultithreadedSimulator ();
+
+  std::vector<MovedEvents *> events;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      events.push_back (new MovedEvents (CreateObject<Node> (i % 2)));
+      events[i]->Schedule ();
+    }
+  Simulator::Run ();
+  for (uint32_t i = 0; i < events.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (events[i]->m_runs, 0, "removed event of node " << i << " ran");
+      NS_TEST_EXPECT_MSG_EQ (events[i]->m_kepts, 1, "event of node " << i << " did not run");
+      NS_TEST_EXPECT_MSG_EQ (events[i]->m_errors, 0, "wrong expiry of the events of node " << i);
+      delete events[i];
+    }
+  Simulator::Destroy ();
+}
+
+/**
+ * The multithreaded simulator test suite.
+ */
+class MultithreadedSimulatorTestSuite : public TestSuite
+{
+public:
+  MultithreadedSimulatorTestSuite ()
+    : TestSuite ("multithreaded-simulator", UNIT)
+  {
+    AddTestCase (new MultithreadedEventOrderTestCase, TestCase::QUICK);
+    AddTestCase (new MultithreadedTimerTestCase, TestCase::QUICK);
+    AddTestCase (new MultithreadedMovedEventTestCase, TestCase::QUICK);
+  }
+} g_multithreadedSimulatorTestSuite;
@@ -24,6 +24,7 @@
 #include <cstring>
 #include <iostream>
 #include <iomanip>
+#include <atomic>
 
 namespace ns3 {
 
@@ -138,9 +139,9 @@ uint8_t
 Address::Register (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  static uint8_t type = 1;
-  type++;
-  return type;
+  // the types may be registered by concurrent Replications
+  static std::atomic<uint8_t> type (1);
+  return ++type;
 }
 
 uint32_t
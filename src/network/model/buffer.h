@@ -488,6 +488,12 @@ private:
    */
   inline uint32_t GetSize (void) const;
 
+  /**
+   * \return true if all the bytes of this buffer are virtual zero
+   * bytes, that is, if no byte has been written to it.
+   */
+  inline bool IsVirtual (void) const;
+
   /**
    * \return a pointer to the start of the internal 
    * byte buffer.
@@ -764,9 +770,9 @@ private:
   /**
    * location in a newly-allocated buffer where you should start
    * writing data. i.e., m_start should be initialized to this 
-   * value.
+   * value. Kept per thread, like the free list.
    */
-  static uint32_t g_recommendedStart;
+  static thread_local uint32_t g_recommendedStart;
 
   /**
    * offset to the start of the virtual zero area from the start
@@ -797,9 +803,13 @@ private:
   {
     ~LocalStaticDestructor ();
   };
-  static uint32_t g_maxSize; //!< Max observed data size
-  static FreeList *g_freeList; //!< Buffer data container
-  static struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
+  /*
+   * The free list is per thread, so that threads running separate
+   * partitions of a parallel simulation can create packets concurrently.
+   */
+  static thread_local uint32_t g_maxSize; //!< Max observed data size
+  static thread_local FreeList *g_freeList; //!< Buffer data container
+  static thread_local struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
 #endif
 };
 
@@ -1064,6 +1074,12 @@ Buffer::GetSize (void) const
   return m_end - m_start;
 }
 
+bool
+Buffer::IsVirtual (void) const
+{
+  return m_start == m_zeroAreaStart && m_end == m_zeroAreaEnd;
+}
+
 Buffer::Iterator 
 Buffer::Begin (void) const
 {
@@ -17,6 +17,7 @@
  */
 
 #include "ns3/simulator.h"
+#include "ns3/replication.h"
 #include "ns3/object-vector.h"
 #include "ns3/config.h"
 #include "ns3/log.h"
@@ -129,13 +130,15 @@ ChannelListPriv::DoGet (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
   static Ptr<ChannelListPriv> ptr = 0;
-  if (ptr == 0)
+  static thread_local Ptr<ChannelListPriv> replicationPtr = 0;
+  Ptr<ChannelListPriv> *pptr = Replication::IsEntered () ? &replicationPtr : &ptr;
+  if (*pptr == 0)
     {
-      ptr = CreateObject<ChannelListPriv> ();
-      Config::RegisterRootNamespaceObject (ptr);
+      *pptr = CreateObject<ChannelListPriv> ();
+      Config::RegisterRootNamespaceObject (*pptr);
       Simulator::ScheduleDestroy (&ChannelListPriv::Delete);
     }
-  return &ptr;
+  return pptr;
 }
 
 void 
@@ -33,7 +33,8 @@ class CallbackBase;
  *
  * \brief the list of simulation channels.
  *
- * Every Channel created is automatically added to this list.
+ * Every Channel created is automatically added to this list. A thread
+ * running a Replication has a list of its own.
  */
 class ChannelList
 {
@@ -35,7 +35,8 @@ class CallbackBase;
  *
  * \brief the list of simulation nodes.
  *
- * Every Node created is automatically added to this list.
+ * Every Node created is automatically added to this list. A thread
+ * running a Replication has a list of its own.
  */
 class NodeList
 {
@@ -28,7 +28,7 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Packet");
 
-uint32_t Packet::m_globalUid = 0;
+thread_local uint32_t Packet::m_globalUid = 0;
 
 TypeId 
 ByteTagIterator::Item::GetTypeId (void) const
@@ -241,6 +241,14 @@ Packet::CreateFragment (uint32_t start, uint32_t length) const
   return ret;
 }
 
+bool
+Packet::IsVirtual (void) const
+{
+  return m_buffer.IsVirtual ()
+         && m_packetTagList.Head () == 0
+         && !m_byteTagList.Begin (0, m_buffer.GetSize ()).HasNext ();
+}
+
 void
 Packet::SetNixVector (Ptr<NixVector> nixVector)
 {
@@ -249,9 +249,10 @@ public:
    *
    * The memory necessary for the payload is not allocated:
    * it will be allocated at any later point if you attempt
-   * to fragment this packet or to access the zero-filled
-   * bytes. The packet is allocated with a new uid (as 
-   * returned by getUid).
+   * to write to the zero-filled bytes. Fragmenting this packet,
+   * or appending it to a packet which also ends with zero-filled
+   * bytes, does not allocate them. The packet is allocated with
+   * a new uid (as returned by getUid).
    * 
    * \param size the size of the zero-filled payload
    */
@@ -298,6 +299,19 @@ public:
    * \returns the size in bytes of the packet
    */
   inline uint32_t GetSize (void) const;
+  /**
+   * \brief Check whether the payload of this packet is virtual.
+   *
+   * A packet is virtual if its bytes are all zero-filled bytes which
+   * were never written nor materialized, and if it has no tag. Such a
+   * packet carries no information besides its size: it can be
+   * merged with another virtual packet, or split, by creating a new
+   * packet of the right size, without copying any byte. This is what
+   * the TCP buffers do with the payload of bulk transfers.
+   *
+   * \returns true if this packet is virtual
+   */
+  bool IsVirtual (void) const;
   /**
    * \brief Add header to this packet.
    *
@@ -727,7 +741,12 @@ private:
   /* Please see comments above about nix-vector */
   Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
-  static uint32_t m_globalUid; //!< Global counter of packets Uid
+  /**
+   * Counter of packets Uid. It is per thread, the system id held in
+   * the upper bits of the uid keeps the uids of parallel simulation
+   * partitions apart.
+   */
+  static thread_local uint32_t m_globalUid;
 };
 
 /**
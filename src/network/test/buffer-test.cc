@@ -359,6 +359,26 @@ BufferTest::DoRun (void)
   val2 <<= 8;
   val2 |= i.ReadU8 ();
   NS_TEST_ASSERT_MSG_EQ (val1, val2, "Bad ReadNtohU16()");
+
+  // merging the zero areas of shared buffers does not materialize them.
+  buffer = Buffer (1000);
+  NS_TEST_ASSERT_MSG_EQ (buffer.IsVirtual (), true, "Zero-filled buffer not virtual");
+  frag0 = buffer.CreateFragment (0, 600);
+  frag1 = buffer.CreateFragment (600, 400);
+  frag0.AddAtEnd (frag1);
+  NS_TEST_ASSERT_MSG_EQ (frag0.GetSize (), 1000, "Bad merged size");
+  NS_TEST_ASSERT_MSG_EQ (frag0.IsVirtual (), true, "Merged zero areas materialized");
+  frag0.AddAtStart (2);
+  i = frag0.Begin ();
+  i.WriteU8 (0x11);
+  i.WriteU8 (0x22);
+  NS_TEST_ASSERT_MSG_EQ (frag0.IsVirtual (), false, "Written buffer still virtual");
+  other = frag0;
+  other.AddAtEnd (frag1);
+  NS_TEST_ASSERT_MSG_EQ (other.GetSize (), 1402, "Bad merged size");
+  NS_TEST_ASSERT_MSG_LT (other.GetSerializedSize (), 100, "Merged zero areas materialized");
+  ENSURE_WRITTEN_BYTES (other.CreateFragment (0, 4), 4, 0x11, 0x22, 0x00, 0x00);
+  ENSURE_WRITTEN_BYTES (frag0.CreateFragment (0, 4), 4, 0x11, 0x22, 0x00, 0x00);
 }
 //-----------------------------------------------------------------------------
 class BufferTestSuite : public TestSuite
@@ -582,6 +582,24 @@ PacketTest::DoRun (void)
     tmp->AddPaddingAtEnd (50);
     CHECK (tmp, 1, E (25, 0, 50));
   }
+
+  /* Test virtual payload */
+  {
+    Ptr<Packet> tmp = Create<Packet> (1000);
+    NS_TEST_EXPECT_MSG_EQ (tmp->IsVirtual (), true, "zero-filled packet not virtual");
+    Ptr<Packet> frag = tmp->CreateFragment (100, 500);
+    frag->AddAtEnd (tmp->CreateFragment (600, 400));
+    NS_TEST_EXPECT_MSG_EQ (frag->GetSize (), 900, "bad merged size");
+    NS_TEST_EXPECT_MSG_EQ (frag->IsVirtual (), true, "merged fragments not virtual");
+    frag->AddByteTag (ATestTag<10> ());
+    NS_TEST_EXPECT_MSG_EQ (frag->IsVirtual (), false, "tagged packet virtual");
+    frag = tmp->Copy ();
+    frag->AddHeader (ATestHeader<10> ());
+    NS_TEST_EXPECT_MSG_EQ (frag->IsVirtual (), false, "packet with header virtual");
+    ATestHeader<10> header;
+    frag->RemoveHeader (header);
+    NS_TEST_EXPECT_MSG_EQ (frag->IsVirtual (), true, "payload not virtual once header removed");
+  }
 }
 //--------------------------------------
 class PacketTagListTest : public TestCase
@@ -19,6 +19,7 @@
  */
 #include "flow-id-tag.h"
 #include "ns3/log.h"
+#include "ns3/replication.h"
 
 namespace ns3 {
 
@@ -95,7 +96,9 @@ uint32_t
 FlowIdTag::AllocateFlowId (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  static uint32_t nextFlowId = 1;
+  static uint32_t sharedFlowId = 1;
+  static thread_local uint32_t replicationFlowId = 1;
+  uint32_t &nextFlowId = Replication::IsEntered () ? replicationFlowId : sharedFlowId;
   uint32_t flowId = nextFlowId;
   nextFlowId++;
   return flowId;
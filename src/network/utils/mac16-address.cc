@@ -22,6 +22,7 @@
 #include "ns3/address.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/replication.h"
 #include <iomanip>
 #include <iostream>
 #include <cstring>
@@ -140,7 +141,9 @@ Mac16Address
 Mac16Address::Allocate (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  static uint64_t id = 0;
+  static uint64_t allocated = 0;
+  static thread_local uint64_t replicationAllocated = 0;
+  uint64_t &id = Replication::IsEntered () ? replicationAllocated : allocated;
   id++;
   Mac16Address address;
   address.m_address[0] = (id >> 8) & 0xff;
@@ -21,6 +21,7 @@
 #include "ns3/address.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/replication.h"
 #include <iomanip>
 #include <iostream>
 #include <cstring>
@@ -135,7 +136,10 @@ Mac48Address
 Mac48Address::Allocate (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  static uint64_t id = 0;
+  // the addresses of a Replication do not depend on the other ones
+  static uint64_t allocated = 0;
+  static thread_local uint64_t replicationAllocated = 0;
+  uint64_t &id = Replication::IsEntered () ? replicationAllocated : allocated;
   id++;
   Mac48Address address;
   address.m_address[0] = (id >> 40) & 0xff;
@@ -247,7 +247,13 @@ PointToPointHelper::Install (Ptr<Node> a, Ptr<Node> b)
       uint32_t n1SystemId = a->GetSystemId ();
       uint32_t n2SystemId = b->GetSystemId ();
       uint32_t currSystemId = MpiInterface::GetSystemId ();
-      if (n1SystemId != currSystemId || n2SystemId != currSystemId) 
+      if (MpiInterface::IsSharedMemory ())
+        {
+          // all the nodes live in this process, only the links between
+          // two partitions need to be remote.
+          useNormalChannel = n1SystemId == n2SystemId;
+        }
+      else if (n1SystemId != currSystemId || n2SystemId != currSystemId) 
         {
           useNormalChannel = false;
         }
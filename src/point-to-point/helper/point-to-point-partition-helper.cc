@@ -0,0 +1,591 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "point-to-point-partition-helper.h"
+
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/point-to-point-channel.h"
+#include "ns3/point-to-point-remote-channel.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/mpi-receiver.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <set>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PointToPointPartitionHelper");
+
+namespace {
+
+/** Delay of the links which are never cut. */
+const int64_t INFINITE_DELAY = std::numeric_limits<int64_t>::max ();
+
+/**
+ * Find the representative of a node in a union-find forest.
+ *
+ * \param [in,out] parent The forest.
+ * \param [in] i The node.
+ * \returns The representative.
+ */
+uint32_t
+Find (std::vector<uint32_t> &parent, uint32_t i)
+{
+  while (parent[i] != i)
+    {
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+    }
+  return i;
+}
+
+/**
+ * Pack weights into bins, heaviest first in the lightest bin.
+ *
+ * \param [in] weights The weights.
+ * \param [in] n The number of bins.
+ * \returns The weight of the heaviest bin.
+ */
+uint64_t
+Pack (const std::vector<uint64_t> &weights, uint32_t n)
+{
+  std::vector<uint64_t> sorted (weights);
+  std::sort (sorted.begin (), sorted.end (), std::greater<uint64_t> ());
+  std::vector<uint64_t> bins (n, 0);
+  for (std::vector<uint64_t>::const_iterator i = sorted.begin (); i != sorted.end (); ++i)
+    {
+      *std::min_element (bins.begin (), bins.end ()) += *i;
+    }
+  return *std::max_element (bins.begin (), bins.end ());
+}
+
+/**
+ * Copy the attributes of an object which another object can take.
+ *
+ * \param [in] from The object to copy from.
+ * \param [in] to The object to copy to.
+ */
+void
+CopyAttributes (Ptr<const Object> from, Ptr<Object> to)
+{
+  TypeId toTid = to->GetInstanceTypeId ();
+  TypeId tid = from->GetInstanceTypeId ();
+  do
+    {
+      for (uint32_t i = 0; i < tid.GetAttributeN (); ++i)
+        {
+          const struct TypeId::AttributeInformation &info = tid.GetAttribute (i);
+          struct TypeId::AttributeInformation toInfo;
+          if (!(info.flags & TypeId::ATTR_GET) || !info.accessor->HasGetter ()
+              || !toTid.LookupAttributeByName (info.name, &toInfo)
+              || !(toInfo.flags & TypeId::ATTR_SET) || !toInfo.accessor->HasSetter ())
+            {
+              continue;
+            }
+          Ptr<AttributeValue> value = info.checker->Create ();
+          from->GetAttribute (info.name, *value);
+          to->SetAttribute (info.name, *value);
+        }
+      tid = tid.GetParent ();
+    } while (tid != ObjectBase::GetTypeId ());
+}
+
+} // unnamed namespace
+
+PointToPointPartitionHelper::PointToPointPartitionHelper ()
+  : m_imbalance (0.05),
+    m_passes (8),
+    m_n (1),
+    m_edgeCut (0),
+    m_lookAhead (INFINITE_DELAY)
+{
+  m_channelFactory.SetTypeId ("ns3::PointToPointChannel");
+  m_remoteChannelFactory.SetTypeId ("ns3::PointToPointRemoteChannel");
+}
+
+PointToPointPartitionHelper::~PointToPointPartitionHelper ()
+{
+}
+
+void
+PointToPointPartitionHelper::SetImbalance (double imbalance)
+{
+  NS_ASSERT (imbalance >= 0);
+  m_imbalance = imbalance;
+}
+
+void
+PointToPointPartitionHelper::SetRefinementPasses (uint32_t passes)
+{
+  m_passes = passes;
+}
+
+void
+PointToPointPartitionHelper::Partition (NodeContainer c, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+  NS_ASSERT (n > 0);
+
+  m_nodes = c;
+  m_n = n;
+  uint32_t nNodes = c.GetN ();
+  m_weight.assign (nNodes, 1);
+  m_links.clear ();
+  m_part.assign (nNodes, 0);
+
+  std::map<uint32_t, uint32_t> index;
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      index[c.Get (i)->GetId ()] = i;
+    }
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      Ptr<Node> node = c.Get (i);
+      for (uint32_t j = 0; j < node->GetNDevices (); ++j)
+        {
+          Ptr<PointToPointNetDevice> dev = DynamicCast<PointToPointNetDevice> (node->GetDevice (j));
+          if (dev == 0)
+            {
+              continue;
+            }
+          m_weight[i]++;
+          Ptr<PointToPointChannel> channel = DynamicCast<PointToPointChannel> (dev->GetChannel ());
+          if (channel == 0 || channel->GetNDevices () != 2)
+            {
+              continue;
+            }
+          Ptr<PointToPointNetDevice> peer = channel->GetPointToPointDevice (0);
+          if (peer == dev)
+            {
+              peer = channel->GetPointToPointDevice (1);
+            }
+          std::map<uint32_t, uint32_t>::const_iterator k = index.find (peer->GetNode ()->GetId ());
+          // each link is seen from both ends, keep one.
+          if (k == index.end () || k->second <= i)
+            {
+              continue;
+            }
+          TimeValue delay;
+          channel->GetAttribute ("Delay", delay);
+          Link link;
+          link.a = i;
+          link.b = k->second;
+          link.delay = delay.Get ().GetTimeStep ();
+          link.channel = channel;
+          m_links.push_back (link);
+        }
+    }
+
+  uint64_t total = 0;
+  uint64_t heaviest = 0;
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      total += m_weight[i];
+      heaviest = std::max (heaviest, m_weight[i]);
+    }
+  uint64_t cap = static_cast<uint64_t> (std::ceil ((1 + m_imbalance) * total / n));
+  cap = std::max (cap, heaviest);
+
+  // candidate lookaheads, from the largest: no link cut, then each delay.
+  std::vector<int64_t> delays;
+  delays.push_back (INFINITE_DELAY);
+  for (std::vector<Link>::const_iterator i = m_links.begin (); i != m_links.end (); ++i)
+    {
+      delays.push_back (i->delay);
+    }
+  std::sort (delays.begin (), delays.end (), std::greater<int64_t> ());
+  delays.erase (std::unique (delays.begin (), delays.end ()), delays.end ());
+
+  std::vector<uint32_t> component;
+  uint32_t nComponents = 0;
+  int64_t minDelay = delays.back ();
+  for (std::vector<int64_t>::const_iterator d = delays.begin (); d != delays.end (); ++d)
+    {
+      // contract the links shorter than the candidate lookahead.
+      std::vector<uint32_t> parent (nNodes);
+      for (uint32_t i = 0; i < nNodes; ++i)
+        {
+          parent[i] = i;
+        }
+      for (std::vector<Link>::const_iterator i = m_links.begin (); i != m_links.end (); ++i)
+        {
+          if (i->delay < *d || *d == INFINITE_DELAY)
+            {
+              parent[Find (parent, i->a)] = Find (parent, i->b);
+            }
+        }
+      component.assign (nNodes, 0);
+      std::vector<uint32_t> label (nNodes, nNodes);
+      std::vector<uint64_t> weights;
+      nComponents = 0;
+      for (uint32_t i = 0; i < nNodes; ++i)
+        {
+          uint32_t root = Find (parent, i);
+          if (label[root] == nNodes)
+            {
+              label[root] = nComponents++;
+              weights.push_back (0);
+            }
+          component[i] = label[root];
+          weights[component[i]] += m_weight[i];
+        }
+      if (nNodes == 0 || Pack (weights, n) <= cap)
+        {
+          minDelay = *d;
+          NS_LOG_LOGIC ("lookahead " << *d << " leaves " << nComponents << " components");
+          break;
+        }
+    }
+
+  Assign (component, nComponents, minDelay, cap);
+  ComputeMetrics ();
+  NS_LOG_INFO ("partitioned " << nNodes << " nodes, edge cut " << m_edgeCut <<
+               ", lookahead " << GetLookAhead ());
+}
+
+void
+PointToPointPartitionHelper::Assign (const std::vector<uint32_t> &component, uint32_t nComponents,
+                                     int64_t minDelay, uint64_t cap)
+{
+  NS_LOG_FUNCTION (this << nComponents << minDelay << cap);
+
+  // the contracted graph: one vertex per component, one edge per link cut.
+  std::vector<uint64_t> weight (nComponents, 0);
+  std::vector<std::vector<uint32_t> > adjacency (nComponents);
+  uint64_t remaining = 0;
+  for (uint32_t i = 0; i < component.size (); ++i)
+    {
+      weight[component[i]] += m_weight[i];
+      remaining += m_weight[i];
+    }
+  for (std::vector<Link>::const_iterator i = m_links.begin (); i != m_links.end (); ++i)
+    {
+      uint32_t a = component[i->a];
+      uint32_t b = component[i->b];
+      if (a != b)
+        {
+          adjacency[a].push_back (b);
+          adjacency[b].push_back (a);
+        }
+    }
+
+  // graph growing: fill the partitions one after the other, each time
+  // taking the vertex with the most links to the current partition.
+  const uint32_t NONE = m_n;
+  std::vector<uint32_t> part (nComponents, NONE);
+  std::vector<uint64_t> pw (m_n, 0);
+  for (uint32_t p = 0; p < m_n; ++p)
+    {
+      uint64_t target = remaining / (m_n - p);
+      std::vector<uint32_t> conn (nComponents, 0);
+      std::set<std::pair<int64_t, uint32_t> > frontier;
+      std::vector<bool> skipped (nComponents, false);
+      while (p == m_n - 1 || pw[p] < target)
+        {
+          uint32_t v = NONE;
+          if (!frontier.empty ())
+            {
+              v = frontier.begin ()->second;
+              frontier.erase (frontier.begin ());
+            }
+          else
+            {
+              // start from the vertex farthest from the first unassigned
+              // vertex, which is likely on the periphery of the graph.
+              uint32_t first = 0;
+              while (first < nComponents && (part[first] != NONE || skipped[first]))
+                {
+                  first++;
+                }
+              if (first == nComponents)
+                {
+                  break;
+                }
+              std::vector<bool> seen (nComponents, false);
+              std::vector<uint32_t> queue (1, first);
+              seen[first] = true;
+              for (uint32_t q = 0; q < queue.size (); ++q)
+                {
+                  for (std::vector<uint32_t>::const_iterator u = adjacency[queue[q]].begin ();
+                       u != adjacency[queue[q]].end (); ++u)
+                    {
+                      if (!seen[*u] && part[*u] == NONE && !skipped[*u])
+                        {
+                          seen[*u] = true;
+                          queue.push_back (*u);
+                        }
+                    }
+                }
+              v = queue.back ();
+            }
+          if (p != m_n - 1 && pw[p] > 0 && pw[p] + weight[v] > cap)
+            {
+              skipped[v] = true;
+              continue;
+            }
+          part[v] = p;
+          pw[p] += weight[v];
+          remaining -= weight[v];
+          for (std::vector<uint32_t>::const_iterator u = adjacency[v].begin ();
+               u != adjacency[v].end (); ++u)
+            {
+              if (part[*u] != NONE || skipped[*u])
+                {
+                  continue;
+                }
+              frontier.erase (std::make_pair (-static_cast<int64_t> (conn[*u]), *u));
+              conn[*u]++;
+              frontier.insert (std::make_pair (-static_cast<int64_t> (conn[*u]), *u));
+            }
+        }
+    }
+
+  // greedy refinement: move the vertices to the neighbouring partition
+  // which reduces the cut the most, and out of the overweight partitions.
+  for (uint32_t pass = 0; pass < m_passes; ++pass)
+    {
+      bool moved = false;
+      for (uint32_t v = 0; v < nComponents; ++v)
+        {
+          uint32_t from = part[v];
+          std::vector<int64_t> conn (m_n, 0);
+          for (std::vector<uint32_t>::const_iterator u = adjacency[v].begin ();
+               u != adjacency[v].end (); ++u)
+            {
+              conn[part[*u]]++;
+            }
+          bool over = pw[from] > cap;
+          uint32_t best = from;
+          int64_t bestGain = 0;
+          for (uint32_t t = 0; t < m_n; ++t)
+            {
+              if (t == from || pw[t] + weight[v] > cap)
+                {
+                  continue;
+                }
+              int64_t gain = conn[t] - conn[from];
+              bool better;
+              if (best == from)
+                {
+                  better = over || gain > 0
+                    || (gain == 0 && pw[t] + weight[v] < pw[from]);
+                }
+              else
+                {
+                  better = gain > bestGain || (gain == bestGain && pw[t] < pw[best]);
+                }
+              if (better)
+                {
+                  best = t;
+                  bestGain = gain;
+                }
+            }
+          if (best != from)
+            {
+              part[v] = best;
+              pw[from] -= weight[v];
+              pw[best] += weight[v];
+              moved = true;
+            }
+        }
+      if (!moved)
+        {
+          break;
+        }
+    }
+
+  for (uint32_t i = 0; i < component.size (); ++i)
+    {
+      m_part[i] = part[component[i]];
+    }
+}
+
+void
+PointToPointPartitionHelper::ComputeMetrics (void)
+{
+  m_edgeCut = 0;
+  m_lookAhead = INFINITE_DELAY;
+  for (std::vector<Link>::const_iterator i = m_links.begin (); i != m_links.end (); ++i)
+    {
+      if (m_part[i->a] != m_part[i->b])
+        {
+          m_edgeCut++;
+          m_lookAhead = std::min (m_lookAhead, i->delay);
+        }
+    }
+}
+
+void
+PointToPointPartitionHelper::Apply (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  for (uint32_t i = 0; i < m_nodes.GetN (); ++i)
+    {
+      m_nodes.Get (i)->SetAttribute ("SystemId", UintegerValue (m_part[i]));
+    }
+  if (!MpiInterface::IsEnabled ())
+    {
+      // a sequential simulation only uses local channels.
+      return;
+    }
+  for (std::vector<Link>::iterator i = m_links.begin (); i != m_links.end (); ++i)
+    {
+      // same rule as PointToPointHelper::Install
+      uint32_t n1SystemId = m_part[i->a];
+      uint32_t n2SystemId = m_part[i->b];
+      uint32_t currSystemId = MpiInterface::GetSystemId ();
+      bool remote;
+      if (MpiInterface::IsSharedMemory ())
+        {
+          remote = n1SystemId != n2SystemId;
+        }
+      else
+        {
+          remote = n1SystemId != currSystemId || n2SystemId != currSystemId;
+        }
+      bool isRemote = DynamicCast<PointToPointRemoteChannel> (i->channel) != 0;
+      if (remote != isRemote)
+        {
+          SwapChannel (*i, remote);
+        }
+    }
+}
+
+void
+PointToPointPartitionHelper::Install (NodeContainer c, uint32_t n)
+{
+  Partition (c, n);
+  Apply ();
+}
+
+void
+PointToPointPartitionHelper::SwapChannel (Link &link, bool remote)
+{
+  NS_LOG_FUNCTION (this << link.a << link.b << remote);
+
+  Ptr<PointToPointNetDevice> devA = link.channel->GetPointToPointDevice (0);
+  Ptr<PointToPointNetDevice> devB = link.channel->GetPointToPointDevice (1);
+  Ptr<PointToPointChannel> channel;
+  if (remote)
+    {
+      channel = m_remoteChannelFactory.Create<PointToPointRemoteChannel> ();
+      Ptr<PointToPointNetDevice> devices[2] = { devA, devB };
+      for (uint32_t i = 0; i < 2; ++i)
+        {
+          if (devices[i]->GetObject<MpiReceiver> () == 0)
+            {
+              Ptr<MpiReceiver> mpiRec = CreateObject<MpiReceiver> ();
+              mpiRec->SetReceiveCallback (MakeCallback (&PointToPointNetDevice::Receive, devices[i]));
+              devices[i]->AggregateObject (mpiRec);
+            }
+        }
+    }
+  else
+    {
+      channel = m_channelFactory.Create<PointToPointChannel> ();
+    }
+  CopyAttributes (link.channel, channel);
+  // the old channel stays in the ChannelList, but is no longer used.
+  devA->Attach (channel);
+  devB->Attach (channel);
+  link.channel = channel;
+}
+
+uint32_t
+PointToPointPartitionHelper::GetSystemId (uint32_t i) const
+{
+  NS_ASSERT (i < m_part.size ());
+  return m_part[i];
+}
+
+Time
+PointToPointPartitionHelper::GetLookAhead (void) const
+{
+  if (m_lookAhead == INFINITE_DELAY)
+    {
+      return Simulator::GetMaximumSimulationTime ();
+    }
+  return TimeStep (m_lookAhead);
+}
+
+uint32_t
+PointToPointPartitionHelper::GetEdgeCut (void) const
+{
+  return m_edgeCut;
+}
+
+std::vector<uint64_t>
+PointToPointPartitionHelper::GetWeights (void) const
+{
+  std::vector<uint64_t> weights (m_n, 0);
+  for (uint32_t i = 0; i < m_part.size (); ++i)
+    {
+      weights[m_part[i]] += m_weight[i];
+    }
+  return weights;
+}
+
+double
+PointToPointPartitionHelper::GetSpeedupBound (void) const
+{
+  std::vector<uint64_t> weights = GetWeights ();
+  uint64_t total = 0;
+  uint64_t heaviest = 0;
+  for (std::vector<uint64_t>::const_iterator i = weights.begin (); i != weights.end (); ++i)
+    {
+      total += *i;
+      heaviest = std::max (heaviest, *i);
+    }
+  if (heaviest == 0)
+    {
+      return 1;
+    }
+  return static_cast<double> (total) / heaviest;
+}
+
+void
+PointToPointPartitionHelper::Print (std::ostream &os) const
+{
+  os << "Partitions: " << m_n << std::endl;
+  os << "Lookahead: ";
+  if (m_lookAhead == INFINITE_DELAY)
+    {
+      os << "infinite";
+    }
+  else
+    {
+      os << GetLookAhead ().GetSeconds () << "s";
+    }
+  os << std::endl;
+  os << "Edge cut: " << m_edgeCut << " of " << m_links.size () << " links" << std::endl;
+  os << "Weights:";
+  std::vector<uint64_t> weights = GetWeights ();
+  for (std::vector<uint64_t>::const_iterator i = weights.begin (); i != weights.end (); ++i)
+    {
+      os << " " << *i;
+    }
+  os << std::endl;
+  os << "Speedup bound: " << GetSpeedupBound () << std::endl;
+}
+
+} // namespace ns3
@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef POINT_TO_POINT_PARTITION_HELPER_H
+#define POINT_TO_POINT_PARTITION_HELPER_H
+
+#include <ostream>
+#include <vector>
+
+#include "ns3/object-factory.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+namespace ns3 {
+
+class PointToPointChannel;
+
+/**
+ * \brief Split a point-to-point topology into the logical processes of a
+ * distributed simulation
+ *
+ * Rather than assigning the SystemId of each node by hand, a topology
+ * can be built with all its nodes in system 0 and then partitioned by
+ * this helper, which looks at the point-to-point links between the
+ * given nodes and their Delay.
+ *
+ * The partition maximizes the lookahead first: the links shorter than
+ * the lookahead are never cut, and the lookahead chosen is the largest
+ * link delay for which the partitions can still be balanced. Within
+ * that constraint, the partition is built by graph growing and then
+ * refined greedily to reduce the number of links cut (the edge cut).
+ * The weight of a node, used for balancing, is one plus its number of
+ * point-to-point devices. The result only depends on the topology, so
+ * every MPI rank computes the same partition.
+ *
+ * Partition () computes the partition and its metrics, which can be
+ * looked at with Print () before deciding to run; Apply () then sets the
+ * SystemId of the nodes and replaces the channels of the links which
+ * now cross two partitions by PointToPointRemoteChannel (or the other way
+ * around). Both must be done before Simulator::Run.
+ */
+class PointToPointPartitionHelper
+{
+public:
+  /** Create a PointToPointPartitionHelper. */
+  PointToPointPartitionHelper ();
+  /** Destroy a PointToPointPartitionHelper. */
+  ~PointToPointPartitionHelper ();
+
+  /**
+   * \param imbalance the tolerated imbalance
+   *
+   * The weight of a partition can exceed the average weight by this
+   * fraction, 0.05 by default.
+   */
+  void SetImbalance (double imbalance);
+  /**
+   * \param passes the maximum number of refinement passes, 8 by default.
+   */
+  void SetRefinementPasses (uint32_t passes);
+
+  /**
+   * Compute the partition of a set of nodes.
+   *
+   * Only the point-to-point links between two nodes of the container
+   * are considered. This does not modify the nodes.
+   *
+   * \param c the nodes
+   * \param n the number of partitions, usually MpiInterface::GetSize ()
+   */
+  void Partition (NodeContainer c, uint32_t n);
+  /**
+   * Assign the nodes to the partitions computed by Partition, and
+   * use remote channels for the links between two partitions if
+   * parallel communication is enabled.
+   */
+  void Apply (void);
+  /**
+   * Partition a set of nodes and apply the partition.
+   *
+   * \param c the nodes
+   * \param n the number of partitions
+   */
+  void Install (NodeContainer c, uint32_t n);
+
+  /**
+   * \param i the index of a node in the container given to Partition
+   * \returns the partition of the node
+   */
+  uint32_t GetSystemId (uint32_t i) const;
+  /**
+   * \returns the expected lookahead, the smallest delay of the links cut,
+   * or Simulator::GetMaximumSimulationTime if no link is cut.
+   */
+  Time GetLookAhead (void) const;
+  /**
+   * \returns the number of links cut
+   */
+  uint32_t GetEdgeCut (void) const;
+  /**
+   * \returns the total weight of each partition
+   */
+  std::vector<uint64_t> GetWeights (void) const;
+  /**
+   * \returns the ratio of the total weight to the weight of the heaviest
+   * partition, an upper bound of the speedup of the parallel simulation.
+   */
+  double GetSpeedupBound (void) const;
+  /**
+   * Print the partition metrics.
+   *
+   * \param os the output stream
+   */
+  void Print (std::ostream &os) const;
+
+private:
+  /** A point-to-point link between two nodes of the container. */
+  struct Link
+  {
+    uint32_t a;       //!< Index of the first node.
+    uint32_t b;       //!< Index of the second node.
+    int64_t delay;    //!< Delay of the channel, in time steps.
+    Ptr<PointToPointChannel> channel; //!< The channel.
+  };
+
+  /**
+   * Assign the components of the contracted graph to the partitions.
+   *
+   * \param component the component of each node
+   * \param nComponents the number of components
+   * \param minDelay the links shorter than this belong to a component
+   * \param cap the maximum weight of a partition
+   */
+  void Assign (const std::vector<uint32_t> &component, uint32_t nComponents,
+               int64_t minDelay, uint64_t cap);
+  /** Compute the edge cut and the lookahead of the current partition. */
+  void ComputeMetrics (void);
+  /**
+   * Replace the channel of a link by a channel of another type, with
+   * the same attribute values.
+   *
+   * \param link the link
+   * \param remote whether the new channel is remote
+   */
+  void SwapChannel (Link &link, bool remote);
+
+  double m_imbalance;           //!< Tolerated imbalance.
+  uint32_t m_passes;            //!< Maximum number of refinement passes.
+  uint32_t m_n;                 //!< Number of partitions.
+  NodeContainer m_nodes;        //!< The nodes partitioned.
+  std::vector<uint64_t> m_weight;   //!< Weight of each node.
+  std::vector<Link> m_links;        //!< Links between the nodes.
+  std::vector<uint32_t> m_part;     //!< Partition of each node.
+  uint32_t m_edgeCut;           //!< Number of links cut.
+  int64_t m_lookAhead;          //!< Smallest delay of the links cut.
+  ObjectFactory m_channelFactory;       //!< Channel Factory
+  ObjectFactory m_remoteChannelFactory; //!< Remote Channel Factory
+};
+
+} // namespace ns3
+
+#endif /* POINT_TO_POINT_PARTITION_HELPER_H */
@@ -25,6 +25,7 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "ns3/node.h"
 #include "ns3/mpi-interface.h"
 
 namespace ns3 {
@@ -45,7 +46,8 @@ PointToPointRemoteChannel::GetTypeId (void)
 }
 
 PointToPointRemoteChannel::PointToPointRemoteChannel ()
-  : PointToPointChannel ()
+  : PointToPointChannel (),
+    m_nPeers (0)
 {
 }
 
@@ -53,6 +55,18 @@ PointToPointRemoteChannel::~PointToPointRemoteChannel ()
 {
 }
 
+void
+PointToPointRemoteChannel::Attach (Ptr<PointToPointNetDevice> device)
+{
+  NS_LOG_FUNCTION (this << device);
+  NS_ASSERT_MSG (device->GetNode () != 0, "Device must be added to a node before being attached");
+  PointToPointChannel::Attach (device);
+  Peer &peer = m_peers[m_nPeers++];
+  peer.device = PeekPointer (device);
+  peer.node = device->GetNode ()->GetId ();
+  peer.ifIndex = device->GetIfIndex ();
+}
+
 bool
 PointToPointRemoteChannel::TransmitStart (
   Ptr<Packet> p,
@@ -64,16 +78,12 @@ PointToPointRemoteChannel::TransmitStart (
 
   IsInitialized ();
 
-  uint32_t wire = src == GetSource (0) ? 0 : 1;
-  Ptr<PointToPointNetDevice> dst = GetDestination (wire);
+  NS_ASSERT (m_nPeers == 2);
+  const Peer &dst = m_peers[PeekPointer (src) == m_peers[0].device ? 1 : 0];
 
-#ifdef NS3_MPI
   // Calculate the rxTime (absolute)
   Time rxTime = Simulator::Now () + txTime + GetDelay ();
-  MpiInterface::SendPacket (p, rxTime, dst->GetNode ()->GetId (), dst->GetIfIndex ());
-#else
-  NS_FATAL_ERROR ("Can't use distributed simulator without MPI compiled in");
-#endif
+  MpiInterface::SendPacket (p, rxTime, dst.node, dst.ifIndex);
   return true;
 }
 
@@ -58,6 +58,17 @@ public:
    */
   ~PointToPointRemoteChannel ();
 
+  /**
+   * \brief Attach a given netdevice to this channel
+   *
+   * The node and interface index of the device are recorded, so that
+   * transmitting does not touch the remote device, which may be
+   * concurrently used by another thread.
+   *
+   * \param device pointer to the netdevice to attach to the channel
+   */
+  virtual void Attach (Ptr<PointToPointNetDevice> device);
+
   /**
    * \brief Transmit the packet
    *
@@ -68,6 +79,18 @@ public:
    */
   virtual bool TransmitStart (Ptr<Packet> p, Ptr<PointToPointNetDevice> src,
                               Time txTime);
+
+private:
+  /** The identifiers of an end of the channel. */
+  struct Peer
+  {
+    PointToPointNetDevice *device; //!< The device, only used as a key.
+    uint32_t node;                 //!< The node id.
+    uint32_t ifIndex;              //!< The interface index of the device.
+  };
+
+  Peer m_peers[2];    //!< The ends of the channel.
+  uint32_t m_nPeers;  //!< Number of attached devices.
 };
 
 } // namespace ns3
@@ -23,6 +23,13 @@
 #include "ns3/simulator.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/point-to-point-partition-helper.h"
+#include "ns3/point-to-point-remote-channel.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/global-value.h"
+#include "ns3/data-rate.h"
+#include "ns3/string.h"
 
 using namespace ns3;
 
@@ -100,6 +107,181 @@ PointToPointTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \brief Test class for PointToPointPartitionHelper
+ *
+ * It partitions two stars whose hubs are joined by a long link, and
+ * checks that only that link is cut. A shorter link between two leaves
+ * of the stars then has to be cut as well, and sets the lookahead.
+ */
+class PointToPointPartitionTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointPartitionTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+};
+
+PointToPointPartitionTest::PointToPointPartitionTest ()
+  : TestCase ("PointToPointPartition")
+{
+}
+
+void
+PointToPointPartitionTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (8);
+  PointToPointHelper p2p;
+  p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  for (uint32_t i = 1; i < 4; ++i)
+    {
+      p2p.Install (nodes.Get (0), nodes.Get (i));
+      p2p.Install (nodes.Get (4), nodes.Get (4 + i));
+    }
+  p2p.SetChannelAttribute ("Delay", StringValue ("20ms"));
+  p2p.Install (nodes.Get (0), nodes.Get (4));
+
+  PointToPointPartitionHelper partition;
+  partition.Partition (nodes, 2);
+  NS_TEST_ASSERT_MSG_EQ (partition.GetEdgeCut (), 1, "only the trunk should be cut");
+  NS_TEST_ASSERT_MSG_EQ (partition.GetLookAhead (), MilliSeconds (20), "wrong lookahead");
+  std::vector<uint64_t> weights = partition.GetWeights ();
+  NS_TEST_ASSERT_MSG_EQ (weights[0], 11, "unbalanced partition");
+  NS_TEST_ASSERT_MSG_EQ (weights[1], 11, "unbalanced partition");
+  for (uint32_t i = 1; i < 4; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (partition.GetSystemId (i), partition.GetSystemId (0), "leaf split from its hub");
+      NS_TEST_ASSERT_MSG_EQ (partition.GetSystemId (4 + i), partition.GetSystemId (4), "leaf split from its hub");
+    }
+  NS_TEST_ASSERT_MSG_NE (partition.GetSystemId (0), partition.GetSystemId (4), "hubs in the same partition");
+
+  partition.Apply ();
+  for (uint32_t i = 0; i < nodes.GetN (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (nodes.Get (i)->GetSystemId (), partition.GetSystemId (i), "SystemId not set");
+    }
+
+  // joining the stars with a shorter link forbids the larger lookahead.
+  p2p.SetChannelAttribute ("Delay", StringValue ("2ms"));
+  p2p.Install (nodes.Get (1), nodes.Get (5));
+  partition.Partition (nodes, 2);
+  NS_TEST_ASSERT_MSG_EQ (partition.GetEdgeCut (), 2, "both links between the stars should be cut");
+  NS_TEST_ASSERT_MSG_EQ (partition.GetLookAhead (), MilliSeconds (2), "wrong lookahead");
+
+  // a single partition cuts nothing.
+  partition.Partition (nodes, 1);
+  NS_TEST_ASSERT_MSG_EQ (partition.GetEdgeCut (), 0, "no link should be cut");
+  NS_TEST_ASSERT_MSG_EQ (partition.GetSpeedupBound (), 1, "wrong speedup bound");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief Test class for a link cut by PointToPointPartitionHelper
+ *
+ * It partitions two nodes joined by a link, with the multithreaded
+ * simulator, and checks that the link gets a remote channel with the
+ * attributes of the original one, which carries a packet from one
+ * partition to the other.
+ */
+class PointToPointPartitionLinkTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointPartitionLinkTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Send one packet of 1000 bytes to the device specified
+   *
+   * \param device NetDevice to send to
+   */
+  void SendOnePacket (Ptr<NetDevice> device);
+  /**
+   * \brief Record the reception of a packet
+   *
+   * \param device the receiving device
+   * \param p the packet
+   * \param protocol the protocol number
+   * \param from the sender address
+   * \returns true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from);
+
+  Time m_received; //!< The reception time of the packet
+};
+
+PointToPointPartitionLinkTest::PointToPointPartitionLinkTest ()
+  : TestCase ("PointToPointPartition link between two partitions")
+{
+}
+
+void
+PointToPointPartitionLinkTest::SendOnePacket (Ptr<NetDevice> device)
+{
+  device->Send (Create<Packet> (1000), device->GetBroadcast (), 0x800);
+}
+
+bool
+PointToPointPartitionLinkTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> p,
+                                        uint16_t protocol, const Address &from)
+{
+  m_received = Simulator::Now ();
+  return true;
+}
+
+void
+PointToPointPartitionLinkTest::DoRun (void)
+{
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::MultithreadedSimulatorImpl"));
+  MpiInterface::Enable (0, 0);
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("8Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("5ms"));
+  NetDeviceContainer devices = p2p.Install (nodes);
+
+  PointToPointPartitionHelper partition;
+  partition.Install (nodes, 2);
+  NS_TEST_ASSERT_MSG_EQ (partition.GetEdgeCut (), 1, "the link should be cut");
+  NS_TEST_ASSERT_MSG_NE (nodes.Get (0)->GetSystemId (), nodes.Get (1)->GetSystemId (),
+                         "nodes in the same partition");
+  Ptr<Channel> channel = devices.Get (0)->GetChannel ();
+  NS_TEST_ASSERT_MSG_NE (DynamicCast<PointToPointRemoteChannel> (channel), 0, "the link is not remote");
+  NS_TEST_ASSERT_MSG_EQ (devices.Get (1)->GetChannel (), channel, "the devices are not on the same channel");
+  TimeValue delay;
+  channel->GetAttribute ("Delay", delay);
+  NS_TEST_ASSERT_MSG_EQ (delay.Get (), MilliSeconds (5), "the delay of the link was not kept");
+
+  devices.Get (1)->SetReceiveCallback (MakeCallback (&PointToPointPartitionLinkTest::Receive, this));
+  Simulator::ScheduleWithContext (nodes.Get (0)->GetId (), Seconds (1),
+                                  &PointToPointPartitionLinkTest::SendOnePacket, this, devices.Get (0));
+  Simulator::Run ();
+  // 1002 bytes with the PPP header take 1.002 ms at 8 Mb/s
+  NS_TEST_ASSERT_MSG_EQ (m_received, Seconds (1) + MicroSeconds (1002) + MilliSeconds (5),
+                         "bad reception time");
+
+  Simulator::Destroy ();
+  MpiInterface::Disable ();
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -116,6 +298,8 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest, TestCase::QUICK);
+  AddTestCase (new PointToPointPartitionTest, TestCase::QUICK);
+  AddTestCase (new PointToPointPartitionLinkTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
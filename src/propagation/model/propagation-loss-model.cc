@@ -24,11 +24,13 @@
 #include "propagation-loss-model.h"
 #include "ns3/log.h"
 #include "ns3/mobility-model.h"
+#include "ns3/constant-position-mobility-model.h"
 #include "ns3/boolean.h"
 #include "ns3/double.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
 #include <cmath>
+#include <limits>
 
 namespace ns3 {
 
@@ -94,6 +96,45 @@ PropagationLossModel::AssignStreams (int64_t stream)
   return (currentStream - stream);
 }
 
+double
+PropagationLossModel::GetMaxRange (double txPowerDbm, double rxThresholdDbm) const
+{
+  NS_LOG_FUNCTION (this << txPowerDbm << rxThresholdDbm);
+  Ptr<ConstantPositionMobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<ConstantPositionMobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0, 0, 0));
+
+  // find a power of two beyond the range, then bisect
+  double near = 0;
+  double far = 1;
+  b->SetPosition (Vector (far, 0, 0));
+  while (CalcRxPower (txPowerDbm, a, b) >= rxThresholdDbm)
+    {
+      near = far;
+      far *= 2;
+      if (far > 1e9)
+        {
+          return std::numeric_limits<double>::infinity ();
+        }
+      b->SetPosition (Vector (far, 0, 0));
+    }
+  while (far - near > 1e-3)
+    {
+      double mid = (near + far) / 2;
+      b->SetPosition (Vector (mid, 0, 0));
+      if (CalcRxPower (txPowerDbm, a, b) >= rxThresholdDbm)
+        {
+          near = mid;
+        }
+      else
+        {
+          far = mid;
+        }
+    }
+  NS_LOG_DEBUG ("range " << far << "m for txPower=" << txPowerDbm << "dBm, threshold=" << rxThresholdDbm << "dBm");
+  return far;
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (RandomPropagationLossModel);
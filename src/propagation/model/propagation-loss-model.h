@@ -106,6 +106,24 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * Find the distance beyond which the reception power, taking into
+   * account all the chained models, falls below a threshold.
+   *
+   * The loss is evaluated along a straight line and the distance is
+   * found by bisection, so it is only meaningful when the loss does
+   * not decrease with distance. Models that draw random variables
+   * consume them here, and their range is a sample, not a bound: set
+   * the range explicitly instead when using such models.
+   *
+   * \param txPowerDbm the transmission power (in dBm)
+   * \param rxThresholdDbm the smallest reception power of interest (in dBm)
+   * \returns a distance (in meters) at which the reception power is
+   * below rxThresholdDbm, within 1 mm of the smallest such distance,
+   * or infinity if there is none within 1e9 meters
+   */
+  double GetMaxRange (double txPowerDbm, double rxThresholdDbm) const;
+
 private:
   /**
    * \brief Copy constructor
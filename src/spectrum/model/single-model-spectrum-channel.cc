@@ -21,6 +21,7 @@
 #include <ns3/object.h>
 #include <ns3/simulator.h>
 #include <ns3/log.h>
+#include <ns3/abort.h>
 #include <ns3/packet.h>
 #include <ns3/packet-burst.h>
 #include <ns3/net-device.h>
@@ -45,6 +46,7 @@ NS_LOG_COMPONENT_DEFINE ("SingleModelSpectrumChannel");
 NS_OBJECT_ENSURE_REGISTERED (SingleModelSpectrumChannel);
 
 SingleModelSpectrumChannel::SingleModelSpectrumChannel ()
+  : m_maxRange (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -54,6 +56,7 @@ SingleModelSpectrumChannel::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
   m_phyList.clear ();
+  m_index.Clear ();
   m_spectrumModel = 0;
   m_propagationDelay = 0;
   m_propagationLoss = 0;
@@ -83,6 +86,18 @@ SingleModelSpectrumChannel::GetTypeId (void)
                    DoubleValue (1.0e9),
                    MakeDoubleAccessor (&SingleModelSpectrumChannel::m_maxLossDb),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxRange",
+                   "The distance in meters beyond which signals are not "
+                   "passed to the receiving PHY. Receivers out of range "
+                   "get no StartRx event and no PathLoss trace, and are "
+                   "found through a spatial index without visiting every "
+                   "PHY on the channel; every PHY must then have a "
+                   "MobilityModel. PropagationLossModel::GetMaxRange gives "
+                   "the distance matching a given loss. The default value "
+                   "corresponds to considering all signals for reception.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&SingleModelSpectrumChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0))
     .AddTraceSource ("PathLoss",
                      "This trace is fired whenever a new path loss value "
                      "is calculated. The first and second parameters "
@@ -134,12 +149,32 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
   Ptr<MobilityModel> senderMobility = txParams->txPhy->GetMobility ();
 
-  for (PhyList::const_iterator rxPhyIterator = m_phyList.begin ();
-       rxPhyIterator != m_phyList.end ();
-       ++rxPhyIterator)
+  bool bounded = m_maxRange > 0 && senderMobility != 0;
+  if (bounded)
     {
+      if (m_index.GetN () != m_phyList.size ())
+        {
+          m_index.Clear ();
+          m_index.SetCellSize (m_maxRange);
+          for (PhyList::const_iterator it = m_phyList.begin (); it != m_phyList.end (); ++it)
+            {
+              Ptr<MobilityModel> mobility = (*it)->GetMobility ();
+              NS_ABORT_MSG_IF (mobility == 0, "MaxRange requires every SpectrumPhy to have a MobilityModel");
+              m_index.Add (mobility);
+            }
+        }
+      m_index.GetCandidates (senderMobility->GetPosition (), m_maxRange, m_candidates);
+    }
+  uint32_t n = bounded ? m_candidates.size () : m_phyList.size ();
+  for (uint32_t k = 0; k < n; k++)
+    {
+      PhyList::const_iterator rxPhyIterator = m_phyList.begin () + (bounded ? m_candidates[k] : k);
       if ((*rxPhyIterator) != txParams->txPhy)
         {
+          if (bounded && senderMobility->GetDistanceFrom ((*rxPhyIterator)->GetMobility ()) > m_maxRange)
+            {
+              continue;
+            }
           Time delay  = MicroSeconds (0);
 
           Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
@@ -25,6 +25,7 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-model.h>
 #include <ns3/traced-callback.h>
+#include <ns3/spatial-index.h>
 
 namespace ns3 {
 
@@ -116,6 +117,22 @@ private:
    */
   double m_maxLossDb;
 
+  /**
+   * Maximum distance [m] at which signals are delivered, 0 if none.
+   */
+  double m_maxRange;
+
+  /**
+   * Grid over the positions of the PHYs in m_phyList, used when
+   * m_maxRange is set.
+   */
+  SpatialIndex m_index;
+
+  /**
+   * Scratch list of the indices in m_phyList of the PHYs in range.
+   */
+  std::vector<uint32_t> m_candidates;
+
   /**
    * \deprecated The non-const \c Ptr<SpectrumPhy> argument
    * is deprecated and will be changed to \c Ptr<const SpectrumPhy>
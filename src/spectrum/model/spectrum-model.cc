@@ -68,6 +68,7 @@ SpectrumModel::SpectrumModel (std::vector<double> centerFreqs)
         }
       m_bands.push_back (e);
     }
+  InitBandWidths ();
 }
 
 SpectrumModel::SpectrumModel (Bands bands)
@@ -75,6 +76,23 @@ SpectrumModel::SpectrumModel (Bands bands)
   m_uid = ++m_uidCount;
   NS_LOG_INFO ("creating new SpectrumModel, m_uid=" << m_uid);
   m_bands = bands;
+  InitBandWidths ();
+}
+
+void
+SpectrumModel::InitBandWidths ()
+{
+  m_bandWidths.reserve (m_bands.size ());
+  for (Bands::const_iterator it = m_bands.begin (); it != m_bands.end (); ++it)
+    {
+      m_bandWidths.push_back (it->fh - it->fl);
+    }
+}
+
+const std::vector<double>&
+SpectrumModel::GetBandWidths () const
+{
+  return m_bandWidths;
 }
 
 Bands::const_iterator
@@ -119,9 +119,22 @@ public:
    * Const Iterator to the model Bands container end.
    */
   Bands::const_iterator End () const;
+  /**
+   * The width (fh - fl) of every band, in the same order as the bands.
+   * Precomputed at construction so that Integral () runs as a single
+   * dot product.
+   * @return a const reference to the band widths
+   */
+  const std::vector<double>& GetBandWidths () const;
 
 private:
+  /**
+   * Fill m_bandWidths from m_bands.
+   */
+  void InitBandWidths ();
+
   Bands m_bands;         //!< Actual definition of frequency bands within this SpectrumModel
+  std::vector<double> m_bandWidths; //!< fh - fl of every band in m_bands
   SpectrumModelUid_t m_uid;        //!< unique id for a given set of frequencies
   static SpectrumModelUid_t m_uidCount;    //!< counter to assign m_uids
 };
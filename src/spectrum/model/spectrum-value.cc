@@ -23,6 +23,9 @@
 #include <ns3/math.h>
 #include <ns3/log.h>
 
+#include <algorithm>
+#include <utility>
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("SpectrumValue");
@@ -103,20 +106,28 @@ SpectrumValue::ConstBandsEnd () const
 }
 
 
+/*
+ * The element-wise kernels below walk the raw storage of m_values with
+ * an index rather than with iterators and a per-element assertion, so
+ * that the loops have a known trip count and no side exits: this lets
+ * the compiler vectorize them (the common LTE sizes, 6 to 100 RBs, are
+ * handled with packed double arithmetic). Each element is still
+ * computed with exactly one IEEE operation, so the results are
+ * bit-identical to the scalar code. The reductions (Norm, Sum, Prod,
+ * Integral) keep the sequential summation order for the same reason.
+ */
+
 void
 SpectrumValue::Add (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  double *v = m_values.data ();
+  const double *w = x.m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; ++i)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 += *it2;
-      ++it1;
-      ++it2;
+      v[i] += w[i];
     }
 }
 
@@ -124,12 +135,11 @@ SpectrumValue::Add (const SpectrumValue& x)
 void
 SpectrumValue::Add (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; ++i)
     {
-      *it1 += s;
-      ++it1;
+      v[i] += s;
     }
 }
 
@@ -138,17 +148,14 @@ SpectrumValue::Add (double s)
 void
 SpectrumValue::Subtract (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  double *v = m_values.data ();
+  const double *w = x.m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; ++i)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 -= *it2;
-      ++it1;
-      ++it2;
+      v[i] -= w[i];
     }
 }
 
@@ -160,21 +167,32 @@ SpectrumValue::Subtract (double s)
 }
 
 
+void
+SpectrumValue::SubtractFrom (const SpectrumValue& x)
+{
+  NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  double *v = m_values.data ();
+  const double *w = x.m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; ++i)
+    {
+      v[i] = w[i] - v[i];
+    }
+}
+
 
 void
 SpectrumValue::Multiply (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  double *v = m_values.data ();
+  const double *w = x.m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; ++i)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 *= *it2;
-      ++it1;
-      ++it2;
+      v[i] *= w[i];
     }
 }
 
@@ -182,12 +200,11 @@ SpectrumValue::Multiply (const SpectrumValue& x)
 void
 SpectrumValue::Multiply (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; ++i)
     {
-      *it1 *= s;
-      ++it1;
+      v[i] *= s;
     }
 }
 
@@ -197,17 +214,14 @@ SpectrumValue::Multiply (double s)
 void
 SpectrumValue::Divide (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  double *v = m_values.data ();
+  const double *w = x.m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; ++i)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 /= *it2;
-      ++it1;
-      ++it2;
+      v[i] /= w[i];
     }
 }
 
@@ -216,12 +230,11 @@ void
 SpectrumValue::Divide (double s)
 {
   NS_LOG_FUNCTION (this << s);
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; ++i)
     {
-      *it1 /= s;
-      ++it1;
+      v[i] /= s;
     }
 }
 
@@ -231,12 +244,11 @@ SpectrumValue::Divide (double s)
 void
 SpectrumValue::ChangeSign ()
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; ++i)
     {
-      *it1 = -(*it1);
-      ++it1;
+      v[i] = -v[i];
     }
 }
 
@@ -348,11 +360,11 @@ double
 Norm (const SpectrumValue& x)
 {
   double s = 0;
-  Values::const_iterator it1 = x.ConstValuesBegin ();
-  while (it1 != x.ConstValuesEnd ())
+  const double *v = x.m_values.data ();
+  const size_t n = x.m_values.size ();
+  for (size_t i = 0; i < n; ++i)
     {
-      s += (*it1) * (*it1);
-      ++it1;
+      s += v[i] * v[i];
     }
   return std::sqrt (s);
 }
@@ -362,11 +374,11 @@ double
 Sum (const SpectrumValue& x)
 {
   double s = 0;
-  Values::const_iterator it1 = x.ConstValuesBegin ();
-  while (it1 != x.ConstValuesEnd ())
+  const double *v = x.m_values.data ();
+  const size_t n = x.m_values.size ();
+  for (size_t i = 0; i < n; ++i)
     {
-      s += (*it1);
-      ++it1;
+      s += v[i];
     }
   return s;
 }
@@ -376,12 +388,12 @@ Sum (const SpectrumValue& x)
 double
 Prod (const SpectrumValue& x)
 {
-  double s = 0;
-  Values::const_iterator it1 = x.ConstValuesBegin ();
-  while (it1 != x.ConstValuesEnd ())
+  double s = 1;
+  const double *v = x.m_values.data ();
+  const size_t n = x.m_values.size ();
+  for (size_t i = 0; i < n; ++i)
     {
-      s *= (*it1);
-      ++it1;
+      s *= v[i];
     }
   return s;
 }
@@ -389,17 +401,16 @@ Prod (const SpectrumValue& x)
 double
 Integral (const SpectrumValue& arg)
 {
+  const std::vector<double>& widths = arg.m_spectrumModel->GetBandWidths ();
+  NS_ASSERT (widths.size () == arg.m_values.size ());
   double i = 0;
-  Values::const_iterator vit = arg.ConstValuesBegin ();
-  Bands::const_iterator bit = arg.ConstBandsBegin ();
-  while (vit != arg.ConstValuesEnd ())
+  const double *v = arg.m_values.data ();
+  const double *w = widths.data ();
+  const size_t n = arg.m_values.size ();
+  for (size_t k = 0; k < n; ++k)
     {
-      NS_ASSERT (bit != arg.ConstBandsEnd ());
-      i += (*vit) * (bit->fh - bit->fl);
-      ++vit;
-      ++bit;
+      i += v[k] * w[k];
     }
-  NS_ASSERT (bit == arg.ConstBandsEnd ());
   return i;
 }
 
@@ -467,9 +478,8 @@ operator+ (double lhs, const SpectrumValue& rhs)
 SpectrumValue
 operator- (const SpectrumValue& lhs, const SpectrumValue& rhs)
 {
-  SpectrumValue res = rhs;
-  res.ChangeSign ();
-  res.Add (lhs);
+  SpectrumValue res = lhs;
+  res.Subtract (rhs);
   return res;
 }
 
@@ -561,6 +571,133 @@ operator- (const SpectrumValue& rhs)
 }
 
 
+SpectrumValue
+operator+ (SpectrumValue&& lhs, const SpectrumValue& rhs)
+{
+  lhs.Add (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator+ (const SpectrumValue& lhs, SpectrumValue&& rhs)
+{
+  rhs.Add (lhs);
+  return std::move (rhs);
+}
+
+SpectrumValue
+operator+ (SpectrumValue&& lhs, SpectrumValue&& rhs)
+{
+  lhs.Add (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator+ (SpectrumValue&& lhs, double rhs)
+{
+  lhs.Add (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator+ (double lhs, SpectrumValue&& rhs)
+{
+  rhs.Add (lhs);
+  return std::move (rhs);
+}
+
+SpectrumValue
+operator- (SpectrumValue&& lhs, const SpectrumValue& rhs)
+{
+  lhs.Subtract (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator- (const SpectrumValue& lhs, SpectrumValue&& rhs)
+{
+  rhs.SubtractFrom (lhs);
+  return std::move (rhs);
+}
+
+SpectrumValue
+operator- (SpectrumValue&& lhs, SpectrumValue&& rhs)
+{
+  lhs.Subtract (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator- (SpectrumValue&& lhs, double rhs)
+{
+  lhs.Subtract (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator* (SpectrumValue&& lhs, const SpectrumValue& rhs)
+{
+  lhs.Multiply (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator* (const SpectrumValue& lhs, SpectrumValue&& rhs)
+{
+  rhs.Multiply (lhs);
+  return std::move (rhs);
+}
+
+SpectrumValue
+operator* (SpectrumValue&& lhs, SpectrumValue&& rhs)
+{
+  lhs.Multiply (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator* (SpectrumValue&& lhs, double rhs)
+{
+  lhs.Multiply (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator* (double lhs, SpectrumValue&& rhs)
+{
+  rhs.Multiply (lhs);
+  return std::move (rhs);
+}
+
+SpectrumValue
+operator/ (SpectrumValue&& lhs, const SpectrumValue& rhs)
+{
+  lhs.Divide (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator/ (SpectrumValue&& lhs, SpectrumValue&& rhs)
+{
+  lhs.Divide (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator/ (SpectrumValue&& lhs, double rhs)
+{
+  lhs.Divide (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator- (SpectrumValue&& rhs)
+{
+  rhs.ChangeSign ();
+  return std::move (rhs);
+}
+
+
 SpectrumValue
 Pow (double lhs, const SpectrumValue& rhs)
 {
@@ -664,13 +801,7 @@ SpectrumValue::operator/= (double rhs)
 SpectrumValue&
 SpectrumValue::operator= (double rhs)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
-    {
-      *it1 = rhs;
-      ++it1;
-    }
+  std::fill (m_values.begin (), m_values.end (), rhs);
   return *this;
 }
 
@@ -297,6 +297,41 @@ public:
    */
   friend SpectrumValue operator- (const SpectrumValue& rhs);
 
+  /**
+   * \name Operators on temporaries
+   *
+   * These overloads are selected when one operand is an rvalue, as
+   * happens for every intermediate result of a chained expression such
+   * as <tt>a - b + c</tt>. The operation is applied in place on the
+   * storage of the temporary and the result is moved out, so a chain of
+   * N operations allocates a single Values vector instead of N.
+   * The results are identical to those of the const-reference overloads.
+   *
+   * @param lhs Left Hand Side of the operator
+   * @param rhs Right Hand Side of the operator
+   * @return the value of the operation
+   * @{
+   */
+  friend SpectrumValue operator+ (SpectrumValue&& lhs, const SpectrumValue& rhs);
+  friend SpectrumValue operator+ (const SpectrumValue& lhs, SpectrumValue&& rhs);
+  friend SpectrumValue operator+ (SpectrumValue&& lhs, SpectrumValue&& rhs);
+  friend SpectrumValue operator+ (SpectrumValue&& lhs, double rhs);
+  friend SpectrumValue operator+ (double lhs, SpectrumValue&& rhs);
+  friend SpectrumValue operator- (SpectrumValue&& lhs, const SpectrumValue& rhs);
+  friend SpectrumValue operator- (const SpectrumValue& lhs, SpectrumValue&& rhs);
+  friend SpectrumValue operator- (SpectrumValue&& lhs, SpectrumValue&& rhs);
+  friend SpectrumValue operator- (SpectrumValue&& lhs, double rhs);
+  friend SpectrumValue operator* (SpectrumValue&& lhs, const SpectrumValue& rhs);
+  friend SpectrumValue operator* (const SpectrumValue& lhs, SpectrumValue&& rhs);
+  friend SpectrumValue operator* (SpectrumValue&& lhs, SpectrumValue&& rhs);
+  friend SpectrumValue operator* (SpectrumValue&& lhs, double rhs);
+  friend SpectrumValue operator* (double lhs, SpectrumValue&& rhs);
+  friend SpectrumValue operator/ (SpectrumValue&& lhs, const SpectrumValue& rhs);
+  friend SpectrumValue operator/ (SpectrumValue&& lhs, SpectrumValue&& rhs);
+  friend SpectrumValue operator/ (SpectrumValue&& lhs, double rhs);
+  friend SpectrumValue operator- (SpectrumValue&& rhs);
+  /**@}*/
+
 
   /**
    * left shift operator
@@ -535,6 +570,12 @@ private:
    * \param s flat value
    */
   void Subtract (double s);
+  /**
+   * Replace each element with the corresponding element of x minus
+   * itself, i.e., *this = x - *this.
+   * @param x operand
+   */
+  void SubtractFrom (const SpectrumValue& x);
   /**
    * Multiplies for a SpectrumValue (element to element multiplication)
    * \param x SpectrumValue
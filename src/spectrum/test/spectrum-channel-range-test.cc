@@ -0,0 +1,290 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/core-module.h>
+#include <ns3/test.h>
+#include <ns3/spectrum-module.h>
+#include <ns3/mobility-module.h>
+
+
+NS_LOG_COMPONENT_DEFINE ("SpectrumChannelRangeTest");
+
+using namespace ns3;
+
+
+/**
+ * A SpectrumPhy counting the signals it receives.
+ */
+class RangeTestSpectrumPhy : public SpectrumPhy
+{
+public:
+  RangeTestSpectrumPhy (Ptr<const SpectrumModel> model);
+
+  // inherited from SpectrumPhy
+  virtual void SetDevice (Ptr<NetDevice> d);
+  virtual Ptr<NetDevice> GetDevice () const;
+  virtual void SetMobility (Ptr<MobilityModel> m);
+  virtual Ptr<MobilityModel> GetMobility ();
+  virtual void SetChannel (Ptr<SpectrumChannel> c);
+  virtual Ptr<const SpectrumModel> GetRxSpectrumModel () const;
+  virtual Ptr<AntennaModel> GetRxAntenna ();
+  virtual void StartRx (Ptr<SpectrumSignalParameters> params);
+
+  uint32_t m_rxCount; //!< The signals received so far
+
+private:
+  virtual void DoDispose (void);
+
+  Ptr<const SpectrumModel> m_model; //!< The model of the signals received
+  Ptr<MobilityModel> m_mobility;    //!< The position of the PHY
+};
+
+RangeTestSpectrumPhy::RangeTestSpectrumPhy (Ptr<const SpectrumModel> model)
+  : m_rxCount (0),
+    m_model (model)
+{
+}
+
+void
+RangeTestSpectrumPhy::DoDispose (void)
+{
+  m_model = 0;
+  m_mobility = 0;
+  SpectrumPhy::DoDispose ();
+}
+
+void
+RangeTestSpectrumPhy::SetDevice (Ptr<NetDevice> d)
+{
+}
+
+Ptr<NetDevice>
+RangeTestSpectrumPhy::GetDevice () const
+{
+  return 0;
+}
+
+void
+RangeTestSpectrumPhy::SetMobility (Ptr<MobilityModel> m)
+{
+  m_mobility = m;
+}
+
+Ptr<MobilityModel>
+RangeTestSpectrumPhy::GetMobility ()
+{
+  return m_mobility;
+}
+
+void
+RangeTestSpectrumPhy::SetChannel (Ptr<SpectrumChannel> c)
+{
+}
+
+Ptr<const SpectrumModel>
+RangeTestSpectrumPhy::GetRxSpectrumModel () const
+{
+  return m_model;
+}
+
+Ptr<AntennaModel>
+RangeTestSpectrumPhy::GetRxAntenna ()
+{
+  return 0;
+}
+
+void
+RangeTestSpectrumPhy::StartRx (Ptr<SpectrumSignalParameters> params)
+{
+  m_rxCount++;
+}
+
+
+/**
+ * Check that a SingleModelSpectrumChannel with a MaxRange starts the
+ * reception on exactly the PHYs that a scan of every PHY with the same
+ * cutoff distance finds, while some PHYs move at a constant velocity and
+ * others jump to new positions.
+ */
+class SpectrumChannelRangeTestCase : public TestCase
+{
+public:
+  SpectrumChannelRangeTestCase ();
+  virtual ~SpectrumChannelRangeTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Send a signal from a PHY drawn at random, and schedule the check of
+   * its receivers.
+   */
+  void Transmit (void);
+  /**
+   * Check the receivers of the last signal against the expected ones.
+   */
+  void Check (void);
+  /**
+   * Move a PHY with a constant position to a position drawn at random.
+   */
+  void Jump (void);
+
+  Ptr<SingleModelSpectrumChannel> m_channel;          //!< The channel
+  Ptr<const SpectrumModel> m_model;                   //!< The model of the signals
+  std::vector<Ptr<RangeTestSpectrumPhy> > m_phys;     //!< The PHYs on the channel
+  std::vector<Ptr<ConstantPositionMobilityModel> > m_fixed; //!< The PHYs which jump
+  std::vector<bool> m_expected;                       //!< The expected receivers of the last signal
+  Ptr<UniformRandomVariable> m_random;                //!< The draws of senders and positions
+  double m_range;                                     //!< The cutoff distance
+  uint32_t m_inRange;                                 //!< The receptions expected so far
+  uint32_t m_outOfRange;                              //!< The receptions not expected so far
+};
+
+SpectrumChannelRangeTestCase::SpectrumChannelRangeTestCase ()
+  : TestCase ("Check the receivers of a SingleModelSpectrumChannel with a MaxRange"),
+    m_range (60),
+    m_inRange (0),
+    m_outOfRange (0)
+{
+}
+
+SpectrumChannelRangeTestCase::~SpectrumChannelRangeTestCase ()
+{
+}
+
+void
+SpectrumChannelRangeTestCase::Transmit (void)
+{
+  uint32_t sender = m_random->GetInteger (0, m_phys.size () - 1);
+  Ptr<MobilityModel> senderMobility = m_phys[sender]->GetMobility ();
+  for (uint32_t i = 0; i < m_phys.size (); i++)
+    {
+      m_phys[i]->m_rxCount = 0;
+      m_expected[i] = i != sender
+        && senderMobility->GetDistanceFrom (m_phys[i]->GetMobility ()) <= m_range;
+      if (i != sender)
+        {
+          m_inRange += m_expected[i] ? 1 : 0;
+          m_outOfRange += m_expected[i] ? 0 : 1;
+        }
+    }
+
+  Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+  params->psd = Create<SpectrumValue> (m_model);
+  (*params->psd) = 1e-9;
+  params->duration = MicroSeconds (100);
+  params->txPhy = m_phys[sender];
+  m_channel->StartTx (params);
+  Simulator::Schedule (MilliSeconds (1), &SpectrumChannelRangeTestCase::Check, this);
+}
+
+void
+SpectrumChannelRangeTestCase::Check (void)
+{
+  for (uint32_t i = 0; i < m_phys.size (); i++)
+    {
+      uint32_t expected = m_expected[i] ? 1 : 0;
+      NS_TEST_ASSERT_MSG_EQ (m_phys[i]->m_rxCount, expected,
+                             "PHY " << i << " at " << Simulator::Now ().GetSeconds () << "s");
+    }
+}
+
+void
+SpectrumChannelRangeTestCase::Jump (void)
+{
+  Ptr<ConstantPositionMobilityModel> mobility = m_fixed[m_random->GetInteger (0, m_fixed.size () - 1)];
+  mobility->SetPosition (Vector (m_random->GetValue (0, 300), m_random->GetValue (0, 300), 0));
+}
+
+void
+SpectrumChannelRangeTestCase::DoRun (void)
+{
+  std::vector<double> frequencies;
+  frequencies.push_back (2.4e9);
+  frequencies.push_back (2.41e9);
+  m_model = Create<SpectrumModel> (frequencies);
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_random->SetStream (1);
+
+  m_channel = CreateObject<SingleModelSpectrumChannel> ();
+  m_channel->SetAttribute ("MaxRange", DoubleValue (m_range));
+  m_channel->AddPropagationLossModel (CreateObject<FriisPropagationLossModel> ());
+  m_channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  for (uint32_t i = 0; i < 60; i++)
+    {
+      Ptr<MobilityModel> mobility;
+      Vector position (m_random->GetValue (0, 300), m_random->GetValue (0, 300), 0);
+      if (i % 2 == 0)
+        {
+          Ptr<ConstantPositionMobilityModel> fixed = CreateObject<ConstantPositionMobilityModel> ();
+          m_fixed.push_back (fixed);
+          mobility = fixed;
+        }
+      else
+        {
+          Ptr<ConstantVelocityMobilityModel> moving = CreateObject<ConstantVelocityMobilityModel> ();
+          moving->SetVelocity (Vector (m_random->GetValue (-30, 30), m_random->GetValue (-30, 30), 0));
+          mobility = moving;
+        }
+      mobility->SetPosition (position);
+      Ptr<RangeTestSpectrumPhy> phy = CreateObject<RangeTestSpectrumPhy> (m_model);
+      phy->SetMobility (mobility);
+      m_channel->AddRx (phy);
+      m_phys.push_back (phy);
+    }
+  m_expected.resize (m_phys.size ());
+
+  for (uint32_t i = 0; i < 300; i++)
+    {
+      Simulator::Schedule (MilliSeconds (10 * i + 5), &SpectrumChannelRangeTestCase::Transmit, this);
+      if (i % 5 == 0)
+        {
+          Simulator::Schedule (MilliSeconds (10 * i), &SpectrumChannelRangeTestCase::Jump, this);
+        }
+    }
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_GT (m_inRange, 0, "No PHY in range");
+  NS_TEST_ASSERT_MSG_GT (m_outOfRange, 0, "No PHY out of range");
+
+  for (uint32_t i = 0; i < m_phys.size (); i++)
+    {
+      m_phys[i]->Dispose ();
+    }
+  m_phys.clear ();
+  m_fixed.clear ();
+  m_channel->Dispose ();
+  m_channel = 0;
+  Simulator::Destroy ();
+}
+
+
+/**
+ * The test suite of the range of the spectrum channels.
+ */
+class SpectrumChannelRangeTestSuite : public TestSuite
+{
+public:
+  SpectrumChannelRangeTestSuite ();
+};
+
+SpectrumChannelRangeTestSuite::SpectrumChannelRangeTestSuite ()
+  : TestSuite ("spectrum-channel-range", UNIT)
+{
+  AddTestCase (new SpectrumChannelRangeTestCase, TestCase::QUICK);
+}
+
+static SpectrumChannelRangeTestSuite g_spectrumChannelRangeTestSuite;
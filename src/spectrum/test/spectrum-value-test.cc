@@ -25,6 +25,7 @@
 #include <ns3/test.h>
 #include <iostream>
 #include <cmath>
+#include <utility>
 
 #include "spectrum-test.h"
 
@@ -242,6 +243,50 @@ SpectrumValueTestSuite::SpectrumValueTestSuite ()
   AddTestCase (new SpectrumValueTestCase (tv1rs3, v1rs3, "tv1rs3 = v1 >> 3"), TestCase::QUICK);
 
 
+  // the operators on temporaries, which work in place
+  SpectrumValue tv3r (f), tv4r (f), tv4l (f), tv5r (f), tv6r (f);
+  tv3r = v1 + SpectrumValue (v2);
+  tv4r = SpectrumValue (v1) - v2;
+  tv4l = v1 - SpectrumValue (v2);
+  tv5r = SpectrumValue (v1) * SpectrumValue (v2);
+  tv6r = SpectrumValue (v1) / SpectrumValue (v2);
+  AddTestCase (new SpectrumValueTestCase (tv3r, v3, "tv3r = v1 + temporary v2"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv4r, v4, "tv4r = temporary v1 - v2"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv4l, v4, "tv4l = v1 - temporary v2"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv5r, v5, "tv5r = temporary v1 * temporary v2"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv6r, v6, "tv6r = temporary v1 div temporary v2"), TestCase::QUICK);
+
+  SpectrumValue tv7r (f), tv8r (f), tv9r (f), tv10r (f), tv8n (f);
+  tv7r = doubleValue + SpectrumValue (v1);
+  tv8r = SpectrumValue (v1) - doubleValue;
+  tv9r = doubleValue * SpectrumValue (v1);
+  tv10r = SpectrumValue (v1) / doubleValue;
+  tv8n = -SpectrumValue (v8);
+  AddTestCase (new SpectrumValueTestCase (tv7r, v7, "tv7r = doubleValue + temporary v1"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv8r, v8, "tv8r = temporary v1 - doubleValue"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv9r, v9, "tv9r = doubleValue * temporary v1"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv10r, v10, "tv10r = temporary v1 div doubleValue"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv8n, v8 * (-1.0), "tv8n = - temporary v8"), TestCase::QUICK);
+
+  // a value moved into an operator along with itself or into its own result
+  SpectrumValue tv3a (v1), tv4a (v2), tv5a (v1), tv11a (v1);
+  tv3a = std::move (tv3a) + v2;
+  tv4a = v1 - std::move (tv4a);
+  tv5a = std::move (tv5a) * v2;
+  tv11a = std::move (tv11a) + std::move (tv11a);
+  AddTestCase (new SpectrumValueTestCase (tv3a, v3, "tv3a = moved tv3a + v2"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv4a, v4, "tv4a = v1 - moved tv4a"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv5a, v5, "tv5a = moved tv5a * v2"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv11a, 2 * v1, "tv11a = moved tv11a + moved tv11a"), TestCase::QUICK);
+
+  // the product of the elements starts from one
+  SpectrumValue v11 (f), v12 (f), tv11 (f), tv12 (f);
+  v11 = 0.256594914520;
+  v12 = 1;
+  tv11 = Prod (v1);
+  tv12 = Prod (v12);
+  AddTestCase (new SpectrumValueTestCase (tv11, v11, "tv11 = Prod (v1)"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv12, v12, "tv12 = Prod (ones)"), TestCase::QUICK);
 }
 
 
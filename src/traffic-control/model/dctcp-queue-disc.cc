@@ -0,0 +1,277 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/log.h"
+#include "ns3/enum.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/simulator.h"
+#include "ns3/drop-tail-queue.h"
+#include "dctcp-queue-disc.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("DctcpQueueDisc");
+
+NS_OBJECT_ENSURE_REGISTERED (DctcpQueueDisc);
+
+TypeId DctcpQueueDisc::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::DctcpQueueDisc")
+    .SetParent<QueueDisc> ()
+    .SetGroupName ("TrafficControl")
+    .AddConstructor<DctcpQueueDisc> ()
+    .AddAttribute ("Mode",
+                   "Determines unit for QueueLimit and MarkingThreshold",
+                   EnumValue (Queue::QUEUE_MODE_PACKETS),
+                   MakeEnumAccessor (&DctcpQueueDisc::m_mode),
+                   MakeEnumChecker (Queue::QUEUE_MODE_BYTES, "QUEUE_MODE_BYTES",
+                                    Queue::QUEUE_MODE_PACKETS, "QUEUE_MODE_PACKETS"))
+    .AddAttribute ("QueueLimit",
+                   "Queue limit in bytes/packets",
+                   UintegerValue (1000),
+                   MakeUintegerAccessor (&DctcpQueueDisc::m_queueLimit),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("MarkingThreshold",
+                   "Queue length in bytes/packets from which packets are marked (K)",
+                   UintegerValue (65),
+                   MakeUintegerAccessor (&DctcpQueueDisc::m_threshold),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("MarkOnDequeue",
+                   "True to check the queue length when packets are dequeued",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&DctcpQueueDisc::m_markOnDequeue),
+                   MakeBooleanChecker ())
+    .AddAttribute ("SojournThreshold",
+                   "Sojourn time from which packets are marked when dequeued, "
+                   "instead of the queue length; zero disables it",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&DctcpQueueDisc::m_sojournThreshold),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+DctcpQueueDisc::DctcpQueueDisc ()
+  : QueueDisc (),
+    m_sojournSteps (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_stats.qLimDrop = 0;
+  m_stats.marks = 0;
+  m_stats.unmarkable = 0;
+}
+
+DctcpQueueDisc::~DctcpQueueDisc ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+DctcpQueueDisc::Stats
+DctcpQueueDisc::GetStats (void)
+{
+  NS_LOG_FUNCTION (this);
+  return m_stats;
+}
+
+uint32_t
+DctcpQueueDisc::GetQueueSize (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_mode == Queue::QUEUE_MODE_PACKETS)
+    {
+      return GetInternalQueue (0)->GetNPackets ();
+    }
+  return GetInternalQueue (0)->GetNBytes ();
+}
+
+void
+DctcpQueueDisc::MarkPacket (Ptr<QueueDiscItem> item)
+{
+  if (item->Mark ())
+    {
+      NS_LOG_LOGIC ("Marking " << item);
+      m_stats.marks++;
+    }
+  else
+    {
+      NS_LOG_LOGIC ("Cannot mark " << item);
+      m_stats.unmarkable++;
+    }
+}
+
+bool
+DctcpQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+
+  uint32_t nQueued = GetQueueSize ();
+
+  if ((m_mode == Queue::QUEUE_MODE_PACKETS && nQueued >= m_queueLimit) ||
+      (m_mode == Queue::QUEUE_MODE_BYTES && nQueued + item->GetPacketSize () > m_queueLimit))
+    {
+      NS_LOG_LOGIC ("Queue full -- dropping packet");
+      m_stats.qLimDrop++;
+      Drop (item);
+      return false;
+    }
+
+  if (!m_markOnDequeue && m_sojournSteps == 0 && nQueued >= m_threshold)
+    {
+      MarkPacket (item);
+    }
+
+  bool retval = GetInternalQueue (0)->Enqueue (item);
+
+  // If Queue::Enqueue fails, QueueDisc::Drop is called by the internal queue
+  // because QueueDisc::AddInternalQueue sets the drop callback
+  if (!retval)
+    {
+      m_stats.qLimDrop++;
+    }
+  else if (m_sojournSteps != 0)
+    {
+      m_enqueueTimes.push_back (Simulator::Now ().GetTimeStep ());
+    }
+
+  NS_LOG_LOGIC ("Number packets " << GetInternalQueue (0)->GetNPackets ());
+  NS_LOG_LOGIC ("Number bytes " << GetInternalQueue (0)->GetNBytes ());
+
+  return retval;
+}
+
+Ptr<QueueDiscItem>
+DctcpQueueDisc::DoDequeue (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Ptr<QueueDiscItem> item = StaticCast<QueueDiscItem> (GetInternalQueue (0)->Dequeue ());
+  if (item == 0)
+    {
+      NS_LOG_LOGIC ("Queue empty");
+      return 0;
+    }
+
+  if (m_sojournSteps != 0)
+    {
+      NS_ASSERT (!m_enqueueTimes.empty ());
+      int64_t sojourn = Simulator::Now ().GetTimeStep () - m_enqueueTimes.front ();
+      m_enqueueTimes.pop_front ();
+      if (sojourn >= m_sojournSteps)
+        {
+          MarkPacket (item);
+        }
+    }
+  else if (m_markOnDequeue && GetQueueSize () >= m_threshold)
+    {
+      MarkPacket (item);
+    }
+
+  NS_LOG_LOGIC ("Popped " << item);
+  NS_LOG_LOGIC ("Number packets " << GetInternalQueue (0)->GetNPackets ());
+  NS_LOG_LOGIC ("Number bytes " << GetInternalQueue (0)->GetNBytes ());
+
+  return item;
+}
+
+Ptr<const QueueDiscItem>
+DctcpQueueDisc::DoPeek (void) const
+{
+  NS_LOG_FUNCTION (this);
+  if (GetInternalQueue (0)->IsEmpty ())
+    {
+      NS_LOG_LOGIC ("Queue empty");
+      return 0;
+    }
+
+  Ptr<const QueueDiscItem> item = StaticCast<const QueueDiscItem> (GetInternalQueue (0)->Peek ());
+
+  NS_LOG_LOGIC ("Number packets " << GetInternalQueue (0)->GetNPackets ());
+  NS_LOG_LOGIC ("Number bytes " << GetInternalQueue (0)->GetNBytes ());
+
+  return item;
+}
+
+bool
+DctcpQueueDisc::CheckConfig (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (GetNQueueDiscClasses () > 0)
+    {
+      NS_LOG_ERROR ("DctcpQueueDisc cannot have classes");
+      return false;
+    }
+
+  if (GetNPacketFilters () > 0)
+    {
+      NS_LOG_ERROR ("DctcpQueueDisc cannot have packet filters");
+      return false;
+    }
+
+  if (GetNInternalQueues () == 0)
+    {
+      // create a DropTail queue
+      Ptr<Queue> queue = CreateObjectWithAttributes<DropTailQueue> ("Mode", EnumValue (m_mode));
+      if (m_mode == Queue::QUEUE_MODE_PACKETS)
+        {
+          queue->SetMaxPackets (m_queueLimit);
+        }
+      else
+        {
+          queue->SetMaxBytes (m_queueLimit);
+        }
+      AddInternalQueue (queue);
+    }
+
+  if (GetNInternalQueues () != 1)
+    {
+      NS_LOG_ERROR ("DctcpQueueDisc needs 1 internal queue");
+      return false;
+    }
+
+  if (GetInternalQueue (0)->GetMode () != m_mode)
+    {
+      NS_LOG_ERROR ("The mode of the provided queue does not match the mode set on the DctcpQueueDisc");
+      return false;
+    }
+
+  if ((m_mode ==  Queue::QUEUE_MODE_PACKETS && GetInternalQueue (0)->GetMaxPackets () < m_queueLimit) ||
+      (m_mode ==  Queue::QUEUE_MODE_BYTES && GetInternalQueue (0)->GetMaxBytes () < m_queueLimit))
+    {
+      NS_LOG_ERROR ("The size of the internal queue is less than the queue disc limit");
+      return false;
+    }
+
+  if (m_sojournThreshold.IsStrictlyNegative ())
+    {
+      NS_LOG_ERROR ("The sojourn threshold cannot be negative");
+      return false;
+    }
+
+  return true;
+}
+
+void
+DctcpQueueDisc::InitializeParams (void)
+{
+  NS_LOG_FUNCTION (this);
+  // the hot path compares raw time steps
+  m_sojournSteps = m_sojournThreshold.GetTimeStep ();
+  m_enqueueTimes.clear ();
+}
+
+} // namespace ns3
@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef DCTCP_QUEUE_DISC_H
+#define DCTCP_QUEUE_DISC_H
+
+#include "ns3/queue-disc.h"
+#include "ns3/queue.h"
+#include "ns3/nstime.h"
+#include <deque>
+
+namespace ns3 {
+
+/**
+ * \ingroup traffic-control
+ *
+ * The step marking queue disc of DCTCP: a single FIFO queue which marks
+ * the packets with the ECN CE codepoint when the instantaneous queue holds
+ * at least MarkingThreshold packets or bytes (K in the DCTCP paper), and
+ * drops them when the queue is full. Unlike RED, there is no average
+ * queue, random draw or floating point computation per packet.
+ *
+ * By default, packets are marked when they are enqueued. If MarkOnDequeue
+ * is set, the queue left behind by a packet is checked when it is dequeued
+ * instead, which conveys the congestion to the senders one queueing delay
+ * earlier. If SojournThreshold is not zero, packets are marked when they
+ * are dequeued after having waited at least that long in the queue, rather
+ * than according to the queue length.
+ *
+ * Packets are marked through QueueDiscItem::Mark, hence the CE codepoint
+ * is set in the IP header and the DctcpSocket receiving the packet echoes
+ * it back in its UpdateEcnState method. Packets which cannot be marked
+ * (i.e., not ECN capable) are left untouched.
+ */
+class DctcpQueueDisc : public QueueDisc {
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \brief DctcpQueueDisc constructor
+   */
+  DctcpQueueDisc ();
+
+  virtual ~DctcpQueueDisc ();
+
+  /**
+   * \brief Stats
+   */
+  typedef struct
+  {
+    uint32_t qLimDrop;     //!< Drops due to queue limits
+    uint32_t marks;        //!< Packets marked
+    uint32_t unmarkable;   //!< Packets which should have been marked but are not ECN capable
+  } Stats;
+
+  /**
+   * \brief Get the statistics of the queue disc.
+   * \returns The statistics.
+   */
+  Stats GetStats (void);
+
+  /**
+   * \brief Get the current value of the queue in bytes or packets.
+   * \returns The queue size in bytes or packets.
+   */
+  uint32_t GetQueueSize (void);
+
+private:
+  virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
+  virtual Ptr<QueueDiscItem> DoDequeue (void);
+  virtual Ptr<const QueueDiscItem> DoPeek (void) const;
+  virtual bool CheckConfig (void);
+  virtual void InitializeParams (void);
+
+  /**
+   * \brief Mark a packet and update the statistics
+   * \param item the packet to mark
+   */
+  void MarkPacket (Ptr<QueueDiscItem> item);
+
+  Queue::QueueMode m_mode;        //!< Mode (bytes or packets)
+  uint32_t m_queueLimit;          //!< Queue limit in bytes or packets
+  uint32_t m_threshold;           //!< Marking threshold in bytes or packets
+  bool m_markOnDequeue;           //!< True to mark packets when they are dequeued
+  Time m_sojournThreshold;        //!< Sojourn time above which packets are marked
+  int64_t m_sojournSteps;         //!< Sojourn threshold in time steps, 0 if disabled
+  std::deque<int64_t> m_enqueueTimes; //!< Enqueue times of the queued packets, in time steps
+  Stats m_stats;                  //!< Statistics
+};
+
+} // namespace ns3
+
+#endif /* DCTCP_QUEUE_DISC_H */
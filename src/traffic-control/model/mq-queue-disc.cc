@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/net-device.h"
+#include "mq-queue-disc.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MqQueueDisc");
+
+NS_OBJECT_ENSURE_REGISTERED (MqQueueDisc);
+
+TypeId MqQueueDisc::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MqQueueDisc")
+    .SetParent<QueueDisc> ()
+    .SetGroupName ("TrafficControl")
+    .AddConstructor<MqQueueDisc> ()
+    .AddAttribute ("ChildQueueDiscType",
+                   "The type of the child queue discs created if no class is provided.",
+                   StringValue ("ns3::PfifoFastQueueDisc"),
+                   MakeObjectFactoryAccessor (&MqQueueDisc::m_childFactory),
+                   MakeObjectFactoryChecker ())
+  ;
+  return tid;
+}
+
+MqQueueDisc::MqQueueDisc ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MqQueueDisc::~MqQueueDisc ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+QueueDisc::WakeMode
+MqQueueDisc::GetWakeMode (void)
+{
+  return WAKE_CHILD;
+}
+
+bool
+MqQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
+{
+  NS_FATAL_ERROR ("MqQueueDisc: DoEnqueue should never be called");
+}
+
+Ptr<QueueDiscItem>
+MqQueueDisc::DoDequeue (void)
+{
+  NS_FATAL_ERROR ("MqQueueDisc: DoDequeue should never be called");
+}
+
+Ptr<const QueueDiscItem>
+MqQueueDisc::DoPeek (void) const
+{
+  NS_FATAL_ERROR ("MqQueueDisc: DoPeek should never be called");
+}
+
+bool
+MqQueueDisc::CheckConfig (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Ptr<NetDevice> device = GetNetDevice ();
+  if (device == 0)
+    {
+      NS_LOG_ERROR ("MqQueueDisc needs to be installed on a device");
+      return false;
+    }
+
+  Ptr<NetDeviceQueueInterface> devQueueIface = device->GetObject<NetDeviceQueueInterface> ();
+  if (devQueueIface == 0)
+    {
+      NS_LOG_ERROR ("MqQueueDisc needs a device with a netdevice queue interface");
+      return false;
+    }
+
+  if (GetNPacketFilters () != 0)
+    {
+      NS_LOG_ERROR ("MqQueueDisc needs no packet filter");
+      return false;
+    }
+
+  if (GetNInternalQueues () != 0)
+    {
+      NS_LOG_ERROR ("MqQueueDisc cannot have internal queues");
+      return false;
+    }
+
+  if (GetNQueueDiscClasses () == 0)
+    {
+      // create a class with a child queue disc for each transmission queue
+      for (uint32_t i = 0; i < devQueueIface->GetNTxQueues (); i++)
+        {
+          Ptr<QueueDiscClass> c = CreateObject<QueueDiscClass> ();
+          c->SetQueueDisc (m_childFactory.Create<QueueDisc> ());
+          AddQueueDiscClass (c);
+        }
+    }
+
+  if (GetNQueueDiscClasses () != devQueueIface->GetNTxQueues ())
+    {
+      NS_LOG_ERROR ("MqQueueDisc needs as many classes as the transmission queues of the device");
+      return false;
+    }
+
+  // the child queue discs transmit directly to the device
+  for (uint32_t i = 0; i < GetNQueueDiscClasses (); i++)
+    {
+      Ptr<QueueDisc> child = GetQueueDiscClass (i)->GetQueueDisc ();
+      if (child->GetNetDevice () == 0)
+        {
+          child->SetNetDevice (device);
+        }
+    }
+
+  return true;
+}
+
+void
+MqQueueDisc::InitializeParams (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+} // namespace ns3
@@ -0,0 +1,79 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef MQ_QUEUE_DISC_H
+#define MQ_QUEUE_DISC_H
+
+#include "ns3/queue-disc.h"
+#include "ns3/object-factory.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup traffic-control
+ *
+ * mq is a multi-queue aware queue disc which, like the Linux mq qdisc, has
+ * as many classes as the transmission queues of the device it is installed
+ * on. Each class holds a child queue disc which is directly woken by the
+ * corresponding transmission queue, so that packets destined to distinct
+ * transmission queues are never serialized on a single queue disc.
+ *
+ * The traffic control layer enqueues a packet in the child queue disc
+ * associated with the transmission queue selected for the packet, i.e.,
+ * by the select queue callback of the device or, if the device provides
+ * none, by the hash of the flow the packet belongs to. Hence, the Enqueue
+ * and Dequeue methods of mq itself are never called.
+ *
+ * If no class is provided, one class per transmission queue is created,
+ * each holding a queue disc of the type set by the ChildQueueDiscType
+ * attribute. User is allowed to provide classes, but they must be as many
+ * as the transmission queues of the device. No packet filter or internal
+ * queue can be provided.
+ */
+class MqQueueDisc : public QueueDisc {
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \brief MqQueueDisc constructor
+   */
+  MqQueueDisc ();
+
+  virtual ~MqQueueDisc ();
+
+  /**
+   * \brief Return the wake mode adopted by this queue disc.
+   * \return WAKE_CHILD, the child queue discs are woken by the device.
+   */
+  virtual WakeMode GetWakeMode (void);
+
+private:
+  virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
+  virtual Ptr<QueueDiscItem> DoDequeue (void);
+  virtual Ptr<const QueueDiscItem> DoPeek (void) const;
+  virtual bool CheckConfig (void);
+  virtual void InitializeParams (void);
+
+  ObjectFactory m_childFactory;  //!< Factory of the default child queue discs
+};
+
+} // namespace ns3
+
+#endif /* MQ_QUEUE_DISC_H */
@@ -0,0 +1,383 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+#include "pfabric-queue-disc.h"
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PfabricQueueDisc");
+
+NS_OBJECT_ENSURE_REGISTERED (PfabricTag);
+
+PfabricTag::PfabricTag ()
+  : m_priority (std::numeric_limits<uint64_t>::max ())
+{
+}
+
+PfabricTag::PfabricTag (uint64_t priority)
+  : m_priority (priority)
+{
+}
+
+TypeId
+PfabricTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PfabricTag")
+    .SetParent<Tag> ()
+    .SetGroupName ("TrafficControl")
+    .AddConstructor<PfabricTag> ()
+  ;
+  return tid;
+}
+
+TypeId
+PfabricTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+uint32_t
+PfabricTag::GetSerializedSize (void) const
+{
+  return 8;
+}
+
+void
+PfabricTag::Serialize (TagBuffer i) const
+{
+  i.WriteU64 (m_priority);
+}
+
+void
+PfabricTag::Deserialize (TagBuffer i)
+{
+  m_priority = i.ReadU64 ();
+}
+
+void
+PfabricTag::Print (std::ostream &os) const
+{
+  os << "priority=" << m_priority;
+}
+
+void
+PfabricTag::SetPriority (uint64_t priority)
+{
+  m_priority = priority;
+}
+
+uint64_t
+PfabricTag::GetPriority (void) const
+{
+  return m_priority;
+}
+
+// ------------------------------------------------------------------------- //
+
+PfabricQueueDisc::Heap::Heap (bool max, uint32_t Entry::*index)
+  : m_max (max),
+    m_index (index)
+{
+}
+
+bool
+PfabricQueueDisc::Heap::Before (const Entry *a, const Entry *b) const
+{
+  if (a->priority != b->priority)
+    {
+      return m_max ? a->priority > b->priority : a->priority < b->priority;
+    }
+  // among packets of the same priority, the min heap yields the earliest
+  // and the max heap the latest
+  return m_max ? a->seq > b->seq : a->seq < b->seq;
+}
+
+void
+PfabricQueueDisc::Heap::Set (uint32_t i, Entry *e)
+{
+  m_entries[i] = e;
+  e->*m_index = i;
+}
+
+void
+PfabricQueueDisc::Heap::SiftUp (uint32_t i)
+{
+  Entry *e = m_entries[i];
+  while (i > 0)
+    {
+      uint32_t parent = (i - 1) / 2;
+      if (!Before (e, m_entries[parent]))
+        {
+          break;
+        }
+      Set (i, m_entries[parent]);
+      i = parent;
+    }
+  Set (i, e);
+}
+
+void
+PfabricQueueDisc::Heap::SiftDown (uint32_t i)
+{
+  Entry *e = m_entries[i];
+  uint32_t n = m_entries.size ();
+  while (true)
+    {
+      uint32_t child = 2 * i + 1;
+      if (child >= n)
+        {
+          break;
+        }
+      if (child + 1 < n && Before (m_entries[child + 1], m_entries[child]))
+        {
+          child++;
+        }
+      if (!Before (m_entries[child], e))
+        {
+          break;
+        }
+      Set (i, m_entries[child]);
+      i = child;
+    }
+  Set (i, e);
+}
+
+void
+PfabricQueueDisc::Heap::Push (Entry *e)
+{
+  m_entries.push_back (e);
+  SiftUp (m_entries.size () - 1);
+}
+
+void
+PfabricQueueDisc::Heap::Remove (Entry *e)
+{
+  uint32_t i = e->*m_index;
+  NS_ASSERT (i < m_entries.size () && m_entries[i] == e);
+  Entry *last = m_entries.back ();
+  m_entries.pop_back ();
+  if (last == e)
+    {
+      return;
+    }
+  Set (i, last);
+  if (i > 0 && Before (last, m_entries[(i - 1) / 2]))
+    {
+      SiftUp (i);
+    }
+  else
+    {
+      SiftDown (i);
+    }
+}
+
+PfabricQueueDisc::Entry*
+PfabricQueueDisc::Heap::Top (void) const
+{
+  return m_entries.empty () ? 0 : m_entries.front ();
+}
+
+uint32_t
+PfabricQueueDisc::Heap::Size (void) const
+{
+  return m_entries.size ();
+}
+
+void
+PfabricQueueDisc::Heap::Clear (void)
+{
+  m_entries.clear ();
+}
+
+// ------------------------------------------------------------------------- //
+
+NS_OBJECT_ENSURE_REGISTERED (PfabricQueueDisc);
+
+TypeId PfabricQueueDisc::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PfabricQueueDisc")
+    .SetParent<QueueDisc> ()
+    .SetGroupName ("TrafficControl")
+    .AddConstructor<PfabricQueueDisc> ()
+    .AddAttribute ("Limit",
+                   "The maximum number of packets accepted by this queue disc.",
+                   UintegerValue (1000),
+                   MakeUintegerAccessor (&PfabricQueueDisc::m_limit),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+PfabricQueueDisc::PfabricQueueDisc ()
+  : m_seq (0),
+    m_minHeap (false, &Entry::minIndex),
+    m_maxHeap (true, &Entry::maxIndex)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PfabricQueueDisc::~PfabricQueueDisc ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+PfabricQueueDisc::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::unordered_map<uint32_t, Flow>::iterator it = m_flows.begin (); it != m_flows.end (); it++)
+    {
+      for (Flow::iterator e = it->second.begin (); e != it->second.end (); e++)
+        {
+          delete *e;
+        }
+    }
+  m_flows.clear ();
+  m_minHeap.Clear ();
+  m_maxHeap.Clear ();
+  QueueDisc::DoDispose ();
+}
+
+Ptr<QueueDiscItem>
+PfabricQueueDisc::Remove (Entry *e)
+{
+  m_minHeap.Remove (e);
+  m_maxHeap.Remove (e);
+  std::unordered_map<uint32_t, Flow>::iterator flow = m_flows.find (e->flowId);
+  NS_ASSERT (flow != m_flows.end ());
+  flow->second.erase (e->pos);
+  if (flow->second.empty ())
+    {
+      m_flows.erase (flow);
+    }
+  Ptr<QueueDiscItem> item = e->item;
+  delete e;
+  return item;
+}
+
+bool
+PfabricQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+
+  PfabricTag tag;
+  item->GetPacket ()->PeekPacketTag (tag);
+
+  if (m_minHeap.Size () >= m_limit)
+    {
+      // drop the packet with the lowest priority
+      Entry *lowest = m_maxHeap.Top ();
+      if (tag.GetPriority () >= lowest->priority)
+        {
+          NS_LOG_LOGIC ("Queue full -- dropping arriving packet");
+          Drop (item);
+          return false;
+        }
+      NS_LOG_LOGIC ("Queue full -- dropping packet of priority " << lowest->priority);
+      Drop (Remove (lowest));
+    }
+
+  Entry *e = new Entry;
+  e->item = item;
+  e->priority = tag.GetPriority ();
+  e->seq = m_seq++;
+  e->flowId = item->Hash ();
+  Flow &flow = m_flows[e->flowId];
+  e->pos = flow.insert (flow.end (), e);
+  m_minHeap.Push (e);
+  m_maxHeap.Push (e);
+
+  NS_LOG_LOGIC ("Number packets " << m_minHeap.Size ());
+
+  return true;
+}
+
+Ptr<QueueDiscItem>
+PfabricQueueDisc::DoDequeue (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Entry *highest = m_minHeap.Top ();
+  if (highest == 0)
+    {
+      NS_LOG_LOGIC ("Queue empty");
+      return 0;
+    }
+
+  // send the earliest packet of the flow of the highest priority packet
+  std::unordered_map<uint32_t, Flow>::iterator flow = m_flows.find (highest->flowId);
+  NS_ASSERT (flow != m_flows.end () && !flow->second.empty ());
+  Ptr<QueueDiscItem> item = Remove (flow->second.front ());
+
+  NS_LOG_LOGIC ("Popped " << item);
+  NS_LOG_LOGIC ("Number packets " << m_minHeap.Size ());
+
+  return item;
+}
+
+Ptr<const QueueDiscItem>
+PfabricQueueDisc::DoPeek (void) const
+{
+  NS_LOG_FUNCTION (this);
+
+  Entry *highest = m_minHeap.Top ();
+  if (highest == 0)
+    {
+      NS_LOG_LOGIC ("Queue empty");
+      return 0;
+    }
+
+  std::unordered_map<uint32_t, Flow>::const_iterator flow = m_flows.find (highest->flowId);
+  NS_ASSERT (flow != m_flows.end () && !flow->second.empty ());
+  return flow->second.front ()->item;
+}
+
+bool
+PfabricQueueDisc::CheckConfig (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (GetNQueueDiscClasses () > 0)
+    {
+      NS_LOG_ERROR ("PfabricQueueDisc cannot have classes");
+      return false;
+    }
+
+  if (GetNPacketFilters () > 0)
+    {
+      NS_LOG_ERROR ("PfabricQueueDisc cannot have packet filters");
+      return false;
+    }
+
+  if (GetNInternalQueues () > 0)
+    {
+      NS_LOG_ERROR ("PfabricQueueDisc cannot have internal queues");
+      return false;
+    }
+
+  return true;
+}
+
+void
+PfabricQueueDisc::InitializeParams (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+} // namespace ns3
@@ -0,0 +1,207 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef PFABRIC_QUEUE_DISC_H
+#define PFABRIC_QUEUE_DISC_H
+
+#include "ns3/queue-disc.h"
+#include "ns3/tag.h"
+#include <list>
+#include <vector>
+#include <unordered_map>
+
+namespace ns3 {
+
+/**
+ * \ingroup traffic-control
+ *
+ * The tag carrying the pFabric priority of a packet, i.e., the remaining
+ * size of its flow in bytes when the packet was sent. Lower values are
+ * served first.
+ */
+class PfabricTag : public Tag
+{
+public:
+  PfabricTag ();
+  /**
+   * \brief Constructor
+   * \param priority the priority of the packet
+   */
+  PfabricTag (uint64_t priority);
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer i) const;
+  virtual void Deserialize (TagBuffer i);
+  virtual void Print (std::ostream &os) const;
+
+  /**
+   * \brief Set the priority of the packet
+   * \param priority the priority, the lower the more urgent
+   */
+  void SetPriority (uint64_t priority);
+  /**
+   * \brief Get the priority of the packet
+   * \return the priority, the lower the more urgent
+   */
+  uint64_t GetPriority (void) const;
+
+private:
+  uint64_t m_priority; //!< Priority of the packet
+};
+
+/**
+ * \ingroup traffic-control
+ *
+ * The pFabric queue disc serves packets in "smallest remaining size first"
+ * order: when dequeuing, it finds the packet with the highest priority (the
+ * lowest PfabricTag value) and sends the earliest packet of the same flow,
+ * so that the packets of a flow are never reordered. When a packet arrives
+ * to a full queue, the packet with the lowest priority is dropped, which is
+ * the arriving packet itself if no queued packet has a lower priority.
+ * Packets without a PfabricTag have the lowest priority.
+ *
+ * The flows are identified by the hash of the packets (QueueDiscItem::Hash).
+ * The packets are indexed by two binary heaps, ordered by priority and then
+ * by arrival, hence enqueue, dequeue and drop take O(log n) time in the
+ * number n of queued packets.
+ */
+class PfabricQueueDisc : public QueueDisc {
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \brief PfabricQueueDisc constructor
+   */
+  PfabricQueueDisc ();
+
+  virtual ~PfabricQueueDisc ();
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  struct Entry;
+  /// The packets of a flow in arrival order
+  typedef std::list<Entry *> Flow;
+
+  /// A queued packet
+  struct Entry
+  {
+    Ptr<QueueDiscItem> item;     //!< The packet
+    uint64_t priority;           //!< The priority of the packet
+    uint64_t seq;                //!< The arrival order of the packet
+    uint32_t flowId;             //!< The flow of the packet
+    Flow::iterator pos;          //!< The position of the packet in its flow
+    uint32_t minIndex;           //!< The position of the packet in the min heap
+    uint32_t maxIndex;           //!< The position of the packet in the max heap
+  };
+
+  /**
+   * \brief Binary heap of entries storing the position of each entry in
+   *        the entry itself, so that any entry can be removed in O(log n)
+   */
+  class Heap
+  {
+  public:
+    /**
+     * \brief Constructor
+     * \param max true for a max heap, false for a min heap
+     * \param index the member of the entries holding their position
+     */
+    Heap (bool max, uint32_t Entry::*index);
+    /**
+     * \brief Insert an entry
+     * \param e the entry
+     */
+    void Push (Entry *e);
+    /**
+     * \brief Remove an entry
+     * \param e the entry
+     */
+    void Remove (Entry *e);
+    /**
+     * \return the entry at the top of the heap
+     */
+    Entry* Top (void) const;
+    /**
+     * \return the number of entries
+     */
+    uint32_t Size (void) const;
+    /// Remove all the entries
+    void Clear (void);
+
+  private:
+    /**
+     * \param a an entry
+     * \param b an entry
+     * \return true if a must be closer to the top than b
+     */
+    bool Before (const Entry *a, const Entry *b) const;
+    /**
+     * \brief Store an entry at a position
+     * \param i the position
+     * \param e the entry
+     */
+    void Set (uint32_t i, Entry *e);
+    /**
+     * \brief Move an entry toward the top
+     * \param i the position of the entry
+     */
+    void SiftUp (uint32_t i);
+    /**
+     * \brief Move an entry toward the bottom
+     * \param i the position of the entry
+     */
+    void SiftDown (uint32_t i);
+
+    std::vector<Entry *> m_entries;  //!< The entries
+    bool m_max;                      //!< True for a max heap
+    uint32_t Entry::*m_index;        //!< The member holding the position
+  };
+
+  virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
+  virtual Ptr<QueueDiscItem> DoDequeue (void);
+  virtual Ptr<const QueueDiscItem> DoPeek (void) const;
+  virtual bool CheckConfig (void);
+  virtual void InitializeParams (void);
+
+  /**
+   * \brief Remove a packet from the flows and the heaps
+   * \param e the entry of the packet
+   * \return the packet
+   */
+  Ptr<QueueDiscItem> Remove (Entry *e);
+
+  uint32_t m_limit;                                  //!< Maximum number of packets
+  uint64_t m_seq;                                    //!< Arrival order of the next packet
+  std::unordered_map<uint32_t, Flow> m_flows;        //!< The flows with queued packets
+  Heap m_minHeap;                                    //!< Packets by increasing priority value
+  Heap m_maxHeap;                                    //!< Packets by decreasing priority value
+};
+
+} // namespace ns3
+
+#endif /* PFABRIC_QUEUE_DISC_H */
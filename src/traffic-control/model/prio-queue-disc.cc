@@ -0,0 +1,312 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/log.h"
+#include "ns3/enum.h"
+#include "ns3/uinteger.h"
+#include "ns3/object-factory.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/socket.h"
+#include "prio-queue-disc.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PrioQueueDisc");
+
+NS_OBJECT_ENSURE_REGISTERED (PrioQueueDisc);
+
+TypeId PrioQueueDisc::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PrioQueueDisc")
+    .SetParent<QueueDisc> ()
+    .SetGroupName ("TrafficControl")
+    .AddConstructor<PrioQueueDisc> ()
+    .AddAttribute ("Bands",
+                   "The number of priority bands.",
+                   UintegerValue (3),
+                   MakeUintegerAccessor (&PrioQueueDisc::m_bands),
+                   MakeUintegerChecker<uint32_t> (1, 16))
+    .AddAttribute ("Limit",
+                   "The maximum number of packets accepted by each band.",
+                   UintegerValue (1000),
+                   MakeUintegerAccessor (&PrioQueueDisc::m_limit),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Scheduler",
+                   "The scheduler serving the bands.",
+                   EnumValue (PrioQueueDisc::STRICT),
+                   MakeEnumAccessor (&PrioQueueDisc::m_scheduler),
+                   MakeEnumChecker (PrioQueueDisc::STRICT, "STRICT",
+                                    PrioQueueDisc::WEIGHTED, "WEIGHTED"))
+    .AddAttribute ("Quantum",
+                   "The quantum of the bands of the weighted scheduler, in bytes.",
+                   UintegerValue (1514),
+                   MakeUintegerAccessor (&PrioQueueDisc::m_defaultQuantum),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+PrioQueueDisc::PrioQueueDisc ()
+  : m_current (0)
+{
+  NS_LOG_FUNCTION (this);
+  // the default priomap of the Linux prio queue disc
+  static const uint32_t prio2band[16] = {1, 2, 2, 2, 1, 2, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1};
+  for (uint32_t i = 0; i < 16; i++)
+    {
+      m_priomap[i] = prio2band[i];
+    }
+}
+
+PrioQueueDisc::~PrioQueueDisc ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+PrioQueueDisc::SetBandForPriority (uint8_t priority, uint32_t band)
+{
+  NS_LOG_FUNCTION (this << (uint32_t) priority << band);
+  NS_ASSERT (priority < 16);
+  m_priomap[priority] = band;
+}
+
+void
+PrioQueueDisc::SetQuantum (uint32_t band, uint32_t quantum)
+{
+  NS_LOG_FUNCTION (this << band << quantum);
+  NS_ASSERT (quantum > 0);
+  if (band >= m_quanta.size ())
+    {
+      m_quanta.resize (band + 1, 0);
+    }
+  m_quanta[band] = quantum;
+}
+
+bool
+PrioQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+
+  int32_t ret = Classify (item);
+  uint32_t band;
+
+  if (ret == PacketFilter::PF_NO_MATCH)
+    {
+      uint8_t priority = 0;
+      SocketPriorityTag priorityTag;
+      if (item->GetPacket ()->PeekPacketTag (priorityTag))
+        {
+          priority = priorityTag.GetPriority ();
+        }
+      band = m_priomap[priority & 0x0f];
+    }
+  else
+    {
+      band = ret;
+    }
+
+  if (band >= m_bands)
+    {
+      band = m_bands - 1;
+    }
+
+  bool retval = GetInternalQueue (band)->Enqueue (item);
+
+  // If Queue::Enqueue fails, QueueDisc::Drop is called by the internal queue
+  // because QueueDisc::AddInternalQueue sets the drop callback
+
+  NS_LOG_LOGIC ("Number packets band " << band << ": " << GetInternalQueue (band)->GetNPackets ());
+
+  return retval;
+}
+
+Ptr<QueueDiscItem>
+PrioQueueDisc::DoDequeue (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_scheduler == WEIGHTED)
+    {
+      return DequeueWeighted ();
+    }
+
+  Ptr<QueueDiscItem> item;
+
+  for (uint32_t i = 0; i < m_bands; i++)
+    {
+      if ((item = StaticCast<QueueDiscItem> (GetInternalQueue (i)->Dequeue ())) != 0)
+        {
+          NS_LOG_LOGIC ("Popped from band " << i << ": " << item);
+          return item;
+        }
+    }
+
+  NS_LOG_LOGIC ("Queue empty");
+  return item;
+}
+
+Ptr<QueueDiscItem>
+PrioQueueDisc::DequeueWeighted (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  uint32_t band = SelectWeightedBand (m_deficits, m_current);
+  if (band == m_bands)
+    {
+      NS_LOG_LOGIC ("Queue empty");
+      return 0;
+    }
+
+  Ptr<QueueDiscItem> item = StaticCast<QueueDiscItem> (GetInternalQueue (band)->Dequeue ());
+  m_deficits[band] -= item->GetPacketSize ();
+  NS_LOG_LOGIC ("Popped from band " << band << ": " << item);
+  return item;
+}
+
+uint32_t
+PrioQueueDisc::SelectWeightedBand (std::vector<int64_t> &deficits, uint32_t &current) const
+{
+  NS_LOG_FUNCTION (this << current);
+
+  uint32_t band = 0;
+  while (band < m_bands && GetInternalQueue (band)->IsEmpty ())
+    {
+      band++;
+    }
+  if (band == m_bands)
+    {
+      return m_bands;
+    }
+
+  // deficit round robin: a band keeps the turn while its deficit covers
+  // the packet at its head, and gets a quantum when it takes the turn
+  while (true)
+    {
+      Ptr<const QueueItem> head = GetInternalQueue (current)->Peek ();
+      if (head == 0)
+        {
+          deficits[current] = 0;
+        }
+      else if (deficits[current] >= head->GetPacketSize ())
+        {
+          return current;
+        }
+      current = (current + 1) % m_bands;
+      if (!GetInternalQueue (current)->IsEmpty ())
+        {
+          deficits[current] += m_quanta[current];
+        }
+    }
+}
+
+Ptr<const QueueDiscItem>
+PrioQueueDisc::DoPeek (void) const
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_scheduler == WEIGHTED)
+    {
+      // run the selection of the next dequeue on a copy of the scheduler state
+      std::vector<int64_t> deficits = m_deficits;
+      uint32_t current = m_current;
+      uint32_t band = SelectWeightedBand (deficits, current);
+      if (band < m_bands)
+        {
+          return StaticCast<const QueueDiscItem> (GetInternalQueue (band)->Peek ());
+        }
+      NS_LOG_LOGIC ("Queue empty");
+      return 0;
+    }
+
+  for (uint32_t i = 0; i < m_bands; i++)
+    {
+      if (!GetInternalQueue (i)->IsEmpty ())
+        {
+          return StaticCast<const QueueDiscItem> (GetInternalQueue (i)->Peek ());
+        }
+    }
+
+  NS_LOG_LOGIC ("Queue empty");
+  return 0;
+}
+
+bool
+PrioQueueDisc::CheckConfig (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (GetNQueueDiscClasses () > 0)
+    {
+      NS_LOG_ERROR ("PrioQueueDisc cannot have classes");
+      return false;
+    }
+
+  if (GetNInternalQueues () == 0)
+    {
+      // create m_bands DropTail queues with m_limit packets each
+      ObjectFactory factory;
+      factory.SetTypeId ("ns3::DropTailQueue");
+      factory.Set ("Mode", EnumValue (Queue::QUEUE_MODE_PACKETS));
+      factory.Set ("MaxPackets", UintegerValue (m_limit));
+      for (uint32_t i = 0; i < m_bands; i++)
+        {
+          AddInternalQueue (factory.Create<Queue> ());
+        }
+    }
+
+  if (GetNInternalQueues () != m_bands)
+    {
+      NS_LOG_ERROR ("PrioQueueDisc needs as many internal queues as bands");
+      return false;
+    }
+
+  for (uint32_t i = 0; i < m_bands; i++)
+    {
+      if (GetInternalQueue (i)->GetMode () != Queue::QUEUE_MODE_PACKETS)
+        {
+          NS_LOG_ERROR ("PrioQueueDisc needs internal queues operating in packet mode");
+          return false;
+        }
+    }
+
+  if (m_quanta.size () > m_bands)
+    {
+      NS_LOG_ERROR ("A quantum is set for a band beyond the last one");
+      return false;
+    }
+
+  return true;
+}
+
+void
+PrioQueueDisc::InitializeParams (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_quanta.resize (m_bands, 0);
+  for (uint32_t i = 0; i < m_bands; i++)
+    {
+      if (m_quanta[i] == 0)
+        {
+          m_quanta[i] = m_defaultQuantum;
+        }
+    }
+  m_deficits.assign (m_bands, 0);
+  m_deficits[0] = m_quanta[0];
+  m_current = 0;
+}
+
+} // namespace ns3
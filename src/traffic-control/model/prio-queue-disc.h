@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef PRIO_QUEUE_DISC_H
+#define PRIO_QUEUE_DISC_H
+
+#include "ns3/queue-disc.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup traffic-control
+ *
+ * A multi-level priority queue disc, as used to emulate PIAS and similar
+ * flow scheduling schemes with commodity switches. Packets are stored in
+ * one FIFO droptail queue per band, band 0 having the highest priority.
+ *
+ * The band of a packet is determined by the packet filters (e.g., a filter
+ * mapping the DSCP of IP packets to a band, such as PrioIpv4PacketFilter).
+ * If no filter matches the packet, the priority carried by its
+ * SocketPriorityTag is mapped to a band through the priomap, whose default
+ * value is that of the Linux prio queue disc. Bands beyond the last one are
+ * served as the last one.
+ *
+ * The bands are served in strict priority order by default. If the
+ * Scheduler attribute is set to WEIGHTED, the bands are served by a deficit
+ * round robin scheduler instead, each band sending up to its quantum of
+ * bytes per round.
+ *
+ * If no internal queue is provided, Bands DropTail queues having each a
+ * capacity of Limit packets are created. User is allowed to provide queues,
+ * but they must be as many as the bands and operate in packet mode.
+ */
+class PrioQueueDisc : public QueueDisc {
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \brief PrioQueueDisc constructor
+   */
+  PrioQueueDisc ();
+
+  virtual ~PrioQueueDisc ();
+
+  /**
+   * \brief The scheduler serving the bands
+   */
+  enum Scheduler
+  {
+    STRICT,      //!< Bands served in priority order
+    WEIGHTED     //!< Bands served by deficit round robin
+  };
+
+  /**
+   * \brief Set the band of the packets whose priority has no matching filter
+   * \param priority the priority carried by the SocketPriorityTag (0-15)
+   * \param band the band
+   */
+  void SetBandForPriority (uint8_t priority, uint32_t band);
+
+  /**
+   * \brief Set the number of bytes a band can send in a round of the
+   *        weighted scheduler
+   * \param band the band
+   * \param quantum the quantum in bytes
+   */
+  void SetQuantum (uint32_t band, uint32_t quantum);
+
+private:
+  virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
+  virtual Ptr<QueueDiscItem> DoDequeue (void);
+  virtual Ptr<const QueueDiscItem> DoPeek (void) const;
+  virtual bool CheckConfig (void);
+  virtual void InitializeParams (void);
+
+  /**
+   * \brief Dequeue a packet from the weighted scheduler
+   * \return the packet, or 0 if all the bands are empty
+   */
+  Ptr<QueueDiscItem> DequeueWeighted (void);
+
+  /**
+   * \brief Select the band served next by the weighted scheduler
+   *
+   * The deficits and the current band are updated as the scheduler goes
+   * through the bands, up to the band whose deficit covers its head packet.
+   *
+   * \param deficits the deficit of each band
+   * \param current the band which has the turn
+   * \return the band served next, or the number of bands if they are all empty
+   */
+  uint32_t SelectWeightedBand (std::vector<int64_t> &deficits, uint32_t &current) const;
+
+  uint32_t m_bands;                   //!< Number of bands
+  uint32_t m_limit;                   //!< Maximum number of packets per band
+  Scheduler m_scheduler;              //!< Scheduler serving the bands
+  uint32_t m_defaultQuantum;          //!< Quantum of the bands with no quantum set
+  uint32_t m_priomap[16];             //!< Band of each priority
+  std::vector<uint32_t> m_quanta;     //!< Quantum of each band
+  std::vector<int64_t> m_deficits;    //!< Deficit of each band
+  uint32_t m_current;                 //!< Band served by the weighted scheduler
+};
+
+} // namespace ns3
+
+#endif /* PRIO_QUEUE_DISC_H */
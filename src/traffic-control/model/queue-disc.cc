@@ -78,6 +78,12 @@ QueueDiscItem::Print (std::ostream& os) const
   ;
 }
 
+uint32_t
+QueueDiscItem::Hash (uint32_t perturbation) const
+{
+  return 0;
+}
+
 
 NS_OBJECT_ENSURE_REGISTERED (QueueDiscClass);
 
@@ -98,6 +98,17 @@ public:
    */
   virtual bool Mark (void) = 0;
 
+  /**
+   * \brief Computes the hash of the packet's 5-tuple
+   *
+   * Subclasses can compute the hash of the packet's 5-tuple (if it carries
+   * one) and the given perturbation. The base class returns 0.
+   *
+   * \param perturbation hash perturbation value
+   * \return the hash of the packet's 5-tuple
+   */
+  virtual uint32_t Hash (uint32_t perturbation = 0) const;
+
 private:
   /**
    * \brief Default constructor
@@ -426,7 +437,7 @@ public:
    *
    * \return the wake mode adopted by this queue disc.
    */
-  WakeMode GetWakeMode (void);
+  virtual WakeMode GetWakeMode (void);
 
   /// Callback invoked by a child queue disc to notify the parent of a packet drop
   typedef Callback<void, Ptr<QueueItem> > ParentDropCallback;
@@ -72,37 +72,38 @@ void
 TrafficControlLayer::DoInitialize (void)
 {
   NS_LOG_FUNCTION (this);
-  std::map<Ptr<NetDevice>, NetDeviceInfo>::iterator ndi;
-  for (ndi = m_netDevices.begin (); ndi != m_netDevices.end (); ndi++)
+  for (std::vector<NetDeviceInfo>::iterator ndi = m_netDevices.begin ();
+       ndi != m_netDevices.end (); ndi++)
     {
-      if (ndi->second.rootQueueDisc)
+      if (ndi->rootQueueDisc)
         {
-          Ptr<NetDeviceQueueInterface> devQueueIface = ndi->second.ndqi;
+          Ptr<NetDeviceQueueInterface> devQueueIface = ndi->ndqi;
           NS_ASSERT (devQueueIface);
 
+          // initialize the queue disc first, as multi-queue aware queue discs
+          // create their child queue discs while checking their configuration
+          ndi->rootQueueDisc->Initialize ();
+
           // set the wake callbacks on netdevice queues
-           if (ndi->second.rootQueueDisc->GetWakeMode () == QueueDisc::WAKE_ROOT)
+          if (ndi->rootQueueDisc->GetWakeMode () == QueueDisc::WAKE_ROOT)
             {
               for (uint32_t i = 0; i < devQueueIface->GetNTxQueues (); i++)
                 {
-                  devQueueIface->GetTxQueue (i)->SetWakeCallback (MakeCallback (&QueueDisc::Run, ndi->second.rootQueueDisc));
-                  ndi->second.queueDiscsToWake.push_back (ndi->second.rootQueueDisc);
+                  devQueueIface->GetTxQueue (i)->SetWakeCallback (MakeCallback (&QueueDisc::Run, ndi->rootQueueDisc));
+                  ndi->queueDiscsToWake.push_back (ndi->rootQueueDisc);
                 }
             }
-          else if (ndi->second.rootQueueDisc->GetWakeMode () == QueueDisc::WAKE_CHILD)
+          else if (ndi->rootQueueDisc->GetWakeMode () == QueueDisc::WAKE_CHILD)
             {
-              NS_ASSERT_MSG (ndi->second.rootQueueDisc->GetNQueueDiscClasses () == devQueueIface->GetNTxQueues (),
+              NS_ASSERT_MSG (ndi->rootQueueDisc->GetNQueueDiscClasses () == devQueueIface->GetNTxQueues (),
                              "The number of child queue discs does not match the number of netdevice queues");
               for (uint32_t i = 0; i < devQueueIface->GetNTxQueues (); i++)
                 {
                   devQueueIface->GetTxQueue (i)->SetWakeCallback (MakeCallback (&QueueDisc::Run,
-                                                                  ndi->second.rootQueueDisc->GetQueueDiscClass (i)->GetQueueDisc ()));
-                  ndi->second.queueDiscsToWake.push_back (ndi->second.rootQueueDisc->GetQueueDiscClass (i)->GetQueueDisc ());
+                                                                  ndi->rootQueueDisc->GetQueueDiscClass (i)->GetQueueDisc ()));
+                  ndi->queueDiscsToWake.push_back (ndi->rootQueueDisc->GetQueueDiscClass (i)->GetQueueDisc ());
                 }
             }
-
-          // initialize the queue disc
-          ndi->second.rootQueueDisc->Initialize ();
         }
     }
   Object::DoInitialize ();
@@ -136,12 +137,17 @@ TrafficControlLayer::SetupDevice (Ptr<NetDevice> device)
   // devices can set a select queue callback in their NotifyNewAggregate method
   SelectQueueCallback cb = devQueueIface->GetSelectQueueCallback ();
 
-  // create an entry in the m_netDevices map for this device
-  NS_ASSERT_MSG (m_netDevices.find (device) == m_netDevices.end (), "This is a bug,"
-                 << "  SetupDevice only can insert an entry in the m_netDevices map");
+  // create an entry in the m_netDevices vector for this device
+  uint32_t index = device->GetIfIndex ();
+  if (index >= m_netDevices.size ())
+    {
+      m_netDevices.resize (index + 1);
+    }
+  NS_ASSERT_MSG (m_netDevices[index].ndqi == 0, "This is a bug,"
+                 << "  SetupDevice only can insert an entry in the m_netDevices vector");
 
   NetDeviceInfo entry = {0, devQueueIface, QueueDiscVector (), cb};
-  m_netDevices[device] = entry;
+  m_netDevices[index] = entry;
 }
 
 void
@@ -167,22 +173,22 @@ TrafficControlLayer::SetRootQueueDiscOnDevice (Ptr<NetDevice> device, Ptr<QueueD
 {
   NS_LOG_FUNCTION (this << device << qDisc);
 
-  std::map<Ptr<NetDevice>, NetDeviceInfo>::iterator ndi = m_netDevices.find (device);
+  NetDeviceInfo *ndi = GetNetDeviceInfo (device);
 
-  if (ndi == m_netDevices.end ())
+  if (ndi == 0)
     {
       // SetupDevice has not been called yet. This may happen when the tc helper is
       // invoked (to install a queue disc) before the creation of the Ipv{4,6}Interface.
       // Since queue discs require that a netdevice queue interface is aggregated
       // to the device, call SetupDevice
       SetupDevice (device);
-      ndi = m_netDevices.find (device);
-      NS_ASSERT (ndi != m_netDevices.end ());
+      ndi = GetNetDeviceInfo (device);
+      NS_ASSERT (ndi != 0);
     }
 
-  NS_ASSERT_MSG (ndi->second.rootQueueDisc == 0, "Cannot install a root queue disc on a "
+  NS_ASSERT_MSG (ndi->rootQueueDisc == 0, "Cannot install a root queue disc on a "
                   << "device already having one. Delete the existing queue disc first.");
-  ndi->second.rootQueueDisc = qDisc;
+  ndi->rootQueueDisc = qDisc;
 }
 
 Ptr<QueueDisc>
@@ -190,20 +196,32 @@ TrafficControlLayer::GetRootQueueDiscOnDevice (Ptr<NetDevice> device) const
 {
   NS_LOG_FUNCTION (this << device);
 
-  std::map<Ptr<NetDevice>, NetDeviceInfo>::const_iterator ndi = m_netDevices.find (device);
+  return GetRootQueueDiscOnDeviceByIndex (device->GetIfIndex ());
+}
+
+Ptr<QueueDisc>
+TrafficControlLayer::GetRootQueueDiscOnDeviceByIndex (uint32_t index) const
+{
+  NS_LOG_FUNCTION (this << index);
 
-  if (ndi == m_netDevices.end ())
+  if (index >= m_netDevices.size ())
     {
       return 0;
     }
-  return ndi->second.rootQueueDisc;
+  return m_netDevices[index].rootQueueDisc;
 }
 
-Ptr<QueueDisc>
-TrafficControlLayer::GetRootQueueDiscOnDeviceByIndex (uint32_t index) const
+TrafficControlLayer::NetDeviceInfo*
+TrafficControlLayer::GetNetDeviceInfo (Ptr<NetDevice> device)
 {
-  NS_LOG_FUNCTION (this << index);
-  return GetRootQueueDiscOnDevice (m_node->GetDevice (index));
+  uint32_t index = device->GetIfIndex ();
+  if (index >= m_netDevices.size () || m_netDevices[index].ndqi == 0)
+    {
+      return 0;
+    }
+  NS_ASSERT_MSG (m_node == 0 || m_node->GetDevice (index) == device,
+                 "The device is not installed on the node of this traffic control layer");
+  return &m_netDevices[index];
 }
 
 void
@@ -211,14 +229,14 @@ TrafficControlLayer::DeleteRootQueueDiscOnDevice (Ptr<NetDevice> device)
 {
   NS_LOG_FUNCTION (this << device);
 
-  std::map<Ptr<NetDevice>, NetDeviceInfo>::iterator ndi = m_netDevices.find (device);
+  NetDeviceInfo *ndi = GetNetDeviceInfo (device);
 
-  NS_ASSERT_MSG (ndi != m_netDevices.end () && ndi->second.rootQueueDisc != 0, "No root queue disc"
+  NS_ASSERT_MSG (ndi != 0 && ndi->rootQueueDisc != 0, "No root queue disc"
                  << " installed on device " << device);
 
   // remove the root queue disc
-  ndi->second.rootQueueDisc = 0;
-  ndi->second.queueDiscsToWake.clear ();
+  ndi->rootQueueDisc = 0;
+  ndi->queueDiscsToWake.clear ();
 }
 
 void
@@ -294,30 +312,33 @@ TrafficControlLayer::Send (Ptr<NetDevice> device, Ptr<QueueDiscItem> item)
   NS_LOG_DEBUG ("Send packet to device " << device << " protocol number " <<
                 item->GetProtocol ());
 
-  std::map<Ptr<NetDevice>, NetDeviceInfo>::iterator ndi = m_netDevices.find (device);
-  NS_ASSERT (ndi != m_netDevices.end ());
-  Ptr<NetDeviceQueueInterface> devQueueIface = ndi->second.ndqi;
-  NS_ASSERT (devQueueIface);
+  NetDeviceInfo *ndi = GetNetDeviceInfo (device);
+  NS_ASSERT (ndi != 0);
+  Ptr<NetDeviceQueueInterface> devQueueIface = ndi->ndqi;
 
   // determine the transmission queue of the device where the packet will be enqueued
   uint8_t txq = 0;
   if (devQueueIface->GetNTxQueues () > 1)
     {
-      if (!ndi->second.selectQueueCallback.IsNull ())
+      if (!ndi->selectQueueCallback.IsNull ())
+        {
+          txq = ndi->selectQueueCallback (item);
+        }
+      else
         {
-          txq = ndi->second.selectQueueCallback (item);
+          // otherwise, Linux determines the queue index by using a hash function
+          // and associates such index to the socket which the packet belongs to,
+          // so that subsequent packets of the same socket will be mapped to the
+          // same tx queue (__netdev_pick_tx function in net/core/dev.c). Here,
+          // the hash of the flow the packet belongs to is used, which maps the
+          // packets of a flow to the same tx queue as well
+          txq = item->Hash () % devQueueIface->GetNTxQueues ();
         }
-      // otherwise, Linux determines the queue index by using a hash function
-      // and associates such index to the socket which the packet belongs to,
-      // so that subsequent packets of the same socket will be mapped to the
-      // same tx queue (__netdev_pick_tx function in net/core/dev.c). It is
-      // pointless to implement this in ns-3 because currently the multi-queue
-      // devices provide a select queue callback
     }
 
   NS_ASSERT (txq < devQueueIface->GetNTxQueues ());
 
-  if (ndi->second.rootQueueDisc == 0)
+  if (ndi->rootQueueDisc == 0)
     {
       // The device has no attached queue disc, thus add the header to the packet and
       // send it directly to the device if the selected queue is not stopped
@@ -339,7 +360,7 @@ TrafficControlLayer::Send (Ptr<NetDevice> device, Ptr<QueueDiscItem> item)
       // selected for the packet and try to dequeue packets from such queue disc
       item->SetTxQueueIndex (txq);
 
-      Ptr<QueueDisc> qDisc = ndi->second.queueDiscsToWake[txq];
+      Ptr<QueueDisc> qDisc = ndi->queueDiscsToWake[txq];
       NS_ASSERT (qDisc);
       qDisc->Enqueue (item);
       qDisc->Run ();
@@ -24,7 +24,6 @@
 #include "ns3/net-device.h"
 #include "ns3/node.h"
 #include "queue-disc.h"
-#include <map>
 #include <vector>
 
 namespace ns3 {
@@ -247,11 +246,19 @@ private:
    * \return the root queue disc installed on the specified device
    */
   Ptr<QueueDisc> GetRootQueueDiscOnDeviceByIndex (uint32_t index) const;
+  /**
+   * \brief Get the information stored for a device
+   * \param device the device
+   * \return the information stored for the device, or 0 if SetupDevice has
+   *         not been called for the device yet
+   */
+  NetDeviceInfo* GetNetDeviceInfo (Ptr<NetDevice> device);
 
   /// The node this TrafficControlLayer object is aggregated to
   Ptr<Node> m_node;
-  /// Map storing the required information for each device with a queue disc installed
-  std::map<Ptr<NetDevice>, NetDeviceInfo> m_netDevices;
+  /// Vector storing the required information for each device, indexed by the
+  /// index of the device in the node's device list
+  std::vector<NetDeviceInfo> m_netDevices;
   ProtocolHandlerList m_handlers;  //!< List of upper-layer handlers
 };
 
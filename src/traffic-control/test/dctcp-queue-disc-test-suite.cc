@@ -0,0 +1,220 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/dctcp-queue-disc.h"
+#include "ns3/packet.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Queue disc item recording whether it has been marked
+ */
+class DctcpQueueDiscTestItem : public QueueDiscItem {
+public:
+  /**
+   * Constructor
+   * \param p the packet
+   * \param ecnCapable true if the packet can be marked
+   */
+  DctcpQueueDiscTestItem (Ptr<Packet> p, bool ecnCapable);
+  virtual ~DctcpQueueDiscTestItem ();
+  virtual void AddHeader (void);
+  virtual bool Mark (void);
+  /**
+   * \return true if the packet has been marked
+   */
+  bool IsMarked (void) const;
+
+private:
+  DctcpQueueDiscTestItem ();
+  DctcpQueueDiscTestItem (const DctcpQueueDiscTestItem &);
+  DctcpQueueDiscTestItem &operator = (const DctcpQueueDiscTestItem &);
+
+  bool m_ecnCapable; //!< True if the packet can be marked
+  bool m_marked;     //!< True if the packet has been marked
+};
+
+DctcpQueueDiscTestItem::DctcpQueueDiscTestItem (Ptr<Packet> p, bool ecnCapable)
+  : QueueDiscItem (p, Address (), 0),
+    m_ecnCapable (ecnCapable),
+    m_marked (false)
+{
+}
+
+DctcpQueueDiscTestItem::~DctcpQueueDiscTestItem ()
+{
+}
+
+void
+DctcpQueueDiscTestItem::AddHeader (void)
+{
+}
+
+bool
+DctcpQueueDiscTestItem::Mark (void)
+{
+  if (m_ecnCapable)
+    {
+      m_marked = true;
+    }
+  return m_ecnCapable;
+}
+
+bool
+DctcpQueueDiscTestItem::IsMarked (void) const
+{
+  return m_marked;
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Check the step marking of DctcpQueueDisc
+ */
+class DctcpQueueDiscTestCase : public TestCase
+{
+public:
+  DctcpQueueDiscTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Check marking on enqueue and on dequeue
+   * \param mode the queue mode
+   * \param onDequeue true to mark on dequeue
+   */
+  void RunStepTest (StringValue mode, bool onDequeue);
+  /**
+   * \brief Dequeue a packet and check its mark
+   * \param queue the queue disc
+   * \param marked true if the packet must be marked
+   */
+  void DequeueAndCheck (Ptr<DctcpQueueDisc> queue, bool marked);
+  /// Check the sojourn time variant
+  void RunSojournTest (void);
+};
+
+DctcpQueueDiscTestCase::DctcpQueueDiscTestCase ()
+  : TestCase ("Step marking of the DCTCP queue disc")
+{
+}
+
+void
+DctcpQueueDiscTestCase::DequeueAndCheck (Ptr<DctcpQueueDisc> queue, bool marked)
+{
+  Ptr<DctcpQueueDiscTestItem> item = DynamicCast<DctcpQueueDiscTestItem> (queue->Dequeue ());
+  NS_TEST_ASSERT_MSG_NE (item, 0, "no packet dequeued");
+  NS_TEST_EXPECT_MSG_EQ (item->IsMarked (), marked, "bad mark at " << Simulator::Now ().GetMicroSeconds () << "us");
+}
+
+void
+DctcpQueueDiscTestCase::RunStepTest (StringValue mode, bool onDequeue)
+{
+  Ptr<DctcpQueueDisc> queue = CreateObject<DctcpQueueDisc> ();
+  queue->SetAttribute ("Mode", mode);
+  queue->SetAttribute ("MarkOnDequeue", BooleanValue (onDequeue));
+
+  uint32_t pktSize = 1;
+  if (mode.Get () == "QUEUE_MODE_BYTES")
+    {
+      pktSize = 1000;
+    }
+  queue->SetAttribute ("QueueLimit", UintegerValue (10 * pktSize));
+  queue->SetAttribute ("MarkingThreshold", UintegerValue (5 * pktSize));
+  queue->Initialize ();
+
+  // the packets find 0 to 9 packets in the queue, the last two are dropped
+  std::vector<Ptr<DctcpQueueDiscTestItem> > items;
+  for (uint32_t i = 0; i < 12; i++)
+    {
+      items.push_back (Create<DctcpQueueDiscTestItem> (Create<Packet> (pktSize), i != 7));
+      queue->Enqueue (items.back ());
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->GetQueueSize (), 10 * pktSize, "bad queue size");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetStats ().qLimDrop, 2, "bad number of drops");
+
+  if (!onDequeue)
+    {
+      for (uint32_t i = 0; i < 10; i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (items[i]->IsMarked (), (i >= 5 && i != 7), "bad mark of packet " << i);
+        }
+      NS_TEST_EXPECT_MSG_EQ (queue->GetStats ().marks, 4, "bad number of marks");
+      NS_TEST_EXPECT_MSG_EQ (queue->GetStats ().unmarkable, 1, "bad number of unmarkable packets");
+    }
+  else
+    {
+      // the packets leave 9 to 0 packets behind them
+      for (uint32_t i = 0; i < 10; i++)
+        {
+          DequeueAndCheck (queue, i < 5 && i != 7);
+        }
+      NS_TEST_EXPECT_MSG_EQ (queue->GetStats ().marks, 5, "bad number of marks");
+      NS_TEST_EXPECT_MSG_EQ (queue->GetStats ().unmarkable, 0, "bad number of unmarkable packets");
+    }
+}
+
+void
+DctcpQueueDiscTestCase::RunSojournTest (void)
+{
+  Ptr<DctcpQueueDisc> queue = CreateObject<DctcpQueueDisc> ();
+  queue->SetAttribute ("SojournThreshold", TimeValue (MilliSeconds (1)));
+  queue->SetAttribute ("MarkingThreshold", UintegerValue (1));
+  queue->Initialize ();
+
+  // the queue length does not matter, only the time spent in the queue
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      queue->Enqueue (Create<DctcpQueueDiscTestItem> (Create<Packet> (100), true));
+    }
+  Simulator::Schedule (MicroSeconds (500), &DctcpQueueDiscTestCase::DequeueAndCheck, this, queue, false);
+  Simulator::Schedule (MicroSeconds (1000), &DctcpQueueDiscTestCase::DequeueAndCheck, this, queue, true);
+  Simulator::Schedule (MicroSeconds (1000), &QueueDisc::Enqueue, queue,
+                       Create<DctcpQueueDiscTestItem> (Create<Packet> (100), true));
+  Simulator::Schedule (MicroSeconds (1500), &DctcpQueueDiscTestCase::DequeueAndCheck, this, queue, true);
+  Simulator::Schedule (MicroSeconds (1500), &DctcpQueueDiscTestCase::DequeueAndCheck, this, queue, false);
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (queue->GetStats ().marks, 2, "bad number of marks");
+}
+
+void
+DctcpQueueDiscTestCase::DoRun (void)
+{
+  RunStepTest (StringValue ("QUEUE_MODE_PACKETS"), false);
+  RunStepTest (StringValue ("QUEUE_MODE_BYTES"), false);
+  RunStepTest (StringValue ("QUEUE_MODE_PACKETS"), true);
+  RunStepTest (StringValue ("QUEUE_MODE_BYTES"), true);
+  RunSojournTest ();
+  Simulator::Destroy ();
+}
+
+static class DctcpQueueDiscTestSuite : public TestSuite
+{
+public:
+  DctcpQueueDiscTestSuite ()
+    : TestSuite ("dctcp-queue-disc", UNIT)
+  {
+    AddTestCase (new DctcpQueueDiscTestCase (), TestCase::QUICK);
+  }
+} g_dctcpQueueDiscTestSuite;
@@ -0,0 +1,221 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/mq-queue-disc.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/error-model.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Queue disc item whose flow hash is set by the test
+ */
+class MqQueueDiscTestItem : public QueueDiscItem {
+public:
+  /**
+   * Constructor
+   * \param p the packet
+   * \param flow the flow the packet belongs to
+   */
+  MqQueueDiscTestItem (Ptr<Packet> p, uint32_t flow);
+  virtual ~MqQueueDiscTestItem ();
+  virtual void AddHeader (void);
+  virtual bool Mark (void);
+  virtual uint32_t Hash (uint32_t perturbation) const;
+
+private:
+  MqQueueDiscTestItem ();
+  MqQueueDiscTestItem (const MqQueueDiscTestItem &);
+  MqQueueDiscTestItem &operator = (const MqQueueDiscTestItem &);
+
+  uint32_t m_flow; //!< The flow the packet belongs to
+};
+
+MqQueueDiscTestItem::MqQueueDiscTestItem (Ptr<Packet> p, uint32_t flow)
+  : QueueDiscItem (p, Address (), 0),
+    m_flow (flow)
+{
+}
+
+MqQueueDiscTestItem::~MqQueueDiscTestItem ()
+{
+}
+
+void
+MqQueueDiscTestItem::AddHeader (void)
+{
+}
+
+bool
+MqQueueDiscTestItem::Mark (void)
+{
+  return false;
+}
+
+uint32_t
+MqQueueDiscTestItem::Hash (uint32_t perturbation) const
+{
+  return m_flow;
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Device with four transmission queues counting the packets sent
+ */
+class MqQueueDiscTestDevice : public SimpleNetDevice {
+public:
+  MqQueueDiscTestDevice ();
+  virtual bool Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber);
+  /**
+   * \return the number of packets sent by the device
+   */
+  uint32_t GetNSent (void) const;
+
+protected:
+  virtual void NotifyNewAggregate (void);
+
+private:
+  uint32_t m_nSent; //!< Number of packets sent
+};
+
+MqQueueDiscTestDevice::MqQueueDiscTestDevice ()
+  : m_nSent (0)
+{
+}
+
+bool
+MqQueueDiscTestDevice::Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber)
+{
+  m_nSent++;
+  return true;
+}
+
+uint32_t
+MqQueueDiscTestDevice::GetNSent (void) const
+{
+  return m_nSent;
+}
+
+void
+MqQueueDiscTestDevice::NotifyNewAggregate (void)
+{
+  // multi-queue devices set the number of transmission queues here
+  Ptr<NetDeviceQueueInterface> ndqi = GetObject<NetDeviceQueueInterface> ();
+  if (ndqi != 0)
+    {
+      ndqi->SetTxQueuesN (4);
+    }
+  SimpleNetDevice::NotifyNewAggregate ();
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Check that mq fans the flows out to per transmission queue children
+ *
+ * Eight flows of three packets each are sent through the traffic control
+ * layer of a device having four transmission queues and no select queue
+ * callback. The packets are mapped to a transmission queue by their flow
+ * hash, thus each child queue disc receives two flows. A stopped transmission
+ * queue only holds back the packets of its own child queue disc.
+ */
+class MqQueueDiscTestCase : public TestCase
+{
+public:
+  MqQueueDiscTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MqQueueDiscTestCase::MqQueueDiscTestCase ()
+  : TestCase ("Flows are spread over the child queue discs of mq")
+{
+}
+
+void
+MqQueueDiscTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<TrafficControlLayer> tc = CreateObject<TrafficControlLayer> ();
+  node->AggregateObject (tc);
+  Ptr<MqQueueDiscTestDevice> dev = CreateObject<MqQueueDiscTestDevice> ();
+  node->AddDevice (dev);
+
+  Ptr<MqQueueDisc> mq = CreateObject<MqQueueDisc> ();
+  mq->SetNetDevice (dev);
+  tc->SetRootQueueDiscOnDevice (dev, mq);
+  tc->Initialize ();
+
+  NS_TEST_ASSERT_MSG_EQ (tc->GetRootQueueDiscOnDevice (dev), mq, "mq not installed");
+  NS_TEST_ASSERT_MSG_EQ (mq->GetNQueueDiscClasses (), 4, "one child per transmission queue expected");
+
+  Ptr<NetDeviceQueueInterface> ndqi = dev->GetObject<NetDeviceQueueInterface> ();
+  ndqi->GetTxQueue (1)->Stop ();
+
+  for (uint32_t flow = 0; flow < 8; flow++)
+    {
+      for (uint32_t i = 0; i < 3; i++)
+        {
+          tc->Send (dev, Create<MqQueueDiscTestItem> (Create<Packet> (100), flow));
+        }
+    }
+
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      Ptr<QueueDisc> child = mq->GetQueueDiscClass (i)->GetQueueDisc ();
+      NS_TEST_ASSERT_MSG_EQ (child->GetTotalReceivedPackets (), 6, "child " << i << " got other flows");
+      NS_TEST_ASSERT_MSG_EQ (child->GetNPackets (), (i == 1 ? 6 : 0), "bad backlog of child " << i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (dev->GetNSent (), 18, "the stopped queue held back other children");
+
+  // waking the transmission queue runs its own child queue disc
+  ndqi->GetTxQueue (1)->Wake ();
+  NS_TEST_ASSERT_MSG_EQ (mq->GetQueueDiscClass (1)->GetQueueDisc ()->GetNPackets (), 0, "child not woken");
+  NS_TEST_ASSERT_MSG_EQ (dev->GetNSent (), 24, "bad number of packets sent");
+
+  // removing the root queue disc sends the packets straight to the device
+  tc->DeleteRootQueueDiscOnDevice (dev);
+  tc->Send (dev, Create<MqQueueDiscTestItem> (Create<Packet> (100), 0));
+  NS_TEST_ASSERT_MSG_EQ (dev->GetNSent (), 25, "packet not sent without queue disc");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief mq queue disc TestSuite
+ */
+static class MqQueueDiscTestSuite : public TestSuite
+{
+public:
+  MqQueueDiscTestSuite ()
+    : TestSuite ("mq-queue-disc", UNIT)
+  {
+    AddTestCase (new MqQueueDiscTestCase (), TestCase::QUICK);
+  }
+} g_mqQueueDiscTestSuite; ///< the test suite
@@ -0,0 +1,180 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/pfabric-queue-disc.h"
+#include "ns3/packet.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Queue disc item of a given flow, identified by the packet size
+ */
+class PfabricQueueDiscTestItem : public QueueDiscItem {
+public:
+  /**
+   * Constructor
+   * \param flow the flow of the packet
+   * \param id the identifier of the packet, used as its size
+   */
+  PfabricQueueDiscTestItem (uint32_t flow, uint32_t id);
+  virtual ~PfabricQueueDiscTestItem ();
+  virtual void AddHeader (void);
+  virtual bool Mark (void);
+  virtual uint32_t Hash (uint32_t perturbation) const;
+
+private:
+  PfabricQueueDiscTestItem ();
+  PfabricQueueDiscTestItem (const PfabricQueueDiscTestItem &);
+  PfabricQueueDiscTestItem &operator = (const PfabricQueueDiscTestItem &);
+
+  uint32_t m_flow; //!< The flow of the packet
+};
+
+PfabricQueueDiscTestItem::PfabricQueueDiscTestItem (uint32_t flow, uint32_t id)
+  : QueueDiscItem (Create<Packet> (id), Address (), 0),
+    m_flow (flow)
+{
+}
+
+PfabricQueueDiscTestItem::~PfabricQueueDiscTestItem ()
+{
+}
+
+void
+PfabricQueueDiscTestItem::AddHeader (void)
+{
+}
+
+bool
+PfabricQueueDiscTestItem::Mark (void)
+{
+  return false;
+}
+
+uint32_t
+PfabricQueueDiscTestItem::Hash (uint32_t perturbation) const
+{
+  return m_flow;
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Check the scheduling and the dropping of PfabricQueueDisc
+ */
+class PfabricQueueDiscTestCase : public TestCase
+{
+public:
+  PfabricQueueDiscTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Enqueue a packet
+   * \param queue the queue disc
+   * \param flow the flow of the packet
+   * \param id the identifier of the packet
+   * \param priority the priority of the packet, 0 for no PfabricTag
+   * \return the value returned by Enqueue
+   */
+  bool Enqueue (Ptr<PfabricQueueDisc> queue, uint32_t flow, uint32_t id, uint64_t priority);
+  /**
+   * \brief Check the order of the dequeued packets
+   * \param queue the queue disc
+   * \param ids the expected identifiers
+   * \param n the number of packets
+   */
+  void CheckOrder (Ptr<PfabricQueueDisc> queue, const uint32_t *ids, uint32_t n);
+};
+
+PfabricQueueDiscTestCase::PfabricQueueDiscTestCase ()
+  : TestCase ("Smallest remaining size first scheduling and dropping")
+{
+}
+
+bool
+PfabricQueueDiscTestCase::Enqueue (Ptr<PfabricQueueDisc> queue, uint32_t flow, uint32_t id, uint64_t priority)
+{
+  Ptr<QueueDiscItem> item = Create<PfabricQueueDiscTestItem> (flow, id);
+  if (priority != 0)
+    {
+      item->GetPacket ()->AddPacketTag (PfabricTag (priority));
+    }
+  return queue->Enqueue (item);
+}
+
+void
+PfabricQueueDiscTestCase::CheckOrder (Ptr<PfabricQueueDisc> queue, const uint32_t *ids, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<QueueDiscItem> item = queue->Dequeue ();
+      NS_TEST_ASSERT_MSG_NE (item, 0, "no packet dequeued");
+      NS_TEST_EXPECT_MSG_EQ (item->GetPacketSize (), ids[i], "bad dequeue order at " << i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (), 0, "queue disc not empty");
+}
+
+void
+PfabricQueueDiscTestCase::DoRun (void)
+{
+  Ptr<PfabricQueueDisc> queue = CreateObject<PfabricQueueDisc> ();
+  queue->Initialize ();
+
+  // the flow of the highest priority packet is served from its first packet
+  Enqueue (queue, 1, 11, 10000);
+  Enqueue (queue, 2, 21, 2500);
+  Enqueue (queue, 1, 12, 9000);
+  Enqueue (queue, 2, 22, 1500);
+  Enqueue (queue, 1, 13, 8000);
+  Enqueue (queue, 3, 31, 0);
+  Enqueue (queue, 4, 41, 9000);
+  uint32_t order[] = { 21, 22, 11, 12, 13, 41, 31 };
+  CheckOrder (queue, order, 7);
+
+  // a full queue drops the lowest priority packet
+  queue = CreateObject<PfabricQueueDisc> ();
+  queue->SetAttribute ("Limit", UintegerValue (3));
+  queue->Initialize ();
+
+  NS_TEST_EXPECT_MSG_EQ (Enqueue (queue, 1, 1, 100), true, "packet dropped");
+  NS_TEST_EXPECT_MSG_EQ (Enqueue (queue, 2, 2, 500), true, "packet dropped");
+  NS_TEST_EXPECT_MSG_EQ (Enqueue (queue, 3, 3, 300), true, "packet dropped");
+  NS_TEST_EXPECT_MSG_EQ (Enqueue (queue, 4, 4, 200), true, "arriving packet dropped");
+  NS_TEST_EXPECT_MSG_EQ (Enqueue (queue, 5, 5, 1000), false, "lowest priority packet accepted");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 3, "bad number of packets");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalDroppedPackets (), 2, "bad number of drops");
+  uint32_t left[] = { 1, 4, 3 };
+  CheckOrder (queue, left, 3);
+
+  Simulator::Destroy ();
+}
+
+static class PfabricQueueDiscTestSuite : public TestSuite
+{
+public:
+  PfabricQueueDiscTestSuite ()
+    : TestSuite ("pfabric-queue-disc", UNIT)
+  {
+    AddTestCase (new PfabricQueueDiscTestCase (), TestCase::QUICK);
+  }
+} g_pfabricQueueDiscTestSuite;
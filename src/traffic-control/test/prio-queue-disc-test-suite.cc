@@ -0,0 +1,212 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/prio-queue-disc.h"
+#include "ns3/packet-filter.h"
+#include "ns3/packet.h"
+#include "ns3/socket.h"
+#include "ns3/uinteger.h"
+#include "ns3/enum.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Queue disc item of the priority queue disc tests
+ */
+class PrioQueueDiscTestItem : public QueueDiscItem {
+public:
+  /**
+   * Constructor
+   * \param p the packet
+   */
+  PrioQueueDiscTestItem (Ptr<Packet> p);
+  virtual ~PrioQueueDiscTestItem ();
+  virtual void AddHeader (void);
+  virtual bool Mark (void);
+
+private:
+  PrioQueueDiscTestItem ();
+  PrioQueueDiscTestItem (const PrioQueueDiscTestItem &);
+  PrioQueueDiscTestItem &operator = (const PrioQueueDiscTestItem &);
+};
+
+PrioQueueDiscTestItem::PrioQueueDiscTestItem (Ptr<Packet> p)
+  : QueueDiscItem (p, Address (), 0)
+{
+}
+
+PrioQueueDiscTestItem::~PrioQueueDiscTestItem ()
+{
+}
+
+void
+PrioQueueDiscTestItem::AddHeader (void)
+{
+}
+
+bool
+PrioQueueDiscTestItem::Mark (void)
+{
+  return false;
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Packet filter sending the packets of 100 bytes to the last band
+ */
+class PrioQueueDiscTestFilter : public PacketFilter {
+private:
+  virtual bool CheckProtocol (Ptr<QueueDiscItem> item) const
+  {
+    return true;
+  }
+  virtual int32_t DoClassify (Ptr<QueueDiscItem> item) const
+  {
+    return item->GetPacketSize () == 100 ? 2 : PF_NO_MATCH;
+  }
+};
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Check the classification and the schedulers of PrioQueueDisc
+ */
+class PrioQueueDiscTestCase : public TestCase
+{
+public:
+  PrioQueueDiscTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Enqueue a packet
+   * \param queue the queue disc
+   * \param size the size of the packet
+   * \param priority the priority carried by the packet
+   */
+  void Enqueue (Ptr<PrioQueueDisc> queue, uint32_t size, uint8_t priority);
+};
+
+PrioQueueDiscTestCase::PrioQueueDiscTestCase ()
+  : TestCase ("Strict and weighted priority scheduling")
+{
+}
+
+void
+PrioQueueDiscTestCase::Enqueue (Ptr<PrioQueueDisc> queue, uint32_t size, uint8_t priority)
+{
+  Ptr<Packet> p = Create<Packet> (size);
+  SocketPriorityTag tag;
+  tag.SetPriority (priority);
+  p->AddPacketTag (tag);
+  queue->Enqueue (Create<PrioQueueDiscTestItem> (p));
+}
+
+void
+PrioQueueDiscTestCase::DoRun (void)
+{
+  // strict priority: the priomap and the filter select the band
+  Ptr<PrioQueueDisc> queue = CreateObject<PrioQueueDisc> ();
+  queue->AddPacketFilter (CreateObject<PrioQueueDiscTestFilter> ());
+  queue->SetBandForPriority (3, 0);
+  queue->Initialize ();
+
+  Enqueue (queue, 100, 6);   // band 2 by the filter
+  Enqueue (queue, 200, 0);   // band 1 by the priomap
+  Enqueue (queue, 300, 6);   // band 0 by the priomap
+  Enqueue (queue, 400, 3);   // band 0 as configured
+  Enqueue (queue, 500, 2);   // band 2 by the priomap
+
+  uint32_t order[] = { 300, 400, 200, 100, 500 };
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      Ptr<QueueDiscItem> item = queue->Dequeue ();
+      NS_TEST_ASSERT_MSG_NE (item, 0, "no packet dequeued");
+      NS_TEST_EXPECT_MSG_EQ (item->GetPacketSize (), order[i], "bad dequeue order at " << i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (), 0, "queue disc not empty");
+
+  // weighted: band 0 sends three times the bytes of band 1
+  queue = CreateObject<PrioQueueDisc> ();
+  queue->SetAttribute ("Bands", UintegerValue (2));
+  queue->SetAttribute ("Scheduler", EnumValue (PrioQueueDisc::WEIGHTED));
+  queue->SetAttribute ("Quantum", UintegerValue (1000));
+  queue->SetQuantum (0, 3000);
+  queue->SetBandForPriority (0, 0);
+  queue->SetBandForPriority (1, 1);
+  queue->Initialize ();
+
+  for (uint32_t i = 0; i < 30; i++)
+    {
+      Enqueue (queue, 1000, 0);
+      Enqueue (queue, 1000, 1);
+    }
+  uint32_t high = 0;
+  for (uint32_t i = 0; i < 20; i++)
+    {
+      Ptr<const QueueDiscItem> peeked = queue->Peek ();
+      Ptr<QueueDiscItem> item = queue->Dequeue ();
+      NS_TEST_EXPECT_MSG_EQ (PeekPointer (peeked), PeekPointer (item), "peeked packet not dequeued at " << i);
+      SocketPriorityTag tag;
+      item->GetPacket ()->PeekPacketTag (tag);
+      high += (tag.GetPriority () == 0);
+    }
+  NS_TEST_EXPECT_MSG_EQ (high, 15, "bad share of the weighted bands");
+
+  // a band with no backlog does not stall the other ones
+  for (uint32_t i = 0; i < 40; i++)
+    {
+      Ptr<const QueueDiscItem> peeked = queue->Peek ();
+      Ptr<QueueDiscItem> item = queue->Dequeue ();
+      NS_TEST_ASSERT_MSG_NE (item, 0, "packet not dequeued");
+      NS_TEST_EXPECT_MSG_EQ (PeekPointer (peeked), PeekPointer (item), "peeked packet not dequeued at " << i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->Peek (), 0, "queue disc not empty");
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (), 0, "queue disc not empty");
+
+  // the peeked packet is the next dequeued one with packets of any size
+  uint32_t sizes[] = { 1500, 200, 900, 1400, 300, 1200, 600, 1000 };
+  for (uint32_t i = 0; i < 40; i++)
+    {
+      Enqueue (queue, sizes[i % 8], i % 2);
+    }
+  for (uint32_t i = 0; i < 40; i++)
+    {
+      Ptr<const QueueDiscItem> peeked = queue->Peek ();
+      NS_TEST_EXPECT_MSG_EQ (PeekPointer (peeked), PeekPointer (queue->Peek ()), "peek changed the state at " << i);
+      Ptr<QueueDiscItem> item = queue->Dequeue ();
+      NS_TEST_ASSERT_MSG_NE (item, 0, "packet not dequeued");
+      NS_TEST_EXPECT_MSG_EQ (PeekPointer (peeked), PeekPointer (item), "peeked packet not dequeued at " << i);
+    }
+
+  Simulator::Destroy ();
+}
+
+static class PrioQueueDiscTestSuite : public TestSuite
+{
+public:
+  PrioQueueDiscTestSuite ()
+    : TestSuite ("prio-queue-disc", UNIT)
+  {
+    AddTestCase (new PrioQueueDiscTestCase (), TestCase::QUICK);
+  }
+} g_prioQueueDiscTestSuite;
@@ -161,6 +161,12 @@ VisualSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay, E
   m_simulator->ScheduleWithContext (context, delay, event);
 }
 
+EventId
+VisualSimulatorImpl::ScheduleInContext (uint32_t context, Time const &delay, EventImpl *event)
+{
+  return m_simulator->ScheduleInContext (context, delay, event);
+}
+
 EventId
 VisualSimulatorImpl::ScheduleNow (EventImpl *event)
 {
@@ -215,6 +221,24 @@ VisualSimulatorImpl::GetContext (void) const
   return m_simulator->GetContext ();
 }
 
+uint32_t
+VisualSimulatorImpl::GetEventCount (void) const
+{
+  return m_simulator->GetEventCount ();
+}
+
+uint32_t
+VisualSimulatorImpl::GetCancelledEventCount (void) const
+{
+  return m_simulator->GetCancelledEventCount ();
+}
+
+bool
+VisualSimulatorImpl::IsConcurrent (void) const
+{
+  return m_simulator->IsConcurrent ();
+}
+
 void
 VisualSimulatorImpl::RunRealSimulator (void)
 {
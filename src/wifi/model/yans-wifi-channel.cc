@@ -26,9 +26,11 @@
 #include "ns3/log.h"
 #include "ns3/pointer.h"
 #include "ns3/object-factory.h"
+#include "ns3/double.h"
 #include "yans-wifi-channel.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
+#include <limits>
 
 namespace ns3 {
 
@@ -51,11 +53,31 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("MaxRange",
+                   "The distance in meters beyond which packets are not delivered. "
+                   "Receivers out of range get no receive event at all, and are "
+                   "found without visiting every PHY on the channel. 0 means that "
+                   "the range is not set explicitly (see RxSensitivity).",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("RxSensitivity",
+                   "If MaxRange is 0, packets are not delivered beyond the distance "
+                   "at which the PropagationLossModel brings their power below this "
+                   "value, in dBm. The distance is derived once for each tx power, "
+                   "which assumes a deterministic loss that grows with distance: "
+                   "with random loss models set MaxRange instead. The default value "
+                   "corresponds to delivering every packet.",
+                   DoubleValue (-1.0e9),
+                   MakeDoubleAccessor (&YansWifiChannel::m_rxSensitivityDbm),
+                   MakeDoubleChecker<double> ())
   ;
   return tid;
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_maxRange (0),
+    m_rxSensitivityDbm (-1.0e9)
 {
 }
 
@@ -69,6 +91,7 @@ void
 YansWifiChannel::SetPropagationLossModel (Ptr<PropagationLossModel> loss)
 {
   m_loss = loss;
+  m_ranges.clear ();
 }
 
 void
@@ -83,24 +106,45 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
 {
   Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT (senderMobility != 0);
-  uint32_t j = 0;
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
+  double range = GetMaxRange (txPowerDbm);
+  bool bounded = range < std::numeric_limits<double>::infinity ();
+  if (bounded)
     {
-      if (sender != (*i))
+      if (m_index.GetN () != m_phyList.size ())
+        {
+          m_index.Clear ();
+          m_index.SetCellSize (range);
+          for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++)
+            {
+              m_index.Add ((*i)->GetMobility ()->GetObject<MobilityModel> ());
+            }
+        }
+      m_index.GetCandidates (senderMobility->GetPosition (), range, m_candidates);
+    }
+  uint32_t n = bounded ? m_candidates.size () : m_phyList.size ();
+  for (uint32_t k = 0; k < n; k++)
+    {
+      uint32_t j = bounded ? m_candidates[k] : k;
+      Ptr<YansWifiPhy> phy = m_phyList[j];
+      if (sender != phy)
         {
           //For now don't account for inter channel interference
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
+          if (phy->GetChannelNumber () != sender->GetChannelNumber ())
             {
               continue;
             }
 
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
+          Ptr<MobilityModel> receiverMobility = phy->GetMobility ()->GetObject<MobilityModel> ();
+          if (bounded && senderMobility->GetDistanceFrom (receiverMobility) > range)
+            {
+              continue;
+            }
           Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
           double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
           NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
                         "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
           Ptr<Packet> copy = packet->Copy ();
-          Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
+          Ptr<Object> dstNetDevice = phy->GetDevice ();
           uint32_t dstNode;
           if (dstNetDevice == 0)
             {
@@ -131,6 +175,25 @@ YansWifiChannel::Receive (uint32_t i, Ptr<Packet> packet, struct Parameters para
   m_phyList[i]->StartReceivePreambleAndHeader (packet, parameters.rxPowerDbm, parameters.txVector, parameters.preamble, parameters.type, parameters.duration);
 }
 
+double
+YansWifiChannel::GetMaxRange (double txPowerDbm) const
+{
+  if (m_maxRange > 0)
+    {
+      return m_maxRange;
+    }
+  if (m_rxSensitivityDbm <= -1.0e9)
+    {
+      return std::numeric_limits<double>::infinity ();
+    }
+  std::map<double, double>::const_iterator it = m_ranges.find (txPowerDbm);
+  if (it == m_ranges.end ())
+    {
+      it = m_ranges.insert (std::make_pair (txPowerDbm, m_loss->GetMaxRange (txPowerDbm, m_rxSensitivityDbm))).first;
+    }
+  return it->second;
+}
+
 uint32_t
 YansWifiChannel::GetNDevices (void) const
 {
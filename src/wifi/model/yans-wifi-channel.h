@@ -30,6 +30,8 @@
 #include "wifi-tx-vector.h"
 #include "yans-wifi-phy.h"
 #include "ns3/nstime.h"
+#include "ns3/spatial-index.h"
+#include <map>
 
 namespace ns3 {
 
@@ -99,6 +101,10 @@ public:
    * currently invoked only from WifiPhy::Send. YansWifiChannel
    * delivers packets only between PHYs with the same m_channelNumber,
    * e.g. PHYs that are operating on the same channel.
+   *
+   * If the MaxRange or RxSensitivity attribute bounds the delivery
+   * range, only the PHYs within range of the sender, as found through a
+   * SpatialIndex over their mobility models, get a receive event.
    */
   void Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
              WifiTxVector txVector, WifiPreamble preamble, enum mpduType mpdutype, Time duration) const;
@@ -134,9 +140,21 @@ private:
    */
   void Receive (uint32_t i, Ptr<Packet> packet, struct Parameters parameters) const;
 
+  /**
+   * \param txPowerDbm the tx power of a packet
+   * \return the distance beyond which the packet is not delivered, or
+   * infinity if it is delivered to every PHY
+   */
+  double GetMaxRange (double txPowerDbm) const;
+
   PhyList m_phyList;                   //!< List of YansWifiPhys connected to this YansWifiChannel
   Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
+  double m_maxRange;                   //!< Explicit delivery range in meters, 0 if none
+  double m_rxSensitivityDbm;           //!< Power below which packets are not delivered
+  mutable std::map<double, double> m_ranges;  //!< Delivery range for each tx power seen
+  mutable SpatialIndex m_index;        //!< Grid over the PHY positions, built on the first bounded Send
+  mutable std::vector<uint32_t> m_candidates; //!< Scratch list of PHY indices for Send
 };
 
 } //namespace ns3
@@ -29,6 +29,9 @@
 #include "ns3/propagation-loss-model.h"
 #include "ns3/yans-error-rate-model.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/double.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/test.h"
 #include "ns3/pointer.h"
 #include "ns3/rng-seed-manager.h"
@@ -1090,6 +1093,187 @@ Bug2222TestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_countInternalCollisions, 1, "unexpected number of internal collisions!");
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that a YansWifiChannel bounded by MaxRange or RxSensitivity
+ * delivers each packet to exactly the PHYs that a scan of every PHY with
+ * the same cutoff distance finds, while some PHYs move at a constant
+ * velocity and others jump to new positions.
+ */
+
+class YansWifiChannelRangeTest : public TestCase
+{
+public:
+  YansWifiChannelRangeTest ();
+  virtual ~YansWifiChannelRangeTest ();
+
+  virtual void DoRun (void);
+
+
+private:
+  /**
+   * Run the transmissions on a channel.
+   *
+   * \param maxRange the MaxRange of the channel
+   * \param rxSensitivity the RxSensitivity of the channel
+   */
+  void RunOne (double maxRange, double rxSensitivity);
+  void Transmit (void);
+  void Check (void);
+  void Jump (void);
+  void Receive (std::string context, Ptr<const Packet> p);
+
+  Ptr<YansWifiChannel> m_channel;
+  std::vector<Ptr<YansWifiPhy> > m_phys;
+  std::vector<Ptr<ConstantPositionMobilityModel> > m_fixed;
+  std::vector<uint32_t> m_received;
+  std::vector<bool> m_expected;
+  Ptr<UniformRandomVariable> m_random;
+  double m_txPowerDbm;
+  double m_range;
+  uint32_t m_inRange;
+  uint32_t m_outOfRange;
+};
+
+YansWifiChannelRangeTest::YansWifiChannelRangeTest ()
+  : TestCase ("Test case for the receivers of a YansWifiChannel with a range"),
+    m_txPowerDbm (16.0206),
+    m_range (0),
+    m_inRange (0),
+    m_outOfRange (0)
+{
+}
+
+YansWifiChannelRangeTest::~YansWifiChannelRangeTest ()
+{
+}
+
+void
+YansWifiChannelRangeTest::Receive (std::string context, Ptr<const Packet> p)
+{
+  m_received[atoi (context.c_str ())]++;
+}
+
+void
+YansWifiChannelRangeTest::Transmit (void)
+{
+  uint32_t sender = m_random->GetInteger (0, m_phys.size () - 1);
+  Ptr<MobilityModel> senderMobility = m_phys[sender]->GetMobility ();
+  for (uint32_t i = 0; i < m_phys.size (); i++)
+    {
+      m_received[i] = 0;
+      m_expected[i] = i != sender
+        && senderMobility->GetDistanceFrom (m_phys[i]->GetMobility ()) <= m_range;
+      if (i != sender)
+        {
+          m_inRange += m_expected[i] ? 1 : 0;
+          m_outOfRange += m_expected[i] ? 0 : 1;
+        }
+    }
+
+  WifiTxVector txVector = WifiTxVector (WifiPhy::GetOfdmRate6Mbps (), 0, 0, false, 1, 0, 20000000, false, false);
+  m_channel->Send (m_phys[sender], Create<Packet> (100), m_txPowerDbm, txVector,
+                   WIFI_PREAMBLE_LONG, NORMAL_MPDU, MicroSeconds (200));
+  Simulator::Schedule (MilliSeconds (1), &YansWifiChannelRangeTest::Check, this);
+}
+
+void
+YansWifiChannelRangeTest::Check (void)
+{
+  for (uint32_t i = 0; i < m_phys.size (); i++)
+    {
+      uint32_t expected = m_expected[i] ? 1 : 0;
+      NS_TEST_ASSERT_MSG_EQ (m_received[i], expected,
+                             "PHY " << i << " at " << Simulator::Now ().GetSeconds () << "s");
+    }
+}
+
+void
+YansWifiChannelRangeTest::Jump (void)
+{
+  Ptr<ConstantPositionMobilityModel> mobility = m_fixed[m_random->GetInteger (0, m_fixed.size () - 1)];
+  mobility->SetPosition (Vector (m_random->GetValue (0, 300), m_random->GetValue (0, 300), 0));
+}
+
+void
+YansWifiChannelRangeTest::RunOne (double maxRange, double rxSensitivity)
+{
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_random->SetStream (1);
+  Ptr<PropagationLossModel> loss = CreateObject<LogDistancePropagationLossModel> ();
+  m_channel = CreateObject<YansWifiChannel> ();
+  m_channel->SetPropagationLossModel (loss);
+  m_channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  m_channel->SetAttribute ("MaxRange", DoubleValue (maxRange));
+  m_channel->SetAttribute ("RxSensitivity", DoubleValue (rxSensitivity));
+  m_range = maxRange > 0 ? maxRange : loss->GetMaxRange (m_txPowerDbm, rxSensitivity);
+
+  for (uint32_t i = 0; i < 60; i++)
+    {
+      Ptr<MobilityModel> mobility;
+      Vector position (m_random->GetValue (0, 300), m_random->GetValue (0, 300), 0);
+      if (i % 2 == 0)
+        {
+          Ptr<ConstantPositionMobilityModel> fixed = CreateObject<ConstantPositionMobilityModel> ();
+          m_fixed.push_back (fixed);
+          mobility = fixed;
+        }
+      else
+        {
+          Ptr<ConstantVelocityMobilityModel> moving = CreateObject<ConstantVelocityMobilityModel> ();
+          moving->SetVelocity (Vector (m_random->GetValue (-30, 30), m_random->GetValue (-30, 30), 0));
+          mobility = moving;
+        }
+      mobility->SetPosition (position);
+      Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+      phy->SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+      phy->SetMobility (mobility);
+      phy->SetChannel (m_channel);
+      phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+      // every packet is dropped at once, so that the PHYs stay idle
+      phy->SetAttribute ("EnergyDetectionThreshold", DoubleValue (100));
+      std::ostringstream context;
+      context << i;
+      phy->TraceConnect ("PhyRxBegin", context.str (), MakeCallback (&YansWifiChannelRangeTest::Receive, this));
+      phy->TraceConnect ("PhyRxDrop", context.str (), MakeCallback (&YansWifiChannelRangeTest::Receive, this));
+      m_phys.push_back (phy);
+    }
+  m_received.resize (m_phys.size ());
+  m_expected.resize (m_phys.size ());
+
+  for (uint32_t i = 0; i < 300; i++)
+    {
+      Simulator::Schedule (MilliSeconds (10 * i + 5), &YansWifiChannelRangeTest::Transmit, this);
+      if (i % 5 == 0)
+        {
+          Simulator::Schedule (MilliSeconds (10 * i), &YansWifiChannelRangeTest::Jump, this);
+        }
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  for (uint32_t i = 0; i < m_phys.size (); i++)
+    {
+      m_phys[i]->Dispose ();
+    }
+  m_phys.clear ();
+  m_fixed.clear ();
+  m_channel = 0;
+}
+
+void
+YansWifiChannelRangeTest::DoRun (void)
+{
+  RunOne (60, -1.0e9);
+  // the range of LogDistancePropagationLossModel for -80 dBm is about 44m
+  RunOne (0, -80);
+  NS_TEST_ASSERT_MSG_GT (m_range, 40, "unexpected range for the sensitivity");
+  NS_TEST_ASSERT_MSG_LT (m_range, 50, "unexpected range for the sensitivity");
+
+  NS_TEST_ASSERT_MSG_GT (m_inRange, 0, "no PHY in range");
+  NS_TEST_ASSERT_MSG_GT (m_outOfRange, 0, "no PHY out of range");
+}
+
 //-----------------------------------------------------------------------------
 
 class WifiTestSuite : public TestSuite
@@ -1108,6 +1292,7 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new Bug730TestCase, TestCase::QUICK); //Bug 730
   AddTestCase (new SetChannelFrequencyTest, TestCase::QUICK);
   AddTestCase (new Bug2222TestCase, TestCase::QUICK); //Bug 2222
+  AddTestCase (new YansWifiChannelRangeTest, TestCase::QUICK);
 }
 
 static WifiTestSuite g_wifiTestSuite;
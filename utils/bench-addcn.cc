@@ -0,0 +1,101 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ip-l3_5-protocol-helper.h"
+#include "ns3/addcn-l3_5-protocol.h"
+#include "ns3/c3-tag.h"
+#include <iostream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/*
+ * Send n tagged packets round-robin to a number of tunnels through the
+ * ADDCN protocol of a host, then look the tunnels up n times.
+ */
+static void
+runBench (uint32_t n, uint32_t tunnels)
+{
+  NodeContainer nodes;
+  nodes.Create (1);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  dcn::IpL3_5ProtocolHelper addcn ("ns3::dcn::ADDCNL3_5Protocol");
+  addcn.AddIpL4Protocol ("ns3::UdpL4Protocol");
+  addcn.Install (nodes);
+  Ptr<dcn::ADDCNL3_5Protocol> protocol = nodes.Get (0)->GetObject<dcn::ADDCNL3_5Protocol> ();
+
+  dcn::C3Tag tag;
+  tag.SetFlowSize (1000000);
+  Ptr<Packet> packet = Create<Packet> (100);
+  packet->AddPacketTag (tag);
+  Ipv4Address source ("10.0.0.1");
+
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      protocol->Send (packet->Copy (), source, Ipv4Address (0x0b000000 + i % tunnels), 17, 0);
+    }
+  uint64_t sendMs = time.End ();
+
+  time.Start ();
+  uint32_t found = 0;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      found += protocol->GetFlow (source, Ipv4Address (0x0b000000 + (i * 2654435761u) % tunnels), 17) != 0;
+    }
+  uint64_t lookupMs = time.End ();
+  NS_ASSERT (found == n);
+
+  std::cout << "tunnels=" << protocol->GetNFlows ()
+            << "\t" << n * 1000.0 / std::max<uint64_t> (sendMs, 1) << " packets/s"
+            << " (" << sendMs << " ms)"
+            << "\t" << n * 1000.0 / std::max<uint64_t> (lookupMs, 1) << " lookups/s"
+            << " (" << lookupMs << " ms)" << std::endl;
+  protocol = 0;
+  Simulator::Destroy ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the tunnel table of the ADDCN protocol");
+  cmd.AddValue ("n", "number of packets", n);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of packets must be specified " <<
+        "by command-line argument --n=(number of packets)" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-addcn with n=" << n << std::endl;
+
+  uint32_t tunnels[] = { 1000, 10000, 100000 };
+  for (uint32_t i = 0; i < sizeof (tunnels) / sizeof (tunnels[0]); ++i)
+    {
+      runBench (n, tunnels[i]);
+    }
+  return 0;
+}
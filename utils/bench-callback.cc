@@ -0,0 +1,195 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/callback.h"
+#include "ns3/traced-callback.h"
+#include "ns3/traced-value.h"
+#include "ns3/object.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Stands for a protocol or device with a receive handler.
+ */
+class Handler : public Object
+{
+public:
+  Handler () : m_count (0) {}
+  /**
+   * Count a call.
+   * \param ptr a pointer argument
+   * \param protocol an integer argument
+   */
+  void Receive (Ptr<Object> ptr, uint16_t protocol)
+  {
+    m_count += protocol;
+  }
+  uint64_t m_count; //!< sum of the protocols received
+};
+
+static uint64_t g_count = 0; //!< sum of the protocols received by Receive
+
+/**
+ * A static handler with one bound argument.
+ * \param handler the bound handler
+ * \param ptr a pointer argument
+ * \param protocol an integer argument
+ */
+static void
+Receive (Ptr<Handler> handler, Ptr<Object> ptr, uint16_t protocol)
+{
+  g_count += protocol;
+}
+
+static void
+Report (std::string name, uint32_t iterations, uint64_t ms)
+{
+  std::cout << name << "\titerations=" << iterations << "\t" << ms << " ms\t"
+            << (ms * 1e6 / iterations) << " ns/op" << std::endl;
+}
+
+static void
+runInvoke (std::string name, Callback<void, Ptr<Object>, uint16_t> cb, uint32_t iterations)
+{
+  Ptr<Object> arg = CreateObject<Object> ();
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < iterations; ++i)
+    {
+      cb (arg, 1);
+    }
+  Report (name, iterations, time.End ());
+}
+
+static void
+runCopy (std::string name, Callback<void, Ptr<Object>, uint16_t> cb, uint32_t iterations)
+{
+  std::vector<Callback<void, Ptr<Object>, uint16_t> > slots (16);
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < iterations; ++i)
+    {
+      slots[i & 15] = cb;
+    }
+  Report (name, iterations, time.End ());
+}
+
+static void
+runMake (Ptr<Handler> handler, uint32_t iterations)
+{
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < iterations; ++i)
+    {
+      Callback<void, Ptr<Object>, uint16_t> cb = MakeCallback (&Handler::Receive, handler);
+    }
+  Report ("make", iterations, time.End ());
+}
+
+/*
+ * Connect and disconnect a handler to a trace source with other
+ * handlers connected, which compares callbacks with IsEqual.
+ */
+static void
+runDisconnect (uint32_t iterations)
+{
+  std::vector<Ptr<Handler> > handlers;
+  TracedCallback<Ptr<Object>, uint16_t> trace;
+  for (uint32_t i = 0; i < 8; ++i)
+    {
+      handlers.push_back (CreateObject<Handler> ());
+      trace.ConnectWithoutContext (MakeCallback (&Handler::Receive, handlers.back ()));
+    }
+  Ptr<Handler> handler = CreateObject<Handler> ();
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < iterations; ++i)
+    {
+      trace.ConnectWithoutContext (MakeCallback (&Handler::Receive, handler));
+      trace.DisconnectWithoutContext (MakeCallback (&Handler::Receive, handler));
+    }
+  Report ("connect+disconnect", iterations, time.End ());
+}
+
+/*
+ * Fire a trace source with no sink connected, as most trace sources are
+ * in a simulation.
+ */
+static void
+runEmptyTrace (uint32_t iterations)
+{
+  TracedCallback<Ptr<Object>, uint16_t> trace;
+  Ptr<Object> arg = CreateObject<Object> ();
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < iterations; ++i)
+    {
+      trace (arg, 1);
+    }
+  Report ("empty trace", iterations, time.End ());
+}
+
+/*
+ * Update a TracedValue with no sink connected, like a congestion window
+ * on every ACK, and the same with the trace source compiled out.
+ */
+template <bool ENABLED>
+static void
+runTracedValue (std::string name, uint32_t iterations)
+{
+  TracedValue<uint32_t, ENABLED> value = 0;
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < iterations; ++i)
+    {
+      value += 1448;
+    }
+  g_count += value;
+  Report (name, iterations, time.End ());
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t iterations = 10000000;
+
+  CommandLine cmd;
+  cmd.AddValue ("iterations", "number of iterations of each benchmark", iterations);
+  cmd.Parse (argc, argv);
+
+  Ptr<Handler> handler = CreateObject<Handler> ();
+  Callback<void, Ptr<Object>, uint16_t> member = MakeCallback (&Handler::Receive, handler);
+  Callback<void, Ptr<Object>, uint16_t> raw = MakeCallback (&Handler::Receive, PeekPointer (handler));
+  Callback<void, Ptr<Object>, uint16_t> bound = MakeBoundCallback (&Receive, handler);
+
+  runInvoke ("invoke member", member, iterations);
+  runInvoke ("invoke raw member", raw, iterations);
+  runInvoke ("invoke bound", bound, iterations);
+  runCopy ("copy member", member, iterations);
+  runCopy ("copy bound", bound, iterations);
+  runMake (handler, iterations);
+  runDisconnect (iterations / 10);
+  runEmptyTrace (iterations);
+  runTracedValue<true> ("traced value", iterations);
+  runTracedValue<false> ("compiled out traced value", iterations);
+
+  std::cout << "checksum " << handler->m_count + g_count << std::endl;
+  return 0;
+}
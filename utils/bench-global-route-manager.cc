@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simple-channel.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include <iostream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/*
+ * Build a k-ary fat tree of switches, with a /24 of hosts on each edge
+ * switch, and return the edge side of the first edge-aggregation link.
+ */
+static NetDeviceContainer
+buildFatTree (uint32_t k)
+{
+  uint32_t half = k / 2;
+  NodeContainer cores, aggs, edges;
+  cores.Create (half * half);
+  aggs.Create (k * half);
+  edges.Create (k * half);
+  InternetStackHelper internet;
+  internet.SetRoutingHelper (Ipv4GlobalRoutingHelper ());
+  internet.Install (cores);
+  internet.Install (aggs);
+  internet.Install (edges);
+
+  SimpleNetDeviceHelper p2p;
+  p2p.SetNetDevicePointToPointMode (true);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.0.0.0", "255.255.255.252");
+  NetDeviceContainer first;
+  for (uint32_t p = 0; p < k; ++p)
+    {
+      for (uint32_t a = 0; a < half; ++a)
+        {
+          Ptr<Node> agg = aggs.Get (p * half + a);
+          for (uint32_t e = 0; e < half; ++e)
+            {
+              NetDeviceContainer devices = p2p.Install (NodeContainer (edges.Get (p * half + e), agg),
+                                                        CreateObject<SimpleChannel> ());
+              ipv4.Assign (devices);
+              ipv4.NewNetwork ();
+              if (first.GetN () == 0)
+                {
+                  first = devices;
+                }
+            }
+          for (uint32_t c = 0; c < half; ++c)
+            {
+              ipv4.Assign (p2p.Install (NodeContainer (agg, cores.Get (a * half + c)),
+                                        CreateObject<SimpleChannel> ()));
+              ipv4.NewNetwork ();
+            }
+        }
+    }
+  SimpleNetDeviceHelper hosts;
+  ipv4.SetBase ("172.16.0.0", "255.255.255.0");
+  for (uint32_t e = 0; e < edges.GetN (); ++e)
+    {
+      ipv4.Assign (hosts.Install (edges.Get (e), CreateObject<SimpleChannel> ()));
+      ipv4.NewNetwork ();
+    }
+  return first;
+}
+
+static uint64_t
+recompute (std::string mode)
+{
+  Config::SetGlobal ("GlobalRoutingSpfMode", StringValue (mode));
+  SystemWallClockMs time;
+  time.Start ();
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  return time.End ();
+}
+
+static void
+runBench (uint32_t k)
+{
+  NetDeviceContainer link = buildFatTree (k);
+  Ptr<Ipv4> ipv4 = link.Get (0)->GetNode ()->GetObject<Ipv4> ();
+  uint32_t interface = ipv4->GetInterfaceForDevice (link.Get (0));
+
+  uint64_t legacy = recompute ("Legacy");
+  uint64_t parallel = recompute ("Parallel");
+  recompute ("Incremental");
+  ipv4->SetDown (interface);
+  uint64_t down = recompute ("Incremental");
+  ipv4->SetUp (interface);
+  uint64_t up = recompute ("Incremental");
+  std::cout << "k=" << k << " routers=" << 5 * k * k / 4
+            << "\tlegacy " << legacy << " ms"
+            << "\tparallel " << parallel << " ms"
+            << "\tincremental link down " << down << " ms"
+            << " link up " << up << " ms" << std::endl;
+  Simulator::Destroy ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t k = 0;
+  uint32_t threads = 0;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the SPF modes of the global route manager on fat trees");
+  cmd.AddValue ("k", "largest arity of the fat trees", k);
+  cmd.AddValue ("threads", "number of SPF threads, 0 for one per CPU", threads);
+  cmd.Parse (argc, argv);
+
+  if (k < 4 || k % 2 != 0)
+    {
+      std::cerr << "Error-- the arity must be specified " <<
+        "by command-line argument --k=(even number, at least 4)" << std::endl;
+      exit (1);
+    }
+  Config::SetGlobal ("GlobalRoutingSpfThreads", UintegerValue (threads));
+  std::cout << "Running bench-global-route-manager with k=" << k << std::endl;
+
+  for (uint32_t i = 4; i <= k; i *= 2)
+    {
+      runBench (i);
+    }
+  return 0;
+}
@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/enum.h"
+#include "ns3/node.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/udp-header.h"
+#include <iostream>
+#include <sstream>
+#include <stdlib.h> // for exit ()
+#include <limits>
+#include <algorithm>
+
+using namespace ns3;
+
+/*
+ * Look up routes in the table of a switch of a data center: one host
+ * route and one /24 network with ecmp equal-cost next hops per rack,
+ * destinations drawn among all the hosts of all the racks.
+ */
+static void
+benchLookup (uint32_t n, uint32_t racks, uint32_t ecmp, LookupMode_t lookupMode, EcmpMode_t ecmpMode)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  InternetStackHelper internet;
+  internet.Install (node);
+  SimpleNetDeviceHelper devHelper;
+  Ipv4AddressHelper ipv4;
+  for (uint32_t i = 0; i < ecmp; ++i)
+    {
+      std::ostringstream base;
+      base << "192.168." << i << ".0";
+      ipv4.SetBase (base.str ().c_str (), "255.255.255.0");
+      ipv4.Assign (devHelper.Install (node));
+    }
+
+  Ptr<Ipv4GlobalRouting> routing = CreateObject<Ipv4GlobalRouting> ();
+  routing->SetAttribute ("LookupMode", EnumValue (lookupMode));
+  routing->SetAttribute ("EcmpMode", EnumValue (ecmpMode));
+  routing->SetIpv4 (node->GetObject<Ipv4> ());
+  for (uint32_t r = 0; r < racks; ++r)
+    {
+      Ipv4Address network (0x0a000000 | (r << 8));
+      for (uint32_t i = 0; i < ecmp; ++i)
+        {
+          Ipv4Address gateway (0xc0a80002 | (i << 8));
+          routing->AddHostRouteTo (Ipv4Address (network.Get () | 1), gateway, i + 1);
+          routing->AddNetworkRouteTo (network, Ipv4Mask ("/24"), gateway, i + 1);
+        }
+    }
+
+  Ptr<Packet> p = Create<Packet> (100);
+  UdpHeader udp;
+  udp.SetDestinationPort (9);
+  Ipv4Header header;
+  header.SetSource (Ipv4Address ("192.168.0.1"));
+  header.SetProtocol (17);
+  Socket::SocketErrno err;
+  uint32_t found = 0;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      uint32_t rack = (i * 2654435761u) % racks;
+      header.SetDestination (Ipv4Address (0x0a000000 | (rack << 8) | (2 + i % 250)));
+      Ptr<Packet> q = p->Copy ();
+      udp.SetSourcePort (i & 0xffff);
+      q->AddHeader (udp);
+      found += routing->RouteOutput (q, header, 0, err) != 0 ? 1 : 0;
+    }
+  NS_ASSERT (found == n);
+  routing->Dispose ();
+  Simulator::Destroy ();
+}
+
+static uint64_t
+runBenchOneIteration (uint32_t n, uint32_t racks, uint32_t ecmp, LookupMode_t lookupMode, EcmpMode_t ecmpMode)
+{
+  SystemWallClockMs time;
+  time.Start ();
+  benchLookup (n, racks, ecmp, lookupMode, ecmpMode);
+  uint64_t deltaMs = time.End ();
+  return deltaMs;
+}
+
+static void
+runBench (uint32_t n, uint32_t minIterations, uint32_t racks, uint32_t ecmp,
+          LookupMode_t lookupMode, EcmpMode_t ecmpMode)
+{
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      uint64_t delay = runBenchOneIteration (n, racks, ecmp, lookupMode, ecmpMode);
+      minDelay = std::min (minDelay, delay);
+    }
+  double ps = n;
+  ps *= 1000;
+  ps /= std::max<uint64_t> (minDelay, 1);
+  std::cout << ps << " lookups/s"
+            << " (" << minDelay << " ms elapsed)\t"
+            << "racks=" << racks << " ecmp=" << ecmp
+            << (lookupMode == LOOKUP_TRIE ? " trie" : " list")
+            << (ecmpMode == ECMP_HASH ? " hash" : " first")
+            << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t minIterations = 1;
+  uint32_t ecmp = 4;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the route lookup of Ipv4GlobalRouting");
+  cmd.AddValue ("n", "number of lookups", n);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
+  cmd.AddValue ("ecmp", "number of equal-cost next hops", ecmp);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of lookups must be specified " <<
+        "by command-line argument --n=(number of lookups)" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-ipv4-global-routing with n=" << n << std::endl;
+
+  uint32_t racks[] = { 16, 256, 4096 };
+  for (uint32_t i = 0; i < sizeof (racks) / sizeof (racks[0]); ++i)
+    {
+      runBench (n, minIterations, racks[i], ecmp, LOOKUP_LIST, ECMP_HASH);
+      runBench (n, minIterations, racks[i], ecmp, LOOKUP_TRIE, ECMP_HASH);
+      runBench (n, minIterations, racks[i], ecmp, LOOKUP_TRIE, ECMP_NONE);
+    }
+
+  return 0;
+}
@@ -27,6 +27,13 @@
 #include <stdlib.h> // for exit ()
 #include <limits>
 #include <algorithm>
+#ifdef NS3_BENCH_DEMUX
+#include <map>
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv6-interface.h"
+#include "ns3/ip-l4-protocol-table.h"
+#endif
 
 using namespace ns3;
 
@@ -302,6 +309,116 @@ benchByteTags (uint32_t n)
     }
 }
 
+#ifdef NS3_BENCH_DEMUX
+/**
+ * L4 protocol counting the packets it receives.
+ */
+class BenchL4Protocol : public IpL4Protocol
+{
+public:
+  BenchL4Protocol (int protocolNumber)
+    : m_protocolNumber (protocolNumber),
+      m_received (0)
+  {}
+  virtual int GetProtocolNumber (void) const
+  {
+    return m_protocolNumber;
+  }
+  virtual enum RxStatus Receive (Ptr<Packet> p, Ipv4Header const &header, Ptr<Ipv4Interface> incomingInterface)
+  {
+    ++m_received;
+    return RX_OK;
+  }
+  virtual enum RxStatus Receive (Ptr<Packet> p, Ipv6Header const &header, Ptr<Ipv6Interface> incomingInterface)
+  {
+    ++m_received;
+    return RX_OK;
+  }
+  virtual void SetDownTarget (DownTargetCallback cb) {}
+  virtual void SetDownTarget6 (DownTargetCallback6 cb) {}
+  virtual DownTargetCallback GetDownTarget (void) const
+  {
+    return DownTargetCallback ();
+  }
+  virtual DownTargetCallback6 GetDownTarget6 (void) const
+  {
+    return DownTargetCallback6 ();
+  }
+private:
+  int m_protocolNumber;
+  uint64_t m_received;
+};
+
+/* protocols of the received packets: ICMP, TCP, UDP and a DCN shim */
+static const uint8_t g_demuxProtocols[] = { 1, 6, 17, 200 };
+
+static std::vector<Ptr<Packet> >
+createDemuxPackets (void)
+{
+  std::vector<Ptr<Packet> > packets;
+  for (uint32_t i = 0; i < sizeof (g_demuxProtocols); i++)
+    {
+      Ptr<Packet> p = Create<Packet> (1000);
+      Ipv4Header ipv4;
+      ipv4.SetProtocol (g_demuxProtocols[i]);
+      ipv4.SetPayloadSize (1000);
+      p->AddHeader (ipv4);
+      packets.push_back (p);
+    }
+  return packets;
+}
+
+/* Demultiplex with the (protocol, interface) map formerly used by the L3 protocols */
+static void
+benchDemuxMap (uint32_t n)
+{
+  typedef std::map<std::pair<int, int32_t>, Ptr<IpL4Protocol> > L4List;
+  L4List protocols;
+  for (uint32_t i = 0; i < sizeof (g_demuxProtocols); i++)
+    {
+      protocols[std::make_pair (g_demuxProtocols[i], -1)] = Create<BenchL4Protocol> (g_demuxProtocols[i]);
+    }
+  protocols[std::make_pair (17, 1)] = Create<BenchL4Protocol> (17);
+  std::vector<Ptr<Packet> > packets = createDemuxPackets ();
+
+  Ipv4Header ipv4;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<Packet> p = packets[i % packets.size ()];
+      p->PeekHeader (ipv4);
+      int32_t interface = i % 3;
+      L4List::const_iterator j = protocols.find (std::make_pair (ipv4.GetProtocol (), interface));
+      if (j == protocols.end ())
+        {
+          j = protocols.find (std::make_pair (ipv4.GetProtocol (), -1));
+        }
+      j->second->Receive (p, ipv4, 0);
+    }
+}
+
+/* Demultiplex with the direct-indexed IpL4ProtocolTable */
+static void
+benchDemuxTable (uint32_t n)
+{
+  IpL4ProtocolTable protocols;
+  for (uint32_t i = 0; i < sizeof (g_demuxProtocols); i++)
+    {
+      protocols.Insert (Create<BenchL4Protocol> (g_demuxProtocols[i]), -1);
+    }
+  protocols.Insert (Create<BenchL4Protocol> (17), 1);
+  std::vector<Ptr<Packet> > packets = createDemuxPackets ();
+
+  Ipv4Header ipv4;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<Packet> p = packets[i % packets.size ()];
+      p->PeekHeader (ipv4);
+      int32_t interface = i % 3;
+      protocols.Get (ipv4.GetProtocol (), interface)->Receive (p, ipv4, 0);
+    }
+}
+#endif
+
 static uint64_t
 runBenchOneIteration (void (*bench) (uint32_t), uint32_t n)
 {
@@ -359,6 +476,10 @@ int main (int argc, char *argv[])
   runBench (&benchD, n, minIterations, "Intermixed add/remove headers and tags");
   runBench (&benchFragment, n, minIterations, "Fragmentation and concatenation");
   runBench (&benchByteTags, n, minIterations, "Benchmark byte tags");
+#ifdef NS3_BENCH_DEMUX
+  runBench (&benchDemuxMap, n, minIterations, "Demultiplex L4 protocols with a map");
+  runBench (&benchDemuxTable, n, minIterations, "Demultiplex L4 protocols with a table");
+#endif
 
   return 0;
 }
@@ -0,0 +1,341 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/error-model.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/pfifo-fast-queue-disc.h"
+#include "ns3/fq-codel-queue-disc.h"
+#include "ns3/mq-queue-disc.h"
+#include "ns3/dctcp-queue-disc.h"
+#include "ns3/prio-queue-disc.h"
+#include "ns3/pfabric-queue-disc.h"
+#include "ns3/uinteger.h"
+#include "ns3/ipv4-queue-disc-item.h"
+#include "ns3/ipv4-packet-filter.h"
+#include "ns3/udp-header.h"
+#include <iostream>
+#include <vector>
+#include <map>
+
+using namespace ns3;
+
+static uint8_t g_txQueues = 1; //!< transmission queues of the devices
+
+/*
+ * Device with g_txQueues transmission queues which consumes the packets.
+ */
+class BenchDevice : public SimpleNetDevice
+{
+public:
+  BenchDevice () : m_sent (0) {}
+  virtual bool Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber)
+  {
+    ++m_sent;
+    return true;
+  }
+  uint64_t m_sent;
+protected:
+  virtual void NotifyNewAggregate (void)
+  {
+    Ptr<NetDeviceQueueInterface> ndqi = GetObject<NetDeviceQueueInterface> ();
+    if (ndqi != 0)
+      {
+        ndqi->SetTxQueuesN (g_txQueues);
+      }
+    SimpleNetDevice::NotifyNewAggregate ();
+  }
+};
+
+/*
+ * Make a packet of a UDP flow. Urgent packets carry the EF DSCP, and the
+ * remaining size of the flow is carried by a PfabricTag.
+ */
+static Ptr<QueueDiscItem>
+MakeItem (uint32_t flow, bool urgent = false, uint64_t remaining = 0)
+{
+  Ptr<Packet> p = Create<Packet> (1000);
+  if (remaining != 0)
+    {
+      p->AddPacketTag (PfabricTag (remaining));
+    }
+  UdpHeader udp;
+  udp.SetSourcePort (10000 + flow % 50000);
+  udp.SetDestinationPort (80);
+  p->AddHeader (udp);
+  Ipv4Header ip;
+  ip.SetSource (Ipv4Address (0x0a000000 + flow / 50000 + 1));
+  ip.SetDestination (Ipv4Address ("10.1.0.1"));
+  ip.SetProtocol (17);
+  ip.SetEcn (Ipv4Header::ECN_ECT0);
+  ip.SetDscp (urgent ? Ipv4Header::DSCP_EF : Ipv4Header::DscpDefault);
+  ip.SetPayloadSize (p->GetSize ());
+  return Create<Ipv4QueueDiscItem> (p, Address (), 0x0800, ip);
+}
+
+static Ptr<QueueDisc>
+MakeQueueDisc (std::string type)
+{
+  if (type == "fq_codel")
+    {
+      Ptr<QueueDisc> qd = CreateObject<FqCoDelQueueDisc> ();
+      qd->AddPacketFilter (CreateObject<FqCoDelIpv4PacketFilter> ());
+      return qd;
+    }
+  if (type == "dctcp")
+    {
+      return CreateObjectWithAttributes<DctcpQueueDisc> ("MarkingThreshold", UintegerValue (65));
+    }
+  if (type == "prio")
+    {
+      Ptr<QueueDisc> qd = CreateObject<PrioQueueDisc> ();
+      Ptr<PrioIpv4PacketFilter> filter = CreateObject<PrioIpv4PacketFilter> ();
+      filter->SetBand (Ipv4Header::DSCP_EF, 0);
+      qd->AddPacketFilter (filter);
+      return qd;
+    }
+  if (type == "pfabric")
+    {
+      return CreateObject<PfabricQueueDisc> ();
+    }
+  if (type == "mq")
+    {
+      return CreateObject<MqQueueDisc> ();
+    }
+  return CreateObject<PfifoFastQueueDisc> ();
+}
+
+/*
+ * Install the queue disc on a number of switch ports, then enqueue a burst
+ * on every port while the transmission queues are stopped and drain the
+ * bursts by waking the transmission queues.
+ */
+static void
+runBench (std::string type, uint32_t ports, uint8_t txQueues, uint32_t burst, uint32_t flows)
+{
+  g_txQueues = txQueues;
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<TrafficControlLayer> tc = CreateObject<TrafficControlLayer> ();
+  node->AggregateObject (tc);
+  std::vector<Ptr<BenchDevice> > devs;
+  for (uint32_t i = 0; i < ports; ++i)
+    {
+      Ptr<BenchDevice> dev = CreateObject<BenchDevice> ();
+      node->AddDevice (dev);
+      Ptr<QueueDisc> qd = MakeQueueDisc (type);
+      qd->SetNetDevice (dev);
+      tc->SetRootQueueDiscOnDevice (dev, qd);
+      devs.push_back (dev);
+    }
+  tc->Initialize ();
+
+  std::vector<Ptr<QueueDiscItem> > items;
+  for (uint32_t i = 0; i < burst * ports; ++i)
+    {
+      items.push_back (MakeItem (i % flows, i % 4 == 0, (i * 2654435761u) % 1000000 + 1));
+    }
+  for (uint32_t i = 0; i < ports; ++i)
+    {
+      Ptr<NetDeviceQueueInterface> ndqi = devs[i]->GetObject<NetDeviceQueueInterface> ();
+      for (uint8_t q = 0; q < txQueues; ++q)
+        {
+          ndqi->GetTxQueue (q)->Stop ();
+        }
+    }
+
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < items.size (); ++i)
+    {
+      tc->Send (devs[i % ports], items[i]);
+    }
+  uint64_t enqueueMs = time.End ();
+  items.clear ();
+
+  // a queue disc run dequeues a limited quota of packets, thus keep waking
+  // the transmission queues until the bursts are drained
+  uint64_t sent = 0;
+  uint64_t last;
+  time.Start ();
+  do
+    {
+      last = sent;
+      sent = 0;
+      for (uint32_t i = 0; i < ports; ++i)
+        {
+          Ptr<NetDeviceQueueInterface> ndqi = devs[i]->GetObject<NetDeviceQueueInterface> ();
+          for (uint8_t q = 0; q < txQueues; ++q)
+            {
+              ndqi->GetTxQueue (q)->Wake ();
+            }
+          sent += devs[i]->m_sent;
+        }
+    }
+  while (sent != last);
+  uint64_t dequeueMs = time.End ();
+
+  uint64_t packets = uint64_t (burst) * ports;
+  std::cout << type << "\tports=" << ports << "\ttxq=" << uint32_t (txQueues)
+            << "\tenqueue=" << packets * 1000 / (enqueueMs + 1) << " pkt/s"
+            << "\tdequeue=" << sent * 1000 / (dequeueMs + 1) << " pkt/s"
+            << "\tsent=" << sent << "/" << packets << std::endl;
+  node->Dispose ();
+  Simulator::Destroy ();
+}
+
+/*
+ * State of the latency benchmark: a 10 Gb/s link, long flows offering 100%
+ * of its capacity and bursts of short flows offering 5% more, so that the
+ * queue fills up.
+ */
+static Ptr<QueueDisc> g_qd;                    //!< the queue disc under test
+static std::map<uint64_t, Time> g_arrivals;    //!< arrival time of the packets
+static Time g_txTime = NanoSeconds (800);      //!< transmission time of a packet
+static uint32_t g_shortSize = 20;              //!< packets of a short flow
+static uint64_t g_longSent = 0;                //!< long flow packets sent
+static uint64_t g_shortSent = 0;               //!< short flow packets sent
+static Time g_shortDelay;                      //!< sum of the short packet delays
+static Time g_shortMaxDelay;                   //!< maximum short packet delay
+
+static void
+LinkDequeue (void)
+{
+  Ptr<QueueDiscItem> item = g_qd->Dequeue ();
+  if (item != 0)
+    {
+      std::map<uint64_t, Time>::iterator it = g_arrivals.find (item->GetPacket ()->GetUid ());
+      if (StaticCast<Ipv4QueueDiscItem> (item)->GetHeader ().GetDscp () == Ipv4Header::DSCP_EF)
+        {
+          Time delay = Simulator::Now () - it->second;
+          g_shortDelay += delay;
+          g_shortMaxDelay = Max (g_shortMaxDelay, delay);
+          g_shortSent++;
+        }
+      else
+        {
+          g_longSent++;
+        }
+      g_arrivals.erase (it);
+    }
+  Simulator::Schedule (g_txTime, &LinkDequeue);
+}
+
+static void
+Arrive (Ptr<QueueDiscItem> item)
+{
+  uint64_t uid = item->GetPacket ()->GetUid ();
+  g_arrivals[uid] = Simulator::Now ();
+  if (!g_qd->Enqueue (item))
+    {
+      g_arrivals.erase (uid);
+    }
+}
+
+static void
+LongFlows (void)
+{
+  // four long flows, whose remaining size stays large
+  for (uint32_t f = 0; f < 4; ++f)
+    {
+      Arrive (MakeItem (f, false, 100000000));
+    }
+  Simulator::Schedule (g_txTime * 4, &LongFlows);
+}
+
+static void
+ShortFlow (uint32_t id)
+{
+  // a short flow sends a burst, the remaining size decreasing along it
+  for (uint32_t i = 0; i < g_shortSize; ++i)
+    {
+      Arrive (MakeItem (1000 + id, true, (g_shortSize - i) * 1000));
+    }
+}
+
+/*
+ * Serve the queue disc at 10 Gb/s for 100 ms of simulated time, and report
+ * the delay of the packets of the short flows and the number of packets of
+ * the long flows sent.
+ */
+static void
+runLatency (std::string type)
+{
+  g_qd = MakeQueueDisc (type);
+  g_qd->Initialize ();
+  g_arrivals.clear ();
+  g_longSent = g_shortSent = 0;
+  g_shortDelay = g_shortMaxDelay = Seconds (0);
+
+  Simulator::Schedule (Seconds (0), &LinkDequeue);
+  Simulator::Schedule (Seconds (0), &LongFlows);
+  uint32_t id = 0;
+  for (Time t = MilliSeconds (1); t < MilliSeconds (100); t += g_txTime * g_shortSize * 20)
+    {
+      Simulator::Schedule (t, &ShortFlow, id++);
+    }
+
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Stop (MilliSeconds (100));
+  Simulator::Run ();
+  uint64_t ms = time.End ();
+
+  std::cout << type
+            << "\tshort delay mean=" << (g_shortSent ? g_shortDelay.GetMicroSeconds () / g_shortSent : 0) << "us"
+            << " max=" << g_shortMaxDelay.GetMicroSeconds () << "us"
+            << "\tshort sent=" << g_shortSent
+            << "\tlong sent=" << g_longSent
+            << "\tdrops=" << g_qd->GetTotalDroppedPackets ()
+            << "\t" << ms << " ms" << std::endl;
+  g_qd->Dispose ();
+  g_qd = 0;
+  Simulator::Destroy ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t ports = 64;
+  uint32_t txQueues = 8;
+  uint32_t burst = 800;
+  uint32_t flows = 4096;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the enqueue and dequeue rates of the traffic control layer, and the latency of the flow scheduling queue discs");
+  cmd.AddValue ("ports", "number of devices of the switch", ports);
+  cmd.AddValue ("txq", "number of transmission queues of multi-queue devices", txQueues);
+  cmd.AddValue ("burst", "number of packets enqueued on each device", burst);
+  cmd.AddValue ("flows", "number of flows", flows);
+  cmd.Parse (argc, argv);
+
+  runBench ("pfifo_fast", ports, 1, burst, flows);
+  runBench ("fq_codel", ports, 1, burst, flows);
+  runBench ("dctcp", ports, 1, burst, flows);
+  runBench ("prio", ports, 1, burst, flows);
+  runBench ("pfabric", ports, 1, burst, flows);
+  runBench ("pfifo_fast", ports, txQueues, burst, flows);
+  runBench ("mq", ports, txQueues, burst, flows);
+
+  runLatency ("pfifo_fast");
+  runLatency ("prio");
+  runLatency ("pfabric");
+  return 0;
+}
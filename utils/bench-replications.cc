@@ -0,0 +1,179 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/replication-runner.h"
+#include "ns3/system-wall-clock-ms.h"
+#include <iostream>
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * The inputs shared by all the replications, read only.
+ */
+struct Scenario
+{
+  uint32_t pairs;             //!< number of sender and receiver pairs
+  std::string rate;           //!< data rate of the access links
+  std::string bottleneck;     //!< data rate of the bottleneck link
+  std::string delay;          //!< propagation delay of every link
+  double seconds;             //!< simulated duration
+  std::vector<std::pair<double, double> > cdf; //!< flow sizes in bytes, and their cumulative probabilities
+};
+
+/*
+ * A dumbbell on which every sender starts flows one after the other,
+ * with sizes drawn from the CDF of the scenario. Returns the bytes
+ * received by the end of the simulation.
+ */
+static uint64_t
+Replicate (const Scenario *scenario, uint64_t run)
+{
+  NodeContainer routers;
+  routers.Create (2);
+  NodeContainer senders;
+  senders.Create (scenario->pairs);
+  NodeContainer receivers;
+  receivers.Create (scenario->pairs);
+  InternetStackHelper stack;
+  stack.Install (routers);
+  stack.Install (senders);
+  stack.Install (receivers);
+
+  PointToPointHelper p2p;
+  p2p.SetChannelAttribute ("Delay", StringValue (scenario->delay));
+  p2p.SetDeviceAttribute ("DataRate", StringValue (scenario->bottleneck));
+  Ipv4AddressHelper address;
+  address.SetBase ("10.0.0.0", "255.255.255.0");
+  address.Assign (p2p.Install (routers));
+  p2p.SetDeviceAttribute ("DataRate", StringValue (scenario->rate));
+  Ipv4InterfaceContainer sinkInterfaces;
+  for (uint32_t i = 0; i < scenario->pairs; ++i)
+    {
+      address.NewNetwork ();
+      address.Assign (p2p.Install (senders.Get (i), routers.Get (0)));
+      address.NewNetwork ();
+      sinkInterfaces.Add (address.Assign (p2p.Install (receivers.Get (i), routers.Get (1))).Get (0));
+    }
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  Ptr<EmpiricalRandomVariable> size = CreateObject<EmpiricalRandomVariable> ();
+  for (std::vector<std::pair<double, double> >::const_iterator i = scenario->cdf.begin (); i != scenario->cdf.end (); ++i)
+    {
+      size->CDF (i->first, i->second);
+    }
+  Ptr<UniformRandomVariable> start = CreateObject<UniformRandomVariable> ();
+  ApplicationContainer sinks;
+  for (uint32_t i = 0; i < scenario->pairs; ++i)
+    {
+      uint16_t port = 5000;
+      PacketSinkHelper sink ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+      sinks.Add (sink.Install (receivers.Get (i)));
+      double at = start->GetValue (0, 0.1);
+      for (; at < scenario->seconds; at += 0.1)
+        {
+          BulkSendHelper source ("ns3::TcpSocketFactory", InetSocketAddress (sinkInterfaces.GetAddress (i), port));
+          source.SetAttribute ("MaxBytes", UintegerValue (size->GetInteger ()));
+          source.Install (senders.Get (i)).Start (Seconds (at));
+        }
+    }
+
+  Simulator::Stop (Seconds (scenario->seconds));
+  Simulator::Run ();
+  uint64_t bytes = 0;
+  for (uint32_t i = 0; i < sinks.GetN (); ++i)
+    {
+      bytes += DynamicCast<PacketSink> (sinks.Get (i))->GetTotalRx ();
+    }
+  return bytes;
+}
+
+static uint64_t
+Run (std::string name, const ReplicationRunner &runner, Callback<uint64_t, uint64_t> replication,
+     uint32_t runs, std::vector<uint64_t> *results)
+{
+  SystemWallClockMs time;
+  time.Start ();
+  *results = runner.Run (replication, 1, runs);
+  uint64_t ms = time.End ();
+  std::cout << name << "\truns=" << runs << "\tthreads=" << runner.GetThreads ()
+            << "\t" << ms << " ms\t" << (ms / runs) << " ms/run" << std::endl;
+  return ms;
+}
+
+int main (int argc, char *argv[])
+{
+  Scenario scenario;
+  scenario.pairs = 8;
+  scenario.rate = "1Gbps";
+  scenario.bottleneck = "4Gbps";
+  scenario.delay = "10us";
+  scenario.seconds = 1;
+  uint32_t runs = 8;
+  uint32_t threads = 0;
+
+  CommandLine cmd;
+  cmd.AddValue ("pairs", "number of sender and receiver pairs", scenario.pairs);
+  cmd.AddValue ("seconds", "simulated duration of each replication", scenario.seconds);
+  cmd.AddValue ("runs", "number of replications", runs);
+  cmd.AddValue ("threads", "maximum number of concurrent replications, 0 for all the cores", threads);
+  cmd.Parse (argc, argv);
+
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1448));
+  // a web search like flow size distribution
+  scenario.cdf.push_back (std::make_pair (6e3, 0.15));
+  scenario.cdf.push_back (std::make_pair (13e3, 0.2));
+  scenario.cdf.push_back (std::make_pair (19e3, 0.3));
+  scenario.cdf.push_back (std::make_pair (33e3, 0.4));
+  scenario.cdf.push_back (std::make_pair (53e3, 0.53));
+  scenario.cdf.push_back (std::make_pair (133e3, 0.6));
+  scenario.cdf.push_back (std::make_pair (667e3, 0.7));
+  scenario.cdf.push_back (std::make_pair (1333e3, 0.8));
+  scenario.cdf.push_back (std::make_pair (3333e3, 0.9));
+  scenario.cdf.push_back (std::make_pair (6667e3, 0.97));
+  scenario.cdf.push_back (std::make_pair (20e6, 1.0));
+  Callback<uint64_t, uint64_t> replication = MakeBoundCallback (&Replicate, &scenario);
+
+  ReplicationRunner runner;
+  std::vector<uint64_t> sequential;
+  std::vector<uint64_t> concurrent;
+  runner.SetThreads (1);
+  uint64_t ms = Run ("sequential", runner, replication, runs, &sequential);
+  if (threads != 0)
+    {
+      runner.SetThreads (threads);
+    }
+  else
+    {
+      runner = ReplicationRunner ();
+    }
+  uint64_t concurrentMs = Run ("concurrent", runner, replication, runs, &concurrent);
+
+  std::cout << "speedup " << (double)ms / std::max<uint64_t> (concurrentMs, 1)
+            << "\tidentical=" << (sequential == concurrent ? "yes" : "no") << "\tbytes";
+  for (uint32_t i = 0; i < runs; ++i)
+    {
+      std::cout << " " << concurrent[i];
+    }
+  std::cout << std::endl;
+  return 0;
+}
@@ -18,6 +18,7 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <fstream>
@@ -184,6 +185,7 @@ int main (int argc, char *argv[])
 
   bool schedCal  = false;
   bool schedHeap = false;
+  bool schedLad  = false;
   bool schedList = false;
   bool schedMap  = true;
 
@@ -203,6 +205,7 @@ int main (int argc, char *argv[])
              "to be ascii, giving the relative event times in ns.");
   cmd.AddValue ("cal",   "use CalendarSheduler",          schedCal);
   cmd.AddValue ("heap",  "use HeapScheduler",             schedHeap);
+  cmd.AddValue ("ladder", "use LadderScheduler",          schedLad);
   cmd.AddValue ("list",  "use ListSheduler",              schedList);
   cmd.AddValue ("map",   "use MapScheduler (default)",    schedMap);
   cmd.AddValue ("debug", "enable debugging output",       g_debug);
@@ -219,6 +222,7 @@ int main (int argc, char *argv[])
   if (schedCal)  { factory.SetTypeId ("ns3::CalendarScheduler"); }
   if (schedHeap) { factory.SetTypeId ("ns3::HeapScheduler");     }
   if (schedList) { factory.SetTypeId ("ns3::ListScheduler");     }  
+  if (schedLad)  { factory.SetTypeId ("ns3::LadderScheduler");   }
   Simulator::SetScheduler (factory);
 
   LOGME (std::setprecision (g_fwidth - 6));
@@ -269,6 +273,14 @@ int main (int argc, char *argv[])
       bench->RunBench ();
     }
 
+  EventAllocator::Stats stats = EventAllocator::GetStats ();
+  LOG ("");
+  LOGME ("event allocations: " << stats.allocations);
+  LOGME ("event allocations recycled: " << stats.recycled <<
+         " (" << (100.0 * stats.recycled / std::max (stats.allocations, (uint64_t)1)) << "%)");
+  LOGME ("event allocations too large for slabs: " << stats.large);
+  LOGME ("event slab memory: " << stats.slabBytes << " bytes");
+
   LOG ("");
   return 0;
 
@@ -0,0 +1,136 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/spectrum-model.h"
+#include "ns3/spectrum-value.h"
+#include <iostream>
+#include <string>
+
+using namespace ns3;
+
+static double g_sink = 0; //!< keeps the results alive
+
+/*
+ * The spectrum model of a 20 MHz LTE carrier: 100 resource blocks of
+ * 180 kHz around 2.12 GHz, laid out as LteSpectrumValueHelper does.
+ */
+static Ptr<SpectrumModel>
+CreateLteModel (uint32_t rbs)
+{
+  Bands bands;
+  double fc = 2.12e9;
+  for (uint32_t i = 0; i < rbs; ++i)
+    {
+      BandInfo bi;
+      bi.fc = fc - (rbs / 2.0) * 180e3 + 90e3 + i * 180e3;
+      bi.fl = bi.fc - 90e3;
+      bi.fh = bi.fc + 90e3;
+      bands.push_back (bi);
+    }
+  return Create<SpectrumModel> (bands);
+}
+
+static void
+Report (std::string name, uint32_t iterations, uint64_t ms)
+{
+  std::cout << name << "\titerations=" << iterations << "\t" << ms << " ms\t"
+            << (ms * 1e6 / iterations) << " ns/iteration" << std::endl;
+}
+
+/*
+ * What LteInterference does at every chunk: SINR and interference
+ * against the signal being received, then the per-RB average.
+ */
+static void
+runInterference (Ptr<SpectrumModel> sm, uint32_t iterations)
+{
+  SpectrumValue all (sm), rx (sm), noise (sm);
+  for (uint32_t i = 0; i < sm->GetNumBands (); ++i)
+    {
+      rx[i] = 1e-15 * (i + 1);
+      all[i] = 3e-15 * (i + 1);
+      noise[i] = 4e-21;
+    }
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < iterations; ++i)
+    {
+      SpectrumValue interf = all - rx + noise;
+      SpectrumValue sinr = rx / interf;
+      g_sink += Sum (sinr) + Sum (interf);
+    }
+  Report ("interference", iterations, time.End ());
+}
+
+/*
+ * What LteInterference does when signals start and end: add to and
+ * subtract from the running total.
+ */
+static void
+runAccumulate (Ptr<SpectrumModel> sm, uint32_t iterations)
+{
+  SpectrumValue all (sm), sig (sm);
+  sig = 1e-15;
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < iterations; ++i)
+    {
+      all += sig;
+      all -= sig;
+    }
+  g_sink += Sum (all);
+  Report ("accumulate", iterations, time.End ());
+}
+
+/*
+ * What MultiModelSpectrumChannel and the PHYs do for each receiver:
+ * scale the transmitted PSD by the path and antenna gains and integrate
+ * the received power.
+ */
+static void
+runReceive (Ptr<SpectrumModel> sm, uint32_t iterations)
+{
+  SpectrumValue tx (sm);
+  tx = 1e-10;
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < iterations; ++i)
+    {
+      SpectrumValue rx = tx * 1e-9 * 2.0;
+      g_sink += Integral (rx);
+    }
+  Report ("receive", iterations, time.End ());
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t rbs = 100;
+  uint32_t iterations = 1000000;
+
+  CommandLine cmd;
+  cmd.AddValue ("rbs", "number of resource blocks in the spectrum model", rbs);
+  cmd.AddValue ("iterations", "number of iterations of each benchmark", iterations);
+  cmd.Parse (argc, argv);
+
+  Ptr<SpectrumModel> sm = CreateLteModel (rbs);
+  runInterference (sm, iterations);
+  runAccumulate (sm, iterations);
+  runReceive (sm, iterations);
+  std::cout << "checksum " << g_sink << std::endl;
+  return 0;
+}
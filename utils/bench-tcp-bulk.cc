@@ -0,0 +1,88 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/system-wall-clock-ms.h"
+#include <iostream>
+
+using namespace ns3;
+
+/*
+ * A single TCP bulk transfer over a point-to-point link, with no trace
+ * sink connected: the time spent per simulated segment is mostly the
+ * TCP, IP and device code, including the trace sources they fire.
+ */
+int main (int argc, char *argv[])
+{
+  double seconds = 10;
+  std::string rate = "1Gbps";
+  std::string delay = "100us";
+  uint32_t flows = 1;
+
+  CommandLine cmd;
+  cmd.AddValue ("seconds", "simulated duration of the transfer", seconds);
+  cmd.AddValue ("rate", "data rate of the link", rate);
+  cmd.AddValue ("delay", "propagation delay of the link", delay);
+  cmd.AddValue ("flows", "number of parallel bulk transfers", flows);
+  cmd.Parse (argc, argv);
+
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1448));
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue (rate));
+  p2p.SetChannelAttribute ("Delay", StringValue (delay));
+  NetDeviceContainer devices = p2p.Install (nodes);
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  ApplicationContainer sinks;
+  for (uint32_t i = 0; i < flows; ++i)
+    {
+      uint16_t port = 5000 + i;
+      BulkSendHelper source ("ns3::TcpSocketFactory", InetSocketAddress (interfaces.GetAddress (1), port));
+      source.SetAttribute ("MaxBytes", UintegerValue (0));
+      source.Install (nodes.Get (0)).Start (Seconds (0));
+      PacketSinkHelper sink ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+      sinks.Add (sink.Install (nodes.Get (1)));
+    }
+
+  Simulator::Stop (Seconds (seconds));
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Run ();
+  uint64_t ms = time.End ();
+
+  uint64_t bytes = 0;
+  for (uint32_t i = 0; i < sinks.GetN (); ++i)
+    {
+      bytes += DynamicCast<PacketSink> (sinks.Get (i))->GetTotalRx ();
+    }
+  uint64_t segments = bytes / 1448;
+  Simulator::Destroy ();
+
+  std::cout << "tcp-bulk\tsegments=" << segments << "\t" << ms << " ms\t"
+            << (ms * 1e6 / segments) << " ns/segment" << std::endl;
+  return 0;
+}
@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/tcp-tx-buffer.h"
+#include <iostream>
+#include <stdlib.h> // for exit ()
+#include <limits>
+#include <algorithm>
+
+using namespace ns3;
+
+static const uint32_t g_segmentSize = 1448;
+
+/*
+ * Drive a TcpTxBuffer like a sender with a window of the given number of
+ * segments: the application fills the buffer with writes of writeSize
+ * bytes, one segment is cut per ACK and every ACK acknowledges the oldest
+ * segment in flight. With lossEvery > 0, one segment out of lossEvery is
+ * retransmitted from the head of the window before being acknowledged.
+ */
+static void
+benchSendAck (uint32_t n, uint32_t window, uint32_t writeSize, bool materialized, uint32_t lossEvery)
+{
+  Ptr<TcpTxBuffer> buf = CreateObject<TcpTxBuffer> (0);
+  buf->SetMaxBufferSize (2 * window * g_segmentSize + writeSize);
+  std::vector<uint8_t> data (writeSize, 0x5a);
+  SequenceNumber32 next (0);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      while (buf->Available () >= writeSize)
+        {
+          buf->Add (materialized ? Create<Packet> (&data[0], writeSize) : Create<Packet> (writeSize));
+        }
+      while (next - buf->HeadSequence () < static_cast<int32_t> (window * g_segmentSize))
+        {
+          next += buf->CopyFromSequence (g_segmentSize, next)->GetSize ();
+        }
+      if (lossEvery > 0 && i % lossEvery == 0)
+        {
+          buf->CopyFromSequence (g_segmentSize, buf->HeadSequence ());
+        }
+      buf->DiscardUpTo (buf->HeadSequence () + g_segmentSize);
+    }
+  Simulator::Destroy ();
+}
+
+static uint64_t
+runBenchOneIteration (uint32_t n, uint32_t window, uint32_t writeSize, bool materialized, uint32_t lossEvery)
+{
+  SystemWallClockMs time;
+  time.Start ();
+  benchSendAck (n, window, writeSize, materialized, lossEvery);
+  uint64_t deltaMs = time.End ();
+  return deltaMs;
+}
+
+static void
+runBench (uint32_t n, uint32_t minIterations, uint32_t window, uint32_t writeSize,
+          bool materialized, uint32_t lossEvery)
+{
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      uint64_t delay = runBenchOneIteration (n, window, writeSize, materialized, lossEvery);
+      minDelay = std::min (minDelay, delay);
+    }
+  double ps = n;
+  ps *= 1000;
+  ps /= std::max<uint64_t> (minDelay, 1);
+  std::cout << ps << " acks/s"
+            << " (" << minDelay << " ms elapsed)\t"
+            << "window=" << window << " write=" << writeSize
+            << (materialized ? " materialized" : " virtual")
+            << (lossEvery > 0 ? " with retransmissions" : "")
+            << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t minIterations = 1;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the send/ack cycle of TcpTxBuffer");
+  cmd.AddValue ("n", "number of acks", n);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of acks must be specified " <<
+        "by command-line argument --n=(number of acks)" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-tcp-tx-buffer with n=" << n << std::endl;
+
+  uint32_t windows[] = { 10, 100, 1000, 10000 };
+  for (uint32_t i = 0; i < sizeof (windows) / sizeof (windows[0]); ++i)
+    {
+      runBench (n, minIterations, windows[i], 536, true, 0);
+      runBench (n, minIterations, windows[i], 536, true, 100);
+      runBench (n, minIterations, windows[i], 100000, false, 0);
+    }
+
+  return 0;
+}
@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/simulator.h"
+#include "ns3/timer.h"
+#include "ns3/watchdog.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/*
+ * Stands for a set of connections, each with a retransmission timeout
+ * which is pushed back on every ACK, and which seldom expires.
+ */
+class Connections
+{
+public:
+  Connections (uint32_t n, Time rto, Time interval)
+    : m_timers (n),
+      m_watchdogs (n),
+      m_events (n),
+      m_rto (rto),
+      m_interval (interval),
+      m_next (0),
+      m_acks (0),
+      m_expired (0),
+      m_dead (0)
+  {
+    for (uint32_t i = 0; i < n; ++i)
+      {
+        m_timers[i] = new Timer (Timer::CANCEL_ON_DESTROY);
+        m_timers[i]->SetFunction (&Connections::Expire, this);
+        m_timers[i]->SetDelay (m_rto);
+        m_watchdogs[i] = new Watchdog ();
+        m_watchdogs[i]->SetFunction (&Connections::Expire, this);
+      }
+  }
+  ~Connections ()
+  {
+    for (uint32_t i = 0; i < m_timers.size (); ++i)
+      {
+        delete m_timers[i];
+        delete m_watchdogs[i];
+      }
+  }
+  /**
+   * Rearm the timer of the next connection, as an ACK would.
+   */
+  void AckTimer (void)
+  {
+    Timer *timer = m_timers[m_next++ % m_timers.size ()];
+    timer->Cancel ();
+    timer->Schedule ();
+    m_acks++;
+    Simulator::Schedule (m_interval, &Connections::AckTimer, this);
+  }
+  /**
+   * Push back the watchdog of the next connection, as an ACK would.
+   */
+  void AckWatchdog (void)
+  {
+    m_watchdogs[m_next++ % m_watchdogs.size ()]->Ping (m_rto);
+    m_acks++;
+    Simulator::Schedule (m_interval, &Connections::AckWatchdog, this);
+  }
+  /**
+   * Cancel and schedule again the timeout event of the next connection,
+   * as TcpSocketBase does on an ACK.
+   */
+  void AckEvent (void)
+  {
+    EventId &event = m_events[m_next++ % m_events.size ()];
+    event.Cancel ();
+    event = Simulator::Schedule (m_rto, &Connections::Expire, this);
+    m_acks++;
+    m_dead = std::max (m_dead, Simulator::GetCancelledEventCount ());
+    Simulator::Schedule (m_interval, &Connections::AckEvent, this);
+  }
+  /**
+   * Count a timeout.
+   */
+  void Expire (void)
+  {
+    m_expired++;
+  }
+
+  std::vector<Timer *> m_timers;        //!< the retransmission timers
+  std::vector<Watchdog *> m_watchdogs;  //!< the same as watchdogs
+  std::vector<EventId> m_events;        //!< the same as raw events
+  Time m_rto;                           //!< the retransmission timeout
+  Time m_interval;                      //!< time between two ACKs
+  uint32_t m_next;                      //!< index of the next connection to ACK
+  uint64_t m_acks;                      //!< number of ACKs so far
+  uint64_t m_expired;                   //!< number of timeouts so far
+  uint32_t m_dead;                      //!< largest number of cancelled events in the queue
+};
+
+static void
+Run (std::string name, void (Connections::*ack)(void), uint32_t n, Time rto, Time interval, Time duration)
+{
+  Connections connections (n, rto, interval);
+  Simulator::Schedule (interval, ack, &connections);
+  Simulator::Stop (duration);
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Run ();
+  uint64_t ms = time.End ();
+  Simulator::Destroy ();
+  std::cout << name << "\tacks=" << connections.m_acks << "\texpired=" << connections.m_expired
+            << "\tdead=" << connections.m_dead
+            << "\t" << ms << " ms\t" << (ms * 1e6 / connections.m_acks) << " ns/ack" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 1000;
+  Time rto = MilliSeconds (200);
+  Time interval = MicroSeconds (1);
+  Time duration = Seconds (2);
+
+  CommandLine cmd;
+  cmd.AddValue ("connections", "number of timers", n);
+  cmd.AddValue ("rto", "delay of each timer", rto);
+  cmd.AddValue ("interval", "time between two rearms", interval);
+  cmd.AddValue ("duration", "simulated time", duration);
+  cmd.Parse (argc, argv);
+
+  Run ("timer", &Connections::AckTimer, n, rto, interval, duration);
+  Run ("watchdog", &Connections::AckWatchdog, n, rto, interval, duration);
+  Run ("event", &Connections::AckEvent, n, rto, interval, duration);
+  return 0;
+}
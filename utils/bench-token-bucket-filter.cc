@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/uinteger.h"
+#include "ns3/token-bucket-filter.h"
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+static uint64_t g_sent = 0; //!< packets released by the filters
+
+static void
+Sent (Ptr<Packet> p)
+{
+  ++g_sent;
+}
+
+/*
+ * Backlog a number of filters sharing 10 Gb/s and run them for a second
+ * of simulated time.
+ */
+static void
+runBench (uint32_t filters, Time slack)
+{
+  uint32_t packets = 1250000 / filters + 1;
+  std::vector<Ptr<dcn::TokenBucketFilter> > tbfs;
+  for (uint32_t i = 0; i < filters; ++i)
+    {
+      Ptr<dcn::TokenBucketFilter> tbf = CreateObject<dcn::TokenBucketFilter> ();
+      tbf->SetAttribute ("Bucket", UintegerValue (24000));
+      tbf->SetAttribute ("Slack", TimeValue (slack));
+      tbf->SetQueueLimit (packets);
+      tbf->SetRate (DataRate (10000000000ULL / filters));
+      tbf->SetSendTarget (MakeCallback (&Sent));
+      for (uint32_t j = 0; j < packets; ++j)
+        {
+          tbf->Send (Create<Packet> (1000));
+        }
+      tbfs.push_back (tbf);
+    }
+
+  g_sent = 0;
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+  uint64_t ms = time.End ();
+
+  uint64_t events = 0;
+  for (uint32_t i = 0; i < filters; ++i)
+    {
+      events += tbfs[i]->GetNEvents ();
+      tbfs[i]->Dispose ();
+    }
+  std::cout << "filters=" << filters << "\tslack=" << slack.GetMicroSeconds () << "us"
+            << "\tpackets=" << g_sent << "\tevents=" << events
+            << "\t" << ms << " ms" << std::endl;
+  Simulator::Destroy ();
+}
+
+int main (int argc, char *argv[])
+{
+  Time slack = MilliSeconds (10);
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the events of the token bucket filters of the DCN protocols");
+  cmd.AddValue ("slack", "slack of the batched filters", slack);
+  cmd.Parse (argc, argv);
+
+  uint32_t filters[] = { 1000, 10000 };
+  for (uint32_t i = 0; i < sizeof (filters) / sizeof (filters[0]); ++i)
+    {
+      runBench (filters[i], Seconds (0));
+      runBench (filters[i], slack);
+    }
+  return 0;
+}